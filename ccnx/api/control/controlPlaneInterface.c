@@ -88,7 +88,9 @@
 #include "cpi_private.h"
 #include "cpi_NameRouteProtocolType.h"
 #include "cpi_Acks.h"
+#include "cpi_Binary.h"
 #include <ccnx/api/control/cpi_ConnectionEthernet.h>
+#include <ccnx/api/control/cpi_ControlFacade.h>
 
 static const char *cpiRequest = "CPI_REQUEST";
 static const char *cpiResponse = "CPI_RESPONSE";
@@ -117,15 +119,34 @@ cpiSequence_GetJSONTag()
     return cpiSeqnum;
 }
 
+const char *
+cpi_PauseJsonTag(void)
+{
+    return cpiPause;
+}
+
+const char *
+cpi_FlushJsonTag(void)
+{
+    return cpiFlush;
+}
+
 uint64_t
 cpi_GetNextSequenceNumber(void)
+{
+    return cpi_GetNextSequenceNumbers(1);
+}
+
+uint64_t
+cpi_GetNextSequenceNumbers(size_t count)
 {
     uint64_t seqnum;
 
     int result = pthread_mutex_lock(&cpiNextSequenceNumberMutex);
     assertTrue(result == 0, "Got error from pthread_mutex_lock: %d", result);
 
-    seqnum = cpiNextSequenceNumber++;
+    seqnum = cpiNextSequenceNumber;
+    cpiNextSequenceNumber += count;
 
     result = pthread_mutex_unlock(&cpiNextSequenceNumberMutex);
     assertTrue(result == 0, "Got error from pthread_mutex_unlock: %d", result);
@@ -159,6 +180,10 @@ cpi_getCPIOperation2(const PARCJSON *json)
         return CPI_REGISTER_PREFIX;
     }
 
+    if (strncasecmp(p, cpiForwarding_AddRoutesJsonTag(), strlen(cpiForwarding_AddRoutesJsonTag())) == 0) {
+        return CPI_REGISTER_PREFIXES;
+    }
+
     if (strncasecmp(p, cpiForwarding_RemoveRouteJsonTag(), strlen(cpiForwarding_RemoveRouteJsonTag())) == 0) {
         return CPI_UNREGISTER_PREFIX;
     }
@@ -231,9 +256,30 @@ cpi_getCPIOperation2(const PARCJSON *json)
  * <#example#>
  * @endcode
  */
+/**
+ * Parse the binary form of a control message
+ *
+ * @return true The message is binary and `message` is filled in
+ */
+static bool
+_cpi_ParseBinary(const CCNxControl *control, CPIBinaryMessage *message)
+{
+    if (ccnxControlFacade_IsBinary(control)) {
+        bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(control), message);
+        assertTrue(success, "Malformed binary CPI message");
+        return true;
+    }
+    return false;
+}
+
 CpiOperation
 cpi_GetMessageOperation(CCNxControl *control)
 {
+    CPIBinaryMessage message;
+    if (_cpi_ParseBinary(control, &message)) {
+        return message.operation;
+    }
+
     if (cpiConnectionEthernet_IsAddMessage(control)) {
         return CPI_ADD_CONNECTION_ETHERNET;
     }
@@ -282,6 +328,11 @@ controlPlaneInterface_GetCPIMessageType(PARCJSON *json)
 CpiMessageType
 cpi_GetMessageType(const CCNxControl *control)
 {
+    CPIBinaryMessage message;
+    if (_cpi_ParseBinary(control, &message)) {
+        return message.messageType;
+    }
+
     PARCJSON *json = ccnxControl_GetJson(control);
     CpiMessageType result = controlPlaneInterface_GetCPIMessageType(json);
     return result;
@@ -354,6 +405,11 @@ controlPlaneInterface_GetSequenceNumber(const PARCJSON *controlPlaneMessage)
 uint64_t
 cpi_GetSequenceNumber(CCNxControl *control)
 {
+    CPIBinaryMessage message;
+    if (_cpi_ParseBinary(control, &message)) {
+        return message.sequenceNumber;
+    }
+
     PARCJSON *json = ccnxControl_GetJson(control);
 
     return controlPlaneInterface_GetSequenceNumber(json);
@@ -389,12 +445,16 @@ cpi_CreateFlushRequest(void)
  */
 PARCJSON *
 cpi_CreateRequest(const char *key, PARCJSON *operation)
+{
+    return cpi_CreateRequestWithSequenceNumber(key, operation, cpi_GetNextSequenceNumber());
+}
+
+PARCJSON *
+cpi_CreateRequestWithSequenceNumber(const char *key, PARCJSON *operation, uint64_t seqnum)
 {
     PARCJSON *result = parcJSON_Create();
     PARCJSON *request = parcJSON_Create();
 
-    uint64_t seqnum = cpi_GetNextSequenceNumber();
-
     parcJSON_AddInteger(request, cpiSeqnum, (int) seqnum);
     parcJSON_AddObject(request, key, operation);
     parcJSON_AddObject(result, cpiRequest, request);
@@ -406,7 +466,14 @@ cpi_CreateRequest(const char *key, PARCJSON *operation)
 CCNxControl *
 cpi_CreateResponse(CCNxControl *request, PARCJSON *operation)
 {
-    PARCJSON *requestJson = ccnxControl_GetJson(request);
+    // a binary request gets a JSON response
+    PARCJSON *binaryJson = NULL;
+    CPIBinaryMessage message;
+    if (_cpi_ParseBinary(request, &message)) {
+        binaryJson = cpiBinary_ToJson(&message);
+    }
+
+    PARCJSON *requestJson = binaryJson != NULL ? binaryJson : ccnxControl_GetJson(request);
 
     // use the same key as the request
     uint64_t seqnum = controlPlaneInterface_GetSequenceNumber(requestJson);
@@ -432,6 +499,9 @@ cpi_CreateResponse(CCNxControl *request, PARCJSON *operation)
     CCNxControl *result = ccnxControl_CreateCPIRequest(responseJson);
 
     parcJSON_Release(&responseJson);
+    if (binaryJson != NULL) {
+        parcJSON_Release(&binaryJson);
+    }
 
     return result;
 }
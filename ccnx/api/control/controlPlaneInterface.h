@@ -135,7 +135,8 @@ typedef enum {
     CPI_ADD_CONNECTION_ETHERNET,
     CPI_REMOVE_CONNECTION_ETHERNET,
     CPI_ADD_LISTENER,
-    CPI_REMOVE_LISTENER
+    CPI_REMOVE_LISTENER,
+    CPI_REGISTER_PREFIXES           // many routes in one request, see cpiForwarding_AddRoutes()
 } CpiOperation;
 
 typedef enum {
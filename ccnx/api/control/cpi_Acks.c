@@ -39,6 +39,7 @@
  *          "SEQUENCE" : <sequence number>,
  *          "RETURN"   : "ACK" or "NACK",
  *          "REQUEST"  : <original request JSON>
+ *          [, "RESULTS" : [ true | false, ... ] ]
  *          [, "MESSAGE" : <optional message> ]
  *        }
  *     ["AUTHENTICATOR" : <TBD proof based on request/response, e.g. a crypto signature>]
@@ -66,15 +67,15 @@ static const char *cpiReturnAck = "ACK";
 static const char *cpiReturnNack = "NACK";
 static const char *cpiOriginal = "REQUEST";
 static const char *cpiRequest = "CPI_REQUEST";
+static const char *cpiResults = "RESULTS";
 
 PARCJSON *
-cpiAcks_CreateAck(const PARCJSON *originalRequest)
+cpiAcks_CreateWithSequenceNumber(uint64_t sequenceNumber, bool isAck, const PARCJSON *originalRequest)
 {
-    uint64_t seqnum = cpi_GetNextSequenceNumber();
     PARCJSON *body = parcJSON_Create();
 
-    parcJSON_AddInteger(body, cpiSeqnum, (int) seqnum);
-    parcJSON_AddString(body, cpiReturn, cpiReturnAck);
+    parcJSON_AddInteger(body, cpiSeqnum, (int) sequenceNumber);
+    parcJSON_AddString(body, cpiReturn, isAck ? cpiReturnAck : cpiReturnNack);
 
     PARCJSON *copy = parcJSON_Copy(originalRequest);
     parcJSON_AddObject(body, cpiOriginal, copy);
@@ -88,25 +89,72 @@ cpiAcks_CreateAck(const PARCJSON *originalRequest)
     return json;
 }
 
+PARCJSON *
+cpiAcks_CreateAck(const PARCJSON *originalRequest)
+{
+    return cpiAcks_CreateWithSequenceNumber(cpi_GetNextSequenceNumber(), true, originalRequest);
+}
+
 PARCJSON *
 cpiAcks_CreateNack(const PARCJSON *request)
 {
-    uint64_t seqnum = cpi_GetNextSequenceNumber();
-    PARCJSON *body = parcJSON_Create();
-    parcJSON_AddInteger(body, cpiSeqnum, (int) seqnum);
-    parcJSON_AddString(body, cpiReturn, cpiReturnNack);
+    return cpiAcks_CreateWithSequenceNumber(cpi_GetNextSequenceNumber(), false, request);
+}
 
-    PARCJSON *copy = parcJSON_Copy(request);
-    parcJSON_AddObject(body, cpiOriginal, copy);
-    parcJSON_Release(&copy);
+PARCJSON *
+cpiAcks_CreateWithResults(uint64_t sequenceNumber, const PARCJSON *originalRequest, size_t count, const bool *results)
+{
+    assertTrue(count == 0 || results != NULL, "Parameter results must be non-null for %zu results", count);
+
+    bool allAcked = true;
+    PARCJSONArray *array = parcJSONArray_Create();
+    for (size_t i = 0; i < count; i++) {
+        allAcked = allAcked && results[i];
+        PARCJSONValue *value = parcJSONValue_CreateFromBoolean(results[i]);
+        parcJSONArray_AddValue(array, value);
+        parcJSONValue_Release(&value);
+    }
 
-    PARCJSON *json = parcJSON_Create();
-    parcJSON_AddObject(json, cpiAck, body);
-    parcJSON_Release(&body);
+    PARCJSON *json = cpiAcks_CreateWithSequenceNumber(sequenceNumber, allAcked, originalRequest);
+    PARCJSON *body = parcJSONValue_GetJSON(parcJSON_GetValueByName(json, cpiAck));
+    parcJSON_AddArray(body, cpiResults, array);
+    parcJSONArray_Release(&array);
 
     return json;
 }
 
+static PARCJSONArray *
+_cpiAcks_GetResults(const PARCJSON *json)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(json, cpiAck);
+    if (value == NULL) {
+        return NULL;
+    }
+    value = parcJSON_GetValueByName(parcJSONValue_GetJSON(value), cpiResults);
+    if (value == NULL) {
+        return NULL;
+    }
+    return parcJSONValue_GetArray(value);
+}
+
+size_t
+cpiAcks_GetResultCount(const PARCJSON *json)
+{
+    PARCJSONArray *results = _cpiAcks_GetResults(json);
+    return (results == NULL) ? 0 : parcJSONArray_GetLength(results);
+}
+
+bool
+cpiAcks_GetResult(const PARCJSON *json, size_t index)
+{
+    PARCJSONArray *results = _cpiAcks_GetResults(json);
+    assertNotNull(results, "Ack has no %s: %s", cpiResults, parcJSON_ToString(json));
+    assertTrue(index < parcJSONArray_GetLength(results), "Index %zu out of range, ack has %zu results",
+               index, parcJSONArray_GetLength(results));
+
+    return parcJSONValue_GetBoolean(parcJSONArray_GetValue(results, index));
+}
+
 bool
 cpiAcks_IsAck(const PARCJSON *json)
 {
@@ -121,6 +121,74 @@ PARCJSON *cpiAcks_CreateAck(const PARCJSON *originalRequest);
  */
 PARCJSON *cpiAcks_CreateNack(const PARCJSON *request);
 
+/**
+ * Create the JSON of an ACK or NACK with a given sequence number
+ *
+ * cpiAcks_CreateAck() and cpiAcks_CreateNack() use the next CPI sequence number.  This is for
+ * converting an ack that already has one, e.g. from its binary form.
+ *
+ * @param [in] sequenceNumber The sequence number of the ack itself
+ * @param [in] isAck true for an ACK, false for a NACK
+ * @param [in] originalRequest The JSON of the request being acknowledged, it is copied
+ *
+ * @return non-null The ack, release with parcJSON_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *ack = cpiAcks_CreateWithSequenceNumber(7, true, request);
+ *     parcJSON_Release(&ack);
+ * }
+ * @endcode
+ */
+PARCJSON *cpiAcks_CreateWithSequenceNumber(uint64_t sequenceNumber, bool isAck, const PARCJSON *originalRequest);
+
+/**
+ * Create the JSON of an ack carrying one result per entry of a batched request
+ *
+ * The ack is an ACK if every result is true, otherwise a NACK; the RESULTS array tells which
+ * entries failed.
+ *
+ * @param [in] sequenceNumber The sequence number of the ack itself
+ * @param [in] originalRequest The JSON of the request being acknowledged, it is copied
+ * @param [in] count The number of results
+ * @param [in] results true for each entry the forwarder accepted
+ *
+ * @return non-null The ack, release with parcJSON_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     bool results[] = { true, false };
+ *     PARCJSON *ack = cpiAcks_CreateWithResults(cpi_GetNextSequenceNumber(), request, 2, results);
+ *     // cpiAcks_IsAck(ack) is false, cpiAcks_GetResult(ack, 0) is true
+ *     parcJSON_Release(&ack);
+ * }
+ * @endcode
+ */
+PARCJSON *cpiAcks_CreateWithResults(uint64_t sequenceNumber, const PARCJSON *originalRequest, size_t count, const bool *results);
+
+/**
+ * The number of per-entry results in an ack
+ *
+ * @param [in] json A CPI_ACK
+ *
+ * @return 0 The ack has no RESULTS, e.g. it answers a single request
+ * @return positive The number of results
+ */
+size_t cpiAcks_GetResultCount(const PARCJSON *json);
+
+/**
+ * The result of entry `index` of a batched request
+ *
+ * @param [in] json A CPI_ACK with RESULTS
+ * @param [in] index Less than cpiAcks_GetResultCount()
+ *
+ * @return true The entry was accepted
+ * @return false The entry was rejected
+ */
+bool cpiAcks_GetResult(const PARCJSON *json, size_t index);
+
 /**
  * <#One Line Description#>
  *
@@ -0,0 +1,612 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_BufferComposer.h>
+
+#include "controlPlaneInterface.h"
+#include "cpi_private.h"
+#include "cpi_Acks.h"
+#include "cpi_Binary.h"
+
+#define _headerLength 12
+#define _tlvHeaderLength 4
+#define _ackLength 9
+#define _lifetimeLength 12
+
+// =====================================================================
+// Encoding
+
+/**
+ * The JSON key of an operation, or NULL if the operation has no binary form
+ */
+static const char *
+_operationTag(CpiOperation operation)
+{
+    switch (operation) {
+        case CPI_REGISTER_PREFIX:
+            return cpiForwarding_AddRouteJsonTag();
+        case CPI_UNREGISTER_PREFIX:
+            return cpiForwarding_RemoveRouteJsonTag();
+        case CPI_PREFIX_REGISTRATION_LIST:
+            return cpiForwarding_RouteListJsonTag();
+        case CPI_REGISTER_PREFIXES:
+            return cpiForwarding_AddRoutesJsonTag();
+        case CPI_PAUSE:
+            return cpi_PauseJsonTag();
+        case CPI_FLUSH:
+            return cpi_FlushJsonTag();
+        default:
+            return NULL;
+    }
+}
+
+static void
+_putHeader(PARCBufferComposer *composer, CpiMessageType messageType, CpiOperation operation, uint64_t sequenceNumber)
+{
+    assertNotNull(_operationTag(operation), "Operation %d has no binary encoding", operation);
+
+    parcBufferComposer_PutUint8(composer, CPI_BINARY_VERSION);
+    parcBufferComposer_PutUint8(composer, (uint8_t) messageType);
+    parcBufferComposer_PutUint16(composer, (uint16_t) operation);
+    parcBufferComposer_PutUint64(composer, sequenceNumber);
+}
+
+static void
+_putTlvHeader(PARCBufferComposer *composer, CPIBinaryTlvType type, size_t length)
+{
+    assertTrue(length <= UINT16_MAX, "TLV %d length %zu does not fit in the binary encoding", type, length);
+
+    parcBufferComposer_PutUint16(composer, (uint16_t) type);
+    parcBufferComposer_PutUint16(composer, (uint16_t) length);
+}
+
+static void
+_putTlv(PARCBufferComposer *composer, CPIBinaryTlvType type, const void *value, size_t length)
+{
+    _putTlvHeader(composer, type, length);
+    parcBufferComposer_PutArray(composer, value, length);
+}
+
+static void
+_putRoute(PARCBufferComposer *composer, const CPIRouteEntry *route)
+{
+    PARCBufferComposer *body = parcBufferComposer_Create();
+
+    char *uri = ccnxName_ToString(cpiRouteEntry_GetPrefix(route));
+    _putTlv(body, CPIBinaryTlv_Prefix, uri, strlen(uri));
+    parcMemory_Deallocate((void **) &uri);
+
+    const char *symbolic = cpiRouteEntry_GetSymbolicName(route);
+    if (symbolic != NULL) {
+        _putTlv(body, CPIBinaryTlv_Symbolic, symbolic, strlen(symbolic));
+    }
+
+    if (cpiRouteEntry_HasInterfaceIndex(route)) {
+        _putTlvHeader(body, CPIBinaryTlv_Interface, sizeof(uint32_t));
+        parcBufferComposer_PutUint32(body, cpiRouteEntry_GetInterfaceIndex(route));
+    }
+
+    const CPIAddress *nexthop = cpiRouteEntry_GetNexthop(route);
+    if (nexthop != NULL) {
+        PARCJSON *json = cpiAddress_ToJson(nexthop);
+        char *string = parcJSON_ToCompactString(json);
+        _putTlv(body, CPIBinaryTlv_Nexthop, string, strlen(string));
+        parcMemory_Deallocate((void **) &string);
+        parcJSON_Release(&json);
+    }
+
+    _putTlvHeader(body, CPIBinaryTlv_Protocol, sizeof(uint8_t));
+    parcBufferComposer_PutUint8(body, (uint8_t) cpiRouteEntry_GetRouteProtocolType(route));
+
+    _putTlvHeader(body, CPIBinaryTlv_RouteType, sizeof(uint8_t));
+    parcBufferComposer_PutUint8(body, (uint8_t) cpiRouteEntry_GetRouteType(route));
+
+    _putTlvHeader(body, CPIBinaryTlv_Cost, sizeof(uint32_t));
+    parcBufferComposer_PutUint32(body, cpiRouteEntry_GetCost(route));
+
+    if (cpiRouteEntry_HasLifetime(route)) {
+        struct timeval lifetime = cpiRouteEntry_GetLifetime(route);
+        _putTlvHeader(body, CPIBinaryTlv_Lifetime, _lifetimeLength);
+        parcBufferComposer_PutUint64(body, (uint64_t) lifetime.tv_sec);
+        parcBufferComposer_PutUint32(body, (uint32_t) lifetime.tv_usec);
+    }
+
+    PARCBuffer *value = parcBufferComposer_ProduceBuffer(body);
+    _putTlv(composer, CPIBinaryTlv_Route, parcBuffer_Overlay(value, 0), parcBuffer_Remaining(value));
+    parcBuffer_Release(&value);
+    parcBufferComposer_Release(&body);
+}
+
+static PARCBuffer *
+_produce(PARCBufferComposer *composer)
+{
+    PARCBuffer *result = parcBufferComposer_ProduceBuffer(composer);
+    parcBufferComposer_Release(&composer);
+    return result;
+}
+
+PARCBuffer *
+cpiBinary_CreateRequest(CpiOperation operation, const CPIRouteEntry *optionalRoute)
+{
+    bool needsRoute = (operation == CPI_REGISTER_PREFIX || operation == CPI_UNREGISTER_PREFIX);
+    assertTrue(needsRoute == (optionalRoute != NULL), "Operation %d %s a route", operation, needsRoute ? "needs" : "does not take");
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _putHeader(composer, CPI_REQUEST, operation, cpi_GetNextSequenceNumber());
+    if (optionalRoute != NULL) {
+        _putRoute(composer, optionalRoute);
+    }
+    return _produce(composer);
+}
+
+PARCBuffer *
+cpiBinary_CreateAddRoutesRequest(const CPIRouteEntryList *routes)
+{
+    assertNotNull(routes, "Parameter routes must be non-null");
+
+    size_t count = cpiRouteEntryList_Length(routes);
+    assertTrue(count <= UINT16_MAX, "A binary batch holds at most %u routes, got %zu", UINT16_MAX, count);
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _putHeader(composer, CPI_REQUEST, CPI_REGISTER_PREFIXES, cpi_GetNextSequenceNumbers(count));
+    for (size_t i = 0; i < count; i++) {
+        CPIRouteEntry *route = cpiRouteEntryList_Get((CPIRouteEntryList *) routes, i);
+        _putRoute(composer, route);
+        cpiRouteEntry_Destroy(&route);
+    }
+    return _produce(composer);
+}
+
+PARCBuffer *
+cpiBinary_CreateAckWithResults(const CPIBinaryMessage *request, size_t count, const bool *results)
+{
+    assertNotNull(request, "Parameter request must be non-null");
+    assertTrue(count == 0 || results != NULL, "Parameter results must be non-null for %zu results", count);
+
+    bool allAcked = true;
+    for (size_t i = 0; i < count; i++) {
+        allAcked = allAcked && results[i];
+    }
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _putHeader(composer, CPI_ACK, request->operation, cpi_GetNextSequenceNumber());
+    _putTlvHeader(composer, CPIBinaryTlv_Ack, _ackLength);
+    parcBufferComposer_PutUint64(composer, request->sequenceNumber);
+    parcBufferComposer_PutUint8(composer, (uint8_t) (allAcked ? ACK_ACK : ACK_NACK));
+    _putTlvHeader(composer, CPIBinaryTlv_Results, count);
+    for (size_t i = 0; i < count; i++) {
+        parcBufferComposer_PutUint8(composer, (uint8_t) (results[i] ? ACK_ACK : ACK_NACK));
+    }
+    return _produce(composer);
+}
+
+PARCBuffer *
+cpiBinary_CreateAck(const CPIBinaryMessage *request, CpiAckType ackType)
+{
+    assertNotNull(request, "Parameter request must be non-null");
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _putHeader(composer, CPI_ACK, request->operation, cpi_GetNextSequenceNumber());
+    _putTlvHeader(composer, CPIBinaryTlv_Ack, _ackLength);
+    parcBufferComposer_PutUint64(composer, request->sequenceNumber);
+    parcBufferComposer_PutUint8(composer, (uint8_t) ackType);
+    return _produce(composer);
+}
+
+PARCBuffer *
+cpiBinary_CreateRouteListResponse(const CPIBinaryMessage *request, const CPIRouteEntryList *list)
+{
+    assertNotNull(request, "Parameter request must be non-null");
+    assertNotNull(list, "Parameter list must be non-null");
+
+    // like the JSON response, it carries the sequence number of the request
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    _putHeader(composer, CPI_RESPONSE, CPI_PREFIX_REGISTRATION_LIST, request->sequenceNumber);
+    for (size_t i = 0; i < cpiRouteEntryList_Length(list); i++) {
+        CPIRouteEntry *route = cpiRouteEntryList_Get((CPIRouteEntryList *) list, i);
+        _putRoute(composer, route);
+        cpiRouteEntry_Destroy(&route);
+    }
+    return _produce(composer);
+}
+
+// =====================================================================
+// Decoding
+
+static inline uint16_t
+_getUint16(const uint8_t *p)
+{
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t
+_getUint32(const uint8_t *p)
+{
+    return ((uint32_t) _getUint16(p) << 16) | _getUint16(p + 2);
+}
+
+static inline uint64_t
+_getUint64(const uint8_t *p)
+{
+    return ((uint64_t) _getUint32(p) << 32) | _getUint32(p + 4);
+}
+
+/**
+ * Read the TLV at `*offset` and advance past it
+ *
+ * @return false The TLV does not fit in `length`
+ */
+static bool
+_getTlv(const uint8_t *tlvs, size_t length, size_t *offset, uint16_t *type, const uint8_t **value, size_t *valueLength)
+{
+    if (length - *offset < _tlvHeaderLength) {
+        return false;
+    }
+
+    const uint8_t *p = tlvs + *offset;
+    size_t tlvLength = _getUint16(p + 2);
+    if (length - *offset - _tlvHeaderLength < tlvLength) {
+        return false;
+    }
+
+    *type = _getUint16(p);
+    *value = p + _tlvHeaderLength;
+    *valueLength = tlvLength;
+    *offset += _tlvHeaderLength + tlvLength;
+    return true;
+}
+
+static bool
+_parseRoute(const uint8_t *tlvs, size_t length, CPIBinaryRoute *route)
+{
+    memset(route, 0, sizeof(CPIBinaryRoute));
+    route->interfaceIndex = UINT32_MAX;
+
+    size_t offset = 0;
+    while (offset < length) {
+        uint16_t type;
+        const uint8_t *value;
+        size_t valueLength;
+        if (!_getTlv(tlvs, length, &offset, &type, &value, &valueLength)) {
+            return false;
+        }
+
+        switch (type) {
+            case CPIBinaryTlv_Prefix:
+                route->prefix = (const char *) value;
+                route->prefixLength = valueLength;
+                break;
+
+            case CPIBinaryTlv_Symbolic:
+                route->symbolic = (const char *) value;
+                route->symbolicLength = valueLength;
+                break;
+
+            case CPIBinaryTlv_Nexthop:
+                route->nexthop = (const char *) value;
+                route->nexthopLength = valueLength;
+                break;
+
+            case CPIBinaryTlv_Interface:
+                if (valueLength != sizeof(uint32_t)) {
+                    return false;
+                }
+                route->hasInterfaceIndex = true;
+                route->interfaceIndex = _getUint32(value);
+                break;
+
+            case CPIBinaryTlv_Protocol:
+                if (valueLength != sizeof(uint8_t)) {
+                    return false;
+                }
+                route->routingProtocol = (CPINameRouteProtocolType) value[0];
+                break;
+
+            case CPIBinaryTlv_RouteType:
+                if (valueLength != sizeof(uint8_t)) {
+                    return false;
+                }
+                route->routeType = (CPINameRouteType) value[0];
+                break;
+
+            case CPIBinaryTlv_Cost:
+                if (valueLength != sizeof(uint32_t)) {
+                    return false;
+                }
+                route->cost = _getUint32(value);
+                break;
+
+            case CPIBinaryTlv_Lifetime:
+                if (valueLength != _lifetimeLength) {
+                    return false;
+                }
+                route->hasLifetime = true;
+                route->lifetime.tv_sec = (time_t) _getUint64(value);
+                route->lifetime.tv_usec = (suseconds_t) _getUint32(value + 8);
+                break;
+
+            default:
+                // skip unknown fields
+                break;
+        }
+    }
+
+    return route->prefix != NULL && route->prefixLength > 0;
+}
+
+bool
+cpiBinary_Parse(const PARCBuffer *encoding, CPIBinaryMessage *message)
+{
+    assertNotNull(encoding, "Parameter encoding must be non-null");
+    assertNotNull(message, "Parameter message must be non-null");
+
+    size_t length = parcBuffer_Remaining(encoding);
+    if (length < _headerLength) {
+        return false;
+    }
+
+    const uint8_t *p = parcBuffer_Overlay((PARCBuffer *) encoding, 0);
+    if (p[0] != CPI_BINARY_VERSION || p[1] > CPI_ACK) {
+        return false;
+    }
+
+    memset(message, 0, sizeof(CPIBinaryMessage));
+    message->messageType = (CpiMessageType) p[1];
+    message->operation = (CpiOperation) _getUint16(p + 2);
+    message->sequenceNumber = _getUint64(p + 4);
+    message->tlvs = p + _headerLength;
+    message->tlvsLength = length - _headerLength;
+
+    if (_operationTag(message->operation) == NULL) {
+        return false;
+    }
+
+    bool hasAck = false;
+    size_t offset = 0;
+    while (offset < message->tlvsLength) {
+        uint16_t type;
+        const uint8_t *value;
+        size_t valueLength;
+        if (!_getTlv(message->tlvs, message->tlvsLength, &offset, &type, &value, &valueLength)) {
+            return false;
+        }
+
+        if (type == CPIBinaryTlv_Route) {
+            CPIBinaryRoute route;
+            if (!_parseRoute(value, valueLength, &route)) {
+                return false;
+            }
+            if (message->routeCount == 0) {
+                message->route = route;
+            }
+            message->routeCount++;
+        } else if (type == CPIBinaryTlv_Ack) {
+            if (valueLength != _ackLength || value[8] > ACK_NACK) {
+                return false;
+            }
+            hasAck = true;
+            message->originalSequenceNumber = _getUint64(value);
+            message->ackType = (CpiAckType) value[8];
+        } else if (type == CPIBinaryTlv_Results) {
+            for (size_t i = 0; i < valueLength; i++) {
+                if (value[i] > ACK_NACK) {
+                    return false;
+                }
+            }
+            message->results = value;
+            message->resultCount = valueLength;
+        }
+    }
+
+    if (message->messageType == CPI_ACK) {
+        return hasAck;
+    }
+
+    if (message->messageType == CPI_REQUEST &&
+        (message->operation == CPI_REGISTER_PREFIX || message->operation == CPI_UNREGISTER_PREFIX)) {
+        return message->routeCount == 1;
+    }
+
+    return true;
+}
+
+bool
+cpiBinary_GetResult(const CPIBinaryMessage *message, size_t index)
+{
+    assertNotNull(message, "Parameter message must be non-null");
+    assertTrue(index < message->resultCount, "Index %zu out of range, message has %zu results", index, message->resultCount);
+
+    return message->results[index] == ACK_ACK;
+}
+
+bool
+cpiBinary_NextRoute(const CPIBinaryMessage *message, size_t *cursor, CPIBinaryRoute *route)
+{
+    assertNotNull(message, "Parameter message must be non-null");
+    assertNotNull(cursor, "Parameter cursor must be non-null");
+    assertNotNull(route, "Parameter route must be non-null");
+
+    while (*cursor < message->tlvsLength) {
+        uint16_t type;
+        const uint8_t *value;
+        size_t valueLength;
+        if (!_getTlv(message->tlvs, message->tlvsLength, cursor, &type, &value, &valueLength)) {
+            return false;
+        }
+
+        if (type == CPIBinaryTlv_Route) {
+            // cpiBinary_Parse() already checked the route
+            return _parseRoute(value, valueLength, route);
+        }
+    }
+    return false;
+}
+
+CPIRouteEntry *
+cpiBinary_CreateRouteEntry(const CPIBinaryRoute *route)
+{
+    assertNotNull(route, "Parameter route must be non-null");
+
+    char *uri = parcMemory_StringDuplicate(route->prefix, route->prefixLength);
+    CCNxName *prefix = ccnxName_CreateFromURI(uri);
+    assertNotNull(prefix, "Could not parse route prefix %s", uri);
+    parcMemory_Deallocate((void **) &uri);
+
+    const struct timeval *lifetime = route->hasLifetime ? &route->lifetime : NULL;
+
+    CPIRouteEntry *result;
+    if (route->symbolic != NULL) {
+        char *symbolic = parcMemory_StringDuplicate(route->symbolic, route->symbolicLength);
+        result = cpiRouteEntry_CreateSymbolic(prefix, symbolic, route->routingProtocol, route->routeType, lifetime, route->cost);
+        parcMemory_Deallocate((void **) &symbolic);
+        if (route->hasInterfaceIndex) {
+            cpiRouteEntry_SetInterfaceIndex(result, route->interfaceIndex);
+        }
+    } else {
+        CPIAddress *nexthop = NULL;
+        if (route->nexthop != NULL) {
+            char *string = parcMemory_StringDuplicate(route->nexthop, route->nexthopLength);
+            PARCJSON *json = parcJSON_ParseString(string);
+            assertNotNull(json, "Could not parse nexthop %s", string);
+            nexthop = cpiAddress_CreateFromJson(json);
+            parcJSON_Release(&json);
+            parcMemory_Deallocate((void **) &string);
+        }
+
+        result = cpiRouteEntry_Create(prefix, route->interfaceIndex, nexthop, route->routingProtocol, route->routeType, lifetime, route->cost);
+
+        if (nexthop != NULL) {
+            cpiAddress_Destroy(&nexthop);
+        }
+    }
+
+    return result;
+}
+
+CPIRouteEntryList *
+cpiBinary_CreateRouteEntryList(const CPIBinaryMessage *message)
+{
+    assertNotNull(message, "Parameter message must be non-null");
+
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+
+    size_t cursor = 0;
+    CPIBinaryRoute route;
+    while (cpiBinary_NextRoute(message, &cursor, &route)) {
+        cpiRouteEntryList_Append(list, cpiBinary_CreateRouteEntry(&route));
+    }
+    return list;
+}
+
+// =====================================================================
+// JSON
+
+/**
+ * { typeTag : { SEQUENCE : sequenceNumber, operationTag : operation } }
+ */
+static PARCJSON *
+_createJson(const char *typeTag, uint64_t sequenceNumber, CpiOperation operation, PARCJSON *operationJson)
+{
+    PARCJSON *body = parcJSON_Create();
+    parcJSON_AddInteger(body, cpiSeqnum, (int) sequenceNumber);
+    parcJSON_AddObject(body, _operationTag(operation), operationJson);
+
+    PARCJSON *result = parcJSON_Create();
+    parcJSON_AddObject(result, typeTag, body);
+    parcJSON_Release(&body);
+
+    return result;
+}
+
+PARCJSON *
+cpiBinary_ToJson(const CPIBinaryMessage *message)
+{
+    assertNotNull(message, "Parameter message must be non-null");
+
+    PARCJSON *result;
+    PARCJSON *operationJson;
+
+    switch (message->messageType) {
+        case CPI_ACK: {
+            operationJson = parcJSON_Create();
+            PARCJSON *original = _createJson(cpiRequest_GetJsonTag(), message->originalSequenceNumber, message->operation, operationJson);
+            if (message->results != NULL) {
+                bool *results = parcMemory_Allocate(message->resultCount * sizeof(bool) + 1);
+                for (size_t i = 0; i < message->resultCount; i++) {
+                    results[i] = cpiBinary_GetResult(message, i);
+                }
+                result = cpiAcks_CreateWithResults(message->sequenceNumber, original, message->resultCount, results);
+                parcMemory_Deallocate((void **) &results);
+            } else {
+                result = cpiAcks_CreateWithSequenceNumber(message->sequenceNumber, message->ackType == ACK_ACK, original);
+            }
+            parcJSON_Release(&original);
+            break;
+        }
+
+        case CPI_RESPONSE: {
+            if (message->operation == CPI_PREFIX_REGISTRATION_LIST) {
+                CPIRouteEntryList *list = cpiBinary_CreateRouteEntryList(message);
+                operationJson = cpiRouteEntryList_ToJson(list);
+                cpiRouteEntryList_Destroy(&list);
+            } else {
+                operationJson = parcJSON_Create();
+            }
+            result = _createJson(cpiResponse_GetJsonTag(), message->sequenceNumber, message->operation, operationJson);
+            break;
+        }
+
+        default: {
+            if (message->operation == CPI_REGISTER_PREFIXES) {
+                CPIRouteEntryList *list = cpiBinary_CreateRouteEntryList(message);
+                operationJson = cpiRouteEntryList_ToJson(list);
+                cpiRouteEntryList_Destroy(&list);
+            } else if (message->routeCount > 0) {
+                CPIRouteEntry *route = cpiBinary_CreateRouteEntry(&message->route);
+                operationJson = cpiRouteEntry_ToJson(route);
+                cpiRouteEntry_Destroy(&route);
+            } else {
+                operationJson = parcJSON_Create();
+            }
+            result = _createJson(cpiRequest_GetJsonTag(), message->sequenceNumber, message->operation, operationJson);
+            break;
+        }
+    }
+
+    parcJSON_Release(&operationJson);
+    return result;
+}
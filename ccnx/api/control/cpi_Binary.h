@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file cpi_Binary.h
+ * @brief A compact binary encoding of the common CPI messages
+ *
+ * The JSON form of a CPI message is parsed again by every component that looks at it.  The
+ * messages that flow on every connection -- route add and remove, route list, pause, flush
+ * and their acks -- also have this binary form, which is read in place by `cpiBinary_Parse()`
+ * without allocating memory.  A binary message is carried in the payload of a control
+ * dictionary (see `ccnxControlFacade_CreateBinaryCPI()`), and `cpiBinary_ToJson()` gives the
+ * equivalent JSON for debugging and for peers that only speak JSON.
+ *
+ * All integers are in network byte order.  A message is a fixed header followed by TLVs:
+ *
+ * @code
+ *   0      1      2             4                            12
+ *   +------+------+-------------+----------------------------+--------
+ *   | ver  | type |  operation  |      sequence number       | TLVs...
+ *   +------+------+-------------+----------------------------+--------
+ *
+ *   TLV: 2 byte type, 2 byte length, value
+ *     CPIBinaryTlv_Route     (nested route TLVs)
+ *       CPIBinaryTlv_Prefix    name URI, not null terminated
+ *       CPIBinaryTlv_Symbolic  symbolic name, not null terminated
+ *       CPIBinaryTlv_Interface 4 byte interface index
+ *       CPIBinaryTlv_Nexthop   JSON of the nexthop address (rarely used)
+ *       CPIBinaryTlv_Protocol  1 byte CPINameRouteProtocolType
+ *       CPIBinaryTlv_RouteType 1 byte CPINameRouteType
+ *       CPIBinaryTlv_Cost      4 byte cost
+ *       CPIBinaryTlv_Lifetime  8 byte seconds, 4 byte microseconds
+ *     CPIBinaryTlv_Ack       8 byte original sequence number, 1 byte CpiAckType
+ *     CPIBinaryTlv_Results   1 byte CpiAckType per entry of a batched request
+ * @endcode
+ *
+ * A REGISTER or UNREGISTER request carries one route, a route list response or batched
+ * REGISTER (CPI_REGISTER_PREFIXES) carries one route TLV per entry and an ack carries the
+ * ack TLV, plus the results TLV if it answers a batch.  The operation of an ack is the
+ * operation of the request it acknowledges.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libccnx_cpi_Binary_h
+#define libccnx_cpi_Binary_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_JSON.h>
+
+#include <ccnx/api/control/controlPlaneInterface.h>
+#include <ccnx/api/control/cpi_RouteEntry.h>
+#include <ccnx/api/control/cpi_RouteEntryList.h>
+
+#define CPI_BINARY_VERSION 1
+
+typedef enum {
+    CPIBinaryTlv_Route = 1,
+    CPIBinaryTlv_Prefix = 2,
+    CPIBinaryTlv_Symbolic = 3,
+    CPIBinaryTlv_Interface = 4,
+    CPIBinaryTlv_Nexthop = 5,
+    CPIBinaryTlv_Protocol = 6,
+    CPIBinaryTlv_RouteType = 7,
+    CPIBinaryTlv_Cost = 8,
+    CPIBinaryTlv_Lifetime = 9,
+    CPIBinaryTlv_Ack = 10,
+    CPIBinaryTlv_Results = 11
+} CPIBinaryTlvType;
+
+/**
+ * A route inside a binary CPI message.  The strings point into the encoding and
+ * are not null terminated, they are only valid as long as the encoding is.
+ */
+typedef struct cpi_binary_route {
+    const char *prefix;
+    size_t prefixLength;
+    const char *symbolic;
+    size_t symbolicLength;
+    const char *nexthop;
+    size_t nexthopLength;
+    bool hasInterfaceIndex;
+    uint32_t interfaceIndex;
+    CPINameRouteProtocolType routingProtocol;
+    CPINameRouteType routeType;
+    uint32_t cost;
+    bool hasLifetime;
+    struct timeval lifetime;
+} CPIBinaryRoute;
+
+/**
+ * A parsed binary CPI message.  It points into the encoding, which must outlive it.
+ */
+typedef struct cpi_binary_message {
+    CpiMessageType messageType;
+    CpiOperation operation;
+    uint64_t sequenceNumber;
+
+    // valid for CPI_ACK
+    CpiAckType ackType;
+    uint64_t originalSequenceNumber;
+
+    // valid for the CPI_ACK of a batch, see cpiBinary_GetResult()
+    const uint8_t *results;
+    size_t resultCount;
+
+    // the first route, if routeCount > 0
+    CPIBinaryRoute route;
+    size_t routeCount;
+
+    const uint8_t *tlvs;
+    size_t tlvsLength;
+} CPIBinaryMessage;
+
+/**
+ * Create a binary CPI request with the next CPI sequence number
+ *
+ * Supported operations are CPI_REGISTER_PREFIX and CPI_UNREGISTER_PREFIX, which need a route,
+ * and CPI_PREFIX_REGISTRATION_LIST, CPI_PAUSE and CPI_FLUSH, which do not.
+ *
+ * @param [in] operation The request operation
+ * @param [in] optionalRoute The route of a REGISTER or UNREGISTER, otherwise NULL
+ *
+ * @return non-null The encoding, release with parcBuffer_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PAUSE, NULL);
+ *     CCNxControl *control = ccnxControlFacade_CreateBinaryCPI(encoding);
+ *     parcBuffer_Release(&encoding);
+ * }
+ * @endcode
+ */
+PARCBuffer *cpiBinary_CreateRequest(CpiOperation operation, const CPIRouteEntry *optionalRoute);
+
+/**
+ * Create the binary ACK or NACK of a binary request
+ *
+ * @param [in] request A parsed binary request
+ * @param [in] ackType ACK_ACK or ACK_NACK
+ *
+ * @return non-null The encoding, release with parcBuffer_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIBinaryMessage request;
+ *     if (cpiBinary_Parse(encoding, &request)) {
+ *         PARCBuffer *ack = cpiBinary_CreateAck(&request, ACK_ACK);
+ *         ...
+ *         parcBuffer_Release(&ack);
+ *     }
+ * }
+ * @endcode
+ */
+PARCBuffer *cpiBinary_CreateAck(const CPIBinaryMessage *request, CpiAckType ackType);
+
+/**
+ * Create a binary CPI_REGISTER_PREFIXES request, the binary form of cpiForwarding_AddRoutes()
+ *
+ * Like the JSON form it reserves one sequence number per route.  A binary batch holds at
+ * most UINT16_MAX routes, so its results fit in one TLV.
+ *
+ * @param [in] routes The routes to register
+ *
+ * @return non-null The encoding, release with parcBuffer_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *encoding = cpiBinary_CreateAddRoutesRequest(routes);
+ *     CCNxControl *control = ccnxControlFacade_CreateBinaryCPI(encoding);
+ *     parcBuffer_Release(&encoding);
+ * }
+ * @endcode
+ */
+PARCBuffer *cpiBinary_CreateAddRoutesRequest(const CPIRouteEntryList *routes);
+
+/**
+ * Create the binary ack of a batch, with one result per entry
+ *
+ * The ack type is ACK_ACK if every result is true, otherwise ACK_NACK.
+ *
+ * @param [in] request A parsed binary request
+ * @param [in] count The number of results
+ * @param [in] results true for each entry that was accepted
+ *
+ * @return non-null The encoding, release with parcBuffer_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     bool results[] = { true, true, false };
+ *     PARCBuffer *ack = cpiBinary_CreateAckWithResults(&request, 3, results);
+ *     parcBuffer_Release(&ack);
+ * }
+ * @endcode
+ */
+PARCBuffer *cpiBinary_CreateAckWithResults(const CPIBinaryMessage *request, size_t count, const bool *results);
+
+/**
+ * Create the binary response to a route list request
+ *
+ * @param [in] request A parsed CPI_PREFIX_REGISTRATION_LIST request
+ * @param [in] list The routes to return
+ *
+ * @return non-null The encoding, release with parcBuffer_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *response = cpiBinary_CreateRouteListResponse(&request, fib);
+ *     parcBuffer_Release(&response);
+ * }
+ * @endcode
+ */
+PARCBuffer *cpiBinary_CreateRouteListResponse(const CPIBinaryMessage *request, const CPIRouteEntryList *list);
+
+/**
+ * Parse a binary CPI message in place
+ *
+ * Nothing is allocated.  The message points into `encoding`, starting at its position.
+ *
+ * @param [in] encoding A binary CPI message
+ * @param [out] message Filled in on success
+ *
+ * @return true The encoding is a valid binary CPI message
+ * @return false The encoding is malformed, `message` is undefined
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIBinaryMessage message;
+ *     if (cpiBinary_Parse(encoding, &message) && message.operation == CPI_PAUSE) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool cpiBinary_Parse(const PARCBuffer *encoding, CPIBinaryMessage *message);
+
+/**
+ * The result of entry `index` in the ack of a batch
+ *
+ * @param [in] message A parsed ack with `resultCount` greater than `index`
+ * @param [in] index The entry
+ *
+ * @return true The entry was accepted
+ * @return false The entry was rejected
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < message.resultCount; i++) {
+ *         if (!cpiBinary_GetResult(&message, i)) {
+ *             ...
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+bool cpiBinary_GetResult(const CPIBinaryMessage *message, size_t index);
+
+/**
+ * Step through the routes of a parsed message
+ *
+ * `cursor` must be 0 on the first call.  Nothing is allocated.
+ *
+ * @param [in] message A parsed binary message
+ * @param [in,out] cursor The iteration state
+ * @param [out] route Filled in with the next route
+ *
+ * @return true `route` is the next route
+ * @return false There are no more routes
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t cursor = 0;
+ *     CPIBinaryRoute route;
+ *     while (cpiBinary_NextRoute(&message, &cursor, &route)) {
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+bool cpiBinary_NextRoute(const CPIBinaryMessage *message, size_t *cursor, CPIBinaryRoute *route);
+
+/**
+ * Create a CPIRouteEntry from a binary route
+ *
+ * @param [in] route A route from a parsed binary message
+ *
+ * @return non-null A route entry, destroy with cpiRouteEntry_Destroy()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIRouteEntry *entry = cpiBinary_CreateRouteEntry(&message.route);
+ *     cpiRouteEntry_Destroy(&entry);
+ * }
+ * @endcode
+ */
+CPIRouteEntry *cpiBinary_CreateRouteEntry(const CPIBinaryRoute *route);
+
+/**
+ * Create a CPIRouteEntryList from all the routes of a parsed message
+ *
+ * @param [in] message A parsed binary message
+ *
+ * @return non-null A route list, destroy with cpiRouteEntryList_Destroy()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIRouteEntryList *list = cpiBinary_CreateRouteEntryList(&message);
+ *     cpiRouteEntryList_Destroy(&list);
+ * }
+ * @endcode
+ */
+CPIRouteEntryList *cpiBinary_CreateRouteEntryList(const CPIBinaryMessage *message);
+
+/**
+ * The JSON form of a binary message
+ *
+ * The result is what the JSON constructors (e.g. cpiForwarding_CreateAddRouteRequest()) would
+ * have made with the same sequence number.  The REQUEST inside an ack only carries
+ * the sequence number and operation of the original request.
+ *
+ * @param [in] message A parsed binary message
+ *
+ * @return non-null The JSON, release with parcJSON_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = cpiBinary_ToJson(&message);
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+PARCJSON *cpiBinary_ToJson(const CPIBinaryMessage *message);
+#endif // libccnx_cpi_Binary_h
@@ -126,6 +126,12 @@ cpiConnectionList_Equals(const CPIConnectionList *a, const CPIConnectionList *b)
 
 const char cpi_ConnectionList[] = "ConnectionList";
 
+const char *
+cpiConnectionList_JsonTag(void)
+{
+    return cpi_ConnectionList;
+}
+
 PARCJSON *
 cpiConnectionList_ToJson(const CPIConnectionList *list)
 {
@@ -195,4 +195,9 @@ PARCJSON *cpiConnectionList_ToJson(const CPIConnectionList *list);
  * @endcode
  */
 CPIConnectionList *cpiConnectionList_FromJson(PARCJSON *json);
+
+/**
+ * The key of the connection array in the JSON of a list, `{ key : [ connection, ... ] }`
+ */
+const char *cpiConnectionList_JsonTag(void);
 #endif // libccnx_cpi_ConnectionList_h
@@ -39,6 +39,8 @@
 #include <parc/algol/parc_Memory.h>
 
 #include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Binary.h>
+#include <ccnx/api/notify/notify_Status.h>
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_TlvDictionary.h>
 
 #include <ccnx/common/ccnx_Name.h>
@@ -62,6 +64,18 @@ ccnxControlFacade_CreateCPI(PARCJSON *ccnx_json)
     return dictionary;
 }
 
+CCNxControl *
+ccnxControlFacade_CreateBinaryCPI(PARCBuffer *encoding)
+{
+    assertNotNull(encoding, "Parameter encoding must be non-null");
+
+    CCNxTlvDictionary *dictionary = ccnxCodecSchemaV1TlvDictionary_CreateControl();
+
+    ccnxTlvDictionary_PutBuffer(dictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD, encoding);
+
+    return dictionary;
+}
+
 CCNxControl *ccnxControlFacade_CreateNotification(PARCJSON *payload) {
     assertNotNull(payload, "Parameter ccnx_json must be non-null");
     
@@ -79,10 +93,26 @@ CCNxControl *ccnxControlFacade_CreateNotification(PARCJSON *payload) {
     return dictionary;
 }
 
+CCNxControl *
+ccnxControlFacade_CreateBinaryNotification(PARCBuffer *encoding)
+{
+    assertTrue(notifyStatus_IsBinary(encoding), "Parameter encoding must be from notifyStatus_ToBinary()");
+
+    CCNxTlvDictionary *dictionary = ccnxCodecSchemaV1TlvDictionary_CreateControl();
+
+    ccnxTlvDictionary_PutBuffer(dictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD, encoding);
+
+    return dictionary;
+}
+
 PARCJSON *
 ccnxControlFacade_GetJson(const CCNxTlvDictionary *controlDictionary)
 {
     ccnxControlFacade_AssertValid(controlDictionary);
+    if (ccnxControlFacade_IsBinary(controlDictionary)) {
+        return NULL;
+    }
+
     PARCJSON *controlJSON = ccnxTlvDictionary_GetJson(controlDictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD);
 
     if (ccnxControlFacade_IsNotification(controlDictionary)) {
@@ -93,6 +123,22 @@ ccnxControlFacade_GetJson(const CCNxTlvDictionary *controlDictionary)
     return controlJSON;
 }
 
+bool
+ccnxControlFacade_IsBinary(const CCNxTlvDictionary *controlDictionary)
+{
+    return ccnxTlvDictionary_IsValueBuffer(controlDictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD);
+}
+
+PARCBuffer *
+ccnxControlFacade_GetBinary(const CCNxTlvDictionary *controlDictionary)
+{
+    ccnxControlFacade_AssertValid(controlDictionary);
+    if (!ccnxControlFacade_IsBinary(controlDictionary)) {
+        return NULL;
+    }
+    return ccnxTlvDictionary_GetBuffer(controlDictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD);
+}
+
 bool
 ccnxControlFacade_IsCPI(const CCNxTlvDictionary *controlDictionary)
 {
@@ -100,6 +146,10 @@ ccnxControlFacade_IsCPI(const CCNxTlvDictionary *controlDictionary)
     ccnxControlFacade_AssertValid(controlDictionary);
     
     result = ccnxTlvDictionary_IsControl(controlDictionary);
+    if (ccnxControlFacade_IsBinary(controlDictionary)) {
+        // binary messages are CPI unless they are a binary NotifyStatus
+        return result && !notifyStatus_IsBinary(ccnxControlFacade_GetBinary(controlDictionary));
+    }
     
     PARCJSON *controlJSON = ccnxTlvDictionary_GetJson(controlDictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD);
     if (controlJSON != NULL) {
@@ -117,6 +167,9 @@ ccnxControlFacade_IsNotification(const CCNxTlvDictionary *controlDictionary)
     bool result = false;
     
     ccnxControlFacade_AssertValid(controlDictionary);
+    if (ccnxControlFacade_IsBinary(controlDictionary)) {
+        return notifyStatus_IsBinary(ccnxControlFacade_GetBinary(controlDictionary));
+    }
         
     PARCJSON *controlJSON = ccnxTlvDictionary_GetJson(controlDictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD);
     if (controlJSON != NULL && (parcJSON_GetValueByName(controlJSON, _NotificationIndicator) != NULL)) {
@@ -140,6 +193,21 @@ ccnxControlFacade_ToString(const CCNxTlvDictionary *contentDictionary)
     PARCJSON *json = ccnxControlFacade_GetJson(contentDictionary);
     if (json != NULL) {
         jsonString = parcJSON_ToString(json);
+    } else if (ccnxControlFacade_IsNotification(contentDictionary)) {
+        NotifyStatus *status = notifyStatus_ParseBinary(ccnxControlFacade_GetBinary(contentDictionary));
+        if (status != NULL) {
+            json = notifyStatus_ToJSON(status);
+            jsonString = parcJSON_ToString(json);
+            parcJSON_Release(&json);
+            notifyStatus_Release(&status);
+        }
+    } else if (ccnxControlFacade_IsBinary(contentDictionary)) {
+        CPIBinaryMessage message;
+        if (cpiBinary_Parse(ccnxControlFacade_GetBinary(contentDictionary), &message)) {
+            json = cpiBinary_ToJson(&message);
+            jsonString = parcJSON_ToString(json);
+            parcJSON_Release(&json);
+        }
     }
 
     int failure = asprintf(&string, "CCNxControl { isCPI=%s, isNotification=%s, JSON=\"%s\"}",
@@ -167,6 +235,7 @@ ccnxControlFacade_AssertValid(const CCNxTlvDictionary *controlDictionary)
 
     
     assertTrue(ccnxTlvDictionary_IsValueJson(controlDictionary, 
-                                             CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD), "Does not have JSON payload");
+                                             CCNxCodecSchemaV1TlvDictionary_MessageFastArray_PAYLOAD) ||
+               ccnxControlFacade_IsBinary(controlDictionary), "Does not have JSON or binary payload");
     assertTrue(ccnxTlvDictionary_IsControl(controlDictionary), "Does not have type set");
 }
@@ -91,13 +91,55 @@ CCNxControl *ccnxControlFacade_CreateNotification(PARCJSON *ccnxJson);
  */
 CCNxControl *ccnxControlFacade_CreateCPI(PARCJSON *ccnxJson);
 
+/**
+ * Creates a CPI message from a binary encoding (see cpi_Binary.h).
+ *
+ * The newly created instance must eventually be released by calling
+ * {@link ccnxControl_Release}.  The message holds a reference to the encoding.
+ *
+ * @param encoding A binary CPI message from e.g. cpiBinary_CreateRequest().
+ * @return A `CCNxControl` message.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_FLUSH, NULL);
+ *     CCNxControl *control = ccnxControlFacade_CreateBinaryCPI(encoding);
+ *     parcBuffer_Release(&encoding);
+ * }
+ * @endcode
+ */
+CCNxControl *ccnxControlFacade_CreateBinaryCPI(PARCBuffer *encoding);
+
+/**
+ * Creates a Notification control message from the binary form of a `NotifyStatus`.
+ *
+ * Cheaper than `ccnxControlFacade_CreateNotification()`, there is no JSON to build or parse.
+ * `ccnxControlFacade_IsNotification()` is true and `ccnxControlFacade_IsCPI()` is false for it.
+ * The message holds a reference to the encoding.
+ *
+ * @param encoding The binary form, from notifyStatus_ToBinary().
+ * @return A `CCNxControl` message.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *encoding = notifyStatus_ToBinary(status);
+ *     CCNxControl *control = ccnxControlFacade_CreateBinaryNotification(encoding);
+ *     parcBuffer_Release(&encoding);
+ * }
+ * @endcode
+ */
+CCNxControl *ccnxControlFacade_CreateBinaryNotification(PARCBuffer *encoding);
+
 // =====================
 // Getters
 
 /**
  * Return a pointer to the JSON object contained in the control message.
  *
- *   <#Discussion#>
+ *   A binary CPI message has no JSON object, this returns NULL for it.  Use
+ *   cpiBinary_ToJson() to see its JSON form.
  *
  * @param controlDictionary the control message to retrieve the JSON from.
  * @return the PARCJSON object from the control message.
@@ -109,6 +151,38 @@ CCNxControl *ccnxControlFacade_CreateCPI(PARCJSON *ccnxJson);
  */
 PARCJSON *ccnxControlFacade_GetJson(const CCNxTlvDictionary *controlDictionary);
 
+/**
+ * Test whether a control message carries a binary CPI encoding.
+ *
+ * @param controlDictionary the control message to test.
+ * @return true if the payload is a binary CPI message, see ccnxControlFacade_GetBinary().
+ * @return false if the payload is JSON.
+ *
+ * Example:
+ * @code
+ * {
+ *     if (ccnxControlFacade_IsBinary(control)) {
+ *         CPIBinaryMessage message;
+ *         cpiBinary_Parse(ccnxControlFacade_GetBinary(control), &message);
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxControlFacade_IsBinary(const CCNxTlvDictionary *controlDictionary);
+
+/**
+ * Return the binary CPI encoding of the control message.
+ *
+ * @param controlDictionary the control message to retrieve the encoding from.
+ * @return the encoding, or NULL if the message is not binary.  Do not release it.
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+PARCBuffer *ccnxControlFacade_GetBinary(const CCNxTlvDictionary *controlDictionary);
+
 /**
  * Test whether a control message is a Notification.
  *
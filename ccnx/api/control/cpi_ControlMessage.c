@@ -32,6 +32,8 @@
 
 #include <LongBow/runtime.h>
 
+#include <parc/algol/parc_Memory.h>
+
 #include <ccnx/api/control/cpi_ControlMessage.h>
 
 #include <ccnx/api/control/cpi_ControlFacade.h>
@@ -39,6 +41,10 @@
 #include <ccnx/api/notify/notify_Status.h>
 
 #include <ccnx/api/control/controlPlaneInterface.h>
+#include <ccnx/api/control/cpi_Binary.h>
+#include <ccnx/api/control/cpi_Acks.h>
+
+#include "cpi_private.h"
 
 PARCJSON *
 ccnxControl_GetJson(const CCNxControl *control)
@@ -64,10 +70,25 @@ ccnxControl_Acquire(const CCNxControl *control)
     return ccnxTlvDictionary_Acquire(control);
 }
 
+/**
+ * Parse a binary control message, which must be well formed
+ */
+static void
+_ccnxControl_ParseBinary(const CCNxControl *control, CPIBinaryMessage *message)
+{
+    bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(control), message);
+    assertTrue(success, "Malformed binary CPI message");
+}
+
 bool
 ccnxControl_IsACK(const CCNxControl *control)
 {
     if (cpi_GetMessageType(control) == CPI_ACK) {
+        if (ccnxControlFacade_IsBinary(control)) {
+            CPIBinaryMessage message;
+            _ccnxControl_ParseBinary(control, &message);
+            return message.ackType == ACK_ACK;
+        }
         PARCJSON *json = ccnxControlFacade_GetJson(control);
         return cpiAcks_IsAck(json);
     }
@@ -78,6 +99,11 @@ bool
 ccnxControl_IsNACK(const CCNxControl *control)
 {
     if (cpi_GetMessageType(control) == CPI_ACK) {
+        if (ccnxControlFacade_IsBinary(control)) {
+            CPIBinaryMessage message;
+            _ccnxControl_ParseBinary(control, &message);
+            return message.ackType == ACK_NACK;
+        }
         PARCJSON *json = ccnxControlFacade_GetJson(control);
         return !cpiAcks_IsAck(json);
     }
@@ -87,6 +113,12 @@ ccnxControl_IsNACK(const CCNxControl *control)
 uint64_t
 ccnxControl_GetAckOriginalSequenceNumber(const CCNxControl *control)
 {
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        _ccnxControl_ParseBinary(control, &message);
+        assertTrue(message.messageType == CPI_ACK, "Control message is not an ack");
+        return message.originalSequenceNumber;
+    }
     PARCJSON *json = ccnxControlFacade_GetJson(control);
     return cpiAcks_GetAckOriginalSequenceNumber(json);
 }
@@ -100,6 +132,9 @@ ccnxControl_IsNotification(const CCNxControl *control)
 NotifyStatus *
 ccnxControl_GetNotifyStatus(const CCNxControl *control)
 {
+    if (ccnxControlFacade_IsBinary(control)) {
+        return notifyStatus_ParseBinary(ccnxControlFacade_GetBinary(control));
+    }
     return notifyStatus_ParseJSON(ccnxControl_GetJson(control));
 }
 
@@ -190,6 +225,143 @@ ccnxControl_CreateFlushRequest(void)
     return result;
 }
 
+static CCNxControl *
+_ccnxControl_CreateBinaryRequest(CpiOperation operation, const CPIRouteEntry *optionalRoute)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(operation, optionalRoute);
+    CCNxControl *result = ccnxControlFacade_CreateBinaryCPI(encoding);
+    parcBuffer_Release(&encoding);
+    return result;
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryAddRouteRequest(const CPIRouteEntry *route)
+{
+    return _ccnxControl_CreateBinaryRequest(CPI_REGISTER_PREFIX, route);
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryRemoveRouteRequest(const CPIRouteEntry *route)
+{
+    return _ccnxControl_CreateBinaryRequest(CPI_UNREGISTER_PREFIX, route);
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryRouteListRequest(void)
+{
+    return _ccnxControl_CreateBinaryRequest(CPI_PREFIX_REGISTRATION_LIST, NULL);
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryPauseInputRequest(void)
+{
+    return _ccnxControl_CreateBinaryRequest(CPI_PAUSE, NULL);
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryFlushRequest(void)
+{
+    return _ccnxControl_CreateBinaryRequest(CPI_FLUSH, NULL);
+}
+
+CCNxControl *
+ccnxControl_CreateAck(const CCNxControl *request)
+{
+    if (cpi_GetMessageOperation((CCNxControl *) request) == CPI_REGISTER_PREFIXES) {
+        size_t count = cpiForwarding_RouteCountFromControlMessage((CCNxControl *) request);
+        bool *results = parcMemory_Allocate(count * sizeof(bool) + 1);
+        for (size_t i = 0; i < count; i++) {
+            results[i] = true;
+        }
+        CCNxControl *result = ccnxControl_CreateAckWithResults(request, count, results);
+        parcMemory_Deallocate((void **) &results);
+        return result;
+    }
+
+    CCNxControl *result;
+    if (ccnxControlFacade_IsBinary(request)) {
+        CPIBinaryMessage message;
+        _ccnxControl_ParseBinary(request, &message);
+        PARCBuffer *encoding = cpiBinary_CreateAck(&message, ACK_ACK);
+        result = ccnxControlFacade_CreateBinaryCPI(encoding);
+        parcBuffer_Release(&encoding);
+    } else {
+        PARCJSON *json = cpiAcks_CreateAck(ccnxControlFacade_GetJson(request));
+        result = ccnxControlFacade_CreateCPI(json);
+        parcJSON_Release(&json);
+    }
+    return result;
+}
+
+CCNxControl *
+ccnxControl_CreateAddRoutesRequest(const CPIRouteEntryList *routes)
+{
+    PARCJSON *cpiRequest = cpiForwarding_AddRoutes(routes);
+    CCNxControl *result = ccnxControl_CreateCPIRequest(cpiRequest);
+    parcJSON_Release(&cpiRequest);
+    return result;
+}
+
+CCNxControl *
+ccnxControl_CreateBinaryAddRoutesRequest(const CPIRouteEntryList *routes)
+{
+    PARCBuffer *encoding = cpiBinary_CreateAddRoutesRequest(routes);
+    CCNxControl *result = ccnxControlFacade_CreateBinaryCPI(encoding);
+    parcBuffer_Release(&encoding);
+    return result;
+}
+
+CCNxControl *
+ccnxControl_CreateAckWithResults(const CCNxControl *request, size_t count, const bool *results)
+{
+    CCNxControl *result;
+    if (ccnxControlFacade_IsBinary(request)) {
+        CPIBinaryMessage message;
+        _ccnxControl_ParseBinary(request, &message);
+        PARCBuffer *encoding = cpiBinary_CreateAckWithResults(&message, count, results);
+        result = ccnxControlFacade_CreateBinaryCPI(encoding);
+        parcBuffer_Release(&encoding);
+    } else {
+        PARCJSON *original;
+        if (cpi_GetMessageOperation((CCNxControl *) request) == CPI_REGISTER_PREFIXES) {
+            // Echo only the header of a batch, the caller already has its thousands of routes
+            PARCJSON *empty = parcJSON_Create();
+            original = cpi_CreateRequestWithSequenceNumber(cpiForwarding_AddRoutesJsonTag(), empty,
+                                                           cpi_GetSequenceNumber((CCNxControl *) request));
+            parcJSON_Release(&empty);
+        } else {
+            original = parcJSON_Acquire(ccnxControlFacade_GetJson(request));
+        }
+        PARCJSON *json = cpiAcks_CreateWithResults(cpi_GetNextSequenceNumber(), original, count, results);
+        result = ccnxControlFacade_CreateCPI(json);
+        parcJSON_Release(&json);
+        parcJSON_Release(&original);
+    }
+    return result;
+}
+
+size_t
+ccnxControl_GetAckResultCount(const CCNxControl *control)
+{
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        _ccnxControl_ParseBinary(control, &message);
+        return message.resultCount;
+    }
+    return cpiAcks_GetResultCount(ccnxControlFacade_GetJson(control));
+}
+
+bool
+ccnxControl_GetAckResult(const CCNxControl *control, size_t index)
+{
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        _ccnxControl_ParseBinary(control, &message);
+        return cpiBinary_GetResult(&message, index);
+    }
+    return cpiAcks_GetResult(ccnxControlFacade_GetJson(control), index);
+}
+
 bool
 ccnxControl_IsCPI(const CCNxControl *controlMsg)
 {
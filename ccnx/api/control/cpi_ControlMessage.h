@@ -45,6 +45,7 @@
 #include <ccnx/api/notify/notify_Status.h>
 
 #include <ccnx/api/control/cpi_RouteEntry.h>
+#include <ccnx/api/control/cpi_RouteEntryList.h>
 #include <ccnx/api/control/cpi_InterfaceIPTunnel.h>
 
 /**
@@ -212,6 +213,7 @@ bool ccnxControl_IsNACK(const CCNxControl *control);
  * This function creates a new instance of `NotifyStatus`, initialized from the specified
  * `CCNxControl`, which must eventually be released by calling {@link notifyStatus_Release}().
  * If the specified `CCNxControl` instance does not contain a `NotifyStatus`, this function will return NULL.
+ * The notification may be JSON or binary (see ccnxControlFacade_CreateBinaryNotification()).
  *
  * @param [in] control A pointer to the instance of `CCNxControl` from which to retrieve the `NotifyStatus`.
  *
@@ -482,6 +484,139 @@ CCNxControl *ccnxControl_CreatePauseInputRequest(void);
  */
 CCNxControl *ccnxControl_CreateFlushRequest(void);
 
+/**
+ * Creates requests in the binary CPI encoding (see cpi_Binary.h).
+ *
+ * These are the binary forms of ccnxControl_CreateAddRouteRequest(),
+ * ccnxControl_CreateRemoveRouteRequest(), ccnxControl_CreateRouteListRequest(),
+ * ccnxControl_CreatePauseInputRequest() and ccnxControl_CreateFlushRequest().  The transport
+ * reads a binary request in place instead of parsing JSON, and its answers to a binary
+ * request are binary as well.  The accessors in this file work on both forms.
+ *
+ * @param [in] route The route to add or remove.
+ *
+ * @retval non-null An allocated CCnxControl message
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxControl *control = ccnxControl_CreateBinaryAddRouteRequest(route);
+ *     ...
+ *     ccnxControl_Release(&control);
+ * }
+ * @endcode
+ *
+ * @see {@link cpiBinary_CreateRequest}
+ */
+CCNxControl *ccnxControl_CreateBinaryAddRouteRequest(const CPIRouteEntry *route);
+CCNxControl *ccnxControl_CreateBinaryRemoveRouteRequest(const CPIRouteEntry *route);
+CCNxControl *ccnxControl_CreateBinaryRouteListRequest(void);
+CCNxControl *ccnxControl_CreateBinaryPauseInputRequest(void);
+CCNxControl *ccnxControl_CreateBinaryFlushRequest(void);
+
+/**
+ * Creates the ACK of a CPI request.
+ *
+ * The ACK has the same encoding, JSON or binary, as the request.
+ *
+ * @param [in] request A CPI request.
+ *
+ * @retval non-null An allocated CCnxControl message
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxControl *ack = ccnxControl_CreateAck(request);
+ *     assertTrue(ccnxControl_GetAckOriginalSequenceNumber(ack) == cpi_GetSequenceNumber(request), "Wrong sequence number");
+ *     ccnxControl_Release(&ack);
+ * }
+ * @endcode
+ */
+CCNxControl *ccnxControl_CreateAck(const CCNxControl *request);
+
+/**
+ * Create a new `CCNxControl` instance that registers every route of a list in one request.
+ *
+ * The transport forwards the batch as one message and answers it with a single ACK whose
+ * results (see {@link ccnxControl_GetAckResult}) say which routes were accepted.  The ACK is
+ * an ACK only if every route was accepted, otherwise it is a NACK.
+ *
+ * `ccnxControl_CreateBinaryAddRoutesRequest()` creates the binary form.
+ *
+ * @param [in] routes The routes to add.
+ *
+ * @retval non-null An allocated CCnxControl message
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxControl *control = ccnxControl_CreateAddRoutesRequest(routes);
+ *     ...
+ *     ccnxControl_Release(&control);
+ * }
+ * @endcode
+ *
+ * @see {@link cpiForwarding_AddRoutes}
+ */
+CCNxControl *ccnxControl_CreateAddRoutesRequest(const CPIRouteEntryList *routes);
+CCNxControl *ccnxControl_CreateBinaryAddRoutesRequest(const CPIRouteEntryList *routes);
+
+/**
+ * Creates the ACK of a batched request, with one result per entry.
+ *
+ * The ACK has the same encoding, JSON or binary, as the request.  It is an ACK if every
+ * result is true and a NACK otherwise.
+ *
+ * @param [in] request A CPI request, e.g. from {@link ccnxControl_CreateAddRoutesRequest}
+ * @param [in] count The number of results
+ * @param [in] results true for each entry that was accepted
+ *
+ * @retval non-null An allocated CCnxControl message
+ *
+ * Example:
+ * @code
+ * {
+ *     bool results[] = { true, false };
+ *     CCNxControl *ack = ccnxControl_CreateAckWithResults(request, 2, results);
+ *     assertTrue(ccnxControl_IsNACK(ack), "A rejected route makes the batch a NACK");
+ *     ccnxControl_Release(&ack);
+ * }
+ * @endcode
+ */
+CCNxControl *ccnxControl_CreateAckWithResults(const CCNxControl *request, size_t count, const bool *results);
+
+/**
+ * The number of per-entry results of an ACK.
+ *
+ * @param [in] control A CPI ACK
+ *
+ * @retval 0 The ACK has no results, e.g. it answers a single request
+ * @retval positive The number of entries in the batch it answers
+ */
+size_t ccnxControl_GetAckResultCount(const CCNxControl *control);
+
+/**
+ * The result of entry `index` of the batch an ACK answers.
+ *
+ * @param [in] control A CPI ACK with more than `index` results
+ * @param [in] index The position of the entry in the request
+ *
+ * @retval true The entry was accepted
+ * @retval false The entry was rejected
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < ccnxControl_GetAckResultCount(ack); i++) {
+ *         if (!ccnxControl_GetAckResult(ack, i)) {
+ *             printf("route %zu was rejected\n", i);
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+bool ccnxControl_GetAckResult(const CCNxControl *control, size_t index);
+
 /**
  * Create a new `CCNxControl` instance containing a "Cancel Flow" request.
  *
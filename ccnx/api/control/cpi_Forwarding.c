@@ -33,6 +33,8 @@
 
 #include <ccnx/api/control/controlPlaneInterface.h>
 #include <ccnx/api/control/cpi_Forwarding.h>
+#include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Binary.h>
 #include <LongBow/runtime.h>
 
 #include "cpi_private.h"
@@ -40,6 +42,7 @@
 static const char *cpiRegister = "REGISTER";
 static const char *cpiUnregister = "UNREGISTER";
 static const char *cpiRouteList = "ROUTE_LIST";
+static const char *cpiAddRoutes = "ADD_ROUTES";
 
 PARCJSON *
 cpiForwarding_CreateAddRouteRequest(const CPIRouteEntry *route)
@@ -103,6 +106,15 @@ CPIRouteEntry *
 cpiForwarding_RouteFromControlMessage(CCNxControl *control)
 {
     assertNotNull(control, "Parameter control must be non-null");
+
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        if (cpiBinary_Parse(ccnxControlFacade_GetBinary(control), &message) && message.routeCount > 0) {
+            return cpiBinary_CreateRouteEntry(&message.route);
+        }
+        return NULL;
+    }
+
     PARCJSON *json = ccnxControl_GetJson(control);
 
     PARCJSONPair *routeOpPair = cpi_ParseRequest(json);
@@ -119,6 +131,12 @@ cpiForwarding_AddRouteJsonTag()
     return cpiRegister;
 }
 
+const char *
+cpiForwarding_AddRoutesJsonTag()
+{
+    return cpiAddRoutes;
+}
+
 const char *
 cpiForwarding_RemoveRouteJsonTag()
 {
@@ -144,6 +162,13 @@ cpiForwarding_CreateRouteListRequest()
 CPIRouteEntryList *
 cpiForwarding_RouteListFromControlMessage(CCNxControl *control)
 {
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(control), &message);
+        assertTrue(success, "Malformed binary CPI message");
+        return cpiBinary_CreateRouteEntryList(&message);
+    }
+
     PARCJSON *json = ccnxControl_GetJson(control);
     PARCJSONValue *value = parcJSON_GetValueByName(json, cpiRequest_GetJsonTag());
     if (value == NULL) {
@@ -155,3 +180,70 @@ cpiForwarding_RouteListFromControlMessage(CCNxControl *control)
     PARCJSON *operation = parcJSONValue_GetJSON(value);
     return cpiRouteEntryList_FromJson(operation);
 }
+
+PARCJSON *
+cpiForwarding_AddRoutes(const CPIRouteEntryList *routes)
+{
+    assertNotNull(routes, "Parameter routes must be non-null");
+
+    // One sequence number per entry, so the forwarder's per-route acks map back to list positions
+    uint64_t sequenceNumber = cpi_GetNextSequenceNumbers(cpiRouteEntryList_Length(routes));
+
+    PARCJSON *operation = cpiRouteEntryList_ToJson(routes);
+    PARCJSON *result = cpi_CreateRequestWithSequenceNumber(cpiAddRoutes, operation, sequenceNumber);
+    parcJSON_Release(&operation);
+
+    return result;
+}
+
+PARCJSON *
+cpiForwarding_CreateAddRouteRequestInBatch(const CPIRouteEntry *route, uint64_t batchSequenceNumber, size_t index)
+{
+    PARCJSON *operation = cpiRouteEntry_ToJson(route);
+    PARCJSON *result = cpi_CreateRequestWithSequenceNumber(cpiRegister, operation, batchSequenceNumber + index);
+    parcJSON_Release(&operation);
+
+    return result;
+}
+
+CPIRouteEntryList *
+cpiForwarding_RoutesFromControlMessage(CCNxControl *control)
+{
+    assertNotNull(control, "Parameter control must be non-null");
+
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(control), &message);
+        assertTrue(success, "Malformed binary CPI message");
+        return cpiBinary_CreateRouteEntryList(&message);
+    }
+
+    PARCJSON *json = ccnxControl_GetJson(control);
+
+    PARCJSONPair *routesOpPair = cpi_ParseRequest(json);
+    PARCJSON *routesJson = parcJSONValue_GetJSON(parcJSONPair_GetValue(routesOpPair));
+
+    return cpiRouteEntryList_FromJson(routesJson);
+}
+
+size_t
+cpiForwarding_RouteCountFromControlMessage(CCNxControl *control)
+{
+    assertNotNull(control, "Parameter control must be non-null");
+
+    if (ccnxControlFacade_IsBinary(control)) {
+        CPIBinaryMessage message;
+        bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(control), &message);
+        assertTrue(success, "Malformed binary CPI message");
+        return message.routeCount;
+    }
+
+    // The operation is { cpi_RouteEntryList : [ ... ] }, count the array without creating the routes
+    PARCJSONPair *routesOpPair = cpi_ParseRequest(ccnxControl_GetJson(control));
+    PARCJSON *routesJson = parcJSONValue_GetJSON(parcJSONPair_GetValue(routesOpPair));
+    PARCJSONPair *listPair = parcJSON_GetPairByIndex(routesJson, 0);
+    if (listPair == NULL) {
+        return 0;
+    }
+    return parcJSONArray_GetLength(parcJSONValue_GetArray(parcJSONPair_GetValue(listPair)));
+}
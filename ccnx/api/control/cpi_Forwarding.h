@@ -247,4 +247,66 @@ const char *cpiForwarding_RemoveRouteJsonTag();
  * @see <#references#>
  */
 const char *cpiForwarding_RouteListJsonTag();
+
+/**
+ * The JSON tag of a batched route registration, see cpiForwarding_AddRoutes()
+ */
+const char *cpiForwarding_AddRoutesJsonTag();
+
+/**
+ * Creates one control message that registers every route in the list
+ *
+ *   Registering thousands of prefixes one `cpiForwarding_AddRoute()` at a time costs a
+ *   request, a trip through the stack and an ack per route.  The batch travels as a single
+ *   message and is answered by a single ack whose result vector (see `ccnxControl_GetAckResult()`)
+ *   has one entry per route, in list order.
+ *
+ *   The request reserves one sequence number per route: route `i` is `SEQUENCE + i`.
+ *
+ * @param [in] routes The routes to register, may be empty
+ *
+ * @return non-null A CPI request with operation CPI_REGISTER_PREFIXES
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = cpiForwarding_AddRoutes(routes);
+ *     CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+PARCJSON *cpiForwarding_AddRoutes(const CPIRouteEntryList *routes);
+
+/**
+ * The single REGISTER request for entry `index` of a batch
+ *
+ *   Used where the batch is taken apart for a forwarder that only knows single-route
+ *   requests.  The request's sequence number is `batchSequenceNumber + index`.
+ *
+ * @param [in] route The route at position `index`
+ * @param [in] batchSequenceNumber The sequence number of the batch request
+ * @param [in] index The position of the route in the batch
+ *
+ * @return non-null A CPI_REGISTER_PREFIX request
+ */
+PARCJSON *cpiForwarding_CreateAddRouteRequestInBatch(const CPIRouteEntry *route, uint64_t batchSequenceNumber, size_t index);
+
+/**
+ * The routes of a CPI_REGISTER_PREFIXES request, JSON or binary
+ *
+ * @param [in] control A batched route registration
+ *
+ * @return non-null An allocated list, destroy with `cpiRouteEntryList_Destroy()`
+ */
+CPIRouteEntryList *cpiForwarding_RoutesFromControlMessage(CCNxControl *control);
+
+/**
+ * The number of routes in a CPI_REGISTER_PREFIXES request, without creating them
+ *
+ * @param [in] control A batched route registration
+ *
+ * @return The number of routes
+ */
+size_t cpiForwarding_RouteCountFromControlMessage(CCNxControl *control);
 #endif // libccnx_cpi_ManageForwarding_h
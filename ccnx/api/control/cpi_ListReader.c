@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/control/controlPlaneInterface.h>
+#include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Binary.h>
+#include <ccnx/api/control/cpi_ListReader.h>
+#include <ccnx/api/control/cpi_RouteEntryList.h>
+#include <ccnx/api/control/cpi_ConnectionList.h>
+#include <ccnx/api/control/cpi_ManageLinks.h>
+
+typedef enum {
+    _ListReaderSource_Binary,
+    _ListReaderSource_Json,
+    _ListReaderSource_Text
+} _ListReaderSource;
+
+typedef enum {
+    _ListReaderType_Route,
+    _ListReaderType_Connection
+} _ListReaderType;
+
+struct cpi_list_reader {
+    _ListReaderType type;
+    _ListReaderSource source;
+    size_t count;
+    bool failed;
+
+    // _ListReaderSource_Binary and _ListReaderSource_Json
+    CCNxControl *response;
+
+    // _ListReaderSource_Binary: the message points into the response's buffer
+    CPIBinaryMessage message;
+    size_t cursor;
+
+    // _ListReaderSource_Json: the array belongs to the response's JSON
+    PARCJSONArray *array;
+    size_t index;
+
+    // _ListReaderSource_Text: `offset` is just inside the list's '[' until it reaches the ']'
+    PARCBuffer *text;
+    const char *chars;
+    size_t length;
+    size_t offset;
+    bool done;
+};
+
+static CPIListReader *
+_cpiListReader_Create(_ListReaderType type, _ListReaderSource source)
+{
+    CPIListReader *reader = parcMemory_AllocateAndClear(sizeof(CPIListReader));
+    assertNotNull(reader, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(CPIListReader));
+    reader->type = type;
+    reader->source = source;
+    return reader;
+}
+
+// =====================================================================
+// JSON of a control message
+
+/**
+ * { CPI_RESPONSE : { SEQUENCE : n, operationTag : { listTag : [ ... ] } } }
+ */
+static PARCJSONArray *
+_findArray(CCNxControl *response, const char *operationTag, const char *listTag)
+{
+    PARCJSON *json = ccnxControl_GetJson(response);
+    assertNotNull(json, "Control message has no JSON");
+
+    PARCJSONValue *value = parcJSON_GetValueByName(json, cpiResponse_GetJsonTag());
+    if (value == NULL) {
+        value = parcJSON_GetValueByName(json, cpiRequest_GetJsonTag());
+    }
+    assertNotNull(value, "Not a CPI response: %s", parcJSON_ToString(json));
+
+    value = parcJSON_GetValueByName(parcJSONValue_GetJSON(value), operationTag);
+    assertNotNull(value, "Response has no %s: %s", operationTag, parcJSON_ToString(json));
+
+    value = parcJSON_GetValueByName(parcJSONValue_GetJSON(value), listTag);
+    assertNotNull(value, "Response has no %s: %s", listTag, parcJSON_ToString(json));
+
+    return parcJSONValue_GetArray(value);
+}
+
+static CPIListReader *
+_cpiListReader_CreateFromJson(_ListReaderType type, CCNxControl *response, const char *operationTag, const char *listTag)
+{
+    CPIListReader *reader = _cpiListReader_Create(type, _ListReaderSource_Json);
+    reader->response = ccnxControl_Acquire(response);
+    reader->array = _findArray(response, operationTag, listTag);
+    return reader;
+}
+
+static PARCJSON *
+_nextJson(CPIListReader *reader)
+{
+    if (reader->index >= parcJSONArray_GetLength(reader->array)) {
+        return NULL;
+    }
+    PARCJSONValue *value = parcJSONArray_GetValue(reader->array, reader->index++);
+    return parcJSON_Acquire(parcJSONValue_GetJSON(value));
+}
+
+// =====================================================================
+// JSON text
+
+static void
+_skipWhitespace(CPIListReader *reader)
+{
+    while (reader->offset < reader->length) {
+        char c = reader->chars[reader->offset];
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            break;
+        }
+        reader->offset++;
+    }
+}
+
+/**
+ * Step over the string that starts at `offset`, which must be a '"'
+ *
+ * @return false The string is not terminated
+ */
+static bool
+_skipString(CPIListReader *reader)
+{
+    reader->offset++;
+    while (reader->offset < reader->length) {
+        char c = reader->chars[reader->offset++];
+        if (c == '\\') {
+            reader->offset++;
+        } else if (c == '"') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Move `offset` just inside the '[' of `"listTag" : [`
+ *
+ * Only strings are matched, so the tag inside a value, e.g. a prefix, is not mistaken for the key.
+ *
+ * @return false The text has no such list
+ */
+static bool
+_findList(CPIListReader *reader, const char *listTag)
+{
+    size_t tagLength = strlen(listTag);
+
+    while (reader->offset < reader->length) {
+        if (reader->chars[reader->offset] != '"') {
+            reader->offset++;
+            continue;
+        }
+
+        size_t start = reader->offset + 1;
+        if (!_skipString(reader)) {
+            return false;
+        }
+
+        // the string without its quotes
+        size_t stringLength = reader->offset - 1 - start;
+        if (stringLength == tagLength && memcmp(reader->chars + start, listTag, tagLength) == 0) {
+            _skipWhitespace(reader);
+            if (reader->offset < reader->length && reader->chars[reader->offset] == ':') {
+                reader->offset++;
+                _skipWhitespace(reader);
+                if (reader->offset < reader->length && reader->chars[reader->offset] == '[') {
+                    reader->offset++;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Find the next object of the list and step past it and its ','
+ *
+ * @return false The list has ended, or is malformed and `failed` is set
+ */
+static bool
+_nextObject(CPIListReader *reader, size_t *start, size_t *length)
+{
+    _skipWhitespace(reader);
+    if (reader->offset >= reader->length) {
+        reader->failed = true;
+        return false;
+    }
+
+    if (reader->chars[reader->offset] == ']') {
+        reader->done = true;
+        return false;
+    }
+
+    if (reader->chars[reader->offset] != '{') {
+        reader->failed = true;
+        return false;
+    }
+
+    *start = reader->offset;
+    unsigned depth = 0;
+    while (reader->offset < reader->length) {
+        char c = reader->chars[reader->offset];
+        if (c == '"') {
+            if (!_skipString(reader)) {
+                break;
+            }
+            continue;
+        }
+
+        reader->offset++;
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+            if (depth == 0) {
+                *length = reader->offset - *start;
+
+                _skipWhitespace(reader);
+                if (reader->offset < reader->length && reader->chars[reader->offset] == ',') {
+                    reader->offset++;
+                }
+                return true;
+            }
+        }
+    }
+
+    reader->failed = true;
+    return false;
+}
+
+static CPIListReader *
+_cpiListReader_CreateFromText(_ListReaderType type, PARCBuffer *text, const char *listTag)
+{
+    assertNotNull(text, "Parameter text must be non-null");
+
+    CPIListReader *reader = _cpiListReader_Create(type, _ListReaderSource_Text);
+    reader->text = parcBuffer_Acquire(text);
+    reader->chars = parcBuffer_Overlay(text, 0);
+    reader->length = parcBuffer_Remaining(text);
+
+    if (!_findList(reader, listTag)) {
+        reader->failed = true;
+    }
+    return reader;
+}
+
+static PARCJSON *
+_nextJsonFromText(CPIListReader *reader)
+{
+    if (reader->failed || reader->done) {
+        return NULL;
+    }
+
+    size_t start;
+    size_t length;
+    if (!_nextObject(reader, &start, &length)) {
+        return NULL;
+    }
+
+    char *string = parcMemory_StringDuplicate(reader->chars + start, length);
+    PARCJSON *json = parcJSON_ParseString(string);
+    parcMemory_Deallocate((void **) &string);
+
+    if (json == NULL) {
+        reader->failed = true;
+    }
+    return json;
+}
+
+// =====================================================================
+// Public API
+
+CPIListReader *
+cpiListReader_CreateRouteReader(CCNxControl *response)
+{
+    assertNotNull(response, "Parameter response must be non-null");
+
+    if (ccnxControlFacade_IsBinary(response)) {
+        CPIListReader *reader = _cpiListReader_Create(_ListReaderType_Route, _ListReaderSource_Binary);
+        reader->response = ccnxControl_Acquire(response);
+        bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(response), &reader->message);
+        assertTrue(success, "Malformed binary CPI message");
+        return reader;
+    }
+
+    return _cpiListReader_CreateFromJson(_ListReaderType_Route, response, cpiForwarding_RouteListJsonTag(), cpiRouteEntryList_JsonTag());
+}
+
+CPIListReader *
+cpiListReader_CreateConnectionReader(CCNxControl *response)
+{
+    assertNotNull(response, "Parameter response must be non-null");
+
+    return _cpiListReader_CreateFromJson(_ListReaderType_Connection, response, cpiLinks_ConnectionListJsonTag(), cpiConnectionList_JsonTag());
+}
+
+CPIListReader *
+cpiListReader_CreateRouteReaderFromText(PARCBuffer *text)
+{
+    return _cpiListReader_CreateFromText(_ListReaderType_Route, text, cpiRouteEntryList_JsonTag());
+}
+
+CPIListReader *
+cpiListReader_CreateConnectionReaderFromText(PARCBuffer *text)
+{
+    return _cpiListReader_CreateFromText(_ListReaderType_Connection, text, cpiConnectionList_JsonTag());
+}
+
+void
+cpiListReader_Destroy(CPIListReader **readerPtr)
+{
+    assertNotNull(readerPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*readerPtr, "Parameter must dereference to non-null pointer");
+
+    CPIListReader *reader = *readerPtr;
+    if (reader->response != NULL) {
+        ccnxControl_Release(&reader->response);
+    }
+    if (reader->text != NULL) {
+        parcBuffer_Release(&reader->text);
+    }
+    parcMemory_Deallocate((void **) readerPtr);
+}
+
+/**
+ * The JSON of the next entry of a JSON or text reader
+ */
+static PARCJSON *
+_nextEntryJson(CPIListReader *reader)
+{
+    if (reader->source == _ListReaderSource_Json) {
+        return _nextJson(reader);
+    }
+    return _nextJsonFromText(reader);
+}
+
+CPIRouteEntry *
+cpiListReader_NextRoute(CPIListReader *reader)
+{
+    assertNotNull(reader, "Parameter reader must be non-null");
+    assertTrue(reader->type == _ListReaderType_Route, "Not a route reader");
+
+    CPIRouteEntry *route = NULL;
+    if (reader->source == _ListReaderSource_Binary) {
+        CPIBinaryRoute binaryRoute;
+        if (cpiBinary_NextRoute(&reader->message, &reader->cursor, &binaryRoute)) {
+            route = cpiBinary_CreateRouteEntry(&binaryRoute);
+        }
+    } else {
+        PARCJSON *json = _nextEntryJson(reader);
+        if (json != NULL) {
+            route = cpiRouteEntry_FromJson(json);
+            parcJSON_Release(&json);
+        }
+    }
+
+    if (route != NULL) {
+        reader->count++;
+    }
+    return route;
+}
+
+CPIConnection *
+cpiListReader_NextConnection(CPIListReader *reader)
+{
+    assertNotNull(reader, "Parameter reader must be non-null");
+    assertTrue(reader->type == _ListReaderType_Connection, "Not a connection reader");
+
+    CPIConnection *connection = NULL;
+    PARCJSON *json = _nextEntryJson(reader);
+    if (json != NULL) {
+        connection = cpiConnection_CreateFromJson(json);
+        parcJSON_Release(&json);
+        reader->count++;
+    }
+    return connection;
+}
+
+size_t
+cpiListReader_GetCount(const CPIListReader *reader)
+{
+    assertNotNull(reader, "Parameter reader must be non-null");
+    return reader->count;
+}
+
+bool
+cpiListReader_HasFailed(const CPIListReader *reader)
+{
+    assertNotNull(reader, "Parameter reader must be non-null");
+    return reader->failed;
+}
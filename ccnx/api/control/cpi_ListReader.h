@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file cpi_ListReader.h
+ * @brief Read the entries of a route or connection list response one at a time
+ *
+ * `cpiForwarding_RouteListFromControlMessage()` and `cpiLinks_ConnectionListFromControlMessage()`
+ * create every entry before the caller sees the first one, so a forwarder with a million routes
+ * costs a million CPIRouteEntry at once.  A list reader creates one entry per call to
+ * `cpiListReader_NextRoute()` or `cpiListReader_NextConnection()` and the caller releases it
+ * before asking for the next, so memory stays at one entry plus the response itself.
+ *
+ * A reader works from one of three sources:
+ *
+ *   - A binary route list response (see cpi_Binary.h), read in place from its buffer.
+ *   - The JSON of a control message, stepping through its array without building a list.
+ *   - JSON text, e.g. a response saved by a management tool.  Only the text of the current
+ *     entry is parsed, the whole response is never turned into a PARCJSON.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef libccnx_cpi_ListReader_h
+#define libccnx_cpi_ListReader_h
+
+#include <stdbool.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/api/control/cpi_ControlMessage.h>
+#include <ccnx/api/control/cpi_RouteEntry.h>
+#include <ccnx/api/control/cpi_Connection.h>
+
+struct cpi_list_reader;
+typedef struct cpi_list_reader CPIListReader;
+
+/**
+ * Create a reader over the routes of a route list response
+ *
+ * The response may be JSON or binary.  The reader holds a reference to it.
+ *
+ * @param [in] response A CPI_PREFIX_REGISTRATION_LIST response
+ *
+ * @return non-null A reader, destroy with cpiListReader_Destroy()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIListReader *reader = cpiListReader_CreateRouteReader(response);
+ *     CPIRouteEntry *route;
+ *     while ((route = cpiListReader_NextRoute(reader)) != NULL) {
+ *         ...
+ *         cpiRouteEntry_Destroy(&route);
+ *     }
+ *     cpiListReader_Destroy(&reader);
+ * }
+ * @endcode
+ */
+CPIListReader *cpiListReader_CreateRouteReader(CCNxControl *response);
+
+/**
+ * Create a reader over the connections of a connection list response
+ *
+ * @param [in] response A CPI_CONNECTION_LIST response.  The reader holds a reference to it.
+ *
+ * @return non-null A reader, destroy with cpiListReader_Destroy()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIListReader *reader = cpiListReader_CreateConnectionReader(response);
+ *     CPIConnection *connection;
+ *     while ((connection = cpiListReader_NextConnection(reader)) != NULL) {
+ *         ...
+ *         cpiConnection_Release(&connection);
+ *     }
+ *     cpiListReader_Destroy(&reader);
+ * }
+ * @endcode
+ */
+CPIListReader *cpiListReader_CreateConnectionReader(CCNxControl *response);
+
+/**
+ * Create a reader over the routes in JSON text
+ *
+ * The text is a route list response, or any JSON with a route list in it.  It is scanned as
+ * the reader advances.  The reader holds a reference to `text` and reads from its position
+ * to its limit.
+ *
+ * @param [in] text UTF-8 JSON, not necessarily null terminated
+ *
+ * @return non-null A reader, destroy with cpiListReader_Destroy()
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+ *     ...
+ *     if (cpiListReader_HasFailed(reader)) {
+ *         printf("The response is malformed\n");
+ *     }
+ *     cpiListReader_Destroy(&reader);
+ * }
+ * @endcode
+ */
+CPIListReader *cpiListReader_CreateRouteReaderFromText(PARCBuffer *text);
+
+/**
+ * Create a reader over the connections in JSON text
+ *
+ * @param [in] text UTF-8 JSON with a connection list in it
+ *
+ * @return non-null A reader, destroy with cpiListReader_Destroy()
+ *
+ * @see cpiListReader_CreateRouteReaderFromText
+ */
+CPIListReader *cpiListReader_CreateConnectionReaderFromText(PARCBuffer *text);
+
+/**
+ * Destroy a reader and release what it holds
+ *
+ * @param [in,out] readerPtr The reader, set to NULL
+ */
+void cpiListReader_Destroy(CPIListReader **readerPtr);
+
+/**
+ * The next route of a route reader
+ *
+ * @param [in] reader A reader from cpiListReader_CreateRouteReader() or
+ *                    cpiListReader_CreateRouteReaderFromText()
+ *
+ * @return non-null The next route, destroy with cpiRouteEntry_Destroy()
+ * @return null There are no more routes, or the text is malformed (see cpiListReader_HasFailed())
+ */
+CPIRouteEntry *cpiListReader_NextRoute(CPIListReader *reader);
+
+/**
+ * The next connection of a connection reader
+ *
+ * @param [in] reader A reader from cpiListReader_CreateConnectionReader() or
+ *                    cpiListReader_CreateConnectionReaderFromText()
+ *
+ * @return non-null The next connection, release with cpiConnection_Release()
+ * @return null There are no more connections, or the text is malformed
+ */
+CPIConnection *cpiListReader_NextConnection(CPIListReader *reader);
+
+/**
+ * The number of entries returned so far
+ *
+ * @param [in] reader A reader
+ *
+ * @return The number of routes or connections returned by the Next functions
+ */
+size_t cpiListReader_GetCount(const CPIListReader *reader);
+
+/**
+ * Whether the reader stopped because its JSON text is malformed
+ *
+ * Messages from the transport are already validated, this is for text from elsewhere.
+ *
+ * @param [in] reader A reader
+ *
+ * @return true The text has no list, or an entry could not be parsed
+ * @return false The reader has not found a problem
+ */
+bool cpiListReader_HasFailed(const CPIListReader *reader);
+#endif // libccnx_cpi_ListReader_h
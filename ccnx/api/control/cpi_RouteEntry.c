@@ -253,6 +253,13 @@ cpiRouteEntry_SetInterfaceIndex(CPIRouteEntry *route, unsigned interfaceIndex)
     route->hasInterfaceIndex = true;
 }
 
+bool
+cpiRouteEntry_HasInterfaceIndex(const CPIRouteEntry *route)
+{
+    assertNotNull(route, "Parameter must be non-null");
+    return route->hasInterfaceIndex;
+}
+
 
 bool
 cpiRouteEntry_Equals(const CPIRouteEntry *a, const CPIRouteEntry *b)
@@ -275,6 +275,27 @@ bool cpiRouteEntry_Equals(const CPIRouteEntry *a, const CPIRouteEntry *b);
  */
 void cpiRouteEntry_SetInterfaceIndex(CPIRouteEntry *route, unsigned interfaceIndex);
 
+/**
+ * Determine if the route has an interface index
+ *
+ * Routes made with cpiRouteEntry_Create() always have one, symbolic routes only after
+ * cpiRouteEntry_SetInterfaceIndex().
+ *
+ * @param [in] route A non-null pointer to a CPIRouteEntry instance.
+ *
+ * @return true The route has an interface index
+ * @return false The route does not have an interface index
+ *
+ * Example:
+ * @code
+ * {
+ *     CPIRouteEntry *route = cpiRouteEntry_CreateSymbolic(prefix, "tun0", cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 1);
+ *     assertFalse(cpiRouteEntry_HasInterfaceIndex(route), "Symbolic route should not have an interface index");
+ * }
+ * @endcode
+ */
+bool cpiRouteEntry_HasInterfaceIndex(const CPIRouteEntry *route);
+
 /**
  * Get the name of the routing prefix in the given `CPIRouteEntry` instance.
  *
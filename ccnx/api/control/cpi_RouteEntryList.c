@@ -128,6 +128,12 @@ cpiRouteEntryList_Equals(const CPIRouteEntryList *a, const CPIRouteEntryList *b)
 
 const char cpi_RouteEntryList[] = "Routes";
 
+const char *
+cpiRouteEntryList_JsonTag(void)
+{
+    return cpi_RouteEntryList;
+}
+
 PARCJSON *
 cpiRouteEntryList_ToJson(const CPIRouteEntryList *list)
 {
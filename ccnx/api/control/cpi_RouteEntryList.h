@@ -176,4 +176,9 @@ PARCJSON *cpiRouteEntryList_ToJson(const CPIRouteEntryList *list);
  * @see <#references#>
  */
 CPIRouteEntryList *cpiRouteEntryList_FromJson(PARCJSON *json);
+
+/**
+ * The key of the route array in the JSON of a list, `{ key : [ route, ... ] }`
+ */
+const char *cpiRouteEntryList_JsonTag(void);
 #endif // libccnx_cpi_RouteEntryList_h
@@ -39,6 +39,13 @@
 
 uint64_t cpi_GetNextSequenceNumber(void);
 
+/**
+ * Reserve `count` consecutive sequence numbers
+ *
+ * @return The first of them
+ */
+uint64_t cpi_GetNextSequenceNumbers(size_t count);
+
 /**
  * Wrap the operation in a CPI_REQUEST and add sequence number
  *
@@ -54,6 +61,11 @@ uint64_t cpi_GetNextSequenceNumber(void);
  */
 PARCJSON *cpi_CreateRequest(const char *key, PARCJSON *operation);
 
+/**
+ * Like cpi_CreateRequest(), with a sequence number the caller already has
+ */
+PARCJSON *cpi_CreateRequestWithSequenceNumber(const char *key, PARCJSON *operation, uint64_t sequenceNumber);
+
 /**
  * <#OneLineDescription#>
  *
@@ -70,4 +82,10 @@ PARCJSON *cpi_CreateRequest(const char *key, PARCJSON *operation);
  * @endcode
  */
 PARCJSONPair *cpi_ParseRequest(PARCJSON *request);
+
+/**
+ * The JSON keys of the pause and flush operations
+ */
+const char *cpi_PauseJsonTag(void);
+const char *cpi_FlushJsonTag(void);
 #endif // libccnx_cpi_private_h
@@ -56,6 +56,8 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, cpiAck_CreateAck);
     LONGBOW_RUN_TEST_CASE(Global, cpiAck_CreateNack);
+    LONGBOW_RUN_TEST_CASE(Global, cpiAck_CreateWithResults);
+    LONGBOW_RUN_TEST_CASE(Global, cpiAck_CreateWithResults_AllAcked);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -106,6 +108,47 @@ LONGBOW_TEST_CASE(Global, cpiAck_CreateNack)
     ccnxName_Release(&name);
 }
 
+LONGBOW_TEST_CASE(Global, cpiAck_CreateWithResults)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CPIRouteEntry *route = cpiRouteEntry_CreateRouteToSelf(name);
+    PARCJSON *request = cpiForwarding_CreateAddRouteRequest(route);
+
+    bool results[] = { true, false, true };
+    PARCJSON *actual = cpiAcks_CreateWithResults(7, request, 3, results);
+
+    assertFalse(cpiAcks_IsAck(actual), "A rejected entry should make the ack a NACK");
+    assertTrue(cpiAcks_GetResultCount(actual) == 3, "Expected 3 results, got %zu", cpiAcks_GetResultCount(actual));
+    for (size_t i = 0; i < 3; i++) {
+        assertTrue(cpiAcks_GetResult(actual, i) == results[i], "Wrong result %zu", i);
+    }
+
+    parcJSON_Release(&actual);
+    parcJSON_Release(&request);
+    cpiRouteEntry_Destroy(&route);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, cpiAck_CreateWithResults_AllAcked)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CPIRouteEntry *route = cpiRouteEntry_CreateRouteToSelf(name);
+    PARCJSON *request = cpiForwarding_CreateAddRouteRequest(route);
+
+    bool results[] = { true, true };
+    PARCJSON *actual = cpiAcks_CreateWithResults(7, request, 2, results);
+    assertTrue(cpiAcks_IsAck(actual), "Expected an ACK when every entry is accepted");
+
+    PARCJSON *single = cpiAcks_CreateAck(request);
+    assertTrue(cpiAcks_GetResultCount(single) == 0, "A single ack has no results, got %zu", cpiAcks_GetResultCount(single));
+
+    parcJSON_Release(&single);
+    parcJSON_Release(&actual);
+    parcJSON_Release(&request);
+    cpiRouteEntry_Destroy(&route);
+    ccnxName_Release(&name);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
 }
@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Runner.
+#include "../cpi_Binary.c"
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <ccnx/api/control/cpi_ControlFacade.h>
+
+LONGBOW_TEST_RUNNER(cpi_Binary)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(cpi_Binary)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(cpi_Binary)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateRequest_Register);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateRequest_Symbolic);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateRequest_Nexthop);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateRequest_Pause);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateAck);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateRouteListResponse);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateAddRoutesRequest);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_CreateAckWithResults);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_Parse_NoAllocation);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_Parse_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_Parse_BadVersion);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_ToJson_Register);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_ToJson_Ack);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_ToJson_RouteList);
+    LONGBOW_RUN_TEST_CASE(Global, cpiBinary_ToJson_AckWithResults);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CPIRouteEntry *
+_createRoute(const char *uri, unsigned interfaceIndex)
+{
+    struct timeval lifetime = { 3600, 5 };
+    return cpiRouteEntry_Create(ccnxName_CreateFromURI(uri), interfaceIndex, NULL, cpiNameRouteProtocolType_STATIC,
+                                cpiNameRouteType_LONGEST_MATCH, &lifetime, 200);
+}
+
+static void
+_assertRoundTrip(CpiOperation operation, const CPIRouteEntry *route)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(operation, route);
+
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(encoding, &message), "Could not parse the encoding");
+    assertTrue(message.messageType == CPI_REQUEST, "Expected a request, got %d", message.messageType);
+    assertTrue(message.operation == operation, "Expected operation %d, got %d", operation, message.operation);
+    assertTrue(message.routeCount == 1, "Expected 1 route, got %zu", message.routeCount);
+
+    CPIRouteEntry *test = cpiBinary_CreateRouteEntry(&message.route);
+    assertTrue(cpiRouteEntry_Equals(route, test), "Route did not survive the binary encoding");
+
+    cpiRouteEntry_Destroy(&test);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateRequest_Register)
+{
+    CPIRouteEntry *route = _createRoute("lci:/apple/pie", 55);
+    _assertRoundTrip(CPI_REGISTER_PREFIX, route);
+    _assertRoundTrip(CPI_UNREGISTER_PREFIX, route);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateRequest_Symbolic)
+{
+    CPIRouteEntry *route = cpiRouteEntry_CreateSymbolic(ccnxName_CreateFromURI("lci:/apple/pie"), "tun0",
+                                                        cpiNameRouteProtocolType_STATIC, cpiNameRouteType_EXACT_MATCH, NULL, 7);
+    _assertRoundTrip(CPI_REGISTER_PREFIX, route);
+
+    cpiRouteEntry_SetInterfaceIndex(route, 3);
+    _assertRoundTrip(CPI_REGISTER_PREFIX, route);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateRequest_Nexthop)
+{
+    struct sockaddr_in sin = { .sin_family = AF_INET, .sin_port = htons(9695), .sin_addr.s_addr = htonl(0x01020304) };
+    CPIAddress *nexthop = cpiAddress_CreateFromInet(&sin);
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName_CreateFromURI("lci:/apple/pie"), 1, nexthop, cpiNameRouteProtocolType_STATIC,
+                                                cpiNameRouteType_LONGEST_MATCH, NULL, 1);
+    _assertRoundTrip(CPI_REGISTER_PREFIX, route);
+    cpiRouteEntry_Destroy(&route);
+    cpiAddress_Destroy(&nexthop);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateRequest_Pause)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PAUSE, NULL);
+    assertTrue(parcBuffer_Remaining(encoding) == _headerLength,
+               "Pause should only be a header, got %zu bytes", parcBuffer_Remaining(encoding));
+
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(encoding, &message), "Could not parse the encoding");
+    assertTrue(message.operation == CPI_PAUSE, "Expected operation %d, got %d", CPI_PAUSE, message.operation);
+    assertTrue(message.routeCount == 0, "Expected no routes, got %zu", message.routeCount);
+
+    PARCBuffer *second = cpiBinary_CreateRequest(CPI_PAUSE, NULL);
+    CPIBinaryMessage secondMessage;
+    cpiBinary_Parse(second, &secondMessage);
+    assertTrue(secondMessage.sequenceNumber > message.sequenceNumber, "Each request should have a new sequence number");
+
+    parcBuffer_Release(&second);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateAck)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_FLUSH, NULL);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+
+    PARCBuffer *ack = cpiBinary_CreateAck(&request, ACK_NACK);
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(ack, &message), "Could not parse the ack");
+    assertTrue(message.messageType == CPI_ACK, "Expected an ack, got %d", message.messageType);
+    assertTrue(message.operation == CPI_FLUSH, "Expected operation %d, got %d", CPI_FLUSH, message.operation);
+    assertTrue(message.ackType == ACK_NACK, "Expected a NACK");
+    assertTrue(message.originalSequenceNumber == request.sequenceNumber,
+               "Expected original sequence number %" PRIu64 ", got %" PRIu64, request.sequenceNumber, message.originalSequenceNumber);
+
+    parcBuffer_Release(&ack);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateAddRoutesRequest)
+{
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    cpiRouteEntryList_Append(list, _createRoute("lci:/a", 1));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/b/c", 2));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/d", 3));
+
+    PARCBuffer *encoding = cpiBinary_CreateAddRoutesRequest(list);
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(encoding, &message), "Could not parse the batch");
+    assertTrue(message.operation == CPI_REGISTER_PREFIXES, "Expected operation %d, got %d", CPI_REGISTER_PREFIXES, message.operation);
+    assertTrue(message.routeCount == 3, "Expected 3 routes, got %zu", message.routeCount);
+
+    uint64_t next = cpi_GetNextSequenceNumber();
+    assertTrue(next == message.sequenceNumber + 3,
+               "Expected next sequence number %" PRIu64 ", got %" PRIu64, message.sequenceNumber + 3, next);
+
+    CPIRouteEntryList *test = cpiBinary_CreateRouteEntryList(&message);
+    assertTrue(cpiRouteEntryList_Equals(list, test), "Route lists not equal");
+
+    cpiRouteEntryList_Destroy(&test);
+    cpiRouteEntryList_Destroy(&list);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateAckWithResults)
+{
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    cpiRouteEntryList_Append(list, _createRoute("lci:/a", 1));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/b", 2));
+
+    PARCBuffer *encoding = cpiBinary_CreateAddRoutesRequest(list);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+
+    bool results[] = { false, true };
+    PARCBuffer *ack = cpiBinary_CreateAckWithResults(&request, 2, results);
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(ack, &message), "Could not parse the ack");
+    assertTrue(message.ackType == ACK_NACK, "A rejected route should make the ack a NACK");
+    assertTrue(message.resultCount == 2, "Expected 2 results, got %zu", message.resultCount);
+    assertFalse(cpiBinary_GetResult(&message, 0), "Expected result 0 to be false");
+    assertTrue(cpiBinary_GetResult(&message, 1), "Expected result 1 to be true");
+
+    parcBuffer_Release(&ack);
+    parcBuffer_Release(&encoding);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_CreateRouteListResponse)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PREFIX_REGISTRATION_LIST, NULL);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    cpiRouteEntryList_Append(list, _createRoute("lci:/a", 1));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/b/c", 2));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/d", 3));
+
+    PARCBuffer *response = cpiBinary_CreateRouteListResponse(&request, list);
+    CPIBinaryMessage message;
+    assertTrue(cpiBinary_Parse(response, &message), "Could not parse the response");
+    assertTrue(message.messageType == CPI_RESPONSE, "Expected a response, got %d", message.messageType);
+    assertTrue(message.sequenceNumber == request.sequenceNumber, "Response should have the request sequence number");
+    assertTrue(message.routeCount == 3, "Expected 3 routes, got %zu", message.routeCount);
+
+    size_t cursor = 0;
+    size_t count = 0;
+    CPIBinaryRoute route;
+    while (cpiBinary_NextRoute(&message, &cursor, &route)) {
+        CPIRouteEntry *test = cpiBinary_CreateRouteEntry(&route);
+        CPIRouteEntry *truth = cpiRouteEntryList_Get(list, count);
+        assertTrue(cpiRouteEntry_Equals(truth, test), "Route %zu is wrong", count);
+        cpiRouteEntry_Destroy(&truth);
+        cpiRouteEntry_Destroy(&test);
+        count++;
+    }
+    assertTrue(count == 3, "Expected to step through 3 routes, got %zu", count);
+
+    CPIRouteEntryList *test = cpiBinary_CreateRouteEntryList(&message);
+    assertTrue(cpiRouteEntryList_Equals(list, test), "Route lists should be equal");
+
+    cpiRouteEntryList_Destroy(&test);
+    cpiRouteEntryList_Destroy(&list);
+    parcBuffer_Release(&response);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_Parse_NoAllocation)
+{
+    CPIRouteEntry *route = _createRoute("lci:/apple/pie", 55);
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_REGISTER_PREFIX, route);
+
+    uint32_t before = parcMemory_Outstanding();
+    CPIBinaryMessage message;
+    bool success = cpiBinary_Parse(encoding, &message);
+    size_t cursor = 0;
+    CPIBinaryRoute binaryRoute;
+    cpiBinary_NextRoute(&message, &cursor, &binaryRoute);
+    uint32_t after = parcMemory_Outstanding();
+
+    assertTrue(success, "Could not parse the encoding");
+    assertTrue(before == after, "Parsing allocated memory, before %u after %u", before, after);
+    assertTrue(binaryRoute.prefixLength == strlen("lci:/apple/pie") &&
+               memcmp(binaryRoute.prefix, "lci:/apple/pie", binaryRoute.prefixLength) == 0, "Wrong prefix");
+
+    parcBuffer_Release(&encoding);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_Parse_Truncated)
+{
+    CPIRouteEntry *route = _createRoute("lci:/apple/pie", 55);
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_REGISTER_PREFIX, route);
+
+    size_t length = parcBuffer_Remaining(encoding);
+    for (size_t i = 0; i < length; i++) {
+        PARCBuffer *truncated = parcBuffer_Wrap(parcBuffer_Overlay(encoding, 0), i, 0, i);
+        CPIBinaryMessage message;
+        assertFalse(cpiBinary_Parse(truncated, &message), "Parsed an encoding truncated to %zu of %zu bytes", i, length);
+        parcBuffer_Release(&truncated);
+    }
+
+    parcBuffer_Release(&encoding);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_Parse_BadVersion)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_FLUSH, NULL);
+    parcBuffer_PutAtIndex(encoding, 0, CPI_BINARY_VERSION + 1);
+
+    CPIBinaryMessage message;
+    assertFalse(cpiBinary_Parse(encoding, &message), "Should not parse an unknown version");
+
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_ToJson_Register)
+{
+    CPIRouteEntry *route = _createRoute("lci:/apple/pie", 55);
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_REGISTER_PREFIX, route);
+    CPIBinaryMessage message;
+    cpiBinary_Parse(encoding, &message);
+
+    PARCJSON *json = cpiBinary_ToJson(&message);
+    assertTrue(cpi_getCPIOperation2(json) == CPI_REGISTER_PREFIX, "Wrong operation in %s", parcJSON_ToString(json));
+    assertTrue(controlPlaneInterface_GetSequenceNumber(json) == message.sequenceNumber, "Wrong sequence number");
+
+    // the JSON parser must see the same route
+    CCNxControl *control = ccnxControlFacade_CreateCPI(json);
+    CPIRouteEntry *test = cpiForwarding_RouteFromControlMessage(control);
+    assertTrue(cpiRouteEntry_Equals(route, test), "Route differs in the JSON form");
+
+    cpiRouteEntry_Destroy(&test);
+    ccnxControl_Release(&control);
+    parcJSON_Release(&json);
+    parcBuffer_Release(&encoding);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_ToJson_Ack)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PAUSE, NULL);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+    PARCBuffer *ack = cpiBinary_CreateAck(&request, ACK_ACK);
+    CPIBinaryMessage message;
+    cpiBinary_Parse(ack, &message);
+
+    PARCJSON *json = cpiBinary_ToJson(&message);
+    assertTrue(cpiAcks_IsAck(json), "Expected an ACK in %s", parcJSON_ToString(json));
+    assertTrue(cpiAcks_GetAckOriginalSequenceNumber(json) == request.sequenceNumber, "Wrong original sequence number");
+    assertTrue(controlPlaneInterface_GetSequenceNumber(json) == message.sequenceNumber, "Wrong sequence number");
+
+    parcJSON_Release(&json);
+    parcBuffer_Release(&ack);
+    parcBuffer_Release(&encoding);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_ToJson_AckWithResults)
+{
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    cpiRouteEntryList_Append(list, _createRoute("lci:/a", 1));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/b", 2));
+
+    PARCBuffer *encoding = cpiBinary_CreateAddRoutesRequest(list);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+    bool results[] = { true, true };
+    PARCBuffer *ack = cpiBinary_CreateAckWithResults(&request, 2, results);
+    CPIBinaryMessage message;
+    cpiBinary_Parse(ack, &message);
+
+    PARCJSON *json = cpiBinary_ToJson(&message);
+    assertTrue(cpiAcks_IsAck(json), "Expected an ACK in %s", parcJSON_ToString(json));
+    assertTrue(cpiAcks_GetAckOriginalSequenceNumber(json) == request.sequenceNumber, "Wrong original sequence number");
+    assertTrue(cpiAcks_GetResultCount(json) == 2, "Expected 2 results in %s", parcJSON_ToString(json));
+    assertTrue(cpiAcks_GetResult(json, 0) && cpiAcks_GetResult(json, 1), "Wrong results in %s", parcJSON_ToString(json));
+
+    parcJSON_Release(&json);
+    parcBuffer_Release(&ack);
+    parcBuffer_Release(&encoding);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiBinary_ToJson_RouteList)
+{
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PREFIX_REGISTRATION_LIST, NULL);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    cpiRouteEntryList_Append(list, _createRoute("lci:/a", 1));
+    cpiRouteEntryList_Append(list, _createRoute("lci:/b", 2));
+    PARCBuffer *response = cpiBinary_CreateRouteListResponse(&request, list);
+    CPIBinaryMessage message;
+    cpiBinary_Parse(response, &message);
+
+    PARCJSON *json = cpiBinary_ToJson(&message);
+    CCNxControl *control = ccnxControlFacade_CreateCPI(json);
+    CPIRouteEntryList *test = cpiForwarding_RouteListFromControlMessage(control);
+    assertTrue(cpiRouteEntryList_Equals(list, test), "Route list differs in the JSON form");
+
+    cpiRouteEntryList_Destroy(&test);
+    ccnxControl_Release(&control);
+    parcJSON_Release(&json);
+    cpiRouteEntryList_Destroy(&list);
+    parcBuffer_Release(&response);
+    parcBuffer_Release(&encoding);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(cpi_Binary);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
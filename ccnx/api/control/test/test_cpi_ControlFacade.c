@@ -96,6 +96,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_GetJson);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_IsCPI);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_IsNotification);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_CreateBinaryNotification);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_Display);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControlFacade_ToString);
 }
@@ -186,6 +187,25 @@ LONGBOW_TEST_CASE(Global, ccnxControlFacade_IsNotification)
     ccnxTlvDictionary_Release(&control);
 }
 
+LONGBOW_TEST_CASE(Global, ccnxControlFacade_CreateBinaryNotification)
+{
+    NotifyStatus *status = notifyStatus_CreateWithCount(3, notifyStatusCode_INTEREST_TIMEOUT, NULL, "expired", 5);
+    PARCBuffer *encoding = notifyStatus_ToBinary(status);
+    CCNxTlvDictionary *control = ccnxControlFacade_CreateBinaryNotification(encoding);
+
+    assertTrue(ccnxControlFacade_IsNotification(control), "Binary notification says its not a notification");
+    assertFalse(ccnxControlFacade_IsCPI(control), "Binary notification says its CPI");
+    assertNull(ccnxControlFacade_GetJson(control), "Binary notification should have no JSON");
+
+    char *desc = ccnxControlFacade_ToString(control);
+    assertNotNull(desc, "Expected a string");
+    parcMemory_Deallocate((void **) &desc);
+
+    ccnxTlvDictionary_Release(&control);
+    parcBuffer_Release(&encoding);
+    notifyStatus_Release(&status);
+}
+
 LONGBOW_TEST_CASE(Global, ccnxControlFacade_Display)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
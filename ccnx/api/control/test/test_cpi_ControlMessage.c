@@ -33,6 +33,7 @@
 #include "../cpi_ControlMessage.c"
 
 #include <stdio.h>
+#include <inttypes.h>
 
 #include <arpa/inet.h>
 #include <LongBow/unit-test.h>
@@ -64,6 +65,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_AcquireRelease);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAddRouteRequest);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAddRouteToSelfRequest);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAck);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAck_Binary);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAck_AddRoutes);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAckWithResults);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateAckWithResults_Binary);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateBinaryAddRouteRequest);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateBinaryPauseInputRequest);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateCPIRequest);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateCancelFlowRequest);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_CreateConnectionListRequest);
@@ -77,6 +85,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_GetAckOriginalSequenceNumber);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_GetJson);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_GetNotifyStatus);
+    LONGBOW_RUN_TEST_CASE(Global, ccnxControl_GetNotifyStatus_Binary);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_IsACK);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_IsCPI);
     LONGBOW_RUN_TEST_CASE(Global, ccnxControl_IsNotification);
@@ -143,6 +152,149 @@ LONGBOW_TEST_CASE(Global, ccnxControl_CreateAddRouteToSelfRequest)
 }
 
 
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateAck)
+{
+    CCNxControl *control = ccnxControl_CreateFlushRequest();
+    CCNxControl *ack = ccnxControl_CreateAck(control);
+
+    assertFalse(ccnxControlFacade_IsBinary(ack), "Ack of a JSON request should be JSON");
+    assertTrue(ccnxControl_IsACK(ack), "Expected the message to be an Ack");
+    assertTrue(ccnxControl_GetAckOriginalSequenceNumber(ack) == cpi_GetSequenceNumber(control),
+               "Expected original sequence number %" PRIu64 " got %" PRIu64,
+               cpi_GetSequenceNumber(control), ccnxControl_GetAckOriginalSequenceNumber(ack));
+
+    ccnxControl_Release(&ack);
+    ccnxControl_Release(&control);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateAck_Binary)
+{
+    CCNxControl *control = ccnxControl_CreateBinaryFlushRequest();
+    CCNxControl *ack = ccnxControl_CreateAck(control);
+
+    assertTrue(ccnxControlFacade_IsBinary(ack), "Ack of a binary request should be binary");
+    assertTrue(ccnxControl_IsCPI(ack), "Expected a CPI message");
+    assertTrue(ccnxControl_IsACK(ack), "Expected the message to be an Ack");
+    assertFalse(ccnxControl_IsNACK(ack), "Expected the message not to be a Nack");
+    assertTrue(cpi_GetMessageOperation(ack) == CPI_FLUSH, "Ack should carry the request operation");
+    assertTrue(ccnxControl_GetAckOriginalSequenceNumber(ack) == cpi_GetSequenceNumber(control),
+               "Expected original sequence number %" PRIu64 " got %" PRIu64,
+               cpi_GetSequenceNumber(control), ccnxControl_GetAckOriginalSequenceNumber(ack));
+
+    ccnxControl_Release(&ack);
+    ccnxControl_Release(&control);
+}
+
+static CPIRouteEntryList *
+_createRouteList(size_t count)
+{
+    CPIRouteEntryList *routes = cpiRouteEntryList_Create();
+    for (size_t i = 0; i < count; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/boose/roo/%zu", i);
+        CCNxName *name = ccnxName_CreateFromURI(uri);
+        cpiRouteEntryList_Append(routes, cpiRouteEntry_CreateRouteToSelf(name));
+        ccnxName_Release(&name);
+    }
+    return routes;
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateAck_AddRoutes)
+{
+    CPIRouteEntryList *routes = _createRouteList(3);
+    CCNxControl *control = ccnxControl_CreateAddRoutesRequest(routes);
+    CCNxControl *ack = ccnxControl_CreateAck(control);
+
+    assertTrue(ccnxControl_IsACK(ack), "Expected the message to be an Ack");
+    assertTrue(ccnxControl_GetAckResultCount(ack) == 3, "Expected 3 results, got %zu", ccnxControl_GetAckResultCount(ack));
+    for (size_t i = 0; i < 3; i++) {
+        assertTrue(ccnxControl_GetAckResult(ack, i), "Expected result %zu to be true", i);
+    }
+    assertTrue(ccnxControl_GetAckOriginalSequenceNumber(ack) == cpi_GetSequenceNumber(control),
+               "Expected original sequence number %" PRIu64 " got %" PRIu64,
+               cpi_GetSequenceNumber(control), ccnxControl_GetAckOriginalSequenceNumber(ack));
+
+    ccnxControl_Release(&ack);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateAckWithResults)
+{
+    CPIRouteEntryList *routes = _createRouteList(2);
+    CCNxControl *control = ccnxControl_CreateAddRoutesRequest(routes);
+
+    bool results[] = { true, false };
+    CCNxControl *ack = ccnxControl_CreateAckWithResults(control, 2, results);
+
+    assertFalse(ccnxControlFacade_IsBinary(ack), "Ack of a JSON request should be JSON");
+    assertTrue(ccnxControl_IsNACK(ack), "A rejected route should make the batch a Nack");
+    assertTrue(ccnxControl_GetAckResultCount(ack) == 2, "Expected 2 results, got %zu", ccnxControl_GetAckResultCount(ack));
+    assertTrue(ccnxControl_GetAckResult(ack, 0), "Expected result 0 to be true");
+    assertFalse(ccnxControl_GetAckResult(ack, 1), "Expected result 1 to be false");
+    assertTrue(ccnxControl_GetAckOriginalSequenceNumber(ack) == cpi_GetSequenceNumber(control),
+               "Expected original sequence number %" PRIu64 " got %" PRIu64,
+               cpi_GetSequenceNumber(control), ccnxControl_GetAckOriginalSequenceNumber(ack));
+
+    ccnxControl_Release(&ack);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateAckWithResults_Binary)
+{
+    CPIRouteEntryList *routes = _createRouteList(2);
+    CCNxControl *control = ccnxControl_CreateBinaryAddRoutesRequest(routes);
+
+    bool results[] = { true, true };
+    CCNxControl *ack = ccnxControl_CreateAckWithResults(control, 2, results);
+
+    assertTrue(ccnxControlFacade_IsBinary(ack), "Ack of a binary request should be binary");
+    assertTrue(ccnxControl_IsACK(ack), "Expected the message to be an Ack");
+    assertTrue(cpi_GetMessageOperation(ack) == CPI_REGISTER_PREFIXES, "Ack should carry the request operation");
+    assertTrue(ccnxControl_GetAckResultCount(ack) == 2, "Expected 2 results, got %zu", ccnxControl_GetAckResultCount(ack));
+
+    ccnxControl_Release(&ack);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateBinaryAddRouteRequest)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/boose/roo/pie");
+    CPIRouteEntry *route = cpiRouteEntry_CreateRouteToSelf(name);
+    CCNxControl *control = ccnxControl_CreateBinaryAddRouteRequest(route);
+
+    assertTrue(ccnxControl_IsCPI(control), "Expected control to be a CPI control message");
+    assertFalse(ccnxControl_IsNotification(control), "Binary CPI message is not a notification");
+    assertNull(ccnxControl_GetJson(control), "Binary CPI message should have no JSON");
+    assertTrue(cpi_GetMessageType(control) == CPI_REQUEST, "Expected a request");
+    assertTrue(cpi_GetMessageOperation(control) == CPI_REGISTER_PREFIX,
+               "Expected operation %d got %d", CPI_REGISTER_PREFIX, cpi_GetMessageOperation(control));
+
+    CPIRouteEntry *test = cpiForwarding_RouteFromControlMessage(control);
+    assertTrue(cpiRouteEntry_Equals(route, test), "Route did not survive the binary encoding");
+
+    cpiRouteEntry_Destroy(&test);
+    ccnxControl_Release(&control);
+    ccnxName_Release(&name);
+    cpiRouteEntry_Destroy(&route);
+}
+
+LONGBOW_TEST_CASE(Global, ccnxControl_CreateBinaryPauseInputRequest)
+{
+    CCNxControl *control = ccnxControl_CreateBinaryPauseInputRequest();
+    assertTrue(ccnxControl_IsCPI(control), "Expected control to be a CPI control message");
+    assertTrue(cpi_GetMessageOperation(control) == CPI_PAUSE,
+               "Expected operation %d got %d", CPI_PAUSE, cpi_GetMessageOperation(control));
+
+    char *string = ccnxControlFacade_ToString(control);
+    assertNotNull(strstr(string, "CPI_PAUSE"), "ToString should show the JSON form, got %s", string);
+    parcMemory_Deallocate((void **) &string);
+
+    ccnxControl_Release(&control);
+}
+
 LONGBOW_TEST_CASE(Global, ccnxControl_CreateCancelFlowRequest)
 {
     CCNxName *name = ccnxName_CreateFromURI("lci:/boose/roo/pie");
@@ -383,6 +535,27 @@ LONGBOW_TEST_CASE(Global, ccnxControl_GetNotifyStatus)
     notifyStatus_Release(&expected);
 }
 
+LONGBOW_TEST_CASE(Global, ccnxControl_GetNotifyStatus_Binary)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/boose/roo/pie");
+    NotifyStatus *expected = notifyStatus_CreateWithCount(1, notifyStatusCode_INTEREST_TIMEOUT, name, "Expired", 12);
+
+    PARCBuffer *encoding = notifyStatus_ToBinary(expected);
+    CCNxControl *control = ccnxControlFacade_CreateBinaryNotification(encoding);
+
+    assertTrue(ccnxControl_IsNotification(control), "Expected a notification");
+    assertFalse(ccnxControl_IsCPI(control), "A binary notification is not CPI");
+
+    NotifyStatus *status = ccnxControl_GetNotifyStatus(control);
+    assertTrue(notifyStatus_Equals(expected, status), "Expected equal statuses");
+
+    notifyStatus_Release(&status);
+    ccnxControl_Release(&control);
+    parcBuffer_Release(&encoding);
+    notifyStatus_Release(&expected);
+    ccnxName_Release(&name);
+}
+
 int
 main(int argc, char *argv[])
 {
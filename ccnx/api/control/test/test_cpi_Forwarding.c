@@ -73,6 +73,11 @@ LONGBOW_TEST_FIXTURE(Global)
 
     LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_CreateRouteListRequest);
     LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_RouteListFromControlMessage);
+
+    LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_AddRoutes);
+    LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_AddRoutes_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_AddRoutes_Binary);
+    LONGBOW_RUN_TEST_CASE(Global, cpiForwarding_CreateAddRouteRequestInBatch);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -332,6 +337,103 @@ LONGBOW_TEST_CASE(Global, cpiForwarding_RouteListFromControlMessage)
     cpiRouteEntryList_Destroy(&test);
 }
 
+static CPIRouteEntryList *
+_createRouteList(size_t count)
+{
+    CPIRouteEntryList *routes = cpiRouteEntryList_Create();
+    for (size_t i = 0; i < count; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/batch/route%zu", i);
+        CCNxName *prefix = ccnxName_CreateFromURI(uri);
+        cpiRouteEntryList_Append(routes, cpiRouteEntry_CreateRouteToSelf(prefix));
+        ccnxName_Release(&prefix);
+    }
+    return routes;
+}
+
+LONGBOW_TEST_CASE(Global, cpiForwarding_AddRoutes)
+{
+    CPIRouteEntryList *routes = _createRouteList(3);
+
+    PARCJSON *json = cpiForwarding_AddRoutes(routes);
+    CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+    parcJSON_Release(&json);
+
+    assertTrue(cpi_GetMessageOperation(control) == CPI_REGISTER_PREFIXES,
+               "Wrong operation, got %d", cpi_GetMessageOperation(control));
+
+    // the batch reserved one sequence number per route
+    uint64_t sequenceNumber = cpi_GetSequenceNumber(control);
+    uint64_t next = cpi_GetNextSequenceNumber();
+    assertTrue(next == sequenceNumber + 3, "Expected next sequence number %" PRIu64 ", got %" PRIu64, sequenceNumber + 3, next);
+
+    assertTrue(cpiForwarding_RouteCountFromControlMessage(control) == 3,
+               "Wrong route count, got %zu", cpiForwarding_RouteCountFromControlMessage(control));
+
+    CPIRouteEntryList *test = cpiForwarding_RoutesFromControlMessage(control);
+    assertTrue(cpiRouteEntryList_Equals(routes, test), "Route lists not equal");
+
+    cpiRouteEntryList_Destroy(&test);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, cpiForwarding_AddRoutes_Empty)
+{
+    CPIRouteEntryList *routes = cpiRouteEntryList_Create();
+
+    PARCJSON *json = cpiForwarding_AddRoutes(routes);
+    CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+    parcJSON_Release(&json);
+
+    assertTrue(cpiForwarding_RouteCountFromControlMessage(control) == 0,
+               "Wrong route count, got %zu", cpiForwarding_RouteCountFromControlMessage(control));
+
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, cpiForwarding_AddRoutes_Binary)
+{
+    CPIRouteEntryList *routes = _createRouteList(4);
+
+    CCNxControl *control = ccnxControl_CreateBinaryAddRoutesRequest(routes);
+    assertTrue(cpi_GetMessageOperation(control) == CPI_REGISTER_PREFIXES,
+               "Wrong operation, got %d", cpi_GetMessageOperation(control));
+    assertTrue(cpiForwarding_RouteCountFromControlMessage(control) == 4,
+               "Wrong route count, got %zu", cpiForwarding_RouteCountFromControlMessage(control));
+
+    CPIRouteEntryList *test = cpiForwarding_RoutesFromControlMessage(control);
+    assertTrue(cpiRouteEntryList_Equals(routes, test), "Route lists not equal");
+
+    cpiRouteEntryList_Destroy(&test);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
+LONGBOW_TEST_CASE(Global, cpiForwarding_CreateAddRouteRequestInBatch)
+{
+    CPIRouteEntryList *routes = _createRouteList(2);
+
+    CPIRouteEntry *truth = cpiRouteEntryList_Get(routes, 1);
+    PARCJSON *json = cpiForwarding_CreateAddRouteRequestInBatch(truth, 1000, 1);
+    CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+    parcJSON_Release(&json);
+
+    assertTrue(cpi_GetMessageOperation(control) == CPI_REGISTER_PREFIX,
+               "Wrong operation, got %d", cpi_GetMessageOperation(control));
+    assertTrue(cpi_GetSequenceNumber(control) == 1001,
+               "Wrong sequence number, got %" PRIu64, cpi_GetSequenceNumber(control));
+
+    CPIRouteEntry *route = cpiForwarding_RouteFromControlMessage(control);
+    assertTrue(cpiRouteEntry_Equals(route, truth), "Wrong route");
+
+    cpiRouteEntry_Destroy(&route);
+    cpiRouteEntry_Destroy(&truth);
+    ccnxControl_Release(&control);
+    cpiRouteEntryList_Destroy(&routes);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Runner.
+#include "../cpi_ListReader.c"
+
+#include <inttypes.h>
+#include <arpa/inet.h>
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(cpi_ListReader)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(cpi_ListReader)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(cpi_ListReader)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Json);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Binary);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Text);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Text_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Text_TagInValue);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Text_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_RouteReader_Text_NoList);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_ConnectionReader_Json);
+    LONGBOW_RUN_TEST_CASE(Global, cpiListReader_ConnectionReader_Text);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static CPIRouteEntryList *
+_createRouteList(size_t count)
+{
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    for (size_t i = 0; i < count; i++) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "lci:/reader/route%zu", i);
+        struct timeval lifetime = { 3600, 0 };
+        CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName_CreateFromURI(uri), (unsigned) i + 1, NULL,
+                                                    cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH,
+                                                    &lifetime, (unsigned) i);
+        cpiRouteEntryList_Append(list, route);
+    }
+    return list;
+}
+
+static CPIConnectionList *
+_createConnectionList(size_t count)
+{
+    CPIConnectionList *list = cpiConnectionList_Create();
+    for (size_t i = 0; i < count; i++) {
+        CPIConnection *connection =
+            cpiConnection_Create((unsigned) i + 1,
+                                 cpiAddress_CreateFromInet(&(struct sockaddr_in) { .sin_family = PF_INET, .sin_addr.s_addr = 0x01020304, .sin_port = htons(1000 + i) }),
+                                 cpiAddress_CreateFromInet(&(struct sockaddr_in) { .sin_family = PF_INET, .sin_addr.s_addr = 0x05060708, .sin_port = htons(9695) }),
+                                 cpiConnection_TCP);
+        cpiConnectionList_Append(list, connection);
+    }
+    return list;
+}
+
+static CCNxControl *
+_createRouteListResponse(const CPIRouteEntryList *list)
+{
+    CCNxControl *request = ccnxControl_CreateRouteListRequest();
+    PARCJSON *json = cpiRouteEntryList_ToJson(list);
+    CCNxControl *response = cpi_CreateResponse(request, json);
+    parcJSON_Release(&json);
+    ccnxControl_Release(&request);
+    return response;
+}
+
+static CCNxControl *
+_createConnectionListResponse(const CPIConnectionList *list)
+{
+    CCNxControl *request = ccnxControl_CreateConnectionListRequest();
+    PARCJSON *json = cpiConnectionList_ToJson(list);
+    CCNxControl *response = cpi_CreateResponse(request, json);
+    parcJSON_Release(&json);
+    ccnxControl_Release(&request);
+    return response;
+}
+
+/**
+ * The JSON text of a control message, as a management tool would have saved it
+ */
+static PARCBuffer *
+_createText(CCNxControl *control)
+{
+    char *string = parcJSON_ToString(ccnxControl_GetJson(control));
+    PARCBuffer *text = parcBuffer_AllocateCString(string);
+    parcMemory_Deallocate((void **) &string);
+    return text;
+}
+
+static PARCBuffer *
+_wrapText(const char *string)
+{
+    return parcBuffer_WrapCString(string);
+}
+
+/**
+ * Read every route and check it against the list
+ */
+static void
+_assertRoutes(CPIListReader *reader, CPIRouteEntryList *truth)
+{
+    size_t count = 0;
+    CPIRouteEntry *route;
+    while ((route = cpiListReader_NextRoute(reader)) != NULL) {
+        assertTrue(count < cpiRouteEntryList_Length(truth), "Got more routes than the list has");
+        CPIRouteEntry *expected = cpiRouteEntryList_Get(truth, count);
+        assertTrue(cpiRouteEntry_Equals(expected, route), "Route %zu is wrong", count);
+        cpiRouteEntry_Destroy(&expected);
+        cpiRouteEntry_Destroy(&route);
+        count++;
+    }
+
+    assertTrue(count == cpiRouteEntryList_Length(truth), "Expected %zu routes, got %zu", cpiRouteEntryList_Length(truth), count);
+    assertTrue(cpiListReader_GetCount(reader) == count, "Expected count %zu, got %zu", count, cpiListReader_GetCount(reader));
+    assertFalse(cpiListReader_HasFailed(reader), "Reader should not have failed");
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Json)
+{
+    CPIRouteEntryList *list = _createRouteList(5);
+    CCNxControl *response = _createRouteListResponse(list);
+
+    CPIListReader *reader = cpiListReader_CreateRouteReader(response);
+    _assertRoutes(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    ccnxControl_Release(&response);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Binary)
+{
+    CPIRouteEntryList *list = _createRouteList(5);
+
+    PARCBuffer *encoding = cpiBinary_CreateRequest(CPI_PREFIX_REGISTRATION_LIST, NULL);
+    CPIBinaryMessage request;
+    cpiBinary_Parse(encoding, &request);
+    PARCBuffer *responseEncoding = cpiBinary_CreateRouteListResponse(&request, list);
+    CCNxControl *response = ccnxControlFacade_CreateBinaryCPI(responseEncoding);
+
+    CPIListReader *reader = cpiListReader_CreateRouteReader(response);
+    _assertRoutes(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    ccnxControl_Release(&response);
+    parcBuffer_Release(&responseEncoding);
+    parcBuffer_Release(&encoding);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Text)
+{
+    CPIRouteEntryList *list = _createRouteList(5);
+    CCNxControl *response = _createRouteListResponse(list);
+    PARCBuffer *text = _createText(response);
+
+    CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+    _assertRoutes(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+    ccnxControl_Release(&response);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Text_Empty)
+{
+    PARCBuffer *text = _wrapText("{ \"Routes\" : [ ] }");
+
+    CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+    assertNull(cpiListReader_NextRoute(reader), "Expected no routes");
+    assertFalse(cpiListReader_HasFailed(reader), "An empty list is not malformed");
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Text_TagInValue)
+{
+    CPIRouteEntryList *list = _createRouteList(1);
+    CPIRouteEntry *route = cpiRouteEntryList_Get(list, 0);
+    PARCJSON *routeJson = cpiRouteEntry_ToJson(route);
+    char *routeString = parcJSON_ToCompactString(routeJson);
+
+    // the tag as a string value, and a '[' inside a string, must not confuse the scanner
+    char string[1024];
+    snprintf(string, sizeof(string), "{\"NAME\":\"Routes\",\"NOTE\":\"[{\\\"\",\"Routes\":[%s]}", routeString);
+    PARCBuffer *text = _wrapText(string);
+
+    CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+    _assertRoutes(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+    parcMemory_Deallocate((void **) &routeString);
+    parcJSON_Release(&routeJson);
+    cpiRouteEntry_Destroy(&route);
+    cpiRouteEntryList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Text_Truncated)
+{
+    PARCBuffer *text = _wrapText("{\"Routes\":[{\"PREFIX\":\"lci:/a\",\"COST\":");
+
+    CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+    assertNull(cpiListReader_NextRoute(reader), "Expected no routes");
+    assertTrue(cpiListReader_HasFailed(reader), "A truncated list is malformed");
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_RouteReader_Text_NoList)
+{
+    PARCBuffer *text = _wrapText("{\"CPI_RESPONSE\":{\"SEQUENCE\":1}}");
+
+    CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(text);
+    assertNull(cpiListReader_NextRoute(reader), "Expected no routes");
+    assertTrue(cpiListReader_HasFailed(reader), "Text without a route list is malformed");
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+}
+
+/**
+ * Read every connection and check it against the list
+ */
+static void
+_assertConnections(CPIListReader *reader, CPIConnectionList *truth)
+{
+    size_t count = 0;
+    CPIConnection *connection;
+    while ((connection = cpiListReader_NextConnection(reader)) != NULL) {
+        assertTrue(count < cpiConnectionList_Length(truth), "Got more connections than the list has");
+        CPIConnection *expected = cpiConnectionList_Get(truth, count);
+        assertTrue(cpiConnection_Equals(expected, connection), "Connection %zu is wrong", count);
+        cpiConnection_Release(&expected);
+        cpiConnection_Release(&connection);
+        count++;
+    }
+
+    assertTrue(count == cpiConnectionList_Length(truth), "Expected %zu connections, got %zu", cpiConnectionList_Length(truth), count);
+    assertFalse(cpiListReader_HasFailed(reader), "Reader should not have failed");
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_ConnectionReader_Json)
+{
+    CPIConnectionList *list = _createConnectionList(4);
+    CCNxControl *response = _createConnectionListResponse(list);
+
+    CPIListReader *reader = cpiListReader_CreateConnectionReader(response);
+    _assertConnections(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    ccnxControl_Release(&response);
+    cpiConnectionList_Destroy(&list);
+}
+
+LONGBOW_TEST_CASE(Global, cpiListReader_ConnectionReader_Text)
+{
+    CPIConnectionList *list = _createConnectionList(4);
+    CCNxControl *response = _createConnectionListResponse(list);
+    PARCBuffer *text = _createText(response);
+
+    CPIListReader *reader = cpiListReader_CreateConnectionReaderFromText(text);
+    _assertConnections(reader, list);
+
+    cpiListReader_Destroy(&reader);
+    parcBuffer_Release(&text);
+    ccnxControl_Release(&response);
+    cpiConnectionList_Destroy(&list);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(cpi_ListReader);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
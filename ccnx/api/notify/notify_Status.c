@@ -33,10 +33,13 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <LongBow/runtime.h>
+
 #include <parc/algol/parc_DisplayIndented.h>
 #include <parc/algol/parc_Object.h>
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_BufferComposer.h>
 
 #include <ccnx/api/notify/notify_Status.h>
 
@@ -47,12 +50,17 @@ static const char param_CONNECTION[] = "connectionId";
 static const char param_CODE[] = "statusCode";
 static const char param_NAME[] = "name";
 static const char param_MESSAGE[] = "message";
+static const char param_COUNT[] = "count";
+
+// version, code, count, apiFd, then the name and message lengths
+static const size_t _binaryFixedLength = 1 + 1 + 4 + 4 + 2 + 2;
 
 struct notify_status {
     int apiFd;
     NotifyStatusCode code;
     CCNxName *name;
     char *message;
+    uint32_t count;
 };
 
 static void
@@ -76,11 +84,20 @@ parcObject_ImplementRelease(notifyStatus, NotifyStatus);
 NotifyStatus *
 notifyStatus_Create(int apiFd, NotifyStatusCode code, CCNxName *name, const char *message)
 {
+    return notifyStatus_CreateWithCount(apiFd, code, name, message, 1);
+}
+
+NotifyStatus *
+notifyStatus_CreateWithCount(int apiFd, NotifyStatusCode code, CCNxName *name, const char *message, uint32_t count)
+{
+    assertTrue(count > 0, "Parameter count must be positive");
+
     NotifyStatus *result = parcObject_CreateInstance(NotifyStatus);
     result->apiFd = apiFd;
     result->code = code;
     result->name = name == NULL ? NULL : ccnxName_Acquire(name);
     result->message = message == NULL ? NULL : parcMemory_StringDuplicate(message, strlen(message));
+    result->count = count;
 
     return result;
 }
@@ -107,7 +124,7 @@ notifyStatus_Equals(const NotifyStatus *x, const NotifyStatus *y)
         return false;
     }
 
-    if (x->apiFd == y->apiFd) {
+    if (x->apiFd == y->apiFd && x->count == y->count) {
         if (x->code == y->code) {
             if (_StringEquals(x->message, y->message)) {
                 if (ccnxName_Equals(x->name, y->name)) {
@@ -143,10 +160,16 @@ notifyStatus_GetMessage(const NotifyStatus *status)
     return status->message;
 }
 
+uint32_t
+notifyStatus_GetCount(const NotifyStatus *status)
+{
+    return status->count;
+}
+
 void
 notifyStatus_Display(const NotifyStatus *status, int indentation)
 {
-    parcDisplayIndented_PrintLine(indentation, "NotifyStatus%p { .apiFd=%d, .code=%d ", status, status->apiFd, status->code);
+    parcDisplayIndented_PrintLine(indentation, "NotifyStatus%p { .apiFd=%d, .code=%d, .count=%u ", status, status->apiFd, status->code, status->count);
     ccnxName_Display(status->name, indentation + 1);
     parcDisplayIndented_PrintLine(indentation, ".message=\"%s\"\n", status->message);
 }
@@ -163,6 +186,12 @@ notifyStatus_IsFlowControlStarted(const NotifyStatus *status)
     return status->code == notifyStatusCode_FLOW_CONTROL_STARTED;
 }
 
+bool
+notifyStatus_IsInterestTimeout(const NotifyStatus *status)
+{
+    return status->code == notifyStatusCode_INTEREST_TIMEOUT;
+}
+
 NotifyStatus *
 notifyStatus_ParseJSON(const PARCJSON *json)
 {
@@ -193,7 +222,13 @@ notifyStatus_ParseJSON(const PARCJSON *json)
             message = parcBuffer_Overlay(sBuf, 0);
         }
 
-        result = notifyStatus_Create(apiFd, code, name, message);
+        uint32_t count = 1;
+        PARCJSONValue *countValue = parcJSON_GetValueByName(status_json, param_COUNT);
+        if (countValue != NULL && parcJSONValue_GetInteger(countValue) > 0) {
+            count = (uint32_t) parcJSONValue_GetInteger(countValue);
+        }
+
+        result = notifyStatus_CreateWithCount(apiFd, code, name, message, count);
         if (name != NULL) {
             ccnxName_Release(&name);
         }
@@ -218,9 +253,124 @@ notifyStatus_ToJSON(const NotifyStatus *status)
         parcJSON_AddString(json, param_MESSAGE, notifyStatus_GetMessage(status));
     }
 
+    // a single event keeps the original form
+    if (notifyStatus_GetCount(status) > 1) {
+        parcJSON_AddInteger(json, param_COUNT, notifyStatus_GetCount(status));
+    }
+
     PARCJSON *result = parcJSON_Create();
     parcJSON_AddObject(result, jsonNotifyStatus, json);
     parcJSON_Release(&json);
 
     return result;
 }
+
+PARCBuffer *
+notifyStatus_ToBinary(const NotifyStatus *status)
+{
+    char *name = NULL;
+    size_t nameLength = 0;
+    if (status->name != NULL) {
+        name = ccnxName_ToString(status->name);
+        nameLength = strlen(name);
+    }
+    size_t messageLength = (status->message == NULL) ? 0 : strlen(status->message);
+
+    if (nameLength > UINT16_MAX || messageLength > UINT16_MAX) {
+        // a valid status, only too long for the 16-bit lengths
+        if (name != NULL) {
+            parcMemory_Deallocate((void **) &name);
+        }
+        return NULL;
+    }
+
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    parcBufferComposer_PutUint8(composer, NOTIFY_STATUS_BINARY_VERSION);
+    parcBufferComposer_PutUint8(composer, (uint8_t) status->code);
+    parcBufferComposer_PutUint32(composer, status->count);
+    parcBufferComposer_PutUint32(composer, (uint32_t) status->apiFd);
+    parcBufferComposer_PutUint16(composer, (uint16_t) nameLength);
+    parcBufferComposer_PutUint16(composer, (uint16_t) messageLength);
+    if (nameLength > 0) {
+        parcBufferComposer_PutArray(composer, (const uint8_t *) name, nameLength);
+    }
+    if (messageLength > 0) {
+        parcBufferComposer_PutArray(composer, (const uint8_t *) status->message, messageLength);
+    }
+
+    PARCBuffer *result = parcBufferComposer_ProduceBuffer(composer);
+    parcBufferComposer_Release(&composer);
+
+    if (name != NULL) {
+        parcMemory_Deallocate((void **) &name);
+    }
+    return result;
+}
+
+static uint16_t
+_getUint16(const uint8_t *p)
+{
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static uint32_t
+_getUint32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+bool
+notifyStatus_IsBinary(const PARCBuffer *encoding)
+{
+    if (encoding == NULL || parcBuffer_Remaining(encoding) < _binaryFixedLength) {
+        return false;
+    }
+    const uint8_t *p = parcBuffer_Overlay((PARCBuffer *) encoding, 0);
+    return p[0] == NOTIFY_STATUS_BINARY_VERSION;
+}
+
+NotifyStatus *
+notifyStatus_ParseBinary(const PARCBuffer *encoding)
+{
+    if (!notifyStatus_IsBinary(encoding)) {
+        return NULL;
+    }
+
+    size_t length = parcBuffer_Remaining(encoding);
+    const uint8_t *p = parcBuffer_Overlay((PARCBuffer *) encoding, 0);
+
+    NotifyStatusCode code = (NotifyStatusCode) p[1];
+    uint32_t count = _getUint32(p + 2);
+    int apiFd = (int) _getUint32(p + 6);
+    size_t nameLength = _getUint16(p + 10);
+    size_t messageLength = _getUint16(p + 12);
+
+    if (count == 0 || _binaryFixedLength + nameLength + messageLength > length) {
+        return NULL;
+    }
+
+    CCNxName *name = NULL;
+    if (nameLength > 0) {
+        char *uri = parcMemory_StringDuplicate((const char *) p + _binaryFixedLength, nameLength);
+        name = ccnxName_CreateFromURI(uri);
+        parcMemory_Deallocate((void **) &uri);
+        if (name == NULL) {
+            return NULL;
+        }
+    }
+
+    char *message = NULL;
+    if (messageLength > 0) {
+        message = parcMemory_StringDuplicate((const char *) p + _binaryFixedLength + nameLength, messageLength);
+    }
+
+    NotifyStatus *result = notifyStatus_CreateWithCount(apiFd, code, name, message, count);
+
+    if (message != NULL) {
+        parcMemory_Deallocate((void **) &message);
+    }
+    if (name != NULL) {
+        ccnxName_Release(&name);
+    }
+    return result;
+}
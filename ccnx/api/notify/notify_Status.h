@@ -38,9 +38,18 @@
 #ifndef Libccnx_notifyStatus_h
 #define Libccnx_notifyStatus_h
 
+#include <stdint.h>
+
 #include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Buffer.h>
 #include <ccnx/common/ccnx_Name.h>
 
+/**
+ * The first byte of the binary form of a `NotifyStatus`, see `notifyStatus_ToBinary()`.
+ * It differs from the version byte of a binary CPI message, so both can travel in a control message.
+ */
+#define NOTIFY_STATUS_BINARY_VERSION 0x80
+
 struct notify_status;
 /**
  * @typedef NotifyStatus
@@ -66,6 +75,8 @@ typedef enum {
     notifyStatusCode_ENCODING_ERROR          = 10, // something bad in the codec
     notifyStatusCode_SIGNING_ERROR           = 11, // error signing
     notifyStatusCode_SEND_ERROR              = 12, // some other "down" stack error
+    notifyStatusCode_INTEREST_TIMEOUT        = 13, // a pending Interest's lifetime expired without a Content Object
+    notifyStatusCode_VERIFICATION_ERROR      = 14, // a Content Object failed signature verification
 } NotifyStatusCode;
 
 /**
@@ -100,6 +111,29 @@ typedef enum {
  */
 NotifyStatus *notifyStatus_Create(int apiFd, NotifyStatusCode code, CCNxName *name, const char *message);
 
+/**
+ * Create an instance of `NotifyStatus` that stands for several events with the same code.
+ *
+ * The Transport may coalesce repeated statuses on a connection (see `apiConnector_SetStatusWindow()`).
+ * The name and message are those of the last event.
+ *
+ * @param [in] apiFd The corresponding api file descriptor.
+ * @param [in] code The NotifyStatusCode for this status.
+ * @param [in] name An associated CCNxName
+ * @param [in] message An (optional) string message
+ * @param [in] count The number of events (positive)
+ *
+ * @return non-NULL A pointer to a valid NotifyStatus instance that must be released via notifyStatus_Release().
+ *
+ * Example:
+ * @code
+ * {
+ *     NotifyStatus *status = notifyStatus_CreateWithCount(1, notifyStatusCode_INTEREST_TIMEOUT, name, NULL, 250);
+ * }
+ * @endcode
+ */
+NotifyStatus *notifyStatus_CreateWithCount(int apiFd, NotifyStatusCode code, CCNxName *name, const char *message, uint32_t count);
+
 /**
  * Increase the number of references to a `NotifyStatus`.
  *
@@ -270,6 +304,25 @@ CCNxName *notifyStatus_GetName(const NotifyStatus *status);
  */
 char *notifyStatus_GetMessage(const NotifyStatus *status);
 
+/**
+ * The number of events the given `NotifyStatus` stands for.
+ *
+ * @param [in] status A pointer to a valid instance of `NotifyStatus`.
+ *
+ * @return 1 A single event
+ * @return >1 Events with the same code, coalesced by the Transport
+ *
+ * Example:
+ * @code
+ * {
+ *     if (notifyStatus_IsInterestTimeout(status)) {
+ *         timeouts += notifyStatus_GetCount(status);
+ *     }
+ * }
+ * @endcode
+ */
+uint32_t notifyStatus_GetCount(const NotifyStatus *status);
+
 /**
  * Return a {@link PARCJSON} representation of the given `NotifyStatus` instance.
  *
@@ -355,4 +408,74 @@ bool notifyStatus_IsConnectionOpen(const NotifyStatus *status);
  * @endcode
  */
 bool notifyStatus_IsFlowControlStarted(const NotifyStatus *status);
+
+/**
+ * Return `true` if the given status indicates that a pending Interest timed out.
+ *
+ * The name of the status is the name of the Interest.
+ *
+ * @param [in] status  A pointer to a NotifyStatus instance.
+ *
+ * @return `true` The given `NotifyStatus` indicates that an Interest's lifetime expired
+ * @return `false` The given `NotifyStatus` is some other status
+ *
+ * Example:
+ * @code
+ * {
+ *     if (notifyStatus_IsInterestTimeout(status)) {
+ *         char *uri = ccnxName_ToString(notifyStatus_GetName(status));
+ *         printf("Interest %s timed out\n", uri);
+ *         parcMemory_Deallocate((void **) &uri);
+ *     }
+ * }
+ * @endcode
+ */
+bool notifyStatus_IsInterestTimeout(const NotifyStatus *status);
+
+/**
+ * A compact binary form of the status, which is cheaper to create and read than the JSON.
+ *
+ * @code
+ *   0      1      2             6             10            12            14
+ *   +------+------+-------------+-------------+-------------+-------------+------+---------
+ *   | ver  | code |    count    |    apiFd    | name length | msg length  | name | message
+ *   +------+------+-------------+-------------+-------------+-------------+------+---------
+ * @endcode
+ *
+ * Integers are in network byte order, the name is its URI and neither string is null terminated.
+ *
+ * @param [in] status A pointer to a valid instance of `NotifyStatus`.
+ *
+ * @return non-NULL The encoding, which must be released via parcBuffer_Release().
+ * @return NULL The name URI or the message is longer than UINT16_MAX, use `notifyStatus_ToJSON()`.
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCBuffer *encoding = notifyStatus_ToBinary(status);
+ *     NotifyStatus *copy = notifyStatus_ParseBinary(encoding);
+ * }
+ * @endcode
+ */
+PARCBuffer *notifyStatus_ToBinary(const NotifyStatus *status);
+
+/**
+ * Determine if the buffer holds the binary form of a `NotifyStatus`.
+ *
+ * @param [in] encoding A buffer, may be NULL
+ *
+ * @return true The buffer starts with NOTIFY_STATUS_BINARY_VERSION and is long enough
+ * @return false Otherwise
+ */
+bool notifyStatus_IsBinary(const PARCBuffer *encoding);
+
+/**
+ * Create a `NotifyStatus` from the binary form made by `notifyStatus_ToBinary()`.
+ *
+ * @param [in] encoding The binary form
+ *
+ * @return NULL The encoding is malformed
+ * @return non-NULL A pointer to a valid NotifyStatus instance that must be released via notifyStatus_Release().
+ */
+NotifyStatus *notifyStatus_ParseBinary(const PARCBuffer *encoding);
 #endif // Libccnx_notifyStatus_h
@@ -55,6 +55,13 @@ LONGBOW_TEST_RUNNER_TEARDOWN(notify_Status)
 LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ToJSON);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_IsInterestTimeout);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_CreateWithCount);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ToJSON_Count);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ToBinary);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ToBinary_NoName);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ToBinary_TooLong);
+    LONGBOW_RUN_TEST_CASE(Global, notifyStatus_ParseBinary_Truncated);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -83,6 +90,129 @@ LONGBOW_TEST_CASE(Global, notifyStatus_ToJSON)
     }
 }
 
+LONGBOW_TEST_CASE(Global, notifyStatus_IsInterestTimeout)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/a/b/c");
+    NotifyStatus *timeout = notifyStatus_Create(1, notifyStatusCode_INTEREST_TIMEOUT, name, NULL);
+    NotifyStatus *open = notifyStatus_Create(1, notifyStatusCode_CONNECTION_OPEN, name, NULL);
+
+    assertTrue(notifyStatus_IsInterestTimeout(timeout), "Expected INTEREST_TIMEOUT to be a timeout");
+    assertFalse(notifyStatus_IsInterestTimeout(open), "Expected CONNECTION_OPEN not to be a timeout");
+
+    notifyStatus_Release(&timeout);
+    notifyStatus_Release(&open);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_CreateWithCount)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/a/b/c");
+    NotifyStatus *single = notifyStatus_Create(1, notifyStatusCode_INTEREST_TIMEOUT, name, NULL);
+    NotifyStatus *many = notifyStatus_CreateWithCount(1, notifyStatusCode_INTEREST_TIMEOUT, name, NULL, 7);
+
+    assertTrue(notifyStatus_GetCount(single) == 1, "Expected count 1, got %u", notifyStatus_GetCount(single));
+    assertTrue(notifyStatus_GetCount(many) == 7, "Expected count 7, got %u", notifyStatus_GetCount(many));
+    assertFalse(notifyStatus_Equals(single, many), "Statuses with different counts should not be equal");
+
+    notifyStatus_Release(&single);
+    notifyStatus_Release(&many);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_ToJSON_Count)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/a/b/c");
+    NotifyStatus *expected = notifyStatus_CreateWithCount(3, notifyStatusCode_FLOW_CONTROL_FINISHED, name, "done", 42);
+
+    PARCJSON *json = notifyStatus_ToJSON(expected);
+    NotifyStatus *actual = notifyStatus_ParseJSON(json);
+
+    assertTrue(notifyStatus_Equals(expected, actual), "Failed to create and parse NotifyStatus")
+    {
+        notifyStatus_Display(expected, 0);
+        notifyStatus_Display(actual, 0);
+    }
+
+    notifyStatus_Release(&actual);
+    parcJSON_Release(&json);
+    notifyStatus_Release(&expected);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_ToBinary)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/a/b/c");
+    NotifyStatus *expected = notifyStatus_CreateWithCount(9, notifyStatusCode_CONNECTION_CLOSED, name, "socket error", 3);
+
+    PARCBuffer *encoding = notifyStatus_ToBinary(expected);
+    assertTrue(notifyStatus_IsBinary(encoding), "Expected a binary NotifyStatus");
+
+    NotifyStatus *actual = notifyStatus_ParseBinary(encoding);
+    assertTrue(notifyStatus_Equals(expected, actual), "Failed to encode and parse NotifyStatus")
+    {
+        notifyStatus_Display(expected, 0);
+        notifyStatus_Display(actual, 0);
+    }
+
+    notifyStatus_Release(&actual);
+    parcBuffer_Release(&encoding);
+    notifyStatus_Release(&expected);
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_ToBinary_NoName)
+{
+    NotifyStatus *expected = notifyStatus_Create(2, notifyStatusCode_CONNECTION_OPEN, NULL, NULL);
+
+    PARCBuffer *encoding = notifyStatus_ToBinary(expected);
+    assertTrue(parcBuffer_Remaining(encoding) == _binaryFixedLength,
+               "Expected %zu bytes, got %zu", _binaryFixedLength, parcBuffer_Remaining(encoding));
+
+    NotifyStatus *actual = notifyStatus_ParseBinary(encoding);
+    assertTrue(notifyStatus_Equals(expected, actual), "Failed to encode and parse NotifyStatus");
+
+    notifyStatus_Release(&actual);
+    parcBuffer_Release(&encoding);
+    notifyStatus_Release(&expected);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_ToBinary_TooLong)
+{
+    size_t length = UINT16_MAX + 1;
+    char *message = parcMemory_Allocate(length + 1);
+    assertNotNull(message, "parcMemory_Allocate(%zu) returned NULL", length + 1);
+    memset(message, 'x', length);
+    message[length] = '\0';
+
+    NotifyStatus *status = notifyStatus_Create(1, notifyStatusCode_SEND_ERROR, NULL, message);
+    assertNull(notifyStatus_ToBinary(status), "A message longer than UINT16_MAX should have no binary form");
+
+    // the JSON form still carries it
+    PARCJSON *json = notifyStatus_ToJSON(status);
+    NotifyStatus *actual = notifyStatus_ParseJSON(json);
+    assertTrue(notifyStatus_Equals(status, actual), "The JSON form should keep the long message");
+
+    notifyStatus_Release(&actual);
+    parcJSON_Release(&json);
+    notifyStatus_Release(&status);
+    parcMemory_Deallocate((void **) &message);
+}
+
+LONGBOW_TEST_CASE(Global, notifyStatus_ParseBinary_Truncated)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/a/b/c");
+    NotifyStatus *status = notifyStatus_Create(1, notifyStatusCode_SEND_ERROR, name, "lost");
+
+    PARCBuffer *encoding = notifyStatus_ToBinary(status);
+    parcBuffer_SetLimit(encoding, parcBuffer_Limit(encoding) - 1);
+
+    assertNull(notifyStatus_ParseBinary(encoding), "A truncated encoding should not parse");
+
+    parcBuffer_Release(&encoding);
+    notifyStatus_Release(&status);
+    ccnxName_Release(&name);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
 }
@@ -59,6 +59,8 @@ LONGBOW_TEST_RUNNER_TEARDOWN(transport)
 LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, Transport_Create_RTA);
+    LONGBOW_RUN_TEST_CASE(Global, Transport_CreateContext);
+    LONGBOW_RUN_TEST_CASE(Global, Transport_CreateContext_WithDefault);
     LONGBOW_RUN_TEST_CASE(Global, Transport_Close);
     LONGBOW_RUN_TEST_CASE(Global, Transport_Destroy);
     LONGBOW_RUN_TEST_CASE(Global, Transport_Open);
@@ -93,6 +95,35 @@ LONGBOW_TEST_CASE(Global, Transport_Create_RTA)
     Transport_Destroy(&transport);
 }
 
+LONGBOW_TEST_CASE(Global, Transport_CreateContext)
+{
+    TransportContext *a = Transport_CreateContext(TRANSPORT_RTA);
+    TransportContext *b = Transport_CreateContext(TRANSPORT_RTA);
+
+    assertTrue(a != b, "Independent contexts must be distinct");
+    assertTrue(a->transport_data != b->transport_data, "Independent contexts must not share a transport");
+    assertTrue(a->references == 1, "Wrong reference count, expected 1 got %u", a->references);
+
+    Transport_Destroy(&a);
+    assertNull(a, "Transport_Destroy did not null the pointer");
+    Transport_Destroy(&b);
+}
+
+LONGBOW_TEST_CASE(Global, Transport_CreateContext_WithDefault)
+{
+    TransportContext *shared = Transport_Create(TRANSPORT_RTA);
+    TransportContext *independent = Transport_CreateContext(TRANSPORT_RTA);
+
+    assertTrue(shared != independent, "Independent context must not be the default context");
+    assertTrue(the_context == shared, "Creating an independent context changed the default");
+
+    Transport_Destroy(&independent);
+    assertTrue(the_context == shared, "Destroying an independent context changed the default");
+
+    Transport_Destroy(&shared);
+    assertNull(the_context, "Default context not cleared");
+}
+
 LONGBOW_TEST_CASE(Global, Transport_Destroy)
 {
     TransportContext *transport = Transport_Create(TRANSPORT_RTA);
@@ -125,6 +156,8 @@ LONGBOW_TEST_CASE(Global, Transport_Send)
 
 LONGBOW_TEST_FIXTURE(Static)
 {
+    LONGBOW_RUN_TEST_CASE(Static, _transport_SetDescriptorContext);
+    LONGBOW_RUN_TEST_CASE(Static, _transport_ClearContextDescriptors);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Static)
@@ -137,6 +170,44 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Static)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+LONGBOW_TEST_CASE(Static, _transport_SetDescriptorContext)
+{
+    TransportContext *shared = Transport_Create(TRANSPORT_RTA);
+    TransportContext *ctx = Transport_CreateContext(TRANSPORT_RTA);
+
+    _transport_SetDescriptorContext(3, ctx);
+    _transport_SetDescriptorContext(200, ctx);
+    assertTrue(_descriptorCapacity > 200, "Table did not grow, capacity %zu", _descriptorCapacity);
+
+    assertTrue(_transport_GetDescriptorContext(3) == ctx, "Wrong context for descriptor 3");
+    assertTrue(_transport_GetDescriptorContext(200) == ctx, "Wrong context for descriptor 200");
+    assertTrue(_transport_GetDescriptorContext(4) == shared, "Unmapped descriptor should use the default context");
+    assertTrue(_transport_GetDescriptorContext(5000) == shared, "Out of range descriptor should use the default context");
+
+    _transport_SetDescriptorContext(3, NULL);
+    assertTrue(_transport_GetDescriptorContext(3) == shared, "Cleared descriptor should use the default context");
+
+    Transport_Destroy(&ctx);
+    Transport_Destroy(&shared);
+}
+
+LONGBOW_TEST_CASE(Static, _transport_ClearContextDescriptors)
+{
+    TransportContext *a = Transport_CreateContext(TRANSPORT_RTA);
+    TransportContext *b = Transport_CreateContext(TRANSPORT_RTA);
+
+    _transport_SetDescriptorContext(7, a);
+    _transport_SetDescriptorContext(8, b);
+
+    Transport_Destroy(&a);
+    assertTrue(_descriptorContexts[7] == NULL, "Destroyed context still owns descriptor 7");
+    assertTrue(_descriptorContexts[8] == b, "Destroying one context dropped another's descriptor");
+
+    Transport_Destroy(&b);
+    assertNull(_descriptorContexts, "Descriptor table not freed once empty");
+    assertTrue(_descriptorCapacity == 0, "Descriptor capacity not reset, got %zu", _descriptorCapacity);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <LongBow/runtime.h>
 
@@ -48,29 +49,106 @@ struct transport_context {
     unsigned references;
 };
 
-// the one global transport, for now
+// the default transport, shared by every Transport_Create()
 static TransportContext *the_context = NULL;
 
+// The context that opened each descriptor, indexed by descriptor.  Descriptors opened on
+// the default transport are not in the table.  Written on open, close and destroy, read on
+// every send and receive.
+static pthread_rwlock_t _descriptorLock = PTHREAD_RWLOCK_INITIALIZER;
+static TransportContext **_descriptorContexts = NULL;
+static size_t _descriptorCapacity = 0;
+
+static TransportContext *
+_transport_AllocateContext(TransportTypes type)
+{
+    TransportContext *ctx = NULL;
+    switch (type) {
+        case TRANSPORT_RTA:
+            ctx = parcMemory_Allocate(sizeof(TransportContext));
+            assertNotNull(ctx, "TransportContext could not be allocated, parcMemory_Allocate(%zu) returned NULL", sizeof(TransportContext));
+
+            ctx->references = 0;
+            ctx->ops = rta_ops;
+            ctx->transport_data = ctx->ops.Create();
+            ctx->transport_type = type;
+            break;
+
+        default:
+            fprintf(stderr, "%s unknown transport type %d\n", __func__, type);
+            abort();
+            break;
+    }
+    return ctx;
+}
+
+static void
+_transport_SetDescriptorContext(int desc, TransportContext *ctx)
+{
+    pthread_rwlock_wrlock(&_descriptorLock);
+    if ((size_t) desc >= _descriptorCapacity) {
+        size_t capacity = (_descriptorCapacity == 0) ? 64 : _descriptorCapacity;
+        while (capacity <= (size_t) desc) {
+            capacity *= 2;
+        }
+
+        TransportContext **table = parcMemory_AllocateAndClear(capacity * sizeof(TransportContext *));
+        assertNotNull(table, "parcMemory_AllocateAndClear(%zu) returned NULL", capacity * sizeof(TransportContext *));
+        if (_descriptorContexts != NULL) {
+            memcpy(table, _descriptorContexts, _descriptorCapacity * sizeof(TransportContext *));
+            parcMemory_Deallocate((void **) &_descriptorContexts);
+        }
+        _descriptorContexts = table;
+        _descriptorCapacity = capacity;
+    }
+    _descriptorContexts[desc] = ctx;
+    pthread_rwlock_unlock(&_descriptorLock);
+}
+
+/**
+ * Forgets every descriptor of the context, and frees the table once it is empty
+ */
+static void
+_transport_ClearContextDescriptors(TransportContext *ctx)
+{
+    pthread_rwlock_wrlock(&_descriptorLock);
+    bool empty = true;
+    for (size_t i = 0; i < _descriptorCapacity; i++) {
+        if (_descriptorContexts[i] == ctx) {
+            _descriptorContexts[i] = NULL;
+        } else if (_descriptorContexts[i] != NULL) {
+            empty = false;
+        }
+    }
+    if (empty && _descriptorContexts != NULL) {
+        parcMemory_Deallocate((void **) &_descriptorContexts);
+        _descriptorCapacity = 0;
+    }
+    pthread_rwlock_unlock(&_descriptorLock);
+}
+
+static TransportContext *
+_transport_GetDescriptorContext(int desc)
+{
+    TransportContext *ctx = NULL;
+    pthread_rwlock_rdlock(&_descriptorLock);
+    if (desc >= 0 && (size_t) desc < _descriptorCapacity) {
+        ctx = _descriptorContexts[desc];
+    }
+    pthread_rwlock_unlock(&_descriptorLock);
+
+    if (ctx == NULL) {
+        ctx = the_context;
+    }
+    assertNotNull(ctx, "Descriptor %d is not open on any TransportContext", desc);
+    return ctx;
+}
+
 TransportContext *
 Transport_Create(TransportTypes type)
 {
     if (the_context == NULL) {
-        switch (type) {
-            case TRANSPORT_RTA:
-                the_context = parcMemory_Allocate(sizeof(TransportContext));
-                assertNotNull(the_context, "TransportContext could not be allocated, parcMemory_Allocate(%zu) returned NULL", sizeof(TransportContext));
-
-                the_context->references = 0;
-                the_context->ops = rta_ops;
-                the_context->transport_data = the_context->ops.Create();
-                the_context->transport_type = type;
-                break;
-
-            default:
-                fprintf(stderr, "%s unknown transport type %d\n", __func__, type);
-                abort();
-                break;
-        }
+        the_context = _transport_AllocateContext(type);
     }
 
     if (the_context->transport_type == type) {
@@ -83,6 +161,14 @@ Transport_Create(TransportTypes type)
     abort();
 }
 
+TransportContext *
+Transport_CreateContext(TransportTypes type)
+{
+    TransportContext *ctx = _transport_AllocateContext(type);
+    ctx->references = 1;
+    return ctx;
+}
+
 int
 Transport_Open(CCNxTransportConfig *transportConfig)
 {
@@ -91,23 +177,41 @@ Transport_Open(CCNxTransportConfig *transportConfig)
     return the_context->ops.Open(the_context->transport_data, transportConfig);
 }
 
+int
+Transport_OpenWithContext(TransportContext *ctx, CCNxTransportConfig *transportConfig)
+{
+    assertNotNull(ctx, "Parameter ctx must be a non-null TransportContext");
+    assertNotNull(transportConfig, "The parameter transportConfig must be a non-null CCNxTransportConfig pointer");
+
+    int desc = ctx->ops.Open(ctx->transport_data, transportConfig);
+    if (desc >= 0 && ctx != the_context) {
+        _transport_SetDescriptorContext(desc, ctx);
+    }
+    return desc;
+}
+
 int
 Transport_Send(int desc, CCNxMetaMessage *msg_in)
 {
-    assertNotNull(the_context, "the_context is null");
-    return the_context->ops.Send(the_context->transport_data, desc, msg_in, CCNxStackTimeout_Never);
+    TransportContext *ctx = _transport_GetDescriptorContext(desc);
+    return ctx->ops.Send(ctx->transport_data, desc, msg_in, CCNxStackTimeout_Never);
 }
 
 TransportIOStatus
 Transport_Recv(int desc, CCNxMetaMessage **msg_out)
 {
-    return the_context->ops.Recv(the_context->transport_data, desc, msg_out, CCNxStackTimeout_Never);
+    TransportContext *ctx = _transport_GetDescriptorContext(desc);
+    return ctx->ops.Recv(ctx->transport_data, desc, msg_out, CCNxStackTimeout_Never);
 }
 
 int
 Transport_Close(int desc)
 {
-    return the_context->ops.Close(the_context->transport_data, desc);
+    TransportContext *ctx = _transport_GetDescriptorContext(desc);
+    if (ctx != the_context) {
+        _transport_SetDescriptorContext(desc, NULL);
+    }
+    return ctx->ops.Close(ctx->transport_data, desc);
 }
 
 int
@@ -116,6 +220,13 @@ Transport_PassCommand(void *stackCommand)
     return the_context->ops.PassCommand(the_context->transport_data, stackCommand);
 }
 
+int
+Transport_PassCommandWithContext(TransportContext *ctx, void *stackCommand)
+{
+    assertNotNull(ctx, "Parameter ctx must be a non-null TransportContext");
+    return ctx->ops.PassCommand(ctx->transport_data, stackCommand);
+}
+
 void
 Transport_Destroy(TransportContext **ctxPtr)
 {
@@ -124,15 +235,18 @@ Transport_Destroy(TransportContext **ctxPtr)
 
     TransportContext *ctx = *ctxPtr;
 
-    assertTrue(the_context == ctx, "Passed ctx is not the same");
     assertTrue(ctx->references > 0, "Invalid reference count");
 
     ctx->references--;
     if (ctx->references == 0) {
+        if (ctx == the_context) {
+            the_context = NULL;
+        } else {
+            _transport_ClearContextDescriptors(ctx);
+        }
         ctx->ops.Destroy(&ctx->transport_data);
         memset(ctx, 0, sizeof(TransportContext));
         parcMemory_Deallocate((void **) &ctx);
-        ctx = NULL;
-        the_context = NULL;
     }
+    *ctxPtr = NULL;
 }
@@ -33,11 +33,16 @@
  *
  * An API will call transport_Create(type), to create
  * a transport of the given type.  Only type TRANSPORT_RTA
- * is supported at this time.  Only one transport may exist,
- * so multiple calls to transport_Create() will return
- * a reference counted pointer to the same transport.
+ * is supported at this time.  Multiple calls to transport_Create()
+ * return a reference counted pointer to the same default transport.
  * When an API is done, it should call transport_Destroy().
  *
+ * A process that wants several independent stacks, for example one
+ * per worker thread, calls Transport_CreateContext() for each and opens
+ * connections with Transport_OpenWithContext().  Each context has its
+ * own framework thread and shares nothing with the others.  Send, Recv
+ * and Close find the context from the descriptor.
+ *
  * An API opens connections with the forwarder via
  * transport_Open(PARCJSON *).  The JSON dictionary defines
  * the properties of the protocol stack associated with the
@@ -162,16 +167,42 @@ typedef uint64_t CCNxStackTimeout;
 
 
 /**
- * Initialize transport.  Creates a thread of execution,
- * you only need one of these.
+ * Initialize the default transport.  Creates a thread of execution.
  *
- * You can only have one of these.  Multiple calls return a
- * reference to the existing one (if same type) or an error.
+ * Multiple calls return a reference to the existing default transport
+ * (if same type) or an error.  Use Transport_CreateContext() for a
+ * transport that is not shared.
  *
  * NULL means error.
  */
 TransportContext *Transport_Create(TransportTypes type);
 
+/**
+ * Create a new, independent transport with its own thread of execution.
+ *
+ * Unlike Transport_Create(), every call returns a distinct context with a
+ * reference count of 1.  Connections are opened on it with
+ * Transport_OpenWithContext().  Release it with Transport_Destroy().
+ *
+ * @param [in] type The type of transport
+ *
+ * @return non-null A new TransportContext
+ *
+ * Example:
+ * @code
+ * {
+ *     TransportContext *ctx = Transport_CreateContext(TRANSPORT_RTA);
+ *     int desc = Transport_OpenWithContext(ctx, transportConfig);
+ *     ...
+ *     Transport_Close(desc);
+ *     Transport_Destroy(&ctx);
+ * }
+ * @endcode
+ *
+ * @see Transport_Create
+ */
+TransportContext *Transport_CreateContext(TransportTypes type);
+
 /**
  * Open a descriptor.  You may use a select(2) or poll(2) on it, but
  * you must only use Transport_{Send, Recv, Close} to modify it.
@@ -192,6 +223,22 @@ TransportContext *Transport_Create(TransportTypes type);
  */
 int Transport_Open(CCNxTransportConfig *transportConfig);
 
+/**
+ * Open a descriptor on a specific transport.
+ *
+ * Same as Transport_Open(), but the connection belongs to `ctx` rather
+ * than the default transport.  The descriptor is then used with the
+ * ordinary Transport_{Send, Recv, Close}.
+ *
+ * @param [in] ctx The transport to open the connection on
+ * @param [in] transportConfig the transport configuration object
+ *
+ * @return the newly opened descriptor
+ *
+ * @see Transport_CreateContext
+ */
+int Transport_OpenWithContext(TransportContext *ctx, CCNxTransportConfig *transportConfig);
+
 /**
  * Send a `CCNxMetaMessage` to the transport. The CCNxMetaMessage instance is acquired by
  * the stack and can be released by the caller immediately after sending if desired.
@@ -266,6 +313,13 @@ int Transport_Close(int desc);
  */
 int Transport_PassCommand(void *stackCommand);
 
+/**
+ * Same as Transport_PassCommand(), but to a specific transport.
+ *
+ * @see Transport_PassCommand
+ */
+int Transport_PassCommandWithContext(TransportContext *ctx, void *stackCommand);
+
 /**
  * Destroy a TransportContext instance.  Shuts done all descriptors and any pending data is lost.
  *
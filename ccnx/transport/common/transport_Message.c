@@ -48,6 +48,11 @@ struct transport_message {
     TransportMessage_Free *freefunc;
     void *info;
 
+    // set while the dictionary is only partially decoded
+    TransportMessage_Decoder *decoder;
+    void *decodeState;
+    TransportMessage_Free *decodeStateFree;
+
     struct timeval creationTime;
 };
 
@@ -145,6 +150,10 @@ _transportMessage_Destroy(TransportMessage **msgPtr)
             msg->freefunc(&msg->info);
         }
 
+        if (msg->decodeStateFree != NULL) {
+            msg->decodeStateFree(&msg->decodeState);
+        }
+
         parcMemory_Deallocate((void **) &msg);
         *msgPtr = NULL;
     }
@@ -184,6 +193,50 @@ transportMessage_GetInfo(const TransportMessage *tm)
     return tm->info;
 }
 
+void
+transportMessage_SetDeferredDecode(TransportMessage *tm, TransportMessage_Decoder *decoder, void *decodeState, TransportMessage_Free *freefunc)
+{
+    assertNotNull(tm, "%s called with NULL transport message", __func__);
+    assertNotNull(decoder, "%s called with NULL decoder", __func__);
+    assertNull(tm->decoder, "%s called on a message with a pending decode", __func__);
+    tm->decoder = decoder;
+    tm->decodeState = decodeState;
+    tm->decodeStateFree = freefunc;
+}
+
+bool
+transportMessage_IsDecodeDeferred(const TransportMessage *tm)
+{
+    assertNotNull(tm, "%s called with NULL transport message", __func__);
+    return (tm->decoder != NULL);
+}
+
+bool
+transportMessage_CompleteDecode(TransportMessage *tm)
+{
+    assertNotNull(tm, "%s called with NULL transport message", __func__);
+    if (tm->decoder == NULL) {
+        return true;
+    }
+
+    CCNxTlvDictionary *decoded = tm->decoder(tm->dictionary, tm->decodeState);
+
+    // the decode is attempted only once, whatever the outcome
+    tm->decoder = NULL;
+    if (tm->decodeStateFree != NULL) {
+        tm->decodeStateFree(&tm->decodeState);
+    }
+    tm->decodeState = NULL;
+    tm->decodeStateFree = NULL;
+
+    if (decoded == NULL) {
+        return false;
+    }
+
+    ccnxTlvDictionary_Release(&tm->dictionary);
+    tm->dictionary = decoded;
+    return true;
+}
 
 struct timeval
 transportMessage_GetDelay(const TransportMessage *tm)
@@ -165,6 +165,82 @@ void transportMessage_SetInfo(TransportMessage *tm, void *info, TransportMessage
  */
 void *transportMessage_GetInfo(const TransportMessage *tm);
 
+/**
+ * Completes a deferred decode.
+ *
+ * Called by `transportMessage_CompleteDecode()` with the partially decoded dictionary
+ * and the state given to `transportMessage_SetDeferredDecode()`.
+ *
+ * @return non-null A new, fully decoded dictionary that replaces the partial one
+ * @return null The packet could not be decoded
+ */
+typedef CCNxTlvDictionary *(TransportMessage_Decoder)(CCNxTlvDictionary *partial, void *decodeState);
+
+/**
+ * Marks the dictionary of the transport message as only partially decoded
+ *
+ * A codec that decodes only some fields of a received packet (e.g. the name) sets a decoder
+ * here to fill in the rest from the retained wire format.  A component that needs
+ * more than the eagerly decoded fields calls `transportMessage_CompleteDecode()` first.
+ * The decodeState is freed with freefunc once the decode completes or the message is destroyed.
+ *
+ * @param [in] tm The transport message
+ * @param [in] decoder Called once on the first `transportMessage_CompleteDecode()`
+ * @param [in] decodeState Passed to the decoder
+ * @param [in] freefunc Frees decodeState, may be NULL
+ *
+ * Example:
+ * @code
+ * {
+ *     transportMessage_SetDeferredDecode(tm, _myCodec_Decode, index, _myCodec_FreeIndex);
+ * }
+ * @endcode
+ *
+ * @see transportMessage_CompleteDecode
+ */
+void transportMessage_SetDeferredDecode(TransportMessage *tm, TransportMessage_Decoder *decoder, void *decodeState, TransportMessage_Free *freefunc);
+
+/**
+ * Determines if the dictionary is still only partially decoded
+ *
+ * @param [in] tm The transport message
+ *
+ * @return true A deferred decode is pending
+ * @return false The dictionary is fully decoded
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool transportMessage_IsDecodeDeferred(const TransportMessage *tm);
+
+/**
+ * Runs a pending deferred decode, replacing the dictionary with the fully decoded one
+ *
+ * Does nothing if there is no pending decode.  Any dictionary pointer previously returned by
+ * `transportMessage_GetDictionary()` may be stale after this call.  A caller should drop
+ * the message if this returns false.
+ *
+ * @param [in] tm The transport message
+ *
+ * @return true The dictionary is fully decoded
+ * @return false The packet could not be decoded
+ *
+ * Example:
+ * @code
+ * {
+ *     if (transportMessage_CompleteDecode(tm)) {
+ *         CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(tm);
+ *         ...
+ *     } else {
+ *         transportMessage_Destroy(&tm);
+ *     }
+ * }
+ * @endcode
+ */
+bool transportMessage_CompleteDecode(TransportMessage *tm);
+
 bool transportMessage_IsControl(const TransportMessage *tm);
 bool transportMessage_IsInterest(const TransportMessage *tm);
 bool transportMessage_IsContentObject(const TransportMessage *tm);
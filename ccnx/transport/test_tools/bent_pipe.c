@@ -41,6 +41,7 @@
 #include <string.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <math.h>
 #include <signal.h>
 #include <errno.h>
@@ -59,11 +60,26 @@
 
 #define MAX_CONN 10
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * A packet read from one client.  It is shared by the output queues of every
+ * client it is reflected to and freed when the last one sends it.
+ */
+struct bentpipe_packet {
+    unsigned refcount;
+    size_t length;
+    uint8_t bytes[];
+};
+
 struct packet_wrapper {
+    // when the link finishes sending it, then when it is delivered
+    double tx_end;
     struct timeval deadline;
     int ingress_fd;
-    uint8_t  *pbuff;
-    size_t pbuff_len;
+    struct bentpipe_packet *packet;
 
     TAILQ_ENTRY(packet_wrapper) list;
 };
@@ -83,6 +99,24 @@ struct bentpipe_conn {
     TAILQ_HEAD(, packet_wrapper) output_queue;
 
     PARCEventTimer *timer_event;
+
+    // The emulated link to this client.  params.rateTrace is our own copy.
+    BentPipeLinkParams params;
+    double trace_cycle_sec;
+    size_t trace_index;
+    double trace_step_start;
+
+    // when the link is next idle
+    double busy_until;
+
+    // the packets not yet sent at the link rate are backlog_head and everything after it
+    struct packet_wrapper *backlog_head;
+    unsigned backlog_bytes;
+
+    double red_average;
+    int red_count;
+
+    BentPipeLinkStats stats;
 };
 
 struct bentpipe_state {
@@ -95,11 +129,8 @@ struct bentpipe_state {
 
     pthread_t router_thread;
 
+    // true if any link emulation is set, otherwise packets are written straight through
     bool use_params;
-    double loss_rate;
-    unsigned buffer_bytes;
-    double mean_sec_delay;
-    double bytes_per_sec;
 
     pthread_mutex_t startup_mutex;
     pthread_cond_t startup_cond;
@@ -138,12 +169,13 @@ listener_cb(int fd, struct sockaddr *sa, int socklen, void *user_data);
 static void *run_bentpipe(void *arg);
 
 static void conn_readcb(PARCEventQueue *bev, PARCEventType event, void *connection);
-static void reflect(struct bentpipe_conn *conn, uint8_t *pbuff, size_t pbuff_len);
+static void reflect(struct bentpipe_conn *conn, struct bentpipe_packet *packet);
 
 static void
-queue_with_delay(struct bentpipe_conn *conn, uint8_t *pbuff, size_t pbuff_len, int i);
+queue_with_delay(struct bentpipe_conn *conn, struct bentpipe_packet *packet, int i);
 
 static void timer_cb(int fd, PARCEventType what, void *user_data);
+static void flush_output_queue(struct bentpipe_conn *conn);
 static void set_timer(struct bentpipe_conn *conn, struct timeval delay);
 static void keepalive_cb(int fd, PARCEventType what, void *user_data);
 void conn_errorcb(PARCEventQueue *bev, PARCEventQueueEventType events, void *user_framework);
@@ -180,6 +212,51 @@ signal_bentpipe(BentPipeState *bp)
     assertTrue(res == 0, "error from pthread_mutex_unlock: %d", res);
 }
 
+static double
+now_seconds(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec * 1E-6;
+}
+
+static struct timeval
+seconds_to_timeval(double seconds)
+{
+    struct timeval tv;
+    tv.tv_sec = (time_t) floor(seconds);
+    tv.tv_usec = (suseconds_t) floor((seconds - floor(seconds)) * 1E+6);
+    return tv;
+}
+
+static struct bentpipe_packet *
+packet_create(size_t length)
+{
+    struct bentpipe_packet *packet = parcMemory_Allocate(sizeof(struct bentpipe_packet) + length);
+    assertNotNull(packet, "parcMemory_Allocate(%zu) returned NULL", sizeof(struct bentpipe_packet) + length);
+    packet->refcount = 1;
+    packet->length = length;
+    return packet;
+}
+
+static struct bentpipe_packet *
+packet_acquire(struct bentpipe_packet *packet)
+{
+    packet->refcount++;
+    return packet;
+}
+
+static void
+packet_release(struct bentpipe_packet **packetPtr)
+{
+    struct bentpipe_packet *packet = *packetPtr;
+    assertTrue(packet->refcount > 0, "invalid state: packet refcount is 0");
+    if (--packet->refcount == 0) {
+        parcMemory_Deallocate((void **) &packet);
+    }
+    *packetPtr = NULL;
+}
+
 /**
  * if SIGPIPE was pending before we are called, don't do anything.
  * Otherwise, mask SIGPIPE
@@ -260,6 +337,7 @@ bentpipe_Create(const char *local_name)
         bp->conns[i].bytes_in_queue = 0;
         TAILQ_INIT(&bp->conns[i].output_queue);
         bp->conns[i].timer_event = parcEventTimer_Create(bp->base, 0, timer_cb, &bp->conns[i]);
+        bentpipe_LinkParamsInit(&bp->conns[i].params);
     }
     setup_local(bp);
     capture_sigpipe(bp);
@@ -283,7 +361,11 @@ bentpipe_Destroy(BentPipeState **bpPtr)
             parcEventQueue_Destroy(&(bp->conns[i].bev));
             bp->conns[i].client_fd = 0;
         }
+        flush_output_queue(&bp->conns[i]);
         parcEventTimer_Destroy(&(bp->conns[i].timer_event));
+        if (bp->conns[i].params.rateTrace != NULL) {
+            parcMemory_Deallocate((void **) &(bp->conns[i].params.rateTrace));
+        }
     }
 
     parcEventTimer_Destroy(&(bp->keep_alive_event));
@@ -413,6 +495,39 @@ run_bentpipe(void *arg)
     pthread_exit(NULL);
 }
 
+/**
+ * Drops everything waiting to go to the client
+ */
+static void
+flush_output_queue(struct bentpipe_conn *conn)
+{
+    struct packet_wrapper *wrapper;
+    while ((wrapper = TAILQ_FIRST(&conn->output_queue)) != NULL) {
+        TAILQ_REMOVE(&conn->output_queue, wrapper, list);
+        packet_release(&wrapper->packet);
+        parcMemory_Deallocate((void **) &wrapper);
+    }
+    conn->bytes_in_queue = 0;
+    conn->count_in_queue = 0;
+    conn->backlog_head = NULL;
+    conn->backlog_bytes = 0;
+}
+
+/**
+ * A new client starts with an idle link at the start of its trace
+ */
+static void
+reset_link(struct bentpipe_conn *conn)
+{
+    double now = now_seconds();
+    conn->trace_index = 0;
+    conn->trace_step_start = now;
+    conn->busy_until = now;
+    conn->red_average = 0;
+    conn->red_count = -1;
+    timerclear(&conn->last_deadline);
+}
+
 static struct bentpipe_conn *
 allocate_connection(BentPipeState *bp)
 {
@@ -425,6 +540,7 @@ allocate_connection(BentPipeState *bp)
     for (int i = 0; i < MAX_CONN; i++) {
         if (bp->conns[i].client_fd == 0) {
             bp->conn_count++;
+            reset_link(&bp->conns[i]);
             return &bp->conns[i];
         }
     }
@@ -450,6 +566,7 @@ deallocate_connection(BentPipeState *bp, struct bentpipe_conn *conn)
     // this unschedules any callbacks, but the timer is still allocated
     // timer_event is freed in bentPipe_Destroy()
     parcEventTimer_Stop(conn->timer_event);
+    flush_output_queue(conn);
 
     bp->conn_count--;
 }
@@ -556,8 +673,8 @@ single_read(PARCEventQueue *bev, struct bentpipe_conn *conn)
         size_t pbuff_len = sizeof(localhdr) + conn->msg_length;
         int bytes_removed;
 
-        uint8_t *pbuff = parcMemory_Allocate(pbuff_len);
-        assertNotNull(pbuff, "parcMemory_Allocate(%zu) returned NULL", pbuff_len);
+        struct bentpipe_packet *packet = packet_create(pbuff_len);
+        uint8_t *pbuff = packet->bytes;
 
         // dequeue into packet buffer
         bytes_removed = parcEventBuffer_Read(input, (void *)pbuff, pbuff_len);
@@ -575,8 +692,8 @@ single_read(PARCEventQueue *bev, struct bentpipe_conn *conn)
             longBowDebug_MemoryDump((char *) pbuff, pbuff_len);
         }
 
-        // reflect will free the memory
-        reflect(conn, pbuff, pbuff_len);
+        // reflect will release the packet
+        reflect(conn, packet);
 
         // we could do more after this
         if (read_length > pbuff_len) {
@@ -603,41 +720,154 @@ conn_readcb(PARCEventQueue *bev, PARCEventType event, void *user_data)
 /*
  * reflect a message to other connections
  *
- * We should use the zero-copy deferred write...
+ * Without link emulation the packet is written to every other connection directly.  With
+ * it, each output queue holds a reference to the one packet, so it is never copied.
  */
 static void
-reflect(struct bentpipe_conn *conn, uint8_t *pbuff, size_t pbuff_len)
+reflect(struct bentpipe_conn *conn, struct bentpipe_packet *packet)
 {
     int i;
     BentPipeState *bp = conn->parent;
 
+    localhdr *msg_hdr = (localhdr *) packet->bytes;
+    assertTrue(msg_hdr->length + sizeof(localhdr) == packet->length,
+               "msg_hdr messed up!  expected %zu got %zu",
+               msg_hdr->length + sizeof(localhdr),
+               packet->length);
+
     for (i = 0; i < MAX_CONN; i++) {
         if (bp->conns[i].client_fd > 0 && bp->conns[i].client_fd != conn->client_fd) {
             int res;
 
             if (bp->chattyOutput) {
-                printf("%s connid %d adding buffer length %zu\n", __func__, conn[i].client_fd, pbuff_len);
+                printf("%s connid %d adding buffer length %zu\n", __func__, bp->conns[i].client_fd, packet->length);
             }
 
             if (bp->use_params) {
-                uint8_t *copy = parcMemory_Allocate(pbuff_len);
-                assertNotNull(copy, "parcMemory_Allocate(%zu) returned NULL", pbuff_len);
-                memcpy(copy, pbuff, pbuff_len);
-                queue_with_delay(conn, copy, pbuff_len, i);
+                queue_with_delay(conn, packet, i);
             } else {
-                res = parcEventQueue_Write(bp->conns[i].bev, pbuff, pbuff_len);
+                res = parcEventQueue_Write(bp->conns[i].bev, packet->bytes, packet->length);
                 assertTrue(res == 0, "%s got parcEventQueue_Write error\n", __func__);
+            }
+        }
+    }
+
+    packet_release(&packet);
+}
+
+/**
+ * When a link that starts sending at `start` finishes sending `bytes`, following the rate trace.
+ *
+ * Moves the link's trace position forward, so `start` must not go backwards between calls.
+ */
+static double
+link_serialize(struct bentpipe_conn *link, double start, size_t bytes)
+{
+    const BentPipeLinkParams *params = &link->params;
+    if (params->rateTraceLength == 0) {
+        return start;
+    }
+
+    // after an idle period, skip whole cycles of the trace
+    if (start - link->trace_step_start > link->trace_cycle_sec) {
+        link->trace_step_start += floor((start - link->trace_step_start) / link->trace_cycle_sec) * link->trace_cycle_sec;
+    }
 
-                localhdr *msg_hdr = (localhdr *) pbuff;
-                assertTrue(msg_hdr->length + sizeof(localhdr) == pbuff_len,
-                           "msg_hdr messed up!  expected %zu got %zu",
-                           msg_hdr->length + sizeof(localhdr),
-                           pbuff_len);
+    double t = start;
+    double remaining = bytes;
+    for (;;) {
+        const BentPipeRateStep *step = &params->rateTrace[link->trace_index];
+        double step_end = link->trace_step_start + step->seconds;
+
+        if (t < step_end) {
+            double capacity = step->bytes_per_sec * (step_end - t);
+            if (step->bytes_per_sec > 0 && capacity >= remaining) {
+                return t + remaining / step->bytes_per_sec;
             }
+            remaining -= capacity;
+            t = step_end;
         }
+
+        link->trace_step_start = step_end;
+        link->trace_index = (link->trace_index + 1) % params->rateTraceLength;
     }
+}
+
+static double
+link_sample_delay(const BentPipeLinkParams *params)
+{
+    double delay_sec;
 
-    parcMemory_Deallocate((void **) &pbuff);
+    switch (params->delayDistribution) {
+        case BentPipeDelay_Uniform:
+            delay_sec = params->mean_sec_delay + (2 * drand48() - 1) * params->delay_sec_parameter;
+            break;
+
+        case BentPipeDelay_Exponential:
+            // 1 - drand48() is in (0, 1], so the log is finite
+            delay_sec = -1 * log(1 - drand48()) * params->mean_sec_delay;
+            break;
+
+        case BentPipeDelay_Normal: {
+            // Box-Muller
+            double u1 = 1 - drand48();
+            double u2 = drand48();
+            delay_sec = params->mean_sec_delay + sqrt(-2 * log(u1)) * cos(2 * M_PI * u2) * params->delay_sec_parameter;
+            break;
+        }
+
+        case BentPipeDelay_Constant:
+        default:
+            delay_sec = params->mean_sec_delay;
+            break;
+    }
+
+    return (delay_sec > 0) ? delay_sec : 0;
+}
+
+/**
+ * Forget the packets the link has finished sending by `now`
+ */
+static void
+link_update_backlog(struct bentpipe_conn *link, double now)
+{
+    while (link->backlog_head != NULL && link->backlog_head->tx_end <= now) {
+        link->backlog_bytes -= link->backlog_head->packet->length;
+        link->backlog_head = TAILQ_NEXT(link->backlog_head, list);
+    }
+}
+
+/**
+ * RED (Floyd and Jacobson) on the average backlog
+ *
+ * @return true to drop the packet
+ */
+static bool
+link_red_drop(struct bentpipe_conn *link)
+{
+    const BentPipeLinkParams *params = &link->params;
+
+    link->red_average = (1 - params->red_weight) * link->red_average + params->red_weight * link->backlog_bytes;
+
+    if (link->red_average < params->red_min_bytes) {
+        link->red_count = -1;
+        return false;
+    }
+
+    if (link->red_average >= params->red_max_bytes) {
+        link->red_count = 0;
+        return true;
+    }
+
+    link->red_count++;
+    double pb = params->red_max_p * (link->red_average - params->red_min_bytes) / (params->red_max_bytes - params->red_min_bytes);
+    double denominator = 1 - link->red_count * pb;
+    double pa = (denominator > 0) ? pb / denominator : 1;
+    if (drand48() < pa) {
+        link->red_count = 0;
+        return true;
+    }
+    return false;
 }
 
 /**
@@ -645,83 +875,271 @@ reflect(struct bentpipe_conn *conn, uint8_t *pbuff, size_t pbuff_len)
  * in the connection's output_queue.  If there is not a timer running (i.e. there are now
  * exactly 1 elements in the queue), we start the timer for the connection.
  *
- * If the output queue is full, the packet might be freed and not added to the output queue.
+ * If the link drops the packet, it is not added to the output queue.
  */
 static void
-queue_with_delay(struct bentpipe_conn *conn, uint8_t *pbuff, size_t pbuff_len, int i)
+queue_with_delay(struct bentpipe_conn *conn, struct bentpipe_packet *packet, int i)
 {
     BentPipeState *bp = conn->parent;
-    double delay_sec;
-
-    struct timeval now;
-    struct timeval delay_tv;
-    struct timeval deadline;
+    struct bentpipe_conn *link = &bp->conns[i];
+    const BentPipeLinkParams *params = &link->params;
 
-    gettimeofday(&now, NULL);
+    double now = now_seconds();
+    link->stats.packetsIn++;
 
     // 1) Apply loss rate
-    if (drand48() < bp->loss_rate) {
+    if (params->loss_rate > 0 && drand48() < params->loss_rate) {
         if (bp->chattyOutput) {
             printf("%s random drop\n", __func__);
         }
-        parcMemory_Deallocate((void **) &pbuff);
+        link->stats.lossDrops++;
         return;
     }
 
     // 2) will it fit?
-    if (pbuff_len + bp->conns[i].bytes_in_queue >= bp->buffer_bytes) {
+    link_update_backlog(link, now);
+
+    if (params->queueDiscipline == BentPipeQueue_RED && link_red_drop(link)) {
         if (bp->chattyOutput) {
-            printf("%s queue full\n", __func__);
+            printf("%s red drop\n", __func__);
         }
-        parcMemory_Deallocate((void **) &pbuff);
+        link->stats.redDrops++;
         return;
     }
 
-    // 3) Determine delay
-    delay_sec = (double) pbuff_len / bp->bytes_per_sec;
+    if (packet->length + link->backlog_bytes > params->buffer_bytes) {
+        if (bp->chattyOutput) {
+            printf("%s queue full\n", __func__);
+        }
+        link->stats.queueDrops++;
+        return;
+    }
 
-    // 4) exponential delay
-    delay_sec += -1 * log(drand48()) * bp->mean_sec_delay;
+    // 3) Send it at the link rate after whatever is ahead of it
+    double tx_start = (link->busy_until > now) ? link->busy_until : now;
+    double tx_end = link_serialize(link, tx_start, packet->length);
+    link->busy_until = tx_end;
 
-    delay_tv.tv_sec = (time_t) floor(delay_sec);
-    delay_tv.tv_usec = (suseconds_t) floor((delay_sec - floor(delay_sec)) * 1E+6);
+    // 4) then the delay, but never ahead of the packet in front
+    struct timeval deadline = seconds_to_timeval(tx_end + link_sample_delay(params));
+    if (timercmp(&deadline, &link->last_deadline, <)) {
+        deadline = link->last_deadline;
+    }
 
     struct packet_wrapper *wrapper = parcMemory_Allocate(sizeof(struct packet_wrapper));
     assertNotNull(wrapper, "parcMemory_Allocate(%zu) returned NULL", sizeof(struct packet_wrapper));
     wrapper->ingress_fd = conn->client_fd;
-    wrapper->pbuff = pbuff;
-    wrapper->pbuff_len = pbuff_len;
-
-    timeradd(&now, &delay_tv, &deadline);
-
+    wrapper->packet = packet_acquire(packet);
+    wrapper->tx_end = tx_end;
     wrapper->deadline = deadline;
-    bp->conns[i].last_deadline = deadline;
-    bp->conns[i].bytes_in_queue += pbuff_len;
 
-    bp->conns[i].count_in_queue++;
-    TAILQ_INSERT_TAIL(&bp->conns[i].output_queue, wrapper, list);
+    link->last_deadline = deadline;
+    link->bytes_in_queue += packet->length;
+    link->count_in_queue++;
+    TAILQ_INSERT_TAIL(&link->output_queue, wrapper, list);
+
+    link->backlog_bytes += packet->length;
+    if (link->backlog_head == NULL) {
+        link->backlog_head = wrapper;
+    }
 
     if (bp->chattyOutput) {
-        printf("%s queue %d fd %d count %d\n", __func__, i, bp->conns[i].client_fd, bp->conns[i].count_in_queue);
+        printf("%s queue %d fd %d count %d\n", __func__, i, link->client_fd, link->count_in_queue);
     }
 
     // if this is first item in queue, set a timer
-    if (bp->conns[i].count_in_queue == 1) {
-        set_timer(&bp->conns[i], delay_tv);
+    if (link->count_in_queue == 1) {
+        struct timeval now_tv;
+        struct timeval delay_tv;
+        gettimeofday(&now_tv, NULL);
+        if (timercmp(&deadline, &now_tv, >)) {
+            timersub(&deadline, &now_tv, &delay_tv);
+        } else {
+            timerclear(&delay_tv);
+        }
+        set_timer(link, delay_tv);
     }
 }
 
+/**
+ * The original single-rate emulation: exponential delay, a drop-tail queue and a constant rate on every link
+ */
 int
 bentpipe_Params(BentPipeState *bp, double loss_rate, unsigned buffer_bytes, double mean_sec_delay, double bytes_per_sec)
 {
+    BentPipeRateStep step = { .seconds = 1.0, .bytes_per_sec = bytes_per_sec };
+
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.loss_rate = loss_rate;
+    params.buffer_bytes = buffer_bytes;
+    params.delayDistribution = BentPipeDelay_Exponential;
+    params.mean_sec_delay = mean_sec_delay;
+    params.rateTrace = &step;
+    params.rateTraceLength = 1;
+
+    return bentpipe_SetLinkParams(bp, -1, &params);
+}
+
+void
+bentpipe_LinkParamsInit(BentPipeLinkParams *params)
+{
+    assertNotNull(params, "Parameter params must be non-null");
+    memset(params, 0, sizeof(BentPipeLinkParams));
+    params->delayDistribution = BentPipeDelay_Constant;
+    params->queueDiscipline = BentPipeQueue_DropTail;
+    params->buffer_bytes = UINT_MAX;
+    params->red_max_p = 0.1;
+    params->red_weight = 0.002;
+}
+
+static bool
+link_params_valid(const BentPipeLinkParams *params)
+{
+    if (params->loss_rate < 0 || params->loss_rate > 1) {
+        return false;
+    }
+    for (size_t i = 0; i < params->rateTraceLength; i++) {
+        if (params->rateTrace[i].seconds <= 0 || params->rateTrace[i].bytes_per_sec < 0) {
+            return false;
+        }
+    }
+    if (params->queueDiscipline == BentPipeQueue_RED) {
+        if (params->red_min_bytes >= params->red_max_bytes || params->red_weight <= 0 || params->red_weight > 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+set_link_params(struct bentpipe_conn *link, const BentPipeLinkParams *params)
+{
+    if (link->params.rateTrace != NULL) {
+        parcMemory_Deallocate((void **) &link->params.rateTrace);
+    }
+
+    link->params = *params;
+    link->params.rateTrace = NULL;
+    link->trace_cycle_sec = 0;
+
+    if (params->rateTraceLength > 0) {
+        size_t length = sizeof(BentPipeRateStep) * params->rateTraceLength;
+        BentPipeRateStep *trace = parcMemory_Allocate(length);
+        assertNotNull(trace, "parcMemory_Allocate(%zu) returned NULL", length);
+        memcpy(trace, params->rateTrace, length);
+        link->params.rateTrace = trace;
+
+        for (size_t i = 0; i < params->rateTraceLength; i++) {
+            link->trace_cycle_sec += trace[i].seconds;
+        }
+    }
+}
+
+int
+bentpipe_SetLinkParams(BentPipeState *bp, int connection, const BentPipeLinkParams *params)
+{
+    assertNotNull(bp, "Parameter bp must be non-null");
+    assertNotNull(params, "Parameter params must be non-null");
+
+    if (connection < -1 || connection >= MAX_CONN || !link_params_valid(params)) {
+        return -1;
+    }
+
+    // a trace of all outages would never send anything
+    double capacity = (params->rateTraceLength > 0) ? 0 : 1;
+    for (size_t i = 0; i < params->rateTraceLength; i++) {
+        capacity += params->rateTrace[i].bytes_per_sec;
+    }
+    if (capacity <= 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < MAX_CONN; i++) {
+        if (connection == -1 || connection == i) {
+            set_link_params(&bp->conns[i], params);
+        }
+    }
+
     bp->use_params = true;
-    bp->loss_rate = loss_rate;
-    bp->buffer_bytes = buffer_bytes;
-    bp->mean_sec_delay = mean_sec_delay;
-    bp->bytes_per_sec = bytes_per_sec;
     return 0;
 }
 
+void
+bentpipe_GetLinkStats(const BentPipeState *bp, int connection, BentPipeLinkStats *stats)
+{
+    assertNotNull(bp, "Parameter bp must be non-null");
+    assertNotNull(stats, "Parameter stats must be non-null");
+    assertTrue(connection >= -1 && connection < MAX_CONN, "Invalid connection %d", connection);
+
+    memset(stats, 0, sizeof(BentPipeLinkStats));
+    for (int i = 0; i < MAX_CONN; i++) {
+        if (connection == -1 || connection == i) {
+            const BentPipeLinkStats *link = &bp->conns[i].stats;
+            stats->packetsIn += link->packetsIn;
+            stats->packetsOut += link->packetsOut;
+            stats->bytesOut += link->bytesOut;
+            stats->lossDrops += link->lossDrops;
+            stats->queueDrops += link->queueDrops;
+            stats->redDrops += link->redDrops;
+        }
+    }
+}
+
+BentPipeRateStep *
+bentpipe_ReadRateTrace(const char *filename, size_t *lengthOut)
+{
+    assertNotNull(filename, "Parameter filename must be non-null");
+    assertNotNull(lengthOut, "Parameter lengthOut must be non-null");
+
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    size_t capacity = 64;
+    size_t length = 0;
+    BentPipeRateStep *trace = parcMemory_Allocate(sizeof(BentPipeRateStep) * capacity);
+    assertNotNull(trace, "parcMemory_Allocate returned NULL");
+
+    char line[256];
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '#' || *p == '\n' || *p == '\0') {
+            continue;
+        }
+
+        BentPipeRateStep step;
+        if (sscanf(p, "%lf %lf", &step.seconds, &step.bytes_per_sec) != 2 || step.seconds <= 0 || step.bytes_per_sec < 0) {
+            valid = false;
+            break;
+        }
+
+        if (length == capacity) {
+            BentPipeRateStep *larger = parcMemory_Allocate(sizeof(BentPipeRateStep) * capacity * 2);
+            assertNotNull(larger, "parcMemory_Allocate returned NULL");
+            memcpy(larger, trace, sizeof(BentPipeRateStep) * length);
+            parcMemory_Deallocate((void **) &trace);
+            trace = larger;
+            capacity *= 2;
+        }
+        trace[length++] = step;
+    }
+    fclose(file);
+
+    if (!valid || length == 0) {
+        parcMemory_Deallocate((void **) &trace);
+        return NULL;
+    }
+
+    *lengthOut = length;
+    return trace;
+}
+
 static
 void
 keepalive_cb(int fd, PARCEventType what, void *user_data)
@@ -770,20 +1188,30 @@ timer_cb(int fd, PARCEventType what, void *user_data)
             break;
         }
 
-        conn->bytes_in_queue -= wrapper->pbuff_len;
+        conn->bytes_in_queue -= wrapper->packet->length;
         conn->count_in_queue--;
 
-        res = parcEventQueue_Write(conn->bev, wrapper->pbuff, wrapper->pbuff_len);
+        // the delivery deadline is never before the end of sending, so it is
+        // always at the head of the backlog if it is still in it
+        if (conn->backlog_head == wrapper) {
+            conn->backlog_bytes -= wrapper->packet->length;
+            conn->backlog_head = TAILQ_NEXT(wrapper, list);
+        }
+
+        res = parcEventQueue_Write(conn->bev, wrapper->packet->bytes, wrapper->packet->length);
         assertTrue(res == 0, "got parcEventQueue_Write error\n");
 
+        conn->stats.packetsOut++;
+        conn->stats.bytesOut += wrapper->packet->length;
+
         if (bp->chattyOutput) {
             printf("%3.9f output conn %d bytes %zu\n",
-                   now.tv_sec + now.tv_usec * 1E-6, conn->client_fd, wrapper->pbuff_len);
+                   now.tv_sec + now.tv_usec * 1E-6, conn->client_fd, wrapper->packet->length);
         }
 
         TAILQ_REMOVE(&conn->output_queue, wrapper, list);
 
-        parcMemory_Deallocate((void **) &(wrapper->pbuff));
+        packet_release(&wrapper->packet);
         parcMemory_Deallocate((void **) &wrapper);
     }
 
@@ -817,14 +1245,14 @@ set_timer(struct bentpipe_conn *conn, struct timeval delay)
     BentPipeState *bp = conn->parent;
     // this replaces any prior events
 
-    if (delay.tv_usec < 1000) {
-        delay.tv_usec = 1000;
-    }
-
     if (delay.tv_sec < 0) {
         delay.tv_sec = 0;
     }
 
+    if (delay.tv_sec == 0 && delay.tv_usec < 1000) {
+        delay.tv_usec = 1000;
+    }
+
     if (bp->chattyOutput) {
         printf("%s connid %d delay %.6f timer_event %p\n",
                __func__,
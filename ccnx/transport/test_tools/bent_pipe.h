@@ -36,6 +36,11 @@
  * We capture SIG_PIPE when doing a write so this test code does not
  * trigger a process-wide SIG_PIPE.  Unless we have SO_SIGPIPE, then we'll use that.
  *
+ * Each client has a link from the pipe to it, which can emulate a bottleneck for testing
+ * flow control: random loss, a bandwidth that follows a trace, a delay drawn from a
+ * distribution, and a drop-tail or RED queue.  Clients take connection slots in accept order,
+ * lowest free slot first, so with two clients link 0 and link 1 are the two directions.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
@@ -43,6 +48,8 @@
 #define Libccnx_bent_pipe_h
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 struct bentpipe_state;
 /**
@@ -158,4 +165,112 @@ void bentpipe_SetChattyOutput(BentPipeState *bp, bool chattyOutput);
  * @see <#references#>
  */
 int bentpipe_Params(BentPipeState *bp, double loss_rate, unsigned buffer_bytes, double mean_sec_delay, double bytes_per_sec);
+
+/**
+ * How the per-packet delay of a link is drawn.  Delay is added after the packet
+ * is sent at the link rate.  Packets on a link are never reordered.
+ */
+typedef enum {
+    BentPipeDelay_Constant,     // always mean_sec_delay
+    BentPipeDelay_Uniform,      // mean_sec_delay +/- delay_sec_parameter
+    BentPipeDelay_Exponential,  // exponential with mean mean_sec_delay
+    BentPipeDelay_Normal        // normal with mean mean_sec_delay and std deviation delay_sec_parameter
+} BentPipeDelayDistribution;
+
+typedef enum {
+    BentPipeQueue_DropTail,     // drop when the backlog would exceed buffer_bytes
+    BentPipeQueue_RED           // Random Early Detection on the average backlog, then drop-tail
+} BentPipeQueueDiscipline;
+
+/**
+ * One step of a bandwidth trace.  A trace is a list of steps that repeats.
+ */
+typedef struct bentpipe_rate_step {
+    double seconds;
+    double bytes_per_sec;       // 0 is an outage
+} BentPipeRateStep;
+
+typedef struct bentpipe_link_params {
+    double loss_rate;
+
+    // If rateTraceLength is 0 the link is not rate limited
+    const BentPipeRateStep *rateTrace;
+    size_t rateTraceLength;
+
+    BentPipeDelayDistribution delayDistribution;
+    double mean_sec_delay;
+    double delay_sec_parameter;
+
+    BentPipeQueueDiscipline queueDiscipline;
+    unsigned buffer_bytes;
+
+    // RED thresholds on the average backlog, maximum drop probability and averaging weight
+    unsigned red_min_bytes;
+    unsigned red_max_bytes;
+    double red_max_p;
+    double red_weight;
+} BentPipeLinkParams;
+
+typedef struct bentpipe_link_stats {
+    uint64_t packetsIn;
+    uint64_t packetsOut;
+    uint64_t bytesOut;
+    uint64_t lossDrops;
+    uint64_t queueDrops;
+    uint64_t redDrops;
+} BentPipeLinkStats;
+
+/**
+ * Fills in a link that does nothing: no loss, no rate limit, no delay, an unlimited drop-tail queue
+ *
+ * Example:
+ * @code
+ * {
+ *     BentPipeRateStep trace[] = { { 1.0, 125000 }, { 0.5, 12500 } };
+ *     BentPipeLinkParams params;
+ *     bentpipe_LinkParamsInit(&params);
+ *     params.rateTrace = trace;
+ *     params.rateTraceLength = 2;
+ *     params.delayDistribution = BentPipeDelay_Normal;
+ *     params.mean_sec_delay = 0.020;
+ *     params.delay_sec_parameter = 0.005;
+ *     params.buffer_bytes = 64000;
+ *     bentpipe_SetLinkParams(bp, -1, &params);
+ * }
+ * @endcode
+ */
+void bentpipe_LinkParamsInit(BentPipeLinkParams *params);
+
+/**
+ * Sets the emulation of the link to the client in a connection slot
+ *
+ * Call before bentpipe_Start().  The rate trace is copied.
+ *
+ * @param [in] bp The bent pipe
+ * @param [in] connection The connection slot, or -1 for all of them
+ * @param [in] params The link
+ *
+ * @return 0 on success, -1 if the connection or params are invalid
+ */
+int bentpipe_SetLinkParams(BentPipeState *bp, int connection, const BentPipeLinkParams *params);
+
+/**
+ * The counters of the link to a connection slot, or the sum of all links for -1
+ *
+ * Only consistent once the pipe is stopped.
+ */
+void bentpipe_GetLinkStats(const BentPipeState *bp, int connection, BentPipeLinkStats *stats);
+
+/**
+ * Reads a bandwidth trace from a file
+ *
+ * Each line is "<seconds> <bytes_per_sec>".  Blank lines and lines starting with '#' are skipped.
+ *
+ * @param [in] filename The trace file
+ * @param [out] lengthOut The number of steps
+ *
+ * @return non-null The steps, release with parcMemory_Deallocate()
+ * @return null The file could not be read or has no valid steps
+ */
+BentPipeRateStep *bentpipe_ReadRateTrace(const char *filename, size_t *lengthOut);
 #endif // Libccnx_bent_pipe_h
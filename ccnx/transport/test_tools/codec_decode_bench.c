@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Decode throughput of received packets, fully decoded or lazily decoded (codec_TlvIndex.h).
+ *
+ * Runs over the V1 truth-set packets that write_packets.c dumps.  For each packet it times
+ *
+ *   full      ccnxCodecTlvPacket_BufferDecode(), what the TLV codec does by default
+ *   lazy      codecTlvIndex_LazyDecode() only, the cost of a packet dropped before anyone reads it
+ *   complete  codecTlvIndex_LazyDecode() then transportMessage_CompleteDecode()
+ *
+ *     codec_decode_bench [-n iterations]
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_testrig_truthSet.h>
+
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/components/codec_TlvIndex.h>
+
+typedef enum {
+    DecodeMode_Full,
+    DecodeMode_Lazy,
+    DecodeMode_Complete
+} DecodeMode;
+
+typedef struct decode_totals {
+    unsigned packets;
+    double usec[3];
+} DecodeTotals;
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  codec_decode_bench [-n iterations]\n");
+    printf("\n");
+    printf("  -n iterations  Decodes of each packet per mode (default 10000)\n");
+    printf("\n");
+}
+
+static double
+elapsedUsec(struct timeval *start, struct timeval *stop)
+{
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return delta.tv_sec * 1E+6 + delta.tv_usec;
+}
+
+static TransportMessage *
+createReceivedMessage(PARCBuffer *wireFormat)
+{
+    TransportMessage *tm = NULL;
+    CCNxWireFormatMessage *message = ccnxWireFormatMessage_Create(wireFormat);
+    if (message != NULL) {
+        tm = transportMessage_CreateFromDictionary(ccnxWireFormatMessage_GetDictionary(message));
+        ccnxWireFormatMessage_Release(&message);
+    }
+    return tm;
+}
+
+/**
+ * Decode the packet once in the given mode, as the codec would on receipt
+ */
+static bool
+decodeOnce(PARCBuffer *wireFormat, DecodeMode mode)
+{
+    TransportMessage *tm = createReceivedMessage(wireFormat);
+    if (tm == NULL) {
+        return false;
+    }
+
+    bool success;
+    switch (mode) {
+        case DecodeMode_Full:
+            success = ccnxCodecTlvPacket_BufferDecode(wireFormat, transportMessage_GetDictionary(tm));
+            break;
+        case DecodeMode_Lazy:
+            success = codecTlvIndex_LazyDecode(tm);
+            break;
+        case DecodeMode_Complete:
+            success = codecTlvIndex_LazyDecode(tm) && transportMessage_CompleteDecode(tm);
+            break;
+        default:
+            success = false;
+            break;
+    }
+
+    transportMessage_Destroy(&tm);
+    return success;
+}
+
+/**
+ * Returns the mean microseconds per decode
+ */
+static double
+timeMode(PARCBuffer *wireFormat, DecodeMode mode, unsigned iterations)
+{
+    struct timeval startTime;
+    struct timeval stopTime;
+
+    gettimeofday(&startTime, NULL);
+    for (unsigned i = 0; i < iterations; i++) {
+        decodeOnce(wireFormat, mode);
+    }
+    gettimeofday(&stopTime, NULL);
+
+    return elapsedUsec(&startTime, &stopTime) / iterations;
+}
+
+static void
+benchTruthTable(TruthTable truthset[], unsigned iterations, DecodeTotals *totals)
+{
+    for (int i = 0; truthset[i].packet != NULL; i++) {
+        PARCBuffer *wireFormat = parcBuffer_Wrap(truthset[i].packet, truthset[i].length, 0, truthset[i].length);
+
+        // the truth sets include packets that are supposed to fail
+        if (decodeOnce(wireFormat, DecodeMode_Full)) {
+            double usec[3];
+            for (DecodeMode mode = DecodeMode_Full; mode <= DecodeMode_Complete; mode++) {
+                usec[mode] = timeMode(wireFormat, mode, iterations);
+                totals->usec[mode] += usec[mode];
+            }
+            totals->packets++;
+
+            printf("%-40s %5zu %10.3f %10.3f %10.3f\n",
+                   truthset[i].testname, truthset[i].length,
+                   usec[DecodeMode_Full], usec[DecodeMode_Lazy], usec[DecodeMode_Complete]);
+        }
+
+        parcBuffer_Release(&wireFormat);
+    }
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    unsigned iterations = 10000;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:h")) != -1) {
+        switch (c) {
+            case 'n':
+                iterations = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (iterations == 0) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    DecodeTotals totals = { 0 };
+
+    printf("%-40s %5s %10s %10s %10s   (usec per packet)\n", "packet", "bytes", "full", "lazy", "complete");
+    benchTruthTable(v1_interests_truthSet, iterations, &totals);
+    benchTruthTable(v1_contentObject_truthSet, iterations, &totals);
+    benchTruthTable(v1_cpi_truthSet, iterations, &totals);
+
+    if (totals.packets > 0) {
+        printf("\n%u packets, packets/sec: full %.0f lazy %.0f complete %.0f\n",
+               totals.packets,
+               totals.packets * 1E+6 / totals.usec[DecodeMode_Full],
+               totals.packets * 1E+6 / totals.usec[DecodeMode_Lazy],
+               totals.packets * 1E+6 / totals.usec[DecodeMode_Complete]);
+    }
+    return 0;
+}
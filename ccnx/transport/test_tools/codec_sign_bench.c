@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Publisher throughput of the TLV codec, signing each Content Object or signing them in
+ * Merkle batches.
+ *
+ * Pushes Content Objects down a mock stack {TESTING_UPPER, TLV_CODEC, TESTING_LOWER}
+ * and counts how many per second come out the bottom encoded and signed.  The first run
+ * signs every object, the second signs a Merkle root per batch, and the optional third
+ * adds signing workers to the per-object run.
+ *
+ *     codec_sign_bench [-n count] [-b batchSize] [-w workers] [-k keyBits]
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_PublicKeySignerPkcs12Store.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+
+#include "../transport_rta/components/test/testrig_MockFramework.c"
+
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/components/component_Codec.h>
+
+// at most this many objects in the stack at once, so the event queues stay small
+#define BENCH_WINDOW 1024
+
+typedef struct codec_sign_bench {
+    unsigned count;
+    unsigned batchSize;
+    unsigned workers;
+    unsigned keyBits;
+
+    char keystoreName[MAXPATH];
+    const char *keystorePassword;
+} CodecSignBench;
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  codec_sign_bench [-n count] [-b batchSize] [-w workers] [-k keyBits]\n");
+    printf("\n");
+    printf("  -n count     Content Objects per run (default 10000)\n");
+    printf("  -b batchSize Content Objects per Merkle root in the batched run (default 256)\n");
+    printf("  -w workers   Also run per-object signing with this many signing workers (default 0, skip)\n");
+    printf("  -k keyBits   RSA key size (default 2048)\n");
+    printf("\n");
+}
+
+static CodecSignBench
+parseCommandLine(int argc, char *argv[argc])
+{
+    CodecSignBench bench;
+    memset(&bench, 0, sizeof(CodecSignBench));
+    bench.count = 10000;
+    bench.batchSize = 256;
+    bench.keyBits = 2048;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:b:w:k:h")) != -1) {
+        switch (c) {
+            case 'n':
+                bench.count = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'b':
+                bench.batchSize = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'w':
+                bench.workers = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'k':
+                bench.keyBits = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    return bench;
+}
+
+// ======================================================================
+
+static CCNxTransportConfig *
+createParams(CodecSignBench *bench, unsigned batchSize, unsigned workers)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingUpper_ProtocolStackConfig(stackConfig);
+    tlvCodec_ProtocolStackConfig(stackConfig);
+    if (workers > 0) {
+        tlvCodec_SetSigningWorkers(stackConfig, workers);
+    }
+    if (batchSize > 0) {
+        tlvCodec_SetBatchSigning(stackConfig, batchSize, 1, true);
+    }
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), tlvCodec_GetName(), testingLower_GetName(), NULL);
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    testingUpper_ConnectionConfig(connConfig);
+    tlvCodec_ConnectionConfig(connConfig);
+    testingLower_ConnectionConfig(connConfig);
+    publicKeySignerPkcs12Store_ConnectionConfig(connConfig, bench->keystoreName, bench->keystorePassword);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+static TransportMessage *
+createContentObject(MockFramework *mock, PARCBuffer *payload, unsigned segment)
+{
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/bench/file/chunk=%u", segment);
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(mock->connection), rtaConnection_FreeFunc);
+
+    ccnxContentObject_Release(&contentObject);
+    ccnxName_Release(&name);
+    return tm;
+}
+
+static double
+elapsedSeconds(struct timeval *start, struct timeval *stop)
+{
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return delta.tv_sec + delta.tv_usec * 1E-6;
+}
+
+/**
+ * Returns the objects per second
+ */
+static double
+run(CodecSignBench *bench, const char *label, unsigned batchSize, unsigned workers)
+{
+    CCNxTransportConfig *config = createParams(bench, batchSize, workers);
+    MockFramework *mock = mockFramework_Create(config);
+    ccnxTransportConfig_Destroy(&config);
+
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_LOWER, RTA_UP);
+
+    PARCBuffer *payload = parcBuffer_Allocate(1200);
+    parcBuffer_SetPosition(payload, parcBuffer_Limit(payload));
+    parcBuffer_Flip(payload);
+
+    struct timeval startTime;
+    struct timeval stopTime;
+    gettimeofday(&startTime, NULL);
+
+    unsigned sent = 0;
+    unsigned received = 0;
+    while (received < bench->count) {
+        while (sent < bench->count && sent - received < BENCH_WINDOW) {
+            rtaComponent_PutMessage(in, createContentObject(mock, payload, sent));
+            sent++;
+        }
+
+        rtaFramework_NonThreadedStepCount(mock->framework, 1);
+
+        TransportMessage *tm;
+        while ((tm = rtaComponent_GetMessage(out)) != NULL) {
+            transportMessage_Destroy(&tm);
+            received++;
+        }
+    }
+
+    gettimeofday(&stopTime, NULL);
+    double seconds = elapsedSeconds(&startTime, &stopTime);
+    double rate = bench->count / seconds;
+
+    const CodecSigningStats *stats = componentCodecTlv_GetSigningStats(mock->connection);
+    printf("%-24s %u objects in %.3f sec, %.0f objects/sec", label, bench->count, seconds, rate);
+    if (stats->batches > 0) {
+        printf(", %" PRIu64 " signatures", stats->batches);
+    }
+    if (stats->encoded > 0) {
+        printf(", mean sign %.1f usec", (double) stats->totalSignUsec / stats->encoded);
+    }
+    printf("\n");
+
+    parcBuffer_Release(&payload);
+    mockFramework_Destroy(&mock);
+    return rate;
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    CodecSignBench bench = parseCommandLine(argc, argv);
+
+    parcSecurity_Init();
+
+    snprintf(bench.keystoreName, MAXPATH, "/tmp/codec_sign_bench.p12.XXXXXX");
+    int fd = mkstemp(bench.keystoreName);
+    assertTrue(fd >= 0, "Could not create a temporary keystore name");
+    close(fd);
+    unlink(bench.keystoreName);
+    bench.keystorePassword = "bench";
+
+    bool success = parcPublicKeySignerPkcs12Store_CreateFile(bench.keystoreName, bench.keystorePassword, "bench", bench.keyBits, 30);
+    assertTrue(success, "parcPublicKeySignerPkcs12Store_CreateFile() failed.");
+
+    printf("RSA-%u, %u byte payloads\n", bench.keyBits, 1200);
+
+    double perObject = run(&bench, "per-object", 0, 0);
+
+    char label[64];
+    snprintf(label, sizeof(label), "batch %u", bench.batchSize);
+    double batched = run(&bench, label, bench.batchSize, 0);
+
+    if (bench.workers > 0) {
+        snprintf(label, sizeof(label), "per-object %u workers", bench.workers);
+        run(&bench, label, 0, bench.workers);
+    }
+
+    printf("batched / per-object = %.1fx\n", batched / perObject);
+
+    unlink(bench.keystoreName);
+    parcSecurity_Fini();
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Cost of the structural check on received packets (codec_Validator.h) next to the decoders.
+ *
+ * Runs over the V1 truth-set packets that write_packets.c dumps.  For each packet it times
+ *
+ *   validate  codecValidator_Validate(), what the Metis connector does to every packet it reads
+ *   index     codecTlvIndex_Create(), the lazy decoder's walk
+ *   full      ccnxCodecTlvPacket_BufferDecode(), the full decode
+ *
+ * It also reports any truth-set packet the validator rejects that the full decoder accepts,
+ * which would be a validator bug.
+ *
+ *     codec_validate_bench [-n iterations]
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_testrig_truthSet.h>
+
+#include <ccnx/transport/transport_rta/components/codec_Validator.h>
+#include <ccnx/transport/transport_rta/components/codec_TlvIndex.h>
+
+typedef enum {
+    CheckMode_Validate,
+    CheckMode_Index,
+    CheckMode_Full
+} CheckMode;
+
+typedef struct check_totals {
+    unsigned packets;
+    unsigned falseRejects;
+    double usec[3];
+} CheckTotals;
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  codec_validate_bench [-n iterations]\n");
+    printf("\n");
+    printf("  -n iterations  Checks of each packet per mode (default 100000)\n");
+    printf("\n");
+}
+
+static double
+elapsedUsec(struct timeval *start, struct timeval *stop)
+{
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return delta.tv_sec * 1E+6 + delta.tv_usec;
+}
+
+static bool
+fullDecode(PARCBuffer *wireFormat)
+{
+    bool success = false;
+    CCNxWireFormatMessage *message = ccnxWireFormatMessage_Create(wireFormat);
+    if (message != NULL) {
+        success = ccnxCodecTlvPacket_BufferDecode(wireFormat, ccnxWireFormatMessage_GetDictionary(message));
+        ccnxWireFormatMessage_Release(&message);
+    }
+    return success;
+}
+
+static bool
+checkOnce(PARCBuffer *wireFormat, CheckMode mode)
+{
+    bool success;
+    switch (mode) {
+        case CheckMode_Validate:
+            success = codecValidator_Validate(parcBuffer_Overlay(wireFormat, 0), parcBuffer_Remaining(wireFormat)) == CodecValidatorResult_Ok;
+            break;
+        case CheckMode_Index: {
+            CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+            success = (index != NULL);
+            if (index != NULL) {
+                codecTlvIndex_Destroy(&index);
+            }
+            break;
+        }
+        case CheckMode_Full:
+            success = fullDecode(wireFormat);
+            break;
+        default:
+            success = false;
+            break;
+    }
+    return success;
+}
+
+/**
+ * Returns the mean microseconds per check
+ */
+static double
+timeMode(PARCBuffer *wireFormat, CheckMode mode, unsigned iterations)
+{
+    struct timeval startTime;
+    struct timeval stopTime;
+
+    gettimeofday(&startTime, NULL);
+    for (unsigned i = 0; i < iterations; i++) {
+        checkOnce(wireFormat, mode);
+    }
+    gettimeofday(&stopTime, NULL);
+
+    return elapsedUsec(&startTime, &stopTime) / iterations;
+}
+
+static void
+benchTruthTable(TruthTable truthset[], unsigned iterations, CheckTotals *totals)
+{
+    for (int i = 0; truthset[i].packet != NULL; i++) {
+        PARCBuffer *wireFormat = parcBuffer_Wrap(truthset[i].packet, truthset[i].length, 0, truthset[i].length);
+
+        // the truth sets include packets that are supposed to fail
+        if (checkOnce(wireFormat, CheckMode_Full)) {
+            if (!checkOnce(wireFormat, CheckMode_Validate)) {
+                totals->falseRejects++;
+                printf("%-40s %5zu rejected by validator but decodes\n", truthset[i].testname, truthset[i].length);
+            }
+
+            double usec[3];
+            for (CheckMode mode = CheckMode_Validate; mode <= CheckMode_Full; mode++) {
+                usec[mode] = timeMode(wireFormat, mode, iterations);
+                totals->usec[mode] += usec[mode];
+            }
+            totals->packets++;
+
+            printf("%-40s %5zu %10.3f %10.3f %10.3f\n",
+                   truthset[i].testname, truthset[i].length,
+                   usec[CheckMode_Validate], usec[CheckMode_Index], usec[CheckMode_Full]);
+        }
+
+        parcBuffer_Release(&wireFormat);
+    }
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    unsigned iterations = 100000;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:h")) != -1) {
+        switch (c) {
+            case 'n':
+                iterations = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (iterations == 0) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    CheckTotals totals = { 0 };
+
+    printf("%-40s %5s %10s %10s %10s   (usec per packet)\n", "packet", "bytes", "validate", "index", "full");
+    benchTruthTable(v1_interests_truthSet, iterations, &totals);
+    benchTruthTable(v1_contentObject_truthSet, iterations, &totals);
+    benchTruthTable(v1_cpi_truthSet, iterations, &totals);
+
+    if (totals.packets > 0) {
+        printf("\n%u packets, packets/sec: validate %.0f index %.0f full %.0f\n",
+               totals.packets,
+               totals.packets * 1E+6 / totals.usec[CheckMode_Validate],
+               totals.packets * 1E+6 / totals.usec[CheckMode_Index],
+               totals.packets * 1E+6 / totals.usec[CheckMode_Full]);
+    }
+    if (totals.falseRejects > 0) {
+        printf("%u packets rejected by the validator decode fully\n", totals.falseRejects);
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Memory and time to read a large route list response (a forwarder FIB dump), whole or with cpi_ListReader.h.
+ *
+ * Synthesizes a route list response of the given size, then reads every route in one mode
+ *
+ *   full    parcJSON_ParseString() then cpiForwarding_RouteListFromControlMessage(), what the tools do today
+ *   tree    parcJSON_ParseString() then a cpiListReader over the control message
+ *   text    cpiListReader_CreateRouteReaderFromText() over the response text
+ *   binary  cpiListReader over a cpi_Binary.h route list response
+ *
+ * Peak RSS is per process, so run one mode per invocation to compare memory.
+ *
+ *     cpi_list_bench [-n routes] [-m full|tree|text|binary]
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <parc/algol/parc_BufferComposer.h>
+#include <parc/algol/parc_JSON.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/api/control/controlPlaneInterface.h>
+#include <ccnx/api/control/cpi_Binary.h>
+#include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Forwarding.h>
+#include <ccnx/api/control/cpi_ListReader.h>
+#include <ccnx/api/control/cpi_RouteEntryList.h>
+
+typedef enum {
+    ListMode_Full,
+    ListMode_Tree,
+    ListMode_Text,
+    ListMode_Binary
+} ListMode;
+
+static const char *listModeNames[] = { "full", "tree", "text", "binary" };
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  cpi_list_bench [-n routes] [-m full|tree|text|binary]\n");
+    printf("\n");
+    printf("  -n routes  Routes in the synthetic response (default 1000000)\n");
+    printf("  -m mode    How to read the response (default text)\n");
+    printf("\n");
+}
+
+static double
+elapsedUsec(struct timeval *start, struct timeval *stop)
+{
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return delta.tv_sec * 1E+6 + delta.tv_usec;
+}
+
+/**
+ * Peak resident set of this process in KiB (bytes on Darwin)
+ */
+static long
+maxResident(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static CPIRouteEntry *
+createRoute(size_t index)
+{
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/bench/fib/%zu/route", index);
+    struct timeval lifetime = { 3600, 0 };
+    return cpiRouteEntry_Create(ccnxName_CreateFromURI(uri), (unsigned) (index % 64) + 1, NULL,
+                                cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, &lifetime, 1);
+}
+
+/**
+ * The response text, built one route at a time so the setup never holds the whole list
+ */
+static PARCBuffer *
+createResponseText(size_t routes)
+{
+    PARCBufferComposer *composer = parcBufferComposer_Create();
+    parcBufferComposer_Format(composer, "{\"%s\":{\"SEQUENCE\":1,\"%s\":{\"%s\":[",
+                              cpiResponse_GetJsonTag(), cpiForwarding_RouteListJsonTag(), cpiRouteEntryList_JsonTag());
+
+    for (size_t i = 0; i < routes; i++) {
+        CPIRouteEntry *route = createRoute(i);
+        PARCJSON *json = cpiRouteEntry_ToJson(route);
+        char *string = parcJSON_ToCompactString(json);
+        if (i > 0) {
+            parcBufferComposer_PutChar(composer, ',');
+        }
+        parcBufferComposer_PutString(composer, string);
+        parcMemory_Deallocate((void **) &string);
+        parcJSON_Release(&json);
+        cpiRouteEntry_Destroy(&route);
+    }
+
+    parcBufferComposer_PutString(composer, "]}}}");
+    PARCBuffer *text = parcBufferComposer_ProduceBuffer(composer);
+    parcBufferComposer_Release(&composer);
+    return text;
+}
+
+static PARCBuffer *
+createResponseBinary(size_t routes)
+{
+    CPIRouteEntryList *list = cpiRouteEntryList_Create();
+    for (size_t i = 0; i < routes; i++) {
+        cpiRouteEntryList_Append(list, createRoute(i));
+    }
+
+    PARCBuffer *request = cpiBinary_CreateRequest(CPI_PREFIX_REGISTRATION_LIST, NULL);
+    CPIBinaryMessage message;
+    cpiBinary_Parse(request, &message);
+    PARCBuffer *response = cpiBinary_CreateRouteListResponse(&message, list);
+
+    parcBuffer_Release(&request);
+    cpiRouteEntryList_Destroy(&list);
+    return response;
+}
+
+static CCNxControl *
+parseResponseText(PARCBuffer *text)
+{
+    char *string = parcBuffer_ToString(text);
+    PARCJSON *json = parcJSON_ParseString(string);
+    parcMemory_Deallocate((void **) &string);
+
+    CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+    parcJSON_Release(&json);
+    return control;
+}
+
+static size_t
+drainReader(CPIListReader *reader)
+{
+    CPIRouteEntry *route;
+    while ((route = cpiListReader_NextRoute(reader)) != NULL) {
+        cpiRouteEntry_Destroy(&route);
+    }
+
+    if (cpiListReader_HasFailed(reader)) {
+        printf("route list is malformed after %zu routes\n", cpiListReader_GetCount(reader));
+    }
+    return cpiListReader_GetCount(reader);
+}
+
+/**
+ * Reads every route from the response and returns how many there were
+ */
+static size_t
+readRoutes(PARCBuffer *response, ListMode mode)
+{
+    size_t count = 0;
+    switch (mode) {
+        case ListMode_Full: {
+            CCNxControl *control = parseResponseText(response);
+            CPIRouteEntryList *list = cpiForwarding_RouteListFromControlMessage(control);
+            count = cpiRouteEntryList_Length(list);
+            cpiRouteEntryList_Destroy(&list);
+            ccnxControl_Release(&control);
+            break;
+        }
+
+        case ListMode_Tree: {
+            CCNxControl *control = parseResponseText(response);
+            CPIListReader *reader = cpiListReader_CreateRouteReader(control);
+            count = drainReader(reader);
+            cpiListReader_Destroy(&reader);
+            ccnxControl_Release(&control);
+            break;
+        }
+
+        case ListMode_Text: {
+            CPIListReader *reader = cpiListReader_CreateRouteReaderFromText(response);
+            count = drainReader(reader);
+            cpiListReader_Destroy(&reader);
+            break;
+        }
+
+        case ListMode_Binary: {
+            CCNxControl *control = ccnxControlFacade_CreateBinaryCPI(response);
+            CPIListReader *reader = cpiListReader_CreateRouteReader(control);
+            count = drainReader(reader);
+            cpiListReader_Destroy(&reader);
+            ccnxControl_Release(&control);
+            break;
+        }
+
+        default:
+            break;
+    }
+    return count;
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    size_t routes = 1000000;
+    ListMode mode = ListMode_Text;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:m:h")) != -1) {
+        switch (c) {
+            case 'n':
+                routes = (size_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'm': {
+                bool found = false;
+                for (ListMode m = ListMode_Full; m <= ListMode_Binary; m++) {
+                    if (strcmp(optarg, listModeNames[m]) == 0) {
+                        mode = m;
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (routes == 0) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    PARCBuffer *response = (mode == ListMode_Binary) ? createResponseBinary(routes) : createResponseText(routes);
+    long setupResident = maxResident();
+
+    struct timeval startTime;
+    struct timeval stopTime;
+
+    gettimeofday(&startTime, NULL);
+    size_t count = readRoutes(response, mode);
+    gettimeofday(&stopTime, NULL);
+
+    double usec = elapsedUsec(&startTime, &stopTime);
+    long peakResident = maxResident();
+
+    printf("%-8s %10s %10s %12s %12s %12s\n", "mode", "bytes", "routes", "sec", "routes/sec", "peak KiB");
+    printf("%-8s %10zu %10zu %12.3f %12.0f %12ld   (after setup %ld)\n",
+           listModeNames[mode], parcBuffer_Remaining(response), count,
+           usec / 1E+6, count * 1E+6 / usec, peakResident, setupResident);
+
+    parcBuffer_Release(&response);
+    return (count == routes) ? 0 : 1;
+}
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+
+#include <LongBow/runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/transport/transport_rta/connectors/forwarder_ShmLink.h>
+#include "metis_standin.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define STANDIN_MAX_CLIENTS 64
+#define STANDIN_BUFFER_BYTES (64 * 1024)
+
+typedef struct standin_client {
+    int fd;
+
+    // non-null with MetisTransport_SharedMemory
+    ForwarderShmLink *link;
+
+    // bytes read from the ring that did not fit in the other ring yet
+    uint8_t *pending;
+    size_t pendingLength;
+
+    uint8_t buffer[STANDIN_BUFFER_BYTES];
+} StandinClient;
+
+struct metis_standin {
+    MetisTransport transport;
+    uint16_t port;
+    char path[MAXPATHLEN];
+
+    int listenFd;
+
+    // the stop flag is written to it
+    int wakeFds[2];
+
+    pthread_t thread;
+    bool running;
+
+    StandinClient *clients[STANDIN_MAX_CLIENTS];
+    unsigned clientCount;
+
+    uint64_t bytesReflected;
+};
+
+static int
+_metisStandin_Listen(MetisStandin *standin)
+{
+    int fd;
+    if (standin->transport == MetisTransport_Tcp) {
+        fd = socket(PF_INET, SOCK_STREAM, 0);
+        assertTrue(fd >= 0, "socket failed: (%d) %s", errno, strerror(errno));
+
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        struct sockaddr_in addr_in;
+        memset(&addr_in, 0, sizeof(addr_in));
+        addr_in.sin_family = AF_INET;
+        addr_in.sin_port = htons(standin->port);
+        addr_in.sin_addr.s_addr = inet_addr("127.0.0.1");
+        assertTrue(bind(fd, (struct sockaddr *) &addr_in, sizeof(addr_in)) == 0,
+                   "bind port %u failed: (%d) %s", standin->port, errno, strerror(errno));
+
+        socklen_t length = sizeof(addr_in);
+        getsockname(fd, (struct sockaddr *) &addr_in, &length);
+        standin->port = ntohs(addr_in.sin_port);
+    } else {
+        fd = socket(PF_UNIX, SOCK_STREAM, 0);
+        assertTrue(fd >= 0, "socket failed: (%d) %s", errno, strerror(errno));
+
+        struct sockaddr_un addr_un;
+        memset(&addr_un, 0, sizeof(addr_un));
+        addr_un.sun_family = AF_UNIX;
+        trapIllegalValueIf(strlen(standin->path) >= sizeof(addr_un.sun_path), "Path too long: %s", standin->path);
+        strcpy(addr_un.sun_path, standin->path);
+
+        unlink(standin->path);
+        assertTrue(bind(fd, (struct sockaddr *) &addr_un, sizeof(addr_un)) == 0,
+                   "bind %s failed: (%d) %s", standin->path, errno, strerror(errno));
+    }
+
+    assertTrue(listen(fd, 16) == 0, "listen failed: (%d) %s", errno, strerror(errno));
+    return fd;
+}
+
+MetisStandin *
+metisStandin_Create(MetisTransport transport, uint16_t port, const char *path)
+{
+    MetisStandin *standin = parcMemory_AllocateAndClear(sizeof(MetisStandin));
+    assertNotNull(standin, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisStandin));
+
+    standin->transport = transport;
+    standin->port = port;
+    if (path != NULL) {
+        strncpy(standin->path, path, MAXPATHLEN - 1);
+    }
+    assertTrue(transport == MetisTransport_Tcp || path != NULL, "The PF_UNIX transports need a path");
+
+    standin->listenFd = _metisStandin_Listen(standin);
+    assertTrue(pipe(standin->wakeFds) == 0, "pipe failed: (%d) %s", errno, strerror(errno));
+
+    return standin;
+}
+
+static void
+_metisStandin_CloseClient(MetisStandin *standin, unsigned index)
+{
+    StandinClient *client = standin->clients[index];
+    if (client->link != NULL) {
+        forwarderShmLink_Destroy(&client->link);
+    }
+    close(client->fd);
+    parcMemory_Deallocate((void **) &client);
+
+    standin->clientCount--;
+    standin->clients[index] = standin->clients[standin->clientCount];
+    standin->clients[standin->clientCount] = NULL;
+}
+
+void
+metisStandin_Destroy(MetisStandin **standinPtr)
+{
+    MetisStandin *standin = *standinPtr;
+
+    if (standin->running) {
+        metisStandin_Stop(standin);
+    }
+
+    while (standin->clientCount > 0) {
+        _metisStandin_CloseClient(standin, standin->clientCount - 1);
+    }
+
+    close(standin->listenFd);
+    close(standin->wakeFds[0]);
+    close(standin->wakeFds[1]);
+    if (standin->transport != MetisTransport_Tcp) {
+        unlink(standin->path);
+    }
+
+    parcMemory_Deallocate((void **) &standin);
+    *standinPtr = NULL;
+}
+
+static void
+_metisStandin_Accept(MetisStandin *standin)
+{
+    int fd = accept(standin->listenFd, NULL, NULL);
+    if (fd < 0) {
+        return;
+    }
+
+    if (standin->clientCount == STANDIN_MAX_CLIENTS) {
+        close(fd);
+        return;
+    }
+
+#if defined(SO_NOSIGPIPE)
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    StandinClient *client = parcMemory_AllocateAndClear(sizeof(StandinClient));
+    assertNotNull(client, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(StandinClient));
+    client->fd = fd;
+
+    if (standin->transport == MetisTransport_SharedMemory) {
+        // the connector sends the hello as soon as it connects
+        client->link = forwarderShmLink_Accept(fd);
+        if (client->link == NULL) {
+            close(fd);
+            parcMemory_Deallocate((void **) &client);
+            return;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, NULL) | O_NONBLOCK);
+    }
+
+    standin->clients[standin->clientCount++] = client;
+}
+
+/**
+ * Sends back everything the client sent on its socket
+ *
+ * @return false The client closed its socket
+ */
+static bool
+_metisStandin_ReflectSocket(MetisStandin *standin, StandinClient *client)
+{
+    ssize_t nread = recv(client->fd, client->buffer, STANDIN_BUFFER_BYTES, 0);
+    if (nread <= 0) {
+        return false;
+    }
+
+    ssize_t offset = 0;
+    while (offset < nread) {
+        ssize_t nwritten = send(client->fd, client->buffer + offset, nread - offset, MSG_NOSIGNAL);
+        if (nwritten < 0) {
+            return false;
+        }
+        offset += nwritten;
+    }
+
+    standin->bytesReflected += nread;
+    return true;
+}
+
+/**
+ * Copies the client's ring to its other ring until one is empty or full
+ *
+ * @return false The client closed its socket
+ */
+static bool
+_metisStandin_ReflectShm(MetisStandin *standin, StandinClient *client)
+{
+    if (forwarderShmLink_DrainDoorbell(client->fd) < 0) {
+        return false;
+    }
+
+    while (true) {
+        if (client->pendingLength > 0) {
+            size_t nwritten = forwarderShmLink_Write(client->link, client->pending, client->pendingLength);
+            standin->bytesReflected += nwritten;
+            client->pending += nwritten;
+            client->pendingLength -= nwritten;
+            if (client->pendingLength > 0) {
+                // the ring is full and marked, the connector rings when it reads
+                break;
+            }
+        }
+
+        size_t nread = forwarderShmLink_Read(client->link, client->buffer, STANDIN_BUFFER_BYTES);
+        if (nread == 0) {
+            // the ring is empty and marked, the connector rings when it writes
+            break;
+        }
+        client->pending = client->buffer;
+        client->pendingLength = nread;
+    }
+
+    return forwarderShmLink_Notify(client->link, client->fd);
+}
+
+static void *
+_metisStandin_Run(void *arg)
+{
+    MetisStandin *standin = arg;
+    struct pollfd fds[STANDIN_MAX_CLIENTS + 2];
+
+    while (true) {
+        fds[0].fd = standin->wakeFds[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = standin->listenFd;
+        fds[1].events = POLLIN;
+        for (unsigned i = 0; i < standin->clientCount; i++) {
+            fds[i + 2].fd = standin->clients[i]->fd;
+            fds[i + 2].events = POLLIN;
+        }
+        unsigned clientCount = standin->clientCount;
+
+        int ready = poll(fds, clientCount + 2, -1);
+        if (ready < 0) {
+            assertTrue(errno == EINTR, "poll failed: (%d) %s", errno, strerror(errno));
+            continue;
+        }
+
+        if (fds[0].revents) {
+            break;
+        }
+
+        // walk backwards, closing a client moves the last one into its slot
+        for (unsigned i = clientCount; i > 0; i--) {
+            if (fds[i + 1].revents) {
+                StandinClient *client = standin->clients[i - 1];
+                bool open = (client->link != NULL) ? _metisStandin_ReflectShm(standin, client)
+                            : _metisStandin_ReflectSocket(standin, client);
+                if (!open) {
+                    _metisStandin_CloseClient(standin, i - 1);
+                }
+            }
+        }
+
+        if (fds[1].revents) {
+            _metisStandin_Accept(standin);
+        }
+    }
+
+    return NULL;
+}
+
+void
+metisStandin_Start(MetisStandin *standin)
+{
+    assertFalse(standin->running, "The stand-in is already running");
+    standin->running = true;
+    assertTrue(pthread_create(&standin->thread, NULL, _metisStandin_Run, standin) == 0, "pthread_create failed.");
+}
+
+void
+metisStandin_Stop(MetisStandin *standin)
+{
+    assertTrue(standin->running, "The stand-in is not running");
+
+    uint8_t stop = 1;
+    ssize_t nwritten = write(standin->wakeFds[1], &stop, 1);
+    assertTrue(nwritten == 1, "write to the wake pipe failed: (%d) %s", errno, strerror(errno));
+
+    pthread_join(standin->thread, NULL);
+    standin->running = false;
+}
+
+uint16_t
+metisStandin_GetPort(const MetisStandin *standin)
+{
+    return standin->port;
+}
+
+uint64_t
+metisStandin_GetBytesReflected(const MetisStandin *standin)
+{
+    return standin->bytesReflected;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file metis_standin.h
+ * @brief A stand-in for a co-located Metis, for benchmarking the Metis connector transports
+ *
+ * Listens on TCP, a PF_UNIX stream socket, or a PF_UNIX socket with shared memory rings
+ * (see forwarder_ShmLink.h), the three transports of `metisForwarder_SetTransport()`.
+ * Every byte a client sends is sent straight back to it, so each packet comes back up
+ * the connection that sent it.  It does not look at the packets and does not answer
+ * control messages.
+ *
+ * It runs in its own thread with a poll() loop.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_metis_standin_h
+#define Libccnx_metis_standin_h
+
+#include <stdint.h>
+#include <ccnx/transport/transport_rta/config/config_Forwarder_Metis.h>
+
+struct metis_standin;
+typedef struct metis_standin MetisStandin;
+
+/**
+ * Creates a stand-in and starts listening
+ *
+ * @param [in] transport The transport clients use
+ * @param [in] port For `MetisTransport_Tcp`, the port on 127.0.0.1.  0 picks a free port.
+ * @param [in] path For the PF_UNIX transports, the socket path.  It is unlinked first.
+ *
+ * @return non-null The stand-in, call `metisStandin_Start()` to serve clients
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisStandin *standin = metisStandin_Create(MetisTransport_Tcp, 0, NULL);
+ *     metisStandin_Start(standin);
+ *     metisForwarder_ConnectionConfig(connConfig, metisStandin_GetPort(standin));
+ *     // ...
+ *     metisStandin_Stop(standin);
+ *     metisStandin_Destroy(&standin);
+ * }
+ * @endcode
+ */
+MetisStandin *metisStandin_Create(MetisTransport transport, uint16_t port, const char *path);
+
+/**
+ * Stops the stand-in if running, closes its clients and listener
+ *
+ * @param [in,out] standinPtr The stand-in, NULL on return
+ */
+void metisStandin_Destroy(MetisStandin **standinPtr);
+
+/**
+ * Starts the stand-in's thread
+ */
+void metisStandin_Start(MetisStandin *standin);
+
+/**
+ * Stops the stand-in's thread and waits for it
+ */
+void metisStandin_Stop(MetisStandin *standin);
+
+/**
+ * The TCP port the stand-in listens on, useful after asking for port 0
+ */
+uint16_t metisStandin_GetPort(const MetisStandin *standin);
+
+/**
+ * The number of bytes sent back to clients, read it after `metisStandin_Stop()`
+ */
+uint64_t metisStandin_GetBytesReflected(const MetisStandin *standin);
+#endif // Libccnx_metis_standin_h
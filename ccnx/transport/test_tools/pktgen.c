@@ -27,25 +27,60 @@
 /**
  * Generate packets
  *
+ * A load generator and reflector for benchmarking the forwarder connectors without a forwarder.
+ * It runs as a pair over loopback: the replier listens where the forwarder would and writes every
+ * packet it reads back on the same connection; the sender connects, writes pre-encoded V1
+ * Interests or Content Objects at a target rate, and times each one until it comes back.
+ *
+ * Two framings are spoken:
+ *
+ *   metis  TCP, each frame a raw V1 packet sized by the PacketLength of its fixed header, as
+ *          between connector_Forwarder_Metis.c and Metis
+ *   local  PF_UNIX stream, each frame a 16-byte localhdr then the packet, as between
+ *          connector_Forwarder_Local.c and bent_pipe.c
+ *
+ * The replier can also stand in for the forwarder of an RTA stack, so a stack's connector can be
+ * loaded with its own traffic reflected.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
- * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ * @copyright 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
 
 #include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 
 #include <LongBow/runtime.h>
 
+#include <ccnx/common/codec/schema_v1/testdata/v1_interest_nameA.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_content_nameA_crc32c.h>
+
+// The largest V1 packet, plus a local header
+#define MAX_FRAME (64 * 1024 + 16)
+
+// The sender gives up waiting for replies after this long without one
+#define IDLE_TIMEOUT_USEC (2 * 1000000)
+
 typedef enum {
     MODE_SEND,
     MODE_REPLY
 } PktGenMode;
 
 typedef enum {
-    ENCAP_ETHER,
-    ENCAP_UDP
+    ENCAP_METIS,
+    ENCAP_LOCAL
 } PktGenEncap;
 
 typedef enum {
@@ -53,19 +88,62 @@ typedef enum {
     PKTGEN_STOPWAIT
 } PktGenFlow;
 
+typedef enum {
+    PACKET_INTEREST,
+    PACKET_OBJECT
+} PktGenPacket;
+
+/**
+ * The framing of connector_Forwarder_Local.c
+ */
+typedef struct {
+    uint32_t pid;
+    uint32_t fd;
+    uint32_t length;
+    uint32_t pad;     // pad out to 16 bytes
+} __attribute__ ((packed)) localhdr;
+
+/**
+ * Bytes read from a stream socket, consumed a frame at a time
+ */
+typedef struct {
+    uint8_t buffer[MAX_FRAME];
+    size_t length;
+} FrameReader;
+
 typedef struct {
     PktGenMode mode;
     PktGenEncap encap;
     PktGenFlow flow;
+    PktGenPacket packet;
+
+    // host name (metis send) or socket path (local)
+    char *address;
+    char *port;
 
-    char *ifname;
-    char *etherOrIp;
-    char *etherType;
     unsigned count;
 
+    // packets per second, 0 is as fast as the socket goes
+    unsigned rate;
+
+    // most packets outstanding at once in stream flow
+    unsigned window;
+
+    // the frame the sender writes
+    uint8_t frame[MAX_FRAME];
+    size_t frameLength;
+
     struct timeval startTime;
     struct timeval stopTime;
     unsigned packetCount;
+    unsigned replyCount;
+    uint64_t byteCount;
+
+    // the send time of each outstanding packet, by sequence number modulo window
+    struct timeval *sendTimes;
+
+    // one per reply
+    uint32_t *rttUsec;
 } PktGen;
 
 // ======================================================================
@@ -75,113 +153,555 @@ usage(void)
 {
     printf("usage: \n");
     printf("  This program functions as a requester and a responder.  They operate in a pair.\n");
-    printf("  The test can run over raw Ethernet encapsulation or over UDP\n");
-    printf("  The <count> parameter can be an integer or use a 'kmg' suffix for 1000, 1E+6, or 1E+9\n");
+    printf("  The test runs over TCP with Metis framing or over a PF_UNIX socket with local framing.\n");
+    printf("  The <count> and <rate> parameters can be an integer or use a 'kmg' suffix for 1000, 1E+6, or 1E+9\n");
     printf("\n");
-    printf("  pktgen send  ether <ifname> <dstmac> [ethertype] count <n> (stream | stopwait)\n");
-    printf("  pktgen reply ether <ifname> [count <n>]\n");
+    printf("  pktgen send  metis <host> <port> count <n> [interest | object] [rate <pps>] [window <n>] (stream | stopwait)\n");
+    printf("  pktgen reply metis <port> [count <n>]\n");
     printf("\n");
-    printf("  This mode sends either a stream or stop-and-wait request to an Ethernet peer\n");
-    printf("  pktgen send  udp <ifname> <dstip> <dstport> count <n> (stream | stopwait)\n");
-    printf("  pktgen reply udp <ifname> [count <n>]\n");
+    printf("  pktgen send  local <path> count <n> [interest | object] [rate <pps>] [window <n>] (stream | stopwait)\n");
+    printf("  pktgen reply local <path> [count <n>]\n");
     printf("\n");
-    printf("  Examples:\n");
-    printf("    This uses the standard Ethertype of 0x0801.  The replier will stay running forever.\n");
-    printf("       pktgen send  ether em1 bc:30:5b:f2:2f:60 count 1M stream\n");
-    printf("       pktgen reply ether em1\n");
+    printf("  The sender writes a pre-encoded Interest (default) or Content Object count times and measures\n");
+    printf("  the round trip time of each.  stream keeps up to window (default 1000) packets outstanding,\n");
+    printf("  stopwait one.  The replier reflects every packet; without a count it stays running forever.\n");
     printf("\n");
-    printf("    This uses a custom ethertype.  The replier will stay running forever.\n");
-    printf("       pktgen send  ether em1 bc:30:5b:f2:2f:60 0x9000 count 1M stream\n");
-    printf("       pktgen reply ether em1\n");
+    printf("  Examples:\n");
+    printf("    A million Interests at 100k packets per second over loopback TCP.\n");
+    printf("       pktgen reply metis 9695\n");
+    printf("       pktgen send  metis localhost 9695 count 1M rate 100k stream\n");
     printf("\n");
-    printf("    An example with UDP\n");
-    printf("       pktgen send  udp em1 10.1.0.2 9695 count 1M stopwait\n");
-    printf("       pktgen reply udp em1\n");
+    printf("    Stop-and-wait Content Objects over a PF_UNIX socket.\n");
+    printf("       pktgen reply local /tmp/pktgen\n");
+    printf("       pktgen send  local /tmp/pktgen count 10k object stopwait\n");
     printf("\n");
 }
 
-static PktGen
+static unsigned
+parseCount(const char *string)
+{
+    char *suffix;
+    double value = strtod(string, &suffix);
+
+    switch (*suffix) {
+        case 'k':
+        case 'K':
+            value *= 1E+3;
+            break;
+        case 'm':
+        case 'M':
+            value *= 1E+6;
+            break;
+        case 'g':
+        case 'G':
+            value *= 1E+9;
+            break;
+        case '\0':
+            break;
+        default:
+            printf("Invalid count '%s'\n", string);
+            exit(EXIT_FAILURE);
+    }
+
+    return (unsigned) value;
+}
+
+static void
+setFrame(PktGen *pktgen)
+{
+    const uint8_t *packet;
+    size_t length;
+
+    if (pktgen->packet == PACKET_INTEREST) {
+        packet = v1_interest_nameA;
+        length = sizeof(v1_interest_nameA);
+    } else {
+        packet = v1_content_nameA_crc32c;
+        length = sizeof(v1_content_nameA_crc32c);
+    }
+
+    size_t offset = 0;
+    if (pktgen->encap == ENCAP_LOCAL) {
+        localhdr header = {
+            .pid    = getpid(),
+            .fd     = 0,
+            .length = (uint32_t) length,
+            .pad    = 0,
+        };
+        memcpy(pktgen->frame, &header, sizeof(header));
+        offset = sizeof(header);
+    }
+
+    memcpy(pktgen->frame + offset, packet, length);
+    pktgen->frameLength = offset + length;
+}
+
+static PktGen *
 parseCommandLine(int argc, char *argv[argc])
 {
-    PktGen pktgen;
-    memset(&pktgen, 0, sizeof(PktGen));
+    PktGen *pktgen = calloc(1, sizeof(PktGen));
+    assertNotNull(pktgen, "calloc returned NULL");
+
+    pktgen->window = 1000;
+    pktgen->packet = PACKET_INTEREST;
+    pktgen->flow = PKTGEN_STREAM;
+
+    if (argc < 4) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (strcasecmp(argv[1], "send") == 0) {
+        pktgen->mode = MODE_SEND;
+    } else if (strcasecmp(argv[1], "reply") == 0) {
+        pktgen->mode = MODE_REPLY;
+    } else {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    int index = 2;
+    if (strcasecmp(argv[index], "metis") == 0) {
+        pktgen->encap = ENCAP_METIS;
+        index++;
+        if (pktgen->mode == MODE_SEND) {
+            if (argc < index + 2) {
+                usage();
+                exit(EXIT_FAILURE);
+            }
+            pktgen->address = argv[index++];
+        }
+        pktgen->port = argv[index++];
+    } else if (strcasecmp(argv[index], "local") == 0) {
+        pktgen->encap = ENCAP_LOCAL;
+        index++;
+        pktgen->address = argv[index++];
+    } else {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    while (index < argc) {
+        const char *keyword = argv[index++];
+        if (strcasecmp(keyword, "count") == 0 && index < argc) {
+            pktgen->count = parseCount(argv[index++]);
+        } else if (strcasecmp(keyword, "rate") == 0 && index < argc) {
+            pktgen->rate = parseCount(argv[index++]);
+        } else if (strcasecmp(keyword, "window") == 0 && index < argc) {
+            pktgen->window = parseCount(argv[index++]);
+        } else if (strcasecmp(keyword, "interest") == 0) {
+            pktgen->packet = PACKET_INTEREST;
+        } else if (strcasecmp(keyword, "object") == 0) {
+            pktgen->packet = PACKET_OBJECT;
+        } else if (strcasecmp(keyword, "stream") == 0) {
+            pktgen->flow = PKTGEN_STREAM;
+        } else if (strcasecmp(keyword, "stopwait") == 0) {
+            pktgen->flow = PKTGEN_STOPWAIT;
+        } else {
+            usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pktgen->mode == MODE_SEND && pktgen->count == 0) {
+        printf("The sender needs a count\n");
+        exit(EXIT_FAILURE);
+    }
 
-    usage();
+    if (pktgen->flow == PKTGEN_STOPWAIT || pktgen->window == 0) {
+        pktgen->window = 1;
+    }
 
+    setFrame(pktgen);
     return pktgen;
 }
 
 // ======================================================================
 
-static void
-generateEther(PktGen *pktgen)
+static uint64_t
+elapsedUsec(const struct timeval *start, const struct timeval *stop)
 {
-    printf("Generating %u ethernet interest messages\n", pktgen->count);
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return (uint64_t) delta.tv_sec * 1000000 + delta.tv_usec;
 }
 
 static void
-replyEther(PktGen *pktgen)
+writeFully(int fd, const uint8_t *bytes, size_t length)
 {
-    printf("replying up to %u ethernet content objects messages\n", pktgen->count);
+    while (length > 0) {
+        ssize_t nwritten = write(fd, bytes, length);
+        if (nwritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            trapUnrecoverableState("write error: (%d) %s", errno, strerror(errno));
+        }
+        bytes += nwritten;
+        length -= nwritten;
+    }
 }
 
-// ======================================================================
-
-static void
-generateUdp(PktGen *pktgen)
+/**
+ * The length of the frame starting at bytes, or 0 if it is not all there yet
+ */
+static size_t
+frameLength(const PktGen *pktgen, const uint8_t *bytes, size_t available)
 {
-    printf("Generating %u UDP interest messages\n", pktgen->count);
+    size_t length;
+
+    if (pktgen->encap == ENCAP_LOCAL) {
+        if (available < sizeof(localhdr)) {
+            return 0;
+        }
+        const localhdr *header = (const localhdr *) bytes;
+        length = sizeof(localhdr) + header->length;
+    } else {
+        // the fixed header's PacketLength
+        if (available < 8) {
+            return 0;
+        }
+        length = ((size_t) bytes[2] << 8) | bytes[3];
+        if (length < 8) {
+            trapUnrecoverableState("Framing error: packet length %zu", length);
+        }
+    }
+
+    if (length > MAX_FRAME) {
+        trapUnrecoverableState("Framing error: frame length %zu", length);
+    }
+
+    return (available >= length) ? length : 0;
 }
 
 static void
-replyUdp(PktGen *pktgen)
+consumeFrame(FrameReader *reader, size_t length)
 {
-    printf("replying up to %u UDP content objects messages\n", pktgen->count);
+    memmove(reader->buffer, reader->buffer + length, reader->length - length);
+    reader->length -= length;
 }
 
+/**
+ * Read what is available into the reader.
+ *
+ * @return false on end of file or error
+ */
+static bool
+fillReader(int fd, FrameReader *reader)
+{
+    ssize_t nread = read(fd, reader->buffer + reader->length, sizeof(reader->buffer) - reader->length);
+    if (nread < 0 && errno == EINTR) {
+        return true;
+    }
+    if (nread <= 0) {
+        return false;
+    }
+    reader->length += nread;
+    return true;
+}
 
 // ======================================================================
 
-static void
-displayStatistics(PktGen *pktgen)
+static int
+openMetis(PktGen *pktgen)
 {
-    printf("stats.... coming soon\n");
+    struct addrinfo hints = {
+        .ai_family   = AF_UNSPEC,
+        .ai_socktype = SOCK_STREAM,
+        .ai_flags    = (pktgen->mode == MODE_REPLY) ? AI_PASSIVE : 0,
+    };
+    struct addrinfo *addresses;
+
+    int failure = getaddrinfo(pktgen->address, pktgen->port, &hints, &addresses);
+    assertTrue(failure == 0, "getaddrinfo(%s, %s): %s", pktgen->address, pktgen->port, gai_strerror(failure));
+
+    int fd = socket(addresses->ai_family, addresses->ai_socktype, addresses->ai_protocol);
+    assertFalse(fd < 0, "socket: (%d) %s", errno, strerror(errno));
+
+    if (pktgen->mode == MODE_REPLY) {
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        failure = bind(fd, addresses->ai_addr, addresses->ai_addrlen);
+        assertTrue(failure == 0, "bind port %s: (%d) %s", pktgen->port, errno, strerror(errno));
+        failure = listen(fd, 16);
+        assertTrue(failure == 0, "listen: (%d) %s", errno, strerror(errno));
+    } else {
+        failure = connect(fd, addresses->ai_addr, addresses->ai_addrlen);
+        assertTrue(failure == 0, "connect %s:%s: (%d) %s", pktgen->address, pktgen->port, errno, strerror(errno));
+    }
+
+    freeaddrinfo(addresses);
+    return fd;
 }
 
-// ======================================================================
+static int
+openLocal(PktGen *pktgen)
+{
+    struct sockaddr_un addr_unix;
+    memset(&addr_unix, 0, sizeof(struct sockaddr_un));
+    addr_unix.sun_family = AF_UNIX;
+    assertTrue(strlen(pktgen->address) < sizeof(addr_unix.sun_path), "Path too long: %s", pktgen->address);
+    strcpy(addr_unix.sun_path, pktgen->address);
+
+    int fd = socket(PF_UNIX, SOCK_STREAM, 0);
+    assertFalse(fd < 0, "socket: (%d) %s", errno, strerror(errno));
+
+    int failure;
+    if (pktgen->mode == MODE_REPLY) {
+        unlink(pktgen->address);
+        failure = bind(fd, (struct sockaddr *) &addr_unix, sizeof(addr_unix));
+        assertTrue(failure == 0, "bind %s: (%d) %s", pktgen->address, errno, strerror(errno));
+        failure = listen(fd, 16);
+        assertTrue(failure == 0, "listen: (%d) %s", errno, strerror(errno));
+    } else {
+        failure = connect(fd, (struct sockaddr *) &addr_unix, sizeof(addr_unix));
+        assertTrue(failure == 0, "connect %s: (%d) %s", pktgen->address, errno, strerror(errno));
+    }
+    return fd;
+}
 
-static void
-runSender(PktGen *pktgen)
+static int
+openSocket(PktGen *pktgen)
 {
+    int fd = -1;
     switch (pktgen->encap) {
-        case ENCAP_ETHER:
-            generateEther(pktgen);
+        case ENCAP_METIS:
+            fd = openMetis(pktgen);
             break;
 
-        case ENCAP_UDP:
-            generateUdp(pktgen);
+        case ENCAP_LOCAL:
+            fd = openLocal(pktgen);
             break;
 
         default:
-            trapIllegalValue(pktgen.encap, "Unknown encapsulation: %d", pktgen->encap);
+            trapIllegalValue(pktgen->encap, "Unknown encapsulation: %d", pktgen->encap);
+    }
+    return fd;
+}
+
+// ======================================================================
+
+/**
+ * Replies come back in the order sent, so the n-th reply matches the n-th packet.
+ */
+static void
+readReplies(PktGen *pktgen, int fd, FrameReader *reader)
+{
+    if (!fillReader(fd, reader)) {
+        trapUnrecoverableState("Replier closed the connection after %u replies", pktgen->replyCount);
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    size_t length;
+    while ((length = frameLength(pktgen, reader->buffer, reader->length)) > 0) {
+        const struct timeval *sent = &pktgen->sendTimes[pktgen->replyCount % pktgen->window];
+        pktgen->rttUsec[pktgen->replyCount] = (uint32_t) elapsedUsec(sent, &now);
+        pktgen->replyCount++;
+        pktgen->stopTime = now;
+        consumeFrame(reader, length);
+    }
+}
+
+static void
+runSender(PktGen *pktgen)
+{
+    int fd = openSocket(pktgen);
+    if (pktgen->encap == ENCAP_METIS) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+    pktgen->sendTimes = calloc(pktgen->window, sizeof(struct timeval));
+    pktgen->rttUsec = calloc(pktgen->count, sizeof(uint32_t));
+    assertTrue(pktgen->sendTimes != NULL && pktgen->rttUsec != NULL, "calloc returned NULL");
+
+    FrameReader *reader = calloc(1, sizeof(FrameReader));
+    assertNotNull(reader, "calloc returned NULL");
+
+    printf("Sending %u %s packets of %zu bytes%s\n",
+           pktgen->count, pktgen->packet == PACKET_INTEREST ? "interest" : "content object", pktgen->frameLength,
+           pktgen->flow == PKTGEN_STOPWAIT ? " stop and wait" : "");
+
+    gettimeofday(&pktgen->startTime, NULL);
+    pktgen->stopTime = pktgen->startTime;
+
+    struct timeval lastProgress = pktgen->startTime;
+    while (pktgen->replyCount < pktgen->count) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+
+        // how long until the rate lets us send the next packet
+        int waitMsec = -1;
+        if (pktgen->packetCount < pktgen->count && pktgen->packetCount - pktgen->replyCount < pktgen->window) {
+            uint64_t due = pktgen->rate ? (uint64_t) pktgen->packetCount * 1000000 / pktgen->rate : 0;
+            uint64_t elapsed = elapsedUsec(&pktgen->startTime, &now);
+            if (elapsed >= due) {
+                pktgen->sendTimes[pktgen->packetCount % pktgen->window] = now;
+                writeFully(fd, pktgen->frame, pktgen->frameLength);
+                pktgen->packetCount++;
+                pktgen->byteCount += pktgen->frameLength;
+                lastProgress = now;
+                waitMsec = 0;
+            } else {
+                waitMsec = (int) ((due - elapsed) / 1000);
+            }
+        }
+
+        if (waitMsec < 0 || waitMsec > 100) {
+            waitMsec = 100;
+        }
+
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, waitMsec) > 0) {
+            unsigned before = pktgen->replyCount;
+            readReplies(pktgen, fd, reader);
+            if (pktgen->replyCount != before) {
+                gettimeofday(&lastProgress, NULL);
+            }
+        } else {
+            gettimeofday(&now, NULL);
+            if (elapsedUsec(&lastProgress, &now) > IDLE_TIMEOUT_USEC) {
+                printf("Timed out waiting for replies\n");
+                break;
+            }
+        }
+    }
+
+    close(fd);
+    free(reader);
+}
+
+/**
+ * Serve one connection until the peer closes it or we reach our count
+ */
+static void
+reflect(PktGen *pktgen, int fd, FrameReader *reader)
+{
+    reader->length = 0;
+    while (pktgen->count == 0 || pktgen->packetCount < pktgen->count) {
+        if (!fillReader(fd, reader)) {
+            return;
+        }
+
+        // write back everything that is a whole frame, in one write
+        size_t total = 0;
+        size_t length;
+        while ((length = frameLength(pktgen, reader->buffer + total, reader->length - total)) > 0) {
+            total += length;
+            pktgen->packetCount++;
+        }
+
+        if (total > 0) {
+            if (pktgen->startTime.tv_sec == 0) {
+                gettimeofday(&pktgen->startTime, NULL);
+            }
+            writeFully(fd, reader->buffer, total);
+            pktgen->byteCount += total;
+            consumeFrame(reader, total);
+            gettimeofday(&pktgen->stopTime, NULL);
+        }
     }
 }
 
 static void
 runReplier(PktGen *pktgen)
 {
-    switch (pktgen->encap) {
-        case ENCAP_ETHER:
-            replyEther(pktgen);
-            break;
+    int listener = openSocket(pktgen);
 
-        case ENCAP_UDP:
-            replyUdp(pktgen);
-            break;
+    FrameReader *reader = calloc(1, sizeof(FrameReader));
+    assertNotNull(reader, "calloc returned NULL");
 
-        default:
-            trapIllegalValue(pktgen.encap, "Unknown encapsulation: %d", pktgen->encap);
+    if (pktgen->encap == ENCAP_METIS) {
+        printf("Reflecting on port %s\n", pktgen->port);
+    } else {
+        printf("Reflecting on %s\n", pktgen->address);
+    }
+
+    while (pktgen->count == 0 || pktgen->packetCount < pktgen->count) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            trapUnrecoverableState("accept: (%d) %s", errno, strerror(errno));
+        }
+
+        if (pktgen->encap == ENCAP_METIS) {
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+
+        reflect(pktgen, fd, reader);
+        close(fd);
+    }
+
+    close(listener);
+    if (pktgen->encap == ENCAP_LOCAL) {
+        unlink(pktgen->address);
     }
+    free(reader);
+}
+
+// ======================================================================
+
+static int
+compareUint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, unsigned count, double fraction)
+{
+    unsigned index = (unsigned) (fraction * count);
+    return sorted[(index < count) ? index : count - 1];
+}
+
+static void
+displayStatistics(PktGen *pktgen)
+{
+    double seconds = elapsedUsec(&pktgen->startTime, &pktgen->stopTime) * 1E-6;
+
+    if (pktgen->mode == MODE_REPLY) {
+        printf("reflected %u packets, %" PRIu64 " bytes", pktgen->packetCount, pktgen->byteCount);
+        if (seconds > 0) {
+            printf(" in %.3f sec, %.0f packets/sec", seconds, pktgen->packetCount / seconds);
+        }
+        printf("\n");
+        return;
+    }
+
+    printf("sent %u packets, %u replies", pktgen->packetCount, pktgen->replyCount);
+    if (pktgen->rate > 0) {
+        printf(", target rate %u packets/sec", pktgen->rate);
+    }
+    printf("\n");
+
+    if (pktgen->replyCount == 0 || seconds <= 0) {
+        return;
+    }
+
+    printf("achieved %.0f packets/sec, %.3f Mbps sent in %.3f sec\n",
+           pktgen->replyCount / seconds, pktgen->byteCount * 8 / seconds / 1E+6, seconds);
+
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < pktgen->replyCount; i++) {
+        sum += pktgen->rttUsec[i];
+    }
+    qsort(pktgen->rttUsec, pktgen->replyCount, sizeof(uint32_t), compareUint32);
+
+    printf("rtt usec: min %u mean %.1f p50 %u p90 %u p99 %u p999 %u max %u\n",
+           pktgen->rttUsec[0],
+           (double) sum / pktgen->replyCount,
+           percentile(pktgen->rttUsec, pktgen->replyCount, 0.50),
+           percentile(pktgen->rttUsec, pktgen->replyCount, 0.90),
+           percentile(pktgen->rttUsec, pktgen->replyCount, 0.99),
+           percentile(pktgen->rttUsec, pktgen->replyCount, 0.999),
+           pktgen->rttUsec[pktgen->replyCount - 1]);
 }
 
 // ======================================================================
@@ -189,20 +709,25 @@ runReplier(PktGen *pktgen)
 int
 main(int argc, char *argv[argc])
 {
-    PktGen pktgen = parseCommandLine(argc, argv);
+    PktGen *pktgen = parseCommandLine(argc, argv);
 
-    switch (pktgen.mode) {
+    switch (pktgen->mode) {
         case MODE_SEND:
-            runSender(&pktgen);
+            runSender(pktgen);
             break;
 
         case MODE_REPLY:
-            runReplier(&pktgen);
+            runReplier(pktgen);
             break;
 
         default:
-            trapIllegalValue(pktgen.mode, "Unknown mode: %d", pktgen.mode);
+            trapIllegalValue(pktgen->mode, "Unknown mode: %d", pktgen->mode);
     }
 
-    displayStatistics(&pktgen);
+    displayStatistics(pktgen);
+
+    free(pktgen->sendTimes);
+    free(pktgen->rttUsec);
+    free(pktgen);
+    return 0;
 }
@@ -0,0 +1,733 @@
+/*
+ * Copyright (c) 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * End-to-end throughput and latency of an RTA protocol stack, from the application API
+ * back up to the application API.
+ *
+ * Builds the stack { API_CONNECTOR, [FC_VEGAS], TLV_CODEC, lower } and opens one connection
+ * per application thread.  Each application has a sender thread that writes Content Objects
+ * with `rtaTransport_Send()` and a receiver thread that reads them back with `rtaTransport_Recv()`.
+ * The lower end of the stack turns the traffic around:
+ *
+ *   testing  TESTING_LOWER, whose downcall reader is replaced with one that puts each encoded
+ *            packet back up the same connection.  Measures the stack alone.
+ *   local    FWD_LOCAL to an in-process bent pipe (bent_pipe.h), which sends each packet up
+ *            every other connection.  Adds the PF_UNIX socket hop; needs two or more threads.
+ *   metis-tcp, metis-unix, metis-shm
+ *            FWD_METIS to an in-process stand-in forwarder (metis_standin.h) that sends each
+ *            packet back up the same connection, over TCP, a PF_UNIX socket or shared memory.
+ *
+ * Every Content Object carries the sender's thread, sequence number and send time, so the
+ * receiver measures send to receive latency.  The results are one JSON object on stdout:
+ * messages and bytes per second, and p50, p99, p999 and maximum latency in microseconds.
+ *
+ * With `-H` thread 0 is a heavy connection that sends its messages back to back while the
+ * other, light, connections send theirs every `-i` microseconds on the same stack.  The
+ * latencies of the two kinds are reported separately, which shows how well the stack's
+ * scheduler keeps the light connections' tail latency from queueing behind the heavy one.
+ * `-w` gives the light connections a larger scheduling weight and `-b` sets the stack's batch.
+ *
+ *     rta_bench [-l testing|local|metis-tcp|metis-unix|metis-shm] [-v] [-S] [-t threads] [-n messages] [-s payloadBytes]
+ *               [-H heavyMessages] [-i intervalUsec] [-w weight] [-b batch]
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/param.h>
+#include <limits.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_PublicKeySignerPkcs12Store.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+
+#include <ccnx/transport/common/transport.h>
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/rta_Transport.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+#include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/components/component_Testing.h>
+
+#include <ccnx/transport/test_tools/bent_pipe.h>
+#include <ccnx/transport/test_tools/metis_standin.h>
+
+// a receiver gives up after this long without a message
+#define RECEIVE_IDLE_USEC (2 * 1000000)
+
+typedef enum {
+    BenchLower_Testing,
+    BenchLower_Local,
+    BenchLower_MetisTcp,
+    BenchLower_MetisUnix,
+    BenchLower_MetisShm
+} BenchLower;
+
+static const char *lowerNames[] = {
+    [BenchLower_Testing]   = "testing",
+    [BenchLower_Local]     = "local",
+    [BenchLower_MetisTcp]  = "metis-tcp",
+    [BenchLower_MetisUnix] = "metis-unix",
+    [BenchLower_MetisShm]  = "metis-shm",
+};
+
+static const MetisTransport lowerTransports[] = {
+    [BenchLower_MetisTcp]  = MetisTransport_Tcp,
+    [BenchLower_MetisUnix] = MetisTransport_Unix,
+    [BenchLower_MetisShm]  = MetisTransport_SharedMemory,
+};
+
+typedef struct rta_bench_options {
+    BenchLower lower;
+    bool vegas;
+    bool separateStacks;
+    unsigned threads;
+    unsigned messages;
+    unsigned payloadBytes;
+
+    // thread 0 sends this many back to back, 0 for no heavy connection
+    unsigned heavyMessages;
+    unsigned intervalUsec;
+    unsigned weight;
+    unsigned batch;
+
+    char keystoreName[MAXPATHLEN];
+    char pipeName[MAXPATHLEN];
+    uint16_t metisPort;
+} RtaBenchOptions;
+
+/**
+ * The start of every payload
+ */
+typedef struct bench_payload_header {
+    uint32_t thread;
+    uint32_t sequence;
+    struct timeval sent;
+} BenchPayloadHeader;
+
+typedef struct bench_application {
+    const RtaBenchOptions *options;
+    RTATransport *transport;
+    unsigned index;
+    int fd;
+
+    pthread_t sender;
+    pthread_t receiver;
+
+    unsigned sent;
+
+    unsigned expected;
+    unsigned received;
+    uint64_t bytesReceived;
+    struct timeval lastReceived;
+
+    // one entry per message received
+    uint32_t *latencyUsec;
+} BenchApplication;
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  rta_bench [-l testing|local|metis-tcp|metis-unix|metis-shm] [-v] [-S] [-t threads] [-n messages] [-s payloadBytes]\n");
+    printf("            [-H heavyMessages] [-i intervalUsec] [-w weight] [-b batch]\n");
+    printf("\n");
+    printf("  -l lower         Bottom of the stack (default testing)\n");
+    printf("                     testing  TESTING_LOWER turns packets around in the stack\n");
+    printf("                     local    FWD_LOCAL to an in-process bent pipe\n");
+    printf("                     metis-*  FWD_METIS to an in-process stand-in over tcp, unix or shm\n");
+    printf("  -v               Put FC_VEGAS in the stack\n");
+    printf("  -S               A separate protocol stack per thread (default one shared stack)\n");
+    printf("  -t threads       Application threads, each with its own connection (default 1)\n");
+    printf("  -n messages      Messages each thread sends (default 10000)\n");
+    printf("  -s payloadBytes  Content Object payload size (default 1024)\n");
+    printf("  -H heavyMessages Thread 0 is a heavy connection sending this many back to back\n");
+    printf("  -i intervalUsec  Pause between the messages of the other threads (default 0, 1000 with -H)\n");
+    printf("  -w weight        Scheduling weight of the connections other than a heavy one (default 1)\n");
+    printf("  -b batch         Messages a component reads per turn of the event loop (default stack's)\n");
+    printf("\n");
+    printf("Output is a JSON object on stdout.\n");
+    printf("\n");
+}
+
+static RtaBenchOptions
+parseCommandLine(int argc, char *argv[argc])
+{
+    RtaBenchOptions options = {
+        .lower          = BenchLower_Testing,
+        .vegas          = false,
+        .separateStacks = false,
+        .threads        = 1,
+        .messages       = 10000,
+        .payloadBytes   = 1024,
+        .heavyMessages  = 0,
+        .intervalUsec   = UINT_MAX,
+        .weight         = 1,
+        .batch          = 0,
+    };
+
+    int c;
+    while ((c = getopt(argc, argv, "l:vSt:n:s:H:i:w:b:h")) != -1) {
+        switch (c) {
+            case 'l':
+                options.lower = BenchLower_MetisShm + 1;
+                for (BenchLower lower = BenchLower_Testing; lower <= BenchLower_MetisShm; lower++) {
+                    if (strcasecmp(optarg, lowerNames[lower]) == 0) {
+                        options.lower = lower;
+                    }
+                }
+                if (options.lower > BenchLower_MetisShm) {
+                    usage();
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'v':
+                options.vegas = true;
+                break;
+            case 'S':
+                options.separateStacks = true;
+                break;
+            case 't':
+                options.threads = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                options.messages = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                options.payloadBytes = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'H':
+                options.heavyMessages = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'i':
+                options.intervalUsec = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'w':
+                options.weight = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'b':
+                options.batch = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.threads == 0 || options.messages == 0 || options.weight == 0) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (options.lower == BenchLower_Local && options.threads < 2) {
+        fprintf(stderr, "The local lower sends to the other connections, it needs at least 2 threads\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options.heavyMessages > 0 && options.threads < 2) {
+        fprintf(stderr, "A heavy connection needs at least one light one beside it, use 2 or more threads\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (options.intervalUsec == UINT_MAX) {
+        options.intervalUsec = (options.heavyMessages > 0) ? 1000 : 0;
+    }
+
+    if (options.payloadBytes < sizeof(BenchPayloadHeader)) {
+        options.payloadBytes = sizeof(BenchPayloadHeader);
+    }
+
+    return options;
+}
+
+static bool
+isHeavy(const RtaBenchOptions *options, unsigned index)
+{
+    return options->heavyMessages > 0 && index == 0;
+}
+
+/**
+ * The number of messages thread `index` sends
+ */
+static unsigned
+messagesToSend(const RtaBenchOptions *options, unsigned index)
+{
+    return isHeavy(options, index) ? options->heavyMessages : options->messages;
+}
+
+static uint64_t
+elapsedUsec(const struct timeval *start, const struct timeval *stop)
+{
+    struct timeval delta;
+    timersub(stop, start, &delta);
+    return (uint64_t) delta.tv_sec * 1000000 + delta.tv_usec;
+}
+
+// ======================================================================
+// The testing lower: reflect every encoded packet back up its connection
+
+/**
+ * Copy the encoded packet into a contiguous buffer and make a message that looks like it
+ * was received by a forwarder connector.
+ */
+static TransportMessage *
+reflectMessage(TransportMessage *tm)
+{
+    CCNxCodecNetworkBufferIoVec *vec = ccnxWireFormatMessage_GetIoVec(transportMessage_GetDictionary(tm));
+    if (vec == NULL) {
+        return NULL;
+    }
+
+    int iovcnt = ccnxCodecNetworkBufferIoVec_GetCount(vec);
+    const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(vec);
+
+    size_t length = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        length += array[i].iov_len;
+    }
+
+    PARCBuffer *wireFormat = parcBuffer_Allocate(length);
+    for (int i = 0; i < iovcnt; i++) {
+        parcBuffer_PutArray(wireFormat, array[i].iov_len, array[i].iov_base);
+    }
+    parcBuffer_Flip(wireFormat);
+
+    TransportMessage *reflected = NULL;
+    CCNxWireFormatMessage *message = ccnxWireFormatMessage_Create(wireFormat);
+    if (message != NULL) {
+        reflected = transportMessage_CreateFromDictionary(ccnxWireFormatMessage_GetDictionary(message));
+        transportMessage_SetInfo(reflected, rtaConnection_Copy(transportMessage_GetInfo(tm)), rtaConnection_FreeFunc);
+        ccnxWireFormatMessage_Release(&message);
+    }
+    parcBuffer_Release(&wireFormat);
+
+    return reflected;
+}
+
+static void
+reflectDowncallRead(PARCEventQueue *in, PARCEventType event, void *stack)
+{
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, TESTING_LOWER, RTA_UP);
+
+    TransportMessage *tm;
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        TransportMessage *reflected = reflectMessage(tm);
+        if (reflected != NULL) {
+            rtaComponent_PutMessage(out, reflected);
+        }
+        transportMessage_Destroy(&tm);
+    }
+}
+
+// ======================================================================
+
+static CCNxTransportConfig *
+createTransportConfig(const RtaBenchOptions *options, unsigned index)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+    CCNxConnectionConfig *connConfig = ccnxConnectionConfig_Create();
+
+    PARCArrayList *components = parcArrayList_Create(NULL);
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    apiConnector_ConnectionConfig(connConfig);
+    parcArrayList_Add(components, (char *) apiConnector_GetName());
+
+    if (options->vegas) {
+        vegasFlowController_ProtocolStackConfig(stackConfig);
+        vegasFlowController_ConnectionConfig(connConfig);
+        parcArrayList_Add(components, (char *) vegasFlowController_GetName());
+    }
+
+    tlvCodec_ProtocolStackConfig(stackConfig);
+    tlvCodec_ConnectionConfig(connConfig);
+    parcArrayList_Add(components, (char *) tlvCodec_GetName());
+
+    switch (options->lower) {
+        case BenchLower_Testing:
+            testingLower_ProtocolStackConfig(stackConfig);
+            testingLower_ConnectionConfig(connConfig);
+            parcArrayList_Add(components, (char *) testingLower_GetName());
+            break;
+        case BenchLower_Local:
+            localForwarder_ProtocolStackConfig(stackConfig);
+            localForwarder_ConnectionConfig(connConfig, options->pipeName);
+            parcArrayList_Add(components, (char *) localForwarder_GetName());
+            break;
+        case BenchLower_MetisTcp:
+        case BenchLower_MetisUnix:
+        case BenchLower_MetisShm:
+            metisForwarder_ProtocolStackConfig(stackConfig);
+            metisForwarder_ConnectionConfig(connConfig, options->metisPort);
+            if (options->lower != BenchLower_MetisTcp) {
+                metisForwarder_SetTransport(connConfig, lowerTransports[options->lower], options->pipeName);
+            }
+            parcArrayList_Add(components, (char *) metisForwarder_GetName());
+            break;
+        default:
+            trapIllegalValue(options->lower, "Unknown lower %d", options->lower);
+    }
+
+    protocolStack_ComponentsConfigArrayList(stackConfig, components);
+    parcArrayList_Destroy(&components);
+
+    if (options->batch > 0) {
+        protocolStack_SetBatchSize(stackConfig, options->batch);
+    }
+
+    if (!isHeavy(options, index) && options->weight > 1) {
+        apiConnector_SetSchedulingWeight(connConfig, options->weight);
+    }
+
+    publicKeySignerPkcs12Store_ConnectionConfig(connConfig, options->keystoreName, "rta_bench");
+
+    // stacks are shared between connections with the same configuration, so a nonce splits them
+    char nonce[32];
+    snprintf(nonce, sizeof(nonce), "rta_bench %u", options->separateStacks ? index : 0);
+    PARCJSONValue *value = parcJSONValue_CreateFromCString(nonce);
+    ccnxStackConfig_Add(stackConfig, "nonce", value);
+    parcJSONValue_Release(&value);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+static CCNxMetaMessage *
+createMessage(BenchApplication *app, uint32_t sequence)
+{
+    uint8_t *payload = parcMemory_AllocateAndClear(app->options->payloadBytes);
+    assertNotNull(payload, "parcMemory_AllocateAndClear(%u) returned NULL", app->options->payloadBytes);
+
+    BenchPayloadHeader header = { .thread = app->index, .sequence = sequence };
+    gettimeofday(&header.sent, NULL);
+    memcpy(payload, &header, sizeof(header));
+
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/rta_bench/%u/%u", app->index, sequence);
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+
+    PARCBuffer *contents = parcBuffer_Flip(parcBuffer_CreateFromArray(payload, app->options->payloadBytes));
+    CCNxContentObject *object = ccnxContentObject_CreateWithDataPayload(name, contents);
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromContentObject(object);
+
+    ccnxContentObject_Release(&object);
+    parcBuffer_Release(&contents);
+    ccnxName_Release(&name);
+    parcMemory_Deallocate((void **) &payload);
+    return message;
+}
+
+static void *
+senderThread(void *arg)
+{
+    BenchApplication *app = arg;
+    unsigned messages = messagesToSend(app->options, app->index);
+    bool paced = !isHeavy(app->options, app->index) && app->options->intervalUsec > 0;
+
+    for (uint32_t sequence = 0; sequence < messages; sequence++) {
+        if (paced && sequence > 0) {
+            usleep(app->options->intervalUsec);
+        }
+
+        CCNxMetaMessage *message = createMessage(app, sequence);
+        bool success = rtaTransport_Send(app->transport, app->fd, message, CCNxStackTimeout_Never);
+        ccnxMetaMessage_Release(&message);
+        if (!success) {
+            fprintf(stderr, "thread %u: send failed after %u messages: %s\n", app->index, sequence, strerror(errno));
+            break;
+        }
+        app->sent++;
+    }
+    return NULL;
+}
+
+static void *
+receiverThread(void *arg)
+{
+    BenchApplication *app = arg;
+
+    while (app->received < app->expected) {
+        CCNxMetaMessage *message;
+        TransportIOStatus status = rtaTransport_Recv(app->transport, app->fd, &message, CCNxStackTimeout_MicroSeconds(RECEIVE_IDLE_USEC));
+        if (status != TransportIOStatus_Success) {
+            break;
+        }
+
+        struct timeval now;
+        gettimeofday(&now, NULL);
+
+        // skip the connection open notification and anything else that is not ours
+        if (ccnxMetaMessage_IsContentObject(message)) {
+            PARCBuffer *payload = ccnxContentObject_GetPayload(ccnxMetaMessage_GetContentObject(message));
+            if (payload != NULL && parcBuffer_Remaining(payload) >= sizeof(BenchPayloadHeader)) {
+                BenchPayloadHeader header;
+                memcpy(&header, parcBuffer_Overlay(payload, 0), sizeof(header));
+
+                app->latencyUsec[app->received] = (uint32_t) elapsedUsec(&header.sent, &now);
+                app->bytesReceived += parcBuffer_Remaining(payload);
+                app->received++;
+                app->lastReceived = now;
+            }
+        }
+        ccnxMetaMessage_Release(&message);
+    }
+    return NULL;
+}
+
+// ======================================================================
+
+static int
+compareUint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, size_t count, double fraction)
+{
+    if (count == 0) {
+        return 0;
+    }
+    size_t index = (size_t) (fraction * count);
+    if (index >= count) {
+        index = count - 1;
+    }
+    return sorted[index];
+}
+
+/**
+ * Prints the latency percentiles of the threads selected by `heavy`, or of all of them
+ */
+static void
+reportLatency(const RtaBenchOptions *options, BenchApplication apps[], const char *key, int heavy, const char *separator)
+{
+    size_t received = 0;
+    for (unsigned i = 0; i < options->threads; i++) {
+        if (heavy < 0 || isHeavy(options, i) == (heavy > 0)) {
+            received += apps[i].received;
+        }
+    }
+
+    uint32_t *latency = parcMemory_Allocate(sizeof(uint32_t) * (received > 0 ? received : 1));
+    assertNotNull(latency, "parcMemory_Allocate returned NULL");
+    size_t count = 0;
+    for (unsigned i = 0; i < options->threads; i++) {
+        if (heavy < 0 || isHeavy(options, i) == (heavy > 0)) {
+            memcpy(&latency[count], apps[i].latencyUsec, sizeof(uint32_t) * apps[i].received);
+            count += apps[i].received;
+        }
+    }
+    qsort(latency, count, sizeof(uint32_t), compareUint32);
+
+    printf("  \"%s\": { \"p50\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u }%s\n", key,
+           percentile(latency, count, 0.50), percentile(latency, count, 0.99), percentile(latency, count, 0.999),
+           count > 0 ? latency[count - 1] : 0, separator);
+
+    parcMemory_Deallocate((void **) &latency);
+}
+
+static void
+report(const RtaBenchOptions *options, BenchApplication apps[], const struct timeval *start)
+{
+    uint64_t sent = 0;
+    uint64_t expected = 0;
+    uint64_t received = 0;
+    uint64_t bytes = 0;
+    struct timeval stop = *start;
+
+    for (unsigned i = 0; i < options->threads; i++) {
+        sent += apps[i].sent;
+        expected += apps[i].expected;
+        received += apps[i].received;
+        bytes += apps[i].bytesReceived;
+        if (apps[i].received > 0 && timercmp(&apps[i].lastReceived, &stop, >)) {
+            stop = apps[i].lastReceived;
+        }
+    }
+
+    double seconds = elapsedUsec(start, &stop) * 1E-6;
+    if (seconds <= 0) {
+        seconds = 1E-6;
+    }
+
+    printf("{\n");
+    printf("  \"lower\": \"%s\",\n", lowerNames[options->lower]);
+    printf("  \"vegas\": %s,\n", options->vegas ? "true" : "false");
+    printf("  \"stacks\": %u,\n", options->separateStacks ? options->threads : 1);
+    printf("  \"threads\": %u,\n", options->threads);
+    printf("  \"payloadBytes\": %u,\n", options->payloadBytes);
+    if (options->heavyMessages > 0) {
+        printf("  \"heavyMessages\": %u,\n", options->heavyMessages);
+        printf("  \"intervalUsec\": %u,\n", options->intervalUsec);
+        printf("  \"weight\": %u,\n", options->weight);
+    }
+    if (options->batch > 0) {
+        printf("  \"batch\": %u,\n", options->batch);
+    }
+    printf("  \"sent\": %" PRIu64 ",\n", sent);
+    printf("  \"expected\": %" PRIu64 ",\n", expected);
+    printf("  \"received\": %" PRIu64 ",\n", received);
+    printf("  \"seconds\": %.6f,\n", seconds);
+    printf("  \"messagesPerSecond\": %.1f,\n", received / seconds);
+    printf("  \"bytesPerSecond\": %.1f,\n", bytes / seconds);
+    if (options->heavyMessages > 0) {
+        reportLatency(options, apps, "latencyUsec", -1, ",");
+        reportLatency(options, apps, "heavyLatencyUsec", 1, ",");
+        reportLatency(options, apps, "lightLatencyUsec", 0, "");
+    } else {
+        reportLatency(options, apps, "latencyUsec", -1, "");
+    }
+    printf("}\n");
+}
+
+static void
+waitForConnectionOpen(RTATransport *transport, int fd)
+{
+    CCNxMetaMessage *message;
+    TransportIOStatus status = rtaTransport_Recv(transport, fd, &message, CCNxStackTimeout_MicroSeconds(RECEIVE_IDLE_USEC));
+    assertTrue(status == TransportIOStatus_Success, "Did not get the connection open notification on fd %d", fd);
+    ccnxMetaMessage_Release(&message);
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    RtaBenchOptions options = parseCommandLine(argc, argv);
+
+    parcSecurity_Init();
+
+    snprintf(options.keystoreName, MAXPATHLEN, "/tmp/rta_bench.p12.%d", getpid());
+    unlink(options.keystoreName);
+    bool success = parcPublicKeySignerPkcs12Store_CreateFile(options.keystoreName, "rta_bench", "rta_bench", 1024, 30);
+    assertTrue(success, "parcPublicKeySignerPkcs12Store_CreateFile() failed.");
+
+    BentPipeState *bentpipe = NULL;
+    MetisStandin *standin = NULL;
+    if (options.lower == BenchLower_Local) {
+        snprintf(options.pipeName, MAXPATHLEN, "/tmp/rta_bench.pipe.%d", getpid());
+        unlink(options.pipeName);
+        bentpipe = bentpipe_Create(options.pipeName);
+        bentpipe_SetChattyOutput(bentpipe, false);
+        bentpipe_Start(bentpipe);
+    } else if (options.lower != BenchLower_Testing) {
+        snprintf(options.pipeName, MAXPATHLEN, "/tmp/rta_bench.metis.%d", getpid());
+        standin = metisStandin_Create(lowerTransports[options.lower], 0, options.pipeName);
+        options.metisPort = metisStandin_GetPort(standin);
+        metisStandin_Start(standin);
+    } else {
+        testing_null_ops.downcallRead = reflectDowncallRead;
+    }
+
+    RTATransport *transport = rtaTransport_Create();
+
+    BenchApplication *apps = parcMemory_AllocateAndClear(sizeof(BenchApplication) * options.threads);
+    assertNotNull(apps, "parcMemory_AllocateAndClear returned NULL");
+
+    for (unsigned i = 0; i < options.threads; i++) {
+        BenchApplication *app = &apps[i];
+        app->options = &options;
+        app->transport = transport;
+        app->index = i;
+
+        // the bent pipe sends every packet to all the other connections
+        app->expected = messagesToSend(&options, i);
+        if (options.lower == BenchLower_Local) {
+            app->expected = 0;
+            for (unsigned j = 0; j < options.threads; j++) {
+                if (j != i) {
+                    app->expected += messagesToSend(&options, j);
+                }
+            }
+        }
+        app->latencyUsec = parcMemory_Allocate(sizeof(uint32_t) * app->expected);
+        assertNotNull(app->latencyUsec, "parcMemory_Allocate returned NULL");
+
+        CCNxTransportConfig *config = createTransportConfig(&options, i);
+        app->fd = rtaTransport_Open(transport, config);
+        assertTrue(app->fd >= 0, "rtaTransport_Open failed for thread %u", i);
+        ccnxTransportConfig_Destroy(&config);
+
+        waitForConnectionOpen(transport, app->fd);
+    }
+
+    struct timeval start;
+    gettimeofday(&start, NULL);
+
+    for (unsigned i = 0; i < options.threads; i++) {
+        pthread_create(&apps[i].receiver, NULL, receiverThread, &apps[i]);
+        pthread_create(&apps[i].sender, NULL, senderThread, &apps[i]);
+    }
+
+    for (unsigned i = 0; i < options.threads; i++) {
+        pthread_join(apps[i].sender, NULL);
+        pthread_join(apps[i].receiver, NULL);
+    }
+
+    report(&options, apps, &start);
+
+    for (unsigned i = 0; i < options.threads; i++) {
+        rtaTransport_Close(transport, apps[i].fd);
+        parcMemory_Deallocate((void **) &apps[i].latencyUsec);
+    }
+    parcMemory_Deallocate((void **) &apps);
+    rtaTransport_Destroy(&transport);
+
+    if (bentpipe != NULL) {
+        bentpipe_Stop(bentpipe);
+        bentpipe_Destroy(&bentpipe);
+        unlink(options.pipeName);
+    }
+
+    if (standin != NULL) {
+        metisStandin_Stop(standin);
+        metisStandin_Destroy(&standin);
+    }
+
+    unlink(options.keystoreName);
+    parcSecurity_Fini();
+    return 0;
+}
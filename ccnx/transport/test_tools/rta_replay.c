@@ -0,0 +1,617 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Replays a connector capture into an RTA protocol stack and measures how the stack keeps up.
+ *
+ * A forwarder connector records a connection's packets when the connection is configured with
+ * `connectorCapture_ConnectionConfig()` (see rta_Capture.h).  This tool loads the packets that
+ * came UP from the forwarder and plays the forwarder's part: it builds the stack
+ * { API_CONNECTOR, TLV_CODEC, forwarder connector }, accepts the connector's socket and writes
+ * the packets to it with their original spacing divided by the speed factor.  The application
+ * end reads them with `rtaTransport_Recv()`.
+ *
+ *   local   FWD_LOCAL over a PF_UNIX socket (default)
+ *   metis   FWD_METIS over TCP on 127.0.0.1, the connector reads the V1 fixed header framing
+ *
+ * Packets are matched in order, so the latency of packet i is from the moment the tool starts
+ * writing it until the application receives message i.  A packet the stack drops skews the
+ * pairing of the ones after it; compare "received" to "replayed".  "lagUsec" is how far behind
+ * the capture's schedule the writes ran, which grows when the stack does not drain its socket
+ * fast enough.  Anything the stack sends down is read and counted but not interpreted.
+ *
+ *     rta_replay [-m port] [-c connectionId] [-x speed] capture
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_ArrayList.h>
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_PublicKeySignerPkcs12Store.h>
+
+#include <ccnx/transport/common/transport.h>
+#include <ccnx/transport/transport_rta/rta_Transport.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+#include <ccnx/transport/transport_rta/connectors/rta_Capture.h>
+
+// the receiver gives up after this long without a message
+#define RECEIVE_IDLE_USEC (2 * 1000000)
+
+typedef enum {
+    ReplayForwarder_Local,
+    ReplayForwarder_Metis
+} ReplayForwarder;
+
+static const char *forwarderNames[] = {
+    [ReplayForwarder_Local] = "local",
+    [ReplayForwarder_Metis] = "metis",
+};
+
+typedef struct rta_replay_options {
+    ReplayForwarder forwarder;
+    uint16_t port;
+    bool filterConnection;
+    unsigned connectionId;
+
+    // 1 is the original timing, 2 twice as fast, 0 as fast as possible
+    double speed;
+
+    const char *captureName;
+    char keystoreName[MAXPATHLEN];
+    char pipeName[MAXPATHLEN];
+} RtaReplayOptions;
+
+/**
+ * The FWD_LOCAL framing, see connector_Forwarder_Local.c
+ */
+typedef struct {
+    uint32_t pid;
+    uint32_t fd;
+    uint32_t length;
+    uint32_t pad;
+} __attribute__ ((packed)) localhdr;
+
+typedef struct replay_packet {
+    // from the first packet in the capture
+    uint64_t offsetUsec;
+    PARCBuffer *packet;
+} ReplayPacket;
+
+typedef struct replay {
+    const RtaReplayOptions *options;
+
+    ReplayPacket *packets;
+    size_t count;
+    uint64_t captureBytes;
+
+    // the connector's end of the socket
+    int fd;
+
+    pthread_t feeder;
+    pthread_t drain;
+
+    // written by the feeder, one entry per packet
+    size_t replayed;
+    uint64_t *startedUsec;
+    uint32_t *lagUsec;
+
+    // counted by the drain thread
+    uint64_t bytesDown;
+
+    // counted by the receiver
+    size_t received;
+    uint32_t *latencyUsec;
+    uint64_t firstReceivedUsec;
+    uint64_t lastReceivedUsec;
+} Replay;
+
+// ======================================================================
+
+static void
+usage(void)
+{
+    printf("usage: \n");
+    printf("  rta_replay [-m port] [-c connectionId] [-x speed] capture\n");
+    printf("\n");
+    printf("  -m port          Replay as Metis on 127.0.0.1 port (default FWD_LOCAL over PF_UNIX)\n");
+    printf("  -c connectionId  Replay only this connection from the capture (default all)\n");
+    printf("  -x speed         Timing factor, 1 is the original timing, 0 as fast as possible (default 1)\n");
+    printf("  capture          A capture file from connectorCapture_ConnectionConfig()\n");
+    printf("\n");
+    printf("Output is a JSON object on stdout.\n");
+    printf("\n");
+}
+
+static RtaReplayOptions
+parseCommandLine(int argc, char *argv[argc])
+{
+    RtaReplayOptions options = {
+        .forwarder        = ReplayForwarder_Local,
+        .port             = 0,
+        .filterConnection = false,
+        .speed            = 1.0,
+    };
+
+    int c;
+    while ((c = getopt(argc, argv, "m:c:x:h")) != -1) {
+        switch (c) {
+            case 'm':
+                options.forwarder = ReplayForwarder_Metis;
+                options.port = (uint16_t) strtoul(optarg, NULL, 10);
+                break;
+            case 'c':
+                options.filterConnection = true;
+                options.connectionId = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'x':
+                options.speed = strtod(optarg, NULL);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind != argc - 1 || options.speed < 0 || (options.forwarder == ReplayForwarder_Metis && options.port == 0)) {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    options.captureName = argv[optind];
+    return options;
+}
+
+static uint64_t
+nowUsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void
+sleepUntil(uint64_t dueUsec)
+{
+    uint64_t now;
+    while ((now = nowUsec()) < dueUsec) {
+        uint64_t remaining = dueUsec - now;
+        struct timespec delay = { .tv_sec = remaining / 1000000, .tv_nsec = (remaining % 1000000) * 1000 };
+        nanosleep(&delay, NULL);
+    }
+}
+
+static bool
+writeAll(int fd, const void *bytes, size_t length)
+{
+    const uint8_t *p = bytes;
+    while (length > 0) {
+        ssize_t nwritten = write(fd, p, length);
+        if (nwritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += nwritten;
+        length -= nwritten;
+    }
+    return true;
+}
+
+// ======================================================================
+
+static bool
+isReplayed(const RtaReplayOptions *options, const RtaCaptureRecord *record)
+{
+    return record->direction == RtaCaptureDirection_Up &&
+           (!options->filterConnection || record->connectionId == options->connectionId);
+}
+
+static RtaCaptureReader *
+openCapture(const RtaReplayOptions *options)
+{
+    RtaCaptureReader *reader = rtaCaptureReader_Open(options->captureName);
+    if (reader == NULL) {
+        fprintf(stderr, "Could not read capture %s\n", options->captureName);
+        exit(EXIT_FAILURE);
+    }
+    return reader;
+}
+
+/**
+ * Loads the UP packets of the capture into memory, so reading the file does not
+ * disturb the replay timing.  The first pass counts them.
+ */
+static void
+loadCapture(Replay *replay)
+{
+    RtaCaptureRecord record;
+
+    RtaCaptureReader *reader = openCapture(replay->options);
+    while (rtaCaptureReader_Next(reader, &record)) {
+        if (isReplayed(replay->options, &record)) {
+            replay->count++;
+        }
+        parcBuffer_Release(&record.packet);
+    }
+    rtaCaptureReader_Close(&reader);
+
+    if (replay->count == 0) {
+        fprintf(stderr, "No packets to replay in %s\n", replay->options->captureName);
+        exit(EXIT_FAILURE);
+    }
+
+    replay->packets = parcMemory_AllocateAndClear(sizeof(ReplayPacket) * replay->count);
+    replay->startedUsec = parcMemory_AllocateAndClear(sizeof(uint64_t) * replay->count);
+    replay->lagUsec = parcMemory_AllocateAndClear(sizeof(uint32_t) * replay->count);
+    replay->latencyUsec = parcMemory_AllocateAndClear(sizeof(uint32_t) * replay->count);
+    assertTrue(replay->packets && replay->startedUsec && replay->lagUsec && replay->latencyUsec,
+               "parcMemory_AllocateAndClear returned NULL");
+
+    size_t loaded = 0;
+    uint64_t firstUsec = 0;
+
+    reader = openCapture(replay->options);
+    while (loaded < replay->count && rtaCaptureReader_Next(reader, &record)) {
+        if (!isReplayed(replay->options, &record)) {
+            parcBuffer_Release(&record.packet);
+            continue;
+        }
+
+        if (loaded == 0) {
+            firstUsec = record.timestampUsec;
+        }
+
+        // connections that share a file are not strictly in timestamp order
+        uint64_t offset = record.timestampUsec > firstUsec ? record.timestampUsec - firstUsec : 0;
+        if (loaded > 0 && offset < replay->packets[loaded - 1].offsetUsec) {
+            offset = replay->packets[loaded - 1].offsetUsec;
+        }
+
+        replay->packets[loaded].offsetUsec = offset;
+        replay->packets[loaded].packet = record.packet;
+        replay->captureBytes += parcBuffer_Remaining(record.packet);
+        loaded++;
+    }
+    rtaCaptureReader_Close(&reader);
+
+    assertTrue(loaded == replay->count, "Capture changed while loading, got %zu packets expected %zu", loaded, replay->count);
+}
+
+static void *
+feederThread(void *arg)
+{
+    Replay *replay = arg;
+    double speed = replay->options->speed;
+    uint64_t start = nowUsec();
+
+    for (size_t i = 0; i < replay->count; i++) {
+        ReplayPacket *packet = &replay->packets[i];
+        size_t length = parcBuffer_Remaining(packet->packet);
+
+        uint64_t due = start;
+        if (speed > 0) {
+            due += (uint64_t) (packet->offsetUsec / speed);
+            sleepUntil(due);
+        }
+
+        uint64_t now = nowUsec();
+        replay->startedUsec[i] = now;
+        replay->lagUsec[i] = (uint32_t) (now > due ? now - due : 0);
+
+        if (replay->options->forwarder == ReplayForwarder_Local) {
+            localhdr header = { .pid = getpid(), .fd = 0, .length = (uint32_t) length, .pad = 0 };
+            if (!writeAll(replay->fd, &header, sizeof(header))) {
+                break;
+            }
+        }
+
+        if (!writeAll(replay->fd, parcBuffer_Overlay(packet->packet, 0), length)) {
+            break;
+        }
+        replay->replayed++;
+    }
+
+    if (replay->replayed < replay->count) {
+        fprintf(stderr, "Socket write failed after %zu packets: %s\n", replay->replayed, strerror(errno));
+    }
+    return NULL;
+}
+
+static void *
+drainThread(void *arg)
+{
+    Replay *replay = arg;
+    uint8_t buffer[65536];
+
+    ssize_t nread;
+    while ((nread = read(replay->fd, buffer, sizeof(buffer))) != 0) {
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        replay->bytesDown += nread;
+    }
+    return NULL;
+}
+
+static void
+receive(Replay *replay, RTATransport *transport, int stackFd)
+{
+    while (replay->received < replay->count) {
+        CCNxMetaMessage *message;
+        TransportIOStatus status = rtaTransport_Recv(transport, stackFd, &message, CCNxStackTimeout_MicroSeconds(RECEIVE_IDLE_USEC));
+        if (status != TransportIOStatus_Success) {
+            break;
+        }
+
+        uint64_t now = nowUsec();
+        if (replay->received == 0) {
+            replay->firstReceivedUsec = now;
+        }
+        replay->lastReceivedUsec = now;
+
+        size_t i = replay->received;
+        replay->latencyUsec[i] = (uint32_t) (now > replay->startedUsec[i] ? now - replay->startedUsec[i] : 0);
+        replay->received++;
+
+        ccnxMetaMessage_Release(&message);
+    }
+}
+
+// ======================================================================
+
+static int
+compareUint32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *) a;
+    uint32_t y = *(const uint32_t *) b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, size_t count, double fraction)
+{
+    if (count == 0) {
+        return 0;
+    }
+    size_t index = (size_t) (fraction * count);
+    if (index >= count) {
+        index = count - 1;
+    }
+    return sorted[index];
+}
+
+static void
+report(Replay *replay)
+{
+    const RtaReplayOptions *options = replay->options;
+
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < replay->received; i++) {
+        bytes += parcBuffer_Remaining(replay->packets[i].packet);
+    }
+
+    qsort(replay->latencyUsec, replay->received, sizeof(uint32_t), compareUint32);
+    qsort(replay->lagUsec, replay->replayed, sizeof(uint32_t), compareUint32);
+
+    double captureSeconds = replay->packets[replay->count - 1].offsetUsec * 1E-6;
+    double seconds = (replay->startedUsec[0] < replay->lastReceivedUsec ? replay->lastReceivedUsec - replay->startedUsec[0] : 1) * 1E-6;
+
+    printf("{\n");
+    printf("  \"forwarder\": \"%s\",\n", forwarderNames[options->forwarder]);
+    printf("  \"capture\": \"%s\",\n", options->captureName);
+    printf("  \"speed\": %.3f,\n", options->speed);
+    printf("  \"packets\": %zu,\n", replay->count);
+    printf("  \"captureBytes\": %" PRIu64 ",\n", replay->captureBytes);
+    printf("  \"captureSeconds\": %.6f,\n", captureSeconds);
+    printf("  \"replayed\": %zu,\n", replay->replayed);
+    printf("  \"received\": %zu,\n", replay->received);
+    printf("  \"bytesDown\": %" PRIu64 ",\n", replay->bytesDown);
+    printf("  \"seconds\": %.6f,\n", seconds);
+    printf("  \"messagesPerSecond\": %.1f,\n", replay->received / seconds);
+    printf("  \"bytesPerSecond\": %.1f,\n", bytes / seconds);
+    printf("  \"lagUsec\": { \"p50\": %u, \"p99\": %u, \"max\": %u },\n",
+           percentile(replay->lagUsec, replay->replayed, 0.50), percentile(replay->lagUsec, replay->replayed, 0.99),
+           replay->replayed > 0 ? replay->lagUsec[replay->replayed - 1] : 0);
+    printf("  \"latencyUsec\": { \"p50\": %u, \"p99\": %u, \"p999\": %u, \"max\": %u }\n",
+           percentile(replay->latencyUsec, replay->received, 0.50), percentile(replay->latencyUsec, replay->received, 0.99),
+           percentile(replay->latencyUsec, replay->received, 0.999),
+           replay->received > 0 ? replay->latencyUsec[replay->received - 1] : 0);
+    printf("}\n");
+}
+
+// ======================================================================
+
+static int
+listenForConnector(RtaReplayOptions *options)
+{
+    int fd;
+    if (options->forwarder == ReplayForwarder_Local) {
+        snprintf(options->pipeName, MAXPATHLEN, "/tmp/rta_replay.pipe.%d", getpid());
+        unlink(options->pipeName);
+
+        fd = socket(PF_UNIX, SOCK_STREAM, 0);
+        assertTrue(fd >= 0, "socket PF_UNIX: %s", strerror(errno));
+
+        struct sockaddr_un addr_unix;
+        memset(&addr_unix, 0, sizeof(addr_unix));
+        addr_unix.sun_family = AF_UNIX;
+        strncpy(addr_unix.sun_path, options->pipeName, sizeof(addr_unix.sun_path) - 1);
+        if (bind(fd, (struct sockaddr *) &addr_unix, sizeof(addr_unix)) < 0) {
+            perror("bind");
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        fd = socket(PF_INET, SOCK_STREAM, 0);
+        assertTrue(fd >= 0, "socket PF_INET: %s", strerror(errno));
+
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        struct sockaddr_in addr_in;
+        memset(&addr_in, 0, sizeof(addr_in));
+        addr_in.sin_family = AF_INET;
+        addr_in.sin_port = htons(options->port);
+        addr_in.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (bind(fd, (struct sockaddr *) &addr_in, sizeof(addr_in)) < 0) {
+            perror("bind");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (listen(fd, 1) < 0) {
+        perror("listen");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+static CCNxTransportConfig *
+createTransportConfig(const RtaReplayOptions *options)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+    CCNxConnectionConfig *connConfig = ccnxConnectionConfig_Create();
+
+    PARCArrayList *components = parcArrayList_Create(NULL);
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    apiConnector_ConnectionConfig(connConfig);
+    parcArrayList_Add(components, (char *) apiConnector_GetName());
+
+    tlvCodec_ProtocolStackConfig(stackConfig);
+    tlvCodec_ConnectionConfig(connConfig);
+    parcArrayList_Add(components, (char *) tlvCodec_GetName());
+
+    switch (options->forwarder) {
+        case ReplayForwarder_Local:
+            localForwarder_ProtocolStackConfig(stackConfig);
+            localForwarder_ConnectionConfig(connConfig, options->pipeName);
+            parcArrayList_Add(components, (char *) localForwarder_GetName());
+            break;
+        case ReplayForwarder_Metis:
+            metisForwarder_ProtocolStackConfig(stackConfig);
+            metisForwarder_ConnectionConfig(connConfig, options->port);
+            parcArrayList_Add(components, (char *) metisForwarder_GetName());
+            break;
+        default:
+            trapIllegalValue(options->forwarder, "Unknown forwarder %d", options->forwarder);
+    }
+
+    protocolStack_ComponentsConfigArrayList(stackConfig, components);
+    parcArrayList_Destroy(&components);
+
+    publicKeySignerPkcs12Store_ConnectionConfig(connConfig, options->keystoreName, "rta_replay");
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+int
+main(int argc, char *argv[argc])
+{
+    RtaReplayOptions options = parseCommandLine(argc, argv);
+
+    Replay replay = { .options = &options, .fd = -1 };
+    loadCapture(&replay);
+
+    parcSecurity_Init();
+
+    snprintf(options.keystoreName, MAXPATHLEN, "/tmp/rta_replay.p12.%d", getpid());
+    unlink(options.keystoreName);
+    bool success = parcPublicKeySignerPkcs12Store_CreateFile(options.keystoreName, "rta_replay", "rta_replay", 1024, 30);
+    assertTrue(success, "parcPublicKeySignerPkcs12Store_CreateFile() failed.");
+
+    int listenFd = listenForConnector(&options);
+
+    RTATransport *transport = rtaTransport_Create();
+    CCNxTransportConfig *config = createTransportConfig(&options);
+    int stackFd = rtaTransport_Open(transport, config);
+    assertTrue(stackFd >= 0, "rtaTransport_Open failed");
+    ccnxTransportConfig_Destroy(&config);
+
+    // the connector connects from the transport thread, the backlog holds it until we accept
+    replay.fd = accept(listenFd, NULL, NULL);
+    assertTrue(replay.fd >= 0, "accept: %s", strerror(errno));
+    close(listenFd);
+
+    // the connection open notification
+    CCNxMetaMessage *message;
+    TransportIOStatus status = rtaTransport_Recv(transport, stackFd, &message, CCNxStackTimeout_MicroSeconds(RECEIVE_IDLE_USEC));
+    assertTrue(status == TransportIOStatus_Success, "Did not get the connection open notification");
+    ccnxMetaMessage_Release(&message);
+
+    pthread_create(&replay.drain, NULL, drainThread, &replay);
+    pthread_create(&replay.feeder, NULL, feederThread, &replay);
+
+    receive(&replay, transport, stackFd);
+    pthread_join(replay.feeder, NULL);
+
+    report(&replay);
+
+    // closing the connection closes the connector's socket, which ends the drain thread
+    rtaTransport_Close(transport, stackFd);
+    pthread_join(replay.drain, NULL);
+    close(replay.fd);
+    rtaTransport_Destroy(&transport);
+
+    for (size_t i = 0; i < replay.count; i++) {
+        parcBuffer_Release(&replay.packets[i].packet);
+    }
+    parcMemory_Deallocate((void **) &replay.packets);
+    parcMemory_Deallocate((void **) &replay.startedUsec);
+    parcMemory_Deallocate((void **) &replay.lagUsec);
+    parcMemory_Deallocate((void **) &replay.latencyUsec);
+
+    if (options.forwarder == ReplayForwarder_Local) {
+        unlink(options.pipeName);
+    }
+    unlink(options.keystoreName);
+    parcSecurity_Fini();
+    return 0;
+}
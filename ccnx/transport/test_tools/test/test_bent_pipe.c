@@ -50,6 +50,7 @@ static const char *local_name = "/tmp/alpha";
 LONGBOW_TEST_RUNNER(BentPipe)
 {
     LONGBOW_RUN_TEST_FIXTURE(CreateDestroy);
+    LONGBOW_RUN_TEST_FIXTURE(Link);
     LONGBOW_RUN_TEST_FIXTURE(System);
 }
 
@@ -100,6 +101,236 @@ LONGBOW_TEST_CASE(CreateDestroy, create_start_stop_destroy)
     bentpipe_Destroy(&bp);
 }
 
+// ================================
+// The link emulation, on a pipe with no clients
+
+LONGBOW_TEST_FIXTURE(Link)
+{
+    LONGBOW_RUN_TEST_CASE(Link, bentpipe_SetLinkParams_Invalid);
+    LONGBOW_RUN_TEST_CASE(Link, bentpipe_Params);
+    LONGBOW_RUN_TEST_CASE(Link, link_serialize_ConstantRate);
+    LONGBOW_RUN_TEST_CASE(Link, link_serialize_Trace);
+    LONGBOW_RUN_TEST_CASE(Link, link_serialize_Outage);
+    LONGBOW_RUN_TEST_CASE(Link, link_sample_delay);
+    LONGBOW_RUN_TEST_CASE(Link, link_red_drop);
+    LONGBOW_RUN_TEST_CASE(Link, bentpipe_ReadRateTrace);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Link)
+{
+    BentPipeState *bp = bentpipe_Create(local_name);
+    longBowTestCase_SetClipBoardData(testCase, bp);
+    srand48(1);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Link)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    bentpipe_Destroy(&bp);
+
+    if (parcMemory_Outstanding() != 0) {
+        printf("('%s' leaks memory by %d (allocs - frees)) ", longBowTestCase_GetName(testCase), parcMemory_Outstanding());
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static struct bentpipe_conn *
+setupLink(BentPipeState *bp, const BentPipeLinkParams *params)
+{
+    int failure = bentpipe_SetLinkParams(bp, 0, params);
+    assertTrue(failure == 0, "bentpipe_SetLinkParams failed");
+    struct bentpipe_conn *link = &bp->conns[0];
+    reset_link(link);
+    return link;
+}
+
+LONGBOW_TEST_CASE(Link, bentpipe_SetLinkParams_Invalid)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    BentPipeLinkParams params;
+
+    bentpipe_LinkParamsInit(&params);
+    assertTrue(bentpipe_SetLinkParams(bp, MAX_CONN, &params) == -1, "Should reject a connection out of range");
+
+    params.loss_rate = 1.5;
+    assertTrue(bentpipe_SetLinkParams(bp, -1, &params) == -1, "Should reject loss rate over 1");
+
+    BentPipeRateStep outage[] = { { 1.0, 0 } };
+    bentpipe_LinkParamsInit(&params);
+    params.rateTrace = outage;
+    params.rateTraceLength = 1;
+    assertTrue(bentpipe_SetLinkParams(bp, -1, &params) == -1, "Should reject a trace that never sends");
+
+    bentpipe_LinkParamsInit(&params);
+    params.queueDiscipline = BentPipeQueue_RED;
+    params.red_min_bytes = 1000;
+    params.red_max_bytes = 1000;
+    assertTrue(bentpipe_SetLinkParams(bp, -1, &params) == -1, "Should reject RED min >= max");
+
+    assertFalse(bp->use_params, "Rejected params should not turn on emulation");
+}
+
+LONGBOW_TEST_CASE(Link, bentpipe_Params)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+
+    bentpipe_Params(bp, 0.01, 32000, 0.005, 125000);
+
+    assertTrue(bp->use_params, "Emulation should be on");
+    for (int i = 0; i < MAX_CONN; i++) {
+        const BentPipeLinkParams *params = &bp->conns[i].params;
+        assertTrue(params->rateTraceLength == 1 && params->rateTrace[0].bytes_per_sec == 125000,
+                   "Link %d wrong rate", i);
+        assertTrue(params->delayDistribution == BentPipeDelay_Exponential, "Link %d wrong delay", i);
+        assertTrue(params->buffer_bytes == 32000, "Link %d wrong buffer", i);
+    }
+}
+
+LONGBOW_TEST_CASE(Link, link_serialize_ConstantRate)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    BentPipeRateStep trace[] = { { 1.0, 1000 } };
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.rateTrace = trace;
+    params.rateTraceLength = 1;
+    struct bentpipe_conn *link = setupLink(bp, &params);
+
+    double start = link->trace_step_start;
+    double end = link_serialize(link, start, 500);
+    assertTrue(fabs(end - start - 0.5) < 1E-9, "500 bytes at 1000 B/s should take 0.5 sec, got %f", end - start);
+
+    // back to back it spans the step boundary, which repeats at the same rate
+    end = link_serialize(link, end, 1000);
+    assertTrue(fabs(end - start - 1.5) < 1E-9, "Expected 1.5 sec, got %f", end - start);
+}
+
+LONGBOW_TEST_CASE(Link, link_serialize_Trace)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    BentPipeRateStep trace[] = { { 1.0, 1000 }, { 1.0, 100 } };
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.rateTrace = trace;
+    params.rateTraceLength = 2;
+    struct bentpipe_conn *link = setupLink(bp, &params);
+
+    double start = link->trace_step_start;
+
+    // 1000 bytes in the first second, then 50 bytes at 100 B/s
+    double end = link_serialize(link, start + 0.0, 1050);
+    assertTrue(fabs(end - start - 1.5) < 1E-9, "Expected 1.5 sec, got %f", end - start);
+
+    // idle for ten cycles, then in the fast step again
+    end = link_serialize(link, start + 20.25, 500);
+    assertTrue(fabs(end - start - 20.75) < 1E-9, "Expected 20.75 sec, got %f", end - start);
+}
+
+LONGBOW_TEST_CASE(Link, link_serialize_Outage)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    BentPipeRateStep trace[] = { { 1.0, 0 }, { 1.0, 1000 } };
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.rateTrace = trace;
+    params.rateTraceLength = 2;
+    struct bentpipe_conn *link = setupLink(bp, &params);
+
+    double start = link->trace_step_start;
+    double end = link_serialize(link, start + 0.5, 100);
+    assertTrue(fabs(end - start - 1.1) < 1E-9, "Should wait out the outage, expected 1.1 sec, got %f", end - start);
+}
+
+LONGBOW_TEST_CASE(Link, link_sample_delay)
+{
+    const unsigned samples = 100000;
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.mean_sec_delay = 0.010;
+    params.delay_sec_parameter = 0.002;
+
+    BentPipeDelayDistribution distributions[] = {
+        BentPipeDelay_Constant, BentPipeDelay_Uniform, BentPipeDelay_Exponential, BentPipeDelay_Normal
+    };
+
+    for (int d = 0; d < sizeof(distributions) / sizeof(distributions[0]); d++) {
+        params.delayDistribution = distributions[d];
+        double sum = 0;
+        for (unsigned i = 0; i < samples; i++) {
+            double delay = link_sample_delay(&params);
+            assertTrue(delay >= 0, "Distribution %d gave a negative delay %f", distributions[d], delay);
+            if (distributions[d] == BentPipeDelay_Uniform) {
+                assertTrue(delay >= 0.008 && delay <= 0.012, "Uniform delay %f out of range", delay);
+            }
+            sum += delay;
+        }
+        double mean = sum / samples;
+        assertTrue(fabs(mean - params.mean_sec_delay) < 0.0005, "Distribution %d mean %f expected %f",
+                   distributions[d], mean, params.mean_sec_delay);
+    }
+}
+
+LONGBOW_TEST_CASE(Link, link_red_drop)
+{
+    BentPipeState *bp = longBowTestCase_GetClipBoardData(testCase);
+    BentPipeLinkParams params;
+    bentpipe_LinkParamsInit(&params);
+    params.queueDiscipline = BentPipeQueue_RED;
+    params.red_min_bytes = 10000;
+    params.red_max_bytes = 30000;
+    params.red_max_p = 0.1;
+    params.red_weight = 1.0;    // no averaging, so the test controls the average
+    struct bentpipe_conn *link = setupLink(bp, &params);
+
+    link->backlog_bytes = 5000;
+    for (int i = 0; i < 1000; i++) {
+        assertFalse(link_red_drop(link), "Should never drop below the minimum threshold");
+    }
+
+    link->backlog_bytes = 40000;
+    for (int i = 0; i < 1000; i++) {
+        assertTrue(link_red_drop(link), "Should always drop above the maximum threshold");
+    }
+
+    link->backlog_bytes = 20000;
+    unsigned drops = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (link_red_drop(link)) {
+            drops++;
+        }
+    }
+    // pb is 0.05, spread evenly by the count so about 1 in 10
+    assertTrue(drops > 500 && drops < 1500, "Expected about 1000 early drops, got %u", drops);
+    link->backlog_bytes = 0;
+}
+
+LONGBOW_TEST_CASE(Link, bentpipe_ReadRateTrace)
+{
+    const char *filename = "/tmp/test_bent_pipe_trace";
+    FILE *file = fopen(filename, "w");
+    assertNotNull(file, "Could not create %s", filename);
+    fprintf(file, "# seconds bytes_per_sec\n\n0.5 125000\n  1.5 0\n0.25 1250000\n");
+    fclose(file);
+
+    size_t length = 0;
+    BentPipeRateStep *trace = bentpipe_ReadRateTrace(filename, &length);
+    assertNotNull(trace, "Could not read the trace");
+    assertTrue(length == 3, "Expected 3 steps, got %zu", length);
+    assertTrue(trace[1].seconds == 1.5 && trace[1].bytes_per_sec == 0, "Wrong second step");
+    assertTrue(trace[2].seconds == 0.25 && trace[2].bytes_per_sec == 1250000, "Wrong third step");
+    parcMemory_Deallocate((void **) &trace);
+
+    file = fopen(filename, "w");
+    fprintf(file, "0.5 fast\n");
+    fclose(file);
+    assertNull(bentpipe_ReadRateTrace(filename, &length), "Should reject a malformed line");
+
+    unlink(filename);
+}
+
 // ================================
 
 BentPipeState *system_bp;
@@ -653,7 +653,8 @@ vegas_HandleControl(RtaConnection *conn, CCNxTlvDictionary *controlDictionary, P
 {
     bool success = false;
 
-    if (ccnxControlFacade_IsCPI(controlDictionary)) {
+    // CANCEL_FLOW only comes as JSON, binary CPI messages pass straight through
+    if (ccnxControlFacade_IsCPI(controlDictionary) && !ccnxControlFacade_IsBinary(controlDictionary)) {
         PARCJSON *json = ccnxControlFacade_GetJson(controlDictionary);
         if (cpi_getCPIOperation2(json) == CPI_CANCEL_FLOW) {
             VegasConnectionState *fc = rtaConnection_GetPrivateData(conn, FC_VEGAS);
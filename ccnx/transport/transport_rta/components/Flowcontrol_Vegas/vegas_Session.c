@@ -87,7 +87,7 @@
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_SafeMemory.h>
 
-#include <parc/algol/parc_EventTimer.h>
+#include <ccnx/transport/transport_rta/core/rta_Timer.h>
 
 #include <ccnx/common/ccnx_NameSegmentNumber.h>
 #include <ccnx/common/ccnx_WireFormatMessage.h>
@@ -191,7 +191,7 @@ struct vegas_session {
 
     struct fc_window_entry window[FC_MAX_CWND];
 
-    PARCEventTimer *tick_event;
+    RtaTimer *tick_event;
 
     // we will generate Interests with the same version as was received to start the session.
     // Will also use the same lifetime settings as the original Interest.
@@ -918,7 +918,7 @@ vegasSession_SetTimer(VegasSession *session, ticks tick_delay)
     timeout.tv_usec = (int) (usec - timeout.tv_sec * usec_per_sec);
 
     // this replaces any prior events
-    parcEventTimer_Start(session->tick_event, &timeout);
+    rtaTimer_Start(session->tick_event, &timeout);
 
     if (rtaLogger_IsLoggable(rtaFramework_GetLogger(session->parent_framework), RtaLoggerFacility_Flowcontrol, PARCLogLevel_Debug)) {
         rtaLogger_Log(rtaFramework_GetLogger(session->parent_framework), RtaLoggerFacility_Flowcontrol, PARCLogLevel_Debug, __func__,
@@ -977,7 +977,7 @@ vegasSession_Create(VegasConnectionState *fc, RtaConnection *conn, CCNxName *bas
     }
     session->parent_fc = fc;
 
-    session->tick_event = parcEventTimer_Create(rtaFramework_GetEventScheduler(session->parent_framework), 0, vegasSession_TimerCallback, (void *) session);
+    session->tick_event = rtaTimer_Create(session->parent_framework, 0, vegasSession_TimerCallback, (void *) session);
 
     session->starting_segnum = 0;
     session->current_cwnd = FC_INIT_CWND;
@@ -1056,7 +1056,7 @@ vegasSession_Destroy(VegasSession **sessionPtr)
 
     vegasSession_Close(session);
 
-    parcEventTimer_Destroy(&(session->tick_event));
+    rtaTimer_Destroy(&(session->tick_event));
     parcMemory_Deallocate((void **) &session);
     sessionPtr = NULL;
 }
@@ -1248,7 +1248,7 @@ vegasSession_SendMoreInterests(VegasSession *session, struct fc_window_entry *en
                           session->final_segnum);
         }
 
-        parcEventTimer_Stop(session->tick_event);
+        rtaTimer_Stop(session->tick_event);
         vegas_EndSession(session->parent_fc, session);
     }
     // else session->starting_segnum == session->final_segnum, we're not done yet.
@@ -1343,6 +1343,13 @@ vegasSession_ReceiveContentObject(VegasSession *session, TransportMessage *tm)
         return -1;
     }
 
+    // The segment number only needs the name.  Decode the rest now that we know we keep the object.
+    if (!transportMessage_CompleteDecode(tm)) {
+        transportMessage_Destroy(&tm);
+        return -1;
+    }
+    contentObjectDictionary = transportMessage_GetDictionary(tm);
+
     // Update our idea of the final chunk number.  This must be done
     // before running the algorithm because session->final_segnum is used
     // to decide if we're done.
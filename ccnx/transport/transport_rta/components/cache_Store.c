@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_CryptoHash.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/internal/ccnx_ValidationFacadeV1.h>
+
+#include "cache_Store.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+#define MIN_BUCKETS 16
+
+typedef struct cache_entry {
+    uint64_t nameHash;
+    CCNxTlvDictionary *contentObject;
+
+    // the name and keyid are owned by contentObject
+    const CCNxName *name;
+    const PARCBuffer *keyId;
+    size_t wireLength;
+
+    bool hasExpiryTime;
+    uint64_t expiryTime;
+
+    // SHA-256 of the object, computed in cacheStore_Put.  Hashing positions the shared
+    // wire format buffer, so it must happen before the object goes up to the API thread.
+    PARCBuffer *objectHash;
+
+    LIST_ENTRY(cache_entry) bucketList;
+    TAILQ_ENTRY(cache_entry) lruList;
+} CacheEntry;
+
+LIST_HEAD(cache_bucket, cache_entry);
+
+struct cache_store {
+    size_t maxObjects;
+    size_t maxBytes;
+
+    size_t objectCount;
+    size_t byteCount;
+
+    // bucketCount is a power of 2
+    size_t bucketCount;
+    struct cache_bucket *buckets;
+
+    // head is most recently used, tail is the eviction candidate
+    TAILQ_HEAD(cache_lru, cache_entry) lruHead;
+
+    CacheStoreStats stats;
+};
+
+// ==================
+
+static size_t
+_cacheStore_BucketCount(size_t maxObjects)
+{
+    size_t count = MIN_BUCKETS;
+    while (count < maxObjects) {
+        count <<= 1;
+    }
+    return count;
+}
+
+static struct cache_bucket *
+_cacheStore_GetBucket(CacheStore *store, uint64_t nameHash)
+{
+    return &store->buckets[nameHash & (store->bucketCount - 1)];
+}
+
+static void
+_cacheStore_RemoveEntry(CacheStore *store, CacheEntry *entry)
+{
+    LIST_REMOVE(entry, bucketList);
+    TAILQ_REMOVE(&store->lruHead, entry, lruList);
+
+    store->objectCount--;
+    store->byteCount -= entry->wireLength;
+
+    if (entry->objectHash) {
+        parcBuffer_Release(&entry->objectHash);
+    }
+    ccnxTlvDictionary_Release(&entry->contentObject);
+    parcMemory_Deallocate((void **) &entry);
+}
+
+static void
+_cacheStore_MakeRoom(CacheStore *store, size_t wireLength)
+{
+    while (store->objectCount > 0 &&
+           (store->objectCount >= store->maxObjects || store->byteCount + wireLength > store->maxBytes)) {
+        CacheEntry *victim = TAILQ_LAST(&store->lruHead, cache_lru);
+        _cacheStore_RemoveEntry(store, victim);
+        store->stats.evictions++;
+    }
+}
+
+static bool
+_cacheStore_IsExpired(const CacheEntry *entry, uint64_t nowMillis)
+{
+    return entry->hasExpiryTime && entry->expiryTime <= nowMillis;
+}
+
+static bool
+_cacheStore_KeyIdEquals(const PARCBuffer *a, const PARCBuffer *b)
+{
+    if (a == NULL || b == NULL) {
+        return a == b;
+    }
+    return parcBuffer_Equals(a, b);
+}
+
+static PARCBuffer *
+_cacheStore_CreateObjectHash(CCNxTlvDictionary *contentObject)
+{
+    PARCBuffer *objectHash = NULL;
+    PARCCryptoHash *hash = ccnxWireFormatMessage_CreateContentObjectHash(contentObject);
+    if (hash != NULL) {
+        objectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
+        parcCryptoHash_Release(&hash);
+    }
+    return objectHash;
+}
+
+static bool
+_cacheStore_EntryMatches(CacheEntry *entry, const CCNxName *name, uint64_t nameHash,
+                         const PARCBuffer *keyIdRestriction, const PARCBuffer *hashRestriction)
+{
+    if (entry->nameHash != nameHash || !ccnxName_Equals(entry->name, name)) {
+        return false;
+    }
+
+    if (keyIdRestriction != NULL && !_cacheStore_KeyIdEquals(entry->keyId, keyIdRestriction)) {
+        return false;
+    }
+
+    if (hashRestriction != NULL) {
+        if (entry->objectHash == NULL || !parcBuffer_Equals(entry->objectHash, hashRestriction)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ==================
+
+CacheStore *
+cacheStore_Create(size_t maxObjects, size_t maxBytes)
+{
+    assertTrue(maxObjects > 0, "Parameter maxObjects must be positive");
+    assertTrue(maxBytes > 0, "Parameter maxBytes must be positive");
+
+    CacheStore *store = parcMemory_AllocateAndClear(sizeof(CacheStore));
+    assertNotNull(store, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(CacheStore));
+
+    store->maxObjects = maxObjects;
+    store->maxBytes = maxBytes;
+    store->bucketCount = _cacheStore_BucketCount(maxObjects);
+
+    store->buckets = parcMemory_AllocateAndClear(store->bucketCount * sizeof(struct cache_bucket));
+    assertNotNull(store->buckets, "parcMemory_AllocateAndClear(%zu) returned NULL", store->bucketCount * sizeof(struct cache_bucket));
+
+    for (size_t i = 0; i < store->bucketCount; i++) {
+        LIST_INIT(&store->buckets[i]);
+    }
+    TAILQ_INIT(&store->lruHead);
+
+    return store;
+}
+
+void
+cacheStore_Destroy(CacheStore **storePtr)
+{
+    assertNotNull(storePtr, "Parameter storePtr must be non-null");
+    CacheStore *store = *storePtr;
+    assertNotNull(store, "Parameter storePtr must dereference to non-null");
+
+    while (!TAILQ_EMPTY(&store->lruHead)) {
+        _cacheStore_RemoveEntry(store, TAILQ_FIRST(&store->lruHead));
+    }
+
+    parcMemory_Deallocate((void **) &store->buckets);
+    parcMemory_Deallocate((void **) &store);
+    *storePtr = NULL;
+}
+
+bool
+cacheStore_Put(CacheStore *store, CCNxTlvDictionary *contentObject, uint64_t nowMillis)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    assertNotNull(contentObject, "Parameter contentObject must be non-null");
+
+    const CCNxName *name = ccnxContentObject_GetName(contentObject);
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(contentObject);
+    if (name == NULL || wireFormat == NULL) {
+        return false;
+    }
+
+    size_t wireLength = parcBuffer_Limit(wireFormat);
+    if (wireLength > store->maxBytes) {
+        return false;
+    }
+
+    bool hasExpiryTime = ccnxContentObject_HasExpiryTime(contentObject);
+    uint64_t expiryTime = hasExpiryTime ? ccnxContentObject_GetExpiryTime(contentObject) : 0;
+    if (hasExpiryTime && expiryTime <= nowMillis) {
+        return false;
+    }
+
+    const PARCBuffer *keyId = ccnxValidationFacadeV1_GetKeyId(contentObject);
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct cache_bucket *bucket = _cacheStore_GetBucket(store, nameHash);
+
+    // A re-fetch of the same object replaces the old entry
+    CacheEntry *entry;
+    LIST_FOREACH(entry, bucket, bucketList)
+    {
+        if (entry->nameHash == nameHash && entry->wireLength == wireLength &&
+            ccnxName_Equals(entry->name, name) && _cacheStore_KeyIdEquals(entry->keyId, keyId)) {
+            _cacheStore_RemoveEntry(store, entry);
+            break;
+        }
+    }
+
+    _cacheStore_MakeRoom(store, wireLength);
+
+    entry = parcMemory_AllocateAndClear(sizeof(CacheEntry));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(CacheEntry));
+
+    entry->nameHash = nameHash;
+    entry->contentObject = ccnxTlvDictionary_Acquire(contentObject);
+    entry->name = name;
+    entry->keyId = keyId;
+    entry->wireLength = wireLength;
+    entry->hasExpiryTime = hasExpiryTime;
+    entry->expiryTime = expiryTime;
+    entry->objectHash = _cacheStore_CreateObjectHash(contentObject);
+
+    LIST_INSERT_HEAD(bucket, entry, bucketList);
+    TAILQ_INSERT_HEAD(&store->lruHead, entry, lruList);
+
+    store->objectCount++;
+    store->byteCount += wireLength;
+    store->stats.inserts++;
+
+    if (DEBUG_OUTPUT) {
+        printf("%s store %p entry %p hash %016" PRIX64 " length %zu count %zu bytes %zu\n",
+               __func__, (void *) store, (void *) entry, nameHash, wireLength, store->objectCount, store->byteCount);
+    }
+
+    return true;
+}
+
+CCNxTlvDictionary *
+cacheStore_Match(CacheStore *store, const CCNxTlvDictionary *interest, uint64_t nowMillis)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    assertNotNull(interest, "Parameter interest must be non-null");
+
+    store->stats.lookups++;
+
+    const CCNxName *name = ccnxInterest_GetName(interest);
+    if (name == NULL) {
+        return NULL;
+    }
+
+    const PARCBuffer *keyIdRestriction = ccnxInterest_GetKeyIdRestriction(interest);
+    const PARCBuffer *hashRestriction = ccnxInterest_GetContentObjectHashRestriction(interest);
+
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct cache_bucket *bucket = _cacheStore_GetBucket(store, nameHash);
+
+    CacheEntry *entry = LIST_FIRST(bucket);
+    while (entry != NULL) {
+        CacheEntry *next = LIST_NEXT(entry, bucketList);
+
+        if (_cacheStore_IsExpired(entry, nowMillis)) {
+            _cacheStore_RemoveEntry(store, entry);
+            store->stats.expirations++;
+        } else if (_cacheStore_EntryMatches(entry, name, nameHash, keyIdRestriction, hashRestriction)) {
+            TAILQ_REMOVE(&store->lruHead, entry, lruList);
+            TAILQ_INSERT_HEAD(&store->lruHead, entry, lruList);
+
+            store->stats.hits++;
+            store->stats.bytesServed += entry->wireLength;
+            return ccnxTlvDictionary_Acquire(entry->contentObject);
+        }
+
+        entry = next;
+    }
+
+    return NULL;
+}
+
+size_t
+cacheStore_Count(const CacheStore *store)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    return store->objectCount;
+}
+
+size_t
+cacheStore_Bytes(const CacheStore *store)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    return store->byteCount;
+}
+
+const CacheStoreStats *
+cacheStore_GetStats(const CacheStore *store)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    return &store->stats;
+}
+
+double
+cacheStore_GetHitRatio(const CacheStore *store)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+    if (store->stats.lookups == 0) {
+        return 0.0;
+    }
+    return (double) store->stats.hits / (double) store->stats.lookups;
+}
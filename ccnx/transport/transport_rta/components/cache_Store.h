@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file cache_Store.h
+ * @brief A size-bounded, name-hashed LRU store of Content Objects
+ *
+ * The store holds references to decoded Content Object dictionaries (which also
+ * carry their wire format).  Entries are indexed by the hash of the name in a
+ * power-of-two bucket array and kept on an LRU list.  The store is bounded by
+ * both the number of objects and the total number of wire format bytes.  When
+ * either bound would be exceeded, the least recently used entries are evicted.
+ *
+ * A Content Object matches an Interest if the names are equal, the KeyId restriction
+ * (if any) equals the object's KeyId, and the ContentObjectHash restriction (if any)
+ * equals the SHA-256 hash of the object.  Objects past their ExpiryTime are never
+ * returned and are removed on lookup.
+ *
+ * The store is not thread safe.  It is meant to be used only from the RTA framework thread.
+ * The dictionaries it holds are the same instances the application receives, so after
+ * `cacheStore_Put()` the store only reads them.  Everything that touches the dictionary,
+ * such as the ContentObjectHash, is computed in `cacheStore_Put()` while the RTA thread
+ * still owns the message.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_cache_Store_h
+#define Libccnx_cache_Store_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ccnx/common/internal/ccnx_TlvDictionary.h>
+
+struct cache_store;
+typedef struct cache_store CacheStore;
+
+/**
+ * Counters kept by the store.  They are cumulative over the life of the store.
+ */
+typedef struct cache_store_stats {
+    uint64_t lookups;       // number of calls to cacheStore_Match
+    uint64_t hits;          // number of lookups that returned an object
+    uint64_t bytesServed;   // wire format bytes of the objects returned
+    uint64_t inserts;       // objects put in the store
+    uint64_t evictions;     // objects removed to make room
+    uint64_t expirations;   // objects removed because they were past their ExpiryTime
+} CacheStoreStats;
+
+/**
+ * Create a content store
+ *
+ * @param [in] maxObjects The maximum number of objects to hold (must be positive)
+ * @param [in] maxBytes The maximum number of wire format bytes to hold (must be positive)
+ *
+ * @return non-null An allocated store, destroy with `cacheStore_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     CacheStore *store = cacheStore_Create(1000, 1024 * 1024);
+ *     cacheStore_Destroy(&store);
+ * }
+ * @endcode
+ */
+CacheStore *cacheStore_Create(size_t maxObjects, size_t maxBytes);
+
+/**
+ * Destroys the store and releases every held Content Object
+ *
+ * @param [in,out] storePtr Pointer to the store, will be NULL'd
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void cacheStore_Destroy(CacheStore **storePtr);
+
+/**
+ * Put a decoded Content Object in the store
+ *
+ * The store acquires its own reference to the dictionary and computes its
+ * ContentObjectHash, so call it before the message goes up the stack.  An existing entry
+ * with the same name, KeyId, and wire format length is replaced.  Objects without
+ * a name, without a wire format, or past their ExpiryTime are not stored.
+ *
+ * @param [in] store The content store
+ * @param [in] contentObject A decoded Content Object dictionary with its wire format
+ * @param [in] nowMillis The current UTC time in milliseconds, used for ExpiryTime
+ *
+ * @return true The object was stored
+ * @return false The object was not cacheable
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool cacheStore_Put(CacheStore *store, CCNxTlvDictionary *contentObject, uint64_t nowMillis);
+
+/**
+ * Find a Content Object that satisfies the Interest
+ *
+ * On a hit, the entry becomes the most recently used.
+ *
+ * @param [in] store The content store
+ * @param [in] interest A decoded Interest dictionary
+ * @param [in] nowMillis The current UTC time in milliseconds, used for ExpiryTime
+ *
+ * @return non-null A new reference to the matching Content Object, release with `ccnxTlvDictionary_Release()`
+ * @return null No object in the store satisfies the Interest
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxTlvDictionary *cacheStore_Match(CacheStore *store, const CCNxTlvDictionary *interest, uint64_t nowMillis);
+
+/**
+ * The number of objects in the store
+ */
+size_t cacheStore_Count(const CacheStore *store);
+
+/**
+ * The number of wire format bytes held by the store
+ */
+size_t cacheStore_Bytes(const CacheStore *store);
+
+/**
+ * Returns the cumulative counters of the store.  Do not free it.
+ */
+const CacheStoreStats *cacheStore_GetStats(const CacheStore *store);
+
+/**
+ * The fraction of lookups that were hits, in the range [0.0, 1.0]
+ *
+ * @return 0.0 if there have been no lookups
+ */
+double cacheStore_GetHitRatio(const CacheStore *store);
+#endif // Libccnx_cache_Store_h
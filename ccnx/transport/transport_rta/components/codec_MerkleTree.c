@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_CryptoHasher.h>
+
+#include "codec_MerkleTree.h"
+
+static const uint8_t leafPrefix = 0x00;
+static const uint8_t nodePrefix = 0x01;
+
+// leafIndex and leafCount
+static const size_t proofHeaderLength = 2 * sizeof(uint32_t);
+
+static const uint8_t batchMagic[CODEC_MERKLE_BATCH_MAGIC_LENGTH] = { 'M', 'R', 'K', '1' };
+
+/*
+ * level[0] holds the hashed leaves, level[levelCount - 1] holds only the root.
+ * Each level is an array of width[i] digests.
+ */
+struct codec_merkle_tree {
+    size_t leafCount;
+    size_t levelCount;
+    size_t *width;
+    uint8_t **level;
+    PARCBuffer *root;
+};
+
+// ==================
+
+static void
+_codecMerkleTree_HashLeaf(uint8_t *output, const uint8_t *leaf)
+{
+    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+    parcCryptoHasher_Init(hasher);
+    parcCryptoHasher_UpdateBytes(hasher, &leafPrefix, 1);
+    parcCryptoHasher_UpdateBytes(hasher, leaf, CODEC_MERKLE_DIGEST_LENGTH);
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+
+    memcpy(output, parcBuffer_Overlay(parcCryptoHash_GetDigest(hash), 0), CODEC_MERKLE_DIGEST_LENGTH);
+
+    parcCryptoHash_Release(&hash);
+    parcCryptoHasher_Release(&hasher);
+}
+
+static void
+_codecMerkleTree_HashNode(uint8_t *output, const uint8_t *left, const uint8_t *right)
+{
+    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+    parcCryptoHasher_Init(hasher);
+    parcCryptoHasher_UpdateBytes(hasher, &nodePrefix, 1);
+    parcCryptoHasher_UpdateBytes(hasher, left, CODEC_MERKLE_DIGEST_LENGTH);
+    parcCryptoHasher_UpdateBytes(hasher, right, CODEC_MERKLE_DIGEST_LENGTH);
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+
+    memcpy(output, parcBuffer_Overlay(parcCryptoHash_GetDigest(hash), 0), CODEC_MERKLE_DIGEST_LENGTH);
+
+    parcCryptoHash_Release(&hash);
+    parcCryptoHasher_Release(&hasher);
+}
+
+static size_t
+_codecMerkleTree_LevelCount(size_t leafCount)
+{
+    size_t levelCount = 1;
+    for (size_t width = leafCount; width > 1; width = (width + 1) / 2) {
+        levelCount++;
+    }
+    return levelCount;
+}
+
+// ==================
+
+CodecMerkleTree *
+codecMerkleTree_Create(size_t leafCount, PARCBuffer *leaves[])
+{
+    assertTrue(leafCount > 0, "Parameter leafCount must be positive");
+    assertTrue(leafCount <= UINT32_MAX, "Parameter leafCount must fit in 32 bits, got %zu", leafCount);
+    assertNotNull(leaves, "Parameter leaves must be non-null");
+
+    CodecMerkleTree *tree = parcMemory_AllocateAndClear(sizeof(CodecMerkleTree));
+    assertNotNull(tree, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(CodecMerkleTree));
+
+    tree->leafCount = leafCount;
+    tree->levelCount = _codecMerkleTree_LevelCount(leafCount);
+    tree->width = parcMemory_AllocateAndClear(tree->levelCount * sizeof(size_t));
+    tree->level = parcMemory_AllocateAndClear(tree->levelCount * sizeof(uint8_t *));
+    assertTrue(tree->width != NULL && tree->level != NULL, "parcMemory_AllocateAndClear returned NULL");
+
+    tree->width[0] = leafCount;
+    tree->level[0] = parcMemory_Allocate(leafCount * CODEC_MERKLE_DIGEST_LENGTH);
+    assertNotNull(tree->level[0], "parcMemory_Allocate(%zu) returned NULL", leafCount * CODEC_MERKLE_DIGEST_LENGTH);
+
+    for (size_t i = 0; i < leafCount; i++) {
+        assertTrue(parcBuffer_Remaining(leaves[i]) == CODEC_MERKLE_DIGEST_LENGTH,
+                   "Leaf %zu has length %zu, expected %d", i, parcBuffer_Remaining(leaves[i]), CODEC_MERKLE_DIGEST_LENGTH);
+        uint8_t *leaf = parcBuffer_Overlay(leaves[i], 0);
+        _codecMerkleTree_HashLeaf(tree->level[0] + i * CODEC_MERKLE_DIGEST_LENGTH, leaf);
+    }
+
+    for (size_t k = 1; k < tree->levelCount; k++) {
+        size_t below = tree->width[k - 1];
+        tree->width[k] = (below + 1) / 2;
+        tree->level[k] = parcMemory_Allocate(tree->width[k] * CODEC_MERKLE_DIGEST_LENGTH);
+        assertNotNull(tree->level[k], "parcMemory_Allocate(%zu) returned NULL", tree->width[k] * CODEC_MERKLE_DIGEST_LENGTH);
+
+        for (size_t i = 0; i < tree->width[k]; i++) {
+            uint8_t *output = tree->level[k] + i * CODEC_MERKLE_DIGEST_LENGTH;
+            const uint8_t *left = tree->level[k - 1] + 2 * i * CODEC_MERKLE_DIGEST_LENGTH;
+            if (2 * i + 1 < below) {
+                _codecMerkleTree_HashNode(output, left, left + CODEC_MERKLE_DIGEST_LENGTH);
+            } else {
+                // the odd node out moves up unchanged
+                memcpy(output, left, CODEC_MERKLE_DIGEST_LENGTH);
+            }
+        }
+    }
+
+    tree->root = parcBuffer_Wrap(tree->level[tree->levelCount - 1], CODEC_MERKLE_DIGEST_LENGTH, 0, CODEC_MERKLE_DIGEST_LENGTH);
+    return tree;
+}
+
+void
+codecMerkleTree_Destroy(CodecMerkleTree **treePtr)
+{
+    assertNotNull(treePtr, "Parameter treePtr must be non-null");
+    CodecMerkleTree *tree = *treePtr;
+    assertNotNull(tree, "Parameter treePtr must dereference to non-null");
+
+    parcBuffer_Release(&tree->root);
+    for (size_t k = 0; k < tree->levelCount; k++) {
+        parcMemory_Deallocate((void **) &tree->level[k]);
+    }
+    parcMemory_Deallocate((void **) &tree->level);
+    parcMemory_Deallocate((void **) &tree->width);
+    parcMemory_Deallocate((void **) &tree);
+    *treePtr = NULL;
+}
+
+size_t
+codecMerkleTree_GetLeafCount(const CodecMerkleTree *tree)
+{
+    assertNotNull(tree, "Parameter tree must be non-null");
+    return tree->leafCount;
+}
+
+PARCBuffer *
+codecMerkleTree_GetRoot(const CodecMerkleTree *tree)
+{
+    assertNotNull(tree, "Parameter tree must be non-null");
+    return tree->root;
+}
+
+PARCBuffer *
+codecMerkleTree_CreateProof(const CodecMerkleTree *tree, size_t leafIndex)
+{
+    assertNotNull(tree, "Parameter tree must be non-null");
+    assertTrue(leafIndex < tree->leafCount, "Leaf index %zu out of range, leaf count %zu", leafIndex, tree->leafCount);
+
+    PARCBuffer *proof = parcBuffer_Allocate(proofHeaderLength + (tree->levelCount - 1) * CODEC_MERKLE_DIGEST_LENGTH);
+    parcBuffer_PutUint32(proof, (uint32_t) leafIndex);
+    parcBuffer_PutUint32(proof, (uint32_t) tree->leafCount);
+
+    size_t index = leafIndex;
+    for (size_t k = 0; k < tree->levelCount - 1; k++) {
+        size_t sibling = index ^ 1;
+        if (sibling < tree->width[k]) {
+            parcBuffer_PutArray(proof, CODEC_MERKLE_DIGEST_LENGTH, tree->level[k] + sibling * CODEC_MERKLE_DIGEST_LENGTH);
+        }
+        index >>= 1;
+    }
+
+    return parcBuffer_Flip(proof);
+}
+
+PARCBuffer *
+codecMerkleTree_CreateRootFromProof(PARCBuffer *leaf, PARCBuffer *proof)
+{
+    assertNotNull(leaf, "Parameter leaf must be non-null");
+    assertNotNull(proof, "Parameter proof must be non-null");
+
+    if (parcBuffer_Remaining(leaf) != CODEC_MERKLE_DIGEST_LENGTH || parcBuffer_Remaining(proof) < proofHeaderLength) {
+        return NULL;
+    }
+
+    size_t index = parcBuffer_GetUint32(proof);
+    size_t width = parcBuffer_GetUint32(proof);
+    if (width == 0 || index >= width) {
+        return NULL;
+    }
+
+    uint8_t current[CODEC_MERKLE_DIGEST_LENGTH];
+    _codecMerkleTree_HashLeaf(current, parcBuffer_Overlay(leaf, 0));
+
+    for (; width > 1; width = (width + 1) / 2, index >>= 1) {
+        size_t sibling = index ^ 1;
+        if (sibling < width) {
+            if (parcBuffer_Remaining(proof) < CODEC_MERKLE_DIGEST_LENGTH) {
+                return NULL;
+            }
+            uint8_t *siblingDigest = parcBuffer_Overlay(proof, CODEC_MERKLE_DIGEST_LENGTH);
+            if (index & 1) {
+                _codecMerkleTree_HashNode(current, siblingDigest, current);
+            } else {
+                _codecMerkleTree_HashNode(current, current, siblingDigest);
+            }
+        }
+    }
+
+    PARCBuffer *root = parcBuffer_Allocate(CODEC_MERKLE_DIGEST_LENGTH);
+    parcBuffer_PutArray(root, CODEC_MERKLE_DIGEST_LENGTH, current);
+    return parcBuffer_Flip(root);
+}
+
+bool
+codecMerkleTree_VerifyProof(PARCBuffer *leaf, PARCBuffer *proof, PARCBuffer *root)
+{
+    assertNotNull(root, "Parameter root must be non-null");
+
+    PARCBuffer *computed = codecMerkleTree_CreateRootFromProof(leaf, proof);
+    if (computed == NULL) {
+        return false;
+    }
+
+    bool success = parcBuffer_Remaining(root) == CODEC_MERKLE_DIGEST_LENGTH &&
+                   memcmp(parcBuffer_Overlay(computed, 0), parcBuffer_Overlay(root, 0), CODEC_MERKLE_DIGEST_LENGTH) == 0;
+    parcBuffer_Release(&computed);
+    return success;
+}
+
+PARCBuffer *
+codecMerkleTree_CreateBatchPayload(const CodecMerkleTree *tree, size_t leafIndex, PARCBuffer *rootSignature)
+{
+    assertNotNull(rootSignature, "Parameter rootSignature must be non-null");
+
+    PARCBuffer *proof = codecMerkleTree_CreateProof(tree, leafIndex);
+    PARCBuffer *payload = parcBuffer_Allocate(CODEC_MERKLE_BATCH_MAGIC_LENGTH + parcBuffer_Remaining(proof) + parcBuffer_Remaining(rootSignature));
+    parcBuffer_PutArray(payload, CODEC_MERKLE_BATCH_MAGIC_LENGTH, batchMagic);
+    parcBuffer_PutBuffer(payload, proof);
+    parcBuffer_PutArray(payload, parcBuffer_Remaining(rootSignature), parcBuffer_Overlay(rootSignature, 0));
+    parcBuffer_Release(&proof);
+    return parcBuffer_Flip(payload);
+}
+
+bool
+codecMerkleTree_IsBatchPayload(const PARCBuffer *payload)
+{
+    assertNotNull(payload, "Parameter payload must be non-null");
+
+    if (parcBuffer_Remaining(payload) < CODEC_MERKLE_BATCH_MAGIC_LENGTH) {
+        return false;
+    }
+    for (size_t i = 0; i < CODEC_MERKLE_BATCH_MAGIC_LENGTH; i++) {
+        if (parcBuffer_GetAtIndex(payload, parcBuffer_Position(payload) + i) != batchMagic[i]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file codec_MerkleTree.h
+ * @brief A SHA-256 Merkle tree over a batch of packet digests
+ *
+ * The TLV codec can sign a batch of Content Objects with one public key operation.  It
+ * builds a Merkle tree over the digests of the objects, signs the root, and gives each
+ * object an inclusion proof that leads from its own digest to the root.
+ *
+ * Leaves are hashed as H(0x00 || digest) and interior nodes as H(0x01 || left || right),
+ * so a leaf can never be passed off as an interior node.  When a level has an odd number
+ * of nodes, the last one moves up a level unchanged.
+ *
+ * A proof is self-delimiting, so it may be followed by other bytes (the root signature):
+ *
+ *   uint32_t leafIndex    (network byte order)
+ *   uint32_t leafCount    (network byte order)
+ *   32 bytes per level where the node has a sibling, from the leaves up
+ *
+ * Batch signatures are an extension, not one of the CCNx validation algorithms.  A Content
+ * Object signed in a batch keeps the signer's crypto suite and KeyId, so a verifier finds
+ * the key as usual, but its ValidationPayload is
+ *
+ *   4 bytes "MRK1"        marks the payload as a batch signature
+ *   the proof
+ *   the root signature    what the crypto suite makes of the root digest
+ *
+ * The leaf of a Content Object is SHA-256 over its CCNx message TLV, i.e. the packet without
+ * the fixed header and without the validation sections.  Only a verifier that knows the
+ * extension (component_Verify.c) can check a batched object, so the codec only batches when
+ * the stack configuration accepts that (see `tlvCodec_SetBatchSigning()`).
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_codec_MerkleTree_h
+#define Libccnx_codec_MerkleTree_h
+
+#include <stdbool.h>
+#include <parc/algol/parc_Buffer.h>
+
+struct codec_merkle_tree;
+typedef struct codec_merkle_tree CodecMerkleTree;
+
+/**
+ * The length of every digest in the tree
+ */
+#define CODEC_MERKLE_DIGEST_LENGTH 32
+
+/**
+ * The length of the mark at the start of a batch ValidationPayload
+ */
+#define CODEC_MERKLE_BATCH_MAGIC_LENGTH 4
+
+/**
+ * Build a tree over a batch of leaf digests
+ *
+ * @param [in] leafCount The number of leaves, at least 1
+ * @param [in] leaves Array of `leafCount` SHA-256 digests, each from its position to its limit
+ *
+ * @return non-null An allocated tree, destroy with `codecMerkleTree_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     CodecMerkleTree *tree = codecMerkleTree_Create(count, digests);
+ *     PARCBuffer *root = codecMerkleTree_GetRoot(tree);
+ *     PARCBuffer *proof = codecMerkleTree_CreateProof(tree, 0);
+ *     ...
+ *     parcBuffer_Release(&proof);
+ *     codecMerkleTree_Destroy(&tree);
+ * }
+ * @endcode
+ */
+CodecMerkleTree *codecMerkleTree_Create(size_t leafCount, PARCBuffer *leaves[]);
+
+/**
+ * Destroy the tree
+ *
+ * @param [in,out] treePtr Pointer to the tree, will be NULL'd
+ */
+void codecMerkleTree_Destroy(CodecMerkleTree **treePtr);
+
+/**
+ * The number of leaves in the tree
+ */
+size_t codecMerkleTree_GetLeafCount(const CodecMerkleTree *tree);
+
+/**
+ * The root of the tree
+ *
+ * @return non-null A buffer owned by the tree.  Acquire it to keep it after the tree is destroyed.
+ */
+PARCBuffer *codecMerkleTree_GetRoot(const CodecMerkleTree *tree);
+
+/**
+ * Create the inclusion proof of one leaf
+ *
+ * @param [in] tree The tree
+ * @param [in] leafIndex The leaf, less than the leaf count
+ *
+ * @return non-null A flipped buffer with the proof, release with `parcBuffer_Release()`
+ */
+PARCBuffer *codecMerkleTree_CreateProof(const CodecMerkleTree *tree, size_t leafIndex);
+
+/**
+ * Check that a leaf digest and a proof lead to a root
+ *
+ * Reads the proof from `proof`'s position.  On success the position is left just past the
+ * proof, which is where a caller finds whatever was appended to it.
+ *
+ * @param [in] leaf The leaf digest, from its position to its limit
+ * @param [in] proof A buffer starting with a proof made by `codecMerkleTree_CreateProof()`
+ * @param [in] root The expected root
+ *
+ * @return true The proof is well formed and leads from `leaf` to `root`
+ * @return false Otherwise
+ */
+bool codecMerkleTree_VerifyProof(PARCBuffer *leaf, PARCBuffer *proof, PARCBuffer *root);
+
+/**
+ * Compute the root a leaf digest and a proof lead to
+ *
+ * Reads the proof from `proof`'s position.  On success the position is left just past the
+ * proof.
+ *
+ * @param [in] leaf The leaf digest, from its position to its limit
+ * @param [in] proof A buffer starting with a proof made by `codecMerkleTree_CreateProof()`
+ *
+ * @return non-null The root, release with `parcBuffer_Release()`
+ * @return null The leaf or the proof is malformed
+ */
+PARCBuffer *codecMerkleTree_CreateRootFromProof(PARCBuffer *leaf, PARCBuffer *proof);
+
+/**
+ * Create the ValidationPayload of one object in a batch: the mark, its proof and the root signature
+ *
+ * @param [in] tree The tree
+ * @param [in] leafIndex The object's leaf, less than the leaf count
+ * @param [in] rootSignature The signature of the root, from its position to its limit
+ *
+ * @return non-null A flipped buffer, release with `parcBuffer_Release()`
+ */
+PARCBuffer *codecMerkleTree_CreateBatchPayload(const CodecMerkleTree *tree, size_t leafIndex, PARCBuffer *rootSignature);
+
+/**
+ * Determine if a ValidationPayload is a batch signature
+ *
+ * @param [in] payload The ValidationPayload, from its position to its limit
+ *
+ * @return true The payload starts with the batch mark
+ * @return false Otherwise, e.g. a plain RSA or ECDSA signature
+ */
+bool codecMerkleTree_IsBatchPayload(const PARCBuffer *payload);
+#endif // Libccnx_codec_MerkleTree_h
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/common/ccnx_NameSegment.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_FixedHeader.h>
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_Types.h>
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_TlvDictionary.h>
+
+#include "codec_TlvIndex.h"
+
+// type and length
+static const size_t tlvHeaderLength = 4;
+
+struct codec_tlv_index {
+    uint8_t packetType;
+    uint16_t packetLength;
+
+    CodecTlvIndexEntry message;
+
+    bool hasValidation;
+    CodecTlvIndexEntry validationAlg;
+    CodecTlvIndexEntry validationPayload;
+
+    size_t fieldCount;
+    CodecTlvIndexEntry fields[CODEC_TLV_INDEX_MAX_FIELDS];
+};
+
+// ==================
+
+/*
+ * Reads the TLV at `offset`, which must fit before `end`
+ */
+static bool
+_codecTlvIndex_ReadTlv(const uint8_t *bytes, size_t end, size_t offset, CodecTlvIndexEntry *entry)
+{
+    if (offset + tlvHeaderLength > end) {
+        return false;
+    }
+
+    uint16_t length = (uint16_t) (bytes[offset + 2] << 8 | bytes[offset + 3]);
+    if (offset + tlvHeaderLength + length > end) {
+        return false;
+    }
+
+    entry->type = (uint16_t) (bytes[offset] << 8 | bytes[offset + 1]);
+    entry->offset = (uint16_t) (offset + tlvHeaderLength);
+    entry->length = length;
+    return true;
+}
+
+static size_t
+_codecTlvIndex_End(const CodecTlvIndexEntry *entry)
+{
+    return (size_t) entry->offset + entry->length;
+}
+
+static bool
+_codecTlvIndex_ReadFixedHeader(CodecTlvIndex *index, const uint8_t *bytes, size_t length, size_t *messageOffset)
+{
+    if (length < sizeof(CCNxCodecSchemaV1FixedHeader)) {
+        return false;
+    }
+
+    const CCNxCodecSchemaV1FixedHeader *header = (const CCNxCodecSchemaV1FixedHeader *) bytes;
+    if (header->version != 1) {
+        return false;
+    }
+
+    if (header->packetType != CCNxCodecSchemaV1Types_PacketType_Interest &&
+        header->packetType != CCNxCodecSchemaV1Types_PacketType_ContentObject) {
+        return false;
+    }
+
+    index->packetType = header->packetType;
+    index->packetLength = (uint16_t) (bytes[2] << 8 | bytes[3]);
+    if (index->packetLength != length) {
+        return false;
+    }
+
+    if (header->headerLength < sizeof(CCNxCodecSchemaV1FixedHeader) || header->headerLength > length) {
+        return false;
+    }
+
+    *messageOffset = header->headerLength;
+    return true;
+}
+
+static bool
+_codecTlvIndex_ReadMessage(CodecTlvIndex *index, const uint8_t *bytes, size_t length, size_t offset)
+{
+    if (!_codecTlvIndex_ReadTlv(bytes, length, offset, &index->message)) {
+        return false;
+    }
+
+    if (index->message.type != CCNxCodecSchemaV1Types_MessageType_Interest &&
+        index->message.type != CCNxCodecSchemaV1Types_MessageType_ContentObject) {
+        return false;
+    }
+
+    size_t end = _codecTlvIndex_End(&index->message);
+    size_t position = index->message.offset;
+    while (position < end) {
+        if (index->fieldCount == CODEC_TLV_INDEX_MAX_FIELDS) {
+            return false;
+        }
+
+        CodecTlvIndexEntry *field = &index->fields[index->fieldCount];
+        if (!_codecTlvIndex_ReadTlv(bytes, end, position, field)) {
+            return false;
+        }
+        index->fieldCount++;
+        position = _codecTlvIndex_End(field);
+    }
+    return true;
+}
+
+static bool
+_codecTlvIndex_ReadValidation(CodecTlvIndex *index, const uint8_t *bytes, size_t length)
+{
+    size_t position = _codecTlvIndex_End(&index->message);
+    if (position == length) {
+        return true;
+    }
+
+    if (!_codecTlvIndex_ReadTlv(bytes, length, position, &index->validationAlg) ||
+        index->validationAlg.type != CCNxCodecSchemaV1Types_MessageType_ValidationAlg) {
+        return false;
+    }
+
+    position = _codecTlvIndex_End(&index->validationAlg);
+    if (!_codecTlvIndex_ReadTlv(bytes, length, position, &index->validationPayload) ||
+        index->validationPayload.type != CCNxCodecSchemaV1Types_MessageType_ValidationPayload) {
+        return false;
+    }
+
+    index->hasValidation = true;
+    return _codecTlvIndex_End(&index->validationPayload) == length;
+}
+
+static CCNxTlvDictionary *
+_codecTlvIndex_Decode(CCNxTlvDictionary *partial, void *decodeState)
+{
+    CodecTlvIndex *index = decodeState;
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(partial);
+
+    CCNxTlvDictionary *decoded = NULL;
+    switch (index->packetType) {
+        case CCNxCodecSchemaV1Types_PacketType_Interest:
+            decoded = ccnxWireFormatMessage_FromInterestPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+            break;
+        case CCNxCodecSchemaV1Types_PacketType_ContentObject:
+            decoded = ccnxWireFormatMessage_FromContentObjectPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+            break;
+        default:
+            trapUnexpectedState("Indexed a packet of type %u", index->packetType);
+    }
+
+    if (!ccnxCodecTlvPacket_BufferDecode(wireFormat, decoded)) {
+        ccnxTlvDictionary_Release(&decoded);
+    }
+    return decoded;
+}
+
+static void
+_codecTlvIndex_FreeFunc(void **indexPtr)
+{
+    codecTlvIndex_Destroy((CodecTlvIndex **) indexPtr);
+}
+
+// ==================
+
+CodecTlvIndex *
+codecTlvIndex_Create(const PARCBuffer *wireFormat)
+{
+    assertNotNull(wireFormat, "Parameter wireFormat must be non-null");
+
+    const uint8_t *bytes = parcBuffer_Overlay((PARCBuffer *) wireFormat, 0);
+    size_t length = parcBuffer_Remaining(wireFormat);
+
+    CodecTlvIndex *index = parcMemory_AllocateAndClear(sizeof(CodecTlvIndex));
+    assertNotNull(index, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(CodecTlvIndex));
+
+    size_t messageOffset;
+    bool success = _codecTlvIndex_ReadFixedHeader(index, bytes, length, &messageOffset) &&
+                   _codecTlvIndex_ReadMessage(index, bytes, length, messageOffset) &&
+                   _codecTlvIndex_ReadValidation(index, bytes, length);
+
+    if (!success) {
+        codecTlvIndex_Destroy(&index);
+    }
+    return index;
+}
+
+void
+codecTlvIndex_Destroy(CodecTlvIndex **indexPtr)
+{
+    assertNotNull(indexPtr, "Parameter indexPtr must be non-null double pointer");
+    assertNotNull(*indexPtr, "Parameter indexPtr must dereference to non-null pointer");
+    parcMemory_Deallocate((void **) indexPtr);
+}
+
+uint8_t
+codecTlvIndex_GetPacketType(const CodecTlvIndex *index)
+{
+    return index->packetType;
+}
+
+const CodecTlvIndexEntry *
+codecTlvIndex_GetMessage(const CodecTlvIndex *index)
+{
+    return &index->message;
+}
+
+size_t
+codecTlvIndex_GetFieldCount(const CodecTlvIndex *index)
+{
+    return index->fieldCount;
+}
+
+const CodecTlvIndexEntry *
+codecTlvIndex_GetField(const CodecTlvIndex *index, size_t ordinal)
+{
+    assertTrue(ordinal < index->fieldCount, "Field %zu out of range, have %zu", ordinal, index->fieldCount);
+    return &index->fields[ordinal];
+}
+
+const CodecTlvIndexEntry *
+codecTlvIndex_FindField(const CodecTlvIndex *index, uint16_t type)
+{
+    for (size_t i = 0; i < index->fieldCount; i++) {
+        if (index->fields[i].type == type) {
+            return &index->fields[i];
+        }
+    }
+    return NULL;
+}
+
+const CodecTlvIndexEntry *
+codecTlvIndex_GetValidationAlg(const CodecTlvIndex *index)
+{
+    return index->hasValidation ? &index->validationAlg : NULL;
+}
+
+const CodecTlvIndexEntry *
+codecTlvIndex_GetValidationPayload(const CodecTlvIndex *index)
+{
+    return index->hasValidation ? &index->validationPayload : NULL;
+}
+
+CCNxName *
+codecTlvIndex_CreateName(const CodecTlvIndex *index, const PARCBuffer *wireFormat)
+{
+    const CodecTlvIndexEntry *field = codecTlvIndex_FindField(index, CCNxCodecSchemaV1Types_CCNxMessage_Name);
+    if (field == NULL) {
+        return NULL;
+    }
+
+    const uint8_t *bytes = parcBuffer_Overlay((PARCBuffer *) wireFormat, 0);
+    assertTrue(parcBuffer_Remaining(wireFormat) == index->packetLength,
+               "wireFormat is not the indexed packet, length %zu expected %u",
+               parcBuffer_Remaining(wireFormat), index->packetLength);
+
+    CCNxName *name = ccnxName_Create();
+    size_t end = _codecTlvIndex_End(field);
+    size_t position = field->offset;
+    while (position < end) {
+        CodecTlvIndexEntry segmentTlv;
+        if (!_codecTlvIndex_ReadTlv(bytes, end, position, &segmentTlv)) {
+            ccnxName_Release(&name);
+            return NULL;
+        }
+
+        PARCBuffer *value = parcBuffer_Flip(parcBuffer_CreateFromArray(bytes + segmentTlv.offset, segmentTlv.length));
+        CCNxNameSegment *segment = ccnxNameSegment_CreateTypeValue((CCNxNameLabelType) segmentTlv.type, value);
+        ccnxName_Append(name, segment);
+        ccnxNameSegment_Release(&segment);
+        parcBuffer_Release(&value);
+
+        position = _codecTlvIndex_End(&segmentTlv);
+    }
+    return name;
+}
+
+bool
+codecTlvIndex_LazyDecode(TransportMessage *tm)
+{
+    CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(tm);
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(dictionary);
+    assertNotNull(wireFormat, "Received a message without a wire format buffer");
+
+    CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+    if (index != NULL) {
+        bool indexed = true;
+        if (codecTlvIndex_FindField(index, CCNxCodecSchemaV1Types_CCNxMessage_Name) != NULL) {
+            CCNxName *name = codecTlvIndex_CreateName(index, wireFormat);
+            if (name != NULL) {
+                indexed = ccnxTlvDictionary_PutName(dictionary, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_NAME, name);
+                ccnxName_Release(&name);
+            } else {
+                indexed = false;
+            }
+        }
+
+        if (indexed) {
+            transportMessage_SetDeferredDecode(tm, _codecTlvIndex_Decode, index, _codecTlvIndex_FreeFunc);
+            return true;
+        }
+        codecTlvIndex_Destroy(&index);
+    }
+
+    // let the full decoder have the final word on anything out of the ordinary
+    return ccnxCodecTlvPacket_BufferDecode(wireFormat, dictionary);
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file codec_TlvIndex.h
+ * @brief Lazy decoding of received V1 packets
+ *
+ * Fully decoding a received packet into its dictionary costs the same whether the application
+ * reads every field or only the name and payload, or the packet is dropped along the way
+ * (e.g. Vegas discarding an old segment).  In lazy mode the TLV codec only walks the packet,
+ * records where each field is in a compact index, and decodes the name.  The rest of the
+ * dictionary is decoded from the retained wire format the first time a component calls
+ * `transportMessage_CompleteDecode()`.
+ *
+ * The index holds the fixed header, the message TLV and each of its top-level fields, and
+ * the ValidationAlg and ValidationPayload TLVs.  Offsets are from the start of the packet.
+ * Packets the index cannot describe (not an Interest or Content Object, more than
+ * CODEC_TLV_INDEX_MAX_FIELDS fields, or anything out of the ordinary) are decoded eagerly.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_codec_TlvIndex_h
+#define Libccnx_codec_TlvIndex_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <parc/algol/parc_Buffer.h>
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/common/transport_Message.h>
+
+struct codec_tlv_index;
+typedef struct codec_tlv_index CodecTlvIndex;
+
+/**
+ * The most message fields an index records
+ */
+#define CODEC_TLV_INDEX_MAX_FIELDS 16
+
+/**
+ * The location of one TLV.  `offset` is where the value starts, from the start of the packet.
+ */
+typedef struct codec_tlv_index_entry {
+    uint16_t type;
+    uint16_t offset;
+    uint16_t length;
+} CodecTlvIndexEntry;
+
+/**
+ * Walk a V1 packet and record where its fields are
+ *
+ * Does not allocate anything besides the index, and decodes nothing.
+ *
+ * @param [in] wireFormat The packet, from its position to its limit
+ *
+ * @return non-null An allocated index, destroy with `codecTlvIndex_Destroy()`
+ * @return null The packet is not an Interest or Content Object, or does not fit the index
+ *
+ * Example:
+ * @code
+ * {
+ *     CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+ *     if (index != NULL) {
+ *         const CodecTlvIndexEntry *payload = codecTlvIndex_FindField(index, CCNxCodecSchemaV1Types_CCNxMessage_Payload);
+ *         codecTlvIndex_Destroy(&index);
+ *     }
+ * }
+ * @endcode
+ */
+CodecTlvIndex *codecTlvIndex_Create(const PARCBuffer *wireFormat);
+
+/**
+ * Destroy the index
+ *
+ * @param [in,out] indexPtr Pointer to the index, will be NULL'd
+ */
+void codecTlvIndex_Destroy(CodecTlvIndex **indexPtr);
+
+/**
+ * The PacketType of the fixed header
+ */
+uint8_t codecTlvIndex_GetPacketType(const CodecTlvIndex *index);
+
+/**
+ * The message TLV (its type is the MessageType)
+ */
+const CodecTlvIndexEntry *codecTlvIndex_GetMessage(const CodecTlvIndex *index);
+
+/**
+ * The number of top-level fields in the message TLV
+ */
+size_t codecTlvIndex_GetFieldCount(const CodecTlvIndex *index);
+
+/**
+ * A top-level field of the message TLV, in packet order
+ *
+ * @param [in] index The index
+ * @param [in] ordinal Less than `codecTlvIndex_GetFieldCount()`
+ */
+const CodecTlvIndexEntry *codecTlvIndex_GetField(const CodecTlvIndex *index, size_t ordinal);
+
+/**
+ * The first top-level field of the message TLV with the given type
+ *
+ * @return non-null The field
+ * @return null The message has no such field
+ */
+const CodecTlvIndexEntry *codecTlvIndex_FindField(const CodecTlvIndex *index, uint16_t type);
+
+/**
+ * The ValidationAlg TLV
+ *
+ * @return null The packet is not signed
+ */
+const CodecTlvIndexEntry *codecTlvIndex_GetValidationAlg(const CodecTlvIndex *index);
+
+/**
+ * The ValidationPayload TLV
+ *
+ * @return null The packet is not signed
+ */
+const CodecTlvIndexEntry *codecTlvIndex_GetValidationPayload(const CodecTlvIndex *index);
+
+/**
+ * Decode only the Name field of the packet
+ *
+ * @param [in] index The index of `wireFormat`
+ * @param [in] wireFormat The packet the index was created from
+ *
+ * @return non-null The name, release with `ccnxName_Release()`
+ * @return null The message has no name
+ */
+CCNxName *codecTlvIndex_CreateName(const CodecTlvIndex *index, const PARCBuffer *wireFormat);
+
+/**
+ * Lazily decode a received packet
+ *
+ * Puts the name in the message's dictionary and defers the rest with
+ * `transportMessage_SetDeferredDecode()`.  If the packet cannot be indexed, decodes it eagerly.
+ *
+ * @param [in] tm A transport message whose dictionary holds only the wire format
+ *
+ * @return true The packet was indexed, or was eagerly decoded without error
+ * @return false The packet could not be decoded
+ *
+ * Example:
+ * @code
+ * {
+ *     if (codecTlvIndex_LazyDecode(tm)) {
+ *         rtaComponent_PutMessage(out, tm);
+ *     }
+ * }
+ * @endcode
+ */
+bool codecTlvIndex_LazyDecode(TransportMessage *tm);
+#endif // Libccnx_codec_TlvIndex_h
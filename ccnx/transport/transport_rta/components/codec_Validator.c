@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <LongBow/runtime.h>
+
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_FixedHeader.h>
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_Types.h>
+
+#include "codec_Validator.h"
+
+// type and length
+#define TLV_HEADER_LENGTH 4
+
+// offsets in the fixed header
+#define FIXED_HEADER_VERSION       0
+#define FIXED_HEADER_PACKET_TYPE   1
+#define FIXED_HEADER_PACKET_LENGTH 2
+#define FIXED_HEADER_HEADER_LENGTH 7
+
+static const char *resultStrings[] = {
+    [CodecValidatorResult_Ok]              = "Ok",
+    [CodecValidatorResult_TooShort]        = "TooShort",
+    [CodecValidatorResult_BadVersion]      = "BadVersion",
+    [CodecValidatorResult_BadPacketType]   = "BadPacketType",
+    [CodecValidatorResult_BadPacketLength] = "BadPacketLength",
+    [CodecValidatorResult_BadHeaderLength] = "BadHeaderLength",
+    [CodecValidatorResult_BadTlv]          = "BadTlv",
+};
+
+/*
+ * What to check inside a value
+ */
+typedef enum {
+    _Contents_Opaque,
+    _Contents_Message,          // fields of an Interest or Content Object
+    _Contents_Name,             // name segments
+    _Contents_ValidationAlg,    // one crypto suite TLV whose value is a list of TLVs
+    _Contents_TlvList           // a list of TLVs with opaque values
+} _Contents;
+
+// ==================
+
+/*
+ * One 16-bit load instead of two byte loads and a shift.  memcpy() because the
+ * packet has no alignment.
+ */
+static inline uint16_t
+_codecValidator_GetUint16(const uint8_t *p)
+{
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return ntohs(value);
+}
+
+static _Contents _codecValidator_ContentsOf(_Contents container, uint16_t type);
+
+/*
+ * Walks the TLVs in [offset, end), which must fill it exactly.  Recursion is bounded by
+ * the fixed nesting of _Contents (ValidationAlg -> TlvList, Message -> Name).
+ */
+static bool
+_codecValidator_WalkList(const uint8_t *packet, size_t offset, size_t end, _Contents container)
+{
+    while (offset < end) {
+        if (end - offset < TLV_HEADER_LENGTH) {
+            return false;
+        }
+
+        uint16_t type = _codecValidator_GetUint16(packet + offset);
+        size_t length = _codecValidator_GetUint16(packet + offset + 2);
+        size_t valueOffset = offset + TLV_HEADER_LENGTH;
+        if (length > end - valueOffset) {
+            return false;
+        }
+
+        _Contents contents = _codecValidator_ContentsOf(container, type);
+        if (contents != _Contents_Opaque &&
+            !_codecValidator_WalkList(packet, valueOffset, valueOffset + length, contents)) {
+            return false;
+        }
+
+        offset = valueOffset + length;
+    }
+    return true;
+}
+
+static _Contents
+_codecValidator_ContentsOf(_Contents container, uint16_t type)
+{
+    switch (container) {
+        case _Contents_Message:
+            return (type == CCNxCodecSchemaV1Types_CCNxMessage_Name) ? _Contents_Name : _Contents_Opaque;
+
+        case _Contents_ValidationAlg:
+            return _Contents_TlvList;
+
+        default:
+            return _Contents_Opaque;
+    }
+}
+
+/*
+ * The top level after the hop-by-hop headers: the message, then optionally the
+ * ValidationAlg and ValidationPayload.  Only the containers we know are walked.
+ */
+static _Contents
+_codecValidator_TopLevelContents(uint8_t packetType, uint16_t type)
+{
+    switch (type) {
+        case CCNxCodecSchemaV1Types_MessageType_Interest:
+        case CCNxCodecSchemaV1Types_MessageType_ContentObject:
+            // a control packet's message is not TLV inside
+            return (packetType == CCNxCodecSchemaV1Types_PacketType_Control) ? _Contents_Opaque : _Contents_Message;
+
+        case CCNxCodecSchemaV1Types_MessageType_ValidationAlg:
+            return _Contents_ValidationAlg;
+
+        default:
+            return _Contents_Opaque;
+    }
+}
+
+static bool
+_codecValidator_WalkTopLevel(const uint8_t *packet, size_t offset, size_t end, uint8_t packetType)
+{
+    while (offset < end) {
+        if (end - offset < TLV_HEADER_LENGTH) {
+            return false;
+        }
+
+        uint16_t type = _codecValidator_GetUint16(packet + offset);
+        size_t length = _codecValidator_GetUint16(packet + offset + 2);
+        size_t valueOffset = offset + TLV_HEADER_LENGTH;
+        if (length > end - valueOffset) {
+            return false;
+        }
+
+        _Contents contents = _codecValidator_TopLevelContents(packetType, type);
+        if (contents != _Contents_Opaque &&
+            !_codecValidator_WalkList(packet, valueOffset, valueOffset + length, contents)) {
+            return false;
+        }
+
+        offset = valueOffset + length;
+    }
+    return true;
+}
+
+static bool
+_codecValidator_IsKnownPacketType(uint8_t packetType)
+{
+    switch (packetType) {
+        case CCNxCodecSchemaV1Types_PacketType_Interest:
+        case CCNxCodecSchemaV1Types_PacketType_ContentObject:
+        case CCNxCodecSchemaV1Types_PacketType_InterestReturn:
+        case CCNxCodecSchemaV1Types_PacketType_Control:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ==================
+
+CodecValidatorResult
+codecValidator_Validate(const uint8_t *packet, size_t length)
+{
+    assertNotNull(packet, "Parameter packet must be non-null");
+
+    if (length < sizeof(CCNxCodecSchemaV1FixedHeader)) {
+        return CodecValidatorResult_TooShort;
+    }
+
+    if (packet[FIXED_HEADER_VERSION] != 1) {
+        return CodecValidatorResult_BadVersion;
+    }
+
+    uint8_t packetType = packet[FIXED_HEADER_PACKET_TYPE];
+    if (!_codecValidator_IsKnownPacketType(packetType)) {
+        return CodecValidatorResult_BadPacketType;
+    }
+
+    if (_codecValidator_GetUint16(packet + FIXED_HEADER_PACKET_LENGTH) != length) {
+        return CodecValidatorResult_BadPacketLength;
+    }
+
+    size_t headerLength = packet[FIXED_HEADER_HEADER_LENGTH];
+    if (headerLength < sizeof(CCNxCodecSchemaV1FixedHeader) || headerLength > length) {
+        return CodecValidatorResult_BadHeaderLength;
+    }
+
+    // there must be a message after the headers
+    if (headerLength == length) {
+        return CodecValidatorResult_BadTlv;
+    }
+
+    bool success = _codecValidator_WalkList(packet, sizeof(CCNxCodecSchemaV1FixedHeader), headerLength, _Contents_TlvList) &&
+                   _codecValidator_WalkTopLevel(packet, headerLength, length, packetType);
+
+    return success ? CodecValidatorResult_Ok : CodecValidatorResult_BadTlv;
+}
+
+const char *
+codecValidator_ResultToString(CodecValidatorResult result)
+{
+    if (result < 0 || result > CodecValidatorResult_BadTlv) {
+        return "Unknown";
+    }
+    return resultStrings[result];
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file codec_Validator.h
+ * @brief Structural check of a received V1 packet before anything is allocated for it
+ *
+ * The Metis connector sizes the packet buffer from the fixed header, and the TLV decoder
+ * finds a malformed length only after it has allocated a dictionary and decoded everything
+ * before it.  `codecValidator_Validate()` walks the packet once, without allocating, and
+ * checks that
+ *
+ *   - the fixed header has version 1, a known PacketType, a PacketLength equal to the bytes
+ *     read, and a HeaderLength between the fixed header and the end of the packet;
+ *   - the optional hop-by-hop headers exactly fill the space up to HeaderLength;
+ *   - the message TLV, ValidationAlg and ValidationPayload exactly fill the rest of the packet;
+ *   - the fields of an Interest or Content Object message, the segments of its Name, and
+ *     the fields of the ValidationAlg each exactly fill their container.
+ *
+ * It does not look inside other values (e.g. the JSON of a control message), so a packet
+ * that passes may still fail to decode; one that fails would never decode.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_codec_Validator_h
+#define Libccnx_codec_Validator_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    CodecValidatorResult_Ok = 0,
+    CodecValidatorResult_TooShort,          // shorter than a fixed header
+    CodecValidatorResult_BadVersion,
+    CodecValidatorResult_BadPacketType,
+    CodecValidatorResult_BadPacketLength,   // PacketLength is not the number of bytes
+    CodecValidatorResult_BadHeaderLength,
+    CodecValidatorResult_BadTlv             // a T/L runs past, or does not exactly fill, its container
+} CodecValidatorResult;
+
+/**
+ * Check the structure of a V1 packet
+ *
+ * @param [in] packet The first byte of the fixed header
+ * @param [in] length The number of bytes at `packet`
+ *
+ * @return CodecValidatorResult_Ok The packet is well formed
+ * @return other The first problem found
+ *
+ * Example:
+ * @code
+ * {
+ *     const uint8_t *bytes = parcBuffer_Overlay(packet, 0);
+ *     if (codecValidator_Validate(bytes, parcBuffer_Remaining(packet)) != CodecValidatorResult_Ok) {
+ *         // drop it
+ *     }
+ * }
+ * @endcode
+ */
+CodecValidatorResult codecValidator_Validate(const uint8_t *packet, size_t length);
+
+/**
+ * A static string naming the result, for logging
+ */
+const char *codecValidator_ResultToString(CodecValidatorResult result);
+#endif // Libccnx_codec_Validator_h
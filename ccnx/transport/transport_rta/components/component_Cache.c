@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework_Services.h>
+#include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/config/config_Cache.h>
+
+#include "component_Cache.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+static int  component_Cache_Init(RtaProtocolStack *stack);
+static int  component_Cache_Opener(RtaConnection *conn);
+static void component_Cache_Upcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static void component_Cache_Downcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static int  component_Cache_Closer(RtaConnection *conn);
+static int  component_Cache_Release(RtaProtocolStack *stack);
+
+RtaComponentOperations cache_ops = {
+    .init          = component_Cache_Init,
+    .open          = component_Cache_Opener,
+    .upcallRead    = component_Cache_Upcall_Read,
+    .upcallEvent   = NULL,
+    .downcallRead  = component_Cache_Downcall_Read,
+    .downcallEvent = NULL,
+    .close         = component_Cache_Closer,
+    .release       = component_Cache_Release,
+    .stateChange   = NULL
+};
+
+// ==================
+
+static uint64_t
+_component_Cache_NowMillis(RtaProtocolStack *stack)
+{
+    struct timeval now;
+    rtaFramework_GetTimeOfDay(rtaProtocolStack_GetFramework(stack), &now);
+    return (uint64_t) now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+static int
+component_Cache_Init(RtaProtocolStack *stack)
+{
+    PARCJSON *params = rtaProtocolStack_GetParameters(stack);
+    size_t maxObjects = localCache_GetMaxObjectsFromConfig(params);
+    size_t maxBytes = localCache_GetMaxBytesFromConfig(params);
+
+    CacheStore *store = cacheStore_Create(maxObjects, maxBytes);
+    rtaProtocolStack_SetPrivateData(stack, CACHE, store);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s stack %d store %p maxObjects %zu maxBytes %zu\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+               __func__,
+               rtaProtocolStack_GetStackId(stack),
+               (void *) store, maxObjects, maxBytes);
+    }
+
+    return 0;
+}
+
+static int
+component_Cache_Opener(RtaConnection *conn)
+{
+    // all the state is stack-wide
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, CACHE), STATS_OPENS);
+    return 0;
+}
+
+/* Read from below and send to above.  Remember every Content Object. */
+static void
+component_Cache_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, CACHE, RTA_UP);
+    CacheStore *store = rtaProtocolStack_GetPrivateData(stack, CACHE);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        RtaComponentStats *stats = rtaConnection_GetStats(conn, CACHE);
+        rtaComponentStats_Increment(stats, STATS_UPCALL_IN);
+
+        if (transportMessage_IsContentObject(tm)) {
+            // the store reads the expiry time and answers later Interests from the whole object.
+            // Put hashes the object, so it must run before the message goes up to the API thread.
+            if (!transportMessage_CompleteDecode(tm)) {
+                transportMessage_Destroy(&tm);
+                continue;
+            }
+            cacheStore_Put(store, transportMessage_GetDictionary(tm), _component_Cache_NowMillis(stack));
+        }
+
+        if (rtaComponent_PutMessage(out, tm)) {
+            rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+        }
+    }
+}
+
+/**
+ * Sends the cached Content Object up the stack on the Interest's connection
+ */
+static void
+_component_Cache_SendHit(RtaConnection *conn, CCNxTlvDictionary *contentObject, PARCEventQueue *upQueue)
+{
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(conn), rtaConnection_FreeFunc);
+
+    if (rtaComponent_PutMessage(upQueue, tm)) {
+        rtaComponentStats_Increment(rtaConnection_GetStats(conn, CACHE), STATS_UPCALL_OUT);
+    }
+}
+
+/* Read from above and send to below, unless the store answers the Interest */
+static void
+component_Cache_Downcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, CACHE, RTA_DOWN);
+    CacheStore *store = rtaProtocolStack_GetPrivateData(stack, CACHE);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        RtaComponentStats *stats = rtaConnection_GetStats(conn, CACHE);
+        rtaComponentStats_Increment(stats, STATS_DOWNCALL_IN);
+
+        CCNxTlvDictionary *hit = NULL;
+        if (transportMessage_IsInterest(tm)) {
+            hit = cacheStore_Match(store, transportMessage_GetDictionary(tm), _component_Cache_NowMillis(stack));
+        }
+
+        if (hit != NULL) {
+            if (DEBUG_OUTPUT) {
+                printf("%9" PRIu64 " %s connection %u interest %p answered from store, hit ratio %.3f\n",
+                       rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+                       __func__,
+                       rtaConnection_GetConnectionId(conn),
+                       (void *) tm,
+                       cacheStore_GetHitRatio(store));
+            }
+
+            _component_Cache_SendHit(conn, hit, rtaProtocolStack_GetPutQueue(stack, CACHE, RTA_UP));
+            ccnxTlvDictionary_Release(&hit);
+
+            // The store consumed the Interest
+            transportMessage_Destroy(&tm);
+        } else {
+            if (rtaComponent_PutMessage(out, tm)) {
+                rtaComponentStats_Increment(stats, STATS_DOWNCALL_OUT);
+            }
+        }
+    }
+}
+
+static int
+component_Cache_Closer(RtaConnection *conn)
+{
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, CACHE), STATS_CLOSES);
+    return 0;
+}
+
+static int
+component_Cache_Release(RtaProtocolStack *stack)
+{
+    CacheStore *store = rtaProtocolStack_GetPrivateData(stack, CACHE);
+
+    if (DEBUG_OUTPUT) {
+        const CacheStoreStats *stats = cacheStore_GetStats(store);
+        printf("%s stack %d lookups %" PRIu64 " hits %" PRIu64 " bytes served %" PRIu64 " evictions %" PRIu64 "\n",
+               __func__,
+               rtaProtocolStack_GetStackId(stack),
+               stats->lookups, stats->hits, stats->bytesServed, stats->evictions);
+    }
+
+    cacheStore_Destroy(&store);
+    rtaProtocolStack_SetPrivateData(stack, CACHE, NULL);
+    return 0;
+}
+
+// ==================
+
+const CacheStoreStats *
+componentCache_GetStats(RtaProtocolStack *stack)
+{
+    CacheStore *store = rtaProtocolStack_GetPrivateData(stack, CACHE);
+    if (store == NULL) {
+        return NULL;
+    }
+    return cacheStore_GetStats(store);
+}
+
+double
+componentCache_GetHitRatio(RtaProtocolStack *stack)
+{
+    CacheStore *store = rtaProtocolStack_GetPrivateData(stack, CACHE);
+    if (store == NULL) {
+        return 0.0;
+    }
+    return cacheStore_GetHitRatio(store);
+}
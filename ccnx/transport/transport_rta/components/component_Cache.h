@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file component_Cache.h
+ * @brief An in-stack content store that answers repeated Interests locally
+ *
+ * The CACHE component keeps recently received Content Objects in a stack-wide
+ * `CacheStore` and satisfies matching Interests on the downcall path without
+ * sending them to the forwarder.  It must sit above the codec, because it works
+ * on decoded dictionaries:
+ *
+ * { SYSTEM : COMPONENTS : [API_CONNECTOR, FC_VEGAS, CACHE, CODEC_TLV, FWD_METIS] }
+ *
+ * Up Stack Behavior: every Content Object is put in the store and passed up unaltered.
+ *
+ * Down Stack Behavior: an Interest that matches a stored object is consumed and the
+ * object is sent back up the stack on the same connection.  Everything else is passed down.
+ *
+ * The store limits are set with `localCache_ProtocolStackConfig()`.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_component_Cache_h
+#define Libccnx_component_Cache_h
+
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/components/cache_Store.h>
+
+extern RtaComponentOperations cache_ops;
+
+/**
+ * Returns the cumulative counters of the stack's content store
+ *
+ * The hit ratio is `hits / lookups`.  `bytesServed` counts the wire format bytes of
+ * every Content Object answered from the store.
+ *
+ * @param [in] stack A protocol stack configured with the CACHE component
+ *
+ * @return non-null The store counters, do not free
+ * @return null The stack does not have a CACHE component
+ *
+ * Example:
+ * @code
+ * {
+ *     const CacheStoreStats *stats = componentCache_GetStats(stack);
+ *     printf("hits %" PRIu64 " of %" PRIu64 " bytes %" PRIu64 "\n", stats->hits, stats->lookups, stats->bytesServed);
+ * }
+ * @endcode
+ */
+const CacheStoreStats *componentCache_GetStats(RtaProtocolStack *stack);
+
+/**
+ * The fraction of Interests answered from the stack's content store
+ *
+ * @param [in] stack A protocol stack configured with the CACHE component
+ *
+ * @return The hit ratio in the range [0.0, 1.0]
+ */
+double componentCache_GetHitRatio(RtaProtocolStack *stack);
+#endif // Libccnx_component_Cache_h
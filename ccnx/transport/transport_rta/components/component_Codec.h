@@ -36,6 +36,38 @@
 #ifndef Libccnx_component_codec_h
 #define Libccnx_component_codec_h
 
+#include <stdint.h>
+
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+
 // Function structs for component variations.  There's only the TLV codec now.
 extern RtaComponentOperations codec_tlv_ops;
+
+/**
+ * Per-connection counters of the TLV codec's signing workers.  Times are in microseconds.
+ */
+typedef struct codec_signing_stats {
+    uint64_t encoded;           // packets encoded and signed by a worker
+    uint64_t queueDepth;        // packets in the codec waiting to go down the stack now
+    uint64_t maxQueueDepth;
+    uint64_t totalSignUsec;     // time on the workers
+    uint64_t maxSignUsec;
+    uint64_t totalLatencyUsec;  // time from entering the codec to leaving it
+    uint64_t maxLatencyUsec;
+    uint64_t batches;           // Merkle roots signed
+    uint64_t batchedObjects;    // Content Objects signed under a Merkle root
+} CodecSigningStats;
+
+/**
+ * Returns the signing counters of a connection
+ *
+ * The counters stay at zero unless the stack was configured with `tlvCodec_SetSigningWorkers()`
+ * or `tlvCodec_SetBatchSigning()`.
+ *
+ * @param [in] conn An open connection
+ *
+ * @return non-null The connection's counters.  Do not free them.
+ * @return null The connection has no TLV codec state
+ */
+const CodecSigningStats *componentCodecTlv_GetSigningStats(RtaConnection *conn);
 #endif // Libccnx_component_codec_h
@@ -35,6 +35,8 @@
 #include <fcntl.h>
 #include <pthread.h>
 #include <sys/socket.h>
+#include <sys/queue.h>
+#include <sys/time.h>
 
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
@@ -43,6 +45,7 @@
 #include <LongBow/debugging.h>
 
 #include <parc/algol/parc_Memory.h>
+#include <ccnx/transport/transport_rta/core/rta_Timer.h>
 
 #include <ccnx/transport/common/transport_Message.h>
 
@@ -50,20 +53,31 @@
 #include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
 #include <ccnx/transport/transport_rta/core/rta_Connection.h>
 #include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/core/rta_WorkerPool.h>
 
 #include <parc/security/parc_PublicKeySignerPkcs12Store.h>
 #include <parc/security/parc_SymmetricSignerFileStore.h>
 #include <parc/security/parc_CryptoHashType.h>
+#include <parc/security/parc_CryptoHasher.h>
+#include <parc/security/parc_Signature.h>
 
 #include <ccnx/common/codec/ccnxCodec_TlvPacket.h>
+#include <ccnx/common/codec/ccnxCodec_NetworkBuffer.h>
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_TlvDictionary.h>
 
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_PacketEncoder.h>
 
+#include <ccnx/common/ccnx_ContentObject.h>
 #include <ccnx/common/ccnx_WireFormatMessage.h>
 
+#include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Binary.h>
+#include <ccnx/api/control/controlPlaneInterface.h>
+
 #include "component_Codec.h"
 #include "codec_Signing.h"
+#include "codec_MerkleTree.h"
+#include "codec_TlvIndex.h"
 #include <ccnx/transport/transport_rta/config/config_Signer.h>
 #include <ccnx/transport/transport_rta/config/config_Codec_Tlv.h>
 
@@ -79,6 +93,7 @@ static void component_Codec_Tlv_Downcall_Read(PARCEventQueue *, PARCEventType ev
 static int  component_Codec_Tlv_Closer(RtaConnection *conn);
 static int  component_Codec_Tlv_Release(RtaProtocolStack *stack);
 static void component_Codec_Tlv_StateChange(RtaConnection *conn);
+static void component_Codec_Tlv_Flush(RtaConnection *conn);
 
 RtaComponentOperations codec_tlv_ops = {
     .init          = component_Codec_Tlv_Init,
@@ -89,20 +104,171 @@ RtaComponentOperations codec_tlv_ops = {
     .downcallEvent = NULL,
     .close         = component_Codec_Tlv_Closer,
     .release       = component_Codec_Tlv_Release,
-    .stateChange   = component_Codec_Tlv_StateChange
+    .stateChange   = component_Codec_Tlv_StateChange,
+    .flush         = component_Codec_Tlv_Flush
 };
 
+typedef struct codec_stack_state {
+    // NULL unless the stack config asks for signing workers
+    RtaWorkerPool *signingPool;
+    unsigned signingWorkers;
+
+    // 0 unless the stack config asks for batch signing
+    unsigned batchSize;
+    unsigned batchDelayMsec;
+
+    // decode only the name of received packets, see codec_TlvIndex.h
+    bool lazyDecode;
+
+    // NULL unless the stack config asks for decode workers
+    RtaWorkerPool *decodePool;
+    unsigned decodeWorkers;
+} CodecStackState;
+
+typedef struct codec_batch_entry {
+    TransportMessage *tm;
+
+    // only Content Objects go under the batch signature, the rest wait their turn
+    bool batched;
+
+    // set for the others when the batch goes to a signing worker and they need encoding too
+    bool needsEncoding;
+
+    TAILQ_ENTRY(codec_batch_entry) list;
+} CodecBatchEntry;
+
+TAILQ_HEAD(codec_batch_list, codec_batch_entry);
+
+struct codec_connection_state;
+
+typedef struct codec_sign_job {
+    struct codec_connection_state *codecState;
+    TransportMessage *tm;
+
+    // false for messages that already have a wire format, they only wait their turn
+    bool needsEncoding;
+    bool submitted;
+    bool finished;
+
+    // borrowed from the connection's idle signers while a worker has the job
+    PARCSigner *signer;
+
+    // A flushed batch instead of `tm`.  The worker signs its root and encodes every
+    // message in it, then they go down in order.
+    struct codec_batch_list batch;
+    size_t batchObjects;
+
+    uint64_t arrivalUsec;
+    uint64_t signUsec;
+
+    TAILQ_ENTRY(codec_sign_job) list;
+} CodecSignJob;
+
+typedef struct codec_decode_job {
+    struct codec_connection_state *codecState;
+    TransportMessage *tm;
+
+    // false for control messages, they only wait their turn
+    bool needsDecoding;
+    bool lazy;
+    bool finished;
+    bool success;
+
+    TAILQ_ENTRY(codec_decode_job) list;
+} CodecDecodeJob;
+
 typedef struct codec_connection_state {
     PARCSigner *signer;
+
+    // not acquired, the state lives only as long as the connection
+    RtaConnection *connection;
+
+    // Only used when the stack has signing workers.  A PARCSigner is not safe to use
+    // from two threads at once, so the connection has one signer per worker and a job
+    // holds one of them while it is on a worker.
+    size_t signerCount;
+    PARCSigner **signers;
+    size_t idleCount;
+    PARCSigner **idleSigners;
+
+    // every message going down, in arrival order, while any of them is being signed
+    TAILQ_HEAD(, codec_sign_job) inOrder;
+
+    // the first job that still needs to go to a worker, or NULL
+    CodecSignJob *nextToSubmit;
+
+    // Only used when the stack has decode workers.  Every message going up, in arrival
+    // order, while any of them is being decoded.
+    TAILQ_HEAD(, codec_decode_job) upInOrder;
+
+    // sign and decode jobs still held by a worker pool
+    size_t outstanding;
+    bool closed;
+
+    // set when the connection is about to close, jobs are then encoded on the RTA thread
+    bool flushing;
+
+    // Only used when the stack batches Content Objects under one signature.  While the
+    // batch has anything in it, every message of the connection goes behind it.
+    struct codec_batch_list batch;
+    size_t batchObjects;
+    RtaTimer *batchTimer;
+
+    CodecSigningStats signingStats;
 } CodecConnectionState;
 
+static void _component_Codec_Tlv_SignDone(void *arg, void *doneContext);
+static void _component_Codec_Tlv_DecodeDone(void *arg, void *doneContext);
+static void _component_Codec_Tlv_EnqueueUp(CodecStackState *stackState, CodecConnectionState *codecState, TransportMessage *tm);
+static void _component_Codec_Tlv_BatchTimerCallback(int fd, PARCEventType what, void *user_data);
+static void _component_Codec_Tlv_EncodeBatch(struct codec_batch_list *batch, size_t batchObjects, PARCSigner *signer);
+
 // ==================
-// NULL
+
+static uint64_t
+_component_Codec_Tlv_NowUsec(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec * 1000000ULL + now.tv_usec;
+}
 
 static int
 component_Codec_Tlv_Init(RtaProtocolStack *stack)
 {
-    // no ProtocolStack wide state
+    CodecStackState *stackState = parcMemory_AllocateAndClear(sizeof(CodecStackState));
+    assertNotNull(stackState, "%s parcMemory_AllocateAndClear(%zu) returned NULL", __func__, sizeof(CodecStackState));
+
+    stackState->signingWorkers = tlvCodec_GetSigningWorkersFromConfig(rtaProtocolStack_GetParameters(stack));
+    if (stackState->signingWorkers > 0) {
+        stackState->signingPool = rtaWorkerPool_Create(rtaFramework_GetEventScheduler(rtaProtocolStack_GetFramework(stack)),
+                                                       stackState->signingWorkers, _component_Codec_Tlv_SignDone, stackState);
+    }
+
+    stackState->batchSize = tlvCodec_GetBatchSizeFromConfig(rtaProtocolStack_GetParameters(stack));
+    stackState->batchDelayMsec = tlvCodec_GetBatchDelayFromConfig(rtaProtocolStack_GetParameters(stack));
+    stackState->lazyDecode = tlvCodec_GetLazyDecodeFromConfig(rtaProtocolStack_GetParameters(stack));
+
+    stackState->decodeWorkers = tlvCodec_GetDecodeWorkersFromConfig(rtaProtocolStack_GetParameters(stack));
+    if (stackState->decodeWorkers > 0) {
+        stackState->decodePool = rtaWorkerPool_Create(rtaFramework_GetEventScheduler(rtaProtocolStack_GetFramework(stack)),
+                                                      stackState->decodeWorkers, _component_Codec_Tlv_DecodeDone, stackState);
+    }
+
+    rtaProtocolStack_SetPrivateData(stack, CODEC_TLV, stackState);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s stack %d signing workers %u batch size %u delay %u msec lazy decode %d decode workers %u\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+               __func__,
+               rtaProtocolStack_GetStackId(stack),
+               stackState->signingWorkers,
+               stackState->batchSize,
+               stackState->batchDelayMsec,
+               stackState->lazyDecode,
+               stackState->decodeWorkers);
+    }
+
     return 0;
 }
 
@@ -115,6 +281,36 @@ component_Codec_Tlv_Opener(RtaConnection *conn)
 
     codec_state->signer = component_Codec_GetSigner(conn);
 
+    codec_state->connection = conn;
+    TAILQ_INIT(&codec_state->inOrder);
+    TAILQ_INIT(&codec_state->upInOrder);
+    TAILQ_INIT(&codec_state->batch);
+
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(rtaConnection_GetStack(conn), CODEC_TLV);
+    if (stackState->batchSize > 0) {
+        codec_state->batchTimer = rtaTimer_Create(rtaConnection_GetFramework(conn),
+                                                        0, _component_Codec_Tlv_BatchTimerCallback, (void *) codec_state);
+    }
+
+    if (stackState->signingPool != NULL) {
+
+        codec_state->signerCount = stackState->signingWorkers;
+        codec_state->signers = parcMemory_AllocateAndClear(codec_state->signerCount * sizeof(PARCSigner *));
+        codec_state->idleSigners = parcMemory_AllocateAndClear(codec_state->signerCount * sizeof(PARCSigner *));
+        assertTrue(codec_state->signers != NULL && codec_state->idleSigners != NULL,
+                   "%s parcMemory_AllocateAndClear returned NULL", __func__);
+
+        // codec_state->signer stays on the RTA thread, the workers only use these
+        for (size_t i = 0; i < codec_state->signerCount; i++) {
+            codec_state->signers[i] = component_Codec_GetSigner(conn);
+        }
+
+        for (size_t i = 0; i < codec_state->signerCount; i++) {
+            codec_state->idleSigners[i] = codec_state->signers[i];
+        }
+        codec_state->idleCount = codec_state->signerCount;
+    }
+
     rtaConnection_SetPrivateData(conn, CODEC_TLV, codec_state);
 
     if (DEBUG_OUTPUT) {
@@ -130,12 +326,17 @@ component_Codec_Tlv_Opener(RtaConnection *conn)
 }
 
 static void
-upcallDictionary(TransportMessage *tm, PARCEventQueue *out, RtaComponentStats *stats)
+upcallDictionary(CodecStackState *stackState, TransportMessage *tm, PARCEventQueue *out, RtaComponentStats *stats)
 {
     CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(tm);
 
     PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(dictionary);
-    bool success = ccnxCodecTlvPacket_BufferDecode(wireFormat, dictionary);
+    bool success;
+    if (stackState->lazyDecode) {
+        success = codecTlvIndex_LazyDecode(tm);
+    } else {
+        success = ccnxCodecTlvPacket_BufferDecode(wireFormat, dictionary);
+    }
 
     if (success) {
         if (rtaComponent_PutMessage(out, tm)) {
@@ -153,6 +354,7 @@ component_Codec_Tlv_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *p
 {
     RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
     PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, CODEC_TLV, RTA_UP);
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(stack, CODEC_TLV);
     TransportMessage *tm;
 
     while ((tm = rtaComponent_GetMessage(in)) != NULL) {
@@ -160,12 +362,16 @@ component_Codec_Tlv_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *p
         RtaComponentStats *stats = rtaConnection_GetStats(conn, CODEC_TLV);
         rtaComponentStats_Increment(stats, STATS_UPCALL_IN);
 
-        if (transportMessage_IsControl(tm)) {
+        CodecConnectionState *codecState = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+        if (stackState->decodePool != NULL && codecState != NULL) {
+            // the message goes up from _component_Codec_Tlv_DeliverUp(), maybe later
+            _component_Codec_Tlv_EnqueueUp(stackState, codecState, tm);
+        } else if (transportMessage_IsControl(tm)) {
             if (rtaComponent_PutMessage(out, tm)) {
                 rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
             }
         } else {
-            upcallDictionary(tm, out, stats);
+            upcallDictionary(stackState, tm, out, stats);
         }
 
         if (DEBUG_OUTPUT) {
@@ -181,37 +387,119 @@ component_Codec_Tlv_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *p
 }
 
 
-static TransportMessage *
-component_Codec_Tlv_EncodeDictionary_SchemaV1(TransportMessage *tm, RtaConnection  *conn, CCNxTlvDictionary *packetDictionary)
+static bool
+component_Codec_Tlv_HasWireFormat_SchemaV1(CCNxTlvDictionary *packetDictionary)
 {
-    bool hasWireFormat = (ccnxTlvDictionary_IsValueIoVec(packetDictionary, CCNxCodecSchemaV1TlvDictionary_HeadersFastArray_WireFormat) ||
-                          ccnxTlvDictionary_IsValueBuffer(packetDictionary, CCNxCodecSchemaV1TlvDictionary_HeadersFastArray_WireFormat));
+    return (ccnxTlvDictionary_IsValueIoVec(packetDictionary, CCNxCodecSchemaV1TlvDictionary_HeadersFastArray_WireFormat) ||
+            ccnxTlvDictionary_IsValueBuffer(packetDictionary, CCNxCodecSchemaV1TlvDictionary_HeadersFastArray_WireFormat));
+}
 
-    if (!hasWireFormat) {
-        CodecConnectionState *codec_conn_state = rtaConnection_GetPrivateData(conn, CODEC_TLV);
-        assertNotNull(codec_conn_state, "%s got null private data\n", __func__);
+/**
+ * The forwarder only understands JSON control messages.  A binary CPI message is encoded
+ * from its JSON form, which has the same sequence number.
+ */
+static CCNxCodecNetworkBufferIoVec *
+component_Codec_Tlv_EncodeBinaryControl_SchemaV1(CCNxTlvDictionary *packetDictionary, PARCSigner *signer)
+{
+    CPIBinaryMessage message;
+    bool success = cpiBinary_Parse(ccnxControlFacade_GetBinary(packetDictionary), &message);
+    assertTrue(success, "Malformed binary CPI message");
 
-        CCNxCodecNetworkBufferIoVec *vec = ccnxCodecSchemaV1PacketEncoder_DictionaryEncode(packetDictionary, codec_conn_state->signer);
+    PARCJSON *json = cpiBinary_ToJson(&message);
+    CCNxTlvDictionary *jsonDictionary = ccnxControlFacade_CreateCPI(json);
+    parcJSON_Release(&json);
 
-        if (vec) {
-            // store a reference back into the dictioary
-            bool success = ccnxWireFormatMessage_PutIoVec(packetDictionary, vec);
-            assertTrue(success, "Failed to save wire format in the dictionary") {
-                ccnxCodecNetworkBufferIoVec_Display(vec, 0);
-            }
+    CCNxCodecNetworkBufferIoVec *vec = ccnxCodecSchemaV1PacketEncoder_DictionaryEncode(jsonDictionary, signer);
+    ccnxTlvDictionary_Release(&jsonDictionary);
+    return vec;
+}
 
-            if (DEBUG_OUTPUT > 2) {
-                printf("%s encoded packet:\n", __func__);
-                ccnxCodecNetworkBufferIoVec_Display(vec, 0);
-            }
+/**
+ * The forwarder registers one route per request.  A batch (CPI_REGISTER_PREFIXES) is encoded
+ * as that many REGISTER packets back to back in a single wire format, so it still goes down
+ * the stack and into the socket as one message.  Route `i` has sequence number `batch + i`,
+ * which is how the forwarder connector folds the acks back into one.
+ */
+static CCNxCodecNetworkBufferIoVec *
+component_Codec_Tlv_EncodeRouteBatch_SchemaV1(CCNxTlvDictionary *packetDictionary, PARCSigner *signer)
+{
+    uint64_t batchSequenceNumber = cpi_GetSequenceNumber(packetDictionary);
+    CPIRouteEntryList *routes = cpiForwarding_RoutesFromControlMessage(packetDictionary);
 
-            ccnxCodecNetworkBufferIoVec_Release(&vec);
+    CCNxCodecNetworkBuffer *netbuff = ccnxCodecNetworkBuffer_Create(&ParcMemoryMemoryBlock, NULL);
+    for (size_t i = 0; i < cpiRouteEntryList_Length(routes); i++) {
+        CPIRouteEntry *route = cpiRouteEntryList_Get(routes, i);
+        PARCJSON *json = cpiForwarding_CreateAddRouteRequestInBatch(route, batchSequenceNumber, i);
+        cpiRouteEntry_Destroy(&route);
+        CCNxTlvDictionary *routeDictionary = ccnxControlFacade_CreateCPI(json);
+        parcJSON_Release(&json);
 
-        } else {
-            trapUnexpectedState("Error encoding packet") {
-                ccnxTlvDictionary_Display(packetDictionary, 0);
-            }
+        CCNxCodecNetworkBufferIoVec *routeVec = ccnxCodecSchemaV1PacketEncoder_DictionaryEncode(routeDictionary, signer);
+        assertNotNull(routeVec, "Error encoding route %zu of a batch", i);
+
+        int iovcnt = ccnxCodecNetworkBufferIoVec_GetCount(routeVec);
+        const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(routeVec);
+        for (int j = 0; j < iovcnt; j++) {
+            ccnxCodecNetworkBuffer_PutArray(netbuff, array[j].iov_len, array[j].iov_base);
         }
+
+        ccnxCodecNetworkBufferIoVec_Release(&routeVec);
+        ccnxTlvDictionary_Release(&routeDictionary);
+    }
+    cpiRouteEntryList_Destroy(&routes);
+
+    CCNxCodecNetworkBufferIoVec *vec = ccnxCodecNetworkBuffer_CreateIoVec(netbuff);
+    ccnxCodecNetworkBuffer_Release(&netbuff);
+    return vec;
+}
+
+/**
+ * Encodes (and signs) the packet and saves the wire format in the dictionary.  It does not
+ * touch the connection, so it may run on a signing worker.
+ */
+static void
+component_Codec_Tlv_Encode_SchemaV1(CCNxTlvDictionary *packetDictionary, PARCSigner *signer)
+{
+    CCNxCodecNetworkBufferIoVec *vec;
+    if (ccnxTlvDictionary_IsControl(packetDictionary) && ccnxControlFacade_IsCPI(packetDictionary) &&
+        cpi_GetMessageType(packetDictionary) == CPI_REQUEST &&
+        cpi_GetMessageOperation(packetDictionary) == CPI_REGISTER_PREFIXES) {
+        vec = component_Codec_Tlv_EncodeRouteBatch_SchemaV1(packetDictionary, signer);
+    } else if (ccnxTlvDictionary_IsControl(packetDictionary) && ccnxControlFacade_IsBinary(packetDictionary)) {
+        vec = component_Codec_Tlv_EncodeBinaryControl_SchemaV1(packetDictionary, signer);
+    } else {
+        vec = ccnxCodecSchemaV1PacketEncoder_DictionaryEncode(packetDictionary, signer);
+    }
+
+    if (vec) {
+        // store a reference back into the dictioary
+        bool success = ccnxWireFormatMessage_PutIoVec(packetDictionary, vec);
+        assertTrue(success, "Failed to save wire format in the dictionary") {
+            ccnxCodecNetworkBufferIoVec_Display(vec, 0);
+        }
+
+        if (DEBUG_OUTPUT > 2) {
+            printf("%s encoded packet:\n", __func__);
+            ccnxCodecNetworkBufferIoVec_Display(vec, 0);
+        }
+
+        ccnxCodecNetworkBufferIoVec_Release(&vec);
+
+    } else {
+        trapUnexpectedState("Error encoding packet") {
+            ccnxTlvDictionary_Display(packetDictionary, 0);
+        }
+    }
+}
+
+static TransportMessage *
+component_Codec_Tlv_EncodeDictionary_SchemaV1(TransportMessage *tm, RtaConnection  *conn, CCNxTlvDictionary *packetDictionary)
+{
+    if (!component_Codec_Tlv_HasWireFormat_SchemaV1(packetDictionary)) {
+        CodecConnectionState *codec_conn_state = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+        assertNotNull(codec_conn_state, "%s got null private data\n", __func__);
+
+        component_Codec_Tlv_Encode_SchemaV1(packetDictionary, codec_conn_state->signer);
     } else {
         if (DEBUG_OUTPUT) {
             printf("%9" PRIu64 " %s packetDictionary %p already has wire format\n",
@@ -255,12 +543,576 @@ component_Codec_Tlv_EncodeDictionary(TransportMessage *tm, RtaConnection  *conn)
     return NULL;
 }
 
+// ==================
+// Signing workers
+
+static void
+_codecBatchList_Destroy(struct codec_batch_list *batch)
+{
+    CodecBatchEntry *entry;
+    while ((entry = TAILQ_FIRST(batch)) != NULL) {
+        TAILQ_REMOVE(batch, entry, list);
+        transportMessage_Destroy(&entry->tm);
+        parcMemory_Deallocate((void **) &entry);
+    }
+}
+
+static void
+_codecSignJob_Destroy(CodecSignJob **jobPtr)
+{
+    CodecSignJob *job = *jobPtr;
+    if (job->tm) {
+        transportMessage_Destroy(&job->tm);
+    }
+    _codecBatchList_Destroy(&job->batch);
+    parcMemory_Deallocate((void **) jobPtr);
+}
+
+static void
+_codecConnectionState_Destroy(CodecConnectionState **statePtr)
+{
+    CodecConnectionState *codecState = *statePtr;
+    assertTrue(codecState->outstanding == 0, "Destroying state with %zu outstanding jobs", codecState->outstanding);
+
+    for (size_t i = 0; i < codecState->signerCount; i++) {
+        parcSigner_Release(&codecState->signers[i]);
+    }
+    if (codecState->signers) {
+        parcMemory_Deallocate((void **) &codecState->signers);
+        parcMemory_Deallocate((void **) &codecState->idleSigners);
+    }
+
+    parcSigner_Release(&codecState->signer);
+    parcMemory_Deallocate((void **) statePtr);
+}
+
+/**
+ * Runs on a signing worker
+ */
+static void
+_component_Codec_Tlv_SignWork(void *arg)
+{
+    CodecSignJob *job = (CodecSignJob *) arg;
+
+    uint64_t start = _component_Codec_Tlv_NowUsec();
+    if (job->batchObjects > 0) {
+        _component_Codec_Tlv_EncodeBatch(&job->batch, job->batchObjects, job->signer);
+    } else {
+        component_Codec_Tlv_Encode_SchemaV1(transportMessage_GetDictionary(job->tm), job->signer);
+    }
+    job->signUsec = _component_Codec_Tlv_NowUsec() - start;
+}
+
+/**
+ * Give jobs to the workers, in order, for as long as the connection has an idle signer.
+ */
+static void
+_component_Codec_Tlv_Submit(CodecStackState *stackState, CodecConnectionState *codecState)
+{
+    CodecSignJob *job;
+    while (!codecState->flushing && (job = codecState->nextToSubmit) != NULL && (!job->needsEncoding || codecState->idleCount > 0)) {
+        if (job->needsEncoding) {
+            job->signer = codecState->idleSigners[--codecState->idleCount];
+            job->submitted = true;
+            codecState->outstanding++;
+            rtaWorkerPool_Submit(stackState->signingPool, _component_Codec_Tlv_SignWork, job);
+        }
+        codecState->nextToSubmit = TAILQ_NEXT(job, list);
+    }
+}
+
+/**
+ * Send down every message at the head of the connection's list that is ready to go.
+ */
+static void
+_component_Codec_Tlv_Deliver(CodecConnectionState *codecState)
+{
+    RtaConnection *conn = codecState->connection;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(rtaConnection_GetStack(conn), CODEC_TLV, RTA_DOWN);
+    RtaComponentStats *stats = rtaConnection_GetStats(conn, CODEC_TLV);
+    CodecSigningStats *signingStats = &codecState->signingStats;
+
+    CodecSignJob *job;
+    while ((job = TAILQ_FIRST(&codecState->inOrder)) != NULL && job->finished) {
+        TAILQ_REMOVE(&codecState->inOrder, job, list);
+        signingStats->queueDepth--;
+
+        if (job->needsEncoding) {
+            uint64_t latency = _component_Codec_Tlv_NowUsec() - job->arrivalUsec;
+            signingStats->totalLatencyUsec += latency;
+            if (latency > signingStats->maxLatencyUsec) {
+                signingStats->maxLatencyUsec = latency;
+            }
+        }
+
+        if (job->batchObjects > 0) {
+            CodecBatchEntry *entry;
+            while ((entry = TAILQ_FIRST(&job->batch)) != NULL) {
+                TAILQ_REMOVE(&job->batch, entry, list);
+                if (rtaComponent_PutMessage(out, entry->tm)) {
+                    rtaComponentStats_Increment(stats, STATS_DOWNCALL_OUT);
+                }
+                parcMemory_Deallocate((void **) &entry);
+            }
+        } else {
+            if (rtaComponent_PutMessage(out, job->tm)) {
+                rtaComponentStats_Increment(stats, STATS_DOWNCALL_OUT);
+            }
+            job->tm = NULL;
+        }
+        _codecSignJob_Destroy(&job);
+    }
+}
+
+/**
+ * Runs on the RTA thread when a signing worker is done with a job
+ */
+static void
+_component_Codec_Tlv_SignDone(void *arg, void *doneContext)
+{
+    CodecStackState *stackState = (CodecStackState *) doneContext;
+    CodecSignJob *job = (CodecSignJob *) arg;
+    CodecConnectionState *codecState = job->codecState;
+    CodecSigningStats *signingStats = &codecState->signingStats;
+
+    codecState->idleSigners[codecState->idleCount++] = job->signer;
+    job->signer = NULL;
+    job->finished = true;
+    codecState->outstanding--;
+
+    signingStats->encoded++;
+    signingStats->totalSignUsec += job->signUsec;
+    if (job->signUsec > signingStats->maxSignUsec) {
+        signingStats->maxSignUsec = job->signUsec;
+    }
+
+    if (codecState->closed) {
+        // The job was taken off the connection's list when it closed
+        _codecSignJob_Destroy(&job);
+        if (codecState->outstanding == 0) {
+            _codecConnectionState_Destroy(&codecState);
+        }
+        return;
+    }
+
+    _component_Codec_Tlv_Submit(stackState, codecState);
+    _component_Codec_Tlv_Deliver(codecState);
+}
+
+/**
+ * Put a job at the end of the connection's list and send down what is ready
+ */
+static void
+_component_Codec_Tlv_AddJob(CodecStackState *stackState, CodecConnectionState *codecState, CodecSignJob *job)
+{
+    TAILQ_INSERT_TAIL(&codecState->inOrder, job, list);
+    if (codecState->nextToSubmit == NULL) {
+        codecState->nextToSubmit = job;
+    }
+
+    CodecSigningStats *signingStats = &codecState->signingStats;
+    signingStats->queueDepth++;
+    if (signingStats->queueDepth > signingStats->maxQueueDepth) {
+        signingStats->maxQueueDepth = signingStats->queueDepth;
+    }
+
+    _component_Codec_Tlv_Submit(stackState, codecState);
+    _component_Codec_Tlv_Deliver(codecState);
+}
+
+/**
+ * Queue a message going down behind the ones before it.  Messages that need encoding go to
+ * a signing worker, the others only wait for their turn.
+ */
+static void
+_component_Codec_Tlv_Enqueue(CodecStackState *stackState, TransportMessage *tm, RtaConnection *conn)
+{
+    CodecConnectionState *codecState = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+    assertNotNull(codecState, "%s got null private data\n", __func__);
+
+    CCNxTlvDictionary *packetDictionary = transportMessage_GetDictionary(tm);
+    assertNotNull(packetDictionary, "Got a NULL packet dictionary for dictionary based encoding");
+
+    CodecSignJob *job = parcMemory_AllocateAndClear(sizeof(CodecSignJob));
+    assertNotNull(job, "%s parcMemory_AllocateAndClear(%zu) returned NULL", __func__, sizeof(CodecSignJob));
+    job->codecState = codecState;
+    job->tm = tm;
+    job->arrivalUsec = _component_Codec_Tlv_NowUsec();
+    job->needsEncoding = (ccnxTlvDictionary_GetSchemaVersion(packetDictionary) == CCNxTlvDictionary_SchemaVersion_V1 &&
+                          !component_Codec_Tlv_HasWireFormat_SchemaV1(packetDictionary));
+    TAILQ_INIT(&job->batch);
+
+    if (!job->needsEncoding) {
+        // nothing to sign, but unknown schemas still trap here
+        component_Codec_Tlv_EncodeDictionary(tm, conn);
+        job->finished = true;
+    }
+
+    _component_Codec_Tlv_AddJob(stackState, codecState, job);
+}
+
+// ==================
+// Decode workers
+
+static void
+_codecDecodeJob_Destroy(CodecDecodeJob **jobPtr)
+{
+    CodecDecodeJob *job = *jobPtr;
+    if (job->tm) {
+        transportMessage_Destroy(&job->tm);
+    }
+    parcMemory_Deallocate((void **) jobPtr);
+}
+
+/**
+ * Runs on a decode worker.  The job owns its message, so nothing here is shared.
+ */
+static void
+_component_Codec_Tlv_DecodeWork(void *arg)
+{
+    CodecDecodeJob *job = (CodecDecodeJob *) arg;
+
+    if (job->lazy) {
+        job->success = codecTlvIndex_LazyDecode(job->tm);
+    } else {
+        CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(job->tm);
+        PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(dictionary);
+        job->success = ccnxCodecTlvPacket_BufferDecode(wireFormat, dictionary);
+    }
+}
+
+/**
+ * Send up every message at the head of the connection's list that is done decoding.
+ */
+static void
+_component_Codec_Tlv_DeliverUp(CodecConnectionState *codecState)
+{
+    RtaConnection *conn = codecState->connection;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(rtaConnection_GetStack(conn), CODEC_TLV, RTA_UP);
+    RtaComponentStats *stats = rtaConnection_GetStats(conn, CODEC_TLV);
+
+    CodecDecodeJob *job;
+    while ((job = TAILQ_FIRST(&codecState->upInOrder)) != NULL && job->finished) {
+        TAILQ_REMOVE(&codecState->upInOrder, job, list);
+
+        if (job->success) {
+            if (rtaComponent_PutMessage(out, job->tm)) {
+                rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+            }
+            job->tm = NULL;
+        } else {
+            printf("Decoding error!");
+            parcBuffer_Display(ccnxWireFormatMessage_GetWireFormatBuffer(transportMessage_GetDictionary(job->tm)), 3);
+        }
+        _codecDecodeJob_Destroy(&job);
+    }
+}
+
+/**
+ * Runs on the RTA thread when a decode worker is done with a job
+ */
+static void
+_component_Codec_Tlv_DecodeDone(void *arg, void *doneContext)
+{
+    CodecDecodeJob *job = (CodecDecodeJob *) arg;
+    CodecConnectionState *codecState = job->codecState;
+
+    job->finished = true;
+    codecState->outstanding--;
+
+    if (codecState->closed) {
+        // The job was taken off the connection's list when it closed
+        _codecDecodeJob_Destroy(&job);
+        if (codecState->outstanding == 0) {
+            _codecConnectionState_Destroy(&codecState);
+        }
+        return;
+    }
+
+    _component_Codec_Tlv_DeliverUp(codecState);
+}
+
+/**
+ * Queue a message going up behind the ones before it.  Packets go to a decode worker,
+ * control messages only wait for their turn.
+ */
+static void
+_component_Codec_Tlv_EnqueueUp(CodecStackState *stackState, CodecConnectionState *codecState, TransportMessage *tm)
+{
+    CodecDecodeJob *job = parcMemory_AllocateAndClear(sizeof(CodecDecodeJob));
+    assertNotNull(job, "%s parcMemory_AllocateAndClear(%zu) returned NULL", __func__, sizeof(CodecDecodeJob));
+    job->codecState = codecState;
+    job->tm = tm;
+    job->lazy = stackState->lazyDecode;
+    job->needsDecoding = !transportMessage_IsControl(tm);
+
+    TAILQ_INSERT_TAIL(&codecState->upInOrder, job, list);
+
+    if (job->needsDecoding) {
+        codecState->outstanding++;
+        rtaWorkerPool_Submit(stackState->decodePool, _component_Codec_Tlv_DecodeWork, job);
+    } else {
+        job->success = true;
+        job->finished = true;
+        _component_Codec_Tlv_DeliverUp(codecState);
+    }
+}
+
+// ==================
+// Batch signing
+
+/**
+ * Encode a message now, or give it to the signing workers if the stack has them
+ */
+static void
+_component_Codec_Tlv_SendDown(CodecStackState *stackState, TransportMessage *tm, RtaConnection *conn)
+{
+    if (stackState->signingPool != NULL) {
+        _component_Codec_Tlv_Enqueue(stackState, tm, conn);
+        return;
+    }
+
+    TransportMessage *encoded = component_Codec_Tlv_EncodeDictionary(tm, conn);
+    if (encoded) {
+        PARCEventQueue *out = rtaProtocolStack_GetPutQueue(rtaConnection_GetStack(conn), CODEC_TLV, RTA_DOWN);
+        if (rtaComponent_PutMessage(out, encoded)) {
+            rtaComponentStats_Increment(rtaConnection_GetStats(conn, CODEC_TLV), STATS_DOWNCALL_OUT);
+        }
+    }
+}
+
+/**
+ * A Content Object can go in a batch if the codec would sign it, i.e. it has no wire
+ * format and the application did not choose its own validation.
+ */
+static bool
+_component_Codec_Tlv_IsBatchable(TransportMessage *tm)
+{
+    CCNxTlvDictionary *packetDictionary = transportMessage_GetDictionary(tm);
+    return transportMessage_IsContentObject(tm) &&
+           ccnxTlvDictionary_GetSchemaVersion(packetDictionary) == CCNxTlvDictionary_SchemaVersion_V1 &&
+           !component_Codec_Tlv_HasWireFormat_SchemaV1(packetDictionary) &&
+           !ccnxTlvDictionary_IsValueInteger(packetDictionary, CCNxCodecSchemaV1TlvDictionary_ValidationFastArray_CRYPTO_SUITE);
+}
+
+/**
+ * The leaf digest of a Content Object: SHA-256 over the CCNx message TLV, without the fixed
+ * header (the packet length changes once the validation is added) and without the
+ * validation sections.
+ */
+static PARCBuffer *
+_component_Codec_Tlv_CreateLeafDigest(CCNxTlvDictionary *contentObject)
+{
+    CCNxCodecNetworkBufferIoVec *vec = ccnxCodecSchemaV1PacketEncoder_DictionaryEncode(contentObject, NULL);
+    assertNotNull(vec, "Error encoding packet");
+
+    const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(vec);
+    int count = ccnxCodecNetworkBufferIoVec_GetCount(vec);
+
+    // The last byte of the 8 byte fixed header is the header length
+    assertTrue(count > 0 && array[0].iov_len >= 8, "Fixed header not in the first iovec");
+    size_t skip = ((const uint8_t *) array[0].iov_base)[7];
+
+    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+    parcCryptoHasher_Init(hasher);
+    for (int i = 0; i < count; i++) {
+        if (skip >= array[i].iov_len) {
+            skip -= array[i].iov_len;
+            continue;
+        }
+        parcCryptoHasher_UpdateBytes(hasher, (const uint8_t *) array[i].iov_base + skip, array[i].iov_len - skip);
+        skip = 0;
+    }
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+    PARCBuffer *digest = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
+
+    parcCryptoHash_Release(&hash);
+    parcCryptoHasher_Release(&hasher);
+    ccnxCodecNetworkBufferIoVec_Release(&vec);
+    return digest;
+}
+
+/**
+ * Sign every Content Object in the batch with one signature over a Merkle root.  It only
+ * touches the messages of the batch, so it may run on a signing worker.
+ */
+static void
+_component_Codec_Tlv_SignBatch(struct codec_batch_list *batch, size_t count, PARCSigner *signer)
+{
+    CCNxTlvDictionary **objects = parcMemory_Allocate(count * sizeof(CCNxTlvDictionary *));
+    PARCBuffer **leaves = parcMemory_Allocate(count * sizeof(PARCBuffer *));
+    assertTrue(objects != NULL && leaves != NULL, "%s parcMemory_Allocate returned NULL", __func__);
+
+    size_t i = 0;
+    CodecBatchEntry *entry;
+    TAILQ_FOREACH(entry, batch, list)
+    {
+        if (entry->batched) {
+            objects[i] = transportMessage_GetDictionary(entry->tm);
+            leaves[i] = _component_Codec_Tlv_CreateLeafDigest(objects[i]);
+            i++;
+        }
+    }
+    assertTrue(i == count, "Batch has %zu Content Objects, expected %zu", i, count);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(count, leaves);
+    PARCCryptoHash *root = parcCryptoHash_Create(PARC_HASH_SHA256, codecMerkleTree_GetRoot(tree));
+    PARCSignature *rootSignature = parcSigner_SignDigest(signer, root);
+    PARCKeyId *keyId = parcSigner_CreateKeyId(signer);
+
+    for (i = 0; i < count; i++) {
+        PARCBuffer *payload = codecMerkleTree_CreateBatchPayload(tree, i, parcSignature_GetSignature(rootSignature));
+        PARCSignature *signature = parcSignature_Create(parcSignature_GetSigningAlgorithm(rootSignature), PARC_HASH_SHA256, payload);
+        ccnxContentObject_SetSignature(objects[i], parcKeyId_GetKeyId(keyId), signature, NULL);
+
+        // The payload is in the dictionary, so the encoder does not sign again
+        component_Codec_Tlv_Encode_SchemaV1(objects[i], NULL);
+
+        parcSignature_Release(&signature);
+        parcBuffer_Release(&payload);
+        parcBuffer_Release(&leaves[i]);
+    }
+
+    parcKeyId_Release(&keyId);
+    parcSignature_Release(&rootSignature);
+    parcCryptoHash_Release(&root);
+    codecMerkleTree_Destroy(&tree);
+    parcMemory_Deallocate((void **) &leaves);
+    parcMemory_Deallocate((void **) &objects);
+}
+
+/**
+ * Runs on a signing worker: sign the batch and encode the other messages waiting in it
+ */
+static void
+_component_Codec_Tlv_EncodeBatch(struct codec_batch_list *batch, size_t batchObjects, PARCSigner *signer)
+{
+    _component_Codec_Tlv_SignBatch(batch, batchObjects, signer);
+
+    CodecBatchEntry *entry;
+    TAILQ_FOREACH(entry, batch, list)
+    {
+        if (entry->needsEncoding) {
+            component_Codec_Tlv_Encode_SchemaV1(transportMessage_GetDictionary(entry->tm), signer);
+        }
+    }
+}
+
+/**
+ * Give the whole batch to the signing workers as one job, so the root signature stays off
+ * the RTA thread.  The job holds the connection's later messages behind it like any other.
+ */
+static void
+_component_Codec_Tlv_EnqueueBatch(CodecStackState *stackState, CodecConnectionState *codecState)
+{
+    CodecSignJob *job = parcMemory_AllocateAndClear(sizeof(CodecSignJob));
+    assertNotNull(job, "%s parcMemory_AllocateAndClear(%zu) returned NULL", __func__, sizeof(CodecSignJob));
+    job->codecState = codecState;
+    job->arrivalUsec = _component_Codec_Tlv_NowUsec();
+    job->needsEncoding = true;
+    job->batchObjects = codecState->batchObjects;
+    TAILQ_INIT(&job->batch);
+
+    CodecBatchEntry *entry;
+    while ((entry = TAILQ_FIRST(&codecState->batch)) != NULL) {
+        TAILQ_REMOVE(&codecState->batch, entry, list);
+        if (!entry->batched) {
+            CCNxTlvDictionary *packetDictionary = transportMessage_GetDictionary(entry->tm);
+            entry->needsEncoding = (ccnxTlvDictionary_GetSchemaVersion(packetDictionary) == CCNxTlvDictionary_SchemaVersion_V1 &&
+                                    !component_Codec_Tlv_HasWireFormat_SchemaV1(packetDictionary));
+            if (!entry->needsEncoding) {
+                // nothing to sign, but unknown schemas still trap here
+                component_Codec_Tlv_EncodeDictionary(entry->tm, codecState->connection);
+            }
+        }
+        TAILQ_INSERT_TAIL(&job->batch, entry, list);
+    }
+
+    _component_Codec_Tlv_AddJob(stackState, codecState, job);
+}
+
+/**
+ * Sign the batch and send everything in it down, in order
+ */
+static void
+_component_Codec_Tlv_FlushBatch(CodecStackState *stackState, CodecConnectionState *codecState)
+{
+    rtaTimer_Stop(codecState->batchTimer);
+
+    if (codecState->batchObjects > 0) {
+        codecState->signingStats.batches++;
+        codecState->signingStats.batchedObjects += codecState->batchObjects;
+
+        if (stackState->signingPool != NULL) {
+            _component_Codec_Tlv_EnqueueBatch(stackState, codecState);
+            codecState->batchObjects = 0;
+            return;
+        }
+
+        _component_Codec_Tlv_SignBatch(&codecState->batch, codecState->batchObjects, codecState->signer);
+        codecState->batchObjects = 0;
+    }
+
+    CodecBatchEntry *entry;
+    while ((entry = TAILQ_FIRST(&codecState->batch)) != NULL) {
+        TAILQ_REMOVE(&codecState->batch, entry, list);
+        _component_Codec_Tlv_SendDown(stackState, entry->tm, codecState->connection);
+        parcMemory_Deallocate((void **) &entry);
+    }
+}
+
+static void
+_component_Codec_Tlv_BatchTimerCallback(int fd, PARCEventType what, void *user_data)
+{
+    CodecConnectionState *codecState = (CodecConnectionState *) user_data;
+    assertTrue(what & PARCEventType_Timeout, "%s got unknown signal %d", __func__, what);
+
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(rtaConnection_GetStack(codecState->connection), CODEC_TLV);
+    _component_Codec_Tlv_FlushBatch(stackState, codecState);
+}
+
+/**
+ * Put a message in the connection's batch.  Returns false, and does not take the message,
+ * if it is not a Content Object to sign and there is no batch for it to wait behind.
+ */
+static bool
+_component_Codec_Tlv_AddToBatch(CodecStackState *stackState, TransportMessage *tm, RtaConnection *conn)
+{
+    CodecConnectionState *codecState = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+    assertNotNull(codecState, "%s got null private data\n", __func__);
+
+    bool batched = _component_Codec_Tlv_IsBatchable(tm);
+    if (!batched && TAILQ_EMPTY(&codecState->batch)) {
+        return false;
+    }
+
+    CodecBatchEntry *entry = parcMemory_AllocateAndClear(sizeof(CodecBatchEntry));
+    assertNotNull(entry, "%s parcMemory_AllocateAndClear(%zu) returned NULL", __func__, sizeof(CodecBatchEntry));
+    entry->tm = tm;
+    entry->batched = batched;
+    TAILQ_INSERT_TAIL(&codecState->batch, entry, list);
+
+    if (batched) {
+        codecState->batchObjects++;
+        if (codecState->batchObjects == 1) {
+            struct timeval timeout = { .tv_sec = stackState->batchDelayMsec / 1000, .tv_usec = (stackState->batchDelayMsec % 1000) * 1000 };
+            rtaTimer_Start(codecState->batchTimer, &timeout);
+        }
+        if (codecState->batchObjects >= stackState->batchSize) {
+            _component_Codec_Tlv_FlushBatch(stackState, codecState);
+        }
+    }
+
+    return true;
+}
+
 /* Read from above and send to below */
 static void
 component_Codec_Tlv_Downcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
 {
     RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
     PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, CODEC_TLV, RTA_DOWN);
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(stack, CODEC_TLV);
     TransportMessage *tm;
 
 
@@ -269,6 +1121,17 @@ component_Codec_Tlv_Downcall_Read(PARCEventQueue *in, PARCEventType event, void
         RtaComponentStats *stats = rtaConnection_GetStats(conn, CODEC_TLV);
         rtaComponentStats_Increment(stats, STATS_DOWNCALL_IN);
 
+        if (stackState->batchSize > 0 && _component_Codec_Tlv_AddToBatch(stackState, tm, conn)) {
+            // the message goes down when the batch is flushed
+            continue;
+        }
+
+        if (stackState->signingPool != NULL) {
+            // the message goes down from _component_Codec_Tlv_Deliver(), maybe later
+            _component_Codec_Tlv_Enqueue(stackState, tm, conn);
+            continue;
+        }
+
         // this will encode everything, including control messages
         TransportMessage *encoded = component_Codec_Tlv_EncodeDictionary(tm, conn);
 
@@ -309,17 +1172,102 @@ component_Codec_Tlv_Closer(RtaConnection *conn)
                (void *) codec_conn_state);
     }
 
-    parcSigner_Release(&codec_conn_state->signer);
+    if (DEBUG_OUTPUT && codec_conn_state->signerCount > 0) {
+        const CodecSigningStats *signingStats = &codec_conn_state->signingStats;
+        printf("%s connection %u encoded %" PRIu64 " max depth %" PRIu64 " mean sign usec %" PRIu64 " max sign usec %" PRIu64 "\n",
+               __func__,
+               rtaConnection_GetConnectionId(conn),
+               signingStats->encoded,
+               signingStats->maxQueueDepth,
+               signingStats->encoded ? signingStats->totalSignUsec / signingStats->encoded : 0,
+               signingStats->maxSignUsec);
+    }
+
+    if (codec_conn_state->batchTimer) {
+        rtaTimer_Stop(codec_conn_state->batchTimer);
+        rtaTimer_Destroy(&codec_conn_state->batchTimer);
+    }
+
+    _codecBatchList_Destroy(&codec_conn_state->batch);
+
+    // component_Codec_Tlv_Flush() sent down what it could.  What is left, messages behind a
+    // job a worker still holds and messages not yet sent up, dies with the connection.  Jobs
+    // a worker still holds are freed when they come back.
+    CodecSignJob *job;
+    while ((job = TAILQ_FIRST(&codec_conn_state->inOrder)) != NULL) {
+        TAILQ_REMOVE(&codec_conn_state->inOrder, job, list);
+        if (!job->submitted || job->finished) {
+            _codecSignJob_Destroy(&job);
+        }
+    }
 
-    parcMemory_Deallocate((void **) &codec_conn_state);
+    CodecDecodeJob *decodeJob;
+    while ((decodeJob = TAILQ_FIRST(&codec_conn_state->upInOrder)) != NULL) {
+        TAILQ_REMOVE(&codec_conn_state->upInOrder, decodeJob, list);
+        if (!decodeJob->needsDecoding || decodeJob->finished) {
+            _codecDecodeJob_Destroy(&decodeJob);
+        }
+    }
+
+    rtaConnection_SetPrivateData(conn, CODEC_TLV, NULL);
+    codec_conn_state->closed = true;
+    codec_conn_state->connection = NULL;
+    codec_conn_state->nextToSubmit = NULL;
+    if (codec_conn_state->outstanding == 0) {
+        _codecConnectionState_Destroy(&codec_conn_state);
+    }
 
     return 0;
 }
 
+/**
+ * The connection is about to close.  Sign and send down the partial batch, and encode here
+ * the jobs no worker has yet, so every message the connection accepted goes down in order.
+ * Only a job still on a worker, and what is behind it, dies with the connection.
+ */
+static void
+component_Codec_Tlv_Flush(RtaConnection *conn)
+{
+    CodecConnectionState *codecState = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+    assertNotNull(codecState, "%s got null private data\n", __func__);
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(rtaConnection_GetStack(conn), CODEC_TLV);
+
+    codecState->flushing = true;
+
+    if (stackState->batchSize > 0) {
+        _component_Codec_Tlv_FlushBatch(stackState, codecState);
+    }
+
+    CodecSignJob *job;
+    while ((job = codecState->nextToSubmit) != NULL) {
+        if (job->needsEncoding) {
+            job->signer = codecState->signer;
+            _component_Codec_Tlv_SignWork(job);
+            job->signer = NULL;
+            job->finished = true;
+            codecState->signingStats.encoded++;
+        }
+        codecState->nextToSubmit = TAILQ_NEXT(job, list);
+    }
+
+    _component_Codec_Tlv_Deliver(codecState);
+}
+
 static int
 component_Codec_Tlv_Release(RtaProtocolStack *stack)
 {
-    // no ProtocolStack wide state
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(stack, CODEC_TLV);
+
+    // finishing every outstanding job frees the last closed connection states
+    if (stackState->signingPool != NULL) {
+        rtaWorkerPool_Destroy(&stackState->signingPool);
+    }
+    if (stackState->decodePool != NULL) {
+        rtaWorkerPool_Destroy(&stackState->decodePool);
+    }
+
+    parcMemory_Deallocate((void **) &stackState);
+    rtaProtocolStack_SetPrivateData(stack, CODEC_TLV, NULL);
     return 0;
 }
 
@@ -343,3 +1291,13 @@ component_Codec_Tlv_StateChange(RtaConnection *conn)
 }
 
 // ==================
+
+const CodecSigningStats *
+componentCodecTlv_GetSigningStats(RtaConnection *conn)
+{
+    CodecConnectionState *codec_state = rtaConnection_GetPrivateData(conn, CODEC_TLV);
+    if (codec_state == NULL) {
+        return NULL;
+    }
+    return &codec_state->signingStats;
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <ccnx/transport/transport_rta/core/rta_Timer.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework_Services.h>
+#include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/config/config_Pit.h>
+
+#include "component_Pit.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+typedef struct pit_connection_state {
+    // not acquired, the state lives only as long as the connection
+    RtaConnection *connection;
+    PitTable *table;
+    RtaTimer *expiryTimer;
+} PitConnectionState;
+
+static int  component_Pit_Init(RtaProtocolStack *stack);
+static int  component_Pit_Opener(RtaConnection *conn);
+static void component_Pit_Upcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static void component_Pit_Downcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static int  component_Pit_Closer(RtaConnection *conn);
+static int  component_Pit_Release(RtaProtocolStack *stack);
+
+RtaComponentOperations pit_ops = {
+    .init          = component_Pit_Init,
+    .open          = component_Pit_Opener,
+    .upcallRead    = component_Pit_Upcall_Read,
+    .upcallEvent   = NULL,
+    .downcallRead  = component_Pit_Downcall_Read,
+    .downcallEvent = NULL,
+    .close         = component_Pit_Closer,
+    .release       = component_Pit_Release,
+    .stateChange   = NULL
+};
+
+// ==================
+
+/**
+ * Schedule the expiry timer for the entry that expires first.  The timer is
+ * one-shot, so an empty table leaves it idle.
+ */
+static void
+_component_Pit_SetTimer(PitConnectionState *state)
+{
+    uint64_t expiryTime;
+    if (!pitTable_NextExpiry(state->table, &expiryTime)) {
+        rtaTimer_Stop(state->expiryTimer);
+        return;
+    }
+
+    ticks now = rtaFramework_GetTicks(rtaConnection_GetFramework(state->connection));
+    uint64_t usec = expiryTime > now ? rtaFramework_TicksToUsec(expiryTime - now) : 0;
+    const unsigned usec_per_sec = 1000000;
+
+    struct timeval timeout;
+    timeout.tv_sec = usec / usec_per_sec;
+    timeout.tv_usec = (int) (usec - timeout.tv_sec * usec_per_sec);
+
+    // this replaces any prior events
+    rtaTimer_Start(state->expiryTimer, &timeout);
+}
+
+/**
+ * Each waiter on an expired entry gets its own INTEREST_TIMEOUT status, just like
+ * each waiter on a satisfied entry gets its own Content Object.
+ */
+static void
+_component_Pit_ExpireEntries(PitConnectionState *state)
+{
+    RtaConnection *conn = state->connection;
+    ticks now = rtaFramework_GetTicks(rtaConnection_GetFramework(conn));
+
+    CCNxTlvDictionary *interest;
+    size_t waiters;
+    while ((interest = pitTable_PopExpired(state->table, now, &waiters)) != NULL) {
+        CCNxName *name = ccnxInterest_GetName(interest);
+
+        if (DEBUG_OUTPUT) {
+            char *uri = ccnxName_ToString(name);
+            printf("%9" PRIu64 " %s connection %u interest %s expired with %zu waiters\n",
+                   now, __func__, rtaConnection_GetConnectionId(conn), uri, waiters);
+            parcMemory_Deallocate((void **) &uri);
+        }
+
+        for (size_t i = 0; i < waiters; i++) {
+            rtaConnection_SendStatus(conn, PIT, RTA_UP, notifyStatusCode_INTEREST_TIMEOUT, name, "Interest lifetime expired");
+        }
+        ccnxTlvDictionary_Release(&interest);
+    }
+}
+
+static void
+_component_Pit_TimerCallback(int fd, PARCEventType what, void *user_data)
+{
+    PitConnectionState *state = (PitConnectionState *) user_data;
+
+    assertTrue(what & PARCEventType_Timeout, "%s got unknown signal %d", __func__, what);
+
+    _component_Pit_ExpireEntries(state);
+    _component_Pit_SetTimer(state);
+}
+
+// ==================
+
+static int
+component_Pit_Init(RtaProtocolStack *stack)
+{
+    // all the state is per-connection
+    return 0;
+}
+
+static int
+component_Pit_Opener(RtaConnection *conn)
+{
+    PARCJSON *params = rtaProtocolStack_GetParameters(rtaConnection_GetStack(conn));
+    size_t maxEntries = localPit_GetMaxEntriesFromConfig(params);
+
+    PitConnectionState *state = parcMemory_AllocateAndClear(sizeof(PitConnectionState));
+    assertNotNull(state, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(PitConnectionState));
+
+    state->connection = conn;
+    state->table = pitTable_Create(maxEntries);
+    state->expiryTimer = rtaTimer_Create(rtaConnection_GetFramework(conn),
+                                               0, _component_Pit_TimerCallback, (void *) state);
+
+    rtaConnection_SetPrivateData(conn, PIT, state);
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, PIT), STATS_OPENS);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s connection %u state %p maxEntries %zu\n",
+               rtaFramework_GetTicks(rtaConnection_GetFramework(conn)),
+               __func__,
+               rtaConnection_GetConnectionId(conn),
+               (void *) state, maxEntries);
+    }
+
+    return 0;
+}
+
+/**
+ * Sends another reference to the Content Object up the stack for an aggregated waiter
+ */
+static void
+_component_Pit_SendCopy(RtaConnection *conn, CCNxTlvDictionary *contentObject, PARCEventQueue *upQueue)
+{
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(conn), rtaConnection_FreeFunc);
+
+    if (rtaComponent_PutMessage(upQueue, tm)) {
+        rtaComponentStats_Increment(rtaConnection_GetStats(conn, PIT), STATS_UPCALL_OUT);
+    }
+}
+
+/* Read from below and send to above.  A Content Object goes up once per waiter. */
+static void
+component_Pit_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, PIT, RTA_UP);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        RtaComponentStats *stats = rtaConnection_GetStats(conn, PIT);
+        rtaComponentStats_Increment(stats, STATS_UPCALL_IN);
+
+        // An unsolicited object (e.g. after its entry expired) is passed up once
+        size_t waiters = 1;
+        PitConnectionState *state = rtaConnection_GetPrivateData(conn, PIT);
+        if (state != NULL && transportMessage_IsContentObject(tm)) {
+            // matching reads the KeyId, and the copies below must share a fully decoded dictionary
+            if (!transportMessage_CompleteDecode(tm)) {
+                transportMessage_Destroy(&tm);
+                continue;
+            }
+
+            size_t satisfied = pitTable_Satisfy(state->table, transportMessage_GetDictionary(tm));
+            if (satisfied > 1) {
+                waiters = satisfied;
+            }
+            _component_Pit_SetTimer(state);
+        }
+
+        // the copies must go up before the original, which we no longer own after the put
+        for (size_t i = 1; i < waiters; i++) {
+            _component_Pit_SendCopy(conn, transportMessage_GetDictionary(tm), out);
+        }
+
+        if (rtaComponent_PutMessage(out, tm)) {
+            rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+        }
+    }
+}
+
+/* Read from above and send to below, unless the Interest duplicates a pending one */
+static void
+component_Pit_Downcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, PIT, RTA_DOWN);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        RtaComponentStats *stats = rtaConnection_GetStats(conn, PIT);
+        rtaComponentStats_Increment(stats, STATS_DOWNCALL_IN);
+
+        PitVerdict verdict = PitVerdict_Untracked;
+        PitConnectionState *state = rtaConnection_GetPrivateData(conn, PIT);
+        if (state != NULL && transportMessage_IsInterest(tm)) {
+            CCNxTlvDictionary *interest = transportMessage_GetDictionary(tm);
+            ticks now = rtaFramework_GetTicks(rtaConnection_GetFramework(conn));
+            ticks expiryTime = now + rtaFramework_MsecToTicks(ccnxInterest_GetLifetime(interest));
+
+            verdict = pitTable_Receive(state->table, interest, expiryTime);
+            if (verdict == PitVerdict_Forward || verdict == PitVerdict_Refresh) {
+                _component_Pit_SetTimer(state);
+            }
+        }
+
+        if (verdict == PitVerdict_Aggregate) {
+            if (DEBUG_OUTPUT) {
+                printf("%9" PRIu64 " %s connection %u interest %p aggregated, %zu pending\n",
+                       rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+                       __func__,
+                       rtaConnection_GetConnectionId(conn),
+                       (void *) tm,
+                       pitTable_Count(state->table));
+            }
+
+            // The table holds the waiter
+            transportMessage_Destroy(&tm);
+        } else {
+            if (rtaComponent_PutMessage(out, tm)) {
+                rtaComponentStats_Increment(stats, STATS_DOWNCALL_OUT);
+            }
+        }
+    }
+}
+
+static int
+component_Pit_Closer(RtaConnection *conn)
+{
+    PitConnectionState *state = rtaConnection_GetPrivateData(conn, PIT);
+    assertNotNull(state, "%s got null private data\n", __func__);
+
+    if (DEBUG_OUTPUT) {
+        const PitTableStats *stats = pitTable_GetStats(state->table);
+        printf("%s connection %u interests %" PRIu64 " aggregated %" PRIu64 " satisfied %" PRIu64 " expired %" PRIu64 "\n",
+               __func__,
+               rtaConnection_GetConnectionId(conn),
+               stats->interests, stats->aggregated, stats->satisfied, stats->expired);
+    }
+
+    // Pending Interests die with the connection, there is no one left to notify
+    rtaTimer_Stop(state->expiryTimer);
+    rtaTimer_Destroy(&state->expiryTimer);
+    pitTable_Destroy(&state->table);
+    parcMemory_Deallocate((void **) &state);
+    rtaConnection_SetPrivateData(conn, PIT, NULL);
+
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, PIT), STATS_CLOSES);
+    return 0;
+}
+
+static int
+component_Pit_Release(RtaProtocolStack *stack)
+{
+    return 0;
+}
+
+// ==================
+
+const PitTableStats *
+componentPit_GetStats(RtaConnection *conn)
+{
+    PitConnectionState *state = rtaConnection_GetPrivateData(conn, PIT);
+    if (state == NULL) {
+        return NULL;
+    }
+    return pitTable_GetStats(state->table);
+}
+
+size_t
+componentPit_GetPendingCount(RtaConnection *conn)
+{
+    PitConnectionState *state = rtaConnection_GetPrivateData(conn, PIT);
+    if (state == NULL) {
+        return 0;
+    }
+    return pitTable_Count(state->table);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file component_Pit.h
+ * @brief A local PIT that collapses duplicate outstanding Interests
+ *
+ * The PIT component tracks every Interest a connection has sent down the stack in a
+ * per-connection `PitTable`, so an application sending raw Interests (without a flow
+ * controller) does not put identical Interests in flight.  It must sit above the codec,
+ * because it works on decoded dictionaries:
+ *
+ * { SYSTEM : COMPONENTS : [API_CONNECTOR, PIT, CODEC_TLV, FWD_METIS] }
+ *
+ * Down Stack Behavior: a new Interest is recorded and passed down.  A duplicate (same name,
+ * KeyId restriction, and ContentObjectHash restriction) adds a waiter to the pending entry and
+ * is consumed, unless its lifetime extends past the entry's.  Then it is passed down instead of
+ * adding a waiter, and the forwarder's answer to it comes up like any other object.
+ * If the table is full, Interests are passed down untracked.
+ *
+ * Up Stack Behavior: a Content Object that satisfies pending entries is passed up once per waiter.
+ * Unsolicited Content Objects are passed up once.  Everything else is passed up unaltered.
+ *
+ * Expiry: when an entry's lifetime passes without a Content Object, each waiter gets a
+ * `notifyStatusCode_INTEREST_TIMEOUT` status with the Interest's name.
+ *
+ * The table size is set with `localPit_ProtocolStackConfig()`.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_component_Pit_h
+#define Libccnx_component_Pit_h
+
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/components/pit_Table.h>
+
+extern RtaComponentOperations pit_ops;
+
+/**
+ * Returns the cumulative counters of the connection's PIT
+ *
+ * @param [in] conn A connection on a stack configured with the PIT component
+ *
+ * @return non-null The table counters, do not free
+ * @return null The connection does not have PIT state
+ *
+ * Example:
+ * @code
+ * {
+ *     const PitTableStats *stats = componentPit_GetStats(conn);
+ *     printf("aggregated %" PRIu64 " of %" PRIu64 "\n", stats->aggregated, stats->interests);
+ * }
+ * @endcode
+ */
+const PitTableStats *componentPit_GetStats(RtaConnection *conn);
+
+/**
+ * The number of distinct Interests pending on the connection
+ *
+ * @param [in] conn A connection on a stack configured with the PIT component
+ *
+ * @return The number of entries in the connection's table, 0 if it has none
+ */
+size_t componentPit_GetPendingCount(RtaConnection *conn);
+#endif // Libccnx_component_Pit_h
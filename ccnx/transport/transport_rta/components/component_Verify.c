@@ -0,0 +1,601 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_CryptoHasher.h>
+#include <parc/security/parc_InMemoryVerifier.h>
+#include <parc/security/parc_Signature.h>
+#include <parc/security/parc_Verifier.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/internal/ccnx_ValidationFacadeV1.h>
+#include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_TlvDictionary.h>
+
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework_Services.h>
+#include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/core/rta_WorkerPool.h>
+#include <ccnx/transport/transport_rta/config/config_VerifyEnumerated.h>
+
+#include "component_Verify.h"
+#include "verify_KeyCache.h"
+#include "codec_MerkleTree.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+typedef enum {
+    VerifyResult_Pending,       // a worker has it
+    VerifyResult_Passed,        // deliver it
+    VerifyResult_Failed         // drop it and tell the application
+} VerifyResult;
+
+struct verify_connection_state;
+
+typedef struct verify_job {
+    struct verify_connection_state *state;
+    TransportMessage *tm;
+
+    // acquired, only set for jobs given to a worker
+    PARCKey *key;
+
+    VerifyResult result;
+    const char *reason;
+
+    TAILQ_ENTRY(verify_job) list;
+} VerifyJob;
+
+typedef struct verify_connection_state {
+    // not acquired, the state lives only as long as the connection
+    RtaConnection *connection;
+    VerifyKeyCache *keyCache;
+
+    // every message going up, in arrival order, while a verification is outstanding
+    TAILQ_HEAD(, verify_job) inOrder;
+
+    // jobs still held by the worker pool
+    size_t outstanding;
+    bool closed;
+
+    VerifyStats stats;
+} VerifyConnectionState;
+
+typedef struct verify_stack_state {
+    RtaWorkerPool *pool;
+} VerifyStackState;
+
+static int  component_Verify_Init(RtaProtocolStack *stack);
+static int  component_Verify_Opener(RtaConnection *conn);
+static void component_Verify_Upcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static void component_Verify_Downcall_Read(PARCEventQueue *, PARCEventType event, void *stack);
+static int  component_Verify_Closer(RtaConnection *conn);
+static int  component_Verify_Release(RtaProtocolStack *stack);
+
+RtaComponentOperations verify_ops = {
+    .init          = component_Verify_Init,
+    .open          = component_Verify_Opener,
+    .upcallRead    = component_Verify_Upcall_Read,
+    .upcallEvent   = NULL,
+    .downcallRead  = component_Verify_Downcall_Read,
+    .downcallEvent = NULL,
+    .close         = component_Verify_Closer,
+    .release       = component_Verify_Release,
+    .stateChange   = NULL
+};
+
+// ==================
+
+static VerifyJob *
+_verifyJob_Create(VerifyConnectionState *state, TransportMessage *tm, VerifyResult result, const char *reason)
+{
+    VerifyJob *job = parcMemory_AllocateAndClear(sizeof(VerifyJob));
+    assertNotNull(job, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(VerifyJob));
+    job->state = state;
+    job->tm = tm;
+    job->result = result;
+    job->reason = reason;
+    return job;
+}
+
+static void
+_verifyJob_Destroy(VerifyJob **jobPtr)
+{
+    VerifyJob *job = *jobPtr;
+    if (job->tm) {
+        transportMessage_Destroy(&job->tm);
+    }
+    if (job->key) {
+        parcKey_Release(&job->key);
+    }
+    parcMemory_Deallocate((void **) jobPtr);
+}
+
+static void
+_verifyConnectionState_Destroy(VerifyConnectionState **statePtr)
+{
+    VerifyConnectionState *state = *statePtr;
+    assertTrue(state->outstanding == 0, "Destroying state with %zu outstanding jobs", state->outstanding);
+    verifyKeyCache_Destroy(&state->keyCache);
+    parcMemory_Deallocate((void **) statePtr);
+}
+
+/**
+ * The signing algorithm of a Content Object, from its crypto suite.  Only public key
+ * suites can be verified against a trusted key.
+ */
+static bool
+_component_Verify_GetSigningAlgorithm(const CCNxTlvDictionary *contentObject, PARCSigningAlgorithm *algorithmPtr)
+{
+    if (!ccnxTlvDictionary_IsValueInteger(contentObject, CCNxCodecSchemaV1TlvDictionary_ValidationFastArray_CRYPTO_SUITE)) {
+        return false;
+    }
+
+    PARCCryptoSuite suite = (PARCCryptoSuite) ccnxTlvDictionary_GetInteger(contentObject, CCNxCodecSchemaV1TlvDictionary_ValidationFastArray_CRYPTO_SUITE);
+    switch (suite) {
+        case PARCCryptoSuite_RSA_SHA256:
+            *algorithmPtr = PARCSigningAlgorithm_RSA;
+            return true;
+
+        case PARCCryptoSuite_EC_SECP_256K1:
+            *algorithmPtr = PARCSigningAlgorithm_ECDSA;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static PARCCryptoSuite
+_component_Verify_GetCryptoSuite(PARCKey *key)
+{
+    switch (parcKey_GetSigningAlgorithm(key)) {
+        case PARCSigningAlgorithm_ECDSA:
+            return PARCCryptoSuite_EC_SECP_256K1;
+
+        default:
+            return PARCCryptoSuite_RSA_SHA256;
+    }
+}
+
+/**
+ * The Merkle leaf of a received Content Object: SHA-256 over its CCNx message TLV, the same
+ * bytes the codec hashed before it added the validation sections.
+ */
+static PARCBuffer *
+_component_Verify_CreateLeafDigest(PARCBuffer *wireFormat)
+{
+    PARCBuffer *packet = parcBuffer_Slice(wireFormat);
+    size_t length = parcBuffer_Remaining(packet);
+    PARCBuffer *digest = NULL;
+
+    // The last byte of the 8 byte fixed header is the header length, the message TLV follows the headers
+    if (length >= 8) {
+        size_t start = parcBuffer_GetAtIndex(packet, 7);
+        if (start + 4 <= length) {
+            size_t end = start + 4 + (((size_t) parcBuffer_GetAtIndex(packet, start + 2) << 8) | parcBuffer_GetAtIndex(packet, start + 3));
+            if (end <= length) {
+                parcBuffer_SetLimit(packet, end);
+                parcBuffer_SetPosition(packet, start);
+
+                PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+                parcCryptoHasher_Init(hasher);
+                parcCryptoHasher_UpdateBuffer(hasher, packet);
+                PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+                digest = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
+                parcCryptoHash_Release(&hash);
+                parcCryptoHasher_Release(&hasher);
+            }
+        }
+    }
+
+    parcBuffer_Release(&packet);
+    return digest;
+}
+
+/**
+ * A Content Object signed in a batch (see codec_MerkleTree.h) carries a proof from its leaf to
+ * the Merkle root, and the signature covers the root.  Returns the root as the digest to verify
+ * and the root signature in `rootSignaturePtr`, or NULL if the payload or packet is malformed.
+ */
+static PARCCryptoHash *
+_component_Verify_CreateBatchDigest(CCNxTlvDictionary *contentObject, PARCBuffer *payload, PARCBuffer **rootSignaturePtr)
+{
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(contentObject);
+    if (wireFormat == NULL) {
+        return NULL;
+    }
+
+    PARCBuffer *leaf = _component_Verify_CreateLeafDigest(wireFormat);
+    if (leaf == NULL) {
+        return NULL;
+    }
+
+    PARCBuffer *proof = parcBuffer_Slice(payload);
+    parcBuffer_SetPosition(proof, CODEC_MERKLE_BATCH_MAGIC_LENGTH);
+
+    PARCCryptoHash *digest = NULL;
+    PARCBuffer *root = codecMerkleTree_CreateRootFromProof(leaf, proof);
+    if (root != NULL) {
+        // the root signature is everything after the proof
+        if (parcBuffer_Remaining(proof) > 0) {
+            digest = parcCryptoHash_Create(PARC_HASH_SHA256, root);
+            *rootSignaturePtr = parcBuffer_Slice(proof);
+        }
+        parcBuffer_Release(&root);
+    }
+
+    parcBuffer_Release(&proof);
+    parcBuffer_Release(&leaf);
+    return digest;
+}
+
+/**
+ * Runs on a worker thread.  It only reads the message dictionary and the key, which
+ * the RTA thread does not touch until the job comes back.
+ */
+static void
+_component_Verify_Work(void *arg)
+{
+    VerifyJob *job = (VerifyJob *) arg;
+    CCNxTlvDictionary *contentObject = transportMessage_GetDictionary(job->tm);
+
+    job->result = VerifyResult_Failed;
+    job->reason = "Signature does not verify";
+
+    PARCBuffer *signatureBits = ccnxValidationFacadeV1_GetPayload(contentObject);
+    if (signatureBits == NULL) {
+        job->reason = "Missing signature";
+        return;
+    }
+
+    PARCCryptoHash *digest;
+    PARCBuffer *rootSignatureBits = NULL;
+    if (codecMerkleTree_IsBatchPayload(signatureBits)) {
+        digest = _component_Verify_CreateBatchDigest(contentObject, signatureBits, &rootSignatureBits);
+        if (digest == NULL) {
+            job->reason = "Malformed batch signature";
+            return;
+        }
+        signatureBits = rootSignatureBits;
+    } else {
+        PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+        digest = ccnxWireFormatMessage_HashProtectedRegion(contentObject, hasher);
+        parcCryptoHasher_Release(&hasher);
+        if (digest == NULL) {
+            job->reason = "Missing wire format";
+            return;
+        }
+    }
+
+    // Each job gets its own verifier, they are not safe to share between threads
+    PARCInMemoryVerifier *inMemoryVerifier = parcInMemoryVerifier_Create();
+    PARCVerifier *verifier = parcVerifier_Create(inMemoryVerifier, PARCInMemoryVerifierAsVerifier);
+    parcInMemoryVerifier_Release(&inMemoryVerifier);
+    parcVerifier_AddKey(verifier, job->key);
+
+    PARCSignature *signature = parcSignature_Create(parcKey_GetSigningAlgorithm(job->key), PARC_HASH_SHA256, signatureBits);
+
+    if (parcVerifier_VerifyDigestSignature(verifier, parcKey_GetKeyId(job->key), digest,
+                                           _component_Verify_GetCryptoSuite(job->key), signature)) {
+        job->result = VerifyResult_Passed;
+        job->reason = NULL;
+    }
+
+    parcSignature_Release(&signature);
+    parcVerifier_Release(&verifier);
+    parcCryptoHash_Release(&digest);
+    if (rootSignatureBits != NULL) {
+        parcBuffer_Release(&rootSignatureBits);
+    }
+}
+
+/**
+ * Deliver or drop every message at the head of the connection's list that is no
+ * longer waiting for a worker.
+ */
+static void
+_component_Verify_Deliver(VerifyConnectionState *state)
+{
+    RtaConnection *conn = state->connection;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(rtaConnection_GetStack(conn), VERIFY_ENUMERATED, RTA_UP);
+    RtaComponentStats *stats = rtaConnection_GetStats(conn, VERIFY_ENUMERATED);
+
+    VerifyJob *job;
+    while ((job = TAILQ_FIRST(&state->inOrder)) != NULL && job->result != VerifyResult_Pending) {
+        TAILQ_REMOVE(&state->inOrder, job, list);
+
+        if (job->result == VerifyResult_Passed) {
+            if (rtaComponent_PutMessage(out, job->tm)) {
+                rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+            }
+            job->tm = NULL;
+        } else {
+            CCNxName *name = ccnxContentObject_GetName(transportMessage_GetDictionary(job->tm));
+            rtaConnection_SendStatus(conn, VERIFY_ENUMERATED, RTA_UP, notifyStatusCode_VERIFICATION_ERROR, name, job->reason);
+        }
+
+        _verifyJob_Destroy(&job);
+    }
+}
+
+/**
+ * Runs on the RTA thread when a worker is done with a job
+ */
+static void
+_component_Verify_Done(void *arg, void *doneContext)
+{
+    VerifyJob *job = (VerifyJob *) arg;
+    VerifyConnectionState *state = job->state;
+
+    state->outstanding--;
+
+    if (state->closed) {
+        // The job was taken off the connection's list when it closed
+        _verifyJob_Destroy(&job);
+        if (state->outstanding == 0) {
+            _verifyConnectionState_Destroy(&state);
+        }
+        return;
+    }
+
+    if (job->result == VerifyResult_Passed) {
+        state->stats.verified++;
+    } else {
+        state->stats.failed++;
+    }
+
+    _component_Verify_Deliver(state);
+}
+
+/**
+ * Decide what to do with a message coming up the stack.  Returns the key that will verify it,
+ * or NULL with the result set if no worker is needed.
+ */
+static PARCKey *
+_component_Verify_Classify(VerifyConnectionState *state, TransportMessage *tm, VerifyResult *resultPtr, const char **reasonPtr)
+{
+    *resultPtr = VerifyResult_Passed;
+    *reasonPtr = NULL;
+
+    if (!transportMessage_IsContentObject(tm)) {
+        return NULL;
+    }
+
+    CCNxTlvDictionary *contentObject = transportMessage_GetDictionary(tm);
+    PARCBuffer *keyId = ccnxValidationFacadeV1_GetKeyId(contentObject);
+    if (keyId == NULL) {
+        // Not signed with a key, e.g. a CRC32C or no validation at all
+        state->stats.unsignedObjects++;
+        return NULL;
+    }
+
+    if (!verifyKeyCache_IsTrusted(state->keyCache, keyId)) {
+        state->stats.untrusted++;
+        *resultPtr = VerifyResult_Failed;
+        *reasonPtr = "KeyId not trusted";
+        return NULL;
+    }
+
+    PARCKey *key = verifyKeyCache_GetKey(state->keyCache, keyId);
+    if (key == NULL) {
+        PARCSigningAlgorithm algorithm;
+        if (_component_Verify_GetSigningAlgorithm(contentObject, &algorithm)) {
+            key = verifyKeyCache_LearnKey(state->keyCache, keyId, algorithm, ccnxValidationFacadeV1_GetPublicKey(contentObject));
+            if (key != NULL) {
+                state->stats.keysLearned++;
+            }
+        }
+    }
+
+    if (key == NULL) {
+        state->stats.untrusted++;
+        *resultPtr = VerifyResult_Failed;
+        *reasonPtr = "Public key for trusted KeyId not known";
+        return NULL;
+    }
+
+    *resultPtr = VerifyResult_Pending;
+    return key;
+}
+
+// ==================
+
+static int
+component_Verify_Init(RtaProtocolStack *stack)
+{
+    unsigned workerCount = verifyEnumerated_GetWorkersFromConfig(rtaProtocolStack_GetParameters(stack));
+
+    VerifyStackState *stackState = parcMemory_AllocateAndClear(sizeof(VerifyStackState));
+    assertNotNull(stackState, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(VerifyStackState));
+
+    stackState->pool = rtaWorkerPool_Create(rtaFramework_GetEventScheduler(rtaProtocolStack_GetFramework(stack)),
+                                            workerCount, _component_Verify_Done, NULL);
+    rtaProtocolStack_SetPrivateData(stack, VERIFY_ENUMERATED, stackState);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s stack %d workers %u\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+               __func__,
+               rtaProtocolStack_GetStackId(stack),
+               workerCount);
+    }
+
+    return 0;
+}
+
+static int
+component_Verify_Opener(RtaConnection *conn)
+{
+    VerifyConnectionState *state = parcMemory_AllocateAndClear(sizeof(VerifyConnectionState));
+    assertNotNull(state, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(VerifyConnectionState));
+
+    state->connection = conn;
+    state->keyCache = verifyKeyCache_Create();
+    TAILQ_INIT(&state->inOrder);
+
+    PARCJSON *params = rtaConnection_GetParameters(conn);
+    size_t count = verifyEnumerated_GetTrustedKeyIdCount(params);
+    for (size_t i = 0; i < count; i++) {
+        PARCBuffer *keyId = verifyEnumerated_CreateTrustedKeyId(params, i);
+        verifyKeyCache_AddTrustedKeyId(state->keyCache, keyId);
+        parcBuffer_Release(&keyId);
+    }
+
+    rtaConnection_SetPrivateData(conn, VERIFY_ENUMERATED, state);
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, VERIFY_ENUMERATED), STATS_OPENS);
+    return 0;
+}
+
+/* Read from below and send to above, in order, once each Content Object is verified */
+static void
+component_Verify_Upcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    VerifyStackState *stackState = rtaProtocolStack_GetPrivateData(stack, VERIFY_ENUMERATED);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        rtaComponentStats_Increment(rtaConnection_GetStats(conn, VERIFY_ENUMERATED), STATS_UPCALL_IN);
+
+        VerifyConnectionState *state = rtaConnection_GetPrivateData(conn, VERIFY_ENUMERATED);
+
+        // verification reads the validation section and hashes the protected region
+        if (!transportMessage_CompleteDecode(tm)) {
+            transportMessage_Destroy(&tm);
+            continue;
+        }
+
+        VerifyResult result;
+        const char *reason;
+        PARCKey *key = _component_Verify_Classify(state, tm, &result, &reason);
+
+        VerifyJob *job = _verifyJob_Create(state, tm, result, reason);
+        TAILQ_INSERT_TAIL(&state->inOrder, job, list);
+
+        if (key != NULL) {
+            job->key = parcKey_Acquire(key);
+            state->outstanding++;
+            rtaWorkerPool_Submit(stackState->pool, _component_Verify_Work, job);
+        }
+
+        _component_Verify_Deliver(state);
+    }
+}
+
+/* Read from above and send to below */
+static void
+component_Verify_Downcall_Read(PARCEventQueue *in, PARCEventType event, void *ptr)
+{
+    RtaProtocolStack *stack = (RtaProtocolStack *) ptr;
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(stack, VERIFY_ENUMERATED, RTA_DOWN);
+    TransportMessage *tm;
+
+    while ((tm = rtaComponent_GetMessage(in)) != NULL) {
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        RtaComponentStats *stats = rtaConnection_GetStats(conn, VERIFY_ENUMERATED);
+        rtaComponentStats_Increment(stats, STATS_DOWNCALL_IN);
+
+        if (rtaComponent_PutMessage(out, tm)) {
+            rtaComponentStats_Increment(stats, STATS_DOWNCALL_OUT);
+        }
+    }
+}
+
+static int
+component_Verify_Closer(RtaConnection *conn)
+{
+    VerifyConnectionState *state = rtaConnection_GetPrivateData(conn, VERIFY_ENUMERATED);
+    assertNotNull(state, "%s got null private data\n", __func__);
+
+    if (DEBUG_OUTPUT) {
+        printf("%s connection %u verified %" PRIu64 " failed %" PRIu64 " untrusted %" PRIu64 " unsigned %" PRIu64 "\n",
+               __func__,
+               rtaConnection_GetConnectionId(conn),
+               state->stats.verified, state->stats.failed, state->stats.untrusted, state->stats.unsignedObjects);
+    }
+
+    // Messages not yet delivered die with the connection.  Jobs a worker still
+    // holds are freed when they come back.
+    VerifyJob *job;
+    while ((job = TAILQ_FIRST(&state->inOrder)) != NULL) {
+        TAILQ_REMOVE(&state->inOrder, job, list);
+        if (job->result != VerifyResult_Pending) {
+            _verifyJob_Destroy(&job);
+        }
+    }
+
+    rtaConnection_SetPrivateData(conn, VERIFY_ENUMERATED, NULL);
+    state->closed = true;
+    state->connection = NULL;
+    if (state->outstanding == 0) {
+        _verifyConnectionState_Destroy(&state);
+    }
+
+    rtaComponentStats_Increment(rtaConnection_GetStats(conn, VERIFY_ENUMERATED), STATS_CLOSES);
+    return 0;
+}
+
+static int
+component_Verify_Release(RtaProtocolStack *stack)
+{
+    VerifyStackState *stackState = rtaProtocolStack_GetPrivateData(stack, VERIFY_ENUMERATED);
+
+    // finishes every outstanding job, which frees the last closed connection states
+    rtaWorkerPool_Destroy(&stackState->pool);
+    parcMemory_Deallocate((void **) &stackState);
+    rtaProtocolStack_SetPrivateData(stack, VERIFY_ENUMERATED, NULL);
+    return 0;
+}
+
+// ==================
+
+const VerifyStats *
+componentVerify_GetStats(RtaConnection *conn)
+{
+    VerifyConnectionState *state = rtaConnection_GetPrivateData(conn, VERIFY_ENUMERATED);
+    if (state == NULL) {
+        return NULL;
+    }
+    return &state->stats;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file component_Verify.h
+ * @brief Verifies Content Object signatures against an enumerated set of trusted keys
+ *
+ * The VERIFY_ENUMERATED component checks the signature of every Content Object on the upcall
+ * path, so applications do not each verify content on their own threads.  It must sit above
+ * the codec, because it works on decoded dictionaries with their wire format:
+ *
+ * { SYSTEM : COMPONENTS : [API_CONNECTOR, FC_VEGAS, VERIFY_ENUMERATED, CODEC_TLV, FWD_METIS] }
+ *
+ * Each connection trusts the KeyIds listed in its configuration (see `config_VerifyEnumerated.h`).
+ * The public key for a trusted KeyId is learned from the first Content Object that embeds it and
+ * then cached for the life of the connection.
+ *
+ * Up Stack Behavior:
+ * - A Content Object signed by a trusted key is given to a worker thread for the public key
+ *   operation and passed up if the signature verifies.
+ * - A Content Object signed in a batch by the TLV codec (see codec_MerkleTree.h) is checked the
+ *   same way, except that its inclusion proof leads to the Merkle root and the root is what the
+ *   signature must cover.
+ * - A Content Object whose KeyId is not trusted, whose key is not known, or whose signature does
+ *   not verify is dropped, and a `notifyStatusCode_VERIFICATION_ERROR` status is sent up instead.
+ * - Content Objects without a KeyId (unsigned or CRC32C) and all other messages are passed up.
+ * - Messages leave the component in the order they arrived on their connection, so a quick
+ *   message never overtakes one that is still being verified.
+ *
+ * Down Stack Behavior: everything is passed down unaltered.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_component_Verify_h
+#define Libccnx_component_Verify_h
+
+#include <stdint.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+
+extern RtaComponentOperations verify_ops;
+
+/**
+ * Counters kept for each connection.  They are cumulative over the life of the connection.
+ */
+typedef struct verify_stats {
+    uint64_t verified;          // signatures that verified
+    uint64_t failed;            // signatures that did not verify
+    uint64_t untrusted;         // objects dropped without a public key operation
+    uint64_t unsignedObjects;   // objects without a KeyId, passed up unverified
+    uint64_t keysLearned;       // public keys cached from a KeyLocator
+} VerifyStats;
+
+/**
+ * Returns the verification counters of a connection
+ *
+ * @param [in] conn A connection on a stack configured with the VERIFY_ENUMERATED component
+ *
+ * @return non-null The connection's counters, do not free
+ * @return null The connection does not have verifier state
+ *
+ * Example:
+ * @code
+ * {
+ *     const VerifyStats *stats = componentVerify_GetStats(conn);
+ *     printf("verified %" PRIu64 " failed %" PRIu64 "\n", stats->verified, stats->failed);
+ * }
+ * @endcode
+ */
+const VerifyStats *componentVerify_GetStats(RtaConnection *conn);
+#endif // Libccnx_component_Verify_h
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_CryptoHash.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/internal/ccnx_ValidationFacadeV1.h>
+
+#include "pit_Table.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+#define MIN_BUCKETS 16
+
+typedef struct pit_entry {
+    uint64_t nameHash;
+    CCNxTlvDictionary *interest;
+
+    // the name and restrictions are owned by interest
+    const CCNxName *name;
+    const PARCBuffer *keyIdRestriction;
+    const PARCBuffer *hashRestriction;
+
+    uint64_t expiryTime;
+    size_t waiters;
+
+    LIST_ENTRY(pit_entry) bucketList;
+    TAILQ_ENTRY(pit_entry) expiryList;
+} PitEntry;
+
+LIST_HEAD(pit_bucket, pit_entry);
+
+struct pit_table {
+    size_t maxEntries;
+    size_t entryCount;
+
+    // bucketCount is a power of 2
+    size_t bucketCount;
+    struct pit_bucket *buckets;
+
+    // ordered by expiryTime, head expires first
+    TAILQ_HEAD(pit_expiry, pit_entry) expiryHead;
+
+    PitTableStats stats;
+};
+
+// ==================
+
+static size_t
+_pitTable_BucketCount(size_t maxEntries)
+{
+    size_t count = MIN_BUCKETS;
+    while (count < maxEntries) {
+        count <<= 1;
+    }
+    return count;
+}
+
+static struct pit_bucket *
+_pitTable_GetBucket(PitTable *table, uint64_t nameHash)
+{
+    return &table->buckets[nameHash & (table->bucketCount - 1)];
+}
+
+static bool
+_pitTable_BufferEquals(const PARCBuffer *a, const PARCBuffer *b)
+{
+    if (a == NULL || b == NULL) {
+        return a == b;
+    }
+    return parcBuffer_Equals(a, b);
+}
+
+/**
+ * Insert the entry on the expiry list.  Lifetimes are usually similar, so
+ * search from the tail.
+ */
+static void
+_pitTable_InsertExpiry(PitTable *table, PitEntry *entry)
+{
+    PitEntry *prev = TAILQ_LAST(&table->expiryHead, pit_expiry);
+    while (prev != NULL && prev->expiryTime > entry->expiryTime) {
+        prev = TAILQ_PREV(prev, pit_expiry, expiryList);
+    }
+
+    if (prev == NULL) {
+        TAILQ_INSERT_HEAD(&table->expiryHead, entry, expiryList);
+    } else {
+        TAILQ_INSERT_AFTER(&table->expiryHead, prev, entry, expiryList);
+    }
+}
+
+static void
+_pitTable_RemoveEntry(PitTable *table, PitEntry *entry)
+{
+    LIST_REMOVE(entry, bucketList);
+    TAILQ_REMOVE(&table->expiryHead, entry, expiryList);
+    table->entryCount--;
+
+    ccnxTlvDictionary_Release(&entry->interest);
+    parcMemory_Deallocate((void **) &entry);
+}
+
+static bool
+_pitTable_ObjectSatisfies(const PitEntry *entry, const CCNxName *name, uint64_t nameHash,
+                          const PARCBuffer *keyId, const CCNxTlvDictionary *contentObject, PARCBuffer **objectHashPtr)
+{
+    if (entry->nameHash != nameHash || !ccnxName_Equals(entry->name, name)) {
+        return false;
+    }
+
+    if (entry->keyIdRestriction != NULL && !_pitTable_BufferEquals(entry->keyIdRestriction, keyId)) {
+        return false;
+    }
+
+    if (entry->hashRestriction != NULL) {
+        // only hash the object if some entry asks for it
+        if (*objectHashPtr == NULL) {
+            PARCCryptoHash *hash = ccnxWireFormatMessage_CreateContentObjectHash((CCNxTlvDictionary *) contentObject);
+            if (hash == NULL) {
+                return false;
+            }
+            *objectHashPtr = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
+            parcCryptoHash_Release(&hash);
+        }
+        if (!parcBuffer_Equals(*objectHashPtr, entry->hashRestriction)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ==================
+
+PitTable *
+pitTable_Create(size_t maxEntries)
+{
+    assertTrue(maxEntries > 0, "Parameter maxEntries must be positive");
+
+    PitTable *table = parcMemory_AllocateAndClear(sizeof(PitTable));
+    assertNotNull(table, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(PitTable));
+
+    table->maxEntries = maxEntries;
+    table->bucketCount = _pitTable_BucketCount(maxEntries);
+
+    table->buckets = parcMemory_AllocateAndClear(table->bucketCount * sizeof(struct pit_bucket));
+    assertNotNull(table->buckets, "parcMemory_AllocateAndClear(%zu) returned NULL", table->bucketCount * sizeof(struct pit_bucket));
+
+    for (size_t i = 0; i < table->bucketCount; i++) {
+        LIST_INIT(&table->buckets[i]);
+    }
+    TAILQ_INIT(&table->expiryHead);
+
+    return table;
+}
+
+void
+pitTable_Destroy(PitTable **tablePtr)
+{
+    assertNotNull(tablePtr, "Parameter tablePtr must be non-null");
+    PitTable *table = *tablePtr;
+    assertNotNull(table, "Parameter tablePtr must dereference to non-null");
+
+    while (!TAILQ_EMPTY(&table->expiryHead)) {
+        _pitTable_RemoveEntry(table, TAILQ_FIRST(&table->expiryHead));
+    }
+
+    parcMemory_Deallocate((void **) &table->buckets);
+    parcMemory_Deallocate((void **) &table);
+    *tablePtr = NULL;
+}
+
+PitVerdict
+pitTable_Receive(PitTable *table, CCNxTlvDictionary *interest, uint64_t expiryTime)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    assertNotNull(interest, "Parameter interest must be non-null");
+
+    table->stats.interests++;
+
+    const CCNxName *name = ccnxInterest_GetName(interest);
+    if (name == NULL) {
+        table->stats.untracked++;
+        return PitVerdict_Untracked;
+    }
+
+    const PARCBuffer *keyIdRestriction = ccnxInterest_GetKeyIdRestriction(interest);
+    const PARCBuffer *hashRestriction = ccnxInterest_GetContentObjectHashRestriction(interest);
+
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct pit_bucket *bucket = _pitTable_GetBucket(table, nameHash);
+
+    PitEntry *entry;
+    LIST_FOREACH(entry, bucket, bucketList)
+    {
+        if (entry->nameHash == nameHash && ccnxName_Equals(entry->name, name) &&
+            _pitTable_BufferEquals(entry->keyIdRestriction, keyIdRestriction) &&
+            _pitTable_BufferEquals(entry->hashRestriction, hashRestriction)) {
+            // A refresh goes down, so the forwarder answers it.  It is not a waiter, or the
+            // object would come up once for the waiter and again for the forwarder's reply.
+            if (expiryTime > entry->expiryTime) {
+                entry->expiryTime = expiryTime;
+                TAILQ_REMOVE(&table->expiryHead, entry, expiryList);
+                _pitTable_InsertExpiry(table, entry);
+                return PitVerdict_Refresh;
+            }
+
+            entry->waiters++;
+            table->stats.aggregated++;
+            return PitVerdict_Aggregate;
+        }
+    }
+
+    if (table->entryCount >= table->maxEntries) {
+        table->stats.untracked++;
+        return PitVerdict_Untracked;
+    }
+
+    entry = parcMemory_AllocateAndClear(sizeof(PitEntry));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(PitEntry));
+
+    entry->nameHash = nameHash;
+    entry->interest = ccnxTlvDictionary_Acquire(interest);
+    entry->name = name;
+    entry->keyIdRestriction = keyIdRestriction;
+    entry->hashRestriction = hashRestriction;
+    entry->expiryTime = expiryTime;
+    entry->waiters = 1;
+
+    LIST_INSERT_HEAD(bucket, entry, bucketList);
+    _pitTable_InsertExpiry(table, entry);
+    table->entryCount++;
+
+    if (DEBUG_OUTPUT) {
+        printf("%s table %p entry %p hash %016" PRIX64 " expiry %" PRIu64 " count %zu\n",
+               __func__, (void *) table, (void *) entry, nameHash, expiryTime, table->entryCount);
+    }
+
+    return PitVerdict_Forward;
+}
+
+size_t
+pitTable_Satisfy(PitTable *table, const CCNxTlvDictionary *contentObject)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    assertNotNull(contentObject, "Parameter contentObject must be non-null");
+
+    const CCNxName *name = ccnxContentObject_GetName(contentObject);
+    if (name == NULL) {
+        return 0;
+    }
+
+    const PARCBuffer *keyId = ccnxValidationFacadeV1_GetKeyId(contentObject);
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct pit_bucket *bucket = _pitTable_GetBucket(table, nameHash);
+
+    PARCBuffer *objectHash = NULL;
+    size_t waiters = 0;
+
+    PitEntry *entry = LIST_FIRST(bucket);
+    while (entry != NULL) {
+        PitEntry *next = LIST_NEXT(entry, bucketList);
+
+        if (_pitTable_ObjectSatisfies(entry, name, nameHash, keyId, contentObject, &objectHash)) {
+            waiters += entry->waiters;
+            table->stats.satisfied++;
+            _pitTable_RemoveEntry(table, entry);
+        }
+
+        entry = next;
+    }
+
+    if (objectHash != NULL) {
+        parcBuffer_Release(&objectHash);
+    }
+
+    table->stats.waitersServed += waiters;
+    return waiters;
+}
+
+CCNxTlvDictionary *
+pitTable_PopExpired(PitTable *table, uint64_t now, size_t *waitersPtr)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+
+    PitEntry *entry = TAILQ_FIRST(&table->expiryHead);
+    if (entry == NULL || entry->expiryTime > now) {
+        return NULL;
+    }
+
+    CCNxTlvDictionary *interest = ccnxTlvDictionary_Acquire(entry->interest);
+    if (waitersPtr != NULL) {
+        *waitersPtr = entry->waiters;
+    }
+
+    table->stats.expired++;
+    _pitTable_RemoveEntry(table, entry);
+    return interest;
+}
+
+bool
+pitTable_NextExpiry(const PitTable *table, uint64_t *expiryTimePtr)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    assertNotNull(expiryTimePtr, "Parameter expiryTimePtr must be non-null");
+
+    PitEntry *entry = TAILQ_FIRST(&table->expiryHead);
+    if (entry == NULL) {
+        return false;
+    }
+    *expiryTimePtr = entry->expiryTime;
+    return true;
+}
+
+size_t
+pitTable_Count(const PitTable *table)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    return table->entryCount;
+}
+
+const PitTableStats *
+pitTable_GetStats(const PitTable *table)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    return &table->stats;
+}
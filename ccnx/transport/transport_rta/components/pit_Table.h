@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file pit_Table.h
+ * @brief A per-connection table of outstanding Interests
+ *
+ * The table records every Interest a connection has sent down the stack until it is
+ * satisfied by a Content Object or its lifetime expires.  Entries are indexed by the hash
+ * of the name in a power-of-two bucket array.  Two Interests are duplicates if they have
+ * equal names, equal KeyId restrictions, and equal ContentObjectHash restrictions.  A
+ * duplicate does not create a new entry, it adds a waiter to the existing entry unless it
+ * refreshes the entry's lifetime.
+ *
+ * Entries are also kept on a list ordered by expiry time, so the next expiry is
+ * always at the head of the list.
+ *
+ * A Content Object satisfies an entry if the names are equal, the KeyId restriction (if any)
+ * equals the object's KeyId, and the ContentObjectHash restriction (if any) equals the
+ * SHA-256 hash of the object.
+ *
+ * Times are in framework ticks.  The table is not thread safe.  It is meant to be used
+ * only from the RTA framework thread.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_pit_Table_h
+#define Libccnx_pit_Table_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ccnx/common/internal/ccnx_TlvDictionary.h>
+
+struct pit_table;
+typedef struct pit_table PitTable;
+
+/**
+ * What the caller should do with an Interest after `pitTable_Receive()`
+ */
+typedef enum {
+    PitVerdict_Forward,         // A new entry, send the Interest down
+    PitVerdict_Refresh,         // A duplicate that extends the lifetime of the entry, send it down
+    PitVerdict_Aggregate,       // A duplicate inside the lifetime of the entry, do not send it
+    PitVerdict_Untracked        // The table is full or the Interest has no name, send it down
+} PitVerdict;
+
+/**
+ * Counters kept by the table.  They are cumulative over the life of the table.
+ */
+typedef struct pit_table_stats {
+    uint64_t interests;     // number of calls to pitTable_Receive
+    uint64_t aggregated;    // Interests not sent down because they duplicate a pending entry
+    uint64_t satisfied;     // entries removed by a Content Object
+    uint64_t waitersServed; // copies of Content Objects owed to waiters
+    uint64_t expired;       // entries removed because their lifetime expired
+    uint64_t untracked;     // Interests passed through because the table was full
+} PitTableStats;
+
+/**
+ * Create a PIT
+ *
+ * @param [in] maxEntries The maximum number of distinct pending Interests (must be positive)
+ *
+ * @return non-null An allocated table, destroy with `pitTable_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     PitTable *table = pitTable_Create(1024);
+ *     pitTable_Destroy(&table);
+ * }
+ * @endcode
+ */
+PitTable *pitTable_Create(size_t maxEntries);
+
+/**
+ * Destroys the table and releases every pending Interest
+ *
+ * @param [in,out] tablePtr Pointer to the table, will be NULL'd
+ */
+void pitTable_Destroy(PitTable **tablePtr);
+
+/**
+ * Record an Interest sent down the stack
+ *
+ * A new Interest gets an entry with one waiter that expires at `expiryTime`.  A duplicate
+ * adds a waiter to the existing entry.  If the duplicate expires later than the entry,
+ * the entry takes the later expiry and the duplicate must be sent down so the forwarder
+ * keeps its own state alive.  A refreshing duplicate does not add a waiter: the forwarder
+ * answers it like the first, and the entry goes with the first object that satisfies it.
+ *
+ * @param [in] table The PIT
+ * @param [in] interest A decoded Interest dictionary, the table acquires a reference for a new entry
+ * @param [in] expiryTime The absolute time, in ticks, at which the Interest's lifetime ends
+ *
+ * @return PitVerdict What the caller should do with the Interest
+ *
+ * Example:
+ * @code
+ * {
+ *     ticks expiry = now + rtaFramework_MsecToTicks(ccnxInterest_GetLifetime(interest));
+ *     if (pitTable_Receive(table, interest, expiry) != PitVerdict_Aggregate) {
+ *         // send it down
+ *     }
+ * }
+ * @endcode
+ */
+PitVerdict pitTable_Receive(PitTable *table, CCNxTlvDictionary *interest, uint64_t expiryTime);
+
+/**
+ * Remove every entry satisfied by the Content Object
+ *
+ * A Content Object may satisfy more than one entry, for example one Interest with
+ * a KeyId restriction and one without.
+ *
+ * @param [in] table The PIT
+ * @param [in] contentObject A decoded Content Object dictionary with its wire format
+ *
+ * @return The total number of waiters on the removed entries, 0 if the object was unsolicited
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+size_t pitTable_Satisfy(PitTable *table, const CCNxTlvDictionary *contentObject);
+
+/**
+ * Remove the entry that expires first, if its expiry time has passed
+ *
+ * Call it in a loop until it returns NULL.
+ *
+ * @param [in] table The PIT
+ * @param [in] now The current time in ticks
+ * @param [out] waitersPtr If not NULL, the number of waiters on the entry
+ *
+ * @return non-null The expired Interest, release with `ccnxTlvDictionary_Release()`
+ * @return null No entry has expired
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxTlvDictionary *interest;
+ *     while ((interest = pitTable_PopExpired(table, now, NULL)) != NULL) {
+ *         // notify the application
+ *         ccnxTlvDictionary_Release(&interest);
+ *     }
+ * }
+ * @endcode
+ */
+CCNxTlvDictionary *pitTable_PopExpired(PitTable *table, uint64_t now, size_t *waitersPtr);
+
+/**
+ * The expiry time of the entry that expires first
+ *
+ * @param [in] table The PIT
+ * @param [out] expiryTimePtr Set to the earliest expiry time, in ticks
+ *
+ * @return true The table has an entry, and `expiryTimePtr` is set
+ * @return false The table is empty
+ */
+bool pitTable_NextExpiry(const PitTable *table, uint64_t *expiryTimePtr);
+
+/**
+ * The number of distinct pending Interests
+ */
+size_t pitTable_Count(const PitTable *table);
+
+/**
+ * Returns the cumulative counters of the table.  Do not free it.
+ */
+const PitTableStats *pitTable_GetStats(const PitTable *table);
+#endif // Libccnx_pit_Table_h
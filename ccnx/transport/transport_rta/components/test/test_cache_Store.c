@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../cache_Store.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/internal/ccnx_InterestDefault.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+#include "testrig_Messages.c"
+
+LONGBOW_TEST_RUNNER(cache_Store)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(cache_Store)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(cache_Store)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Create);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_Match);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Match_Miss);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_Replace);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_EvictByCount);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_EvictByBytes);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_TooLarge);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Match_KeyIdRestriction);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Match_HashRestriction);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_Put_HashesBeforeDelivery);
+    LONGBOW_RUN_TEST_CASE(Global, cacheStore_GetHitRatio);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Create)
+{
+    CacheStore *store = cacheStore_Create(100, 1000);
+    assertNotNull(store, "Got null store");
+    assertTrue(cacheStore_Count(store) == 0, "New store should be empty");
+    assertTrue(store->bucketCount == 128, "Expected 128 buckets, got %zu", store->bucketCount);
+    cacheStore_Destroy(&store);
+    assertNull(store, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_Match)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    bool success = cacheStore_Put(store, contentObject, 0);
+    assertTrue(success, "Put failed");
+    assertTrue(cacheStore_Count(store) == 1, "Expected 1 object, got %zu", cacheStore_Count(store));
+
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interest, 0);
+    assertTrue(hit == contentObject, "Wrong object, expected %p got %p", (void *) contentObject, (void *) hit);
+
+    const CacheStoreStats *stats = cacheStore_GetStats(store);
+    assertTrue(stats->hits == 1, "Expected 1 hit, got %" PRIu64, stats->hits);
+    assertTrue(stats->bytesServed == cacheStore_Bytes(store), "Expected %zu bytes served, got %" PRIu64,
+               cacheStore_Bytes(store), stats->bytesServed);
+
+    ccnxTlvDictionary_Release(&hit);
+    ccnxTlvDictionary_Release(&interest);
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Match_Miss)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/tart", CCNxInterestDefault_LifetimeMilliseconds);
+
+    cacheStore_Put(store, contentObject, 0);
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interest, 0);
+    assertNull(hit, "Should not have matched a different name");
+    assertTrue(cacheStore_GetStats(store)->lookups == 1, "Expected 1 lookup");
+
+    ccnxTlvDictionary_Release(&interest);
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_Replace)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *first = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    CCNxTlvDictionary *second = testRtaMessages_CreateContentObject("lci:/apple/pie", "world");
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    cacheStore_Put(store, first, 0);
+    cacheStore_Put(store, second, 0);
+    assertTrue(cacheStore_Count(store) == 1, "Expected replacement, got %zu objects", cacheStore_Count(store));
+
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interest, 0);
+    assertTrue(hit == second, "Expected the newer object");
+
+    ccnxTlvDictionary_Release(&hit);
+    ccnxTlvDictionary_Release(&interest);
+    ccnxTlvDictionary_Release(&second);
+    ccnxTlvDictionary_Release(&first);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_EvictByCount)
+{
+    CacheStore *store = cacheStore_Create(2, 100000);
+    CCNxTlvDictionary *a = testRtaMessages_CreateContentObject("lci:/a", "hello");
+    CCNxTlvDictionary *b = testRtaMessages_CreateContentObject("lci:/b", "hello");
+    CCNxTlvDictionary *c = testRtaMessages_CreateContentObject("lci:/c", "hello");
+    CCNxTlvDictionary *interestA = testRtaMessages_CreateInterest("lci:/a", CCNxInterestDefault_LifetimeMilliseconds);
+
+    cacheStore_Put(store, a, 0);
+    cacheStore_Put(store, b, 0);
+
+    // touch "a" so "b" is the least recently used
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interestA, 0);
+    ccnxTlvDictionary_Release(&hit);
+
+    cacheStore_Put(store, c, 0);
+    assertTrue(cacheStore_Count(store) == 2, "Expected 2 objects, got %zu", cacheStore_Count(store));
+    assertTrue(cacheStore_GetStats(store)->evictions == 1, "Expected 1 eviction");
+    assertTrue(TAILQ_LAST(&store->lruHead, cache_lru)->contentObject == a, "Expected 'a' to be the LRU entry");
+
+    ccnxTlvDictionary_Release(&interestA);
+    ccnxTlvDictionary_Release(&c);
+    ccnxTlvDictionary_Release(&b);
+    ccnxTlvDictionary_Release(&a);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_EvictByBytes)
+{
+    CCNxTlvDictionary *a = testRtaMessages_CreateContentObject("lci:/a", "hello");
+    CCNxTlvDictionary *b = testRtaMessages_CreateContentObject("lci:/b", "hello");
+    size_t length = parcBuffer_Limit(ccnxWireFormatMessage_GetWireFormatBuffer(a));
+
+    CacheStore *store = cacheStore_Create(100, length + length / 2);
+    cacheStore_Put(store, a, 0);
+    cacheStore_Put(store, b, 0);
+
+    assertTrue(cacheStore_Count(store) == 1, "Expected 1 object, got %zu", cacheStore_Count(store));
+    assertTrue(cacheStore_Bytes(store) == length, "Expected %zu bytes, got %zu", length, cacheStore_Bytes(store));
+
+    ccnxTlvDictionary_Release(&b);
+    ccnxTlvDictionary_Release(&a);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_TooLarge)
+{
+    CacheStore *store = cacheStore_Create(100, 4);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+
+    bool success = cacheStore_Put(store, contentObject, 0);
+    assertFalse(success, "Should not store an object larger than the store");
+    assertTrue(cacheStore_Count(store) == 0, "Store should be empty");
+
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Match_KeyIdRestriction)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/apple/pie");
+    PARCBuffer *keyId = parcBuffer_WrapCString("not the publisher");
+    CCNxInterest *interest = ccnxInterest_Create(name, CCNxInterestDefault_LifetimeMilliseconds, keyId, NULL);
+
+    cacheStore_Put(store, contentObject, 0);
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interest, 0);
+    assertNull(hit, "Unsigned object should not match a KeyId restriction");
+
+    ccnxInterest_Release(&interest);
+    parcBuffer_Release(&keyId);
+    ccnxName_Release(&name);
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Match_HashRestriction)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+
+    // hash an independent decode of the same object, as a consumer would
+    CCNxTlvDictionary *other = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    PARCCryptoHash *hash = ccnxWireFormatMessage_CreateContentObjectHash(other);
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/apple/pie");
+    CCNxInterest *interest = ccnxInterest_Create(name, CCNxInterestDefault_LifetimeMilliseconds, NULL, parcCryptoHash_GetDigest(hash));
+
+    cacheStore_Put(store, contentObject, 0);
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interest, 0);
+    assertTrue(hit == contentObject, "Object should match its own hash restriction");
+
+    ccnxTlvDictionary_Release(&hit);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    parcCryptoHash_Release(&hash);
+    ccnxTlvDictionary_Release(&other);
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_Put_HashesBeforeDelivery)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+
+    cacheStore_Put(store, contentObject, 0);
+
+    // the hash must be done while the caller still owns the object, not on a later lookup
+    CacheEntry *entry = TAILQ_FIRST(&store->lruHead);
+    assertNotNull(entry, "Expected an entry");
+    assertNotNull(entry->objectHash, "ContentObjectHash not computed in Put");
+
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+LONGBOW_TEST_CASE(Global, cacheStore_GetHitRatio)
+{
+    CacheStore *store = cacheStore_Create(100, 100000);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    CCNxTlvDictionary *interestHit = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *interestMiss = testRtaMessages_CreateInterest("lci:/apple/tart", CCNxInterestDefault_LifetimeMilliseconds);
+
+    assertTrue(cacheStore_GetHitRatio(store) == 0.0, "Empty store should have 0 hit ratio");
+
+    cacheStore_Put(store, contentObject, 0);
+    CCNxTlvDictionary *hit = cacheStore_Match(store, interestHit, 0);
+    ccnxTlvDictionary_Release(&hit);
+    hit = cacheStore_Match(store, interestMiss, 0);
+
+    double ratio = cacheStore_GetHitRatio(store);
+    assertTrue(ratio == 0.5, "Expected hit ratio 0.5, got %f", ratio);
+
+    ccnxTlvDictionary_Release(&interestMiss);
+    ccnxTlvDictionary_Release(&interestHit);
+    ccnxTlvDictionary_Release(&contentObject);
+    cacheStore_Destroy(&store);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(cache_Store);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
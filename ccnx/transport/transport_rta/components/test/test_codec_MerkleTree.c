@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../codec_MerkleTree.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#define MAX_LEAVES 17
+
+static PARCBuffer *
+_createLeaf(size_t i)
+{
+    PARCBuffer *leaf = parcBuffer_Allocate(CODEC_MERKLE_DIGEST_LENGTH);
+    for (size_t j = 0; j < CODEC_MERKLE_DIGEST_LENGTH; j++) {
+        parcBuffer_PutUint8(leaf, (uint8_t) (i * 31 + j));
+    }
+    return parcBuffer_Flip(leaf);
+}
+
+static void
+_createLeaves(size_t count, PARCBuffer *leaves[])
+{
+    for (size_t i = 0; i < count; i++) {
+        leaves[i] = _createLeaf(i);
+    }
+}
+
+static void
+_releaseLeaves(size_t count, PARCBuffer *leaves[])
+{
+    for (size_t i = 0; i < count; i++) {
+        parcBuffer_Release(&leaves[i]);
+    }
+}
+
+LONGBOW_TEST_RUNNER(codec_MerkleTree)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(codec_MerkleTree)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(codec_MerkleTree)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_Create_OneLeaf);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_Create_TwoLeaves);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_VerifyProof_AllSizes);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_VerifyProof_WrongLeaf);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_VerifyProof_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_VerifyProof_TrailingBytes);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_CreateRootFromProof);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_CreateBatchPayload);
+    LONGBOW_RUN_TEST_CASE(Global, codecMerkleTree_IsBatchPayload_Plain);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_Create_OneLeaf)
+{
+    PARCBuffer *leaves[1];
+    _createLeaves(1, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(1, leaves);
+    assertTrue(codecMerkleTree_GetLeafCount(tree) == 1, "Wrong leaf count");
+
+    uint8_t expected[CODEC_MERKLE_DIGEST_LENGTH];
+    _codecMerkleTree_HashLeaf(expected, parcBuffer_Overlay(leaves[0], 0));
+    assertTrue(memcmp(expected, parcBuffer_Overlay(codecMerkleTree_GetRoot(tree), 0), CODEC_MERKLE_DIGEST_LENGTH) == 0,
+               "Root of a single leaf should be the hashed leaf");
+
+    codecMerkleTree_Destroy(&tree);
+    assertNull(tree, "Destroy did not null the pointer");
+    _releaseLeaves(1, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_Create_TwoLeaves)
+{
+    PARCBuffer *leaves[2];
+    _createLeaves(2, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(2, leaves);
+
+    uint8_t left[CODEC_MERKLE_DIGEST_LENGTH];
+    uint8_t right[CODEC_MERKLE_DIGEST_LENGTH];
+    uint8_t expected[CODEC_MERKLE_DIGEST_LENGTH];
+    _codecMerkleTree_HashLeaf(left, parcBuffer_Overlay(leaves[0], 0));
+    _codecMerkleTree_HashLeaf(right, parcBuffer_Overlay(leaves[1], 0));
+    _codecMerkleTree_HashNode(expected, left, right);
+
+    assertTrue(memcmp(expected, parcBuffer_Overlay(codecMerkleTree_GetRoot(tree), 0), CODEC_MERKLE_DIGEST_LENGTH) == 0,
+               "Wrong root for two leaves");
+
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(2, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_VerifyProof_AllSizes)
+{
+    PARCBuffer *leaves[MAX_LEAVES];
+    _createLeaves(MAX_LEAVES, leaves);
+
+    for (size_t count = 1; count <= MAX_LEAVES; count++) {
+        CodecMerkleTree *tree = codecMerkleTree_Create(count, leaves);
+        for (size_t i = 0; i < count; i++) {
+            PARCBuffer *proof = codecMerkleTree_CreateProof(tree, i);
+            bool success = codecMerkleTree_VerifyProof(leaves[i], proof, codecMerkleTree_GetRoot(tree));
+            assertTrue(success, "Proof of leaf %zu of %zu did not verify", i, count);
+            assertTrue(parcBuffer_Remaining(proof) == 0, "Proof of leaf %zu of %zu not fully consumed", i, count);
+            parcBuffer_Release(&proof);
+        }
+        codecMerkleTree_Destroy(&tree);
+    }
+
+    _releaseLeaves(MAX_LEAVES, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_VerifyProof_WrongLeaf)
+{
+    PARCBuffer *leaves[5];
+    _createLeaves(5, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(5, leaves);
+    PARCBuffer *proof = codecMerkleTree_CreateProof(tree, 2);
+
+    bool success = codecMerkleTree_VerifyProof(leaves[3], proof, codecMerkleTree_GetRoot(tree));
+    assertFalse(success, "Proof of leaf 2 should not verify leaf 3");
+
+    parcBuffer_Release(&proof);
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(5, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_VerifyProof_Truncated)
+{
+    PARCBuffer *leaves[5];
+    _createLeaves(5, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(5, leaves);
+    PARCBuffer *proof = codecMerkleTree_CreateProof(tree, 2);
+    parcBuffer_SetLimit(proof, parcBuffer_Limit(proof) - 1);
+
+    bool success = codecMerkleTree_VerifyProof(leaves[2], proof, codecMerkleTree_GetRoot(tree));
+    assertFalse(success, "A truncated proof should not verify");
+
+    parcBuffer_Release(&proof);
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(5, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_VerifyProof_TrailingBytes)
+{
+    PARCBuffer *leaves[4];
+    _createLeaves(4, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(4, leaves);
+    PARCBuffer *proof = codecMerkleTree_CreateProof(tree, 1);
+
+    PARCBuffer *payload = parcBuffer_Allocate(parcBuffer_Remaining(proof) + 3);
+    parcBuffer_PutBuffer(payload, proof);
+    parcBuffer_PutArray(payload, 3, (uint8_t *) "sig");
+    parcBuffer_Flip(payload);
+
+    bool success = codecMerkleTree_VerifyProof(leaves[1], payload, codecMerkleTree_GetRoot(tree));
+    assertTrue(success, "Proof followed by other bytes should verify");
+    assertTrue(parcBuffer_Remaining(payload) == 3, "Expected the position just past the proof");
+
+    parcBuffer_Release(&payload);
+    parcBuffer_Release(&proof);
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(4, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_CreateRootFromProof)
+{
+    PARCBuffer *leaves[5];
+    _createLeaves(5, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(5, leaves);
+    PARCBuffer *proof = codecMerkleTree_CreateProof(tree, 4);
+
+    PARCBuffer *root = codecMerkleTree_CreateRootFromProof(leaves[4], proof);
+    assertNotNull(root, "Expected a root from a good proof");
+    assertTrue(parcBuffer_Equals(root, codecMerkleTree_GetRoot(tree)), "Computed root does not match the tree");
+    assertTrue(parcBuffer_Remaining(proof) == 0, "Expected the whole proof to be read");
+
+    parcBuffer_Release(&root);
+    parcBuffer_Release(&proof);
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(5, leaves);
+}
+
+/**
+ * The batch payload is the mark, then a proof that verifies, then the root signature
+ */
+LONGBOW_TEST_CASE(Global, codecMerkleTree_CreateBatchPayload)
+{
+    PARCBuffer *leaves[3];
+    _createLeaves(3, leaves);
+
+    CodecMerkleTree *tree = codecMerkleTree_Create(3, leaves);
+    PARCBuffer *rootSignature = parcBuffer_WrapCString("root signature");
+    PARCBuffer *payload = codecMerkleTree_CreateBatchPayload(tree, 2, rootSignature);
+
+    assertTrue(codecMerkleTree_IsBatchPayload(payload), "Expected the batch mark");
+
+    parcBuffer_SetPosition(payload, CODEC_MERKLE_BATCH_MAGIC_LENGTH);
+    bool success = codecMerkleTree_VerifyProof(leaves[2], payload, codecMerkleTree_GetRoot(tree));
+    assertTrue(success, "Proof in the batch payload should verify");
+    assertTrue(parcBuffer_Equals(payload, rootSignature), "Expected the root signature after the proof");
+
+    parcBuffer_Release(&payload);
+    parcBuffer_Release(&rootSignature);
+    codecMerkleTree_Destroy(&tree);
+    _releaseLeaves(3, leaves);
+}
+
+LONGBOW_TEST_CASE(Global, codecMerkleTree_IsBatchPayload_Plain)
+{
+    PARCBuffer *signature = parcBuffer_WrapCString("an RSA signature");
+    assertFalse(codecMerkleTree_IsBatchPayload(signature), "A plain signature is not a batch payload");
+    parcBuffer_Release(&signature);
+
+    PARCBuffer *shortSignature = parcBuffer_WrapCString("MR");
+    assertFalse(codecMerkleTree_IsBatchPayload(shortSignature), "A payload shorter than the mark is not a batch payload");
+    parcBuffer_Release(&shortSignature);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(codec_MerkleTree);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
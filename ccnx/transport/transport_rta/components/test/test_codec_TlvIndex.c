@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../codec_TlvIndex.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_interest_nameA.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_content_nameA_crc32c.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_cpi_add_route_crc32c.h>
+
+#define WRAP(array) parcBuffer_Wrap(array, sizeof(array), 0, sizeof(array))
+
+static CCNxTlvDictionary *
+_createFullyDecoded(PARCBuffer *wireFormat, bool isInterest)
+{
+    CCNxTlvDictionary *dictionary = isInterest
+                                    ? ccnxWireFormatMessage_FromInterestPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat)
+                                    : ccnxWireFormatMessage_FromContentObjectPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    bool success = ccnxCodecTlvPacket_BufferDecode(wireFormat, dictionary);
+    assertTrue(success, "Could not decode truth set packet");
+    return dictionary;
+}
+
+LONGBOW_TEST_RUNNER(codec_TlvIndex)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(codec_TlvIndex)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(codec_TlvIndex)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_Create_Interest);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_Create_ContentObject);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_Create_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_Create_Control);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_CreateName);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_LazyDecode_Deferred);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_LazyDecode_DestroyPending);
+    LONGBOW_RUN_TEST_CASE(Global, codecTlvIndex_LazyDecode_Control);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_Create_Interest)
+{
+    PARCBuffer *wireFormat = WRAP(v1_interest_nameA);
+    CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+    assertNotNull(index, "Could not index a truth set Interest");
+
+    assertTrue(codecTlvIndex_GetPacketType(index) == CCNxCodecSchemaV1Types_PacketType_Interest,
+               "Wrong packet type %u", codecTlvIndex_GetPacketType(index));
+    assertTrue(codecTlvIndex_GetMessage(index)->type == CCNxCodecSchemaV1Types_MessageType_Interest,
+               "Wrong message type %u", codecTlvIndex_GetMessage(index)->type);
+    assertTrue(codecTlvIndex_GetFieldCount(index) > 0, "Expected message fields");
+    assertNotNull(codecTlvIndex_FindField(index, CCNxCodecSchemaV1Types_CCNxMessage_Name), "Expected a name field");
+
+    // the fields tile the message exactly
+    const CodecTlvIndexEntry *message = codecTlvIndex_GetMessage(index);
+    size_t position = message->offset;
+    for (size_t i = 0; i < codecTlvIndex_GetFieldCount(index); i++) {
+        const CodecTlvIndexEntry *field = codecTlvIndex_GetField(index, i);
+        assertTrue(field->offset == position + 4, "Field %zu at offset %u expected %zu", i, field->offset, position + 4);
+        position = field->offset + field->length;
+    }
+    assertTrue(position == message->offset + message->length, "Fields end at %zu, message at %u",
+               position, message->offset + message->length);
+
+    codecTlvIndex_Destroy(&index);
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_Create_ContentObject)
+{
+    PARCBuffer *wireFormat = WRAP(v1_content_nameA_crc32c);
+    CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+    assertNotNull(index, "Could not index a truth set Content Object");
+
+    assertTrue(codecTlvIndex_GetPacketType(index) == CCNxCodecSchemaV1Types_PacketType_ContentObject,
+               "Wrong packet type %u", codecTlvIndex_GetPacketType(index));
+    assertNotNull(codecTlvIndex_FindField(index, CCNxCodecSchemaV1Types_CCNxMessage_Payload), "Expected a payload field");
+
+    const CodecTlvIndexEntry *alg = codecTlvIndex_GetValidationAlg(index);
+    const CodecTlvIndexEntry *payload = codecTlvIndex_GetValidationPayload(index);
+    assertNotNull(alg, "Expected a ValidationAlg");
+    assertNotNull(payload, "Expected a ValidationPayload");
+    assertTrue(payload->offset + payload->length == sizeof(v1_content_nameA_crc32c), "ValidationPayload should end the packet");
+
+    codecTlvIndex_Destroy(&index);
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_Create_Truncated)
+{
+    for (size_t length = 0; length < sizeof(v1_content_nameA_crc32c); length++) {
+        PARCBuffer *wireFormat = parcBuffer_Wrap(v1_content_nameA_crc32c, sizeof(v1_content_nameA_crc32c), 0, length);
+        CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+        assertNull(index, "Indexed a packet truncated to %zu bytes", length);
+        parcBuffer_Release(&wireFormat);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_Create_Control)
+{
+    PARCBuffer *wireFormat = WRAP(v1_cpi_add_route_crc32c);
+    CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+    assertNull(index, "Control packets should be left to the full decoder");
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_CreateName)
+{
+    PARCBuffer *wireFormat = WRAP(v1_content_nameA_crc32c);
+    CCNxTlvDictionary *truth = _createFullyDecoded(wireFormat, false);
+
+    CodecTlvIndex *index = codecTlvIndex_Create(wireFormat);
+    CCNxName *name = codecTlvIndex_CreateName(index, wireFormat);
+    assertNotNull(name, "Expected a name");
+    assertTrue(ccnxName_Equals(name, ccnxContentObject_GetName(truth)), "Name does not match the full decode");
+
+    ccnxName_Release(&name);
+    codecTlvIndex_Destroy(&index);
+    ccnxTlvDictionary_Release(&truth);
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_LazyDecode_Deferred)
+{
+    PARCBuffer *wireFormat = WRAP(v1_interest_nameA);
+    CCNxTlvDictionary *truth = _createFullyDecoded(wireFormat, true);
+
+    CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_FromInterestPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    ccnxTlvDictionary_Release(&dictionary);
+
+    bool success = codecTlvIndex_LazyDecode(tm);
+    assertTrue(success, "Lazy decode failed");
+    assertTrue(transportMessage_IsDecodeDeferred(tm), "Expected a pending decode");
+
+    CCNxName *name = ccnxTlvDictionary_GetName(transportMessage_GetDictionary(tm), CCNxCodecSchemaV1TlvDictionary_MessageFastArray_NAME);
+    assertTrue(ccnxName_Equals(name, ccnxInterest_GetName(truth)), "Eager name does not match the full decode");
+
+    success = transportMessage_CompleteDecode(tm);
+    assertTrue(success, "Deferred decode failed");
+    assertFalse(transportMessage_IsDecodeDeferred(tm), "Decode should no longer be pending");
+
+    CCNxTlvDictionary *decoded = transportMessage_GetDictionary(tm);
+    assertTrue(ccnxName_Equals(ccnxInterest_GetName(decoded), ccnxInterest_GetName(truth)), "Name does not match the full decode");
+    assertTrue(ccnxInterest_GetLifetime(decoded) == ccnxInterest_GetLifetime(truth), "Lifetime does not match the full decode");
+
+    // a second call has nothing to do
+    assertTrue(transportMessage_CompleteDecode(tm), "Completing twice should succeed");
+    assertTrue(transportMessage_GetDictionary(tm) == decoded, "Completing twice should not replace the dictionary");
+
+    transportMessage_Destroy(&tm);
+    ccnxTlvDictionary_Release(&truth);
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_LazyDecode_DestroyPending)
+{
+    PARCBuffer *wireFormat = WRAP(v1_content_nameA_crc32c);
+    CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_FromContentObjectPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    ccnxTlvDictionary_Release(&dictionary);
+
+    assertTrue(codecTlvIndex_LazyDecode(tm), "Lazy decode failed");
+    assertTrue(transportMessage_IsDecodeDeferred(tm), "Expected a pending decode");
+
+    // destroying the message frees the index (checked by the fixture teardown)
+    transportMessage_Destroy(&tm);
+    parcBuffer_Release(&wireFormat);
+}
+
+LONGBOW_TEST_CASE(Global, codecTlvIndex_LazyDecode_Control)
+{
+    PARCBuffer *wireFormat = WRAP(v1_cpi_add_route_crc32c);
+    CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_FromControlPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    ccnxTlvDictionary_Release(&dictionary);
+
+    assertTrue(codecTlvIndex_LazyDecode(tm), "Control packet should be decoded eagerly");
+    assertFalse(transportMessage_IsDecodeDeferred(tm), "Control packet should not be deferred");
+
+    transportMessage_Destroy(&tm);
+    parcBuffer_Release(&wireFormat);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(codec_TlvIndex);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
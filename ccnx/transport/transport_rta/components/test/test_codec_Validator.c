@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../codec_Validator.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_Buffer.h>
+
+#include <ccnx/common/codec/schema_v1/testdata/v1_interest_nameA.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_content_nameA_crc32c.h>
+#include <ccnx/common/codec/schema_v1/testdata/v1_cpi_add_route_crc32c.h>
+
+typedef struct truth_packet {
+    const char *name;
+    const uint8_t *packet;
+    size_t length;
+} TruthPacket;
+
+#define TRUTH(array) { .name = #array, .packet = array, .length = sizeof(array) }
+
+static const TruthPacket truthPackets[] = {
+    TRUTH(v1_interest_nameA),
+    TRUTH(v1_content_nameA_crc32c),
+    TRUTH(v1_cpi_add_route_crc32c),
+};
+
+static const size_t truthPacketCount = sizeof(truthPackets) / sizeof(TruthPacket);
+
+#define FUZZ_ITERATIONS 20000
+
+/*
+ * An independent, PARCBuffer based statement of the same rules as codecValidator_Validate(),
+ * used as the oracle for the fuzz test.  It only answers "well formed or not".
+ */
+static bool _referenceTiles(PARCBuffer *buffer, size_t start, size_t end, int depth, uint16_t containerType, uint8_t packetType);
+
+static bool
+_referenceIsContainer(int depth, uint16_t containerType, uint16_t type, uint8_t packetType)
+{
+    if (depth == 0) {
+        // top level
+        if (type == CCNxCodecSchemaV1Types_MessageType_ValidationAlg) {
+            return true;
+        }
+        if (packetType == CCNxCodecSchemaV1Types_PacketType_Control) {
+            return false;
+        }
+        return type == CCNxCodecSchemaV1Types_MessageType_Interest || type == CCNxCodecSchemaV1Types_MessageType_ContentObject;
+    }
+
+    if (depth == 1) {
+        if (containerType == CCNxCodecSchemaV1Types_MessageType_ValidationAlg) {
+            return true;
+        }
+        return type == CCNxCodecSchemaV1Types_CCNxMessage_Name;
+    }
+
+    return false;
+}
+
+static bool
+_referenceTiles(PARCBuffer *buffer, size_t start, size_t end, int depth, uint16_t containerType, uint8_t packetType)
+{
+    size_t position = start;
+    while (position != end) {
+        if (position + 4 > end) {
+            return false;
+        }
+        parcBuffer_SetPosition(buffer, position);
+        uint16_t type = parcBuffer_GetUint16(buffer);
+        uint16_t length = parcBuffer_GetUint16(buffer);
+        if (position + 4 + length > end) {
+            return false;
+        }
+        if (_referenceIsContainer(depth, containerType, type, packetType)) {
+            if (!_referenceTiles(buffer, position + 4, position + 4 + length, depth + 1, type, packetType)) {
+                return false;
+            }
+        }
+        position += 4 + length;
+    }
+    return true;
+}
+
+static bool
+_referenceIsValid(const uint8_t *packet, size_t length)
+{
+    if (length < 8) {
+        return false;
+    }
+
+    PARCBuffer *buffer = parcBuffer_Wrap((uint8_t *) packet, length, 0, length);
+    uint8_t version = parcBuffer_GetUint8(buffer);
+    uint8_t packetType = parcBuffer_GetUint8(buffer);
+    uint16_t packetLength = parcBuffer_GetUint16(buffer);
+    parcBuffer_SetPosition(buffer, 7);
+    uint8_t headerLength = parcBuffer_GetUint8(buffer);
+
+    bool valid = version == 1 &&
+                 (packetType == CCNxCodecSchemaV1Types_PacketType_Interest ||
+                  packetType == CCNxCodecSchemaV1Types_PacketType_ContentObject ||
+                  packetType == CCNxCodecSchemaV1Types_PacketType_InterestReturn ||
+                  packetType == CCNxCodecSchemaV1Types_PacketType_Control) &&
+                 packetLength == length &&
+                 headerLength >= 8 && headerLength < length &&
+                 _referenceTiles(buffer, 8, headerLength, 2, 0, packetType) &&
+                 _referenceTiles(buffer, headerLength, length, 0, 0, packetType);
+
+    parcBuffer_Release(&buffer);
+    return valid;
+}
+
+static void
+_setPacketLength(uint8_t *packet, size_t length)
+{
+    packet[2] = (uint8_t) (length >> 8);
+    packet[3] = (uint8_t) length;
+}
+
+LONGBOW_TEST_RUNNER(codec_Validator)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(codec_Validator)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(codec_Validator)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_TruthSet);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_TooShort);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_BadVersion);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_BadPacketType);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_BadHeaderLength);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_Truncated);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_TruncatedWithLength);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_Validate_Fuzz);
+    LONGBOW_RUN_TEST_CASE(Global, codecValidator_ResultToString);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_TruthSet)
+{
+    for (size_t i = 0; i < truthPacketCount; i++) {
+        CodecValidatorResult result = codecValidator_Validate(truthPackets[i].packet, truthPackets[i].length);
+        assertTrue(result == CodecValidatorResult_Ok, "%s: expected Ok got %s",
+                   truthPackets[i].name, codecValidator_ResultToString(result));
+        assertTrue(_referenceIsValid(truthPackets[i].packet, truthPackets[i].length),
+                   "%s: reference disagrees", truthPackets[i].name);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_TooShort)
+{
+    CodecValidatorResult result = codecValidator_Validate(v1_interest_nameA, 7);
+    assertTrue(result == CodecValidatorResult_TooShort, "Expected TooShort got %s", codecValidator_ResultToString(result));
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_BadVersion)
+{
+    uint8_t packet[sizeof(v1_interest_nameA)];
+    memcpy(packet, v1_interest_nameA, sizeof(packet));
+    packet[0] = 0;
+
+    CodecValidatorResult result = codecValidator_Validate(packet, sizeof(packet));
+    assertTrue(result == CodecValidatorResult_BadVersion, "Expected BadVersion got %s", codecValidator_ResultToString(result));
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_BadPacketType)
+{
+    uint8_t packet[sizeof(v1_interest_nameA)];
+    memcpy(packet, v1_interest_nameA, sizeof(packet));
+    packet[1] = 0xFF;
+
+    CodecValidatorResult result = codecValidator_Validate(packet, sizeof(packet));
+    assertTrue(result == CodecValidatorResult_BadPacketType, "Expected BadPacketType got %s", codecValidator_ResultToString(result));
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_BadHeaderLength)
+{
+    uint8_t packet[sizeof(v1_interest_nameA)];
+    memcpy(packet, v1_interest_nameA, sizeof(packet));
+
+    packet[7] = 4;
+    CodecValidatorResult result = codecValidator_Validate(packet, sizeof(packet));
+    assertTrue(result == CodecValidatorResult_BadHeaderLength, "Short header: expected BadHeaderLength got %s",
+               codecValidator_ResultToString(result));
+
+    packet[7] = 0xFF;
+    result = codecValidator_Validate(packet, sizeof(packet));
+    assertTrue(result == CodecValidatorResult_BadHeaderLength, "Long header: expected BadHeaderLength got %s",
+               codecValidator_ResultToString(result));
+}
+
+/*
+ * Cutting a packet short without fixing the PacketLength is always caught by the fixed header
+ */
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_Truncated)
+{
+    for (size_t i = 0; i < truthPacketCount; i++) {
+        for (size_t length = 8; length < truthPackets[i].length; length++) {
+            CodecValidatorResult result = codecValidator_Validate(truthPackets[i].packet, length);
+            assertTrue(result == CodecValidatorResult_BadPacketLength, "%s length %zu: expected BadPacketLength got %s",
+                       truthPackets[i].name, length, codecValidator_ResultToString(result));
+        }
+    }
+}
+
+/*
+ * Cutting a packet short and fixing the PacketLength must be caught by the TLV walk, unless
+ * the cut falls exactly between two top-level TLVs.
+ */
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_TruncatedWithLength)
+{
+    for (size_t i = 0; i < truthPacketCount; i++) {
+        uint8_t packet[truthPackets[i].length];
+        memcpy(packet, truthPackets[i].packet, truthPackets[i].length);
+
+        for (size_t length = 8; length < truthPackets[i].length; length++) {
+            _setPacketLength(packet, length);
+            bool expected = _referenceIsValid(packet, length);
+            CodecValidatorResult result = codecValidator_Validate(packet, length);
+            assertTrue((result == CodecValidatorResult_Ok) == expected, "%s length %zu: expected %s got %s",
+                       truthPackets[i].name, length, expected ? "valid" : "invalid", codecValidator_ResultToString(result));
+        }
+    }
+}
+
+/*
+ * Random byte mutations of the truth set, biased towards the fixed header and TLV headers,
+ * checked against the reference walk.  The seed is fixed so failures reproduce.
+ */
+LONGBOW_TEST_CASE(Global, codecValidator_Validate_Fuzz)
+{
+    srandom(0x5EED);
+
+    unsigned accepted = 0;
+    for (unsigned iteration = 0; iteration < FUZZ_ITERATIONS; iteration++) {
+        const TruthPacket *truth = &truthPackets[iteration % truthPacketCount];
+        uint8_t packet[truth->length];
+        memcpy(packet, truth->packet, truth->length);
+
+        unsigned mutations = 1 + random() % 3;
+        for (unsigned m = 0; m < mutations; m++) {
+            size_t offset = random() % truth->length;
+            switch (random() % 3) {
+                case 0:
+                    // any byte
+                    packet[offset] = (uint8_t) random();
+                    break;
+                case 1:
+                    // small change, which tends to keep a length plausible
+                    packet[offset] += (uint8_t) (random() % 5) - 2;
+                    break;
+                default:
+                    // the packet type, which changes which values are containers
+                    packet[1] = (uint8_t) (random() % 5);
+                    break;
+            }
+        }
+
+        size_t length = truth->length;
+        if (random() % 4 == 0) {
+            length = 8 + random() % (truth->length - 8);
+            _setPacketLength(packet, length);
+        }
+
+        bool expected = _referenceIsValid(packet, length);
+        CodecValidatorResult result = codecValidator_Validate(packet, length);
+        assertTrue((result == CodecValidatorResult_Ok) == expected, "%s iteration %u: expected %s got %s",
+                   truth->name, iteration, expected ? "valid" : "invalid", codecValidator_ResultToString(result));
+        if (expected) {
+            accepted++;
+        }
+    }
+
+    // make sure the fuzzer is exercising both outcomes
+    assertTrue(accepted > 0 && accepted < FUZZ_ITERATIONS, "Fuzzing accepted %u of %u", accepted, FUZZ_ITERATIONS);
+}
+
+LONGBOW_TEST_CASE(Global, codecValidator_ResultToString)
+{
+    assertTrue(strcmp(codecValidator_ResultToString(CodecValidatorResult_Ok), "Ok") == 0, "Wrong string for Ok");
+    assertTrue(strcmp(codecValidator_ResultToString(CodecValidatorResult_BadTlv), "BadTlv") == 0, "Wrong string for BadTlv");
+    assertTrue(strcmp(codecValidator_ResultToString((CodecValidatorResult) 99), "Unknown") == 0, "Wrong string for out of range");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(codec_Validator);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../component_Cache.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/internal/ccnx_InterestDefault.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+
+#include "testrig_MockFramework.c"
+
+static CCNxTransportConfig *
+_createParams(void)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingUpper_ProtocolStackConfig(stackConfig);
+    localCache_ProtocolStackConfig(stackConfig, 100, 100000);
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), localCache_GetName(), testingLower_GetName(), NULL);
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    testingUpper_ConnectionConfig(connConfig);
+    localCache_ConnectionConfig(connConfig);
+    testingLower_ConnectionConfig(connConfig);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+LONGBOW_TEST_RUNNER(component_Cache)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Component);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(component_Cache)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(component_Cache)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Component)
+{
+    LONGBOW_RUN_TEST_CASE(Component, component_Cache_Init);
+    LONGBOW_RUN_TEST_CASE(Component, component_Cache_Upcall_Read_ContentObject);
+    LONGBOW_RUN_TEST_CASE(Component, component_Cache_Downcall_Read_Miss);
+    LONGBOW_RUN_TEST_CASE(Component, component_Cache_Downcall_Read_Hit);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Component)
+{
+    CCNxTransportConfig *config = _createParams();
+    longBowTestCase_SetClipBoardData(testCase, mockFramework_Create(config));
+    ccnxTransportConfig_Destroy(&config);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Component)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    mockFramework_Destroy(&mock);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Component, component_Cache_Init)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    CacheStore *store = rtaProtocolStack_GetPrivateData(mock->stack, CACHE);
+    assertNotNull(store, "Init did not create the store");
+    assertTrue(cacheStore_Count(store) == 0, "New store should be empty");
+
+    PARCJSON *params = rtaProtocolStack_GetParameters(mock->stack);
+    size_t maxObjects = localCache_GetMaxObjectsFromConfig(params);
+    assertTrue(maxObjects == 100, "Wrong maxObjects, expected 100 got %zu", maxObjects);
+}
+
+LONGBOW_TEST_CASE(Component, component_Cache_Upcall_Read_ContentObject)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *tm = mockFramework_CreateContentObjectMessage(mock, "lci:/apple/pie");
+
+    TransportMessage *test_tm = mockFramework_SendUp(mock, tm);
+    assertTrue(test_tm == tm, "Content Object did not pass up the stack");
+
+    CacheStore *store = rtaProtocolStack_GetPrivateData(mock->stack, CACHE);
+    assertTrue(cacheStore_Count(store) == 1, "Content Object not stored, count %zu", cacheStore_Count(store));
+
+    transportMessage_Destroy(&test_tm);
+}
+
+LONGBOW_TEST_CASE(Component, component_Cache_Downcall_Read_Miss)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *tm = mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, tm, &bottom, &top);
+
+    assertTrue(bottom == tm, "Interest should have passed down the stack");
+    assertNull(top, "Nothing should have come back up the stack");
+    assertTrue(componentCache_GetStats(mock->stack)->lookups == 1, "Expected 1 lookup");
+
+    transportMessage_Destroy(&bottom);
+}
+
+LONGBOW_TEST_CASE(Component, component_Cache_Downcall_Read_Hit)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *up_tm = mockFramework_SendUp(mock, mockFramework_CreateContentObjectMessage(mock, "lci:/apple/pie"));
+    transportMessage_Destroy(&up_tm);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds), &bottom, &top);
+
+    assertNull(bottom, "Interest should have been answered from the store");
+    assertNotNull(top, "Content Object should have come back up the stack");
+    assertTrue(transportMessage_IsContentObject(top), "Expected a Content Object");
+    assertTrue(rtaConnection_GetFromTransport(top) == mock->connection, "Wrong connection on the response");
+
+    const CacheStoreStats *stats = componentCache_GetStats(mock->stack);
+    assertTrue(stats->hits == 1, "Expected 1 hit, got %" PRIu64, stats->hits);
+    assertTrue(componentCache_GetHitRatio(mock->stack) == 1.0, "Expected hit ratio 1.0");
+
+    transportMessage_Destroy(&top);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(component_Cache);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
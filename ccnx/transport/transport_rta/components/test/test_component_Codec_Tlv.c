@@ -46,7 +46,9 @@
 #include <ccnx/common/codec/schema_v1/testdata/v1_cpi_add_route_crc32c.h>
 
 
+#include <ccnx/common/ccnx_Interest.h>
 #include <ccnx/common/ccnx_WireFormatMessage.h>
+#include <ccnx/common/internal/ccnx_ValidationFacadeV1.h>
 
 #include "testrig_MockFramework.c"
 
@@ -57,7 +59,8 @@ typedef struct test_data {
 } TestData;
 
 static CCNxTransportConfig *
-codecTlv_CreateParams(const char *keystore_filename, const char *keystore_password)
+codecTlv_CreateParams(const char *keystore_filename, const char *keystore_password, unsigned signingWorkers, unsigned batchSize,
+                      bool lazyDecode, unsigned decodeWorkers)
 {
     assertNotNull(keystore_filename, "Got null keystore name\n");
     assertNotNull(keystore_password, "Got null keystore passwd\n");
@@ -67,6 +70,18 @@ codecTlv_CreateParams(const char *keystore_filename, const char *keystore_passwo
     apiConnector_ProtocolStackConfig(stackConfig);
     testingUpper_ProtocolStackConfig(stackConfig);
     tlvCodec_ProtocolStackConfig(stackConfig);
+    if (signingWorkers > 0) {
+        tlvCodec_SetSigningWorkers(stackConfig, signingWorkers);
+    }
+    if (batchSize > 0) {
+        tlvCodec_SetBatchSigning(stackConfig, batchSize, 1, true);
+    }
+    if (lazyDecode) {
+        tlvCodec_SetLazyDecode(stackConfig, true);
+    }
+    if (decodeWorkers > 0) {
+        tlvCodec_SetDecodeWorkers(stackConfig, decodeWorkers);
+    }
     testingLower_ProtocolStackConfig(stackConfig);
     protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), tlvCodec_GetName(), testingLower_GetName(), NULL);
 
@@ -88,7 +103,7 @@ codecTlv_CreateParams(const char *keystore_filename, const char *keystore_passwo
 }
 
 static TestData *
-_commonSetup(void)
+_commonSetup(unsigned signingWorkers, unsigned batchSize, bool lazyDecode, unsigned decodeWorkers)
 {
     parcSecurity_Init();
 
@@ -99,7 +114,7 @@ _commonSetup(void)
     mktemp(data->keystore_filename);
     sprintf(data->keystore_password, "12345");
 
-    CCNxTransportConfig *config = codecTlv_CreateParams(data->keystore_filename, data->keystore_password);
+    CCNxTransportConfig *config = codecTlv_CreateParams(data->keystore_filename, data->keystore_password, signingWorkers, batchSize, lazyDecode, decodeWorkers);
     data->mock = mockFramework_Create(config);
     ccnxTransportConfig_Destroy(&config);
     return data;
@@ -119,6 +134,11 @@ LONGBOW_TEST_RUNNER(component_Codec_Tlv)
 {
     LONGBOW_RUN_TEST_FIXTURE(Global);
     LONGBOW_RUN_TEST_FIXTURE(Dictionary);
+    LONGBOW_RUN_TEST_FIXTURE(Signing);
+    LONGBOW_RUN_TEST_FIXTURE(Batch);
+    LONGBOW_RUN_TEST_FIXTURE(BatchWorkers);
+    LONGBOW_RUN_TEST_FIXTURE(Lazy);
+    LONGBOW_RUN_TEST_FIXTURE(Decode);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -196,7 +216,7 @@ LONGBOW_TEST_FIXTURE(Dictionary)
 
 LONGBOW_TEST_FIXTURE_SETUP(Dictionary)
 {
-    longBowTestCase_SetClipBoardData(testCase, _commonSetup());
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(0, 0, false, 0));
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
@@ -313,6 +333,464 @@ LONGBOW_TEST_CASE(Dictionary, component_Codec_Tlv_Upcall_Read_Control)
     transportMessage_Destroy(&tm);
 }
 
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Signing)
+{
+    LONGBOW_RUN_TEST_CASE(Signing, component_Codec_Tlv_Init_SigningPool);
+    LONGBOW_RUN_TEST_CASE(Signing, component_Codec_Tlv_Downcall_Read_InOrder);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Signing)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(2, 0, false, 0));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Signing)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Signing, component_Codec_Tlv_Init_SigningPool)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(data->mock->stack, CODEC_TLV);
+    assertNotNull(stackState->signingPool, "Expected a signing pool");
+    assertTrue(rtaWorkerPool_GetWorkerCount(stackState->signingPool) == 2, "Expected 2 signing workers");
+
+    CodecConnectionState *codecState = rtaConnection_GetPrivateData(data->mock->connection, CODEC_TLV);
+    assertTrue(codecState->signerCount == 2, "Expected one signer per worker, got %zu", codecState->signerCount);
+    assertTrue(codecState->idleCount == 2, "Expected all signers idle, got %zu", codecState->idleCount);
+}
+
+/**
+ * Messages that need signing and messages that do not must come out the bottom in the
+ * order they went in.
+ */
+LONGBOW_TEST_CASE(Signing, component_Codec_Tlv_Downcall_Read_InOrder)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    const size_t count = 9;
+    TransportMessage *sent[count];
+    for (size_t i = 0; i < count; i++) {
+        if (i % 3 == 1) {
+            sent[i] = trafficTools_CreateTransportMessageWithDictionaryRaw(data->mock->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        } else {
+            sent[i] = trafficTools_CreateTransportMessageWithDictionaryInterest(data->mock->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        }
+        rtaComponent_PutMessage(in, sent[i]);
+    }
+
+    size_t received = 0;
+    for (int tries = 0; tries < 1000 && received < count; tries++) {
+        rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+        TransportMessage *test_tm;
+        while ((test_tm = rtaComponent_GetMessage(out)) != NULL) {
+            assertTrue(test_tm == sent[received], "Message %zu came out of order", received);
+            CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(test_tm);
+            assertTrue(ccnxWireFormatMessage_GetIoVec(dictionary) != NULL || ccnxWireFormatMessage_GetWireFormatBuffer(dictionary) != NULL,
+                       "Message %zu has no wire format", received);
+            transportMessage_Destroy(&test_tm);
+            received++;
+        }
+        usleep(1000);
+    }
+
+    assertTrue(received == count, "Expected %zu messages, got %zu", count, received);
+
+    const CodecSigningStats *stats = componentCodecTlv_GetSigningStats(data->mock->connection);
+    assertTrue(stats->encoded == 6, "Expected 6 encoded, got %" PRIu64, stats->encoded);
+    assertTrue(stats->queueDepth == 0, "Expected empty queue, got %" PRIu64, stats->queueDepth);
+    assertTrue(stats->maxQueueDepth > 0, "Expected a max queue depth");
+}
+
+// ==================================================================================
+
+static TransportMessage *
+_createContentObjectMessage(TestData *data, size_t i)
+{
+    char uri[64];
+    snprintf(uri, sizeof(uri), "lci:/batch/chunk=%zu", i);
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    PARCBuffer *payload = parcBuffer_WrapCString("segment");
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->mock->connection), rtaConnection_FreeFunc);
+
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+    return tm;
+}
+
+LONGBOW_TEST_FIXTURE(Batch)
+{
+    LONGBOW_RUN_TEST_CASE(Batch, component_Codec_Tlv_Batch_Full);
+    LONGBOW_RUN_TEST_CASE(Batch, component_Codec_Tlv_Batch_Timeout_InOrder);
+    LONGBOW_RUN_TEST_CASE(Batch, component_Codec_Tlv_Batch_Close_Flushes);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Batch)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(0, 4, false, 0));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Batch)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * A full batch goes down at once under one signature, each object with its own proof
+ */
+LONGBOW_TEST_CASE(Batch, component_Codec_Tlv_Batch_Full)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    TransportMessage *sent[4];
+    for (size_t i = 0; i < 4; i++) {
+        sent[i] = _createContentObjectMessage(data, i);
+        rtaComponent_PutMessage(in, sent[i]);
+    }
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+    for (size_t i = 0; i < 4; i++) {
+        TransportMessage *test_tm = rtaComponent_GetMessage(out);
+        assertTrue(test_tm == sent[i], "Message %zu came out of order", i);
+
+        CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(test_tm);
+        assertNotNull(ccnxWireFormatMessage_GetIoVec(dictionary), "Message %zu has no wire format", i);
+
+        PARCBuffer *payload = ccnxValidationFacadeV1_GetPayload(dictionary);
+        assertNotNull(payload, "Message %zu has no validation payload", i);
+
+        // the payload starts with the batch mark and then the proof, whose first field is the leaf index
+        assertTrue(codecMerkleTree_IsBatchPayload(payload), "Message %zu has no batch mark", i);
+        assertTrue(parcBuffer_GetAtIndex(payload, CODEC_MERKLE_BATCH_MAGIC_LENGTH + 3) == i, "Message %zu has the wrong leaf index", i);
+
+        transportMessage_Destroy(&test_tm);
+    }
+
+    const CodecSigningStats *stats = componentCodecTlv_GetSigningStats(data->mock->connection);
+    assertTrue(stats->batches == 1, "Expected 1 batch, got %" PRIu64, stats->batches);
+    assertTrue(stats->batchedObjects == 4, "Expected 4 batched objects, got %" PRIu64, stats->batchedObjects);
+}
+
+/**
+ * A partial batch goes down when its timer fires, and an Interest sent after it
+ * does not pass it.
+ */
+LONGBOW_TEST_CASE(Batch, component_Codec_Tlv_Batch_Timeout_InOrder)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    TransportMessage *object = _createContentObjectMessage(data, 0);
+    TransportMessage *interest = trafficTools_CreateTransportMessageWithDictionaryInterest(data->mock->connection, CCNxTlvDictionary_SchemaVersion_V1);
+    rtaComponent_PutMessage(in, object);
+    rtaComponent_PutMessage(in, interest);
+
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+    usleep(10000);
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+    TransportMessage *first = rtaComponent_GetMessage(out);
+    TransportMessage *second = rtaComponent_GetMessage(out);
+    assertTrue(first == object, "Expected the Content Object first");
+    assertTrue(second == interest, "Expected the Interest second");
+
+    transportMessage_Destroy(&first);
+    transportMessage_Destroy(&second);
+}
+
+/**
+ * Send fewer Content Objects than a batch, then close the connection before the batch timer
+ * fires.  Every object must still go down, while the connection takes messages.
+ */
+static void
+_closeWithPartialBatch(TestData *data, size_t count)
+{
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    for (size_t i = 0; i < count; i++) {
+        rtaComponent_PutMessage(in, _createContentObjectMessage(data, i));
+    }
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+    RtaConnection *conn = rtaConnection_Copy(data->mock->connection);
+    RtaComponentStats *stats = rtaConnection_GetStats(conn, CODEC_TLV);
+    assertTrue(rtaComponentStats_Get(stats, STATS_DOWNCALL_OUT) == 0, "The partial batch should still be held");
+
+    rtaFramework_CloseConnection(data->mock->framework, conn);
+
+    uint64_t sent = rtaComponentStats_Get(stats, STATS_DOWNCALL_OUT);
+    assertTrue(sent == count, "Expected %zu messages sent down on close, got %" PRIu64, count, sent);
+
+    // the connection is closed now, reading drops what is queued for it
+    assertNull(rtaComponent_GetMessage(out), "Nothing of a closed connection should be read");
+    rtaConnection_Destroy(&conn);
+}
+
+LONGBOW_TEST_CASE(Batch, component_Codec_Tlv_Batch_Close_Flushes)
+{
+    _closeWithPartialBatch(longBowTestCase_GetClipBoardData(testCase), 3);
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(BatchWorkers)
+{
+    LONGBOW_RUN_TEST_CASE(BatchWorkers, component_Codec_Tlv_Batch_OnWorker_InOrder);
+    LONGBOW_RUN_TEST_CASE(BatchWorkers, component_Codec_Tlv_Batch_OnWorker_Close_Flushes);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(BatchWorkers)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(2, 4, false, 0));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(BatchWorkers)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * With signing workers the batch is signed on a worker as one job.  An Interest that joins
+ * the batch and one sent after it still come out in order.
+ */
+LONGBOW_TEST_CASE(BatchWorkers, component_Codec_Tlv_Batch_OnWorker_InOrder)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    const size_t count = 6;
+    TransportMessage *sent[count];
+    for (size_t i = 0; i < count; i++) {
+        if (i == 2 || i == 5) {
+            sent[i] = trafficTools_CreateTransportMessageWithDictionaryInterest(data->mock->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        } else {
+            sent[i] = _createContentObjectMessage(data, i);
+        }
+        rtaComponent_PutMessage(in, sent[i]);
+    }
+
+    size_t received = 0;
+    for (int tries = 0; tries < 1000 && received < count; tries++) {
+        rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+        TransportMessage *test_tm;
+        while ((test_tm = rtaComponent_GetMessage(out)) != NULL) {
+            assertTrue(test_tm == sent[received], "Message %zu came out of order", received);
+            CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(test_tm);
+            assertNotNull(ccnxWireFormatMessage_GetIoVec(dictionary), "Message %zu has no wire format", received);
+            if (transportMessage_IsContentObject(test_tm)) {
+                assertTrue(codecMerkleTree_IsBatchPayload(ccnxValidationFacadeV1_GetPayload(dictionary)),
+                           "Content Object %zu is not batch signed", received);
+            }
+            transportMessage_Destroy(&test_tm);
+            received++;
+        }
+        usleep(1000);
+    }
+
+    assertTrue(received == count, "Expected %zu messages, got %zu", count, received);
+
+    const CodecSigningStats *stats = componentCodecTlv_GetSigningStats(data->mock->connection);
+    assertTrue(stats->batches == 1, "Expected 1 batch, got %" PRIu64, stats->batches);
+    assertTrue(stats->batchedObjects == 4, "Expected 4 batched objects, got %" PRIu64, stats->batchedObjects);
+    assertTrue(stats->queueDepth == 0, "Expected empty queue, got %" PRIu64, stats->queueDepth);
+}
+
+LONGBOW_TEST_CASE(BatchWorkers, component_Codec_Tlv_Batch_OnWorker_Close_Flushes)
+{
+    _closeWithPartialBatch(longBowTestCase_GetClipBoardData(testCase), 3);
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Lazy)
+{
+    LONGBOW_RUN_TEST_CASE(Lazy, component_Codec_Tlv_Upcall_Read_Lazy);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Lazy)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(0, 0, true, 0));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Lazy)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Lazy, component_Codec_Tlv_Upcall_Read_Lazy)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    PARCBuffer *wireFormat = parcBuffer_Wrap(v1_interest_nameA, sizeof(v1_interest_nameA), 0, sizeof(v1_interest_nameA));
+    CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_FromInterestPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    parcBuffer_Release(&wireFormat);
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    transportMessage_SetInfo(tm, data->mock->connection, NULL);
+    ccnxTlvDictionary_Release(&dictionary);
+
+    TransportMessage *test_tm = sendUp(data, tm);
+
+    // Only the name is decoded on the way up
+    assertTrue(transportMessage_IsDecodeDeferred(test_tm), "Expected the codec to defer the decode");
+    CCNxTlvDictionary *testdict = transportMessage_GetDictionary(test_tm);
+    assertNotNull(ccnxTlvDictionary_GetName(testdict, CCNxCodecSchemaV1TlvDictionary_MessageFastArray_NAME),
+                  "Expected the name to be decoded eagerly");
+
+    assertTrue(transportMessage_CompleteDecode(test_tm), "Deferred decode failed");
+    testdict = transportMessage_GetDictionary(test_tm);
+    assertTrue(ccnxTlvDictionary_IsInterest(testdict), "Dictionary says it is not an Interest");
+    assertNotNull(ccnxInterest_GetName(testdict), "Fully decoded Interest has no name");
+
+    transportMessage_Destroy(&test_tm);
+}
+
+// ==================================================================================
+
+static TransportMessage *
+_createReceivedMessage(TestData *data, bool isControl)
+{
+    PARCBuffer *wireFormat;
+    CCNxTlvDictionary *dictionary;
+    if (isControl) {
+        wireFormat = parcBuffer_Wrap(v1_cpi_add_route_crc32c, sizeof(v1_cpi_add_route_crc32c), 0, sizeof(v1_cpi_add_route_crc32c));
+        dictionary = ccnxWireFormatMessage_FromControlPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    } else {
+        wireFormat = parcBuffer_Wrap(v1_interest_nameA, sizeof(v1_interest_nameA), 0, sizeof(v1_interest_nameA));
+        dictionary = ccnxWireFormatMessage_FromInterestPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    }
+    parcBuffer_Release(&wireFormat);
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->mock->connection), rtaConnection_FreeFunc);
+    ccnxTlvDictionary_Release(&dictionary);
+    return tm;
+}
+
+LONGBOW_TEST_FIXTURE(Decode)
+{
+    LONGBOW_RUN_TEST_CASE(Decode, component_Codec_Tlv_Init_DecodePool);
+    LONGBOW_RUN_TEST_CASE(Decode, component_Codec_Tlv_Upcall_Read_InOrder);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Decode)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(0, 0, false, 2));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Decode)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Decode, component_Codec_Tlv_Init_DecodePool)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    CodecStackState *stackState = rtaProtocolStack_GetPrivateData(data->mock->stack, CODEC_TLV);
+    assertNotNull(stackState->decodePool, "Expected a decode pool");
+    assertTrue(rtaWorkerPool_GetWorkerCount(stackState->decodePool) == 2, "Expected 2 decode workers");
+    assertNull(stackState->signingPool, "Did not ask for a signing pool");
+}
+
+/**
+ * Packets decoded on the workers and control messages that are not must come out the
+ * top in the order they went in.
+ */
+LONGBOW_TEST_CASE(Decode, component_Codec_Tlv_Upcall_Read_InOrder)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+
+    const size_t count = 9;
+    TransportMessage *sent[count];
+    for (size_t i = 0; i < count; i++) {
+        sent[i] = _createReceivedMessage(data, i % 3 == 1);
+        rtaComponent_PutMessage(in, sent[i]);
+    }
+
+    size_t received = 0;
+    for (int tries = 0; tries < 1000 && received < count; tries++) {
+        rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+        TransportMessage *test_tm;
+        while ((test_tm = rtaComponent_GetMessage(out)) != NULL) {
+            assertTrue(test_tm == sent[received], "Message %zu came out of order", received);
+            if (received % 3 != 1) {
+                CCNxTlvDictionary *dictionary = transportMessage_GetDictionary(test_tm);
+                assertNotNull(ccnxInterest_GetName(dictionary), "Message %zu was not decoded", received);
+            }
+            transportMessage_Destroy(&test_tm);
+            received++;
+        }
+        usleep(1000);
+    }
+
+    assertTrue(received == count, "Expected %zu messages, got %zu", count, received);
+
+    CodecConnectionState *codecState = rtaConnection_GetPrivateData(data->mock->connection, CODEC_TLV);
+    assertTrue(TAILQ_EMPTY(&codecState->upInOrder), "Expected an empty up queue");
+    assertTrue(codecState->outstanding == 0, "Expected no outstanding jobs, got %zu", codecState->outstanding);
+}
+
 int
 main(int argc, char *argv[])
 {
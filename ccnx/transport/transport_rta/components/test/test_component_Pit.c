@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../component_Pit.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/internal/ccnx_InterestDefault.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+
+#include "testrig_MockFramework.c"
+
+static CCNxTransportConfig *
+_createParams(void)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingUpper_ProtocolStackConfig(stackConfig);
+    localPit_ProtocolStackConfig(stackConfig, 100);
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), localPit_GetName(), testingLower_GetName(), NULL);
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    testingUpper_ConnectionConfig(connConfig);
+    localPit_ConnectionConfig(connConfig);
+    testingLower_ConnectionConfig(connConfig);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+LONGBOW_TEST_RUNNER(component_Pit)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Component);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(component_Pit)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(component_Pit)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Component)
+{
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Opener);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Downcall_Read_Forward);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Downcall_Read_Aggregate);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Downcall_Read_Refresh);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Upcall_Read_FanOut);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Upcall_Read_Unsolicited);
+    LONGBOW_RUN_TEST_CASE(Component, component_Pit_Expiry);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Component)
+{
+    CCNxTransportConfig *config = _createParams();
+    longBowTestCase_SetClipBoardData(testCase, mockFramework_Create(config));
+    ccnxTransportConfig_Destroy(&config);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Component)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    mockFramework_Destroy(&mock);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Opener)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    PitConnectionState *state = rtaConnection_GetPrivateData(mock->connection, PIT);
+    assertNotNull(state, "Opener did not create the connection state");
+    assertTrue(state->connection == mock->connection, "Wrong connection in the state");
+    assertTrue(componentPit_GetPendingCount(mock->connection) == 0, "New table should be empty");
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Downcall_Read_Forward)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *tm = mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, tm, &bottom, &top);
+
+    assertTrue(bottom == tm, "Interest should have passed down the stack");
+    assertNull(top, "Nothing should have come back up the stack");
+    assertTrue(componentPit_GetPendingCount(mock->connection) == 1, "Expected 1 pending Interest");
+
+    transportMessage_Destroy(&bottom);
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Downcall_Read_Aggregate)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds), &bottom, &top);
+    transportMessage_Destroy(&bottom);
+
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds), &bottom, &top);
+    assertNull(bottom, "Duplicate Interest should not have passed down the stack");
+    assertNull(top, "Nothing should have come back up the stack");
+
+    const PitTableStats *stats = componentPit_GetStats(mock->connection);
+    assertTrue(stats->aggregated == 1, "Expected 1 aggregated, got %" PRIu64, stats->aggregated);
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Downcall_Read_Refresh)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", 1000), &bottom, &top);
+    transportMessage_Destroy(&bottom);
+
+    TransportMessage *refresh = mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", 4000);
+    mockFramework_SendDown(mock, refresh, &bottom, &top);
+    assertTrue(bottom == refresh, "Refreshing Interest should have passed down the stack");
+    assertNull(top, "Nothing should have come back up the stack");
+    transportMessage_Destroy(&bottom);
+
+    // The forwarder answers both Interests.  The first answer satisfies the entry and the
+    // second is unsolicited, so each comes up exactly once.
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    for (int i = 0; i < 2; i++) {
+        TransportMessage *tm = mockFramework_CreateContentObjectMessage(mock, "lci:/apple/pie");
+        TransportMessage *test_tm = mockFramework_SendUp(mock, tm);
+        assertTrue(test_tm == tm, "Answer %d should pass up the stack", i);
+        assertNull(rtaComponent_GetMessage(out), "Answer %d should not be copied", i);
+        transportMessage_Destroy(&test_tm);
+    }
+
+    assertTrue(componentPit_GetPendingCount(mock->connection) == 0, "Expected empty table");
+    const PitTableStats *stats = componentPit_GetStats(mock->connection);
+    assertTrue(stats->waitersServed == 1, "Expected 1 waiter served, got %" PRIu64, stats->waitersServed);
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Upcall_Read_FanOut)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds), &bottom, &top);
+    transportMessage_Destroy(&bottom);
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds), &bottom, &top);
+
+    TransportMessage *first = mockFramework_SendUp(mock, mockFramework_CreateContentObjectMessage(mock, "lci:/apple/pie"));
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    TransportMessage *second = rtaComponent_GetMessage(out);
+
+    assertNotNull(first, "First waiter did not get the Content Object");
+    assertNotNull(second, "Second waiter did not get the Content Object");
+    assertTrue(transportMessage_GetDictionary(first) == transportMessage_GetDictionary(second),
+               "Waiters should share the same dictionary");
+    assertTrue(componentPit_GetPendingCount(mock->connection) == 0, "Expected empty table");
+
+    transportMessage_Destroy(&first);
+    transportMessage_Destroy(&second);
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Upcall_Read_Unsolicited)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *tm = mockFramework_CreateContentObjectMessage(mock, "lci:/apple/pie");
+
+    TransportMessage *test_tm = mockFramework_SendUp(mock, tm);
+    assertTrue(test_tm == tm, "Unsolicited Content Object should pass up the stack once");
+
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    assertNull(rtaComponent_GetMessage(out), "Unsolicited Content Object should not be copied");
+
+    transportMessage_Destroy(&test_tm);
+}
+
+LONGBOW_TEST_CASE(Component, component_Pit_Expiry)
+{
+    MockFramework *mock = longBowTestCase_GetClipBoardData(testCase);
+
+    TransportMessage *bottom;
+    TransportMessage *top;
+    mockFramework_SendDown(mock, mockFramework_CreateInterestMessage(mock, "lci:/apple/pie", 0), &bottom, &top);
+    transportMessage_Destroy(&bottom);
+
+    // a zero lifetime fires the timer on the next pass of the event loop
+    rtaFramework_NonThreadedStepCount(mock->framework, 10);
+
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    TransportMessage *status = rtaComponent_GetMessage(out);
+    assertNotNull(status, "Expected an INTEREST_TIMEOUT status");
+    assertTrue(transportMessage_IsControl(status), "Expected a control message");
+    assertTrue(componentPit_GetPendingCount(mock->connection) == 0, "Expected empty table");
+    assertTrue(componentPit_GetStats(mock->connection)->expired == 1, "Expected 1 expired");
+
+    transportMessage_Destroy(&status);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(component_Pit);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../component_Verify.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <parc/security/parc_Security.h>
+#include <parc/security/parc_PublicKeySignerPkcs12Store.h>
+
+#include <ccnx/common/validation/ccnxValidation_RsaSha256.h>
+#include <ccnx/common/internal/ccnx_InterestDefault.h>
+#include <ccnx/common/codec/ccnxCodec_NetworkBuffer.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+
+#include "../codec_Signing.h"
+#include "testrig_MockFramework.c"
+
+typedef struct test_data {
+    MockFramework *mock;
+    PARCBuffer *trustedKeyId;
+    char keystoreFilename[64];
+} TestData;
+
+static CCNxTransportConfig *
+_createParams(PARCBuffer *trustedKeyId)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingUpper_ProtocolStackConfig(stackConfig);
+    verifyEnumerated_ProtocolStackConfig(stackConfig, 0);
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), verifyEnumerated_GetName(), testingLower_GetName(), NULL);
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    testingUpper_ConnectionConfig(connConfig);
+    verifyEnumerated_ConnectionConfig(connConfig, trustedKeyId, NULL);
+    testingLower_ConnectionConfig(connConfig);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+static TestData *
+_commonSetup(void)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    data->trustedKeyId = parcBuffer_WrapCString("trusted keyid");
+
+    CCNxTransportConfig *config = _createParams(data->trustedKeyId);
+    data->mock = mockFramework_Create(config);
+    ccnxTransportConfig_Destroy(&config);
+    return data;
+}
+
+static void
+_commonTeardown(TestData *data)
+{
+    mockFramework_Destroy(&data->mock);
+    parcBuffer_Release(&data->trustedKeyId);
+    parcMemory_Deallocate((void **) &data);
+}
+
+/**
+ * Creates a Content Object message.  If keyId is not NULL, the object claims an RSA-SHA256
+ * signature by that KeyId.
+ */
+static TransportMessage *
+_createContentObjectMessage(TestData *data, const char *uri, PARCBuffer *keyId)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    PARCBuffer *payload = parcBuffer_WrapCString("hello");
+    CCNxTlvDictionary *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+
+    if (keyId != NULL) {
+        ccnxValidationRsaSha256_Set(contentObject, keyId, NULL);
+    }
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->mock->connection), rtaConnection_FreeFunc);
+
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+    return tm;
+}
+
+static TransportMessage *
+_sendUp(TestData *data, TransportMessage *tm)
+{
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    rtaComponent_PutMessage(in, tm);
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+    return rtaComponent_GetMessage(out);
+}
+
+/**
+ * A stack with the TLV codec under the Verify component, batch signing 3 Content Objects at a time
+ */
+static CCNxTransportConfig *
+_createBatchParams(const char *keystoreFilename, const char *keystorePassword)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingUpper_ProtocolStackConfig(stackConfig);
+    verifyEnumerated_ProtocolStackConfig(stackConfig, 0);
+    tlvCodec_ProtocolStackConfig(stackConfig);
+    tlvCodec_SetBatchSigning(stackConfig, 3, 1, true);
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingUpper_GetName(), verifyEnumerated_GetName(),
+                                       tlvCodec_GetName(), testingLower_GetName(), NULL);
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    testingUpper_ConnectionConfig(connConfig);
+    verifyEnumerated_ConnectionConfig(connConfig, NULL);
+    tlvCodec_ConnectionConfig(connConfig);
+    testingLower_ConnectionConfig(connConfig);
+    publicKeySignerPkcs12Store_ConnectionConfig(connConfig, keystoreFilename, keystorePassword);
+
+    CCNxTransportConfig *result = ccnxTransportConfig_Create(stackConfig, connConfig);
+    ccnxStackConfig_Release(&stackConfig);
+    return result;
+}
+
+/**
+ * The connection trusts the codec's own signing key
+ */
+static TestData *
+_batchSetup(void)
+{
+    parcSecurity_Init();
+
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    sprintf(data->keystoreFilename, "/tmp/verify_keystore.p12.XXXXXX");
+    mktemp(data->keystoreFilename);
+    bool success = parcPublicKeySignerPkcs12Store_CreateFile(data->keystoreFilename, "12345", "alice", 1024, 30);
+    assertTrue(success, "parcPublicKeySignerPkcs12Store_CreateFile() failed.");
+
+    CCNxTransportConfig *config = _createBatchParams(data->keystoreFilename, "12345");
+    data->mock = mockFramework_Create(config);
+    ccnxTransportConfig_Destroy(&config);
+
+    PARCSigner *signer = component_Codec_GetSigner(data->mock->connection);
+    PARCKey *key = parcSigner_CreatePublicKey(signer);
+    VerifyConnectionState *state = rtaConnection_GetPrivateData(data->mock->connection, VERIFY_ENUMERATED);
+    verifyKeyCache_AddTrustedKey(state->keyCache, key);
+    parcKey_Release(&key);
+    parcSigner_Release(&signer);
+
+    return data;
+}
+
+static void
+_batchTeardown(TestData *data)
+{
+    mockFramework_Destroy(&data->mock);
+    unlink(data->keystoreFilename);
+    parcMemory_Deallocate((void **) &data);
+
+    parcSecurity_Fini();
+}
+
+/**
+ * What a peer would receive: a new dictionary with only the wire format the codec made
+ */
+static TransportMessage *
+_createReceivedMessage(TestData *data, TransportMessage *encoded, bool tamper)
+{
+    CCNxCodecNetworkBufferIoVec *vec = ccnxWireFormatMessage_GetIoVec(transportMessage_GetDictionary(encoded));
+    const struct iovec *array = ccnxCodecNetworkBufferIoVec_GetArray(vec);
+    int count = ccnxCodecNetworkBufferIoVec_GetCount(vec);
+
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        length += array[i].iov_len;
+    }
+
+    PARCBuffer *wireFormat = parcBuffer_Allocate(length);
+    for (int i = 0; i < count; i++) {
+        parcBuffer_PutArray(wireFormat, array[i].iov_len, array[i].iov_base);
+    }
+    parcBuffer_Flip(wireFormat);
+
+    if (tamper) {
+        // the last byte of the message TLV is the last byte of the payload
+        size_t start = parcBuffer_GetAtIndex(wireFormat, 7);
+        size_t end = start + 4 + (((size_t) parcBuffer_GetAtIndex(wireFormat, start + 2) << 8) | parcBuffer_GetAtIndex(wireFormat, start + 3));
+        uint8_t *last = parcBuffer_Overlay(wireFormat, 0) + end - 1;
+        *last ^= 0xFF;
+    }
+
+    CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_FromContentObjectPacketType(CCNxTlvDictionary_SchemaVersion_V1, wireFormat);
+    parcBuffer_Release(&wireFormat);
+
+    TransportMessage *tm = transportMessage_CreateFromDictionary(dictionary);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->mock->connection), rtaConnection_FreeFunc);
+    ccnxTlvDictionary_Release(&dictionary);
+    return tm;
+}
+
+LONGBOW_TEST_RUNNER(component_Verify)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Component);
+    LONGBOW_RUN_TEST_FIXTURE(Batch);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(component_Verify)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(component_Verify)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Component)
+{
+    LONGBOW_RUN_TEST_CASE(Component, component_Verify_Opener);
+    LONGBOW_RUN_TEST_CASE(Component, component_Verify_Downcall_Read);
+    LONGBOW_RUN_TEST_CASE(Component, component_Verify_Upcall_Read_Unsigned);
+    LONGBOW_RUN_TEST_CASE(Component, component_Verify_Upcall_Read_Untrusted);
+    LONGBOW_RUN_TEST_CASE(Component, component_Verify_Upcall_Read_UnknownKey);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Component)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Component)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Component, component_Verify_Opener)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    VerifyConnectionState *state = rtaConnection_GetPrivateData(data->mock->connection, VERIFY_ENUMERATED);
+    assertNotNull(state, "Opener did not create the connection state");
+    assertTrue(verifyKeyCache_IsTrusted(state->keyCache, data->trustedKeyId), "KeyId from the connection config not trusted");
+
+    VerifyStackState *stackState = rtaProtocolStack_GetPrivateData(data->mock->stack, VERIFY_ENUMERATED);
+    assertTrue(rtaWorkerPool_GetWorkerCount(stackState->pool) == 0, "Expected the pool to have 0 workers");
+}
+
+LONGBOW_TEST_CASE(Component, component_Verify_Downcall_Read)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *name = ccnxName_CreateFromURI("lci:/apple/pie");
+    CCNxInterest *interest = ccnxInterest_Create(name, CCNxInterestDefault_LifetimeMilliseconds, NULL, NULL);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(interest);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->mock->connection), rtaConnection_FreeFunc);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *bottom = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    rtaComponent_PutMessage(in, tm);
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+    TransportMessage *test = rtaComponent_GetMessage(bottom);
+
+    assertTrue(test == tm, "Interest should have passed down the stack");
+    transportMessage_Destroy(&test);
+}
+
+LONGBOW_TEST_CASE(Component, component_Verify_Upcall_Read_Unsigned)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TransportMessage *tm = _createContentObjectMessage(data, "lci:/apple/pie", NULL);
+
+    TransportMessage *test = _sendUp(data, tm);
+    assertTrue(test == tm, "Unsigned Content Object should have passed up the stack");
+
+    const VerifyStats *stats = componentVerify_GetStats(data->mock->connection);
+    assertTrue(stats->unsignedObjects == 1, "Expected 1 unsigned, got %" PRIu64, stats->unsignedObjects);
+
+    transportMessage_Destroy(&test);
+}
+
+LONGBOW_TEST_CASE(Component, component_Verify_Upcall_Read_Untrusted)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCBuffer *keyId = parcBuffer_WrapCString("mallory");
+    TransportMessage *tm = _createContentObjectMessage(data, "lci:/apple/pie", keyId);
+    parcBuffer_Release(&keyId);
+
+    TransportMessage *test = _sendUp(data, tm);
+    assertNotNull(test, "Expected a VERIFICATION_ERROR status");
+    assertTrue(transportMessage_IsControl(test), "Expected a control message, the Content Object should be dropped");
+
+    const VerifyStats *stats = componentVerify_GetStats(data->mock->connection);
+    assertTrue(stats->untrusted == 1, "Expected 1 untrusted, got %" PRIu64, stats->untrusted);
+
+    transportMessage_Destroy(&test);
+}
+
+LONGBOW_TEST_CASE(Component, component_Verify_Upcall_Read_UnknownKey)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // Trusted, but carries no public key so there is nothing to verify with
+    TransportMessage *tm = _createContentObjectMessage(data, "lci:/apple/pie", data->trustedKeyId);
+
+    TransportMessage *test = _sendUp(data, tm);
+    assertNotNull(test, "Expected a VERIFICATION_ERROR status");
+    assertTrue(transportMessage_IsControl(test), "Expected a control message, the Content Object should be dropped");
+
+    VerifyConnectionState *state = rtaConnection_GetPrivateData(data->mock->connection, VERIFY_ENUMERATED);
+    assertTrue(TAILQ_EMPTY(&state->inOrder), "Nothing should be left waiting");
+
+    transportMessage_Destroy(&test);
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Batch)
+{
+    LONGBOW_RUN_TEST_CASE(Batch, component_Verify_Upcall_Read_BatchRoundTrip);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Batch)
+{
+    longBowTestCase_SetClipBoardData(testCase, _batchSetup());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Batch)
+{
+    _batchTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * Content Objects the codec signs in a batch verify when they come back up, and one whose
+ * payload changed on the way does not.
+ */
+LONGBOW_TEST_CASE(Batch, component_Verify_Upcall_Read_BatchRoundTrip)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    PARCEventQueue *top = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *bottom = rtaProtocolStack_GetPutQueue(data->mock->stack, TESTING_LOWER, RTA_UP);
+
+    const char *uris[] = { "lci:/batch/chunk=0", "lci:/batch/chunk=1", "lci:/batch/chunk=2" };
+    for (size_t i = 0; i < 3; i++) {
+        rtaComponent_PutMessage(top, _createContentObjectMessage(data, uris[i], NULL));
+    }
+    rtaFramework_NonThreadedStepCount(data->mock->framework, 10);
+
+    TransportMessage *encoded[3];
+    for (size_t i = 0; i < 3; i++) {
+        encoded[i] = rtaComponent_GetMessage(bottom);
+        assertNotNull(encoded[i], "Expected Content Object %zu at the bottom of the stack", i);
+        assertTrue(codecMerkleTree_IsBatchPayload(ccnxValidationFacadeV1_GetPayload(transportMessage_GetDictionary(encoded[i]))),
+                   "Content Object %zu is not batch signed", i);
+    }
+
+    for (size_t i = 0; i < 3; i++) {
+        TransportMessage *tm = _createReceivedMessage(data, encoded[i], false);
+        TransportMessage *test = _sendUp(data, tm);
+        assertTrue(test == tm, "Batch signed Content Object %zu should have verified", i);
+        transportMessage_Destroy(&test);
+    }
+
+    TransportMessage *tampered = _createReceivedMessage(data, encoded[1], true);
+    TransportMessage *test = _sendUp(data, tampered);
+    assertNotNull(test, "Expected a VERIFICATION_ERROR status");
+    assertTrue(transportMessage_IsControl(test), "Expected a control message, the tampered Content Object should be dropped");
+    transportMessage_Destroy(&test);
+
+    const VerifyStats *stats = componentVerify_GetStats(data->mock->connection);
+    assertTrue(stats->verified == 3, "Expected 3 verified, got %" PRIu64, stats->verified);
+    assertTrue(stats->failed == 1, "Expected 1 failed, got %" PRIu64, stats->failed);
+
+    for (size_t i = 0; i < 3; i++) {
+        transportMessage_Destroy(&encoded[i]);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(component_Verify);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
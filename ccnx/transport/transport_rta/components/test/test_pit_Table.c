@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../pit_Table.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/common/internal/ccnx_InterestDefault.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+#include "testrig_Messages.c"
+
+LONGBOW_TEST_RUNNER(pit_Table)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(pit_Table)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(pit_Table)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Create);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Receive_Forward);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Receive_Aggregate);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Receive_Refresh);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Receive_DifferentKeyId);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Receive_Full);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Satisfy);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_Satisfy_Unsolicited);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_PopExpired);
+    LONGBOW_RUN_TEST_CASE(Global, pitTable_NextExpiry_Order);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Create)
+{
+    PitTable *table = pitTable_Create(100);
+    assertNotNull(table, "Got null table");
+    assertTrue(pitTable_Count(table) == 0, "New table should be empty");
+    assertTrue(table->bucketCount == 128, "Expected 128 buckets, got %zu", table->bucketCount);
+    pitTable_Destroy(&table);
+    assertNull(table, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Receive_Forward)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    PitVerdict verdict = pitTable_Receive(table, interest, 1000);
+    assertTrue(verdict == PitVerdict_Forward, "Expected PitVerdict_Forward, got %d", verdict);
+    assertTrue(pitTable_Count(table) == 1, "Expected 1 entry, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&interest);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Receive_Aggregate)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *first = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *second = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    pitTable_Receive(table, first, 1000);
+    PitVerdict verdict = pitTable_Receive(table, second, 1000);
+    assertTrue(verdict == PitVerdict_Aggregate, "Expected PitVerdict_Aggregate, got %d", verdict);
+    assertTrue(pitTable_Count(table) == 1, "Expected 1 entry, got %zu", pitTable_Count(table));
+    assertTrue(pitTable_GetStats(table)->aggregated == 1, "Expected 1 aggregated");
+
+    ccnxTlvDictionary_Release(&first);
+    ccnxTlvDictionary_Release(&second);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Receive_Refresh)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *first = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *second = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    pitTable_Receive(table, first, 1000);
+    PitVerdict verdict = pitTable_Receive(table, second, 2000);
+    assertTrue(verdict == PitVerdict_Refresh, "Expected PitVerdict_Refresh, got %d", verdict);
+
+    uint64_t expiryTime;
+    pitTable_NextExpiry(table, &expiryTime);
+    assertTrue(expiryTime == 2000, "Expected expiry 2000, got %" PRIu64, expiryTime);
+
+    // the refresh went down, so only the first Interest waits here
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+    size_t waiters = pitTable_Satisfy(table, contentObject);
+    assertTrue(waiters == 1, "Expected 1 waiter, got %zu", waiters);
+    assertTrue(pitTable_Count(table) == 0, "Expected empty table, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&contentObject);
+    ccnxTlvDictionary_Release(&first);
+    ccnxTlvDictionary_Release(&second);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Receive_DifferentKeyId)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *plain = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    CCNxName *name = ccnxName_CreateFromURI("lci:/apple/pie");
+    PARCBuffer *keyId = parcBuffer_WrapCString("publisher");
+    CCNxInterest *restricted = ccnxInterest_Create(name, CCNxInterestDefault_LifetimeMilliseconds, keyId, NULL);
+
+    pitTable_Receive(table, plain, 1000);
+    PitVerdict verdict = pitTable_Receive(table, restricted, 1000);
+    assertTrue(verdict == PitVerdict_Forward, "A different KeyId restriction is not a duplicate, got %d", verdict);
+    assertTrue(pitTable_Count(table) == 2, "Expected 2 entries, got %zu", pitTable_Count(table));
+
+    ccnxInterest_Release(&restricted);
+    parcBuffer_Release(&keyId);
+    ccnxName_Release(&name);
+    ccnxTlvDictionary_Release(&plain);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Receive_Full)
+{
+    PitTable *table = pitTable_Create(1);
+    CCNxTlvDictionary *first = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *second = testRtaMessages_CreateInterest("lci:/apple/tart", CCNxInterestDefault_LifetimeMilliseconds);
+
+    pitTable_Receive(table, first, 1000);
+    PitVerdict verdict = pitTable_Receive(table, second, 1000);
+    assertTrue(verdict == PitVerdict_Untracked, "Expected PitVerdict_Untracked, got %d", verdict);
+    assertTrue(pitTable_Count(table) == 1, "Expected 1 entry, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&first);
+    ccnxTlvDictionary_Release(&second);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Satisfy)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *first = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *second = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/pie", "hello");
+
+    pitTable_Receive(table, first, 1000);
+    pitTable_Receive(table, second, 1000);
+
+    size_t waiters = pitTable_Satisfy(table, contentObject);
+    assertTrue(waiters == 2, "Expected 2 waiters, got %zu", waiters);
+    assertTrue(pitTable_Count(table) == 0, "Expected empty table, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&contentObject);
+    ccnxTlvDictionary_Release(&first);
+    ccnxTlvDictionary_Release(&second);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_Satisfy_Unsolicited)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject("lci:/apple/tart", "hello");
+
+    pitTable_Receive(table, interest, 1000);
+
+    size_t waiters = pitTable_Satisfy(table, contentObject);
+    assertTrue(waiters == 0, "Expected 0 waiters, got %zu", waiters);
+    assertTrue(pitTable_Count(table) == 1, "Expected 1 entry, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&contentObject);
+    ccnxTlvDictionary_Release(&interest);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_PopExpired)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest("lci:/apple/pie", CCNxInterestDefault_LifetimeMilliseconds);
+
+    pitTable_Receive(table, interest, 1000);
+    pitTable_Receive(table, interest, 1000);
+
+    CCNxTlvDictionary *test = pitTable_PopExpired(table, 999, NULL);
+    assertNull(test, "Entry should not expire before its expiry time");
+
+    size_t waiters = 0;
+    test = pitTable_PopExpired(table, 1000, &waiters);
+    assertTrue(test == interest, "Expected the pending Interest");
+    assertTrue(waiters == 2, "Expected 2 waiters, got %zu", waiters);
+    assertTrue(pitTable_Count(table) == 0, "Expected empty table, got %zu", pitTable_Count(table));
+
+    ccnxTlvDictionary_Release(&test);
+    ccnxTlvDictionary_Release(&interest);
+    pitTable_Destroy(&table);
+}
+
+LONGBOW_TEST_CASE(Global, pitTable_NextExpiry_Order)
+{
+    PitTable *table = pitTable_Create(100);
+    CCNxTlvDictionary *a = testRtaMessages_CreateInterest("lci:/a", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *b = testRtaMessages_CreateInterest("lci:/b", CCNxInterestDefault_LifetimeMilliseconds);
+    CCNxTlvDictionary *c = testRtaMessages_CreateInterest("lci:/c", CCNxInterestDefault_LifetimeMilliseconds);
+
+    uint64_t expiryTime;
+    assertFalse(pitTable_NextExpiry(table, &expiryTime), "Empty table should have no expiry");
+
+    pitTable_Receive(table, a, 3000);
+    pitTable_Receive(table, b, 1000);
+    pitTable_Receive(table, c, 2000);
+
+    CCNxTlvDictionary *test = pitTable_PopExpired(table, 5000, NULL);
+    assertTrue(test == b, "Expected lci:/b to expire first");
+    ccnxTlvDictionary_Release(&test);
+
+    pitTable_NextExpiry(table, &expiryTime);
+    assertTrue(expiryTime == 2000, "Expected expiry 2000, got %" PRIu64, expiryTime);
+
+    ccnxTlvDictionary_Release(&a);
+    ccnxTlvDictionary_Release(&b);
+    ccnxTlvDictionary_Release(&c);
+    pitTable_Destroy(&table);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(pit_Table);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
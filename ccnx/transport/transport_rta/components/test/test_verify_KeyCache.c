@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../verify_KeyCache.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+static PARCBuffer *
+_createKeyIdForKey(PARCBuffer *derEncodedKey)
+{
+    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+    parcCryptoHasher_Init(hasher);
+    parcCryptoHasher_UpdateBuffer(hasher, derEncodedKey);
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+
+    PARCBuffer *keyId = parcBuffer_Copy(parcCryptoHash_GetDigest(hash));
+
+    parcCryptoHash_Release(&hash);
+    parcCryptoHasher_Release(&hasher);
+    return keyId;
+}
+
+LONGBOW_TEST_RUNNER(verify_KeyCache)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(verify_KeyCache)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(verify_KeyCache)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_Create);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_AddTrustedKeyId);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_AddTrustedKeyId_Twice);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_AddTrustedKey);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_LearnKey);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_LearnKey_WrongKey);
+    LONGBOW_RUN_TEST_CASE(Global, verifyKeyCache_LearnKey_Untrusted);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_Create)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    assertNotNull(cache, "Got null cache");
+    assertTrue(verifyKeyCache_Count(cache) == 0, "New cache should be empty");
+    assertFalse(verifyKeyCache_IsTrusted(cache, NULL), "A NULL KeyId is never trusted");
+    verifyKeyCache_Destroy(&cache);
+    assertNull(cache, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_AddTrustedKeyId)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *keyId = parcBuffer_WrapCString("alice");
+    PARCBuffer *other = parcBuffer_WrapCString("mallory");
+
+    verifyKeyCache_AddTrustedKeyId(cache, keyId);
+    assertTrue(verifyKeyCache_IsTrusted(cache, keyId), "KeyId should be trusted");
+    assertFalse(verifyKeyCache_IsTrusted(cache, other), "Other KeyId should not be trusted");
+    assertNull(verifyKeyCache_GetKey(cache, keyId), "Key should not be known yet");
+
+    parcBuffer_Release(&other);
+    parcBuffer_Release(&keyId);
+    verifyKeyCache_Destroy(&cache);
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_AddTrustedKeyId_Twice)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *keyId = parcBuffer_WrapCString("alice");
+
+    verifyKeyCache_AddTrustedKeyId(cache, keyId);
+    verifyKeyCache_AddTrustedKeyId(cache, keyId);
+    assertTrue(verifyKeyCache_Count(cache) == 1, "Expected 1 KeyId, got %zu", verifyKeyCache_Count(cache));
+
+    parcBuffer_Release(&keyId);
+    verifyKeyCache_Destroy(&cache);
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_AddTrustedKey)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *derEncodedKey = parcBuffer_WrapCString("not really a DER key");
+    PARCBuffer *keyIdBuffer = _createKeyIdForKey(derEncodedKey);
+    PARCKeyId *keyId = parcKeyId_Create(keyIdBuffer);
+    PARCKey *key = parcKey_CreateFromDerEncodedPublicKey(keyId, PARCSigningAlgorithm_RSA, derEncodedKey);
+
+    verifyKeyCache_AddTrustedKey(cache, key);
+    assertTrue(verifyKeyCache_IsTrusted(cache, keyIdBuffer), "KeyId of the key should be trusted");
+    assertTrue(verifyKeyCache_GetKey(cache, keyIdBuffer) == key, "Expected the same key back");
+
+    parcKey_Release(&key);
+    parcKeyId_Release(&keyId);
+    parcBuffer_Release(&keyIdBuffer);
+    parcBuffer_Release(&derEncodedKey);
+    verifyKeyCache_Destroy(&cache);
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_LearnKey)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *derEncodedKey = parcBuffer_WrapCString("not really a DER key");
+    PARCBuffer *keyId = _createKeyIdForKey(derEncodedKey);
+
+    verifyKeyCache_AddTrustedKeyId(cache, keyId);
+    PARCKey *key = verifyKeyCache_LearnKey(cache, keyId, PARCSigningAlgorithm_RSA, derEncodedKey);
+    assertNotNull(key, "Key should have been learned");
+    assertTrue(verifyKeyCache_GetKey(cache, keyId) == key, "Learned key should be cached");
+
+    // learning it again returns the cached key
+    PARCKey *again = verifyKeyCache_LearnKey(cache, keyId, PARCSigningAlgorithm_RSA, derEncodedKey);
+    assertTrue(again == key, "Expected the cached key");
+
+    parcBuffer_Release(&keyId);
+    parcBuffer_Release(&derEncodedKey);
+    verifyKeyCache_Destroy(&cache);
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_LearnKey_WrongKey)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *derEncodedKey = parcBuffer_WrapCString("not really a DER key");
+    PARCBuffer *impostor = parcBuffer_WrapCString("an impostor key");
+    PARCBuffer *keyId = _createKeyIdForKey(derEncodedKey);
+
+    verifyKeyCache_AddTrustedKeyId(cache, keyId);
+    PARCKey *key = verifyKeyCache_LearnKey(cache, keyId, PARCSigningAlgorithm_RSA, impostor);
+    assertNull(key, "A key that does not hash to the KeyId must not be learned");
+    assertNull(verifyKeyCache_GetKey(cache, keyId), "Nothing should be cached");
+
+    parcBuffer_Release(&keyId);
+    parcBuffer_Release(&impostor);
+    parcBuffer_Release(&derEncodedKey);
+    verifyKeyCache_Destroy(&cache);
+}
+
+LONGBOW_TEST_CASE(Global, verifyKeyCache_LearnKey_Untrusted)
+{
+    VerifyKeyCache *cache = verifyKeyCache_Create();
+    PARCBuffer *derEncodedKey = parcBuffer_WrapCString("not really a DER key");
+    PARCBuffer *keyId = _createKeyIdForKey(derEncodedKey);
+
+    PARCKey *key = verifyKeyCache_LearnKey(cache, keyId, PARCSigningAlgorithm_RSA, derEncodedKey);
+    assertNull(key, "A key for an untrusted KeyId must not be learned");
+
+    parcBuffer_Release(&keyId);
+    parcBuffer_Release(&derEncodedKey);
+    verifyKeyCache_Destroy(&cache);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(verify_KeyCache);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Builds the messages the component tests put through a stack or a table.
+ *
+ * The Content Objects are encoded and decoded again, so they carry a wire format
+ * like they would coming up the stack from the codec.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_Interest.h>
+#include <ccnx/transport/common/transport_MetaMessage.h>
+
+CCNxTlvDictionary *
+testRtaMessages_CreateContentObject(const char *uri, const char *payloadString)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    PARCBuffer *payload = parcBuffer_WrapCString((char *) payloadString);
+    CCNxContentObject *contentObject = ccnxContentObject_CreateWithDataPayload(name, payload);
+
+    PARCBuffer *wireFormat = ccnxMetaMessage_CreateWireFormatBuffer(contentObject, NULL);
+    CCNxTlvDictionary *decoded = ccnxMetaMessage_CreateFromWireFormatBuffer(wireFormat);
+    assertNotNull(decoded, "Could not decode wire format of %s", uri);
+
+    parcBuffer_Release(&wireFormat);
+    ccnxContentObject_Release(&contentObject);
+    parcBuffer_Release(&payload);
+    ccnxName_Release(&name);
+    return decoded;
+}
+
+CCNxTlvDictionary *
+testRtaMessages_CreateInterest(const char *uri, uint32_t lifetime)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    CCNxInterest *interest = ccnxInterest_Create(name, lifetime, NULL, NULL);
+    ccnxName_Release(&name);
+    return interest;
+}
@@ -35,6 +35,9 @@
 #include <ccnx/transport/transport_rta/core/rta_Framework.h>
 #include <ccnx/transport/transport_rta/core/rta_Framework_Commands.c>
 #include <ccnx/transport/transport_rta/core/rta_Framework_NonThreaded.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+
+#include "testrig_Messages.c"
 
 #ifndef MAXPATH
 #define MAXPATH 1024
@@ -110,3 +113,55 @@ mockFramework_Destroy(MockFramework **mockPtr)
 
     parcMemory_Deallocate((void **) &mock);
 }
+
+TransportMessage *
+mockFramework_CreateContentObjectMessage(MockFramework *mock, const char *uri)
+{
+    CCNxTlvDictionary *contentObject = testRtaMessages_CreateContentObject(uri, "hello");
+    TransportMessage *tm = transportMessage_CreateFromDictionary(contentObject);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(mock->connection), rtaConnection_FreeFunc);
+    ccnxTlvDictionary_Release(&contentObject);
+    return tm;
+}
+
+TransportMessage *
+mockFramework_CreateInterestMessage(MockFramework *mock, const char *uri, uint32_t lifetime)
+{
+    CCNxTlvDictionary *interest = testRtaMessages_CreateInterest(uri, lifetime);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(interest);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(mock->connection), rtaConnection_FreeFunc);
+    ccnxTlvDictionary_Release(&interest);
+    return tm;
+}
+
+/**
+ * For a stack { ..., TESTING_UPPER, component, TESTING_LOWER }, puts the message in at the
+ * top.  Returns what comes out the bottom in *bottomPtr and what comes back out the top
+ * in *topPtr.
+ */
+void
+mockFramework_SendDown(MockFramework *mock, TransportMessage *tm, TransportMessage **bottomPtr, TransportMessage **topPtr)
+{
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *bottom = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_LOWER, RTA_UP);
+
+    rtaComponent_PutMessage(in, tm);
+    rtaFramework_NonThreadedStepCount(mock->framework, 10);
+    *bottomPtr = rtaComponent_GetMessage(bottom);
+    *topPtr = rtaComponent_GetMessage(in);
+}
+
+/**
+ * For a stack { ..., TESTING_UPPER, component, TESTING_LOWER }, puts the message in at the
+ * bottom and returns the first message that comes out the top.
+ */
+TransportMessage *
+mockFramework_SendUp(MockFramework *mock, TransportMessage *tm)
+{
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_UPPER, RTA_DOWN);
+    PARCEventQueue *in = rtaProtocolStack_GetPutQueue(mock->stack, TESTING_LOWER, RTA_UP);
+
+    rtaComponent_PutMessage(in, tm);
+    rtaFramework_NonThreadedStepCount(mock->framework, 10);
+    return rtaComponent_GetMessage(out);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/security/parc_CryptoHasher.h>
+#include <parc/security/parc_KeyId.h>
+
+#include "verify_KeyCache.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+typedef struct verify_key_entry {
+    PARCBuffer *keyId;
+
+    // NULL until the key is given or learned
+    PARCKey *key;
+
+    LIST_ENTRY(verify_key_entry) list;
+} VerifyKeyEntry;
+
+/*
+ * A connection trusts a handful of publishers, so a list is as fast as anything else.
+ */
+struct verify_key_cache {
+    size_t count;
+    LIST_HEAD(, verify_key_entry) head;
+};
+
+// ==================
+
+static VerifyKeyEntry *
+_verifyKeyCache_Find(const VerifyKeyCache *cache, const PARCBuffer *keyId)
+{
+    if (keyId == NULL) {
+        return NULL;
+    }
+
+    VerifyKeyEntry *entry;
+    LIST_FOREACH(entry, &cache->head, list)
+    {
+        if (parcBuffer_Equals(entry->keyId, keyId)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static VerifyKeyEntry *
+_verifyKeyCache_Add(VerifyKeyCache *cache, const PARCBuffer *keyId)
+{
+    VerifyKeyEntry *entry = _verifyKeyCache_Find(cache, keyId);
+    if (entry == NULL) {
+        entry = parcMemory_AllocateAndClear(sizeof(VerifyKeyEntry));
+        assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(VerifyKeyEntry));
+        entry->keyId = parcBuffer_Copy(keyId);
+        LIST_INSERT_HEAD(&cache->head, entry, list);
+        cache->count++;
+    }
+    return entry;
+}
+
+static bool
+_verifyKeyCache_KeyHashesToKeyId(PARCBuffer *derEncodedKey, const PARCBuffer *keyId)
+{
+    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARC_HASH_SHA256);
+    parcCryptoHasher_Init(hasher);
+    parcCryptoHasher_UpdateBuffer(hasher, derEncodedKey);
+    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
+
+    bool result = parcBuffer_Equals(parcCryptoHash_GetDigest(hash), keyId);
+
+    parcCryptoHash_Release(&hash);
+    parcCryptoHasher_Release(&hasher);
+    return result;
+}
+
+// ==================
+
+VerifyKeyCache *
+verifyKeyCache_Create(void)
+{
+    VerifyKeyCache *cache = parcMemory_AllocateAndClear(sizeof(VerifyKeyCache));
+    assertNotNull(cache, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(VerifyKeyCache));
+    LIST_INIT(&cache->head);
+    return cache;
+}
+
+void
+verifyKeyCache_Destroy(VerifyKeyCache **cachePtr)
+{
+    assertNotNull(cachePtr, "Parameter cachePtr must be non-null");
+    VerifyKeyCache *cache = *cachePtr;
+    assertNotNull(cache, "Parameter cachePtr must dereference to non-null");
+
+    VerifyKeyEntry *entry;
+    while ((entry = LIST_FIRST(&cache->head)) != NULL) {
+        LIST_REMOVE(entry, list);
+        if (entry->key) {
+            parcKey_Release(&entry->key);
+        }
+        parcBuffer_Release(&entry->keyId);
+        parcMemory_Deallocate((void **) &entry);
+    }
+
+    parcMemory_Deallocate((void **) &cache);
+    *cachePtr = NULL;
+}
+
+void
+verifyKeyCache_AddTrustedKeyId(VerifyKeyCache *cache, const PARCBuffer *keyId)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+    assertNotNull(keyId, "Parameter keyId must be non-null");
+    _verifyKeyCache_Add(cache, keyId);
+}
+
+void
+verifyKeyCache_AddTrustedKey(VerifyKeyCache *cache, PARCKey *key)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+    assertNotNull(key, "Parameter key must be non-null");
+
+    VerifyKeyEntry *entry = _verifyKeyCache_Add(cache, parcKeyId_GetKeyId(parcKey_GetKeyId(key)));
+    if (entry->key) {
+        parcKey_Release(&entry->key);
+    }
+    entry->key = parcKey_Acquire(key);
+}
+
+bool
+verifyKeyCache_IsTrusted(const VerifyKeyCache *cache, const PARCBuffer *keyId)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+    return _verifyKeyCache_Find(cache, keyId) != NULL;
+}
+
+PARCKey *
+verifyKeyCache_GetKey(const VerifyKeyCache *cache, const PARCBuffer *keyId)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+    VerifyKeyEntry *entry = _verifyKeyCache_Find(cache, keyId);
+    return entry == NULL ? NULL : entry->key;
+}
+
+PARCKey *
+verifyKeyCache_LearnKey(VerifyKeyCache *cache, const PARCBuffer *keyId,
+                        PARCSigningAlgorithm signingAlgorithm, PARCBuffer *derEncodedKey)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+
+    VerifyKeyEntry *entry = _verifyKeyCache_Find(cache, keyId);
+    if (entry == NULL || derEncodedKey == NULL) {
+        return NULL;
+    }
+
+    if (entry->key == NULL) {
+        if (!_verifyKeyCache_KeyHashesToKeyId(derEncodedKey, keyId)) {
+            return NULL;
+        }
+
+        PARCKeyId *parcKeyId = parcKeyId_Create(entry->keyId);
+        entry->key = parcKey_CreateFromDerEncodedPublicKey(parcKeyId, signingAlgorithm, derEncodedKey);
+        parcKeyId_Release(&parcKeyId);
+
+        if (DEBUG_OUTPUT) {
+            char *hex = parcBuffer_ToHexString(entry->keyId);
+            printf("%s cache %p learned key for keyid %s\n", __func__, (void *) cache, hex);
+            parcMemory_Deallocate((void **) &hex);
+        }
+    }
+
+    return entry->key;
+}
+
+size_t
+verifyKeyCache_Count(const VerifyKeyCache *cache)
+{
+    assertNotNull(cache, "Parameter cache must be non-null");
+    return cache->count;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file verify_KeyCache.h
+ * @brief The set of keys a connection trusts, and the public keys learned for them
+ *
+ * A connection is configured with a list of trusted KeyIds.  Signed Content Objects whose
+ * KeyId is not in the list are not trusted, no matter what their signature says.
+ *
+ * The public key for a trusted KeyId may be given up front or learned from the first
+ * Content Object that embeds it in its KeyLocator.  A learned key is only accepted if
+ * its SHA-256 hash equals the trusted KeyId.  Once a key is in the cache, objects that only
+ * carry the KeyId can be verified without parsing another key.
+ *
+ * The cache is not thread safe.  It is meant to be used only from the RTA framework thread.
+ * The `PARCKey` instances it returns are immutable and may be acquired and handed to a worker.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_verify_KeyCache_h
+#define Libccnx_verify_KeyCache_h
+
+#include <stdbool.h>
+#include <parc/algol/parc_Buffer.h>
+#include <parc/security/parc_Key.h>
+
+struct verify_key_cache;
+typedef struct verify_key_cache VerifyKeyCache;
+
+/**
+ * Create an empty key cache, which trusts nothing
+ *
+ * @return non-null An allocated cache, destroy with `verifyKeyCache_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     VerifyKeyCache *cache = verifyKeyCache_Create();
+ *     verifyKeyCache_AddTrustedKeyId(cache, keyId);
+ *     verifyKeyCache_Destroy(&cache);
+ * }
+ * @endcode
+ */
+VerifyKeyCache *verifyKeyCache_Create(void);
+
+/**
+ * Destroys the cache and releases every key
+ *
+ * @param [in,out] cachePtr Pointer to the cache, will be NULL'd
+ */
+void verifyKeyCache_Destroy(VerifyKeyCache **cachePtr);
+
+/**
+ * Trust a KeyId whose public key is not known yet
+ *
+ * Adding a KeyId that is already trusted does nothing.
+ *
+ * @param [in] cache The key cache
+ * @param [in] keyId The SHA-256 hash of the publisher's DER encoded public key
+ */
+void verifyKeyCache_AddTrustedKeyId(VerifyKeyCache *cache, const PARCBuffer *keyId);
+
+/**
+ * Trust a public key.  Its KeyId becomes trusted, and the key is cached.
+ *
+ * @param [in] cache The key cache
+ * @param [in] key The publisher's public key, the cache acquires a reference
+ */
+void verifyKeyCache_AddTrustedKey(VerifyKeyCache *cache, PARCKey *key);
+
+/**
+ * Determine if a KeyId is trusted
+ *
+ * @return true The KeyId is in the trusted set
+ * @return false The KeyId is NULL or not trusted
+ */
+bool verifyKeyCache_IsTrusted(const VerifyKeyCache *cache, const PARCBuffer *keyId);
+
+/**
+ * Returns the cached public key for a trusted KeyId
+ *
+ * @param [in] cache The key cache
+ * @param [in] keyId The KeyId of a Content Object
+ *
+ * @return non-null The key, acquire it if you keep it
+ * @return null The KeyId is not trusted or its key has not been learned yet
+ */
+PARCKey *verifyKeyCache_GetKey(const VerifyKeyCache *cache, const PARCBuffer *keyId);
+
+/**
+ * Learn the public key of a trusted KeyId from a Content Object's KeyLocator
+ *
+ * @param [in] cache The key cache
+ * @param [in] keyId The KeyId of the Content Object
+ * @param [in] signingAlgorithm The signing algorithm of the Content Object
+ * @param [in] derEncodedKey The DER encoded public key embedded in the Content Object
+ *
+ * @return non-null The cached key for `keyId`, acquire it if you keep it
+ * @return null The KeyId is not trusted or the key does not hash to the KeyId
+ */
+PARCKey *verifyKeyCache_LearnKey(VerifyKeyCache *cache, const PARCBuffer *keyId,
+                                 PARCSigningAlgorithm signingAlgorithm, PARCBuffer *derEncodedKey);
+
+/**
+ * The number of trusted KeyIds
+ */
+size_t verifyKeyCache_Count(const VerifyKeyCache *cache);
+#endif // Libccnx_verify_KeyCache_h
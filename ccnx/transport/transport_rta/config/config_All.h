@@ -41,6 +41,8 @@
 #include <ccnx/transport/common/ccnx_TransportConfig.h>
 
 #include <ccnx/transport/transport_rta/config/config_ApiConnector.h>
+#include <ccnx/transport/transport_rta/config/config_Cache.h>
+#include <ccnx/transport/transport_rta/config/config_Capture.h>
 
 #include <ccnx/transport/transport_rta/config/config_Codec_Tlv.h>
 #include <ccnx/transport/transport_rta/config/config_CryptoCache.h>
@@ -50,6 +52,7 @@
 #include <ccnx/transport/transport_rta/config/config_Forwarder_Metis.h>
 
 #include <ccnx/transport/transport_rta/config/config_InMemoryVerifier.h>
+#include <ccnx/transport/transport_rta/config/config_Pit.h>
 
 #include <ccnx/transport/transport_rta/config/config_ProtocolStack.h>
 #include <ccnx/transport/transport_rta/config/config_PublicKeySignerPkcs12Store.h>
@@ -58,4 +61,5 @@
 #include <ccnx/transport/transport_rta/config/config_SymmetricKeySignerFileStore.h>
 
 #include <ccnx/transport/transport_rta/config/config_TestingComponent.h>
+#include <ccnx/transport/transport_rta/config/config_VerifyEnumerated.h>
 #endif
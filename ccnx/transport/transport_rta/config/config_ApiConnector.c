@@ -30,11 +30,24 @@
  */
 #include <config.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include <LongBow/runtime.h>
 
 #include "config_ApiConnector.h"
 
 #include <ccnx/transport/transport_rta/core/components.h>
 
+static const char param_QUEUE_BYTES[] = "QUEUE_BYTES";         // integer, payload bytes held for the API
+static const char param_QUEUE_MESSAGES[] = "QUEUE_MESSAGES";   // integer, messages held for the API
+static const char param_WEIGHT[] = "WEIGHT";                   // integer, share of the stack's queues
+static const char param_STATUS_WINDOW[] = "STATUS_WINDOW";     // integer, msec to coalesce status notifications
+static const char param_STATUS_BINARY[] = "STATUS_BINARY";     // integer, 1 for binary status notifications
+static const size_t default_queue_bytes = 4 * 1024 * 1024;
+static const size_t default_queue_messages = 4096;
+static const unsigned default_weight = 1;
+
 /**
  * Generates:
  *
@@ -50,16 +63,173 @@ apiConnector_ProtocolStackConfig(CCNxStackConfig *stackConfig)
     return result;
 }
 
+/**
+ * Generates:
+ *
+ * { "API_CONNECTOR" : { } }
+ */
 CCNxConnectionConfig *
 apiConnector_ConnectionConfig(CCNxConnectionConfig *connectionConfig)
 {
-    PARCJSONValue *value = parcJSONValue_CreateFromNULL();
+    PARCJSON *json = parcJSON_Create();
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
     CCNxConnectionConfig *result = ccnxConnectionConfig_Add(connectionConfig, apiConnector_GetName(), value);
     parcJSONValue_Release(&value);
 
     return result;
 }
 
+/**
+ * Generates:
+ *
+ * { "API_CONNECTOR" : { "QUEUE_BYTES" : maxBytes, "QUEUE_MESSAGES" : maxMessages } }
+ */
+CCNxConnectionConfig *
+apiConnector_SetQueueBudget(CCNxConnectionConfig *connectionConfig, size_t maxBytes, size_t maxMessages)
+{
+    PARCJSONValue *apiValue = parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connectionConfig), apiConnector_GetName());
+    assertTrue(apiValue != NULL && parcJSONValue_IsJSON(apiValue),
+               "Call apiConnector_ConnectionConfig() before setting %s", param_QUEUE_BYTES);
+    assertTrue(maxBytes > 0, "Parameter maxBytes must be positive");
+    assertTrue(maxMessages > 0, "Parameter maxMessages must be positive");
+
+    PARCJSON *apiJson = parcJSONValue_GetJSON(apiValue);
+    assertNull(parcJSON_GetValueByName(apiJson, param_QUEUE_BYTES), "%s is already set", param_QUEUE_BYTES);
+
+    parcJSON_AddInteger(apiJson, param_QUEUE_BYTES, (int64_t) maxBytes);
+    parcJSON_AddInteger(apiJson, param_QUEUE_MESSAGES, (int64_t) maxMessages);
+    return connectionConfig;
+}
+
+/**
+ * Generates:
+ *
+ * { "API_CONNECTOR" : { "WEIGHT" : weight } }
+ */
+CCNxConnectionConfig *
+apiConnector_SetSchedulingWeight(CCNxConnectionConfig *connectionConfig, unsigned weight)
+{
+    PARCJSONValue *apiValue = parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connectionConfig), apiConnector_GetName());
+    assertTrue(apiValue != NULL && parcJSONValue_IsJSON(apiValue),
+               "Call apiConnector_ConnectionConfig() before setting %s", param_WEIGHT);
+    assertTrue(weight > 0, "Parameter weight must be positive");
+
+    PARCJSON *apiJson = parcJSONValue_GetJSON(apiValue);
+    assertNull(parcJSON_GetValueByName(apiJson, param_WEIGHT), "%s is already set", param_WEIGHT);
+
+    parcJSON_AddInteger(apiJson, param_WEIGHT, weight);
+    return connectionConfig;
+}
+
+/**
+ * Generates:
+ *
+ * { "API_CONNECTOR" : { "STATUS_WINDOW" : milliseconds } }
+ */
+CCNxConnectionConfig *
+apiConnector_SetStatusWindow(CCNxConnectionConfig *connectionConfig, unsigned milliseconds)
+{
+    PARCJSONValue *apiValue = parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connectionConfig), apiConnector_GetName());
+    assertTrue(apiValue != NULL && parcJSONValue_IsJSON(apiValue),
+               "Call apiConnector_ConnectionConfig() before setting %s", param_STATUS_WINDOW);
+    assertTrue(milliseconds > 0, "Parameter milliseconds must be positive");
+
+    PARCJSON *apiJson = parcJSONValue_GetJSON(apiValue);
+    assertNull(parcJSON_GetValueByName(apiJson, param_STATUS_WINDOW), "%s is already set", param_STATUS_WINDOW);
+
+    parcJSON_AddInteger(apiJson, param_STATUS_WINDOW, milliseconds);
+    return connectionConfig;
+}
+
+/**
+ * Generates:
+ *
+ * { "API_CONNECTOR" : { "STATUS_BINARY" : 1 } }
+ */
+CCNxConnectionConfig *
+apiConnector_SetBinaryStatus(CCNxConnectionConfig *connectionConfig)
+{
+    PARCJSONValue *apiValue = parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connectionConfig), apiConnector_GetName());
+    assertTrue(apiValue != NULL && parcJSONValue_IsJSON(apiValue),
+               "Call apiConnector_ConnectionConfig() before setting %s", param_STATUS_BINARY);
+
+    PARCJSON *apiJson = parcJSONValue_GetJSON(apiValue);
+    assertNull(parcJSON_GetValueByName(apiJson, param_STATUS_BINARY), "%s is already set", param_STATUS_BINARY);
+
+    parcJSON_AddInteger(apiJson, param_STATUS_BINARY, 1);
+    return connectionConfig;
+}
+
+/**
+ * The positive integer under our name, or defaultValue if it is missing or not positive
+ */
+static int64_t
+_getInteger(PARCJSON *connectionJson, const char *key, int64_t defaultValue)
+{
+    if (connectionJson == NULL) {
+        return defaultValue;
+    }
+
+    // Older configurations put a JSON null under our name
+    PARCJSONValue *apiValue = parcJSON_GetValueByName(connectionJson, apiConnector_GetName());
+    if (apiValue != NULL && parcJSONValue_IsJSON(apiValue)) {
+        PARCJSONValue *value = parcJSON_GetValueByName(parcJSONValue_GetJSON(apiValue), key);
+        if (value != NULL && parcJSONValue_IsNumber(value) && parcJSONValue_GetInteger(value) > 0) {
+            return parcJSONValue_GetInteger(value);
+        }
+    }
+    return defaultValue;
+}
+
+static size_t
+_getParameter(PARCJSON *connectionJson, const char *key, size_t defaultValue)
+{
+    int64_t value = _getInteger(connectionJson, key, (int64_t) defaultValue);
+    return ((uint64_t) value > SIZE_MAX) ? SIZE_MAX : (size_t) value;
+}
+
+/**
+ * As _getParameter, clamped to UINT_MAX so a large value does not wrap to a small one
+ */
+static unsigned
+_getUnsignedParameter(PARCJSON *connectionJson, const char *key, unsigned defaultValue)
+{
+    int64_t value = _getInteger(connectionJson, key, defaultValue);
+    return ((uint64_t) value > UINT_MAX) ? UINT_MAX : (unsigned) value;
+}
+
+size_t
+apiConnector_GetQueueBytesFromConfig(PARCJSON *connectionJson)
+{
+    return _getParameter(connectionJson, param_QUEUE_BYTES, default_queue_bytes);
+}
+
+size_t
+apiConnector_GetQueueMessagesFromConfig(PARCJSON *connectionJson)
+{
+    return _getParameter(connectionJson, param_QUEUE_MESSAGES, default_queue_messages);
+}
+
+unsigned
+apiConnector_GetSchedulingWeightFromConfig(PARCJSON *connectionJson)
+{
+    return _getUnsignedParameter(connectionJson, param_WEIGHT, default_weight);
+}
+
+unsigned
+apiConnector_GetStatusWindowFromConfig(PARCJSON *connectionJson)
+{
+    return _getUnsignedParameter(connectionJson, param_STATUS_WINDOW, 0);
+}
+
+bool
+apiConnector_GetBinaryStatusFromConfig(PARCJSON *connectionJson)
+{
+    return _getInteger(connectionJson, param_STATUS_BINARY, 0) != 0;
+}
+
 const char *
 apiConnector_GetName(void)
 {
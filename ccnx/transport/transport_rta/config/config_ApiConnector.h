@@ -54,6 +54,7 @@
 #ifndef Libccnx_config_ApiConnector_h
 #define Libccnx_config_ApiConnector_h
 
+#include <stdbool.h>
 #include <ccnx/transport/common/ccnx_TransportConfig.h>
 
 /**
@@ -89,6 +90,151 @@ CCNxStackConfig *apiConnector_ProtocolStackConfig(CCNxStackConfig *stackConfig);
  */
 CCNxConnectionConfig *apiConnector_ConnectionConfig(CCNxConnectionConfig *config);
 
+/**
+ * Sets the upward queue budget of a connection
+ *
+ * The API connector holds messages for the application until it reads them.  It
+ * accounts the payload bytes of each held message and blocks the connection in the UP
+ * direction when either budget is exceeded.  It unblocks when the application has read
+ * the backlog down to half of both budgets.
+ *
+ * Must be called after `apiConnector_ConnectionConfig()`.  If not called, the connector uses
+ * 4 MB and 4096 messages.
+ *
+ *  { "API_CONNECTOR" : { "QUEUE_BYTES" : maxBytes, "QUEUE_MESSAGES" : maxMessages } }
+ *
+ * @param [in] config A pointer to a valid CCNxConnectionConfig instance.
+ * @param [in] maxBytes The payload bytes held before blocking (positive)
+ * @param [in] maxMessages The messages held before blocking (positive)
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      apiConnector_SetQueueBudget(connConfig, 256 * 1024, 1024);
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *apiConnector_SetQueueBudget(CCNxConnectionConfig *config, size_t maxBytes, size_t maxMessages);
+
+/**
+ * Returns the upward queue byte budget from a connection configuration
+ *
+ * @param [in] connectionJson The connection's JSON parameters
+ *
+ * @return positive The configured byte budget, or the default
+ */
+size_t apiConnector_GetQueueBytesFromConfig(PARCJSON *connectionJson);
+
+/**
+ * Returns the upward queue message budget from a connection configuration
+ *
+ * @param [in] connectionJson The connection's JSON parameters
+ *
+ * @return positive The configured message budget, or the default
+ */
+size_t apiConnector_GetQueueMessagesFromConfig(PARCJSON *connectionJson);
+
+/**
+ * Sets the connection's share of a shared protocol stack
+ *
+ * Connections on the same protocol stack share the queues between its components.  When
+ * the queues back up, each connection gets messages through in proportion to its weight.
+ * If not called, the weight is 1.
+ *
+ *  { "API_CONNECTOR" : { "WEIGHT" : weight } }
+ *
+ * @param [in] config A pointer to a valid CCNxConnectionConfig instance.
+ * @param [in] weight The connection's weight (positive)
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      apiConnector_SetSchedulingWeight(connConfig, 4);
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *apiConnector_SetSchedulingWeight(CCNxConnectionConfig *config, unsigned weight);
+
+/**
+ * Returns the scheduling weight from a connection configuration
+ *
+ * @param [in] connectionJson The connection's JSON parameters
+ *
+ * @return positive The configured weight clamped to UINT_MAX, or 1
+ */
+unsigned apiConnector_GetSchedulingWeightFromConfig(PARCJSON *connectionJson);
+
+/**
+ * Coalesces the connection's status notifications
+ *
+ * The first status with a given code is sent at once.  Statuses with the same code during the
+ * next `milliseconds` are counted and sent as one notification when the window closes, see
+ * rta_StatusCoalescer.h and `notifyStatus_GetCount()`.  If not called, every status is sent.
+ *
+ *  { "API_CONNECTOR" : { "STATUS_WINDOW" : milliseconds } }
+ *
+ * @param [in] config A pointer to a valid CCNxConnectionConfig instance.
+ * @param [in] milliseconds The window (positive)
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      apiConnector_SetStatusWindow(connConfig, 250);
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *apiConnector_SetStatusWindow(CCNxConnectionConfig *config, unsigned milliseconds);
+
+/**
+ * Sends the connection's status notifications in binary instead of JSON
+ *
+ * The notification is made with `ccnxControlFacade_CreateBinaryNotification()`.
+ * `ccnxControl_GetNotifyStatus()` reads either form.
+ *
+ *  { "API_CONNECTOR" : { "STATUS_BINARY" : 1 } }
+ *
+ * @param [in] config A pointer to a valid CCNxConnectionConfig instance.
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      apiConnector_SetBinaryStatus(connConfig);
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *apiConnector_SetBinaryStatus(CCNxConnectionConfig *config);
+
+/**
+ * Returns the status window from a connection configuration
+ *
+ * @param [in] connectionJson The connection's JSON parameters
+ *
+ * @return The window in milliseconds, or 0 to send every status
+ */
+unsigned apiConnector_GetStatusWindowFromConfig(PARCJSON *connectionJson);
+
+/**
+ * Returns if status notifications are binary
+ *
+ * @param [in] connectionJson The connection's JSON parameters
+ *
+ * @return true Send binary notifications
+ * @return false Send JSON notifications
+ */
+bool apiConnector_GetBinaryStatusFromConfig(PARCJSON *connectionJson);
+
 /**
  * Returns the text string for this component
  *
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <LongBow/runtime.h>
+
+#include <stdio.h>
+#include "config_Cache.h"
+#include <ccnx/transport/transport_rta/core/components.h>
+
+static const char param_MAX_OBJECTS[] = "MAX_OBJECTS";      // integer, e.g. 10000
+static const char param_MAX_BYTES[] = "MAX_BYTES";          // integer, e.g. 67108864
+
+static const size_t default_max_objects = 4096;
+static const size_t default_max_bytes = 16 * 1024 * 1024;
+
+/**
+ * Generates:
+ *
+ * { "CACHE" : { "MAX_OBJECTS" : maxObjects, "MAX_BYTES" : maxBytes } }
+ */
+CCNxStackConfig *
+localCache_ProtocolStackConfig(CCNxStackConfig *stackConfig, size_t maxObjects, size_t maxBytes)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, param_MAX_OBJECTS, maxObjects);
+    parcJSON_AddInteger(json, param_MAX_BYTES, maxBytes);
+
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
+    CCNxStackConfig *result = ccnxStackConfig_Add(stackConfig, localCache_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+/**
+ * Generates:
+ *
+ * { "CACHE" : { } }
+ */
+CCNxConnectionConfig *
+localCache_ConnectionConfig(CCNxConnectionConfig *connectionConfig)
+{
+    PARCJSONValue *value = parcJSONValue_CreateFromNULL();
+    CCNxConnectionConfig *result = ccnxConnectionConfig_Add(connectionConfig, localCache_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+const char *
+localCache_GetName(void)
+{
+    return RtaComponentNames[CACHE];
+}
+
+static size_t
+_localCache_GetSizeFromConfig(PARCJSON *stackJson, const char *key, size_t defaultValue)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(stackJson, localCache_GetName());
+    if (value != NULL && parcJSONValue_IsJSON(value)) {
+        PARCJSON *cacheJson = parcJSONValue_GetJSON(value);
+        value = parcJSON_GetValueByName(cacheJson, key);
+        if (value != NULL && parcJSONValue_IsNumber(value)) {
+            return (size_t) parcJSONValue_GetInteger(value);
+        }
+    }
+    return defaultValue;
+}
+
+size_t
+localCache_GetMaxObjectsFromConfig(PARCJSON *stackJson)
+{
+    return _localCache_GetSizeFromConfig(stackJson, param_MAX_OBJECTS, default_max_objects);
+}
+
+size_t
+localCache_GetMaxBytesFromConfig(PARCJSON *stackJson)
+{
+    return _localCache_GetSizeFromConfig(stackJson, param_MAX_BYTES, default_max_bytes);
+}
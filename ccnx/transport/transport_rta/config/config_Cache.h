@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file config_Cache.h
+ * @brief Generates stack and connection configuration information
+ *
+ * Each component in the protocol stack must have a configuration element.
+ * This module generates the configuration elements for the in-stack content store (CACHE).
+ *
+ * The cache is optional.  It sits above the codec so it sees decoded Content Objects
+ * going up the stack and decoded Interests coming down the stack.  The store is
+ * stack-wide and bounded by both an object count and the total wire format bytes held.
+ *
+ * @code
+ * {
+ *      // Configure a stack with {APIConnector,Cache,TLVCodec,MetisConnector}
+ *
+ *      stackConfig = ccnxStackConfig_Create();
+ *      connConfig = ccnxConnectionConfig_Create();
+ *
+ *      apiConnector_ProtocolStackConfig(stackConfig);
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      localCache_ProtocolStackConfig(stackConfig, 10000, 64 * 1024 * 1024);
+ *      localCache_ConnectionConfig(connConfig);
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_ConnectionConfig(connConfig);
+ *      metisForwarder_ProtocolStackConfig(stackConfig);
+ *      metisForwarder_ConnectionConfig(connConfig, metisForwarder_GetDefaultPort());
+ *
+ *      protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), localCache_GetName(),
+ *                                         tlvCodec_GetName(), metisForwarder_GetName(), NULL);
+ *
+ *      CCNxTransportConfig *config = ccnxTransportConfig_Create(stackConfig, connConfig);
+ * }
+ * @endcode
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#ifndef Libccnx_config_Cache_h
+#define Libccnx_config_Cache_h
+
+#include <ccnx/transport/common/ccnx_TransportConfig.h>
+
+/**
+ * Generates the configuration settings included in the Protocol Stack configuration
+ *
+ * Adds configuration elements to the Protocol Stack configuration
+ *
+ * { "CACHE" : { "MAX_OBJECTS" : maxObjects, "MAX_BYTES" : maxBytes } }
+ *
+ * @param [in] stackConfig The protocl stack configuration to update
+ * @param [in] maxObjects The maximum number of Content Objects held by the store
+ * @param [in] maxBytes The maximum number of wire format bytes held by the store
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      localCache_ProtocolStackConfig(stackConfig, 10000, 64 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *localCache_ProtocolStackConfig(CCNxStackConfig *stackConfig, size_t maxObjects, size_t maxBytes);
+
+/**
+ * Generates the configuration settings included in the Connection configuration
+ *
+ * Adds configuration elements to the `CCNxConnectionConfig`
+ *
+ * { "CACHE" : { } }
+ *
+ * @param [in] config The CCNxConnectionConfig instance
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxConnectionConfig *localCache_ConnectionConfig(CCNxConnectionConfig *config);
+
+/**
+ * Returns the text string for this component
+ *
+ * Used as the text key to a JSON block.  You do not need to free it.
+ *
+ * @return non-null A text string unique to this component
+ *
+ */
+const char *localCache_GetName(void);
+
+/**
+ * Return the maximum object count from the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack configuration JSON
+ *
+ * @return The configured value, or the default if the key is missing
+ */
+size_t localCache_GetMaxObjectsFromConfig(PARCJSON *stackJson);
+
+/**
+ * Return the maximum byte count from the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack configuration JSON
+ *
+ * @return The configured value, or the default if the key is missing
+ */
+size_t localCache_GetMaxBytesFromConfig(PARCJSON *stackJson);
+#endif // Libccnx_config_Cache_h
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include "config_Capture.h"
+
+#include <LongBow/runtime.h>
+
+static const char param_CAPTURE[] = "CAPTURE";
+static const char param_CAPTURE_PATH[] = "PATH";        // string, the capture file
+
+/**
+ * Generates:
+ *
+ * { "CAPTURE" : { "PATH" : capturePath } }
+ */
+CCNxConnectionConfig *
+connectorCapture_ConnectionConfig(CCNxConnectionConfig *connConfig, const char *capturePath)
+{
+    assertNotNull(capturePath, "Parameter capturePath must be non-null");
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddString(json, param_CAPTURE_PATH, capturePath);
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+    CCNxConnectionConfig *result = ccnxConnectionConfig_Add(connConfig, connectorCapture_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+const char *
+connectorCapture_GetName()
+{
+    return param_CAPTURE;
+}
+
+const char *
+connectorCapture_GetPathFromConfig(PARCJSON *connectionJson)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(connectionJson, connectorCapture_GetName());
+    if (value == NULL || !parcJSONValue_IsJSON(value)) {
+        return NULL;
+    }
+
+    value = parcJSON_GetValueByName(parcJSONValue_GetJSON(value), param_CAPTURE_PATH);
+    if (value == NULL) {
+        return NULL;
+    }
+    assertTrue(parcJSONValue_IsString(value), "JSON key %s must be type STRING", param_CAPTURE_PATH);
+
+    PARCBuffer *sBuf = parcJSONValue_GetString(value);
+    return parcBuffer_Overlay(sBuf, 0);
+}
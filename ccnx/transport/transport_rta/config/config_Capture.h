@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file config_Capture.h
+ * @brief Generates the connection configuration that records a connection's traffic
+ *
+ * A forwarder connector (FWD_LOCAL or FWD_METIS) writes every packet it sends to or
+ * receives from the forwarder to a capture file if the connection's configuration has a
+ * CAPTURE block.  Only the connections configured this way are captured.  Several
+ * connections may share one file, each record carries its connection id.
+ *
+ * See rta_Capture.h for the file format and test_tools/rta_replay.c to play a capture back.
+ *
+ * @code
+ * {
+ *      // Capture the traffic of one {APIConnector,TLVCodec,MetisForwarder} connection
+ *
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      tlvCodec_ConnectionConfig(connConfig);
+ *      metisForwarder_ConnectionConfig(connConfig, 9695);
+ *      connectorCapture_ConnectionConfig(connConfig, "/tmp/connection.cap");
+ * }
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#ifndef Libccnx_config_Capture_h
+#define Libccnx_config_Capture_h
+
+#include <ccnx/transport/common/ccnx_TransportConfig.h>
+
+/**
+ * Generates the configuration settings included in the Connection configuration
+ *
+ * Adds configuration elements to the `CCNxConnectionConfig`
+ *
+ *  { "CAPTURE" : { "PATH" : capturePath } }
+ *
+ * The file is opened for append, so an existing capture is extended, not truncated.
+ *
+ * @param [in] connConfig A pointer to a valid CCNxConnectionConfig instance.
+ * @param [in] capturePath The filesystem path of the capture file
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *     connectorCapture_ConnectionConfig(connConfig, "/tmp/connection.cap");
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *connectorCapture_ConnectionConfig(CCNxConnectionConfig *connConfig, const char *capturePath);
+
+/**
+ * Returns the text string for the capture block
+ *
+ * Used as the text key to a JSON block.  You do not need to free it.
+ *
+ * @return non-null A text string unique to the capture block
+ */
+const char *connectorCapture_GetName(void);
+
+/**
+ * The capture file path of a connection
+ *
+ * @param [in] connectionJson The connection's parameters, e.g. from `rtaConnection_GetParameters()`
+ *
+ * @return NULL The connection is not captured
+ * @return non-null The capture file path.  It is an overlay of the JSON, do not free it.
+ *
+ * Example:
+ * @code
+ * {
+ *     const char *path = connectorCapture_GetPathFromConfig(rtaConnection_GetParameters(conn));
+ *     if (path != NULL) {
+ *         capture = rtaCapture_Open(path);
+ *     }
+ * }
+ * @endcode
+ */
+const char *connectorCapture_GetPathFromConfig(PARCJSON *connectionJson);
+#endif // Libccnx_config_Capture_h
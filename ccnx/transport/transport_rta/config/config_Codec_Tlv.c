@@ -36,6 +36,20 @@
 //static const char param_CODEC[] = "CODEC";
 //static const int default_schema = 0;
 
+static const char param_SIGNING_WORKERS[] = "SIGNING_WORKERS";     // integer, e.g. 2
+static const char param_BATCH_SIZE[] = "BATCH_SIZE";               // integer, e.g. 256
+static const char param_BATCH_DELAY_MS[] = "BATCH_DELAY_MS";       // integer, e.g. 5
+static const char param_BATCH_NOT_INTEROPERABLE[] = "BATCH_NOT_INTEROPERABLE";    // integer, 0 or 1
+static const char param_LAZY_DECODE[] = "LAZY_DECODE";             // integer, 0 or 1
+static const char param_DECODE_WORKERS[] = "DECODE_WORKERS";       // integer, e.g. 2
+
+static const unsigned default_signing_workers = 0;
+static const unsigned default_batch_size = 0;
+static const unsigned default_batch_delay_ms = 5;
+static const unsigned default_batch_not_interoperable = 0;
+static const unsigned default_lazy_decode = 0;
+static const unsigned default_decode_workers = 0;
+
 /**
  * Generates:
  *
@@ -44,13 +58,129 @@
 CCNxStackConfig *
 tlvCodec_ProtocolStackConfig(CCNxStackConfig *stackConfig)
 {
-    PARCJSONValue *value = parcJSONValue_CreateFromNULL();
+    PARCJSON *json = parcJSON_Create();
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
     CCNxStackConfig *result = ccnxStackConfig_Add(stackConfig, tlvCodec_GetName(), value);
     parcJSONValue_Release(&value);
 
     return result;
 }
 
+/**
+ * Adds a parameter to the codec's object in the stack config.  The object must
+ * already be there from tlvCodec_ProtocolStackConfig().
+ */
+static CCNxStackConfig *
+_tlvCodec_AddStackParameter(CCNxStackConfig *stackConfig, const char *key, unsigned value)
+{
+    PARCJSONValue *codecValue = ccnxStackConfig_Get(stackConfig, tlvCodec_GetName());
+    assertTrue(codecValue != NULL && parcJSONValue_IsJSON(codecValue),
+               "Call tlvCodec_ProtocolStackConfig() before setting %s", key);
+
+    PARCJSON *codecJson = parcJSONValue_GetJSON(codecValue);
+    assertNull(parcJSON_GetValueByName(codecJson, key), "%s is already set", key);
+
+    parcJSON_AddInteger(codecJson, key, value);
+    return stackConfig;
+}
+
+static unsigned
+_tlvCodec_GetStackParameter(PARCJSON *stackJson, const char *key, unsigned defaultValue)
+{
+    PARCJSONValue *codecValue = parcJSON_GetValueByName(stackJson, tlvCodec_GetName());
+    if (codecValue != NULL && parcJSONValue_IsJSON(codecValue)) {
+        PARCJSONValue *value = parcJSON_GetValueByName(parcJSONValue_GetJSON(codecValue), key);
+        if (value != NULL && parcJSONValue_IsNumber(value)) {
+            return (unsigned) parcJSONValue_GetInteger(value);
+        }
+    }
+    return defaultValue;
+}
+
+/**
+ * Generates:
+ *
+ * { "CODEC_TLV" : { "SIGNING_WORKERS" : workerCount } }
+ */
+CCNxStackConfig *
+tlvCodec_SetSigningWorkers(CCNxStackConfig *stackConfig, unsigned workerCount)
+{
+    return _tlvCodec_AddStackParameter(stackConfig, param_SIGNING_WORKERS, workerCount);
+}
+
+unsigned
+tlvCodec_GetSigningWorkersFromConfig(PARCJSON *stackJson)
+{
+    return _tlvCodec_GetStackParameter(stackJson, param_SIGNING_WORKERS, default_signing_workers);
+}
+
+/**
+ * Generates:
+ *
+ * { "CODEC_TLV" : { "BATCH_SIZE" : maxObjects, "BATCH_DELAY_MS" : maxDelayMsec, "BATCH_NOT_INTEROPERABLE" : 0 or 1 } }
+ */
+CCNxStackConfig *
+tlvCodec_SetBatchSigning(CCNxStackConfig *stackConfig, unsigned maxObjects, unsigned maxDelayMsec, bool notInteroperable)
+{
+    assertTrue(maxObjects == 0 || notInteroperable,
+               "Batch signed Content Objects only verify with the batch extension, set notInteroperable to accept that");
+
+    _tlvCodec_AddStackParameter(stackConfig, param_BATCH_SIZE, maxObjects);
+    _tlvCodec_AddStackParameter(stackConfig, param_BATCH_NOT_INTEROPERABLE, notInteroperable ? 1 : 0);
+    return _tlvCodec_AddStackParameter(stackConfig, param_BATCH_DELAY_MS, maxDelayMsec);
+}
+
+unsigned
+tlvCodec_GetBatchSizeFromConfig(PARCJSON *stackJson)
+{
+    if (_tlvCodec_GetStackParameter(stackJson, param_BATCH_NOT_INTEROPERABLE, default_batch_not_interoperable) == 0) {
+        return 0;
+    }
+    return _tlvCodec_GetStackParameter(stackJson, param_BATCH_SIZE, default_batch_size);
+}
+
+unsigned
+tlvCodec_GetBatchDelayFromConfig(PARCJSON *stackJson)
+{
+    return _tlvCodec_GetStackParameter(stackJson, param_BATCH_DELAY_MS, default_batch_delay_ms);
+}
+
+/**
+ * Generates:
+ *
+ * { "CODEC_TLV" : { "LAZY_DECODE" : 0 or 1 } }
+ */
+CCNxStackConfig *
+tlvCodec_SetLazyDecode(CCNxStackConfig *stackConfig, bool lazy)
+{
+    return _tlvCodec_AddStackParameter(stackConfig, param_LAZY_DECODE, lazy ? 1 : 0);
+}
+
+bool
+tlvCodec_GetLazyDecodeFromConfig(PARCJSON *stackJson)
+{
+    return _tlvCodec_GetStackParameter(stackJson, param_LAZY_DECODE, default_lazy_decode) != 0;
+}
+
+/**
+ * Generates:
+ *
+ * { "CODEC_TLV" : { "DECODE_WORKERS" : workerCount } }
+ */
+CCNxStackConfig *
+tlvCodec_SetDecodeWorkers(CCNxStackConfig *stackConfig, unsigned workerCount)
+{
+    return _tlvCodec_AddStackParameter(stackConfig, param_DECODE_WORKERS, workerCount);
+}
+
+unsigned
+tlvCodec_GetDecodeWorkersFromConfig(PARCJSON *stackJson)
+{
+    return _tlvCodec_GetStackParameter(stackJson, param_DECODE_WORKERS, default_decode_workers);
+}
+
 /**
  * Generates:
  *
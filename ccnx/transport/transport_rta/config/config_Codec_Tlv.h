@@ -92,6 +92,172 @@ CCNxStackConfig *tlvCodec_ProtocolStackConfig(CCNxStackConfig *stackConfig);
  */
 CCNxConnectionConfig *tlvCodec_ConnectionConfig(CCNxConnectionConfig *config);
 
+/**
+ * Sign and encode packets going down the stack on worker threads
+ *
+ * With 0 workers, the default, the codec encodes and signs each packet on the RTA
+ * thread as it arrives.  With 1 or more workers, each connection gets its own signer
+ * per worker, packets are encoded on the workers, and the codec passes them down the
+ * stack in the order it received them.
+ *
+ * Must be called after `tlvCodec_ProtocolStackConfig()`.
+ *
+ * { "TLV_CODEC" : { "SIGNING_WORKERS" : workerCount } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] workerCount The number of signing threads in the protocol stack
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_SetSigningWorkers(stackConfig, 4);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *tlvCodec_SetSigningWorkers(CCNxStackConfig *stackConfig, unsigned workerCount);
+
+/**
+ * Returns the number of signing workers in the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return number The configured workers, or 0 if not set
+ */
+unsigned tlvCodec_GetSigningWorkersFromConfig(PARCJSON *stackJson);
+
+/**
+ * Sign Content Objects going down the stack in batches
+ *
+ * The codec holds unsigned Content Objects until it has `maxObjects` of them or the
+ * oldest has waited `maxDelayMsec`.  It then signs the root of a Merkle tree over the
+ * batch with one public key operation, on a signing worker if the stack has them.  Each
+ * object's ValidationPayload carries the batch mark, its inclusion proof and the root
+ * signature (see codec_MerkleTree.h).  Other messages of the connection wait behind the
+ * batch so the order does not change.
+ *
+ * Batched objects are NOT interoperable: only a verifier that knows the batch extension,
+ * such as the Verify component, can check them.  Everyone else sees a signature that does
+ * not verify.  The caller must say so with `notInteroperable`, and the codec ignores a
+ * batch size in a configuration that does not carry that flag.
+ *
+ * Must be called after `tlvCodec_ProtocolStackConfig()`.
+ *
+ * { "TLV_CODEC" : { "BATCH_SIZE" : maxObjects, "BATCH_DELAY_MS" : maxDelayMsec, "BATCH_NOT_INTEROPERABLE" : 1 } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] maxObjects The most Content Objects under one signature, 0 signs each object
+ * @param [in] maxDelayMsec The longest a Content Object waits for its batch to fill
+ * @param [in] notInteroperable Must be true if `maxObjects` is not 0
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_SetBatchSigning(stackConfig, 256, 5, true);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *tlvCodec_SetBatchSigning(CCNxStackConfig *stackConfig, unsigned maxObjects, unsigned maxDelayMsec, bool notInteroperable);
+
+/**
+ * Returns the batch size in the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return number The most Content Objects under one signature, or 0 if batch signing is off
+ *                or the configuration does not accept non-interoperable batches
+ */
+unsigned tlvCodec_GetBatchSizeFromConfig(PARCJSON *stackJson);
+
+/**
+ * Returns the batch delay in the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return number The longest a Content Object waits for its batch, in milliseconds
+ */
+unsigned tlvCodec_GetBatchDelayFromConfig(PARCJSON *stackJson);
+
+/**
+ * Decode received packets lazily
+ *
+ * When on, the codec only indexes where the fields of a received Interest or Content
+ * Object are and decodes its name.  The remaining fields are decoded from the wire
+ * format the first time a component above calls `transportMessage_CompleteDecode()`,
+ * so packets dropped before then (e.g. old segments in Vegas) never pay for a full decode.
+ * See codec_TlvIndex.h.
+ *
+ * Must be called after `tlvCodec_ProtocolStackConfig()`.
+ *
+ * { "TLV_CODEC" : { "LAZY_DECODE" : 0 or 1 } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] lazy true to decode lazily, false (the default) to decode every field on receipt
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_SetLazyDecode(stackConfig, true);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *tlvCodec_SetLazyDecode(CCNxStackConfig *stackConfig, bool lazy);
+
+/**
+ * Returns true if the protocol stack configuration turns on lazy decoding
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return true Received packets are decoded lazily
+ * @return false Received packets are fully decoded by the codec (the default)
+ */
+bool tlvCodec_GetLazyDecodeFromConfig(PARCJSON *stackJson);
+
+/**
+ * Decode packets coming up the stack on worker threads
+ *
+ * With 0 workers, the default, the codec decodes each received packet on the RTA thread
+ * as it arrives, so a burst of Content Objects holds up everything above the codec.  With
+ * 1 or more workers, packets are decoded (fully or lazily, see `tlvCodec_SetLazyDecode()`)
+ * on the workers and the codec passes them up the stack in the order each connection
+ * received them.
+ *
+ * Must be called after `tlvCodec_ProtocolStackConfig()`.
+ *
+ * { "TLV_CODEC" : { "DECODE_WORKERS" : workerCount } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] workerCount The number of decode threads in the protocol stack
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_SetDecodeWorkers(stackConfig, 2);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *tlvCodec_SetDecodeWorkers(CCNxStackConfig *stackConfig, unsigned workerCount);
+
+/**
+ * Returns the number of decode workers in the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return number The configured workers, or 0 if not set
+ */
+unsigned tlvCodec_GetDecodeWorkersFromConfig(PARCJSON *stackJson);
+
 /**
  * Returns the text string for this component
  *
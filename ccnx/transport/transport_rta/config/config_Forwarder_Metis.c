@@ -28,27 +28,72 @@
 #include <LongBow/runtime.h>
 
 #include <stdio.h>
+#include <string.h>
 #include "config_Forwarder_Metis.h"
 #include <ccnx/transport/transport_rta/core/components.h>
 
 static const char param_METIS_PORT[] = METIS_PORT_ENV;          // integer, e.g. 9695
+static const char param_SHARED_SOCKET[] = "SHARED_SOCKET";      // integer, 0 or 1
+static const char param_TRANSPORT[] = "TRANSPORT";              // string, see transportNames
+static const char param_PATH[] = "PATH";                        // string, PF_UNIX socket path
 static const short default_port = 9695;
 
+static const char *transportNames[] = {
+    [MetisTransport_Tcp]          = "tcp",
+    [MetisTransport_Unix]         = "unix",
+    [MetisTransport_SharedMemory] = "shm",
+};
+
 /**
  * Generates:
  *
- * { "FWD_METIS" : { "port" : port } }
+ * { "FWD_METIS" : { } }
  */
 CCNxStackConfig *
 metisForwarder_ProtocolStackConfig(CCNxStackConfig *stackConfig)
 {
-    PARCJSONValue *value = parcJSONValue_CreateFromNULL();
+    PARCJSON *json = parcJSON_Create();
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
     CCNxStackConfig *result = ccnxStackConfig_Add(stackConfig, metisForwarder_GetName(), value);
     parcJSONValue_Release(&value);
 
     return result;
 }
 
+/**
+ * Generates:
+ *
+ * { "FWD_METIS" : { "SHARED_SOCKET" : 0 or 1 } }
+ */
+CCNxStackConfig *
+metisForwarder_SetSharedSocket(CCNxStackConfig *stackConfig, bool shared)
+{
+    PARCJSONValue *metisValue = ccnxStackConfig_Get(stackConfig, metisForwarder_GetName());
+    assertTrue(metisValue != NULL && parcJSONValue_IsJSON(metisValue),
+               "Call metisForwarder_ProtocolStackConfig() before setting %s", param_SHARED_SOCKET);
+
+    PARCJSON *metisJson = parcJSONValue_GetJSON(metisValue);
+    assertNull(parcJSON_GetValueByName(metisJson, param_SHARED_SOCKET), "%s is already set", param_SHARED_SOCKET);
+
+    parcJSON_AddInteger(metisJson, param_SHARED_SOCKET, shared ? 1 : 0);
+    return stackConfig;
+}
+
+bool
+metisForwarder_GetSharedSocketFromConfig(PARCJSON *stackJson)
+{
+    PARCJSONValue *metisValue = parcJSON_GetValueByName(stackJson, metisForwarder_GetName());
+    if (metisValue != NULL && parcJSONValue_IsJSON(metisValue)) {
+        PARCJSONValue *value = parcJSON_GetValueByName(parcJSONValue_GetJSON(metisValue), param_SHARED_SOCKET);
+        if (value != NULL && parcJSONValue_IsNumber(value)) {
+            return parcJSONValue_GetInteger(value) != 0;
+        }
+    }
+    return false;
+}
+
 /**
  * The metis forwarder port may be set per connection in the stack
  *
@@ -68,6 +113,64 @@ metisForwarder_ConnectionConfig(CCNxConnectionConfig *connConfig, uint16_t port)
     return result;
 }
 
+/**
+ * Generates:
+ *
+ * { "FWD_METIS" : { "port" : port, "TRANSPORT" : "tcp" | "unix" | "shm", "PATH" : path } }
+ */
+CCNxConnectionConfig *
+metisForwarder_SetTransport(CCNxConnectionConfig *connConfig, MetisTransport transport, const char *path)
+{
+    PARCJSONValue *metisValue = parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connConfig), metisForwarder_GetName());
+    assertTrue(metisValue != NULL && parcJSONValue_IsJSON(metisValue),
+               "Call metisForwarder_ConnectionConfig() before setting %s", param_TRANSPORT);
+    trapIllegalValueIf(transport > MetisTransport_SharedMemory, "Unknown transport %d", transport);
+    assertTrue(transport == MetisTransport_Tcp || path != NULL, "Transport %s needs a path", transportNames[transport]);
+
+    PARCJSON *metisJson = parcJSONValue_GetJSON(metisValue);
+    assertNull(parcJSON_GetValueByName(metisJson, param_TRANSPORT), "%s is already set", param_TRANSPORT);
+
+    parcJSON_AddString(metisJson, param_TRANSPORT, transportNames[transport]);
+    if (path != NULL) {
+        parcJSON_AddString(metisJson, param_PATH, path);
+    }
+    return connConfig;
+}
+
+static PARCJSONValue *
+_getConnectionValue(PARCJSON *json, const char *key)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(json, metisForwarder_GetName());
+    assertNotNull(value, "Got null for %s json", metisForwarder_GetName());
+    return parcJSON_GetValueByName(parcJSONValue_GetJSON(value), key);
+}
+
+MetisTransport
+metisForwarder_GetTransportFromConfig(PARCJSON *json)
+{
+    PARCJSONValue *value = _getConnectionValue(json, param_TRANSPORT);
+    if (value != NULL && parcJSONValue_IsString(value)) {
+        const char *name = parcBuffer_Overlay(parcJSONValue_GetString(value), 0);
+        for (size_t i = 0; i < sizeof(transportNames) / sizeof(transportNames[0]); i++) {
+            if (strcmp(name, transportNames[i]) == 0) {
+                return (MetisTransport) i;
+            }
+        }
+        trapIllegalValue(name, "Unknown %s %s", param_TRANSPORT, name);
+    }
+    return MetisTransport_Tcp;
+}
+
+const char *
+metisForwarder_GetPathFromConfig(PARCJSON *json)
+{
+    PARCJSONValue *value = _getConnectionValue(json, param_PATH);
+    if (value != NULL && parcJSONValue_IsString(value)) {
+        return parcBuffer_Overlay(parcJSONValue_GetString(value), 0);
+    }
+    return NULL;
+}
+
 uint16_t
 metisForwarder_GetDefaultPort()
 {
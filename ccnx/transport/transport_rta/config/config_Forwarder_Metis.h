@@ -57,11 +57,21 @@
 #ifndef Libccnx_config_Forwarder_Metis_h
 #define Libccnx_config_Forwarder_Metis_h
 
+#include <stdbool.h>
 #include <ccnx/transport/common/ccnx_TransportConfig.h>
 
 #define METIS_PORT_ENV "METIS_PORT"
 #define FORWARDER_CONNECTION_ENV "CCNX_FORWARDER"
 
+/**
+ * How the Metis connector reaches the forwarder
+ */
+typedef enum {
+    MetisTransport_Tcp,          // TCP to the connection's port on 127.0.0.1, the default
+    MetisTransport_Unix,         // a PF_UNIX stream socket
+    MetisTransport_SharedMemory  // packet rings in shared memory, set up and signalled over a PF_UNIX socket
+} MetisTransport;
+
 /**
  * Generates the configuration settings included in the Protocol Stack configuration
  *
@@ -80,6 +90,52 @@
  */
 CCNxStackConfig *metisForwarder_ProtocolStackConfig(CCNxStackConfig *stackConfig);
 
+/**
+ * Share one socket to Metis between every connection on the protocol stack
+ *
+ * The first connection opens the socket and later connections attach to it, so opening
+ * a connection does not wait for a TCP handshake or use a Metis connection slot.  The
+ * connector sends each packet from Metis up the connection it belongs to: Content Objects
+ * to the connections with a pending Interest of that name, Interests to the connection
+ * that registered the longest prefix, control responses to the connection that sent the
+ * request.  See forwarder_Demux.h.
+ *
+ * All the connections use the port of the connection that opened the socket.  A connection
+ * that is blocked up holds its packets instead of pausing the socket for the others.
+ *
+ * Metis does not forward a packet back out the face it came in on, and the shared socket
+ * is a single face.  A producer and a consumer on the same stack cannot reach each other
+ * with this on; give them separate stacks.
+ *
+ * Must be called after `metisForwarder_ProtocolStackConfig()`.
+ *
+ * { "FWD_METIS" : { "SHARED_SOCKET" : 0 or 1 } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] shared true to share one socket, false for a socket per connection (the default)
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      metisForwarder_ProtocolStackConfig(stackConfig);
+ *      metisForwarder_SetSharedSocket(stackConfig, true);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *metisForwarder_SetSharedSocket(CCNxStackConfig *stackConfig, bool shared);
+
+/**
+ * Returns true if the protocol stack configuration shares one socket to Metis
+ *
+ * @param [in] stackJson The protocol stack JSON
+ *
+ * @return true The connections on the stack share one socket
+ * @return false Each connection has its own socket, also if not set
+ */
+bool metisForwarder_GetSharedSocketFromConfig(PARCJSON *stackJson);
+
 /**
  * Generates the configuration settings included in the Connection configuration
  *
@@ -98,6 +154,55 @@ CCNxStackConfig *metisForwarder_ProtocolStackConfig(CCNxStackConfig *stackConfig
  */
 CCNxConnectionConfig *metisForwarder_ConnectionConfig(CCNxConnectionConfig *config, uint16_t port);
 
+/**
+ * Reach a co-located forwarder over a PF_UNIX socket instead of TCP
+ *
+ * `MetisTransport_Unix` sends the same byte stream as TCP over a PF_UNIX stream socket.
+ * `MetisTransport_SharedMemory` connects the PF_UNIX socket, then moves packets through
+ * two rings in a shared memory segment and only uses the socket to wake the other side.
+ * See forwarder_ShmLink.h.  The forwarder must support the transport.
+ *
+ * Must be called after `metisForwarder_ConnectionConfig()`.  The port is not used.
+ * Setting the environment variable CCNX_FORWARDER to "unix://path" has the same effect as
+ * `MetisTransport_Unix` for connections configured for TCP.
+ *
+ *  { "FWD_METIS" : { "port" : port, "TRANSPORT" : "tcp" | "unix" | "shm", "PATH" : path } }
+ *
+ * @param [in] connConfig The connection configuration to update
+ * @param [in] transport How to reach the forwarder
+ * @param [in] path The path of the forwarder's PF_UNIX socket, may be NULL for `MetisTransport_Tcp`
+ *
+ * @return non-null The updated connection configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      metisForwarder_ConnectionConfig(connConfig, metisForwarder_GetDefaultPort());
+ *      metisForwarder_SetTransport(connConfig, MetisTransport_SharedMemory, "/tmp/metis.sock");
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *metisForwarder_SetTransport(CCNxConnectionConfig *connConfig, MetisTransport transport, const char *path);
+
+/**
+ * Returns the transport in the per-connection configuration
+ *
+ * @param [in] json The connection JSON
+ *
+ * @return The configured transport, `MetisTransport_Tcp` if not set
+ */
+MetisTransport metisForwarder_GetTransportFromConfig(PARCJSON *json);
+
+/**
+ * Returns the PF_UNIX socket path in the per-connection configuration
+ *
+ * @param [in] json The connection JSON
+ *
+ * @return non-null The path, owned by the configuration
+ * @return null No path is set
+ */
+const char *metisForwarder_GetPathFromConfig(PARCJSON *json);
+
 /**
  * Returns the text string for this component
  *
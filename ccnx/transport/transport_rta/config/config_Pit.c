@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <LongBow/runtime.h>
+
+#include <stdio.h>
+#include "config_Pit.h"
+#include <ccnx/transport/transport_rta/core/components.h>
+
+static const char param_MAX_ENTRIES[] = "MAX_ENTRIES";      // integer, e.g. 1024
+
+static const size_t default_max_entries = 4096;
+
+/**
+ * Generates:
+ *
+ * { "PIT" : { "MAX_ENTRIES" : maxEntries } }
+ */
+CCNxStackConfig *
+localPit_ProtocolStackConfig(CCNxStackConfig *stackConfig, size_t maxEntries)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, param_MAX_ENTRIES, maxEntries);
+
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
+    CCNxStackConfig *result = ccnxStackConfig_Add(stackConfig, localPit_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+/**
+ * Generates:
+ *
+ * { "PIT" : { } }
+ */
+CCNxConnectionConfig *
+localPit_ConnectionConfig(CCNxConnectionConfig *connectionConfig)
+{
+    PARCJSONValue *value = parcJSONValue_CreateFromNULL();
+    CCNxConnectionConfig *result = ccnxConnectionConfig_Add(connectionConfig, localPit_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+const char *
+localPit_GetName(void)
+{
+    return RtaComponentNames[PIT];
+}
+
+size_t
+localPit_GetMaxEntriesFromConfig(PARCJSON *stackJson)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(stackJson, localPit_GetName());
+    if (value != NULL && parcJSONValue_IsJSON(value)) {
+        PARCJSON *pitJson = parcJSONValue_GetJSON(value);
+        value = parcJSON_GetValueByName(pitJson, param_MAX_ENTRIES);
+        if (value != NULL && parcJSONValue_IsNumber(value)) {
+            return (size_t) parcJSONValue_GetInteger(value);
+        }
+    }
+    return default_max_entries;
+}
@@ -39,6 +39,8 @@
 
 static const char param_STACK[] = "STACK";
 static const char param_COMPONENTS[] = "COMPONENTS";
+static const char param_BATCH[] = "BATCH";             // integer, messages per component turn
+static const unsigned default_batch = 64;
 
 /*
  * Call with the names of each component, terminated by a NULL, for example:
@@ -107,6 +109,39 @@ protocolStack_GetName(void)
     return param_STACK;
 }
 
+/**
+ * Generates:
+ *
+ * { "STACK" : { "COMPONENTS" : [ ... ], "BATCH" : messages } }
+ */
+CCNxStackConfig *
+protocolStack_SetBatchSize(CCNxStackConfig *stackConfig, unsigned messages)
+{
+    PARCJSONValue *stackValue = ccnxStackConfig_Get(stackConfig, param_STACK);
+    assertTrue(stackValue != NULL && parcJSONValue_IsJSON(stackValue),
+               "Configure the %s before setting %s", param_COMPONENTS, param_BATCH);
+    assertTrue(messages > 0, "Parameter messages must be positive");
+
+    PARCJSON *stackJson = parcJSONValue_GetJSON(stackValue);
+    assertNull(parcJSON_GetValueByName(stackJson, param_BATCH), "%s is already set", param_BATCH);
+
+    parcJSON_AddInteger(stackJson, param_BATCH, messages);
+    return stackConfig;
+}
+
+unsigned
+protocolStack_GetBatchSizeFromConfig(PARCJSON *protocolStackJson)
+{
+    PARCJSONValue *stackValue = parcJSON_GetValueByName(protocolStackJson, param_STACK);
+    if (stackValue != NULL && parcJSONValue_IsJSON(stackValue)) {
+        PARCJSONValue *value = parcJSON_GetValueByName(parcJSONValue_GetJSON(stackValue), param_BATCH);
+        if (value != NULL && parcJSONValue_IsNumber(value) && parcJSONValue_GetInteger(value) > 0) {
+            return (unsigned) parcJSONValue_GetInteger(value);
+        }
+    }
+    return default_batch;
+}
+
 /**
  * Parse the protocol stack json to extract an array list of the component names
  */
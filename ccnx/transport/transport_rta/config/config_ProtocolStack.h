@@ -124,4 +124,36 @@ const char *protocolStack_GetName(void);
  * Parse the protocol stack json to extract an array list of the component names
  */
 PARCArrayList *protocolStack_GetComponentNameArray(PARCJSON *stackJson);
+
+/**
+ * Sets the most messages a component processes in one turn
+ *
+ * When a queue between two components backs up, the stack gives the component at most
+ * this many messages, shared between the connections (see rta_QueueScheduler.h), then lets
+ * other events run.  Smaller batches give lower latency to light connections next to a busy
+ * one; larger batches have less overhead.  If not called, the batch is 64.
+ *
+ * Must be called after `protocolStack_ComponentsConfigArgs()` or `protocolStack_ComponentsConfigArrayList()`.
+ *
+ * { "STACK" : { "COMPONENTS" : [ ... ], "BATCH" : messages } }
+ *
+ * @param [in] stackConfig The protocol stack configuration to update
+ * @param [in] messages The batch size (positive)
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), tlvCodec_GetName(), metisForwarder_GetName(), NULL);
+ *      protocolStack_SetBatchSize(stackConfig, 16);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *protocolStack_SetBatchSize(CCNxStackConfig *stackConfig, unsigned messages);
+
+/**
+ * Returns the batch size from the protocol stack json, or the default
+ */
+unsigned protocolStack_GetBatchSizeFromConfig(PARCJSON *stackJson);
 #endif // Libccnx_config_ProtocolStack_h
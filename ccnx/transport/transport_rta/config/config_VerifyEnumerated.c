@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <LongBow/runtime.h>
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include "config_VerifyEnumerated.h"
+#include <ccnx/transport/transport_rta/core/components.h>
+
+static const char param_WORKERS[] = "WORKERS";      // integer, e.g. 2
+static const char param_KEYIDS[] = "KEYIDS";        // array of hex strings
+
+static const unsigned default_workers = 2;
+
+/**
+ * Generates:
+ *
+ * { "VERIFY_ENUMERATED" : { "WORKERS" : workerCount } }
+ */
+CCNxStackConfig *
+verifyEnumerated_ProtocolStackConfig(CCNxStackConfig *stackConfig, unsigned workerCount)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, param_WORKERS, workerCount);
+
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
+    CCNxStackConfig *result = ccnxStackConfig_Add(stackConfig, verifyEnumerated_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+/**
+ * Generates:
+ *
+ * { "VERIFY_ENUMERATED" : { "KEYIDS" : [ hex, hex, ... ] } }
+ */
+CCNxConnectionConfig *
+verifyEnumerated_ConnectionConfig(CCNxConnectionConfig *connectionConfig, ...)
+{
+    PARCJSONArray *arrayJson = parcJSONArray_Create();
+
+    va_list ap;
+    const PARCBuffer *keyId;
+    va_start(ap, connectionConfig);
+
+    while ((keyId = va_arg(ap, const PARCBuffer *)) != NULL) {
+        char *hex = parcBuffer_ToHexString(keyId);
+        PARCJSONValue *value = parcJSONValue_CreateFromCString(hex);
+        parcJSONArray_AddValue(arrayJson, value);
+        parcJSONValue_Release(&value);
+        parcMemory_Deallocate((void **) &hex);
+    }
+
+    va_end(ap);
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddArray(json, param_KEYIDS, arrayJson);
+    parcJSONArray_Release(&arrayJson);
+
+    PARCJSONValue *value = parcJSONValue_CreateFromJSON(json);
+    parcJSON_Release(&json);
+
+    CCNxConnectionConfig *result = ccnxConnectionConfig_Add(connectionConfig, verifyEnumerated_GetName(), value);
+    parcJSONValue_Release(&value);
+    return result;
+}
+
+const char *
+verifyEnumerated_GetName(void)
+{
+    return RtaComponentNames[VERIFY_ENUMERATED];
+}
+
+static PARCJSONValue *
+_verifyEnumerated_GetParam(PARCJSON *json, const char *key)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(json, verifyEnumerated_GetName());
+    if (value != NULL && parcJSONValue_IsJSON(value)) {
+        return parcJSON_GetValueByName(parcJSONValue_GetJSON(value), key);
+    }
+    return NULL;
+}
+
+unsigned
+verifyEnumerated_GetWorkersFromConfig(PARCJSON *stackJson)
+{
+    PARCJSONValue *value = _verifyEnumerated_GetParam(stackJson, param_WORKERS);
+    if (value != NULL && parcJSONValue_IsNumber(value)) {
+        return (unsigned) parcJSONValue_GetInteger(value);
+    }
+    return default_workers;
+}
+
+size_t
+verifyEnumerated_GetTrustedKeyIdCount(PARCJSON *connectionJson)
+{
+    PARCJSONValue *value = _verifyEnumerated_GetParam(connectionJson, param_KEYIDS);
+    if (value != NULL && parcJSONValue_IsArray(value)) {
+        return parcJSONArray_GetLength(parcJSONValue_GetArray(value));
+    }
+    return 0;
+}
+
+PARCBuffer *
+verifyEnumerated_CreateTrustedKeyId(PARCJSON *connectionJson, size_t index)
+{
+    PARCJSONValue *value = _verifyEnumerated_GetParam(connectionJson, param_KEYIDS);
+    assertTrue(value != NULL && parcJSONValue_IsArray(value), "Connection config has no %s array", param_KEYIDS);
+
+    PARCJSONArray *keyIds = parcJSONValue_GetArray(value);
+    assertTrue(index < parcJSONArray_GetLength(keyIds), "Index %zu out of range", index);
+
+    char *hex = parcBuffer_ToString(parcJSONValue_GetString(parcJSONArray_GetValue(keyIds, index)));
+    PARCBuffer *keyId = parcBuffer_ParseHexString(hex);
+    parcMemory_Deallocate((void **) &hex);
+    return keyId;
+}
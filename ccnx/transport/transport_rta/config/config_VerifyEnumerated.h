@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file config_VerifyEnumerated.h
+ * @brief Generates stack and connection configuration information
+ *
+ * Each component in the protocol stack must have a configuration element.
+ * This module generates the configuration elements for the signature verifier (VERIFY_ENUMERATED).
+ *
+ * The verifier is optional.  It sits above the codec so it sees decoded Content Objects
+ * going up the stack.  The stack configuration sets the number of worker threads that do the
+ * public key operations.  The connection configuration enumerates the KeyIds the connection
+ * trusts.
+ *
+ * @code
+ * {
+ *      // Configure a stack with {APIConnector,Verifier,TLVCodec,MetisConnector}
+ *
+ *      stackConfig = ccnxStackConfig_Create();
+ *      connConfig = ccnxConnectionConfig_Create();
+ *
+ *      apiConnector_ProtocolStackConfig(stackConfig);
+ *      apiConnector_ConnectionConfig(connConfig);
+ *      verifyEnumerated_ProtocolStackConfig(stackConfig, 2);
+ *      verifyEnumerated_ConnectionConfig(connConfig, publisherKeyId, NULL);
+ *      tlvCodec_ProtocolStackConfig(stackConfig);
+ *      tlvCodec_ConnectionConfig(connConfig);
+ *      metisForwarder_ProtocolStackConfig(stackConfig);
+ *      metisForwarder_ConnectionConfig(connConfig, metisForwarder_GetDefaultPort());
+ *
+ *      protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), verifyEnumerated_GetName(),
+ *                                         tlvCodec_GetName(), metisForwarder_GetName(), NULL);
+ *
+ *      CCNxTransportConfig *config = ccnxTransportConfig_Create(stackConfig, connConfig);
+ * }
+ * @endcode
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#ifndef Libccnx_config_VerifyEnumerated_h
+#define Libccnx_config_VerifyEnumerated_h
+
+#include <ccnx/transport/common/ccnx_TransportConfig.h>
+#include <parc/algol/parc_Buffer.h>
+
+/**
+ * Generates the configuration settings included in the Protocol Stack configuration
+ *
+ * Adds configuration elements to the Protocol Stack configuration
+ *
+ * { "VERIFY_ENUMERATED" : { "WORKERS" : workerCount } }
+ *
+ * @param [in] stackConfig The protocl stack configuration to update
+ * @param [in] workerCount The number of verification threads, 0 verifies on the RTA thread
+ *
+ * @return non-null The updated protocol stack configuration
+ *
+ * Example:
+ * @code
+ * {
+ *      verifyEnumerated_ProtocolStackConfig(stackConfig, 2);
+ * }
+ * @endcode
+ */
+CCNxStackConfig *verifyEnumerated_ProtocolStackConfig(CCNxStackConfig *stackConfig, unsigned workerCount);
+
+/**
+ * Generates the configuration settings included in the Connection configuration
+ *
+ * Call with the trusted KeyIds, terminated by a NULL.  The KeyIds are stored as hex strings.
+ *
+ * { "VERIFY_ENUMERATED" : { "KEYIDS" : [ hex, hex, ... ] } }
+ *
+ * @param [in] config The CCNxConnectionConfig instance
+ * @param [in] ... `const PARCBuffer *` KeyIds, terminated by NULL
+ *
+ * @return non-null The modified `CCNxConnectionConfig`
+ *
+ * Example:
+ * @code
+ * {
+ *      verifyEnumerated_ConnectionConfig(connConfig, aliceKeyId, bobKeyId, NULL);
+ * }
+ * @endcode
+ */
+CCNxConnectionConfig *verifyEnumerated_ConnectionConfig(CCNxConnectionConfig *config, ...);
+
+/**
+ * Returns the text string for this component
+ *
+ * Used as the text key to a JSON block.  You do not need to free it.
+ *
+ * @return non-null A text string unique to this component
+ *
+ */
+const char *verifyEnumerated_GetName(void);
+
+/**
+ * Return the number of worker threads from the protocol stack configuration
+ *
+ * @param [in] stackJson The protocol stack configuration JSON
+ *
+ * @return The configured value, or the default if the key is missing
+ */
+unsigned verifyEnumerated_GetWorkersFromConfig(PARCJSON *stackJson);
+
+/**
+ * Return the number of trusted KeyIds in the connection configuration
+ *
+ * @param [in] connectionJson The connection configuration JSON
+ *
+ * @return The number of KeyIds, 0 if the key is missing
+ */
+size_t verifyEnumerated_GetTrustedKeyIdCount(PARCJSON *connectionJson);
+
+/**
+ * Return one of the trusted KeyIds in the connection configuration
+ *
+ * @param [in] connectionJson The connection configuration JSON
+ * @param [in] index Less than `verifyEnumerated_GetTrustedKeyIdCount()`
+ *
+ * @return non-null The KeyId, release with `parcBuffer_Release()`
+ *
+ * Example:
+ * @code
+ * {
+ *      for (size_t i = 0; i < verifyEnumerated_GetTrustedKeyIdCount(json); i++) {
+ *          PARCBuffer *keyId = verifyEnumerated_CreateTrustedKeyId(json, i);
+ *          ...
+ *          parcBuffer_Release(&keyId);
+ *      }
+ * }
+ * @endcode
+ */
+PARCBuffer *verifyEnumerated_CreateTrustedKeyId(PARCJSON *connectionJson, size_t index);
+#endif // Libccnx_config_VerifyEnumerated_h
@@ -67,6 +67,12 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, apiConnector_GetName);
     LONGBOW_RUN_TEST_CASE(Global, apiConnector_ProtocolStackConfig_JsonKey);
     LONGBOW_RUN_TEST_CASE(Global, apiConnector_ProtocolStackConfig_ReturnValue);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_SetQueueBudget);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_GetQueueBudget_Default);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_SetSchedulingWeight);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_GetSchedulingWeight_Clamped);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_SetStatusWindow);
+    LONGBOW_RUN_TEST_CASE(Global, apiConnector_SetBinaryStatus);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -125,6 +131,94 @@ LONGBOW_TEST_CASE(Global, apiConnector_ProtocolStackConfig_ReturnValue)
                (void *) test, (void *) data->stackConfig);
 }
 
+LONGBOW_TEST_CASE(Global, apiConnector_SetQueueBudget)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+    CCNxConnectionConfig *test = apiConnector_SetQueueBudget(data->connConfig, 65536, 100);
+    assertTrue(test == data->connConfig, "Did not return pointer to argument for chaining");
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    size_t bytes = apiConnector_GetQueueBytesFromConfig(json);
+    size_t messages = apiConnector_GetQueueMessagesFromConfig(json);
+    assertTrue(bytes == 65536, "Wrong byte budget, got %zu expected 65536", bytes);
+    assertTrue(messages == 100, "Wrong message budget, got %zu expected 100", messages);
+}
+
+LONGBOW_TEST_CASE(Global, apiConnector_GetQueueBudget_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    size_t bytes = apiConnector_GetQueueBytesFromConfig(json);
+    size_t messages = apiConnector_GetQueueMessagesFromConfig(json);
+    assertTrue(bytes == default_queue_bytes, "Wrong byte budget, got %zu expected %zu", bytes, default_queue_bytes);
+    assertTrue(messages == default_queue_messages, "Wrong message budget, got %zu expected %zu", messages, default_queue_messages);
+}
+
+LONGBOW_TEST_CASE(Global, apiConnector_SetSchedulingWeight)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    unsigned weight = apiConnector_GetSchedulingWeightFromConfig(json);
+    assertTrue(weight == default_weight, "Wrong default weight, got %u expected %u", weight, default_weight);
+
+    CCNxConnectionConfig *test = apiConnector_SetSchedulingWeight(data->connConfig, 4);
+    assertTrue(test == data->connConfig, "Did not return pointer to argument for chaining");
+
+    weight = apiConnector_GetSchedulingWeightFromConfig(ccnxConnectionConfig_GetJson(data->connConfig));
+    assertTrue(weight == 4, "Wrong weight, got %u expected 4", weight);
+}
+
+/**
+ * A weight above UINT32_MAX must not wrap, 2^32 would become 0 and never be granted a message
+ */
+LONGBOW_TEST_CASE(Global, apiConnector_GetSchedulingWeight_Clamped)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    PARCJSON *apiJson = parcJSONValue_GetJSON(parcJSON_GetValueByName(json, apiConnector_GetName()));
+    parcJSON_AddInteger(apiJson, param_WEIGHT, (int64_t) UINT32_MAX + 1);
+
+    unsigned weight = apiConnector_GetSchedulingWeightFromConfig(json);
+    assertTrue(weight == UINT_MAX, "Expected the weight clamped to %u, got %u", UINT_MAX, weight);
+}
+
+LONGBOW_TEST_CASE(Global, apiConnector_SetStatusWindow)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+
+    unsigned window = apiConnector_GetStatusWindowFromConfig(ccnxConnectionConfig_GetJson(data->connConfig));
+    assertTrue(window == 0, "Default should not coalesce, got window %u", window);
+
+    CCNxConnectionConfig *test = apiConnector_SetStatusWindow(data->connConfig, 250);
+    assertTrue(test == data->connConfig, "Did not return pointer to argument for chaining");
+
+    window = apiConnector_GetStatusWindowFromConfig(ccnxConnectionConfig_GetJson(data->connConfig));
+    assertTrue(window == 250, "Wrong window, got %u expected 250", window);
+}
+
+LONGBOW_TEST_CASE(Global, apiConnector_SetBinaryStatus)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    apiConnector_ConnectionConfig(data->connConfig);
+
+    assertFalse(apiConnector_GetBinaryStatusFromConfig(ccnxConnectionConfig_GetJson(data->connConfig)),
+                "Default should be JSON notifications");
+
+    CCNxConnectionConfig *test = apiConnector_SetBinaryStatus(data->connConfig);
+    assertTrue(test == data->connConfig, "Did not return pointer to argument for chaining");
+
+    assertTrue(apiConnector_GetBinaryStatusFromConfig(ccnxConnectionConfig_GetJson(data->connConfig)),
+               "Expected binary notifications");
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
 }
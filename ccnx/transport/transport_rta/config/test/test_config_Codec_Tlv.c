@@ -68,6 +68,15 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetName);
     LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_ProtocolStackConfig_JsonKey);
     LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_ProtocolStackConfig_ReturnValue);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_SetSigningWorkers);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetSigningWorkersFromConfig_Default);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_SetBatchSigning);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetBatchFromConfig_Default);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetBatchFromConfig_NotAccepted);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_SetLazyDecode);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetLazyDecodeFromConfig_Default);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_SetDecodeWorkers);
+    LONGBOW_RUN_TEST_CASE(Global, Codec_Tlv_GetDecodeWorkersFromConfig_Default);
 
     LONGBOW_RUN_TEST_CASE(Global, tlvCodec_ConnectionConfig);
 }
@@ -128,6 +137,115 @@ LONGBOW_TEST_CASE(Global, Codec_Tlv_ProtocolStackConfig_ReturnValue)
                (void *) test, (void *) data->stackConfig);
 }
 
+LONGBOW_TEST_CASE(Global, Codec_Tlv_SetSigningWorkers)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+    CCNxStackConfig *test = tlvCodec_SetSigningWorkers(data->stackConfig, 3);
+
+    assertTrue(test == data->stackConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->stackConfig);
+
+    unsigned workers = tlvCodec_GetSigningWorkersFromConfig(ccnxStackConfig_GetJson(data->stackConfig));
+    assertTrue(workers == 3, "Wrong value, expected 3 got %u", workers);
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_GetSigningWorkersFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+
+    unsigned workers = tlvCodec_GetSigningWorkersFromConfig(ccnxStackConfig_GetJson(data->stackConfig));
+    assertTrue(workers == default_signing_workers, "Wrong value, expected %u got %u", default_signing_workers, workers);
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_SetBatchSigning)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+    tlvCodec_SetSigningWorkers(data->stackConfig, 2);
+    CCNxStackConfig *test = tlvCodec_SetBatchSigning(data->stackConfig, 64, 10, true);
+
+    assertTrue(test == data->stackConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetBatchSizeFromConfig(json) == 64, "Wrong batch size, got %u", tlvCodec_GetBatchSizeFromConfig(json));
+    assertTrue(tlvCodec_GetBatchDelayFromConfig(json) == 10, "Wrong batch delay, got %u", tlvCodec_GetBatchDelayFromConfig(json));
+    assertTrue(tlvCodec_GetSigningWorkersFromConfig(json) == 2, "Setting the batch lost the signing workers");
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_GetBatchFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetBatchSizeFromConfig(json) == default_batch_size, "Wrong default batch size");
+    assertTrue(tlvCodec_GetBatchDelayFromConfig(json) == default_batch_delay_ms, "Wrong default batch delay");
+}
+
+/**
+ * A batch size without the not-interoperable flag, e.g. from an old configuration, leaves batching off
+ */
+LONGBOW_TEST_CASE(Global, Codec_Tlv_GetBatchFromConfig_NotAccepted)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+    _tlvCodec_AddStackParameter(data->stackConfig, param_BATCH_SIZE, 64);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetBatchSizeFromConfig(json) == 0, "Expected batching off, got size %u", tlvCodec_GetBatchSizeFromConfig(json));
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_SetLazyDecode)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+    CCNxStackConfig *test = tlvCodec_SetLazyDecode(data->stackConfig, true);
+    assertTrue(test == data->stackConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetLazyDecodeFromConfig(json), "Lazy decode should be on");
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_GetLazyDecodeFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertFalse(tlvCodec_GetLazyDecodeFromConfig(json), "Lazy decode should be off by default");
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_SetDecodeWorkers)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+    tlvCodec_SetSigningWorkers(data->stackConfig, 2);
+    CCNxStackConfig *test = tlvCodec_SetDecodeWorkers(data->stackConfig, 3);
+    assertTrue(test == data->stackConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetDecodeWorkersFromConfig(json) == 3, "Wrong decode workers, got %u", tlvCodec_GetDecodeWorkersFromConfig(json));
+    assertTrue(tlvCodec_GetSigningWorkersFromConfig(json) == 2, "Setting the decode workers lost the signing workers");
+}
+
+LONGBOW_TEST_CASE(Global, Codec_Tlv_GetDecodeWorkersFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    tlvCodec_ProtocolStackConfig(data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(tlvCodec_GetDecodeWorkersFromConfig(json) == default_decode_workers, "Wrong default decode workers");
+}
+
 LONGBOW_TEST_CASE(Global, tlvCodec_ConnectionConfig)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -71,6 +71,10 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_ProtocolStackConfig_ReturnValue);
 
     LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_GetPath);
+    LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_SetSharedSocket);
+    LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_GetSharedSocketFromConfig_Default);
+    LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_SetTransport);
+    LONGBOW_RUN_TEST_CASE(Global, Forwarder_Metis_GetTransportFromConfig_Default);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -121,6 +125,54 @@ LONGBOW_TEST_CASE(Global, Forwarder_Metis_GetPath)
     assertTrue(truth == test, "Got wrong socket path, got %d expected %d", test, truth);
 }
 
+LONGBOW_TEST_CASE(Global, Forwarder_Metis_SetSharedSocket)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    metisForwarder_ProtocolStackConfig(data->stackConfig);
+    CCNxStackConfig *test = metisForwarder_SetSharedSocket(data->stackConfig, true);
+    assertTrue(test == data->stackConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertTrue(metisForwarder_GetSharedSocketFromConfig(json), "Shared socket should be on");
+}
+
+LONGBOW_TEST_CASE(Global, Forwarder_Metis_GetSharedSocketFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    metisForwarder_ProtocolStackConfig(data->stackConfig);
+
+    PARCJSON *json = ccnxStackConfig_GetJson(data->stackConfig);
+    assertFalse(metisForwarder_GetSharedSocketFromConfig(json), "Shared socket should be off by default");
+}
+
+LONGBOW_TEST_CASE(Global, Forwarder_Metis_SetTransport)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    metisForwarder_ConnectionConfig(data->connConfig, 9999);
+    CCNxConnectionConfig *test = metisForwarder_SetTransport(data->connConfig, MetisTransport_SharedMemory, "/tmp/metis.sock");
+    assertTrue(test == data->connConfig,
+               "Did not return pointer to argument for chaining, got %p expected %p",
+               (void *) test, (void *) data->connConfig);
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    MetisTransport transport = metisForwarder_GetTransportFromConfig(json);
+    assertTrue(transport == MetisTransport_SharedMemory, "Wrong transport, got %d expected %d", transport, MetisTransport_SharedMemory);
+    assertTrue(strcmp(metisForwarder_GetPathFromConfig(json), "/tmp/metis.sock") == 0,
+               "Wrong path, got %s", metisForwarder_GetPathFromConfig(json));
+}
+
+LONGBOW_TEST_CASE(Global, Forwarder_Metis_GetTransportFromConfig_Default)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    metisForwarder_ConnectionConfig(data->connConfig, 9999);
+
+    PARCJSON *json = ccnxConnectionConfig_GetJson(data->connConfig);
+    assertTrue(metisForwarder_GetTransportFromConfig(json) == MetisTransport_Tcp, "Transport should be TCP by default");
+    assertNull(metisForwarder_GetPathFromConfig(json), "Path should not be set by default");
+}
+
 LONGBOW_TEST_CASE(Global, Forwarder_Metis_ProtocolStackConfig_JsonKey)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -62,6 +62,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, protocolStack_ComponentsConfigArrayList);
     LONGBOW_RUN_TEST_CASE(Global, protocolStack_GetComponentNameArray);
     LONGBOW_RUN_TEST_CASE(Global, protocolStack_GetName);
+    LONGBOW_RUN_TEST_CASE(Global, protocolStack_SetBatchSize);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -149,6 +150,28 @@ LONGBOW_TEST_CASE(Global, protocolStack_GetName)
     assertTrue(strcmp(name, param_STACK) == 0, "Got wrong name, got %s expected %s", name, param_STACK);
 }
 
+LONGBOW_TEST_CASE(Global, protocolStack_SetBatchSize)
+{
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+    protocolStack_ComponentsConfigArgs(stackConfig, "Apple", "Bananna", NULL);
+
+    unsigned batch = protocolStack_GetBatchSizeFromConfig(ccnxStackConfig_GetJson(stackConfig));
+    assertTrue(batch == default_batch, "Wrong default batch, got %u expected %u", batch, default_batch);
+
+    const char truth[] = "{\"STACK\":{\"COMPONENTS\":[\"Apple\",\"Bananna\"],\"BATCH\":16}}";
+
+    protocolStack_SetBatchSize(stackConfig, 16);
+    PARCJSON *json = ccnxStackConfig_GetJson(stackConfig);
+    char *str = parcJSON_ToCompactString(json);
+    assertTrue(strcmp(truth, str) == 0, "Got wrong config, got %s expected %s", str, truth);
+
+    batch = protocolStack_GetBatchSizeFromConfig(json);
+    assertTrue(batch == 16, "Wrong batch, got %u expected 16", batch);
+
+    parcMemory_Deallocate((void **) &str);
+    ccnxStackConfig_Release(&stackConfig);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
 }
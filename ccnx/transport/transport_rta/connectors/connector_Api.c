@@ -155,14 +155,16 @@ connector_Api_Upcall_Read(PARCEventQueue *eventBuffer, PARCEventType type, void
         RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(conn, API_CONNECTOR);
         assertNotNull(apiConnection, "got null apiConnection\n");
 
-        // If we are blocked, only pass control messages
-        if (!rtaConnection_BlockedUp(conn) || transportMessage_IsControl(tm)) {
+        // Being blocked up only stops the components below from reading more, what is
+        // already in the stack still goes to the API.  Data is dropped only once the API
+        // has paused the connection to close it.
+        if (rtaConnection_GetState(conn) == CONN_OPEN || transportMessage_IsControl(tm)) {
             if (!rtaApiConnection_SendToApi(apiConnection, tm, stats)) {
                 // we failed to write.  Should a control message be re-queued? (case 879).
                 // memory is freed at bottom of function
             }
         } else {
-            // closed connection, just destroy the message
+            // closing connection, just destroy the message
             if (DEBUG_OUTPUT) {
                 printf("%9" PRIu64 " %s conn %p destroying transport message %p due to closed connection\n",
                        rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
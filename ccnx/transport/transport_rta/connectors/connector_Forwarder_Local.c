@@ -68,6 +68,8 @@
 #include <ccnx/transport/transport_rta/connectors/connector_Forwarder.h>
 
 #include <ccnx/transport/transport_rta/config/config_Forwarder_Local.h>
+#include <ccnx/transport/transport_rta/config/config_Capture.h>
+#include <ccnx/transport/transport_rta/connectors/rta_Capture.h>
 #include <ccnx/api/control/controlPlaneInterface.h>
 #include <ccnx/api/control/cpi_ControlFacade.h>
 
@@ -102,6 +104,10 @@ struct fwd_local_state {
     int fd;
     PARCEventQueue *bev_local;
     int connected;
+
+    // non-null if the connection is configured with connectorCapture_ConnectionConfig()
+    RtaCapture *capture;
+    unsigned connectionId;
 };
 
 typedef struct {
@@ -158,6 +164,9 @@ connector_Fwd_Local_Opener(RtaConnection *conn)
 
     rtaConnection_SetPrivateData(conn, FWD_LOCAL, fwd_state);
 
+    fwd_state->capture = NULL;
+    fwd_state->connectionId = rtaConnection_GetConnectionId(conn);
+
     fwd_state->fd = socket(PF_LOCAL, SOCK_STREAM, 0);
     if (fwd_state->fd < 0) {
         perror("socket PF_LOCAL");
@@ -217,6 +226,16 @@ connector_Fwd_Local_Opener(RtaConnection *conn)
         return -1;
     }
 
+    // A capture that cannot be opened does not fail the connection
+    const char *capturePath = connectorCapture_GetPathFromConfig(rtaConnection_GetParameters(conn));
+    if (capturePath != NULL) {
+        fwd_state->capture = rtaCapture_Open(capturePath);
+        if (fwd_state->capture == NULL) {
+            fprintf(stderr, "%s connection %u could not open capture file %s: %s\n",
+                    __func__, fwd_state->connectionId, capturePath, strerror(errno));
+        }
+    }
+
     // Socket will be ready for use once we get PARCEventQueueEventType_Connected
     if (DEBUG_OUTPUT) {
         printf("%9" PRIu64 " %s open conn %p\n",
@@ -283,6 +302,11 @@ connector_Fwd_Local_Upcall_Read(PARCEventQueue *bev, PARCEventType type, void *p
 
         parcBuffer_Flip(wireFormat);
 
+        struct fwd_local_state *fwd_state = rtaConnection_GetPrivateData(conn, FWD_LOCAL);
+        if (fwd_state->capture != NULL) {
+            rtaCapture_WriteBuffer(fwd_state->capture, fwd_state->connectionId, RtaCaptureDirection_Up, wireFormat);
+        }
+
         if (rtaConnection_GetState(conn) == CONN_OPEN) {
             CCNxWireFormatMessage *wireFormatMessage = ccnxWireFormatMessage_Create(wireFormat);
             CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_GetDictionary(wireFormatMessage);
@@ -383,14 +407,13 @@ connector_Fwd_Local_Upcall_Event(PARCEventQueue *queue, PARCEventQueueEventType
 }
 
 static void
-_ackRequest(RtaConnection *conn, PARCJSON *request)
+_ackRequest(RtaConnection *conn, CCNxTlvDictionary *request)
 {
-    PARCJSON *response = cpiAcks_CreateAck(request);
-    CCNxTlvDictionary *ackDict = ccnxControlFacade_CreateCPI(response);
+    // the ack has the encoding of the request, JSON or binary
+    CCNxTlvDictionary *ackDict = ccnxControl_CreateAck(request);
 
     TransportMessage *tm_ack = transportMessage_CreateFromDictionary(ackDict);
     ccnxTlvDictionary_Release(&ackDict);
-    parcJSON_Release(&response);
 
     transportMessage_SetInfo(tm_ack, rtaConnection_Copy(conn), rtaConnection_FreeFunc);
 
@@ -408,9 +431,9 @@ connector_Fwd_Local_ProcessControl(RtaConnection *conn, TransportMessage *tm)
     CCNxTlvDictionary *controlDictionary = transportMessage_GetDictionary(tm);
 
     if (ccnxControlFacade_IsCPI(controlDictionary)) {
-        PARCJSON *json = ccnxControlFacade_GetJson(controlDictionary);
-        if (controlPlaneInterface_GetCPIMessageType(json) == CPI_REQUEST) {
-            if (cpi_getCPIOperation2(json) == CPI_PAUSE) {
+        if (cpi_GetMessageType(controlDictionary) == CPI_REQUEST) {
+            CpiOperation operation = cpi_GetMessageOperation(controlDictionary);
+            if (operation == CPI_PAUSE) {
                 // need to pause the input (case 897)
                 if (DEBUG_OUTPUT) {
                     printf("%9" PRIu64 " %s conn %p recieved PAUSE\n",
@@ -418,18 +441,18 @@ connector_Fwd_Local_ProcessControl(RtaConnection *conn, TransportMessage *tm)
                            __func__,
                            (void *) conn);
                 }
-                _ackRequest(conn, json);
-            } else if (cpi_getCPIOperation2(json) == CPI_FLUSH) {
+                _ackRequest(conn, controlDictionary);
+            } else if (operation == CPI_FLUSH) {
                 if (DEBUG_OUTPUT) {
                     printf("%9" PRIu64 " %s conn %p recieved FLUSH\n",
                            rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
                            __func__,
                            (void *) conn);
                 }
-                _ackRequest(conn, json);
+                _ackRequest(conn, controlDictionary);
             } else {
                 // some other message.  We just ACK everything in the local connector.
-                _ackRequest(conn, json);
+                _ackRequest(conn, controlDictionary);
             }
         }
     }
@@ -468,6 +491,10 @@ connector_Fwd_Local_WriteIovec(struct fwd_local_state *fwdConnState, RtaConnecti
             trapUnrecoverableState("%s error writing iovec to bev_local", __func__);
         }
     }
+
+    if (fwdConnState->capture != NULL) {
+        rtaCapture_WriteIoVec(fwdConnState->capture, fwdConnState->connectionId, RtaCaptureDirection_Down, iovcnt, array);
+    }
 }
 
 /* send raw packet from codec to forwarder */
@@ -532,6 +559,9 @@ connector_Fwd_Local_Closer(RtaConnection *conn)
 
     // this will close too
     parcEventQueue_Destroy(&(fwd_state->bev_local));
+    if (fwd_state->capture != NULL) {
+        rtaCapture_Close(&fwd_state->capture);
+    }
     memset(fwd_state, 0, sizeof(struct fwd_local_state));
     parcMemory_Deallocate((void **) &fwd_state);
 
@@ -31,7 +31,7 @@
 
 /**
  * The metis connector does the following per connection:
- * - Opens a TCP socket to Metis
+ * - Opens a TCP socket to Metis, or a PF_UNIX socket (see metisForwarder_SetTransport)
  * - Creates an "event" for the socket, does not use the buffer to avoid doing extra copy.
  * - On read events, uses direct socket operations to read in data
  *
@@ -70,6 +70,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/queue.h>
 #include <netdb.h>
 
 #define __STDC_FORMAT_MACROS
@@ -93,9 +94,15 @@
 #include "connector_Forwarder.h"
 
 #include <ccnx/transport/transport_rta/config/config_Forwarder_Metis.h>
+#include <ccnx/transport/transport_rta/config/config_Capture.h>
+#include <ccnx/transport/transport_rta/connectors/rta_Capture.h>
+#include <ccnx/transport/transport_rta/connectors/forwarder_Demux.h>
+#include <ccnx/transport/transport_rta/connectors/forwarder_ShmLink.h>
 
 #include <ccnx/api/control/controlPlaneInterface.h>
 #include <ccnx/api/control/cpi_ControlFacade.h>
+#include <ccnx/api/control/cpi_Acks.h>
+#include <ccnx/api/control/cpi_Forwarding.h>
 
 #include <ccnx/common/codec/ccnxCodec_TlvEncoder.h>
 #include <ccnx/common/codec/ccnxCodec_TlvDecoder.h>
@@ -105,8 +112,12 @@
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_FixedHeader.h>
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_Types.h>
 
+#include <ccnx/common/ccnx_Interest.h>
 #include <ccnx/common/ccnx_WireFormatMessage.h>
 
+#include <ccnx/transport/transport_rta/components/codec_Validator.h>
+#include <ccnx/transport/transport_rta/components/codec_TlvIndex.h>
+
 #define MINIMUM_READ_LENGTH 8
 
 // The message type for a Metis control packet
@@ -118,9 +129,20 @@
 // How big should we try to make the output socket size?
 #define METIS_SEND_SOCKET_BUFFER 65536
 
-// Maximum input backlog in messages, not bytes
+// Maximum input backlog in messages, not bytes.  We stop reading the socket at this
+// many and start again once the backlog is down to half.
 #define METIS_INPUT_QUEUE_MESSAGES 100
 
+// How many waiting connections a shared socket takes from the demux at a time
+#define METIS_DEMUX_BATCH 16
+
+// A shared socket stops reading once a blocked up connection holds this many packets
+// in the demux, and starts again once it is down to half
+#define METIS_DEMUX_HELD_MESSAGES 100
+
+// The size of each shared memory ring with MetisTransport_SharedMemory
+#define METIS_SHM_RING_BYTES (1024 * 1024)
+
 #ifndef DEBUG_OUTPUT
 #define DEBUG_OUTPUT 0
 #endif
@@ -129,6 +151,7 @@ static int  connector_Fwd_Metis_Init(RtaProtocolStack *stack);
 static int  connector_Fwd_Metis_Opener(RtaConnection *conn);
 
 static void _eventCallback(int fd, PARCEventType what, void *connectionVoid);
+static void _sharedEventCallback(int fd, PARCEventType what, void *metisStateVoid);
 static void connector_Fwd_Metis_Dequeue(int fd, PARCEventType which_event, void *metisStateVoid);
 
 static void connector_Fwd_Metis_Downcall_Read(PARCEventQueue *, PARCEventType, void *conn);
@@ -160,12 +183,21 @@ typedef struct metis_connector_stats {
     unsigned countUpcallReads;
     unsigned countUpcallWriteDataOk;
     unsigned countUpcallWriteDataError;
+    // queued for a connection that was blocked up
     unsigned countUpcallWriteDataBlocked;
+    // the times we stopped reading the socket because the input queue, or the packets a
+    // connection of a shared socket holds in the demux, was full
     unsigned countUpcallWriteDataQueueFull;
 
     unsigned countUpcallWriteControlOk;
     unsigned countUpcallWriteControlError;
 
+    // dropped by codecValidator_Validate() before decoding
+    unsigned countUpcallMalformed;
+
+    // dropped by a shared socket because no connection was waiting for them
+    unsigned countUpcallUnmatched;
+
     unsigned countDowncallReads;
     unsigned countDowncallWrites;
     unsigned countDowncallControl;
@@ -199,10 +231,36 @@ typedef struct next_message_header {
     PARCBuffer *packet;
 } NextMessage;
 
+/**
+ * A batched route registration (CPI_REGISTER_PREFIXES) waiting for its acks
+ *
+ * Metis registers one route per request, so the codec sends a batch as `count`
+ * REGISTER packets numbered from the batch's sequence number.  Their acks are
+ * collected here and go up as one ack with a result per route.
+ */
+typedef struct fwd_metis_route_batch {
+    // not a reference, the batch is dropped when the connection closes
+    RtaConnection *conn;
+    CCNxTlvDictionary *request;
+    uint64_t firstSequenceNumber;
+    size_t count;
+    size_t answered;
+    bool *results;
+    TAILQ_ENTRY(fwd_metis_route_batch) list;
+} _FwdMetisRouteBatch;
+
 typedef struct fwd_metis_state {
     uint16_t port;
     int fd;
 
+    // from the connection's configuration, see metisForwarder_SetTransport()
+    MetisTransport transport;
+    char *path;
+
+    // non-null with MetisTransport_SharedMemory.  Packets go through the link's rings
+    // and fd is only the doorbell.
+    ForwarderShmLink *shmLink;
+
     // separate events for read and write on fd so we can individually enable them
     PARCEvent *readEvent;
     PARCEvent *writeEvent;
@@ -218,12 +276,44 @@ typedef struct fwd_metis_state {
     PARCDeque *transportMessageQueue;
     PARCEventTimer *transportMessageQueueEvent;
 
+    // We stopped reading with packets left in the socket because transportMessageQueue was
+    // full.  The read event is edge triggered, so connector_Fwd_Metis_Dequeue() reads again
+    // with pausedConnection (NULL for a shared socket) once the queue drains.
+    bool readPaused;
+    RtaConnection *pausedConnection;
+
     // This buffer is the queue of stuff we need to send to the network
     PARCEventBuffer *metisOutputQueue;
 
     _MetisConnectorStats stats;
+
+    // non-null if the connection is configured with connectorCapture_ConnectionConfig().
+    // A shared socket uses the capture of the connection that opened it.
+    RtaCapture *capture;
+    unsigned connectionId;
+
+    RtaProtocolStack *stack;
+
+    // non-null if every connection on the stack shares this socket (metisForwarder_SetSharedSocket).
+    // Each connection and the stack hold a reference, the last one closes the socket.
+    ForwarderDemux *demux;
+    unsigned refCount;
+
+    // a shared socket that failed is not given to new connections
+    bool failed;
+
+    // batched route registrations sent to Metis and not yet fully acked
+    TAILQ_HEAD(, fwd_metis_route_batch) routeBatches;
 } FwdMetisState;
 
+/**
+ * The stack's private data when its connections share a socket
+ */
+typedef struct fwd_metis_stack_state {
+    // the socket new connections attach to, opened with the first of them
+    FwdMetisState *sharedState;
+} FwdMetisStackState;
+
 /**
  * @typedef PacketData
  * @brief Used to pass a record between reading a packet and sending it up the stack
@@ -275,6 +365,12 @@ connector_Fwd_Metis_Init(RtaProtocolStack *stack)
     ignore_action.sa_flags = 0;
     sigaction(SIGPIPE, &ignore_action, NULL);
 
+    if (metisForwarder_GetSharedSocketFromConfig(rtaProtocolStack_GetParameters(stack))) {
+        FwdMetisStackState *stackState = parcMemory_AllocateAndClear(sizeof(FwdMetisStackState));
+        assertNotNull(stackState, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(FwdMetisStackState));
+        rtaProtocolStack_SetPrivateData(stack, FWD_METIS, stackState);
+    }
+
     return 0;
 }
 
@@ -321,24 +417,64 @@ connector_Fwd_Metis_CreateConnectionState(PARCEventScheduler *scheduler)
     fwd_state->transportMessageQueueEvent = parcEventTimer_Create(scheduler, 0, connector_Fwd_Metis_Dequeue, fwd_state);
     fwd_state->isConnected = false;
     fwd_state->metisOutputQueue = parcEventBuffer_Create();
+    TAILQ_INIT(&fwd_state->routeBatches);
 
     return fwd_state;
 }
 
+/**
+ * Sets the transport and path from the connection's configuration.  A "unix://path"
+ * in CCNX_FORWARDER moves a TCP connection to a PF_UNIX socket.
+ */
+static void
+_readInTransport(FwdMetisState *fwd_state, PARCJSON *params)
+{
+    fwd_state->transport = metisForwarder_GetTransportFromConfig(params);
+    const char *path = metisForwarder_GetPathFromConfig(params);
+
+    const char unixScheme[] = "unix://";
+    char *forwarderEnv = getenv(FORWARDER_CONNECTION_ENV);
+    if (fwd_state->transport == MetisTransport_Tcp && forwarderEnv != NULL &&
+        strncmp(forwarderEnv, unixScheme, sizeof(unixScheme) - 1) == 0) {
+        fwd_state->transport = MetisTransport_Unix;
+        path = forwarderEnv + sizeof(unixScheme) - 1;
+    }
+
+    if (path != NULL) {
+        fwd_state->path = parcMemory_StringDuplicate(path, strlen(path));
+    }
+}
+
 static bool
 _openSocket(FwdMetisState *fwd_state, uint16_t port)
 {
+    int family = (fwd_state->transport == MetisTransport_Tcp) ? PF_INET : PF_UNIX;
+
     fwd_state->port = port;
-    fwd_state->fd = socket(PF_INET, SOCK_STREAM, 0);
+    fwd_state->fd = socket(family, SOCK_STREAM, 0);
 
     if (fwd_state->fd < 0) {
         if (DEBUG_OUTPUT) {
-            printf("%9c %s failed to open PF_INET SOCK_STREAM socket: (%d) %s\n",
-                   ' ', __func__, errno, strerror(errno));
+            printf("%9c %s failed to open %s SOCK_STREAM socket: (%d) %s\n",
+                   ' ', __func__, (family == PF_INET) ? "PF_INET" : "PF_UNIX", errno, strerror(errno));
         }
         return false;
     }
 
+    if (fwd_state->transport == MetisTransport_SharedMemory) {
+        // the socket is unique in the process while it is open, so it names the segment
+        char name[32];
+        snprintf(name, sizeof(name), "/ccnx-metis-%d-%d", (int) getpid(), fwd_state->fd);
+        fwd_state->shmLink = forwarderShmLink_Create(name, METIS_SHM_RING_BYTES);
+        if (fwd_state->shmLink == NULL) {
+            if (DEBUG_OUTPUT) {
+                printf("%9c %s failed to create shared memory %s: (%d) %s\n",
+                       ' ', __func__, name, errno, strerror(errno));
+            }
+            return false;
+        }
+    }
+
     if (DEBUG_OUTPUT) {
         printf("%9c %s create socket %d port %u\n",
                ' ', __func__, fwd_state->fd, fwd_state->port);
@@ -380,6 +516,7 @@ _setupSocket(FwdMetisState *fwd_state)
         }
 
         close(fwd_state->fd);
+        fwd_state->fd = -1;
         return false;
     }
 
@@ -424,13 +561,21 @@ _setupSocketEvents(FwdMetisState *fwd_state, RtaConnection *conn)
     RtaProtocolStack *stack = rtaConnection_GetStack(conn);
     PARCEventScheduler *scheduler = rtaFramework_GetEventScheduler(rtaProtocolStack_GetFramework(stack));
 
+    // A shared socket's events are not tied to one connection
+    PARCEvent_Callback *callback = _eventCallback;
+    void *callbackArg = conn;
+    if (fwd_state->demux != NULL) {
+        callback = _sharedEventCallback;
+        callbackArg = fwd_state;
+    }
+
     // the connect() call will be asynchrnous because the socket is non-blocking, so we
     // need ET_WRITE to trigger a callback when the socket becomes writable (i.e. connected).
     // If there's an error on connect it will be an ET_READ | ET_WRITE event with an error on the socket.
-    fwd_state->readEvent = parcEvent_Create(scheduler, fwd_state->fd, PARCEventType_Read | PARCEventType_Persist | PARCEventType_EdgeTriggered, _eventCallback, conn);
+    fwd_state->readEvent = parcEvent_Create(scheduler, fwd_state->fd, PARCEventType_Read | PARCEventType_Persist | PARCEventType_EdgeTriggered, callback, callbackArg);
     assertNotNull(fwd_state->readEvent, "Got a null readEvent for socket %d", fwd_state->fd);
 
-    fwd_state->writeEvent = parcEvent_Create(scheduler, fwd_state->fd, PARCEventType_Write | PARCEventType_Persist | PARCEventType_EdgeTriggered, _eventCallback, conn);
+    fwd_state->writeEvent = parcEvent_Create(scheduler, fwd_state->fd, PARCEventType_Write | PARCEventType_Persist | PARCEventType_EdgeTriggered, callback, callbackArg);
     assertNotNull(fwd_state->writeEvent, "Got a null readEvent for socket %d", fwd_state->fd);
 
     // Start the write event.  It will be signaled on a connect error or when we are connected.
@@ -442,10 +587,53 @@ _setupSocketEvents(FwdMetisState *fwd_state, RtaConnection *conn)
     return true;
 }
 
+/**
+ * Sends a status notification up every connection using the socket
+ *
+ * A socket that is not shared has only `conn`.  A shared socket ignores `conn`, which may be NULL.
+ */
+static void
+_sendStatus(FwdMetisState *fwd_state, RtaConnection *conn, NotifyStatusCode code, const char *message)
+{
+    if (fwd_state->demux == NULL) {
+        rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, code, NULL, message);
+    } else {
+        size_t count = forwarderDemux_GetConnectionCount(fwd_state->demux);
+        for (size_t i = 0; i < count; i++) {
+            rtaConnection_SendStatus(forwarderDemux_GetConnection(fwd_state->demux, i), FWD_METIS, RTA_UP, code, NULL, message);
+        }
+    }
+}
+
+/**
+ * The socket could not connect.  Block the connections down and tell the API.
+ */
+static void
+_connectionFailed(FwdMetisState *fwd_state, RtaConnection *conn)
+{
+    // make the event non-pending
+    parcEvent_Stop(fwd_state->readEvent);
+    parcEvent_Stop(fwd_state->writeEvent);
+    fwd_state->failed = true;
+
+    if (fwd_state->demux == NULL) {
+        rtaConnection_SetBlockedDown(conn);
+    } else {
+        size_t count = forwarderDemux_GetConnectionCount(fwd_state->demux);
+        for (size_t i = 0; i < count; i++) {
+            rtaConnection_SetBlockedDown(forwarderDemux_GetConnection(fwd_state->demux, i));
+        }
+    }
+
+    // at least tell the API whats going on
+    _sendStatus(fwd_state, conn, notifyStatusCode_FORWARDER_NOT_AVAILABLE, NULL);
+}
+
 /**
  * The connection to the forwarder succeeded, step the state machine
  *
- * Change the state of the connection to connected and notify the user that it's ready.
+ * Change the state of the connection to connected and notify the user that it's ready.  If the
+ * shared memory hello cannot be sent, the connection fails instead.
  *
  * @param [<#in#> | <#out#> | <#in,out#>] <#name#> <#description#>
  *
@@ -461,9 +649,18 @@ _setupSocketEvents(FwdMetisState *fwd_state, RtaConnection *conn)
 static void
 _connectionSucceeded(FwdMetisState *fwd_state, RtaConnection *conn)
 {
+    if (fwd_state->shmLink != NULL && !forwarderShmLink_SendHello(fwd_state->shmLink, fwd_state->fd)) {
+        printf("%9" PRIu64 " %s Connection %p could not send the shared memory hello on fd %d: %s\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(fwd_state->stack)),
+               __func__,
+               (void *) conn, fwd_state->fd, strerror(errno));
+        _connectionFailed(fwd_state, conn);
+        return;
+    }
+
     if (DEBUG_OUTPUT) {
         printf("%9" PRIu64 " %s Connection %p connected fd %d\n",
-               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(fwd_state->stack)),
                __func__,
                (void *) conn, fwd_state->fd);
     }
@@ -473,7 +670,7 @@ _connectionSucceeded(FwdMetisState *fwd_state, RtaConnection *conn)
     // enable read events
     parcEvent_Start(fwd_state->readEvent);
 
-    rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, notifyStatusCode_CONNECTION_OPEN, NULL, NULL);
+    _sendStatus(fwd_state, conn, notifyStatusCode_CONNECTION_OPEN, NULL);
 }
 
 static void
@@ -518,10 +715,15 @@ _readInEnvironmentConnectionSpecification(struct sockaddr_in *addr_in)
  * @param <#param1#>
  * @return <#return#>
  */
+static bool _connectReturned(FwdMetisState *fwd_state, RtaConnection *conn, int res);
+static bool _beginConnectUnix(FwdMetisState *fwd_state, RtaConnection *conn);
+
 static bool
 connector_Fwd_Metis_BeginConnect(FwdMetisState *fwd_state, RtaConnection *conn)
 {
-    bool success = false;
+    if (fwd_state->transport != MetisTransport_Tcp) {
+        return _beginConnectUnix(fwd_state, conn);
+    }
 
     struct sockaddr_in addr_in;
     memset(&addr_in, 0, sizeof(addr_in));
@@ -545,6 +747,44 @@ connector_Fwd_Metis_BeginConnect(FwdMetisState *fwd_state, RtaConnection *conn)
 
     // This will deliver a PARCEventType_Write event on connect success
     int res = connect(fwd_state->fd, (struct sockaddr*) &addr_in, (socklen_t) sizeof(addr_in));
+    return _connectReturned(fwd_state, conn, res);
+}
+
+/**
+ * Begins the non-blocking connect() to the PF_UNIX path in FwdMetisState
+ */
+static bool
+_beginConnectUnix(FwdMetisState *fwd_state, RtaConnection *conn)
+{
+    struct sockaddr_un addr_un;
+    memset(&addr_un, 0, sizeof(addr_un));
+    addr_un.sun_family = AF_UNIX;
+
+    if (fwd_state->path == NULL || strlen(fwd_state->path) >= sizeof(addr_un.sun_path)) {
+        printf("Error connecting: PF_UNIX path %s missing or too long\n", fwd_state->path ? fwd_state->path : "(null)");
+        return false;
+    }
+    strcpy(addr_un.sun_path, fwd_state->path);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s beginning connect socket %d to %s\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
+               __func__,
+               fwd_state->fd,
+               fwd_state->path);
+    }
+
+    int res = connect(fwd_state->fd, (struct sockaddr*) &addr_un, (socklen_t) sizeof(addr_un));
+    return _connectReturned(fwd_state, conn, res);
+}
+
+/**
+ * Handles the return value of a non-blocking connect()
+ */
+static bool
+_connectReturned(FwdMetisState *fwd_state, RtaConnection *conn, int res)
+{
+    bool success = false;
 
     if (res == 0) {
         // connect succeded immediately
@@ -561,9 +801,94 @@ connector_Fwd_Metis_BeginConnect(FwdMetisState *fwd_state, RtaConnection *conn)
     return success;
 }
 
+static void _readFromMetis(FwdMetisState *fwd_state, RtaConnection *conn);
+
+/**
+ * Reads the packets left in the socket when we paused, if the input queue and the
+ * packets held in the demux have drained
+ */
+static void
+_resumeReading(FwdMetisState *fwd_state)
+{
+    if (!fwd_state->readPaused || !fwd_state->isConnected) {
+        return;
+    }
+
+    if (parcDeque_Size(fwd_state->transportMessageQueue) > METIS_INPUT_QUEUE_MESSAGES / 2) {
+        return;
+    }
+
+    if (fwd_state->demux != NULL && forwarderDemux_GetMostHeld(fwd_state->demux) > METIS_DEMUX_HELD_MESSAGES / 2) {
+        return;
+    }
+
+    fwd_state->readPaused = false;
+    _readFromMetis(fwd_state, fwd_state->pausedConnection);
+}
+
+static void
+_putUpStack(TransportMessage *tm)
+{
+    RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+    RtaProtocolStack *stack = rtaConnection_GetStack(conn);
+    PARCEventQueue  *out = rtaProtocolStack_GetPutQueue(stack, FWD_METIS, RTA_UP);
+    RtaComponentStats *stats = rtaConnection_GetStats(conn, FWD_METIS);
+
+    if (rtaComponent_PutMessage(out, tm)) {
+        rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+    }
+}
+
+/**
+ * Sends up the packets the demux held for connections that are no longer blocked up
+ *
+ * @param [in] fwd_state A shared socket
+ * @param [in] maxMessages The most packets to send up
+ *
+ * @return The number of packets sent up
+ */
+static unsigned
+_releaseHeld(FwdMetisState *fwd_state, unsigned maxMessages)
+{
+    unsigned count = 0;
+    for (size_t i = 0; i < forwarderDemux_GetConnectionCount(fwd_state->demux) && count < maxMessages; i++) {
+        RtaConnection *conn = forwarderDemux_GetConnection(fwd_state->demux, i);
+
+        TransportMessage *tm;
+        while (count < maxMessages && !rtaConnection_BlockedUp(conn) &&
+               (tm = forwarderDemux_TakeHeld(fwd_state->demux, conn)) != NULL) {
+            _putUpStack(tm);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * True if a connection of a shared socket is not blocked up and holds packets
+ */
+static bool
+_hasReleasableHeld(FwdMetisState *fwd_state)
+{
+    for (size_t i = 0; i < forwarderDemux_GetConnectionCount(fwd_state->demux); i++) {
+        RtaConnection *conn = forwarderDemux_GetConnection(fwd_state->demux, i);
+        if (!rtaConnection_BlockedUp(conn) && forwarderDemux_GetHeldCount(fwd_state->demux, conn) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * We maintain an input queue going up the stack and only dequeue a small number of packets
  * with each call from the dispatch loop.  THis is to avoid bursting a bunch of packets up the stack.
+ *
+ * When a connection with its own socket is blocked up, its packets wait here until
+ * connector_Fwd_Metis_StateChange() unblocks it.  The queue fills and we stop reading.
+ *
+ * A shared socket moves the packets of a blocked up connection to the demux, so the other
+ * connections keep going.  They go up before anything newer for that connection once it
+ * unblocks.
  */
 static void
 connector_Fwd_Metis_Dequeue(int fd, PARCEventType which_event, void *metisStateVoid)
@@ -580,22 +905,31 @@ connector_Fwd_Metis_Dequeue(int fd, PARCEventType which_event, void *metisStateV
                parcDeque_Size(fwd_state->transportMessageQueue));
     }
 
+    if (fwd_state->demux != NULL) {
+        max_loops -= _releaseHeld(fwd_state, max_loops);
+    }
+
     while (max_loops > 0 && !parcDeque_IsEmpty(fwd_state->transportMessageQueue)) {
         max_loops--;
         TransportMessage *tm = parcDeque_RemoveFirst(fwd_state->transportMessageQueue);
 
         RtaConnection *conn = rtaConnection_GetFromTransport(tm);
-        RtaProtocolStack *stack = rtaConnection_GetStack(conn);
-        PARCEventQueue  *out = rtaProtocolStack_GetPutQueue(stack, FWD_METIS, RTA_UP);
-        RtaComponentStats *stats = rtaConnection_GetStats(conn, FWD_METIS);
-
-        if (rtaComponent_PutMessage(out, tm)) {
-            rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
+        if (fwd_state->demux != NULL) {
+            if (rtaConnection_BlockedUp(conn) || forwarderDemux_GetHeldCount(fwd_state->demux, conn) > 0) {
+                forwarderDemux_Hold(fwd_state->demux, conn, tm);
+                continue;
+            }
+        } else if (rtaConnection_BlockedUp(conn)) {
+            parcDeque_Prepend(fwd_state->transportMessageQueue, tm);
+            return;
         }
+
+        _putUpStack(tm);
     }
 
     // If there are still messages in there, re-schedule
-    if (!parcDeque_IsEmpty(fwd_state->transportMessageQueue)) {
+    if (!parcDeque_IsEmpty(fwd_state->transportMessageQueue) ||
+        (fwd_state->demux != NULL && _hasReleasableHeld(fwd_state))) {
         if (DEBUG_OUTPUT) {
             printf("%9d %s rescheduling output queue timer %p\n",
                    0,
@@ -606,18 +940,44 @@ connector_Fwd_Metis_Dequeue(int fd, PARCEventType which_event, void *metisStateV
         struct timeval immediateTimeout = { 0, 0 };
         parcEventTimer_Start(fwd_state->transportMessageQueueEvent, &immediateTimeout);
     }
+
+    _resumeReading(fwd_state);
 }
 
+/**
+ * Opens the capture file if the connection asks for one.  A capture that cannot be
+ * opened does not fail the connection.
+ */
+static void
+_openCapture(FwdMetisState *fwd_state, RtaConnection *conn)
+{
+    fwd_state->connectionId = rtaConnection_GetConnectionId(conn);
+
+    const char *capturePath = connectorCapture_GetPathFromConfig(rtaConnection_GetParameters(conn));
+    if (capturePath != NULL) {
+        fwd_state->capture = rtaCapture_Open(capturePath);
+        if (fwd_state->capture == NULL) {
+            fprintf(stderr, "%s connection %u could not open capture file %s: %s\n",
+                    __func__, fwd_state->connectionId, capturePath, strerror(errno));
+        }
+    }
+}
+
+static void _fwdMetisState_Release(FwdMetisState **fwdStatePtr);
+
 /**
  * Create a TCP socket
  * Set it non-blocking
  * Wrap it in a buffer event
  * Set Read and Event callbacks
  *
- * Return 0 success, -1 failure
+ * A shared socket gets its demux first, so its events are not tied to `conn`.
+ *
+ * @return non-null The state, connecting or connected
+ * @return null The socket could not be opened
  */
-static int
-connector_Fwd_Metis_Opener(RtaConnection *conn)
+static FwdMetisState *
+_openState(RtaConnection *conn, bool shared)
 {
     bool success = false;
 
@@ -625,13 +985,17 @@ connector_Fwd_Metis_Opener(RtaConnection *conn)
 
     PARCEventScheduler *scheduler = rtaFramework_GetEventScheduler(rtaConnection_GetFramework(conn));
     FwdMetisState *fwd_state = connector_Fwd_Metis_CreateConnectionState(scheduler);
+    fwd_state->stack = rtaConnection_GetStack(conn);
+    _readInTransport(fwd_state, rtaConnection_GetParameters(conn));
+    if (shared) {
+        fwd_state->demux = forwarderDemux_Create();
+    }
 
     if (_openSocket(fwd_state, port)) {
         if (_setupSocket(fwd_state)) {
             if (_setupSocketEvents(fwd_state, conn)) {
                 if (connector_Fwd_Metis_BeginConnect(fwd_state, conn)) {
-                    // stash it away in the per-connection cubby hole
-                    rtaConnection_SetPrivateData(conn, FWD_METIS, fwd_state);
+                    _openCapture(fwd_state, conn);
                     success = true;
                 }
             }
@@ -639,19 +1003,87 @@ connector_Fwd_Metis_Opener(RtaConnection *conn)
     }
 
     if (!success) {
-        if (fwd_state->fd) {
-            close(fwd_state->fd);
-        }
-        if (fwd_state->readEvent) {
-            parcEvent_Destroy(&(fwd_state->readEvent));
-        }
-        if (fwd_state->writeEvent) {
-            parcEvent_Destroy(&(fwd_state->writeEvent));
+        _fwdMetisState_Release(&fwd_state);
+    }
+
+    return fwd_state;
+}
+
+/**
+ * Drops one reference to a shared socket, the last one closes it
+ */
+static void
+_fwdMetisState_ReleaseShared(FwdMetisState **fwdStatePtr)
+{
+    FwdMetisState *fwd_state = *fwdStatePtr;
+    assertTrue(fwd_state->refCount > 0, "Releasing a shared socket with no references");
+
+    fwd_state->refCount--;
+    if (fwd_state->refCount == 0) {
+        _fwdMetisState_Release(&fwd_state);
+    }
+    *fwdStatePtr = NULL;
+}
+
+/**
+ * Attach the connection to the stack's shared socket, opening it if needed
+ *
+ * Once the socket is connected, this is a local operation and the connection
+ * is open as soon as it returns.
+ */
+static int
+_openShared(FwdMetisStackState *stackState, RtaConnection *conn)
+{
+    if (stackState->sharedState != NULL && stackState->sharedState->failed) {
+        // connections already on it keep it until they close
+        _fwdMetisState_ReleaseShared(&stackState->sharedState);
+    }
+
+    if (stackState->sharedState == NULL) {
+        stackState->sharedState = _openState(conn, true);
+        if (stackState->sharedState == NULL) {
+            return -1;
         }
-        parcMemory_Deallocate((void **) &fwd_state);
+        stackState->sharedState->refCount = 1;
+    }
+
+    FwdMetisState *fwd_state = stackState->sharedState;
+    fwd_state->refCount++;
+    forwarderDemux_AttachConnection(fwd_state->demux, conn);
+    rtaConnection_SetPrivateData(conn, FWD_METIS, fwd_state);
+
+    if (fwd_state->isConnected) {
+        rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, notifyStatusCode_CONNECTION_OPEN, NULL, NULL);
+    }
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s conn %p attached to shared fwd_state %p, %zu connections\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
+               __func__,
+               (void *) conn,
+               (void *) fwd_state,
+               forwarderDemux_GetConnectionCount(fwd_state->demux));
+    }
+
+    return 0;
+}
+
+static int
+connector_Fwd_Metis_Opener(RtaConnection *conn)
+{
+    FwdMetisStackState *stackState = rtaProtocolStack_GetPrivateData(rtaConnection_GetStack(conn), FWD_METIS);
+    if (stackState != NULL) {
+        return _openShared(stackState, conn);
+    }
+
+    FwdMetisState *fwd_state = _openState(conn, false);
+    if (fwd_state == NULL) {
         return -1;
     }
 
+    // stash it away in the per-connection cubby hole
+    rtaConnection_SetPrivateData(conn, FWD_METIS, fwd_state);
+
     // Socket will be ready for use once we get PARCEventQueue_Connected
     if (DEBUG_OUTPUT) {
         printf("%9" PRIu64 " %s open conn %p\n",
@@ -663,6 +1095,117 @@ connector_Fwd_Metis_Opener(RtaConnection *conn)
     return 0;
 }
 
+/**
+ * Send a decoded control packet up the connection in `data`
+ */
+static void
+_putControlMessage(PacketData *data, CCNxTlvDictionary *packetDictionary)
+{
+    TransportMessage *tm = transportMessage_CreateFromDictionary(packetDictionary);
+    transportMessage_SetInfo(tm, rtaConnection_Copy(data->conn), rtaConnection_FreeFunc);
+
+    // send it up the stack
+    if (rtaComponent_PutMessage(data->out, tm)) {
+        rtaComponentStats_Increment(data->stats, STATS_UPCALL_OUT);
+        data->fwd_state->stats.countUpcallWriteControlOk++;
+    } else {
+        data->fwd_state->stats.countUpcallWriteControlError++;
+    }
+}
+
+static void
+_routeBatch_Destroy(_FwdMetisRouteBatch **batchPtr)
+{
+    _FwdMetisRouteBatch *batch = *batchPtr;
+    ccnxTlvDictionary_Release(&batch->request);
+    parcMemory_Deallocate((void **) &batch->results);
+    parcMemory_Deallocate((void **) batchPtr);
+}
+
+/**
+ * Remember a batched route registration on its way to Metis
+ */
+static void
+_routeBatch_Add(FwdMetisState *fwd_state, RtaConnection *conn, CCNxTlvDictionary *request)
+{
+    _FwdMetisRouteBatch *batch = parcMemory_AllocateAndClear(sizeof(_FwdMetisRouteBatch));
+    assertNotNull(batch, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_FwdMetisRouteBatch));
+
+    batch->conn = conn;
+    batch->request = ccnxTlvDictionary_Acquire(request);
+    batch->firstSequenceNumber = cpi_GetSequenceNumber(request);
+    batch->count = cpiForwarding_RouteCountFromControlMessage(request);
+    batch->results = parcMemory_AllocateAndClear(batch->count * sizeof(bool) + 1);
+    assertNotNull(batch->results, "parcMemory_AllocateAndClear(%zu) returned NULL", batch->count * sizeof(bool) + 1);
+
+    TAILQ_INSERT_TAIL(&fwd_state->routeBatches, batch, list);
+}
+
+/**
+ * Drop the batches of a closing connection, or all of them if `conn` is NULL
+ */
+static void
+_routeBatch_DetachConnection(FwdMetisState *fwd_state, RtaConnection *conn)
+{
+    _FwdMetisRouteBatch *batch = TAILQ_FIRST(&fwd_state->routeBatches);
+    while (batch != NULL) {
+        _FwdMetisRouteBatch *next = TAILQ_NEXT(batch, list);
+        if (conn == NULL || batch->conn == conn) {
+            TAILQ_REMOVE(&fwd_state->routeBatches, batch, list);
+            _routeBatch_Destroy(&batch);
+        }
+        batch = next;
+    }
+}
+
+/**
+ * If a control packet acks a route of a pending batch, record it.  The last ack of a
+ * batch sends the batch's ack, with all the results, up the connection that sent it.
+ *
+ * @return true The packet was consumed
+ * @return false The packet is not part of a batch
+ */
+static bool
+_routeBatch_ReceiveAck(PacketData *data, CCNxTlvDictionary *packetDictionary)
+{
+    FwdMetisState *fwd_state = data->fwd_state;
+    if (TAILQ_EMPTY(&fwd_state->routeBatches) || !ccnxControlFacade_IsCPI(packetDictionary) ||
+        cpi_GetMessageType(packetDictionary) != CPI_ACK) {
+        return false;
+    }
+
+    uint64_t sequenceNumber = ccnxControl_GetAckOriginalSequenceNumber(packetDictionary);
+
+    _FwdMetisRouteBatch *batch;
+    TAILQ_FOREACH(batch, &fwd_state->routeBatches, list)
+    {
+        // unsigned, so a sequence number before the batch is out of range too
+        if (sequenceNumber - batch->firstSequenceNumber < batch->count) {
+            break;
+        }
+    }
+
+    if (batch == NULL) {
+        return false;
+    }
+
+    batch->results[sequenceNumber - batch->firstSequenceNumber] = ccnxControl_IsACK(packetDictionary);
+    batch->answered++;
+
+    if (batch->answered == batch->count) {
+        TAILQ_REMOVE(&fwd_state->routeBatches, batch, list);
+
+        CCNxTlvDictionary *ack = ccnxControl_CreateAckWithResults(batch->request, batch->count, batch->results);
+        data->conn = batch->conn;
+        data->stats = rtaConnection_GetStats(batch->conn, FWD_METIS);
+        _putControlMessage(data, ack);
+        ccnxTlvDictionary_Release(&ack);
+
+        _routeBatch_Destroy(&batch);
+    }
+    return true;
+}
+
 /**
  * We received a Metis control packet.  Translate it to a control packet and send it up the stack.
  */
@@ -675,15 +1218,8 @@ receiveControlMessage(PacketData *data)
     bool success = ccnxCodecTlvPacket_BufferDecode(data->fwd_state->nextMessage.packet, packetDictionary);
 
     if (success) {
-        TransportMessage *tm = transportMessage_CreateFromDictionary(packetDictionary);
-        transportMessage_SetInfo(tm, rtaConnection_Copy(data->conn), rtaConnection_FreeFunc);
-
-        // send it up the stack
-        if (rtaComponent_PutMessage(data->out, tm)) {
-            rtaComponentStats_Increment(data->stats, STATS_UPCALL_OUT);
-            data->fwd_state->stats.countUpcallWriteControlOk++;
-        } else {
-            data->fwd_state->stats.countUpcallWriteControlError++;
+        if (!_routeBatch_ReceiveAck(data, packetDictionary)) {
+            _putControlMessage(data, packetDictionary);
         }
     } else {
         assertTrue(success, "Error decoding a Metis control packet\n")
@@ -735,9 +1271,9 @@ _queueNonControl(PacketData *data)
 /**
  * Receive a non-control packet
  *
- * Non-control messages may be dropped due to lack of input buffer space.
- * If the connection has state Block Up or the up queue's length is
- * too many messages deep, the non-control message will be dropped.
+ * The packet is always queued.  Back pressure comes from _readFromMetis() not reading
+ * more once the queue is full and connector_Fwd_Metis_Dequeue() holding the packets of a
+ * blocked up connection, never from dropping here.
  *
  * precondition: the caller knows the message is not a control message
  *
@@ -758,27 +1294,16 @@ _receiveNonControl(PacketData *data)
     if (rtaConnection_BlockedUp(data->conn)) {
         data->fwd_state->stats.countUpcallWriteDataBlocked++;
         if (DEBUG_OUTPUT) {
-            printf("%9" PRIu64 " %s connection %u blocked up, drop wireFormat %p\n",
+            printf("%9" PRIu64 " %s connection %u blocked up, queue wireFormat %p\n",
                    rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(data->conn))),
                    __func__,
                    rtaConnection_GetConnectionId(data->conn),
                    (void *) data->fwd_state->nextMessage.packet);
         }
-    } else {
-        if (parcDeque_Size(data->fwd_state->transportMessageQueue) < METIS_INPUT_QUEUE_MESSAGES) {
-            _queueNonControl(data);
-            data->fwd_state->stats.countUpcallWriteDataOk++;
-        } else {
-            data->fwd_state->stats.countUpcallWriteDataQueueFull++;
-            if (DEBUG_OUTPUT) {
-                printf("%9" PRIu64 " %s connection %u input buffer full, drop wireFormat %p\n",
-                       rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(data->conn))),
-                       __func__,
-                       rtaConnection_GetConnectionId(data->conn),
-                       (void *) data->fwd_state->nextMessage.packet);
-            }
-        }
     }
+
+    _queueNonControl(data);
+    data->fwd_state->stats.countUpcallWriteDataOk++;
 }
 
 /**
@@ -798,6 +1323,229 @@ connector_Fwd_Metis_SendUpStack(PacketData *data)
     }
 }
 
+/**
+ * Send the packet in `data->fwd_state->nextMessage` up one connection of a shared socket
+ */
+static void
+_demuxNonControl(PacketData *data, RtaConnection *conn)
+{
+    data->conn = conn;
+    data->stats = rtaConnection_GetStats(conn, FWD_METIS);
+    rtaComponentStats_Increment(data->stats, STATS_UPCALL_IN);
+    _receiveNonControl(data);
+}
+
+/**
+ * The name of a received Interest, Content Object or InterestReturn
+ *
+ * Interests and Content Objects only need their name decoded.  An InterestReturn
+ * is decoded from a slice, so the packet going up the stack is not disturbed.
+ *
+ * @return non-null The name, release with `ccnxName_Release()`
+ * @return null The packet has no name or could not be decoded
+ */
+static CCNxName *
+_createPacketName(FwdMetisState *fwd_state)
+{
+    PARCBuffer *packet = fwd_state->nextMessage.packet;
+    CCNxName *name = NULL;
+
+    CodecTlvIndex *index = codecTlvIndex_Create(packet);
+    if (index != NULL) {
+        name = codecTlvIndex_CreateName(index, packet);
+        codecTlvIndex_Destroy(&index);
+    } else {
+        PARCBuffer *slice = parcBuffer_Slice(packet);
+        CCNxTlvDictionary *dictionary = ccnxWireFormatMessage_Create(slice);
+        if (dictionary != NULL) {
+            if (ccnxCodecTlvPacket_BufferDecode(slice, dictionary)) {
+                const CCNxName *decoded = ccnxInterest_GetName(dictionary);
+                if (decoded != NULL) {
+                    name = ccnxName_Acquire(decoded);
+                }
+            }
+            ccnxTlvDictionary_Release(&dictionary);
+        }
+        parcBuffer_Release(&slice);
+    }
+
+    return name;
+}
+
+/**
+ * Send a control packet from a shared socket up the connection that sent the request
+ *
+ * A control packet that answers no recorded request goes up every connection.
+ */
+static void
+_demuxControl(PacketData *data)
+{
+    FwdMetisState *fwd_state = data->fwd_state;
+    CCNxTlvDictionary *packetDictionary =
+        ccnxWireFormatMessage_FromControlPacketType(fwd_state->nextMessage.version, fwd_state->nextMessage.packet);
+
+    if (!ccnxCodecTlvPacket_BufferDecode(fwd_state->nextMessage.packet, packetDictionary)) {
+        fwd_state->stats.countUpcallWriteControlError++;
+        ccnxTlvDictionary_Release(&packetDictionary);
+        return;
+    }
+
+    if (_routeBatch_ReceiveAck(data, packetDictionary)) {
+        ccnxTlvDictionary_Release(&packetDictionary);
+        return;
+    }
+
+    RtaConnection *conn = NULL;
+    if (ccnxControlFacade_IsCPI(packetDictionary)) {
+        uint64_t sequenceNumber = cpi_GetMessageType(packetDictionary) == CPI_ACK ? ccnxControl_GetAckOriginalSequenceNumber(packetDictionary)
+                                  : cpi_GetSequenceNumber(packetDictionary);
+        conn = forwarderDemux_TakeControl(fwd_state->demux, sequenceNumber);
+    }
+
+    if (conn != NULL) {
+        data->conn = conn;
+        data->stats = rtaConnection_GetStats(conn, FWD_METIS);
+        rtaComponentStats_Increment(data->stats, STATS_UPCALL_IN);
+        _putControlMessage(data, packetDictionary);
+    } else {
+        size_t count = forwarderDemux_GetConnectionCount(fwd_state->demux);
+        for (size_t i = 0; i < count; i++) {
+            data->conn = forwarderDemux_GetConnection(fwd_state->demux, i);
+            data->stats = rtaConnection_GetStats(data->conn, FWD_METIS);
+            rtaComponentStats_Increment(data->stats, STATS_UPCALL_IN);
+            _putControlMessage(data, packetDictionary);
+        }
+    }
+
+    ccnxTlvDictionary_Release(&packetDictionary);
+}
+
+/**
+ * Send a packet from a shared socket up the connections it belongs to
+ *
+ * An Interest goes to the connection that registered the longest prefix of its name.
+ * A Content Object or InterestReturn goes to every connection waiting for its name.
+ * A packet no connection is waiting for is dropped.
+ */
+static void
+_demuxUpStack(FwdMetisState *fwd_state, RtaProtocolStack *stack)
+{
+    PacketData data = {
+        .fwd_state = fwd_state,
+        .conn      = NULL,
+        .out       = rtaProtocolStack_GetPutQueue(stack, FWD_METIS, RTA_UP),
+        .stats     = NULL,
+    };
+
+    if (fwd_state->nextMessage.packetType == PacketType_Control) {
+        _demuxControl(&data);
+        return;
+    }
+
+    bool matched = false;
+    CCNxName *name = _createPacketName(fwd_state);
+    if (name != NULL) {
+        if (fwd_state->nextMessage.packetType == PacketType_Interest) {
+            RtaConnection *conn = forwarderDemux_MatchPrefix(fwd_state->demux, name);
+            if (conn != NULL) {
+                _demuxNonControl(&data, conn);
+                matched = true;
+            }
+        } else {
+            ticks now = rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack));
+            RtaConnection *waiters[METIS_DEMUX_BATCH];
+            size_t count;
+            while ((count = forwarderDemux_TakeInterest(fwd_state->demux, name, now, waiters, METIS_DEMUX_BATCH)) > 0) {
+                for (size_t i = 0; i < count; i++) {
+                    _demuxNonControl(&data, waiters[i]);
+                }
+                matched = true;
+            }
+        }
+        ccnxName_Release(&name);
+    }
+
+    if (!matched) {
+        fwd_state->stats.countUpcallUnmatched++;
+        if (DEBUG_OUTPUT) {
+            printf("%9" PRIu64 " %s shared fwd_state %p no connection for packet type %d, dropped\n",
+                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+                   __func__,
+                   (void *) fwd_state,
+                   fwd_state->nextMessage.packetType);
+        }
+    }
+}
+
+/**
+ * Stops reading when the input queue is full
+ *
+ * What is left in the socket stays there, so Metis sees the back pressure.  We cannot
+ * know how many connections a shared socket's next packet goes to, so the queue may
+ * go over METIS_INPUT_QUEUE_MESSAGES by the waiters of the last packet read.
+ *
+ * A shared socket also stops when one connection holds METIS_DEMUX_HELD_MESSAGES in the
+ * demux.  We cannot stop reading for just that connection, so a connection that stays
+ * blocked up stalls the others rather than losing its packets.
+ *
+ * @param [in] fwd_state The socket being read
+ * @param [in] conn The connection to read again with, NULL for a shared socket
+ *
+ * @return true Stop reading, connector_Fwd_Metis_Dequeue() starts again
+ * @return false Read the next packet
+ */
+static bool
+_pauseReading(FwdMetisState *fwd_state, RtaConnection *conn)
+{
+    bool full = parcDeque_Size(fwd_state->transportMessageQueue) >= METIS_INPUT_QUEUE_MESSAGES;
+    if (!full && fwd_state->demux != NULL) {
+        full = forwarderDemux_GetMostHeld(fwd_state->demux) >= METIS_DEMUX_HELD_MESSAGES;
+    }
+
+    if (!full) {
+        return false;
+    }
+
+    if (DEBUG_OUTPUT) {
+        printf("%9" PRIu64 " %s fwd_state %p input queue full, stop reading\n",
+               rtaFramework_GetTicks(rtaProtocolStack_GetFramework(fwd_state->stack)),
+               __func__,
+               (void *) fwd_state);
+    }
+
+    fwd_state->stats.countUpcallWriteDataQueueFull++;
+    fwd_state->readPaused = true;
+    fwd_state->pausedConnection = conn;
+    return true;
+}
+
+/**
+ * recv() from the socket, or from the shared memory ring with MetisTransport_SharedMemory
+ *
+ * An empty ring returns -1 with errno EAGAIN, like an empty non-blocking socket.  A short
+ * read from the ring reads again until the ring is marked waiting for data, as the caller
+ * takes a short read to mean there is nothing more until the next read event.
+ */
+static ssize_t
+_recvFromMetis(FwdMetisState *fwd_state, void *buffer, size_t length)
+{
+    if (fwd_state->shmLink == NULL) {
+        return recv(fwd_state->fd, buffer, length, 0);
+    }
+
+    size_t nread = 0;
+    size_t chunk;
+    while (nread < length && (chunk = forwarderShmLink_Read(fwd_state->shmLink, (uint8_t *) buffer + nread, length - nread)) > 0) {
+        nread += chunk;
+    }
+
+    if (nread == 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return (ssize_t) nread;
+}
+
 /**
  * Return the SO_ERROR value for the given socket
  *
@@ -857,21 +1605,15 @@ _disconnectedEventHandler(FwdMetisState *fwd_state, RtaConnection *conn, PARCEve
             _connectionSucceeded(fwd_state, conn);
         } else {
             // error on connect
+            RtaProtocolStack *stack = (conn != NULL) ? rtaConnection_GetStack(conn) : fwd_state->stack;
             printf("%9" PRIu64 " %s Connection %p got error on SOCK_STREAM, fd %d: %s\n",
-                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
+                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
                    __func__,
                    (void *) conn,
                    fwd_state->fd,
                    strerror(errno));
 
-            // make the event non-pending
-            parcEvent_Stop(fwd_state->readEvent);
-            parcEvent_Stop(fwd_state->writeEvent);
-
-            rtaConnection_SetBlockedDown(conn);
-
-            // at least tell the API whats going on
-            rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, notifyStatusCode_FORWARDER_NOT_AVAILABLE, NULL, NULL);
+            _connectionFailed(fwd_state, conn);
         }
     }
 
@@ -991,7 +1733,7 @@ _readPacketHeader(FwdMetisState *fwd_state)
     ReadReturnCode returnCode = ReadReturnCode_Error;
 
     // This could be switched to MSG_PEEK instead of copying later, but I don't think it makes any significant change.
-    ssize_t nread = recv(fwd_state->fd, fwd_state->nextMessage.readLocation, fwd_state->nextMessage.remainingReadLength, 0);
+    ssize_t nread = _recvFromMetis(fwd_state, fwd_state->nextMessage.readLocation, fwd_state->nextMessage.remainingReadLength);
     if (nread > 0) {
         // recv will always runturn at most fwd_state->nextMessage.remainingReadLength, so this won't wrap around to negative.
         fwd_state->nextMessage.remainingReadLength -= nread;
@@ -1065,7 +1807,7 @@ _readPacketBody(FwdMetisState *fwd_state)
     }
 
     void *overlay = parcBuffer_Overlay(fwd_state->nextMessage.packet, 0);
-    ssize_t nread = recv(fwd_state->fd, overlay, remaining, 0);
+    ssize_t nread = _recvFromMetis(fwd_state, overlay, remaining);
 
     if (nread > 0) {
         // good read
@@ -1168,37 +1910,70 @@ _readPacket(FwdMetisState *fwd_state)
 static void
 _readFromMetis(FwdMetisState *fwd_state, RtaConnection *conn)
 {
-    RtaProtocolStack *stack = rtaConnection_GetStack(conn);
-    RtaComponentStats *stats = rtaConnection_GetStats(conn, FWD_METIS);
+    // A shared socket has no connection until it demultiplexes each packet
+    RtaProtocolStack *stack = (conn != NULL) ? rtaConnection_GetStack(conn) : fwd_state->stack;
+    RtaComponentStats *stats = (conn != NULL) ? rtaConnection_GetStats(conn, FWD_METIS) : NULL;
+
+    ReadReturnCode readCode = ReadReturnCode_Finished;
+    if (fwd_state->shmLink != NULL) {
+        // Take the doorbells before looking at the ring, so a doorbell rung after we find
+        // the ring empty is still there for the next read event
+        if (forwarderShmLink_DrainDoorbell(fwd_state->fd) < 0) {
+            readCode = ReadReturnCode_Closed;
+        }
+    }
 
-    ReadReturnCode readCode;
-    while ((readCode = _readPacket(fwd_state)) == ReadReturnCode_Finished) {
-        rtaComponentStats_Increment(stats, STATS_UPCALL_IN);
+    while (readCode == ReadReturnCode_Finished && !_pauseReading(fwd_state, conn) &&
+           (readCode = _readPacket(fwd_state)) == ReadReturnCode_Finished) {
+        if (stats != NULL) {
+            rtaComponentStats_Increment(stats, STATS_UPCALL_IN);
+        }
         fwd_state->stats.countUpcallReads++;
 
         // setup the buffer for reading
         parcBuffer_Flip(fwd_state->nextMessage.packet);
 
+        if (fwd_state->capture != NULL) {
+            rtaCapture_WriteBuffer(fwd_state->capture, fwd_state->connectionId, RtaCaptureDirection_Up, fwd_state->nextMessage.packet);
+        }
+
         if (DEBUG_OUTPUT) {
             printf("%9" PRIu64 " %s sending packet buffer %p up stack length %zu\n",
-                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
+                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
                    __func__,
                    (void *) fwd_state->nextMessage.packet,
                    parcBuffer_Remaining(fwd_state->nextMessage.packet));
         }
 
-        // this is just to make the signature of connector_Fwd_Metis_SendUpStack tractable, PacketData
-        // is not exposed outside this scope.
-
-        PARCEventQueue  *out = rtaProtocolStack_GetPutQueue(stack, FWD_METIS, RTA_UP);
-        PacketData data = {
-            .fwd_state = fwd_state,
-            .conn      = conn,
-            .out       = out,
-            .stats     = stats,
-        };
-
-        connector_Fwd_Metis_SendUpStack(&data);
+        // Reject a malformed packet here, before anything up the stack allocates a
+        // dictionary for it or trusts one of its lengths.
+        CodecValidatorResult valid = codecValidator_Validate(parcBuffer_Overlay(fwd_state->nextMessage.packet, 0),
+                                                             parcBuffer_Remaining(fwd_state->nextMessage.packet));
+        if (valid == CodecValidatorResult_Ok && fwd_state->demux != NULL) {
+            _demuxUpStack(fwd_state, stack);
+        } else if (valid == CodecValidatorResult_Ok) {
+            // this is just to make the signature of connector_Fwd_Metis_SendUpStack tractable, PacketData
+            // is not exposed outside this scope.
+
+            PARCEventQueue  *out = rtaProtocolStack_GetPutQueue(stack, FWD_METIS, RTA_UP);
+            PacketData data = {
+                .fwd_state = fwd_state,
+                .conn      = conn,
+                .out       = out,
+                .stats     = stats,
+            };
+
+            connector_Fwd_Metis_SendUpStack(&data);
+        } else {
+            fwd_state->stats.countUpcallMalformed++;
+            if (DEBUG_OUTPUT) {
+                printf("%9" PRIu64 " %s dropping malformed packet length %zu: %s\n",
+                       rtaFramework_GetTicks(rtaProtocolStack_GetFramework(stack)),
+                       __func__,
+                       parcBuffer_Remaining(fwd_state->nextMessage.packet),
+                       codecValidator_ResultToString(valid));
+            }
+        }
 
         // done with the packet buffer.  Release our hold on it.  If it was sent up the stack
         // another reference count was made.
@@ -1208,19 +1983,28 @@ _readFromMetis(FwdMetisState *fwd_state, RtaConnection *conn)
         _initializeNextMessage(&fwd_state->nextMessage);
     }
 
+    if (fwd_state->shmLink != NULL && readCode == ReadReturnCode_PartialRead) {
+        // tell Metis if it waits for the space we just read
+        if (!forwarderShmLink_Notify(fwd_state->shmLink, fwd_state->fd)) {
+            readCode = ReadReturnCode_Error;
+        }
+    }
+
     if (readCode == ReadReturnCode_Closed) {
         fwd_state->isConnected = false;
+        fwd_state->failed = true;
         parcEvent_Stop(fwd_state->readEvent);
         parcEvent_Stop(fwd_state->writeEvent);
-        rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, notifyStatusCode_CONNECTION_CLOSED, NULL, "Socket operation returned closed by remote");
+        _sendStatus(fwd_state, conn, notifyStatusCode_CONNECTION_CLOSED, "Socket operation returned closed by remote");
     } else if (readCode == ReadReturnCode_Error) {
         fwd_state->isConnected = false;
+        fwd_state->failed = true;
         parcEvent_Stop(fwd_state->readEvent);
         parcEvent_Stop(fwd_state->writeEvent);
-        rtaConnection_SendStatus(conn, FWD_METIS, RTA_UP, notifyStatusCode_CONNECTION_CLOSED, NULL, "Socket operation returned error");
+        _sendStatus(fwd_state, conn, notifyStatusCode_CONNECTION_CLOSED, "Socket operation returned error");
     }
 
-    if (DEBUG_OUTPUT) {
+    if (DEBUG_OUTPUT && stats != NULL) {
         printf("%9" PRIu64 " %s total upcall reads in %" PRIu64 " out %" PRIu64 "\n",
                rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
                __func__,
@@ -1283,11 +2067,47 @@ _queueBufferMessageToMetis(PARCBuffer *wireFormat, PARCEventBuffer *fwd_output)
     }
 }
 
+/**
+ * Moves as much of the output queue as fits into the shared memory ring
+ *
+ * A full ring is marked waiting for space, and Metis rings the doorbell when it reads
+ * from it.  The doorbell is a read event, so the write event is not used.
+ */
+static void
+_dequeueMessagesToShmLink(FwdMetisState *fwdConnState)
+{
+    size_t length;
+    while ((length = parcEventBuffer_GetLength(fwdConnState->metisOutputQueue)) > 0) {
+        void *span;
+        size_t spanLength = forwarderShmLink_WriteSpan(fwdConnState->shmLink, &span);
+        if (spanLength == 0) {
+            break;
+        }
+
+        int nread = parcEventBuffer_Read(fwdConnState->metisOutputQueue, span, (length < spanLength) ? length : spanLength);
+        assertTrue(nread > 0, "parcEventBuffer_Read returned %d", nread);
+        forwarderShmLink_WriteCommit(fwdConnState->shmLink, nread);
+        fwdConnState->stats.countDowncallWrites++;
+    }
+
+    parcEvent_Stop(fwdConnState->writeEvent);
+    forwarderShmLink_Notify(fwdConnState->shmLink, fwdConnState->fd);
+
+    if (DEBUG_OUTPUT) {
+        printf("%9c %s wrote to shared memory on socket %d, %zu bytes remaining\n",
+               ' ',
+               __func__,
+               fwdConnState->fd,
+               parcEventBuffer_GetLength(fwdConnState->metisOutputQueue));
+    }
+}
+
 /**
  * Write as much as possible from the output buffer to metis
  *
  * Write as much as we can to metis.  If there is nothing left, deactivate the write event.
  * If there is still bytes left in the output buffer, activate the write event.
+ * With a shared memory link, the buffer goes to the ring instead.
  *
  * postconditions:
  * - Write as many bytes as possible from the output buffer to metis
@@ -1306,6 +2126,11 @@ _queueBufferMessageToMetis(PARCBuffer *wireFormat, PARCEventBuffer *fwd_output)
 static void
 _dequeueMessagesToMetis(FwdMetisState *fwdConnState)
 {
+    if (fwdConnState->shmLink != NULL) {
+        _dequeueMessagesToShmLink(fwdConnState);
+        return;
+    }
+
     // if we try to write a 0 length buffer, write will return -1 like an error
     if (parcEventBuffer_GetLength(fwdConnState->metisOutputQueue) > 0) {
         fwdConnState->stats.countDowncallWrites++;
@@ -1365,7 +2190,8 @@ _connectedEventHandler(FwdMetisState *fwd_state, RtaConnection *conn, short what
         _readFromMetis(fwd_state, conn);
     }
 
-    if (what & PARCEventType_Write) {
+    // with shared memory, a doorbell may also mean Metis made space in our ring
+    if ((what & PARCEventType_Write) || (fwd_state->shmLink != NULL && fwd_state->isConnected)) {
         _dequeueMessagesToMetis(fwd_state);
     }
 }
@@ -1390,6 +2216,24 @@ _eventCallback(int fd, PARCEventType what, void *connectionVoid)
     }
 }
 
+/**
+ * Called for any activity on a socket shared by all the connections in a stack.
+ * Received packets are demultiplexed to their connections in _readFromMetis().
+ */
+static void
+_sharedEventCallback(int fd, PARCEventType what, void *metisStateVoid)
+{
+    FwdMetisState *fwd_state = (FwdMetisState *) metisStateVoid;
+
+    if (!fwd_state->isConnected) {
+        _disconnectedEventHandler(fwd_state, NULL, what);
+    }
+
+    if (fwd_state->isConnected) {
+        _connectedEventHandler(fwd_state, NULL, what);
+    }
+}
+
 /**
  * Updates the connections's Blocked Down state
  *
@@ -1444,11 +2288,20 @@ connector_Fwd_Metis_Downcall_HandleConnected(FwdMetisState *fwdConnState, Transp
     if (vec != NULL) {
         _queueIoVecMessageToMetis(vec, fwdConnState->metisOutputQueue);
         queued = true;
+
+        if (fwdConnState->capture != NULL) {
+            rtaCapture_WriteIoVec(fwdConnState->capture, fwdConnState->connectionId, RtaCaptureDirection_Down,
+                                  ccnxCodecNetworkBufferIoVec_GetCount(vec), ccnxCodecNetworkBufferIoVec_GetArray(vec));
+        }
     } else {
         PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(dictionary);
         if (wireFormat != NULL) {
             _queueBufferMessageToMetis(wireFormat, fwdConnState->metisOutputQueue);
             queued = true;
+
+            if (fwdConnState->capture != NULL) {
+                rtaCapture_WriteBuffer(fwdConnState->capture, fwdConnState->connectionId, RtaCaptureDirection_Down, wireFormat);
+            }
         }
     }
 
@@ -1475,14 +2328,13 @@ connector_Fwd_Metis_Downcall_HandleConnected(FwdMetisState *fwdConnState, Transp
 }
 
 static void
-_ackRequest(RtaConnection *conn, PARCJSON *request)
+_ackRequest(RtaConnection *conn, CCNxTlvDictionary *request)
 {
-    PARCJSON *response = cpiAcks_CreateAck(request);
-    CCNxTlvDictionary *ackDict = ccnxControlFacade_CreateCPI(response);
+    // the ack has the encoding of the request, JSON or binary
+    CCNxTlvDictionary *ackDict = ccnxControl_CreateAck(request);
 
     TransportMessage *tm_ack = transportMessage_CreateFromDictionary(ackDict);
     ccnxTlvDictionary_Release(&ackDict);
-    parcJSON_Release(&response);
 
     transportMessage_SetInfo(tm_ack, rtaConnection_Copy(conn), rtaConnection_FreeFunc);
 
@@ -1502,9 +2354,9 @@ _handleDownControl(FwdMetisState *fwdConnState, RtaConnection *conn, TransportMe
     CCNxTlvDictionary *dict = transportMessage_GetDictionary(tm);
     if (ccnxTlvDictionary_IsControl(dict)) {
         if (ccnxControlFacade_IsCPI(dict)) {
-            PARCJSON *json = ccnxControlFacade_GetJson(dict);
-            if (controlPlaneInterface_GetCPIMessageType(json) == CPI_REQUEST) {
-                if (cpi_getCPIOperation2(json) == CPI_PAUSE) {
+            if (cpi_GetMessageType(dict) == CPI_REQUEST) {
+                CpiOperation operation = cpi_GetMessageOperation(dict);
+                if (operation == CPI_PAUSE) {
                     // need to pause the input (case 897)
                     if (DEBUG_OUTPUT) {
                         printf("%9" PRIu64 " %s conn %p recieved PAUSE\n",
@@ -1512,18 +2364,24 @@ _handleDownControl(FwdMetisState *fwdConnState, RtaConnection *conn, TransportMe
                                __func__,
                                (void *) conn);
                     }
-                    _ackRequest(conn, json);
+                    _ackRequest(conn, dict);
                     consumedMessage = true;
                 }
 
-                if (cpi_getCPIOperation2(json) == CPI_FLUSH) {
+                if (operation == CPI_REGISTER_PREFIXES && cpiForwarding_RouteCountFromControlMessage(dict) == 0) {
+                    // nothing for Metis to answer
+                    _ackRequest(conn, dict);
+                    consumedMessage = true;
+                }
+
+                if (operation == CPI_FLUSH) {
                     if (DEBUG_OUTPUT) {
                         printf("%9" PRIu64 " %s conn %p recieved FLUSH\n",
                                rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
                                __func__,
                                (void *) conn);
                     }
-                    _ackRequest(conn, json);
+                    _ackRequest(conn, dict);
                     consumedMessage = true;
                 }
             }
@@ -1537,6 +2395,62 @@ _handleDownControl(FwdMetisState *fwdConnState, RtaConnection *conn, TransportMe
     return consumedMessage;
 }
 
+/**
+ * Record what a connection sends down a shared socket, so the answers find their way back
+ *
+ * Interests are remembered until their lifetime expires, CPI requests until acked.
+ * Prefix registrations are remembered per connection.  An unregister is only sent
+ * to Metis when no other connection still has the prefix registered, otherwise it
+ * is acked here.
+ *
+ * @return true The message was consumed
+ * @return false The message should go on to Metis
+ */
+static bool
+_demuxDown(FwdMetisState *fwd_state, RtaConnection *conn, TransportMessage *tm)
+{
+    bool consumedMessage = false;
+    CCNxTlvDictionary *dict = transportMessage_GetDictionary(tm);
+
+    if (ccnxTlvDictionary_IsInterest(dict)) {
+        RtaFramework *framework = rtaProtocolStack_GetFramework(fwd_state->stack);
+        ticks now = rtaFramework_GetTicks(framework);
+        ticks expiryTime = now + rtaFramework_MsecToTicks(ccnxInterest_GetLifetime(dict));
+        forwarderDemux_AddInterest(fwd_state->demux, ccnxInterest_GetName(dict), conn, expiryTime, now);
+    } else if (ccnxTlvDictionary_IsControl(dict) && ccnxControlFacade_IsCPI(dict)) {
+        if (cpi_GetMessageType(dict) == CPI_REQUEST) {
+            CpiOperation op = cpi_GetMessageOperation(dict);
+            if (op == CPI_REGISTER_PREFIX || op == CPI_UNREGISTER_PREFIX) {
+                CPIRouteEntry *route = cpiForwarding_RouteFromControlMessage(dict);
+                if (route != NULL) {
+                    if (op == CPI_REGISTER_PREFIX) {
+                        forwarderDemux_AddPrefix(fwd_state->demux, cpiRouteEntry_GetPrefix(route), conn);
+                    } else if (!forwarderDemux_RemovePrefix(fwd_state->demux, cpiRouteEntry_GetPrefix(route), conn)) {
+                        _ackRequest(conn, dict);
+                        consumedMessage = true;
+                    }
+                    cpiRouteEntry_Destroy(&route);
+                }
+            }
+
+            if (op == CPI_REGISTER_PREFIXES) {
+                // the acks of a batch are collected by _routeBatch_ReceiveAck(), not the demux
+                CPIRouteEntryList *routes = cpiForwarding_RoutesFromControlMessage(dict);
+                for (size_t i = 0; i < cpiRouteEntryList_Length(routes); i++) {
+                    CPIRouteEntry *route = cpiRouteEntryList_Get(routes, i);
+                    forwarderDemux_AddPrefix(fwd_state->demux, cpiRouteEntry_GetPrefix(route), conn);
+                    cpiRouteEntry_Destroy(&route);
+                }
+                cpiRouteEntryList_Destroy(&routes);
+            } else if (!consumedMessage) {
+                forwarderDemux_AddControl(fwd_state->demux, cpi_GetSequenceNumber(dict), conn);
+            }
+        }
+    }
+
+    return consumedMessage;
+}
+
 /**
  * send raw packet from codec to forwarder.  We are passed the ProtocolStack on the ptr.
  */
@@ -1553,10 +2467,20 @@ connector_Fwd_Metis_Downcall_Read(PARCEventQueue *in, PARCEventType event, void
         fwdConnState->stats.countDowncallReads++;
 
         bool consumedControl = _handleDownControl(fwdConnState, conn, tm);
+        if (!consumedControl && fwdConnState->demux != NULL) {
+            consumedControl = _demuxDown(fwdConnState, conn, tm);
+        }
+
         if (!consumedControl) {
             // we did not consume the message as a control packet for the metis connector
 
             if (fwdConnState->isConnected) {
+                CCNxTlvDictionary *dict = transportMessage_GetDictionary(tm);
+                if (ccnxTlvDictionary_IsControl(dict) && ccnxControlFacade_IsCPI(dict) &&
+                    cpi_GetMessageType(dict) == CPI_REQUEST && cpi_GetMessageOperation(dict) == CPI_REGISTER_PREFIXES) {
+                    _routeBatch_Add(fwdConnState, conn, dict);
+                }
+
                 // If the socket is connected, this will "do the right thing" and consume the transport message.
                 connector_Fwd_Metis_Downcall_HandleConnected(fwdConnState, tm, conn, stats);
             } else {
@@ -1607,6 +2531,8 @@ _fwdMetisState_Release(FwdMetisState **fwdStatePtr)
 
     parcDeque_Release(&fwd_state->transportMessageQueue);
 
+    _routeBatch_DetachConnection(fwd_state, NULL);
+
     if (fwd_state->readEvent) {
         parcEvent_Destroy(&(fwd_state->readEvent));
     }
@@ -1625,7 +2551,25 @@ _fwdMetisState_Release(FwdMetisState **fwdStatePtr)
         parcBuffer_Release(&fwd_state->nextMessage.packet);
     }
 
-    close(fwd_state->fd);
+    if (fwd_state->capture) {
+        rtaCapture_Close(&fwd_state->capture);
+    }
+
+    if (fwd_state->demux) {
+        forwarderDemux_Destroy(&fwd_state->demux);
+    }
+
+    if (fwd_state->shmLink) {
+        forwarderShmLink_Destroy(&fwd_state->shmLink);
+    }
+
+    if (fwd_state->path) {
+        parcMemory_Deallocate((void **) &fwd_state->path);
+    }
+
+    if (fwd_state->fd > 0) {
+        close(fwd_state->fd);
+    }
 
     parcMemory_Deallocate((void **) &fwd_state);
     *fwdStatePtr = NULL;
@@ -1652,13 +2596,14 @@ connector_Fwd_Metis_Closer(RtaConnection *conn)
                (void *) fwd_state,
                parcDeque_Size(fwd_state->transportMessageQueue));
 
-        printf("%9" PRIu64 " %s closed fwd_state %p stats: up { reads %u wok %u werr %u wblk %u wfull %u wctrlok %u wctrlerr %u }\n",
+        printf("%9" PRIu64 " %s closed fwd_state %p stats: up { reads %u wok %u werr %u wblk %u wfull %u wctrlok %u wctrlerr %u malformed %u }\n",
                rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
                __func__,
                (void *) fwd_state,
                fwd_state->stats.countUpcallReads, fwd_state->stats.countUpcallWriteDataOk, fwd_state->stats.countUpcallWriteDataError,
                fwd_state->stats.countUpcallWriteDataBlocked, fwd_state->stats.countUpcallWriteDataQueueFull,
-               fwd_state->stats.countUpcallWriteControlOk, fwd_state->stats.countUpcallWriteControlError);
+               fwd_state->stats.countUpcallWriteControlOk, fwd_state->stats.countUpcallWriteControlError,
+               fwd_state->stats.countUpcallMalformed);
 
         printf("%9" PRIu64 " %s closed fwd_state %p stats: dn { reads %u wok %u wctrlok %u }\n",
                rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
@@ -1667,7 +2612,31 @@ connector_Fwd_Metis_Closer(RtaConnection *conn)
                fwd_state->stats.countDowncallReads, fwd_state->stats.countDowncallWrites, fwd_state->stats.countDowncallControl);
     }
 
-    _fwdMetisState_Release(&fwd_state);
+    if (fwd_state->demux != NULL) {
+        // Other connections keep using the socket, so only drop what this connection left behind
+        forwarderDemux_DetachConnection(fwd_state->demux, conn);
+        _routeBatch_DetachConnection(fwd_state, conn);
+
+        size_t length = parcDeque_Size(fwd_state->transportMessageQueue);
+        for (size_t i = 0; i < length; i++) {
+            TransportMessage *tm = parcDeque_RemoveFirst(fwd_state->transportMessageQueue);
+            if (rtaConnection_GetFromTransport(tm) == conn) {
+                transportMessage_Destroy(&tm);
+            } else {
+                parcDeque_Append(fwd_state->transportMessageQueue, tm);
+            }
+        }
+
+        // the packets it held may have stopped the socket for everyone else
+        if (fwd_state->readPaused) {
+            struct timeval immediateTimeout = { 0, 0 };
+            parcEventTimer_Start(fwd_state->transportMessageQueueEvent, &immediateTimeout);
+        }
+
+        _fwdMetisState_ReleaseShared(&fwd_state);
+    } else {
+        _fwdMetisState_Release(&fwd_state);
+    }
 
     return 0;
 }
@@ -1676,6 +2645,14 @@ static int
 connector_Fwd_Metis_Release(RtaProtocolStack *stack)
 {
     // connector_Fwd_Metis_Init sets up some signal handlers, so we should un-do that (case 902).
+    FwdMetisStackState *stackState = rtaProtocolStack_GetPrivateData(stack, FWD_METIS);
+    if (stackState != NULL) {
+        rtaProtocolStack_SetPrivateData(stack, FWD_METIS, NULL);
+        if (stackState->sharedState != NULL) {
+            _fwdMetisState_ReleaseShared(&stackState->sharedState);
+        }
+        parcMemory_Deallocate((void **) &stackState);
+    }
     return 0;
 }
 
@@ -1684,7 +2661,7 @@ connector_Fwd_Metis_Release(RtaProtocolStack *stack)
  *
  * If we receive a Blocked Up state change and the read event is pending, make it
  * not pending.  If we receive a not blocked up state change and the read event is not
- * pending, make it pending.
+ * pending, make it pending and send up the packets that waited in our input queue.
  *
  * @param [<#in#> | <#out#> | <#in,out#>] <#name#> <#description#>
  *
@@ -1700,6 +2677,17 @@ connector_Fwd_Metis_StateChange(RtaConnection *conn)
 {
     struct fwd_metis_state *fwd_state = rtaConnection_GetPrivateData(conn, FWD_METIS);
 
+    // A shared socket keeps reading for the other connections.  The packets of a blocked
+    // up connection are held in the demux, connector_Fwd_Metis_Dequeue() sends them up
+    // once it unblocks.
+    if (fwd_state->demux != NULL) {
+        if (!rtaConnection_BlockedUp(conn) && forwarderDemux_GetHeldCount(fwd_state->demux, conn) > 0) {
+            struct timeval immediateTimeout = { 0, 0 };
+            parcEventTimer_Start(fwd_state->transportMessageQueueEvent, &immediateTimeout);
+        }
+        return;
+    }
+
     int isReadPending = parcEvent_Poll(fwd_state->readEvent, PARCEventType_Read);
 
 
@@ -1726,6 +2714,13 @@ connector_Fwd_Metis_StateChange(RtaConnection *conn)
             }
             parcEvent_Start(fwd_state->readEvent);
         }
+
+        // connector_Fwd_Metis_Dequeue() stopped at this connection's packets, it
+        // reads the socket again once they are sent up
+        if (!parcDeque_IsEmpty(fwd_state->transportMessageQueue)) {
+            struct timeval immediateTimeout = { 0, 0 };
+            parcEventTimer_Start(fwd_state->transportMessageQueueEvent, &immediateTimeout);
+        }
     }
 
     // We do not need to do anything with DOWN direction, becasue we're the component sending
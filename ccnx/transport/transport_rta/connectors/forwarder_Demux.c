@@ -0,0 +1,634 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/queue.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Deque.h>
+
+#include "forwarder_Demux.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+#define MIN_BUCKETS 64
+#define MIN_CONNECTIONS 16
+
+typedef struct demux_interest {
+    uint64_t nameHash;
+    CCNxName *name;
+    RtaConnection *conn;
+    uint64_t expiryTime;
+
+    LIST_ENTRY(demux_interest) bucketList;
+    TAILQ_ENTRY(demux_interest) expiryList;
+} DemuxInterest;
+
+typedef struct demux_prefix {
+    uint64_t prefixHash;
+    size_t segmentCount;
+    CCNxName *prefix;
+    RtaConnection *conn;
+
+    // the number of times conn registered the prefix
+    unsigned registrations;
+
+    TAILQ_ENTRY(demux_prefix) list;
+} DemuxPrefix;
+
+typedef struct demux_control {
+    uint64_t sequenceNumber;
+    RtaConnection *conn;
+
+    LIST_ENTRY(demux_control) list;
+} DemuxControl;
+
+typedef struct demux_connection {
+    RtaConnection *conn;
+
+    // TransportMessages held while conn is blocked up, oldest first
+    PARCDeque *held;
+} DemuxConnection;
+
+LIST_HEAD(demux_bucket, demux_interest);
+
+struct forwarder_demux {
+    DemuxConnection *connections;
+    size_t connectionCount;
+    size_t connectionCapacity;
+
+    // bucketCount is a power of 2
+    size_t bucketCount;
+    struct demux_bucket *buckets;
+    size_t interestCount;
+
+    // ordered by expiryTime, head expires first
+    TAILQ_HEAD(demux_expiry, demux_interest) expiryHead;
+
+    // in registration order, so the first connection to register a prefix wins ties
+    TAILQ_HEAD(demux_prefixes, demux_prefix) prefixHead;
+    size_t longestPrefix;
+
+    LIST_HEAD(demux_controls, demux_control) controlHead;
+};
+
+// ==================
+// Pending Interests
+
+static struct demux_bucket *
+_forwarderDemux_AllocateBuckets(size_t bucketCount)
+{
+    struct demux_bucket *buckets = parcMemory_Allocate(bucketCount * sizeof(struct demux_bucket));
+    assertNotNull(buckets, "parcMemory_Allocate(%zu) returned NULL", bucketCount * sizeof(struct demux_bucket));
+
+    for (size_t i = 0; i < bucketCount; i++) {
+        LIST_INIT(&buckets[i]);
+    }
+    return buckets;
+}
+
+static struct demux_bucket *
+_forwarderDemux_GetBucket(const ForwarderDemux *demux, uint64_t nameHash)
+{
+    return &demux->buckets[nameHash & (demux->bucketCount - 1)];
+}
+
+/**
+ * Doubles the bucket array once the chains average more than two Interests.  Every
+ * Interest is on the expiry list, so walk that to rehash.
+ */
+static void
+_forwarderDemux_Grow(ForwarderDemux *demux)
+{
+    if (demux->interestCount <= 2 * demux->bucketCount) {
+        return;
+    }
+
+    parcMemory_Deallocate((void **) &demux->buckets);
+    demux->bucketCount *= 2;
+    demux->buckets = _forwarderDemux_AllocateBuckets(demux->bucketCount);
+
+    DemuxInterest *entry;
+    TAILQ_FOREACH(entry, &demux->expiryHead, expiryList)
+    {
+        LIST_INSERT_HEAD(_forwarderDemux_GetBucket(demux, entry->nameHash), entry, bucketList);
+    }
+
+    if (DEBUG_OUTPUT) {
+        printf("%s demux %p grew to %zu buckets for %zu interests\n",
+               __func__, (void *) demux, demux->bucketCount, demux->interestCount);
+    }
+}
+
+/**
+ * Insert the entry on the expiry list.  Lifetimes are usually similar, so
+ * search from the tail.
+ */
+static void
+_forwarderDemux_InsertExpiry(ForwarderDemux *demux, DemuxInterest *entry)
+{
+    DemuxInterest *prev = TAILQ_LAST(&demux->expiryHead, demux_expiry);
+    while (prev != NULL && prev->expiryTime > entry->expiryTime) {
+        prev = TAILQ_PREV(prev, demux_expiry, expiryList);
+    }
+
+    if (prev == NULL) {
+        TAILQ_INSERT_HEAD(&demux->expiryHead, entry, expiryList);
+    } else {
+        TAILQ_INSERT_AFTER(&demux->expiryHead, prev, entry, expiryList);
+    }
+}
+
+static void
+_forwarderDemux_RemoveInterest(ForwarderDemux *demux, DemuxInterest *entry)
+{
+    LIST_REMOVE(entry, bucketList);
+    TAILQ_REMOVE(&demux->expiryHead, entry, expiryList);
+    demux->interestCount--;
+
+    ccnxName_Release(&entry->name);
+    parcMemory_Deallocate((void **) &entry);
+}
+
+static void
+_forwarderDemux_RemoveExpired(ForwarderDemux *demux, uint64_t now)
+{
+    DemuxInterest *entry;
+    while ((entry = TAILQ_FIRST(&demux->expiryHead)) != NULL && entry->expiryTime < now) {
+        _forwarderDemux_RemoveInterest(demux, entry);
+    }
+}
+
+void
+forwarderDemux_AddInterest(ForwarderDemux *demux, const CCNxName *name, RtaConnection *conn, uint64_t expiryTime, uint64_t now)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(name, "Parameter name must be non-null");
+    assertNotNull(conn, "Parameter conn must be non-null");
+
+    _forwarderDemux_RemoveExpired(demux, now);
+
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct demux_bucket *bucket = _forwarderDemux_GetBucket(demux, nameHash);
+
+    DemuxInterest *entry;
+    LIST_FOREACH(entry, bucket, bucketList)
+    {
+        if (entry->conn == conn && entry->nameHash == nameHash && ccnxName_Equals(entry->name, name)) {
+            if (expiryTime > entry->expiryTime) {
+                entry->expiryTime = expiryTime;
+                TAILQ_REMOVE(&demux->expiryHead, entry, expiryList);
+                _forwarderDemux_InsertExpiry(demux, entry);
+            }
+            return;
+        }
+    }
+
+    entry = parcMemory_AllocateAndClear(sizeof(DemuxInterest));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(DemuxInterest));
+
+    entry->nameHash = nameHash;
+    entry->name = ccnxName_Acquire(name);
+    entry->conn = conn;
+    entry->expiryTime = expiryTime;
+
+    LIST_INSERT_HEAD(bucket, entry, bucketList);
+    _forwarderDemux_InsertExpiry(demux, entry);
+    demux->interestCount++;
+
+    _forwarderDemux_Grow(demux);
+}
+
+size_t
+forwarderDemux_TakeInterest(ForwarderDemux *demux, const CCNxName *name, uint64_t now,
+                            RtaConnection **connections, size_t maxConnections)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(name, "Parameter name must be non-null");
+    assertNotNull(connections, "Parameter connections must be non-null");
+
+    uint64_t nameHash = ccnxName_HashCode(name);
+    struct demux_bucket *bucket = _forwarderDemux_GetBucket(demux, nameHash);
+
+    size_t count = 0;
+    DemuxInterest *entry = LIST_FIRST(bucket);
+    while (entry != NULL && count < maxConnections) {
+        DemuxInterest *next = LIST_NEXT(entry, bucketList);
+
+        if (entry->nameHash == nameHash && ccnxName_Equals(entry->name, name)) {
+            if (entry->expiryTime >= now) {
+                connections[count++] = entry->conn;
+            }
+            _forwarderDemux_RemoveInterest(demux, entry);
+        }
+
+        entry = next;
+    }
+
+    return count;
+}
+
+size_t
+forwarderDemux_GetInterestCount(const ForwarderDemux *demux)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    return demux->interestCount;
+}
+
+// ==================
+// Registered prefixes
+
+static uint64_t
+_forwarderDemux_PrefixHash(const CCNxName *name, size_t segmentCount)
+{
+    return ccnxName_LeftMostHashCode(name, segmentCount);
+}
+
+static DemuxPrefix *
+_forwarderDemux_FindPrefix(const ForwarderDemux *demux, const CCNxName *prefix, RtaConnection *conn)
+{
+    size_t segmentCount = ccnxName_GetSegmentCount(prefix);
+    uint64_t prefixHash = _forwarderDemux_PrefixHash(prefix, segmentCount);
+
+    DemuxPrefix *entry;
+    TAILQ_FOREACH(entry, &demux->prefixHead, list)
+    {
+        if (entry->conn == conn && entry->prefixHash == prefixHash && ccnxName_Equals(entry->prefix, prefix)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void
+_forwarderDemux_RemovePrefixEntry(ForwarderDemux *demux, DemuxPrefix *entry)
+{
+    TAILQ_REMOVE(&demux->prefixHead, entry, list);
+    ccnxName_Release(&entry->prefix);
+    parcMemory_Deallocate((void **) &entry);
+
+    demux->longestPrefix = 0;
+    TAILQ_FOREACH(entry, &demux->prefixHead, list)
+    {
+        if (entry->segmentCount > demux->longestPrefix) {
+            demux->longestPrefix = entry->segmentCount;
+        }
+    }
+}
+
+void
+forwarderDemux_AddPrefix(ForwarderDemux *demux, const CCNxName *prefix, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(prefix, "Parameter prefix must be non-null");
+    assertNotNull(conn, "Parameter conn must be non-null");
+
+    DemuxPrefix *entry = _forwarderDemux_FindPrefix(demux, prefix, conn);
+    if (entry != NULL) {
+        entry->registrations++;
+        return;
+    }
+
+    entry = parcMemory_AllocateAndClear(sizeof(DemuxPrefix));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(DemuxPrefix));
+
+    entry->segmentCount = ccnxName_GetSegmentCount(prefix);
+    entry->prefixHash = _forwarderDemux_PrefixHash(prefix, entry->segmentCount);
+    entry->prefix = ccnxName_Acquire(prefix);
+    entry->conn = conn;
+    entry->registrations = 1;
+
+    TAILQ_INSERT_TAIL(&demux->prefixHead, entry, list);
+    if (entry->segmentCount > demux->longestPrefix) {
+        demux->longestPrefix = entry->segmentCount;
+    }
+}
+
+bool
+forwarderDemux_RemovePrefix(ForwarderDemux *demux, const CCNxName *prefix, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(prefix, "Parameter prefix must be non-null");
+
+    DemuxPrefix *entry = _forwarderDemux_FindPrefix(demux, prefix, conn);
+    if (entry != NULL) {
+        entry->registrations--;
+        if (entry->registrations == 0) {
+            _forwarderDemux_RemovePrefixEntry(demux, entry);
+        }
+    }
+
+    size_t segmentCount = ccnxName_GetSegmentCount(prefix);
+    uint64_t prefixHash = _forwarderDemux_PrefixHash(prefix, segmentCount);
+    TAILQ_FOREACH(entry, &demux->prefixHead, list)
+    {
+        if (entry->prefixHash == prefixHash && ccnxName_Equals(entry->prefix, prefix)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RtaConnection *
+forwarderDemux_MatchPrefix(const ForwarderDemux *demux, const CCNxName *name)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(name, "Parameter name must be non-null");
+
+    if (TAILQ_EMPTY(&demux->prefixHead)) {
+        return NULL;
+    }
+
+    size_t nameSegments = ccnxName_GetSegmentCount(name);
+    size_t length = nameSegments < demux->longestPrefix ? nameSegments : demux->longestPrefix;
+
+    // try the longest prefixes first, hashing each prefix of the name once
+    for (size_t segmentCount = length + 1; segmentCount-- > 0;) {
+        uint64_t prefixHash = _forwarderDemux_PrefixHash(name, segmentCount);
+
+        DemuxPrefix *entry;
+        TAILQ_FOREACH(entry, &demux->prefixHead, list)
+        {
+            if (entry->segmentCount == segmentCount && entry->prefixHash == prefixHash &&
+                ccnxName_StartsWith(name, entry->prefix)) {
+                return entry->conn;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// ==================
+// Control requests
+
+void
+forwarderDemux_AddControl(ForwarderDemux *demux, uint64_t sequenceNumber, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(conn, "Parameter conn must be non-null");
+
+    DemuxControl *entry = parcMemory_AllocateAndClear(sizeof(DemuxControl));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(DemuxControl));
+
+    entry->sequenceNumber = sequenceNumber;
+    entry->conn = conn;
+    LIST_INSERT_HEAD(&demux->controlHead, entry, list);
+}
+
+RtaConnection *
+forwarderDemux_TakeControl(ForwarderDemux *demux, uint64_t sequenceNumber)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+
+    DemuxControl *entry;
+    LIST_FOREACH(entry, &demux->controlHead, list)
+    {
+        if (entry->sequenceNumber == sequenceNumber) {
+            RtaConnection *conn = entry->conn;
+            LIST_REMOVE(entry, list);
+            parcMemory_Deallocate((void **) &entry);
+            return conn;
+        }
+    }
+    return NULL;
+}
+
+// ==================
+// Held packets
+
+static DemuxConnection *
+_forwarderDemux_FindConnection(const ForwarderDemux *demux, const RtaConnection *conn)
+{
+    DemuxConnection *entry = NULL;
+    for (size_t i = 0; i < demux->connectionCount; i++) {
+        if (demux->connections[i].conn == conn) {
+            entry = &demux->connections[i];
+            break;
+        }
+    }
+    assertNotNull(entry, "Connection %p is not attached", (void *) conn);
+    return entry;
+}
+
+static void
+_forwarderDemux_DestroyHeld(DemuxConnection *entry)
+{
+    while (!parcDeque_IsEmpty(entry->held)) {
+        TransportMessage *tm = parcDeque_RemoveFirst(entry->held);
+        transportMessage_Destroy(&tm);
+    }
+    parcDeque_Release(&entry->held);
+}
+
+void
+forwarderDemux_Hold(ForwarderDemux *demux, RtaConnection *conn, TransportMessage *tm)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(tm, "Parameter tm must be non-null");
+
+    parcDeque_Append(_forwarderDemux_FindConnection(demux, conn)->held, tm);
+}
+
+TransportMessage *
+forwarderDemux_TakeHeld(ForwarderDemux *demux, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+
+    DemuxConnection *entry = _forwarderDemux_FindConnection(demux, conn);
+    if (parcDeque_IsEmpty(entry->held)) {
+        return NULL;
+    }
+    return parcDeque_RemoveFirst(entry->held);
+}
+
+size_t
+forwarderDemux_GetHeldCount(const ForwarderDemux *demux, const RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    return parcDeque_Size(_forwarderDemux_FindConnection(demux, conn)->held);
+}
+
+size_t
+forwarderDemux_GetMostHeld(const ForwarderDemux *demux)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+
+    size_t most = 0;
+    for (size_t i = 0; i < demux->connectionCount; i++) {
+        size_t held = parcDeque_Size(demux->connections[i].held);
+        if (held > most) {
+            most = held;
+        }
+    }
+    return most;
+}
+
+// ==================
+// Connections
+
+ForwarderDemux *
+forwarderDemux_Create(void)
+{
+    ForwarderDemux *demux = parcMemory_AllocateAndClear(sizeof(ForwarderDemux));
+    assertNotNull(demux, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(ForwarderDemux));
+
+    demux->connectionCapacity = MIN_CONNECTIONS;
+    demux->connections = parcMemory_Allocate(demux->connectionCapacity * sizeof(DemuxConnection));
+    assertNotNull(demux->connections, "parcMemory_Allocate(%zu) returned NULL", demux->connectionCapacity * sizeof(DemuxConnection));
+
+    demux->bucketCount = MIN_BUCKETS;
+    demux->buckets = _forwarderDemux_AllocateBuckets(demux->bucketCount);
+
+    TAILQ_INIT(&demux->expiryHead);
+    TAILQ_INIT(&demux->prefixHead);
+    LIST_INIT(&demux->controlHead);
+
+    return demux;
+}
+
+void
+forwarderDemux_Destroy(ForwarderDemux **demuxPtr)
+{
+    assertNotNull(demuxPtr, "Parameter demuxPtr must be non-null");
+    ForwarderDemux *demux = *demuxPtr;
+    assertNotNull(demux, "Parameter demuxPtr must dereference to non-null");
+
+    while (!TAILQ_EMPTY(&demux->expiryHead)) {
+        _forwarderDemux_RemoveInterest(demux, TAILQ_FIRST(&demux->expiryHead));
+    }
+
+    while (!TAILQ_EMPTY(&demux->prefixHead)) {
+        _forwarderDemux_RemovePrefixEntry(demux, TAILQ_FIRST(&demux->prefixHead));
+    }
+
+    while (!LIST_EMPTY(&demux->controlHead)) {
+        DemuxControl *entry = LIST_FIRST(&demux->controlHead);
+        LIST_REMOVE(entry, list);
+        parcMemory_Deallocate((void **) &entry);
+    }
+
+    for (size_t i = 0; i < demux->connectionCount; i++) {
+        _forwarderDemux_DestroyHeld(&demux->connections[i]);
+    }
+
+    parcMemory_Deallocate((void **) &demux->buckets);
+    parcMemory_Deallocate((void **) &demux->connections);
+    parcMemory_Deallocate((void **) &demux);
+    *demuxPtr = NULL;
+}
+
+void
+forwarderDemux_AttachConnection(ForwarderDemux *demux, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(conn, "Parameter conn must be non-null");
+
+    if (demux->connectionCount == demux->connectionCapacity) {
+        size_t capacity = demux->connectionCapacity * 2;
+        DemuxConnection *connections = parcMemory_Allocate(capacity * sizeof(DemuxConnection));
+        assertNotNull(connections, "parcMemory_Allocate(%zu) returned NULL", capacity * sizeof(DemuxConnection));
+        memcpy(connections, demux->connections, demux->connectionCount * sizeof(DemuxConnection));
+        parcMemory_Deallocate((void **) &demux->connections);
+        demux->connections = connections;
+        demux->connectionCapacity = capacity;
+    }
+
+    DemuxConnection *entry = &demux->connections[demux->connectionCount++];
+    entry->conn = conn;
+    entry->held = parcDeque_Create();
+}
+
+/**
+ * Removes everything the connection recorded.  This walks every table, which is fine
+ * because connections close far less often than packets arrive.
+ */
+void
+forwarderDemux_DetachConnection(ForwarderDemux *demux, RtaConnection *conn)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertNotNull(conn, "Parameter conn must be non-null");
+
+    DemuxConnection *entry = _forwarderDemux_FindConnection(demux, conn);
+    _forwarderDemux_DestroyHeld(entry);
+    *entry = demux->connections[--demux->connectionCount];
+
+    DemuxInterest *interest = TAILQ_FIRST(&demux->expiryHead);
+    while (interest != NULL) {
+        DemuxInterest *next = TAILQ_NEXT(interest, expiryList);
+        if (interest->conn == conn) {
+            _forwarderDemux_RemoveInterest(demux, interest);
+        }
+        interest = next;
+    }
+
+    DemuxPrefix *prefix = TAILQ_FIRST(&demux->prefixHead);
+    while (prefix != NULL) {
+        DemuxPrefix *next = TAILQ_NEXT(prefix, list);
+        if (prefix->conn == conn) {
+            _forwarderDemux_RemovePrefixEntry(demux, prefix);
+        }
+        prefix = next;
+    }
+
+    DemuxControl *control = LIST_FIRST(&demux->controlHead);
+    while (control != NULL) {
+        DemuxControl *next = LIST_NEXT(control, list);
+        if (control->conn == conn) {
+            LIST_REMOVE(control, list);
+            parcMemory_Deallocate((void **) &control);
+        }
+        control = next;
+    }
+}
+
+size_t
+forwarderDemux_GetConnectionCount(const ForwarderDemux *demux)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    return demux->connectionCount;
+}
+
+RtaConnection *
+forwarderDemux_GetConnection(const ForwarderDemux *demux, size_t index)
+{
+    assertNotNull(demux, "Parameter demux must be non-null");
+    assertTrue(index < demux->connectionCount, "Index %zu out of range, %zu connections", index, demux->connectionCount);
+    return demux->connections[index].conn;
+}
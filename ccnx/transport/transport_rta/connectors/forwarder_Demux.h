@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file forwarder_Demux.h
+ * @brief Finds the connection a packet from a shared forwarder socket belongs to
+ *
+ * When every connection on a protocol stack shares one socket to the forwarder, the
+ * forwarder no longer tells the connections apart.  The connector records what each
+ * connection sends down and uses it to pick the connection for each packet coming up:
+ *
+ *   - A Content Object or InterestReturn goes to every connection with a pending Interest
+ *     of the same name.  The forwarder has already checked the KeyId and hash restrictions.
+ *   - An Interest goes to the connection that registered the longest prefix of its name.
+ *     If several connections registered that prefix, the first one gets it.
+ *   - A control response goes to the connection that sent the request with its sequence number.
+ *
+ * The socket cannot stop reading for one connection, so the packets of a connection that is
+ * blocked up are held here, in order, until it unblocks.  The connector stops reading the
+ * socket when a connection holds too many.
+ *
+ * Pending Interests are indexed by name hash in a power-of-two bucket array that doubles as
+ * the table grows, and kept on a list ordered by expiry time.  Expired Interests are dropped
+ * as new ones are added.  Prefixes and control requests are few, so they are kept on lists.
+ *
+ * Metis sees the shared socket as one face and never forwards a packet back out the face it
+ * came in on.  Connections on the same demuxed stack therefore cannot reach each other: an
+ * Interest from a consumer is not delivered to a producer on the same stack, even though
+ * the demux would match its prefix.  Put the producer and the consumer on separate stacks,
+ * or turn the shared socket off.
+ *
+ * The demux does not acquire the connections.  Call `forwarderDemux_DetachConnection()` before
+ * a connection goes away.  Times are in framework ticks.  The demux is not thread safe.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_forwarder_Demux_h
+#define Libccnx_forwarder_Demux_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <ccnx/common/ccnx_Name.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/common/transport_Message.h>
+
+struct forwarder_demux;
+typedef struct forwarder_demux ForwarderDemux;
+
+/**
+ * Create an empty demux
+ *
+ * @return non-null An allocated demux, destroy with `forwarderDemux_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     ForwarderDemux *demux = forwarderDemux_Create();
+ *     forwarderDemux_AttachConnection(demux, conn);
+ *     // ...
+ *     forwarderDemux_DetachConnection(demux, conn);
+ *     forwarderDemux_Destroy(&demux);
+ * }
+ * @endcode
+ */
+ForwarderDemux *forwarderDemux_Create(void);
+
+/**
+ * Destroys the demux and everything it records
+ */
+void forwarderDemux_Destroy(ForwarderDemux **demuxPtr);
+
+/**
+ * Adds a connection to the set sharing the socket
+ *
+ * @param [in] demux The demux
+ * @param [in] conn A connection not already attached
+ */
+void forwarderDemux_AttachConnection(ForwarderDemux *demux, RtaConnection *conn);
+
+/**
+ * Removes a connection and every Interest, prefix, control request and held packet it recorded
+ *
+ * @param [in] demux The demux
+ * @param [in] conn An attached connection
+ */
+void forwarderDemux_DetachConnection(ForwarderDemux *demux, RtaConnection *conn);
+
+/**
+ * The number of attached connections
+ */
+size_t forwarderDemux_GetConnectionCount(const ForwarderDemux *demux);
+
+/**
+ * An attached connection, for sending each of them a notification
+ *
+ * @param [in] demux The demux
+ * @param [in] index Less than `forwarderDemux_GetConnectionCount()`
+ */
+RtaConnection *forwarderDemux_GetConnection(const ForwarderDemux *demux, size_t index);
+
+/**
+ * Records an Interest a connection sent down
+ *
+ * If the connection already has a pending Interest with the same name, its expiry time
+ * becomes the later of the two.
+ *
+ * @param [in] demux The demux
+ * @param [in] name The name of the Interest
+ * @param [in] conn The attached connection that sent it
+ * @param [in] expiryTime When the Interest's lifetime ends
+ * @param [in] now The current time, Interests that expired before it are dropped
+ */
+void forwarderDemux_AddInterest(ForwarderDemux *demux, const CCNxName *name, RtaConnection *conn, uint64_t expiryTime, uint64_t now);
+
+/**
+ * Removes the pending Interests with the given name and returns their connections
+ *
+ * Returns at most `maxConnections` connections.  Call it in a loop until it returns 0.
+ *
+ * @param [in] demux The demux
+ * @param [in] name The name of a received Content Object or InterestReturn
+ * @param [in] now The current time, expired Interests do not match
+ * @param [out] connections Filled in with the connections waiting on the name
+ * @param [in] maxConnections The size of `connections`
+ *
+ * @return The number of connections filled in
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaConnection *waiters[16];
+ *     size_t count;
+ *     while ((count = forwarderDemux_TakeInterest(demux, name, now, waiters, 16)) > 0) {
+ *         // send the Content Object up each waiter
+ *     }
+ * }
+ * @endcode
+ */
+size_t forwarderDemux_TakeInterest(ForwarderDemux *demux, const CCNxName *name, uint64_t now,
+                                   RtaConnection **connections, size_t maxConnections);
+
+/**
+ * The number of pending Interests, including expired ones not yet dropped
+ */
+size_t forwarderDemux_GetInterestCount(const ForwarderDemux *demux);
+
+/**
+ * Records that a connection registered a prefix with the forwarder
+ *
+ * A connection may register the same prefix more than once.  It must unregister it as many times.
+ *
+ * @param [in] demux The demux
+ * @param [in] prefix The registered prefix
+ * @param [in] conn The attached connection that registered it
+ */
+void forwarderDemux_AddPrefix(ForwarderDemux *demux, const CCNxName *prefix, RtaConnection *conn);
+
+/**
+ * Removes one registration of a prefix by a connection
+ *
+ * @param [in] demux The demux
+ * @param [in] prefix The prefix to unregister
+ * @param [in] conn The connection unregistering it
+ *
+ * @return true No connection has the prefix registered any more, unregister it with the forwarder
+ * @return false Another connection still has the prefix registered, keep it with the forwarder
+ */
+bool forwarderDemux_RemovePrefix(ForwarderDemux *demux, const CCNxName *prefix, RtaConnection *conn);
+
+/**
+ * The connection that registered the longest prefix of the name
+ *
+ * @param [in] demux The demux
+ * @param [in] name The name of a received Interest
+ *
+ * @return non-null The connection to send the Interest up
+ * @return null No connection registered a prefix of the name
+ */
+RtaConnection *forwarderDemux_MatchPrefix(const ForwarderDemux *demux, const CCNxName *name);
+
+/**
+ * Records a control request a connection sent down
+ *
+ * @param [in] demux The demux
+ * @param [in] sequenceNumber The CPI sequence number of the request
+ * @param [in] conn The attached connection that sent it
+ */
+void forwarderDemux_AddControl(ForwarderDemux *demux, uint64_t sequenceNumber, RtaConnection *conn);
+
+/**
+ * Removes a control request and returns its connection
+ *
+ * @param [in] demux The demux
+ * @param [in] sequenceNumber The CPI sequence number of the request a response answers
+ *
+ * @return non-null The connection that sent the request
+ * @return null No connection sent a request with that sequence number
+ */
+RtaConnection *forwarderDemux_TakeControl(ForwarderDemux *demux, uint64_t sequenceNumber);
+
+/**
+ * Holds a packet for a blocked up connection behind the ones it already holds
+ *
+ * @param [in] demux The demux
+ * @param [in] conn The attached connection the packet is for
+ * @param [in] tm The packet, the demux takes ownership
+ *
+ * Example:
+ * @code
+ * {
+ *     if (rtaConnection_BlockedUp(conn) || forwarderDemux_GetHeldCount(demux, conn) > 0) {
+ *         forwarderDemux_Hold(demux, conn, tm);
+ *     }
+ * }
+ * @endcode
+ */
+void forwarderDemux_Hold(ForwarderDemux *demux, RtaConnection *conn, TransportMessage *tm);
+
+/**
+ * Removes the oldest packet a connection holds
+ *
+ * @param [in] demux The demux
+ * @param [in] conn An attached connection
+ *
+ * @return non-null The packet, the caller owns it
+ * @return null The connection holds no packets
+ */
+TransportMessage *forwarderDemux_TakeHeld(ForwarderDemux *demux, RtaConnection *conn);
+
+/**
+ * The number of packets a connection holds
+ *
+ * @param [in] demux The demux
+ * @param [in] conn An attached connection
+ */
+size_t forwarderDemux_GetHeldCount(const ForwarderDemux *demux, const RtaConnection *conn);
+
+/**
+ * The most packets any one connection holds
+ */
+size_t forwarderDemux_GetMostHeld(const ForwarderDemux *demux);
+#endif // Libccnx_forwarder_Demux_h
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include "forwarder_ShmLink.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+#ifndef MSG_NOSIGNAL
+// the connector sets SO_NOSIGPIPE on the socket instead
+#define MSG_NOSIGNAL 0
+#endif
+
+#define SHMLINK_MAGIC 0x43434e58
+#define SHMLINK_VERSION 1
+#define SHMLINK_NAME_LENGTH 32
+#define SHMLINK_MIN_CAPACITY 4096
+#define SHMLINK_CACHE_LINE 64
+
+/**
+ * The indices of one ring.  The producer and consumer fields are on separate cache lines.
+ * head and tail count every byte ever written and read, so head - tail is the bytes in the ring.
+ */
+typedef struct shm_ring_index {
+    // the producer's line.  spaceWaiting is set by the producer and cleared by the consumer.
+    uint64_t head;
+    uint32_t spaceWaiting;
+    uint8_t pad0[SHMLINK_CACHE_LINE - sizeof(uint64_t) - sizeof(uint32_t)];
+
+    // the consumer's line.  dataWaiting is set by the consumer and cleared by the producer.
+    uint64_t tail;
+    uint32_t dataWaiting;
+    uint8_t pad1[SHMLINK_CACHE_LINE - sizeof(uint64_t) - sizeof(uint32_t)];
+} ShmRingIndex;
+
+/**
+ * The start of the segment.  Ring 0 carries bytes from the creator, ring 1 to it.
+ * The ring data follows, `capacity` bytes for each ring.
+ */
+typedef struct shm_segment_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint8_t pad[SHMLINK_CACHE_LINE - 2 * sizeof(uint32_t) - sizeof(uint64_t)];
+
+    ShmRingIndex rings[2];
+} ShmSegmentHeader;
+
+typedef struct shm_hello {
+    uint32_t magic;
+    char name[SHMLINK_NAME_LENGTH];
+} ShmHello;
+
+struct forwarder_shm_link {
+    char name[SHMLINK_NAME_LENGTH];
+    bool creator;
+
+    ShmSegmentHeader *header;
+    size_t mappedLength;
+    size_t capacity;
+
+    ShmRingIndex *tx;
+    uint8_t *txData;
+    ShmRingIndex *rx;
+    uint8_t *rxData;
+};
+
+static size_t
+_forwarderShmLink_MappedLength(size_t capacity)
+{
+    return sizeof(ShmSegmentHeader) + 2 * capacity;
+}
+
+static ForwarderShmLink *
+_forwarderShmLink_Map(const char *name, int shmfd, size_t capacity, bool creator)
+{
+    size_t mappedLength = _forwarderShmLink_MappedLength(capacity);
+    void *base = mmap(NULL, mappedLength, PROT_READ | PROT_WRITE, MAP_SHARED, shmfd, 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    ForwarderShmLink *link = parcMemory_AllocateAndClear(sizeof(ForwarderShmLink));
+    assertNotNull(link, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(ForwarderShmLink));
+
+    strncpy(link->name, name, SHMLINK_NAME_LENGTH - 1);
+    link->creator = creator;
+    link->header = base;
+    link->mappedLength = mappedLength;
+    link->capacity = capacity;
+
+    uint8_t *data = (uint8_t *) base + sizeof(ShmSegmentHeader);
+    unsigned txRing = creator ? 0 : 1;
+    link->tx = &link->header->rings[txRing];
+    link->txData = data + txRing * capacity;
+    link->rx = &link->header->rings[1 - txRing];
+    link->rxData = data + (1 - txRing) * capacity;
+
+    return link;
+}
+
+ForwarderShmLink *
+forwarderShmLink_Create(const char *name, size_t capacity)
+{
+    assertNotNull(name, "Parameter name must be non-null");
+    assertTrue(strlen(name) < SHMLINK_NAME_LENGTH, "Name %s is longer than %d", name, SHMLINK_NAME_LENGTH - 1);
+
+    size_t roundedCapacity = SHMLINK_MIN_CAPACITY;
+    while (roundedCapacity < capacity) {
+        roundedCapacity <<= 1;
+    }
+
+    int shmfd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (shmfd < 0) {
+        return NULL;
+    }
+
+    ForwarderShmLink *link = NULL;
+    if (ftruncate(shmfd, (off_t) _forwarderShmLink_MappedLength(roundedCapacity)) == 0) {
+        link = _forwarderShmLink_Map(name, shmfd, roundedCapacity, true);
+    }
+    close(shmfd);
+
+    if (link == NULL) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // ftruncate() zero filled the rings and indices.  Neither reader has looked at its
+    // ring yet, so both wait for data and the first write rings the doorbell.
+    link->header->rings[0].dataWaiting = 1;
+    link->header->rings[1].dataWaiting = 1;
+    link->header->capacity = roundedCapacity;
+    link->header->version = SHMLINK_VERSION;
+    __atomic_store_n(&link->header->magic, SHMLINK_MAGIC, __ATOMIC_RELEASE);
+
+    if (DEBUG_OUTPUT) {
+        printf("%s created %s capacity %zu\n", __func__, name, roundedCapacity);
+    }
+
+    return link;
+}
+
+ForwarderShmLink *
+forwarderShmLink_Accept(int fd)
+{
+    ShmHello hello;
+    ssize_t nread = recv(fd, &hello, sizeof(hello), MSG_WAITALL);
+    if (nread != sizeof(hello) || hello.magic != SHMLINK_MAGIC) {
+        return NULL;
+    }
+    hello.name[SHMLINK_NAME_LENGTH - 1] = '\0';
+
+    int shmfd = shm_open(hello.name, O_RDWR, 0600);
+    if (shmfd < 0) {
+        return NULL;
+    }
+
+    // the creator has mapped it and we have it open, nobody else needs the name
+    shm_unlink(hello.name);
+
+    ForwarderShmLink *link = NULL;
+    struct stat statbuf;
+    ShmSegmentHeader header;
+    if (fstat(shmfd, &statbuf) == 0 && statbuf.st_size >= (off_t) sizeof(header) &&
+        pread(shmfd, &header, sizeof(header), 0) == sizeof(header) &&
+        header.magic == SHMLINK_MAGIC && header.version == SHMLINK_VERSION &&
+        statbuf.st_size == (off_t) _forwarderShmLink_MappedLength(header.capacity)) {
+        link = _forwarderShmLink_Map(hello.name, shmfd, header.capacity, false);
+    }
+    close(shmfd);
+
+    return link;
+}
+
+void
+forwarderShmLink_Destroy(ForwarderShmLink **linkPtr)
+{
+    assertNotNull(linkPtr, "Parameter linkPtr must be non-null");
+    ForwarderShmLink *link = *linkPtr;
+    assertNotNull(link, "Parameter *linkPtr must be non-null");
+
+    if (link->creator) {
+        // fails harmlessly if the peer already unlinked it
+        shm_unlink(link->name);
+    }
+
+    munmap(link->header, link->mappedLength);
+    parcMemory_Deallocate((void **) &link);
+    *linkPtr = NULL;
+}
+
+bool
+forwarderShmLink_SendHello(const ForwarderShmLink *link, int fd)
+{
+    ShmHello hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.magic = SHMLINK_MAGIC;
+    strncpy(hello.name, link->name, SHMLINK_NAME_LENGTH - 1);
+
+    ssize_t nwritten = send(fd, &hello, sizeof(hello), MSG_NOSIGNAL);
+    return nwritten == sizeof(hello);
+}
+
+// ==================
+// The rings
+
+size_t
+forwarderShmLink_WriteSpan(ForwarderShmLink *link, void **spanPtr)
+{
+    uint64_t head = link->tx->head;
+    uint64_t tail = __atomic_load_n(&link->tx->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail == link->capacity) {
+        // Mark the wait before looking again, so the reader either sees the mark
+        // or we see what it just read
+        __atomic_store_n(&link->tx->spaceWaiting, 1, __ATOMIC_SEQ_CST);
+        tail = __atomic_load_n(&link->tx->tail, __ATOMIC_SEQ_CST);
+        if (head - tail == link->capacity) {
+            return 0;
+        }
+    }
+
+    size_t offset = head & (link->capacity - 1);
+    size_t freeBytes = link->capacity - (size_t) (head - tail);
+    size_t contiguous = link->capacity - offset;
+
+    *spanPtr = link->txData + offset;
+    return (freeBytes < contiguous) ? freeBytes : contiguous;
+}
+
+void
+forwarderShmLink_WriteCommit(ForwarderShmLink *link, size_t length)
+{
+    __atomic_store_n(&link->tx->head, link->tx->head + length, __ATOMIC_SEQ_CST);
+}
+
+size_t
+forwarderShmLink_Write(ForwarderShmLink *link, const void *bytes, size_t length)
+{
+    const uint8_t *next = bytes;
+    size_t remaining = length;
+
+    // at most two spans, before and after the end of the ring
+    while (remaining > 0) {
+        void *span;
+        size_t spanLength = forwarderShmLink_WriteSpan(link, &span);
+        if (spanLength == 0) {
+            break;
+        }
+
+        size_t copyLength = (remaining < spanLength) ? remaining : spanLength;
+        memcpy(span, next, copyLength);
+        forwarderShmLink_WriteCommit(link, copyLength);
+        next += copyLength;
+        remaining -= copyLength;
+    }
+
+    return length - remaining;
+}
+
+size_t
+forwarderShmLink_Read(ForwarderShmLink *link, void *bytes, size_t length)
+{
+    uint64_t tail = link->rx->tail;
+    uint64_t head = __atomic_load_n(&link->rx->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        __atomic_store_n(&link->rx->dataWaiting, 1, __ATOMIC_SEQ_CST);
+        head = __atomic_load_n(&link->rx->head, __ATOMIC_SEQ_CST);
+        if (head == tail) {
+            return 0;
+        }
+    }
+
+    size_t available = (size_t) (head - tail);
+    size_t readLength = (length < available) ? length : available;
+    size_t offset = tail & (link->capacity - 1);
+    size_t firstLength = link->capacity - offset;
+    if (firstLength > readLength) {
+        firstLength = readLength;
+    }
+
+    memcpy(bytes, link->rxData + offset, firstLength);
+    memcpy((uint8_t *) bytes + firstLength, link->rxData, readLength - firstLength);
+
+    __atomic_store_n(&link->rx->tail, tail + readLength, __ATOMIC_SEQ_CST);
+    return readLength;
+}
+
+// ==================
+// The doorbell
+
+bool
+forwarderShmLink_Notify(ForwarderShmLink *link, int fd)
+{
+    bool ring = false;
+
+    // the reader waits for data and there is some
+    if (link->tx->head != __atomic_load_n(&link->tx->tail, __ATOMIC_SEQ_CST)) {
+        if (__atomic_exchange_n(&link->tx->dataWaiting, 0, __ATOMIC_SEQ_CST)) {
+            ring = true;
+        }
+    }
+
+    // the writer waits for space and we just made some
+    if (__atomic_exchange_n(&link->rx->spaceWaiting, 0, __ATOMIC_SEQ_CST)) {
+        ring = true;
+    }
+
+    if (ring) {
+        uint8_t doorbell = 1;
+        ssize_t nwritten = send(fd, &doorbell, 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (nwritten < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        // a full socket already holds rings the peer has not read
+    }
+
+    return true;
+}
+
+ssize_t
+forwarderShmLink_DrainDoorbell(int fd)
+{
+    ssize_t count = 0;
+    uint8_t rings[64];
+
+    while (true) {
+        ssize_t nread = recv(fd, rings, sizeof(rings), MSG_DONTWAIT);
+        if (nread > 0) {
+            count += nread;
+        } else if (nread == 0) {
+            return -1;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return count;
+        } else if (errno != EINTR) {
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file forwarder_ShmLink.h
+ * @brief A shared memory packet link between the Metis connector and a co-located forwarder
+ *
+ * The link is a shared memory segment with two single-producer single-consumer byte rings,
+ * one in each direction.  Packets are written to a ring back to back, exactly as they would
+ * be written to a stream socket, so the reader frames them with the fixed header as usual.
+ *
+ * The rings have no way to wake the other side, so each link goes with a PF_UNIX stream
+ * socket, the doorbell.  The side that creates the segment (the connector) connects the
+ * socket and sends the segment's name with `forwarderShmLink_SendHello()`.  The forwarder
+ * opens it with `forwarderShmLink_Accept()`.  After that each side rings the doorbell by
+ * writing one byte, and the peer sees it as a read event in its normal event loop:
+ *
+ *   - A reader that finds its ring empty marks it as waiting for data.  A writer rings
+ *     the doorbell if it wrote to a ring whose reader is waiting.
+ *   - A writer that finds its ring full marks it as waiting for space.  A reader rings
+ *     the doorbell if it read from a ring whose writer is waiting.
+ *
+ * So a busy link copies packets through shared memory without a system call per packet.
+ * The doorbell socket closing is how each side sees the other go away.
+ *
+ * A link is used by one thread on each side.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_forwarder_ShmLink_h
+#define Libccnx_forwarder_ShmLink_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+struct forwarder_shm_link;
+typedef struct forwarder_shm_link ForwarderShmLink;
+
+/**
+ * Creates a new shared memory segment for a link
+ *
+ * The segment's name is unlinked when the peer opens it or the link is destroyed,
+ * whichever is first.
+ *
+ * @param [in] name A shared memory object name, "/" followed by up to 30 characters
+ * @param [in] capacity The bytes in each ring, rounded up to a power of 2
+ *
+ * @return non-null The link, destroy with `forwarderShmLink_Destroy()`
+ * @return null The segment could not be created, see errno
+ *
+ * Example:
+ * @code
+ * {
+ *     ForwarderShmLink *link = forwarderShmLink_Create("/ccnx-example", 1 << 20);
+ *     // connect fd to the forwarder
+ *     forwarderShmLink_SendHello(link, fd);
+ * }
+ * @endcode
+ */
+ForwarderShmLink *forwarderShmLink_Create(const char *name, size_t capacity);
+
+/**
+ * Reads the hello from a doorbell socket and opens the other end of the link
+ *
+ * `fd` must be blocking, or readable with the whole hello.
+ *
+ * @param [in] fd The accepted doorbell socket
+ *
+ * @return non-null The link, destroy with `forwarderShmLink_Destroy()`
+ * @return null The hello was not valid or the segment could not be opened
+ */
+ForwarderShmLink *forwarderShmLink_Accept(int fd);
+
+/**
+ * Unmaps the segment.  Does not close the doorbell socket.
+ *
+ * @param [in,out] linkPtr The link, NULL on return
+ */
+void forwarderShmLink_Destroy(ForwarderShmLink **linkPtr);
+
+/**
+ * Sends the segment name to the forwarder over the connected doorbell socket
+ *
+ * @param [in] link A link from `forwarderShmLink_Create()`
+ * @param [in] fd The connected doorbell socket
+ *
+ * @return true The whole hello was sent
+ * @return false The socket failed, see errno
+ */
+bool forwarderShmLink_SendHello(const ForwarderShmLink *link, int fd);
+
+/**
+ * Copies up to `length` bytes to the outgoing ring
+ *
+ * @param [in] link The link
+ * @param [in] bytes The bytes to write
+ * @param [in] length The number of bytes
+ *
+ * @return The number of bytes written.  Less than `length` means the ring is full and
+ *         marked waiting for space.
+ */
+size_t forwarderShmLink_Write(ForwarderShmLink *link, const void *bytes, size_t length);
+
+/**
+ * The contiguous free space at the head of the outgoing ring, to write in place
+ *
+ * Write up to the returned number of bytes at `*spanPtr`, then call
+ * `forwarderShmLink_WriteCommit()`.
+ *
+ * @param [in] link The link
+ * @param [out] spanPtr Where to write
+ *
+ * @return The bytes free at `*spanPtr`.  0 means the ring is full and marked waiting for space.
+ *
+ * Example:
+ * @code
+ * {
+ *     void *span;
+ *     size_t spanLength = forwarderShmLink_WriteSpan(link, &span);
+ *     size_t length = parcEventBuffer_Read(queue, span, spanLength);
+ *     forwarderShmLink_WriteCommit(link, length);
+ * }
+ * @endcode
+ */
+size_t forwarderShmLink_WriteSpan(ForwarderShmLink *link, void **spanPtr);
+
+/**
+ * Publishes bytes written in place to the reader
+ *
+ * @param [in] link The link
+ * @param [in] length No more than the last `forwarderShmLink_WriteSpan()`
+ */
+void forwarderShmLink_WriteCommit(ForwarderShmLink *link, size_t length);
+
+/**
+ * Copies up to `length` bytes from the incoming ring
+ *
+ * @param [in] link The link
+ * @param [out] bytes Where to copy them
+ * @param [in] length The most to copy
+ *
+ * @return The number of bytes read.  0 means the ring is empty and marked waiting for data.
+ */
+size_t forwarderShmLink_Read(ForwarderShmLink *link, void *bytes, size_t length);
+
+/**
+ * Rings the doorbell if the peer is waiting on something this side did
+ *
+ * Call after writing or reading a batch.  It clears the marks it answers, so the peer
+ * gets one doorbell per wait.
+ *
+ * @param [in] link The link
+ * @param [in] fd The doorbell socket
+ *
+ * @return true Rang the doorbell, or it did not need ringing
+ * @return false The doorbell socket failed
+ */
+bool forwarderShmLink_Notify(ForwarderShmLink *link, int fd);
+
+/**
+ * Reads all the doorbell rings waiting on the non-blocking socket
+ *
+ * Call before reading or writing the rings after a read event, so a ring that comes
+ * in while this side is working is not lost.
+ *
+ * @param [in] fd The doorbell socket
+ *
+ * @return >= 0 The number of rings read
+ * @return -1 The peer closed the link or the socket failed
+ */
+ssize_t forwarderShmLink_DrainDoorbell(int fd);
+#endif // Libccnx_forwarder_ShmLink_h
@@ -47,6 +47,7 @@
 #include <inttypes.h>
 
 #include <errno.h>
+#include <sys/ioctl.h>
 
 #include <parc/algol/parc_EventBuffer.h>
 
@@ -58,10 +59,15 @@
 #include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
 #include <ccnx/transport/transport_rta/core/rta_Connection.h>
 #include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/core/rta_Timer.h>
 #include <ccnx/api/control/controlPlaneInterface.h>
 #include <ccnx/api/control/cpi_ControlFacade.h>
 
 #include <ccnx/transport/transport_rta/config/config_Codec_Tlv.h>
+#include <ccnx/transport/transport_rta/config/config_ApiConnector.h>
+
+#include <ccnx/common/ccnx_ContentObject.h>
+#include <ccnx/common/ccnx_WireFormatMessage.h>
 
 #include <ccnx/common/codec/schema_v1/ccnxCodecSchemaV1_TlvDictionary.h>
 
@@ -73,9 +79,9 @@
 #define PAIR_TRANSPORT 0
 #define PAIR_OTHER     1
 
-// we are only putting an 8-byte pointer on the queue, so
-// this should be 50 messages
-#define MAX_API_QUEUE_BYTES     400
+// While blocked UP, how often we look at how much the API has read.  The API
+// reads from its own thread, so nothing on our event base tells us.
+#define API_QUEUE_POLL_USEC     1000
 
 
 unsigned api_upcall_writes = 0;
@@ -93,16 +99,36 @@ struct rta_api_connection {
     // these are assingned to us by the Transport
     int api_fd;
     int transport_fd;
+
+    // Upward flow control.  We block UP when either budget is exceeded and
+    // unblock when the API has read us down to half of both.
+    size_t maxQueueBytes;
+    size_t maxQueueMessages;
+
+    // Ring of the byte counts of the messages the API has not read, oldest first.
+    // It is in the same order as the pointers in the socket.
+    size_t *pendingBytes;
+    size_t pendingCapacity;
+    size_t pendingHead;
+    size_t pendingCount;
+    size_t queuedBytes;
+
+    bool blockedUp;
+    ticks blockedSince;
+    ticks blockedTicks;
+    uint64_t blockedCount;
+
+    RtaTimer *pollTimer;
 };
 
 // ==========================================================================================
 // STATIC PROTOTYPES and their headerdoc
 
 /**
- * PARCEvent calls this when the API queue falls below the watermark
+ * PARCEvent calls this when the API queue output buffer empties
  *
- * We watermark the write queue at MAX_API_QUEUE_BYTES bytes.  When a write takes
- * the queue backlog below that amount, PARCEvent calls this.
+ * Everything we wrote is now in the socket, so it is a good time to see how much
+ * the API has read and if we can unblock in the UP direction.
  *
  * @param [in] connVoid Void pointer to the RtaConnection
  *
@@ -169,11 +195,13 @@ static void rtaApiConnection_DrainApiConnection(RtaApiConnection *apiConnection)
 /**
  * Writes a message to the API
  *
- * Takes ownership of the message which is passed up to the API
+ * Takes ownership of the message which is passed up to the API.  Everything in our output
+ * buffer is for this one connection, so messages, control or not, are written in the order
+ * they came up the stack.  A control message's priority over other connections' data is
+ * given by the queue schedulers below us.
  *
- * @param [<#in out in,out#>] <#name#> <#description#>
- *
- * @return <#value#> <#explanation#>
+ * @param [in] apiConnection The API Connector's connection state
+ * @param [in] msg The message to pass up
  *
  * Example:
  * @code
@@ -182,6 +210,34 @@ static void rtaApiConnection_DrainApiConnection(RtaApiConnection *apiConnection)
  */
 static void rtaApiConnection_WriteMessageToApi(RtaApiConnection *apiConnection, CCNxMetaMessage *msg);
 
+/**
+ * Accounts what the API has read and blocks or unblocks the UP direction
+ *
+ * Sets `rtaConnection_SetBlockedUp()` when the held bytes or messages exceed the budget and
+ * clears it once both are at or below half the budget.  While blocked, a timer calls us
+ * every API_QUEUE_POLL_USEC to look again.
+ *
+ * @param [in] apiConnection The API Connector's connection state
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+static void rtaApiConnection_UpdateFlowControl(RtaApiConnection *apiConnection);
+
+/**
+ * The framework timer calls this every API_QUEUE_POLL_USEC while we are blocked in the UP direction
+ *
+ * @param [in] apiConnectionVoid Void pointer to the RtaApiConnection
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+static void rtaApiConnection_PollCallback(int fd, PARCEventType type, void *apiConnectionVoid);
+
 // ==========================================================================================
 // Public API
 
@@ -201,13 +257,15 @@ rtaApiConnection_SetupSocket(RtaApiConnection *apiConnection, RtaConnection *con
     apiConnection->bev_api = parcEventQueue_Create(base, apiConnection->transport_fd, 0);
     assertNotNull(apiConnection->bev_api, "Got null result from parcEventQueue_Create");
 
-    // Set buffer size
-    int sendbuff = 1000 * 8;
+    // Set buffer size to hold the message budget of pointers, the byte budget is enforced
+    // by rtaApiConnection_UpdateFlowControl()
+    int sendbuff = (int) (sizeof(CCNxMetaMessage *) * apiConnection->maxQueueMessages);
 
     error = setsockopt(rtaConnection_GetTransportFd(connection), SOL_SOCKET, SO_SNDBUF, &sendbuff, sizeof(sendbuff));
     assertTrue(error == 0, "Got error setting SO_SNDBUF: %s", strerror(errno));
 
-    parcEventQueue_SetWatermark(apiConnection->bev_api, PARCEventType_Write, MAX_API_QUEUE_BYTES, 0);
+    // Call the write callback every time the output buffer drains to the socket
+    parcEventQueue_SetWatermark(apiConnection->bev_api, PARCEventType_Write, 0, 0);
     parcEventQueue_SetCallbacks(apiConnection->bev_api,
                                 rtaApiConnection_Downcall_Read,
                                 rtaApiConnection_WriteCallback,
@@ -215,6 +273,8 @@ rtaApiConnection_SetupSocket(RtaApiConnection *apiConnection, RtaConnection *con
                                 (void *) connection);
 
     parcEventQueue_Enable(apiConnection->bev_api, PARCEventType_Read | PARCEventType_Write);
+
+    apiConnection->pollTimer = rtaTimer_Create(rtaProtocolStack_GetFramework(stack), 0, rtaApiConnection_PollCallback, apiConnection);
 }
 
 RtaApiConnection *
@@ -226,6 +286,15 @@ rtaApiConnection_Create(RtaConnection *connection)
     apiConnection->connection = rtaConnection_Copy(connection);
     apiConnection->api_fd = rtaConnection_GetApiFd(connection);
     apiConnection->transport_fd = rtaConnection_GetTransportFd(connection);
+
+    PARCJSON *params = rtaConnection_GetParameters(connection);
+    apiConnection->maxQueueBytes = apiConnector_GetQueueBytesFromConfig(params);
+    apiConnection->maxQueueMessages = apiConnector_GetQueueMessagesFromConfig(params);
+
+    apiConnection->pendingCapacity = 64;
+    apiConnection->pendingBytes = parcMemory_AllocateAndClear(sizeof(size_t) * apiConnection->pendingCapacity);
+    assertNotNull(apiConnection->pendingBytes, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(size_t) * apiConnection->pendingCapacity);
+
     rtaApiConnection_SetupSocket(apiConnection, connection);
 
     return apiConnection;
@@ -245,6 +314,8 @@ rtaApiConnection_Destroy(RtaApiConnection **apiConnectionPtr)
     rtaApiConnection_DrainApiConnection(apiConnection);
 
     parcEventQueue_Destroy(&(apiConnection->bev_api));
+    rtaTimer_Destroy(&(apiConnection->pollTimer));
+    parcMemory_Deallocate((void **) &(apiConnection->pendingBytes));
 
     rtaConnection_Destroy(&apiConnection->connection);
 
@@ -309,6 +380,11 @@ rtaApiConnection_SendToApi(RtaApiConnection *apiConnection, TransportMessage *tm
         }
     }
 
+    // The application may read any field
+    if (!transportMessage_CompleteDecode(tm)) {
+        return false;
+    }
+
     rtaApiConnection_SendToApiAsDictionary(apiConnection, tm);
 
     rtaComponentStats_Increment(stats, STATS_UPCALL_OUT);
@@ -363,9 +439,186 @@ rtaApiConnection_UnblockDown(RtaApiConnection *apiConnection)
     }
 }
 
+size_t
+rtaApiConnection_GetQueuedBytes(RtaApiConnection *apiConnection)
+{
+    assertNotNull(apiConnection, "Parameter apiConnection must be non-null");
+    return apiConnection->queuedBytes;
+}
+
+size_t
+rtaApiConnection_GetQueuedMessages(RtaApiConnection *apiConnection)
+{
+    assertNotNull(apiConnection, "Parameter apiConnection must be non-null");
+    return apiConnection->pendingCount;
+}
+
+uint64_t
+rtaApiConnection_GetBlockedCount(const RtaApiConnection *apiConnection)
+{
+    assertNotNull(apiConnection, "Parameter apiConnection must be non-null");
+    return apiConnection->blockedCount;
+}
+
+uint64_t
+rtaApiConnection_GetBlockedUsec(const RtaApiConnection *apiConnection)
+{
+    assertNotNull(apiConnection, "Parameter apiConnection must be non-null");
+    ticks blocked = apiConnection->blockedTicks;
+    if (apiConnection->blockedUp) {
+        RtaFramework *framework = rtaProtocolStack_GetFramework(rtaConnection_GetStack(apiConnection->connection));
+        blocked += rtaFramework_GetTicks(framework) - apiConnection->blockedSince;
+    }
+    return rtaFramework_TicksToUsec(blocked);
+}
+
 // ==========================================================================================
 // Internal implementation
 
+/**
+ * The bytes a message holds while it waits for the API
+ *
+ * Messages coming up the stack keep their wire format, which is the best measure.  If the
+ * codec did not keep it, count the payload of a content object.  We always count the pointer.
+ */
+static size_t
+rtaApiConnection_MessageBytes(CCNxMetaMessage *msg)
+{
+    size_t bytes = sizeof(CCNxMetaMessage *);
+
+    PARCBuffer *wireFormat = ccnxWireFormatMessage_GetWireFormatBuffer(msg);
+    if (wireFormat != NULL) {
+        bytes += parcBuffer_Limit(wireFormat);
+    } else if (ccnxTlvDictionary_IsContentObject(msg)) {
+        PARCBuffer *payload = ccnxContentObject_GetPayload(msg);
+        if (payload != NULL) {
+            bytes += parcBuffer_Remaining(payload);
+        }
+    }
+    return bytes;
+}
+
+static void
+rtaApiConnection_PushPending(RtaApiConnection *apiConnection, size_t bytes)
+{
+    if (apiConnection->pendingCount == apiConnection->pendingCapacity) {
+        size_t capacity = apiConnection->pendingCapacity * 2;
+        size_t *ring = parcMemory_AllocateAndClear(sizeof(size_t) * capacity);
+        assertNotNull(ring, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(size_t) * capacity);
+
+        for (size_t i = 0; i < apiConnection->pendingCount; i++) {
+            ring[i] = apiConnection->pendingBytes[(apiConnection->pendingHead + i) % apiConnection->pendingCapacity];
+        }
+
+        parcMemory_Deallocate((void **) &(apiConnection->pendingBytes));
+        apiConnection->pendingBytes = ring;
+        apiConnection->pendingCapacity = capacity;
+        apiConnection->pendingHead = 0;
+    }
+
+    size_t tail = (apiConnection->pendingHead + apiConnection->pendingCount) % apiConnection->pendingCapacity;
+    apiConnection->pendingBytes[tail] = bytes;
+    apiConnection->pendingCount++;
+    apiConnection->queuedBytes += bytes;
+}
+
+/**
+ * The number of message pointers the API has not read
+ *
+ * They are either in our output buffer or in the API's receive buffer.  The API's
+ * side of the socketpair is in our process, so we can ask how much is waiting on it.
+ */
+static size_t
+rtaApiConnection_UnreadMessages(RtaApiConnection *apiConnection)
+{
+    PARCEventBuffer *out = parcEventBuffer_GetQueueBufferOutput(apiConnection->bev_api);
+    size_t bytes = parcEventBuffer_GetLength(out);
+    parcEventBuffer_Destroy(&out);
+
+    int inSocket = 0;
+    if (ioctl(apiConnection->api_fd, FIONREAD, &inSocket) == 0 && inSocket > 0) {
+        bytes += (size_t) inSocket;
+    }
+
+    // a partially read pointer is still unread
+    size_t unread = (bytes + sizeof(CCNxMetaMessage *) - 1) / sizeof(CCNxMetaMessage *);
+    return (unread < apiConnection->pendingCount) ? unread : apiConnection->pendingCount;
+}
+
+static void
+rtaApiConnection_ReapConsumed(RtaApiConnection *apiConnection)
+{
+    size_t consumed = apiConnection->pendingCount - rtaApiConnection_UnreadMessages(apiConnection);
+    while (consumed > 0) {
+        apiConnection->queuedBytes -= apiConnection->pendingBytes[apiConnection->pendingHead];
+        apiConnection->pendingHead = (apiConnection->pendingHead + 1) % apiConnection->pendingCapacity;
+        apiConnection->pendingCount--;
+        consumed--;
+    }
+}
+
+static void
+rtaApiConnection_StartPollTimer(RtaApiConnection *apiConnection)
+{
+    struct timeval pollTimeout = { 0, API_QUEUE_POLL_USEC };
+    rtaTimer_Start(apiConnection->pollTimer, &pollTimeout);
+}
+
+static void
+rtaApiConnection_UpdateFlowControl(RtaApiConnection *apiConnection)
+{
+    rtaApiConnection_ReapConsumed(apiConnection);
+
+    RtaConnection *conn = apiConnection->connection;
+    RtaFramework *framework = rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn));
+
+    if (!apiConnection->blockedUp) {
+        if (apiConnection->queuedBytes > apiConnection->maxQueueBytes ||
+            apiConnection->pendingCount > apiConnection->maxQueueMessages) {
+            if (DEBUG_OUTPUT) {
+                printf("%9" PRIu64 " %s connection %u holds %zu bytes %zu messages, blocking UP\n",
+                       rtaFramework_GetTicks(framework),
+                       __func__,
+                       rtaConnection_GetConnectionId(conn),
+                       apiConnection->queuedBytes,
+                       apiConnection->pendingCount);
+            }
+
+            apiConnection->blockedUp = true;
+            apiConnection->blockedSince = rtaFramework_GetTicks(framework);
+            apiConnection->blockedCount++;
+            rtaApiConnection_StartPollTimer(apiConnection);
+            rtaConnection_SetBlockedUp(conn);
+        }
+    } else {
+        if (apiConnection->queuedBytes <= apiConnection->maxQueueBytes / 2 &&
+            apiConnection->pendingCount <= apiConnection->maxQueueMessages / 2) {
+            if (DEBUG_OUTPUT) {
+                printf("%9" PRIu64 " %s connection %u holds %zu bytes %zu messages, unblocking UP\n",
+                       rtaFramework_GetTicks(framework),
+                       __func__,
+                       rtaConnection_GetConnectionId(conn),
+                       apiConnection->queuedBytes,
+                       apiConnection->pendingCount);
+            }
+
+            apiConnection->blockedUp = false;
+            apiConnection->blockedTicks += rtaFramework_GetTicks(framework) - apiConnection->blockedSince;
+            rtaTimer_Stop(apiConnection->pollTimer);
+            rtaConnection_ClearBlockedUp(conn);
+        } else {
+            rtaApiConnection_StartPollTimer(apiConnection);
+        }
+    }
+}
+
+static void
+rtaApiConnection_PollCallback(int fd, PARCEventType type, void *apiConnectionVoid)
+{
+    RtaApiConnection *apiConnection = (RtaApiConnection *) apiConnectionVoid;
+    rtaApiConnection_UpdateFlowControl(apiConnection);
+}
+
 static void
 rtaApiConnection_WriteMessageToApi(RtaApiConnection *apiConnection, CCNxMetaMessage *msg)
 {
@@ -376,16 +629,19 @@ rtaApiConnection_WriteMessageToApi(RtaApiConnection *apiConnection, CCNxMetaMess
                "write to transport_fd %d write error: (%d) %s",
                apiConnection->transport_fd, errno, strerror(errno));
 
+    rtaApiConnection_PushPending(apiConnection, rtaApiConnection_MessageBytes(msg));
+    rtaApiConnection_UpdateFlowControl(apiConnection);
+
     // debugging tracking
     api_upcall_writes++;
 }
 
 static void
-_rtaAPIConnection_ProcessCPIRequest(RtaConnection *conn, PARCJSON *json)
+_rtaAPIConnection_ProcessCPIRequest(RtaConnection *conn, CCNxTlvDictionary *controlDictionary)
 {
     // Is it a request type we know about?
 
-    switch (cpi_getCPIOperation2(json)) {
+    switch (cpi_GetMessageOperation(controlDictionary)) {
         case CPI_PAUSE: {
             RtaConnectionStateType oldstate = rtaConnection_GetState(conn);
             if (oldstate == CONN_OPEN) {
@@ -404,10 +660,11 @@ static void
 connector_Api_ProcessCpiMessage(RtaConnection *conn, CCNxTlvDictionary *controlDictionary)
 {
     if (ccnxControlFacade_IsCPI(controlDictionary)) {
-        PARCJSON *json = ccnxControlFacade_GetJson(controlDictionary);
-        switch (controlPlaneInterface_GetCPIMessageType(json)) {
+        // binary and JSON messages both work here
+        CpiMessageType messageType = cpi_GetMessageType(controlDictionary);
+        switch (messageType) {
             case CPI_REQUEST: {
-                _rtaAPIConnection_ProcessCPIRequest(conn, json);
+                _rtaAPIConnection_ProcessCPIRequest(conn, controlDictionary);
                 break;
             }
 
@@ -419,7 +676,7 @@ connector_Api_ProcessCpiMessage(RtaConnection *conn, CCNxTlvDictionary *controlD
 
             default:
                 // change to an error messsage, don't abort the whole thing (case 910)
-                assertTrue(0, "Got unknown CPI message type: %d", controlPlaneInterface_GetCPIMessageType(json));
+                assertTrue(0, "Got unknown CPI message type: %d", messageType);
         }
     }
 }
@@ -628,21 +885,16 @@ rtaApiConnection_DrainApiConnection(RtaApiConnection *apiConnection)
 }
 
 /**
- * Called by PARCEvent when we cross below the write watermark
+ * Called by PARCEvent when the output buffer has drained to the socket
  */
 static void
 rtaApiConnection_WriteCallback(PARCEventQueue *queue, PARCEventType type, void *connVoid)
 {
-    // we dropped below the write watermark, unblock the connection in the UP direction
     RtaConnection *conn = (RtaConnection *) connVoid;
-    if (rtaConnection_BlockedUp(conn)) {
-        if (DEBUG_OUTPUT) {
-            printf("%9" PRIu64 " %s connection %u output fell below watermark, unblocking UP\n",
-                   rtaFramework_GetTicks(rtaProtocolStack_GetFramework(rtaConnection_GetStack(conn))),
-                   __func__,
-                   rtaConnection_GetConnectionId(conn));
-        }
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(conn, API_CONNECTOR);
 
-        rtaConnection_ClearBlockedUp(conn);
+    // The connector may be closing, in which case there is nothing left to unblock
+    if (apiConnection != NULL && apiConnection->blockedUp) {
+        rtaApiConnection_UpdateFlowControl(apiConnection);
     }
 }
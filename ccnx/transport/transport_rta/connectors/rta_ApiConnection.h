@@ -93,4 +93,65 @@ void rtaApiConnection_BlockDown(RtaApiConnection *apiConnection);
  * @endcode
  */
 void rtaApiConnection_UnblockDown(RtaApiConnection *apiConnection);
+
+/**
+ * The payload bytes held for the API
+ *
+ * Counts the messages written up to the API that it has not read yet, whether they are
+ * still in our output buffer or already in the socket.
+ *
+ * @param [in] apiConnection The API Connector's connection state
+ *
+ * @return number The bytes of the held messages (wire format or payload, plus the pointer)
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+size_t rtaApiConnection_GetQueuedBytes(RtaApiConnection *apiConnection);
+
+/**
+ * The number of messages held for the API
+ *
+ * @param [in] apiConnection The API Connector's connection state
+ *
+ * @return number The messages written up to the API that it has not read yet
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+size_t rtaApiConnection_GetQueuedMessages(RtaApiConnection *apiConnection);
+
+/**
+ * The number of times the API connector blocked the connection in the UP direction
+ *
+ * @param [in] apiConnection The API Connector's connection state
+ *
+ * @return number The count of transitions to blocked
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+uint64_t rtaApiConnection_GetBlockedCount(const RtaApiConnection *apiConnection);
+
+/**
+ * The total time the API connector held the connection blocked in the UP direction
+ *
+ * Includes the current blocked interval, if any.
+ *
+ * @param [in] apiConnection The API Connector's connection state
+ *
+ * @return number Microseconds spent blocked
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+uint64_t rtaApiConnection_GetBlockedUsec(const RtaApiConnection *apiConnection);
 #endif
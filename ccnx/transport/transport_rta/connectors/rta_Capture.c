@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * See rta_Capture.h for the file format.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/transport/transport_rta/connectors/rta_Capture.h>
+
+#define RTA_CAPTURE_VERSION 1
+
+#define FILE_HEADER_LENGTH 8
+#define RECORD_HEADER_LENGTH 20
+
+// records are batched in memory up to this many bytes
+#define CAPTURE_BUFFER_BYTES (64 * 1024)
+
+static const uint8_t _fileHeader[FILE_HEADER_LENGTH] = { 'R', 'T', 'A', 'C', 'A', 'P', 0x00, RTA_CAPTURE_VERSION };
+
+struct rta_capture {
+    int fd;
+    uint64_t records;
+
+    // timestamp of the first record in the buffer
+    uint64_t bufferedSince;
+    size_t bufferLength;
+    uint8_t buffer[CAPTURE_BUFFER_BYTES];
+};
+
+struct rta_capture_reader {
+    FILE *file;
+};
+
+static uint64_t
+_nowUsec(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_usec;
+}
+
+static void
+_encodeRecordHeader(uint8_t header[RECORD_HEADER_LENGTH], uint64_t timestamp, unsigned connectionId, RtaCaptureDirection direction, size_t length)
+{
+    for (int i = 0; i < 8; i++) {
+        header[i] = (uint8_t) (timestamp >> (56 - 8 * i));
+    }
+    for (int i = 0; i < 4; i++) {
+        header[8 + i] = (uint8_t) ((uint32_t) connectionId >> (24 - 8 * i));
+    }
+    header[12] = (uint8_t) direction;
+    header[13] = header[14] = header[15] = 0;
+    for (int i = 0; i < 4; i++) {
+        header[16 + i] = (uint8_t) ((uint32_t) length >> (24 - 8 * i));
+    }
+}
+
+static uint64_t
+_decodeUint(const uint8_t *p, size_t bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+/**
+ * Writes all of the iovec, retrying on EINTR and short writes.
+ */
+static bool
+_writeAll(int fd, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0) {
+        ssize_t nwritten = writev(fd, iov, iovcnt);
+        if (nwritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        while (iovcnt > 0 && (size_t) nwritten >= iov->iov_len) {
+            nwritten -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (uint8_t *) iov->iov_base + nwritten;
+            iov->iov_len -= nwritten;
+        }
+    }
+    return true;
+}
+
+/**
+ * Stops the capture after a failed write.  The connection keeps running.
+ */
+static void
+_captureFailed(RtaCapture *capture)
+{
+    fprintf(stderr, "%s capture fd %d stopped after %" PRIu64 " records: %s\n",
+            __func__, capture->fd, capture->records, strerror(errno));
+    close(capture->fd);
+    capture->fd = -1;
+    capture->bufferLength = 0;
+}
+
+// ================================
+
+RtaCapture *
+rtaCapture_Open(const char *path)
+{
+    assertNotNull(path, "Parameter path must be non-null");
+
+    // Only the call that creates the file writes the file header
+    bool created = true;
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_EXCL, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        created = false;
+        fd = open(path, O_RDWR | O_APPEND);
+    }
+
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (created) {
+        struct iovec iov = { .iov_base = (void *) _fileHeader, .iov_len = FILE_HEADER_LENGTH };
+        if (!_writeAll(fd, &iov, 1)) {
+            close(fd);
+            return NULL;
+        }
+    } else {
+        uint8_t header[FILE_HEADER_LENGTH];
+        if (pread(fd, header, FILE_HEADER_LENGTH, 0) != FILE_HEADER_LENGTH || memcmp(header, _fileHeader, FILE_HEADER_LENGTH) != 0) {
+            close(fd);
+            return NULL;
+        }
+    }
+
+    RtaCapture *capture = parcMemory_AllocateAndClear(sizeof(RtaCapture));
+    assertNotNull(capture, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaCapture));
+    capture->fd = fd;
+    return capture;
+}
+
+void
+rtaCapture_Close(RtaCapture **capturePtr)
+{
+    assertNotNull(capturePtr, "Parameter capturePtr must be non-null");
+    assertNotNull(*capturePtr, "Parameter capturePtr must dereference to non-null");
+
+    RtaCapture *capture = *capturePtr;
+    rtaCapture_Flush(capture);
+    if (capture->fd >= 0) {
+        close(capture->fd);
+    }
+    parcMemory_Deallocate((void **) &capture);
+    *capturePtr = NULL;
+}
+
+bool
+rtaCapture_Flush(RtaCapture *capture)
+{
+    if (capture->fd < 0) {
+        return false;
+    }
+
+    if (capture->bufferLength > 0) {
+        struct iovec iov = { .iov_base = capture->buffer, .iov_len = capture->bufferLength };
+        if (!_writeAll(capture->fd, &iov, 1)) {
+            _captureFailed(capture);
+            return false;
+        }
+        capture->bufferLength = 0;
+    }
+    return true;
+}
+
+uint64_t
+rtaCapture_GetRecordCount(const RtaCapture *capture)
+{
+    return capture->records;
+}
+
+void
+rtaCapture_WriteIoVec(RtaCapture *capture, unsigned connectionId, RtaCaptureDirection direction, int iovcnt, const struct iovec *iov)
+{
+    if (capture->fd < 0) {
+        return;
+    }
+
+    size_t length = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        length += iov[i].iov_len;
+    }
+
+    uint64_t now = _nowUsec();
+    uint8_t header[RECORD_HEADER_LENGTH];
+    _encodeRecordHeader(header, now, connectionId, direction, length);
+
+    size_t recordLength = RECORD_HEADER_LENGTH + length;
+    if (capture->bufferLength + recordLength > CAPTURE_BUFFER_BYTES) {
+        if (!rtaCapture_Flush(capture)) {
+            return;
+        }
+    }
+
+    if (recordLength > CAPTURE_BUFFER_BYTES) {
+        // Too big to batch, write the header and the packet in one call
+        struct iovec array[iovcnt + 1];
+        array[0].iov_base = header;
+        array[0].iov_len = RECORD_HEADER_LENGTH;
+        memcpy(&array[1], iov, sizeof(struct iovec) * iovcnt);
+        if (!_writeAll(capture->fd, array, iovcnt + 1)) {
+            _captureFailed(capture);
+            return;
+        }
+    } else {
+        if (capture->bufferLength == 0) {
+            capture->bufferedSince = now;
+        }
+
+        memcpy(capture->buffer + capture->bufferLength, header, RECORD_HEADER_LENGTH);
+        capture->bufferLength += RECORD_HEADER_LENGTH;
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(capture->buffer + capture->bufferLength, iov[i].iov_base, iov[i].iov_len);
+            capture->bufferLength += iov[i].iov_len;
+        }
+    }
+
+    capture->records++;
+
+    if (capture->bufferLength > 0 && now - capture->bufferedSince >= RTA_CAPTURE_FLUSH_USEC) {
+        rtaCapture_Flush(capture);
+    }
+}
+
+void
+rtaCapture_WriteBuffer(RtaCapture *capture, unsigned connectionId, RtaCaptureDirection direction, const PARCBuffer *packet)
+{
+    struct iovec iov = {
+        .iov_base = parcBuffer_Overlay((PARCBuffer *) packet, 0),
+        .iov_len  = parcBuffer_Remaining(packet)
+    };
+    rtaCapture_WriteIoVec(capture, connectionId, direction, 1, &iov);
+}
+
+// ================================
+
+RtaCaptureReader *
+rtaCaptureReader_Open(const char *path)
+{
+    assertNotNull(path, "Parameter path must be non-null");
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    uint8_t header[FILE_HEADER_LENGTH];
+    if (fread(header, 1, FILE_HEADER_LENGTH, file) != FILE_HEADER_LENGTH || memcmp(header, _fileHeader, FILE_HEADER_LENGTH) != 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    RtaCaptureReader *reader = parcMemory_AllocateAndClear(sizeof(RtaCaptureReader));
+    assertNotNull(reader, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaCaptureReader));
+    reader->file = file;
+    return reader;
+}
+
+bool
+rtaCaptureReader_Next(RtaCaptureReader *reader, RtaCaptureRecord *record)
+{
+    assertNotNull(reader, "Parameter reader must be non-null");
+    assertNotNull(record, "Parameter record must be non-null");
+
+    uint8_t header[RECORD_HEADER_LENGTH];
+    if (fread(header, 1, RECORD_HEADER_LENGTH, reader->file) != RECORD_HEADER_LENGTH) {
+        return false;
+    }
+
+    size_t length = (size_t) _decodeUint(header + 16, 4);
+    PARCBuffer *packet = parcBuffer_Allocate(length);
+    if (length > 0 && fread(parcBuffer_Overlay(packet, length), 1, length, reader->file) != length) {
+        parcBuffer_Release(&packet);
+        return false;
+    }
+    parcBuffer_Flip(packet);
+
+    record->timestampUsec = _decodeUint(header, 8);
+    record->connectionId = (unsigned) _decodeUint(header + 8, 4);
+    record->direction = header[12] == RtaCaptureDirection_Up ? RtaCaptureDirection_Up : RtaCaptureDirection_Down;
+    record->packet = packet;
+    return true;
+}
+
+void
+rtaCaptureReader_Close(RtaCaptureReader **readerPtr)
+{
+    assertNotNull(readerPtr, "Parameter readerPtr must be non-null");
+    assertNotNull(*readerPtr, "Parameter readerPtr must dereference to non-null");
+
+    RtaCaptureReader *reader = *readerPtr;
+    fclose(reader->file);
+    parcMemory_Deallocate((void **) &reader);
+    *readerPtr = NULL;
+}
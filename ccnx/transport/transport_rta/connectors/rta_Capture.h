@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_Capture.h
+ * @brief Records the packets a forwarder connector exchanges with the forwarder
+ *
+ * A forwarder connector opens an `RtaCapture` for each connection configured with
+ * `connectorCapture_ConnectionConfig()` and writes every wire format packet it sends down to
+ * or receives up from the forwarder.  `RtaCaptureReader` reads the file back, for example in
+ * test_tools/rta_replay.c.
+ *
+ * The file is append-only.  It starts with an 8 byte file header, then one record per packet:
+ *
+ *   file header  "RTACAP" 0x00 version
+ *   record       uint64_t timestamp, microseconds since the epoch
+ *                uint32_t connection id
+ *                uint8_t  direction, 0 down (to the forwarder) or 1 up (from the forwarder)
+ *                uint8_t  reserved[3]
+ *                uint32_t packet length
+ *                uint8_t  packet[length], the wire format without any connector framing
+ *
+ * All integers are in network byte order.
+ *
+ * Records are collected in memory and written with one `write(2)` per batch on a descriptor
+ * opened with O_APPEND, so connections sharing a file never interleave partial records.  A batch
+ * is written when the buffer is full, when its oldest record is older than
+ * RTA_CAPTURE_FLUSH_USEC, and on close.  If a write fails the capture stops and the connection
+ * carries on without it.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#ifndef TransportRTA_rta_Capture_h
+#define TransportRTA_rta_Capture_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <parc/algol/parc_Buffer.h>
+
+// The buffered records are written at least this often
+#define RTA_CAPTURE_FLUSH_USEC 1000000
+
+typedef enum {
+    RtaCaptureDirection_Down = 0,
+    RtaCaptureDirection_Up = 1
+} RtaCaptureDirection;
+
+struct rta_capture;
+typedef struct rta_capture RtaCapture;
+
+struct rta_capture_reader;
+typedef struct rta_capture_reader RtaCaptureReader;
+
+/**
+ * @typedef RtaCaptureRecord
+ * @brief One packet read from a capture file
+ */
+typedef struct rta_capture_record {
+    uint64_t timestampUsec;
+    unsigned connectionId;
+    RtaCaptureDirection direction;
+
+    // the wire format packet, the caller must release it
+    PARCBuffer *packet;
+} RtaCaptureRecord;
+
+/**
+ * Opens a capture file for append
+ *
+ * A new file gets the file header.  An existing file must already be a capture file.
+ *
+ * @param [in] path The capture file
+ *
+ * @return non-null The capture
+ * @return null The file could not be opened or is not a capture file
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaCapture *capture = rtaCapture_Open("/tmp/connection.cap");
+ *     rtaCapture_WriteBuffer(capture, 7, RtaCaptureDirection_Up, packet);
+ *     rtaCapture_Close(&capture);
+ * }
+ * @endcode
+ */
+RtaCapture *rtaCapture_Open(const char *path);
+
+/**
+ * Writes the buffered records and closes the file
+ *
+ * @param [in,out] capturePtr The capture, NULL'd on return
+ */
+void rtaCapture_Close(RtaCapture **capturePtr);
+
+/**
+ * Records a packet held in a PARCBuffer
+ *
+ * Records the bytes from the position to the limit, it does not move the position.
+ *
+ * @param [in] capture The capture
+ * @param [in] connectionId The RTA connection id
+ * @param [in] direction Down to the forwarder or up from it
+ * @param [in] packet The wire format packet
+ */
+void rtaCapture_WriteBuffer(RtaCapture *capture, unsigned connectionId, RtaCaptureDirection direction, const PARCBuffer *packet);
+
+/**
+ * Records a packet held in an iovec, as the codec produces it
+ *
+ * @param [in] capture The capture
+ * @param [in] connectionId The RTA connection id
+ * @param [in] direction Down to the forwarder or up from it
+ * @param [in] iovcnt The number of entries in `iov`
+ * @param [in] iov The packet
+ */
+void rtaCapture_WriteIoVec(RtaCapture *capture, unsigned connectionId, RtaCaptureDirection direction, int iovcnt, const struct iovec *iov);
+
+/**
+ * Writes the buffered records
+ *
+ * @param [in] capture The capture
+ *
+ * @return true The buffer is empty
+ * @return false A write failed, the capture is stopped
+ */
+bool rtaCapture_Flush(RtaCapture *capture);
+
+/**
+ * The number of records written or buffered
+ */
+uint64_t rtaCapture_GetRecordCount(const RtaCapture *capture);
+
+/**
+ * Opens a capture file for reading
+ *
+ * @param [in] path The capture file
+ *
+ * @return non-null The reader, positioned at the first record
+ * @return null The file could not be opened or is not a capture file
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaCaptureReader *reader = rtaCaptureReader_Open("/tmp/connection.cap");
+ *     RtaCaptureRecord record;
+ *     while (rtaCaptureReader_Next(reader, &record)) {
+ *         // ...
+ *         parcBuffer_Release(&record.packet);
+ *     }
+ *     rtaCaptureReader_Close(&reader);
+ * }
+ * @endcode
+ */
+RtaCaptureReader *rtaCaptureReader_Open(const char *path);
+
+/**
+ * Reads the next record
+ *
+ * A record cut short at the end of the file, e.g. by a crash before close, ends the capture.
+ *
+ * @param [in] reader The reader
+ * @param [out] record The record, the caller must release `record->packet`
+ *
+ * @return true A record was read
+ * @return false The end of the capture
+ */
+bool rtaCaptureReader_Next(RtaCaptureReader *reader, RtaCaptureRecord *record);
+
+/**
+ * Closes the file
+ *
+ * @param [in,out] readerPtr The reader, NULL'd on return
+ */
+void rtaCaptureReader_Close(RtaCaptureReader **readerPtr);
+#endif // TransportRTA_rta_Capture_h
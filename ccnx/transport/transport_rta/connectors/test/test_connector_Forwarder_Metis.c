@@ -584,6 +584,7 @@ LONGBOW_TEST_FIXTURE(UpDirectionV1)
     LONGBOW_RUN_TEST_CASE(UpDirectionV1, _readPacket_MoreThanOneMessage);
 
     LONGBOW_RUN_TEST_CASE(UpDirectionV1, _readFromMetis_ThreeMessages);
+    LONGBOW_RUN_TEST_CASE(UpDirectionV1, _readFromMetis_BlockedUp_NoDrops);
 
     LONGBOW_RUN_TEST_CASE(UpDirectionV1, _readFromMetis_InterestV1);
     LONGBOW_RUN_TEST_CASE(UpDirectionV1, _readFromMetis_ContentObjectV1);
@@ -896,6 +897,55 @@ LONGBOW_TEST_CASE(UpDirectionV1, _readFromMetis_ThreeMessages)
     // no extra cleanup, done in teardown
 }
 
+/**
+ * Send more packets than METIS_INPUT_QUEUE_MESSAGES while the connection is blocked up.  We
+ * should stop reading with the queue full, and once unblocked every packet goes up the stack.
+ */
+LONGBOW_TEST_CASE(UpDirectionV1, _readFromMetis_BlockedUp_NoDrops)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    int api_fd;
+    int client_fd;
+    RtaConnection *conn = setupConnectionAndClientSocket(data, &api_fd, &client_fd);
+
+    const size_t loopCount = METIS_INPUT_QUEUE_MESSAGES + 20;
+    for (size_t i = 0; i < loopCount; i++) {
+        _sendPacketToConnectorV1(client_fd, 100);
+    }
+
+    FwdMetisState *fwd_state = (FwdMetisState *) rtaConnection_GetPrivateData(conn, FWD_METIS);
+
+    rtaConnection_SetBlockedUp(conn);
+    _readFromMetis(fwd_state, conn);
+    rtaFramework_NonThreadedStepCount(data->framework, 5);
+
+    assertTrue(parcDeque_Size(fwd_state->transportMessageQueue) == METIS_INPUT_QUEUE_MESSAGES,
+               "Wrong queue length while blocked, expected %d got %zu",
+               METIS_INPUT_QUEUE_MESSAGES, parcDeque_Size(fwd_state->transportMessageQueue));
+    assertTrue(fwd_state->readPaused, "Reading should pause with the input queue full");
+
+    rtaConnection_ClearBlockedUp(conn);
+    rtaFramework_NonThreadedStepCount(data->framework, 5);
+
+    PARCEventQueue *out = rtaProtocolStack_GetPutQueue(rtaConnection_GetStack(conn), TESTING_UPPER, RTA_DOWN);
+    _throwAwayControlMessage(out);
+
+    size_t received = 0;
+    for (int step = 0; step < 1000 && received < loopCount; step++) {
+        TransportMessage *test_tm;
+        while ((test_tm = rtaComponent_GetMessage(out)) != NULL) {
+            assertTrue(transportMessage_IsInterest(test_tm), "Transport message %zu is not an interest", received);
+            transportMessage_Destroy(&test_tm);
+            received++;
+        }
+        rtaFramework_NonThreadedStepCount(data->framework, 1);
+    }
+
+    assertTrue(received == loopCount, "Wrong number of messages up the stack, expected %zu got %zu", loopCount, received);
+    assertFalse(fwd_state->readPaused, "Reading should resume once the queue drains");
+}
+
 LONGBOW_TEST_CASE(UpDirectionV1, _readFromMetis_InterestV1)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
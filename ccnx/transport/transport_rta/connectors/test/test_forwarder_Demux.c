@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../forwarder_Demux.c"
+#include <ccnx/common/ccnx_Interest.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+// The demux never dereferences a connection, so the tests use tokens
+static RtaConnection *connA = (RtaConnection *) "a";
+static RtaConnection *connB = (RtaConnection *) "b";
+
+LONGBOW_TEST_RUNNER(forwarder_Demux)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(forwarder_Demux)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(forwarder_Demux)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_AttachDetach);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_TakeInterest);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_TakeInterest_Expired);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_TakeInterest_Batches);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_MatchPrefix_Longest);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_RemovePrefix_Shared);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_TakeControl);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_DetachConnection_Purges);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_Hold_InOrder);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_Hold_PerConnection);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderDemux_DetachConnection_DestroysHeld);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    ForwarderDemux *demux = forwarderDemux_Create();
+    forwarderDemux_AttachConnection(demux, connA);
+    forwarderDemux_AttachConnection(demux, connB);
+    longBowTestCase_SetClipBoardData(testCase, demux);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    forwarderDemux_Destroy(&demux);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_AttachDetach)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    assertTrue(forwarderDemux_GetConnectionCount(demux) == 2, "Wrong connection count, got %zu expected 2",
+               forwarderDemux_GetConnectionCount(demux));
+
+    forwarderDemux_DetachConnection(demux, connA);
+    assertTrue(forwarderDemux_GetConnectionCount(demux) == 1, "Wrong connection count, got %zu expected 1",
+               forwarderDemux_GetConnectionCount(demux));
+    assertTrue(forwarderDemux_GetConnection(demux, 0) == connB, "Wrong connection left attached");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_TakeInterest)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxName *other = ccnxName_CreateFromURI("lci:/foo/car");
+
+    forwarderDemux_AddInterest(demux, name, connA, 100, 0);
+    forwarderDemux_AddInterest(demux, name, connA, 200, 0);
+    forwarderDemux_AddInterest(demux, name, connB, 100, 0);
+    forwarderDemux_AddInterest(demux, other, connB, 100, 0);
+    assertTrue(forwarderDemux_GetInterestCount(demux) == 3, "Wrong interest count, got %zu expected 3",
+               forwarderDemux_GetInterestCount(demux));
+
+    RtaConnection *waiters[4];
+    size_t count = forwarderDemux_TakeInterest(demux, name, 150, waiters, 4);
+    assertTrue(count == 1, "Wrong count, got %zu expected 1", count);
+    assertTrue(waiters[0] == connA, "Expected the connection whose Interest has not expired");
+
+    count = forwarderDemux_TakeInterest(demux, name, 150, waiters, 4);
+    assertTrue(count == 0, "Interests should only be satisfied once, got %zu", count);
+
+    count = forwarderDemux_TakeInterest(demux, other, 50, waiters, 4);
+    assertTrue(count == 1 && waiters[0] == connB, "Expected connB for the other name");
+
+    ccnxName_Release(&name);
+    ccnxName_Release(&other);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_TakeInterest_Expired)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxName *other = ccnxName_CreateFromURI("lci:/foo/car");
+
+    forwarderDemux_AddInterest(demux, name, connA, 100, 0);
+    forwarderDemux_AddInterest(demux, other, connB, 500, 200);
+    assertTrue(forwarderDemux_GetInterestCount(demux) == 1, "Adding should drop the expired Interest, got %zu",
+               forwarderDemux_GetInterestCount(demux));
+
+    RtaConnection *waiters[4];
+    size_t count = forwarderDemux_TakeInterest(demux, name, 200, waiters, 4);
+    assertTrue(count == 0, "An expired Interest should not match, got %zu", count);
+
+    ccnxName_Release(&name);
+    ccnxName_Release(&other);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_TakeInterest_Batches)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+
+    char tokens[5];
+    for (int i = 0; i < 5; i++) {
+        forwarderDemux_AttachConnection(demux, (RtaConnection *) &tokens[i]);
+        forwarderDemux_AddInterest(demux, name, (RtaConnection *) &tokens[i], 100, 0);
+    }
+
+    RtaConnection *waiters[2];
+    size_t total = 0;
+    size_t count;
+    while ((count = forwarderDemux_TakeInterest(demux, name, 0, waiters, 2)) > 0) {
+        assertTrue(count <= 2, "Returned more than the batch size, got %zu", count);
+        total += count;
+    }
+    assertTrue(total == 5, "Wrong number of waiters, got %zu expected 5", total);
+    assertTrue(forwarderDemux_GetInterestCount(demux) == 0, "Interests left over, got %zu",
+               forwarderDemux_GetInterestCount(demux));
+
+    ccnxName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_MatchPrefix_Longest)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *shortPrefix = ccnxName_CreateFromURI("lci:/foo");
+    CCNxName *longPrefix = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar/baz");
+    CCNxName *shortName = ccnxName_CreateFromURI("lci:/foo/car");
+    CCNxName *miss = ccnxName_CreateFromURI("lci:/goo");
+
+    forwarderDemux_AddPrefix(demux, shortPrefix, connA);
+    forwarderDemux_AddPrefix(demux, longPrefix, connB);
+
+    assertTrue(forwarderDemux_MatchPrefix(demux, name) == connB, "Expected the longest prefix");
+    assertTrue(forwarderDemux_MatchPrefix(demux, shortName) == connA, "Expected the short prefix");
+    assertNull(forwarderDemux_MatchPrefix(demux, miss), "Expected no match");
+
+    ccnxName_Release(&shortPrefix);
+    ccnxName_Release(&longPrefix);
+    ccnxName_Release(&name);
+    ccnxName_Release(&shortName);
+    ccnxName_Release(&miss);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_RemovePrefix_Shared)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *prefix = ccnxName_CreateFromURI("lci:/foo");
+
+    forwarderDemux_AddPrefix(demux, prefix, connA);
+    forwarderDemux_AddPrefix(demux, prefix, connB);
+
+    assertFalse(forwarderDemux_RemovePrefix(demux, prefix, connA), "connB still has the prefix registered");
+    assertTrue(forwarderDemux_MatchPrefix(demux, prefix) == connB, "Expected connB to keep the prefix");
+    assertTrue(forwarderDemux_RemovePrefix(demux, prefix, connB), "No connection has the prefix registered");
+    assertNull(forwarderDemux_MatchPrefix(demux, prefix), "Expected no match after both unregistered");
+
+    ccnxName_Release(&prefix);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_TakeControl)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+
+    forwarderDemux_AddControl(demux, 7, connA);
+    forwarderDemux_AddControl(demux, 8, connB);
+
+    assertTrue(forwarderDemux_TakeControl(demux, 8) == connB, "Wrong connection for sequence 8");
+    assertNull(forwarderDemux_TakeControl(demux, 8), "Sequence 8 should only be taken once");
+    assertNull(forwarderDemux_TakeControl(demux, 9), "Sequence 9 was never added");
+    assertTrue(forwarderDemux_TakeControl(demux, 7) == connA, "Wrong connection for sequence 7");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_DetachConnection_Purges)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+
+    forwarderDemux_AddInterest(demux, name, connA, 100, 0);
+    forwarderDemux_AddInterest(demux, name, connB, 100, 0);
+    forwarderDemux_AddPrefix(demux, name, connA);
+    forwarderDemux_AddControl(demux, 7, connA);
+
+    forwarderDemux_DetachConnection(demux, connA);
+
+    RtaConnection *waiters[4];
+    size_t count = forwarderDemux_TakeInterest(demux, name, 0, waiters, 4);
+    assertTrue(count == 1 && waiters[0] == connB, "Only connB should still be waiting");
+    assertNull(forwarderDemux_MatchPrefix(demux, name), "connA's prefix should be gone");
+    assertNull(forwarderDemux_TakeControl(demux, 7), "connA's control request should be gone");
+
+    ccnxName_Release(&name);
+}
+
+static TransportMessage *
+_createTransportMessage(void)
+{
+    CCNxName *name = ccnxName_CreateFromURI("lci:/foo/bar");
+    CCNxInterest *interest = ccnxInterest_CreateSimple(name);
+    TransportMessage *tm = transportMessage_CreateFromDictionary(interest);
+    ccnxInterest_Release(&interest);
+    ccnxName_Release(&name);
+    return tm;
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_Hold_InOrder)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+
+    TransportMessage *held[3];
+    for (int i = 0; i < 3; i++) {
+        held[i] = _createTransportMessage();
+        forwarderDemux_Hold(demux, connA, held[i]);
+    }
+    assertTrue(forwarderDemux_GetHeldCount(demux, connA) == 3, "Wrong held count, got %zu expected 3",
+               forwarderDemux_GetHeldCount(demux, connA));
+
+    for (int i = 0; i < 3; i++) {
+        TransportMessage *tm = forwarderDemux_TakeHeld(demux, connA);
+        assertTrue(tm == held[i], "Held packet %d out of order, got %p expected %p", i, (void *) tm, (void *) held[i]);
+        transportMessage_Destroy(&tm);
+    }
+    assertNull(forwarderDemux_TakeHeld(demux, connA), "connA should hold nothing");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_Hold_PerConnection)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+
+    forwarderDemux_Hold(demux, connA, _createTransportMessage());
+    forwarderDemux_Hold(demux, connB, _createTransportMessage());
+    forwarderDemux_Hold(demux, connB, _createTransportMessage());
+
+    assertTrue(forwarderDemux_GetHeldCount(demux, connA) == 1, "Wrong held count for connA, got %zu expected 1",
+               forwarderDemux_GetHeldCount(demux, connA));
+    assertTrue(forwarderDemux_GetHeldCount(demux, connB) == 2, "Wrong held count for connB, got %zu expected 2",
+               forwarderDemux_GetHeldCount(demux, connB));
+    assertTrue(forwarderDemux_GetMostHeld(demux) == 2, "Wrong most held, got %zu expected 2",
+               forwarderDemux_GetMostHeld(demux));
+
+    // the rest are destroyed with the demux
+    TransportMessage *tm = forwarderDemux_TakeHeld(demux, connB);
+    transportMessage_Destroy(&tm);
+    assertTrue(forwarderDemux_GetMostHeld(demux) == 1, "Wrong most held, got %zu expected 1",
+               forwarderDemux_GetMostHeld(demux));
+}
+
+LONGBOW_TEST_CASE(Global, forwarderDemux_DetachConnection_DestroysHeld)
+{
+    ForwarderDemux *demux = longBowTestCase_GetClipBoardData(testCase);
+
+    forwarderDemux_Hold(demux, connA, _createTransportMessage());
+    forwarderDemux_Hold(demux, connA, _createTransportMessage());
+    forwarderDemux_Hold(demux, connB, _createTransportMessage());
+
+    forwarderDemux_DetachConnection(demux, connA);
+    assertTrue(forwarderDemux_GetHeldCount(demux, connB) == 1, "connB should still hold its packet");
+    assertTrue(forwarderDemux_GetMostHeld(demux) == 1, "Wrong most held, got %zu expected 1",
+               forwarderDemux_GetMostHeld(demux));
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(forwarder_Demux);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
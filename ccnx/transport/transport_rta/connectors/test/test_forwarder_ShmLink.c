@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../forwarder_ShmLink.c"
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+typedef struct test_data {
+    // fds[0] is the creator's doorbell, fds[1] the peer's
+    int fds[2];
+    ForwarderShmLink *creator;
+    ForwarderShmLink *peer;
+} TestData;
+
+LONGBOW_TEST_RUNNER(forwarder_ShmLink)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(forwarder_ShmLink)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(forwarder_ShmLink)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_Accept);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_Accept_BadHello);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_WriteRead);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_WriteRead_Wrap);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_Write_Full);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_Notify_DataWaiting);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_Notify_NotWaiting);
+    LONGBOW_RUN_TEST_CASE(Global, forwarderShmLink_DrainDoorbell_Closed);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    assertTrue(socketpair(PF_UNIX, SOCK_STREAM, 0, data->fds) == 0, "socketpair failed: (%d) %s", errno, strerror(errno));
+
+    char name[SHMLINK_NAME_LENGTH];
+    snprintf(name, sizeof(name), "/test_shmlink.%d", getpid());
+    data->creator = forwarderShmLink_Create(name, SHMLINK_MIN_CAPACITY);
+    assertNotNull(data->creator, "Could not create %s: (%d) %s", name, errno, strerror(errno));
+
+    assertTrue(forwarderShmLink_SendHello(data->creator, data->fds[0]), "Could not send the hello");
+    data->peer = forwarderShmLink_Accept(data->fds[1]);
+    assertNotNull(data->peer, "Could not accept %s", name);
+
+    fcntl(data->fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(data->fds[1], F_SETFL, O_NONBLOCK);
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    forwarderShmLink_Destroy(&data->creator);
+    forwarderShmLink_Destroy(&data->peer);
+    close(data->fds[0]);
+    close(data->fds[1]);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_Accept)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(data->peer->capacity == SHMLINK_MIN_CAPACITY, "Wrong capacity, got %zu expected %d",
+               data->peer->capacity, SHMLINK_MIN_CAPACITY);
+    assertTrue(data->creator->tx - data->creator->header->rings == data->peer->rx - data->peer->header->rings,
+               "The creator should write the ring the peer reads");
+
+    // the peer unlinked the name once it had the segment open
+    int shmfd = shm_open(data->creator->name, O_RDWR, 0600);
+    assertTrue(shmfd < 0, "The segment name should be unlinked after the accept");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_Accept_BadHello)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    ShmHello hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.magic = SHMLINK_MAGIC + 1;
+    send(data->fds[0], &hello, sizeof(hello), 0);
+
+    fcntl(data->fds[1], F_SETFL, 0);
+    ForwarderShmLink *link = forwarderShmLink_Accept(data->fds[1]);
+    assertNull(link, "A hello with the wrong magic should not open a link");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_WriteRead)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const char truth[] = "hello metis";
+    char test[sizeof(truth)];
+
+    size_t nwritten = forwarderShmLink_Write(data->creator, truth, sizeof(truth));
+    assertTrue(nwritten == sizeof(truth), "Short write, got %zu expected %zu", nwritten, sizeof(truth));
+
+    size_t nread = forwarderShmLink_Read(data->peer, test, sizeof(test));
+    assertTrue(nread == sizeof(truth), "Short read, got %zu expected %zu", nread, sizeof(truth));
+    assertTrue(memcmp(test, truth, sizeof(truth)) == 0, "Wrong bytes read");
+
+    nread = forwarderShmLink_Read(data->creator, test, sizeof(test));
+    assertTrue(nread == 0, "The other direction should be empty, got %zu", nread);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_WriteRead_Wrap)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t truth[SHMLINK_MIN_CAPACITY / 2 + 100];
+    uint8_t test[sizeof(truth)];
+
+    // three passes of more than half the ring cross its end
+    for (int pass = 0; pass < 3; pass++) {
+        for (size_t i = 0; i < sizeof(truth); i++) {
+            truth[i] = (uint8_t) (i + pass);
+        }
+
+        size_t nwritten = forwarderShmLink_Write(data->peer, truth, sizeof(truth));
+        assertTrue(nwritten == sizeof(truth), "Pass %d short write, got %zu", pass, nwritten);
+
+        size_t nread = forwarderShmLink_Read(data->creator, test, sizeof(test));
+        assertTrue(nread == sizeof(truth), "Pass %d short read, got %zu", pass, nread);
+        assertTrue(memcmp(test, truth, sizeof(truth)) == 0, "Pass %d wrong bytes read", pass);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_Write_Full)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t bytes[SHMLINK_MIN_CAPACITY + 10];
+    memset(bytes, 0xA5, sizeof(bytes));
+
+    size_t nwritten = forwarderShmLink_Write(data->creator, bytes, sizeof(bytes));
+    assertTrue(nwritten == SHMLINK_MIN_CAPACITY, "Should fill the ring, got %zu", nwritten);
+    assertTrue(data->creator->tx->spaceWaiting, "A full ring should be marked waiting for space");
+
+    // reading makes space, so the reader rings the writer's doorbell
+    size_t nread = forwarderShmLink_Read(data->peer, bytes, 10);
+    assertTrue(nread == 10, "Wrong read, got %zu", nread);
+    assertTrue(forwarderShmLink_Notify(data->peer, data->fds[1]), "Notify failed");
+
+    ssize_t rings = forwarderShmLink_DrainDoorbell(data->fds[0]);
+    assertTrue(rings == 1, "Expected one doorbell, got %zd", rings);
+    assertFalse(data->creator->tx->spaceWaiting, "The mark should be cleared by the doorbell");
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_Notify_DataWaiting)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t byte = 1;
+
+    size_t nread = forwarderShmLink_Read(data->peer, &byte, 1);
+    assertTrue(nread == 0, "The ring should be empty, got %zu", nread);
+
+    forwarderShmLink_Write(data->creator, &byte, 1);
+    assertTrue(forwarderShmLink_Notify(data->creator, data->fds[0]), "Notify failed");
+    assertTrue(forwarderShmLink_Notify(data->creator, data->fds[0]), "Notify failed");
+
+    ssize_t rings = forwarderShmLink_DrainDoorbell(data->fds[1]);
+    assertTrue(rings == 1, "Expected one doorbell per wait, got %zd", rings);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_Notify_NotWaiting)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t bytes[2] = { 1, 2 };
+
+    // a new ring's reader waits for the first write
+    forwarderShmLink_Write(data->creator, bytes, 2);
+    assertTrue(forwarderShmLink_Notify(data->creator, data->fds[0]), "Notify failed");
+    ssize_t rings = forwarderShmLink_DrainDoorbell(data->fds[1]);
+    assertTrue(rings == 1, "The first write should ring the doorbell, got %zd", rings);
+
+    // the reader leaves a byte in the ring, so it is not waiting
+    forwarderShmLink_Read(data->peer, bytes, 1);
+    forwarderShmLink_Write(data->creator, bytes, 1);
+    assertTrue(forwarderShmLink_Notify(data->creator, data->fds[0]), "Notify failed");
+
+    rings = forwarderShmLink_DrainDoorbell(data->fds[1]);
+    assertTrue(rings == 0, "A reader that is not waiting needs no doorbell, got %zd", rings);
+}
+
+LONGBOW_TEST_CASE(Global, forwarderShmLink_DrainDoorbell_Closed)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    shutdown(data->fds[0], SHUT_WR);
+    ssize_t rings = forwarderShmLink_DrainDoorbell(data->fds[1]);
+    assertTrue(rings == -1, "A closed doorbell should return -1, got %zd", rings);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(forwarder_ShmLink);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
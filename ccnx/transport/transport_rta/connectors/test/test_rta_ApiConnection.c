@@ -54,7 +54,7 @@ typedef struct test_data {
 } TestData;
 
 static TestData *
-_commonSetup(void)
+_commonSetup(bool virtualClock)
 {
     TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
     assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
@@ -64,6 +64,10 @@ _commonSetup(void)
     data->framework = rtaFramework_Create(data->commandRingBuffer, data->commandNotifier);
     assertNotNull(data->framework, "rtaFramework_Create returned null");
 
+    if (virtualClock) {
+        rtaFramework_NonThreadedUseVirtualClock(data->framework, &(struct timeval) { .tv_sec = 1000, .tv_usec = 0 });
+    }
+
     CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
 
     apiConnector_ProtocolStackConfig(stackConfig);
@@ -128,6 +132,7 @@ _commonTeardown(TestData *data)
 LONGBOW_TEST_RUNNER(rta_ApiConnection)
 {
     LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(VirtualClock);
 }
 
 // The Test Runner calls this function once before any Test Fixtures are run.
@@ -155,11 +160,15 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_SendToApi);
 
     LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_UnblockDown);
+    LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_FlowControl_MessageBudget);
+    LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_FlowControl_OverMessageBudget_Delivered);
+    LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_FlowControl_OverByteBudget_Delivered);
+    LONGBOW_RUN_TEST_CASE(Global, rtaApiConnection_SendToApi_ControlInOrder);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
 {
-    longBowTestCase_SetClipBoardData(testCase, _commonSetup());
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(false));
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
@@ -210,6 +219,48 @@ LONGBOW_TEST_CASE(Global, rtaApiConnection_SendToApi)
     transportMessage_Destroy(&tm);
 }
 
+/**
+ * A control message written while data waits in the output buffer, like a CONNECTION_CLOSED,
+ * reaches the API after that data
+ */
+LONGBOW_TEST_CASE(Global, rtaApiConnection_SendToApi_ControlInOrder)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+    RtaComponentStats *stats = rtaConnection_GetStats(data->connection, API_CONNECTOR);
+
+    // The output buffer is only written to the socket when the dispatcher runs
+    for (int i = 0; i < 3; i++) {
+        TransportMessage *tm = trafficTools_CreateTransportMessageWithDictionaryInterest(data->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        rtaApiConnection_SendToApi(apiConnection, tm, stats);
+        transportMessage_Destroy(&tm);
+    }
+
+    TransportMessage *control = trafficTools_CreateTransportMessageWithDictionaryControl(data->connection, CCNxTlvDictionary_SchemaVersion_V1);
+    rtaApiConnection_SendToApi(apiConnection, control, stats);
+    rtaFramework_NonThreadedStepCount(data->framework, 10);
+
+    for (int i = 0; i < 4; i++) {
+        CCNxMetaMessage *testMessage;
+        ssize_t bytesRead = read(data->api_fds[PAIR_OTHER], &testMessage, sizeof(testMessage));
+        assertTrue(bytesRead == sizeof(testMessage), "Wrong read size, got %zd expected %zd", bytesRead, sizeof(testMessage));
+        if (i == 3) {
+            assertTrue(testMessage == transportMessage_GetDictionary(control),
+                       "The control message should be read last, got %p expected %p",
+                       (void *) testMessage, (void *) transportMessage_GetDictionary(control));
+        }
+        ccnxMetaMessage_Release(&testMessage);
+    }
+
+    rtaApiConnection_UpdateFlowControl(apiConnection);
+    assertTrue(rtaApiConnection_GetQueuedMessages(apiConnection) == 0,
+               "Wrong queued messages, got %zu expected 0", rtaApiConnection_GetQueuedMessages(apiConnection));
+    assertTrue(rtaApiConnection_GetQueuedBytes(apiConnection) == 0,
+               "Wrong queued bytes, got %zu expected 0", rtaApiConnection_GetQueuedBytes(apiConnection));
+
+    transportMessage_Destroy(&control);
+}
+
 LONGBOW_TEST_CASE(Global, rtaApiConnection_BlockDown)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -286,6 +337,164 @@ LONGBOW_TEST_CASE(Global, rtaApiConnection_UnblockDown)
     rtaApiConnection_Destroy(&apiConnection);
 }
 
+LONGBOW_TEST_CASE(Global, rtaApiConnection_FlowControl_MessageBudget)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+    RtaComponentStats *stats = rtaConnection_GetStats(data->connection, API_CONNECTOR);
+
+    // block above 2 messages, unblock at 1
+    apiConnection->maxQueueMessages = 2;
+
+    for (int i = 0; i < 3; i++) {
+        TransportMessage *tm = trafficTools_CreateTransportMessageWithDictionaryInterest(data->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        rtaApiConnection_SendToApi(apiConnection, tm, stats);
+        transportMessage_Destroy(&tm);
+    }
+    rtaFramework_NonThreadedStepCount(data->framework, 10);
+
+    assertTrue(rtaApiConnection_GetQueuedMessages(apiConnection) == 3,
+               "Wrong queued messages, got %zu expected 3", rtaApiConnection_GetQueuedMessages(apiConnection));
+    assertTrue(rtaApiConnection_GetQueuedBytes(apiConnection) >= 3 * sizeof(CCNxMetaMessage *),
+               "Queued bytes too small, got %zu", rtaApiConnection_GetQueuedBytes(apiConnection));
+    assertTrue(rtaConnection_BlockedUp(data->connection), "Connection should be blocked up over the message budget");
+    assertTrue(rtaApiConnection_GetBlockedCount(apiConnection) == 1,
+               "Wrong blocked count, got %" PRIu64 " expected 1", rtaApiConnection_GetBlockedCount(apiConnection));
+
+    // The API reads everything
+    for (int i = 0; i < 3; i++) {
+        CCNxMetaMessage *testMessage;
+        ssize_t bytesRead = read(data->api_fds[PAIR_OTHER], &testMessage, sizeof(testMessage));
+        assertTrue(bytesRead == sizeof(testMessage), "Wrong read size, got %zd expected %zd", bytesRead, sizeof(testMessage));
+        ccnxMetaMessage_Release(&testMessage);
+    }
+
+    rtaApiConnection_UpdateFlowControl(apiConnection);
+    assertFalse(rtaConnection_BlockedUp(data->connection), "Connection should be unblocked after the API read its messages");
+    assertTrue(rtaApiConnection_GetQueuedMessages(apiConnection) == 0,
+               "Wrong queued messages, got %zu expected 0", rtaApiConnection_GetQueuedMessages(apiConnection));
+    assertTrue(rtaApiConnection_GetQueuedBytes(apiConnection) == 0,
+               "Wrong queued bytes, got %zu expected 0", rtaApiConnection_GetQueuedBytes(apiConnection));
+}
+
+/**
+ * Puts `count` Interests up the stack from the bottom component, then reads them all from
+ * the API's side of the socket in order.  Going over the budget must not drop any.
+ */
+static void
+_sendUpStackAndReadAll(TestData *data, size_t count)
+{
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+    PARCEventQueue *lowerUp = rtaProtocolStack_GetPutQueue(data->stack, TESTING_LOWER, RTA_UP);
+
+    CCNxMetaMessage *sent[count];
+    for (size_t i = 0; i < count; i++) {
+        TransportMessage *tm = trafficTools_CreateTransportMessageWithDictionaryInterest(data->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        sent[i] = transportMessage_GetDictionary(tm);
+        rtaComponent_PutMessage(lowerUp, tm);
+    }
+    rtaFramework_NonThreadedStepCount(data->framework, 10);
+
+    assertTrue(rtaConnection_BlockedUp(data->connection), "Connection should be blocked up over the budget");
+    assertTrue(rtaApiConnection_GetQueuedMessages(apiConnection) == count,
+               "Wrong queued messages, got %zu expected %zu", rtaApiConnection_GetQueuedMessages(apiConnection), count);
+
+    for (size_t i = 0; i < count; i++) {
+        CCNxMetaMessage *testMessage;
+        ssize_t bytesRead = read(data->api_fds[PAIR_OTHER], &testMessage, sizeof(testMessage));
+        assertTrue(bytesRead == sizeof(testMessage), "Message %zu: wrong read size, got %zd expected %zd", i, bytesRead, sizeof(testMessage));
+        assertTrue(testMessage == sent[i], "Message %zu out of order, got %p expected %p", i, (void *) testMessage, (void *) sent[i]);
+        ccnxMetaMessage_Release(&testMessage);
+    }
+
+    rtaApiConnection_UpdateFlowControl(apiConnection);
+    assertFalse(rtaConnection_BlockedUp(data->connection), "Connection should be unblocked after the API read its messages");
+}
+
+LONGBOW_TEST_CASE(Global, rtaApiConnection_FlowControl_OverMessageBudget_Delivered)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+
+    apiConnection->maxQueueMessages = 2;
+    _sendUpStackAndReadAll(data, 10);
+}
+
+LONGBOW_TEST_CASE(Global, rtaApiConnection_FlowControl_OverByteBudget_Delivered)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+
+    apiConnection->maxQueueBytes = 2 * sizeof(CCNxMetaMessage *);
+    _sendUpStackAndReadAll(data, 10);
+}
+
+
+// ==========================================================================================
+
+LONGBOW_TEST_FIXTURE(VirtualClock)
+{
+    LONGBOW_RUN_TEST_CASE(VirtualClock, rtaApiConnection_PollTimer_Unblocks);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(VirtualClock)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup(true));
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(VirtualClock)
+{
+    _commonTeardown(longBowTestCase_GetClipBoardData(testCase));
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * While blocked up, the poll timer runs on the framework's clock, so stepping virtual time
+ * past API_QUEUE_POLL_USEC notices the API drained its socket and unblocks the connection.
+ */
+LONGBOW_TEST_CASE(VirtualClock, rtaApiConnection_PollTimer_Unblocks)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaApiConnection *apiConnection = rtaConnection_GetPrivateData(data->connection, API_CONNECTOR);
+    RtaComponentStats *stats = rtaConnection_GetStats(data->connection, API_CONNECTOR);
+
+    apiConnection->maxQueueMessages = 2;
+
+    for (int i = 0; i < 3; i++) {
+        TransportMessage *tm = trafficTools_CreateTransportMessageWithDictionaryInterest(data->connection, CCNxTlvDictionary_SchemaVersion_V1);
+        rtaApiConnection_SendToApi(apiConnection, tm, stats);
+        transportMessage_Destroy(&tm);
+    }
+    rtaFramework_NonThreadedStepCount(data->framework, 10);
+
+    assertTrue(rtaConnection_BlockedUp(data->connection), "Connection should be blocked up over the message budget");
+    assertTrue(rtaTimer_IsPending(apiConnection->pollTimer), "Poll timer should be pending while blocked up");
+
+    for (int i = 0; i < 3; i++) {
+        CCNxMetaMessage *testMessage;
+        ssize_t bytesRead = read(data->api_fds[PAIR_OTHER], &testMessage, sizeof(testMessage));
+        assertTrue(bytesRead == sizeof(testMessage), "Wrong read size, got %zd expected %zd", bytesRead, sizeof(testMessage));
+        ccnxMetaMessage_Release(&testMessage);
+    }
+
+    // Nothing has advanced the virtual clock yet, so only the poll timer can unblock us
+    rtaFramework_NonThreadedStepCount(data->framework, 10);
+    assertTrue(rtaConnection_BlockedUp(data->connection), "Connection unblocked before the poll timer fired");
+
+    struct timeval step = { .tv_sec = 0, .tv_usec = 2 * API_QUEUE_POLL_USEC };
+    rtaFramework_NonThreadedStepTimed(data->framework, &step);
+
+    assertFalse(rtaConnection_BlockedUp(data->connection), "Poll timer did not unblock the connection");
+    assertFalse(rtaTimer_IsPending(apiConnection->pollTimer), "Poll timer still pending after unblocking");
+}
+
 int
 main(int argc, char *argv[])
 {
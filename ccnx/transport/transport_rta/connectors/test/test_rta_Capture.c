@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_Capture.c"
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+typedef struct test_data {
+    char path[64];
+} TestData;
+
+static void
+_writeFile(const char *path, const void *bytes, size_t length)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assertTrue(fd >= 0, "Could not create %s: %s", path, strerror(errno));
+    ssize_t nwritten = write(fd, bytes, length);
+    assertTrue(nwritten == (ssize_t) length, "Short write to %s", path);
+    close(fd);
+}
+
+static void
+_assertRecord(RtaCaptureReader *reader, unsigned connectionId, RtaCaptureDirection direction, const void *bytes, size_t length)
+{
+    RtaCaptureRecord record;
+    assertTrue(rtaCaptureReader_Next(reader, &record), "Expected a record for connection %u", connectionId);
+    assertTrue(record.connectionId == connectionId, "Wrong connection id, got %u expected %u", record.connectionId, connectionId);
+    assertTrue(record.direction == direction, "Wrong direction, got %d expected %d", record.direction, direction);
+    assertTrue(record.timestampUsec > 0, "Got a zero timestamp");
+    assertTrue(parcBuffer_Remaining(record.packet) == length,
+               "Wrong length, got %zu expected %zu", parcBuffer_Remaining(record.packet), length);
+    assertTrue(memcmp(parcBuffer_Overlay(record.packet, 0), bytes, length) == 0, "Wrong packet bytes");
+    parcBuffer_Release(&record.packet);
+}
+
+LONGBOW_TEST_RUNNER(rta_Capture)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_Capture)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_Capture)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, rtaCapture_WriteAndRead);
+    LONGBOW_RUN_TEST_CASE(Global, rtaCapture_WriteIoVec);
+    LONGBOW_RUN_TEST_CASE(Global, rtaCapture_LargeRecord);
+    LONGBOW_RUN_TEST_CASE(Global, rtaCapture_Open_Append);
+    LONGBOW_RUN_TEST_CASE(Global, rtaCapture_Open_NotACapture);
+    LONGBOW_RUN_TEST_CASE(Global, rtaCaptureReader_Next_Truncated);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+    snprintf(data->path, sizeof(data->path), "/tmp/test_rta_Capture.%d", getpid());
+    unlink(data->path);
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    unlink(data->path);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, rtaCapture_WriteAndRead)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t down[] = { 1, 0, 0, 12, 0, 0, 0, 8, 0xAA, 0xBB, 0xCC, 0xDD };
+    uint8_t up[] = { 1, 1, 0, 9, 0, 0, 0, 8, 0xEE };
+
+    RtaCapture *capture = rtaCapture_Open(data->path);
+    assertNotNull(capture, "Could not open capture %s", data->path);
+
+    PARCBuffer *buffer = parcBuffer_Wrap(down, sizeof(down), 0, sizeof(down));
+    rtaCapture_WriteBuffer(capture, 7, RtaCaptureDirection_Down, buffer);
+    assertTrue(parcBuffer_Position(buffer) == 0, "rtaCapture_WriteBuffer moved the position");
+    parcBuffer_Release(&buffer);
+
+    buffer = parcBuffer_Wrap(up, sizeof(up), 0, sizeof(up));
+    rtaCapture_WriteBuffer(capture, 9, RtaCaptureDirection_Up, buffer);
+    parcBuffer_Release(&buffer);
+
+    assertTrue(rtaCapture_GetRecordCount(capture) == 2, "Wrong record count, got %" PRIu64, rtaCapture_GetRecordCount(capture));
+    rtaCapture_Close(&capture);
+    assertNull(capture, "rtaCapture_Close did not NULL the pointer");
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    assertNotNull(reader, "Could not open reader %s", data->path);
+    _assertRecord(reader, 7, RtaCaptureDirection_Down, down, sizeof(down));
+    _assertRecord(reader, 9, RtaCaptureDirection_Up, up, sizeof(up));
+
+    RtaCaptureRecord record;
+    assertFalse(rtaCaptureReader_Next(reader, &record), "Expected the end of the capture");
+    rtaCaptureReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Global, rtaCapture_WriteIoVec)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t first[] = { 1, 0, 0, 12 };
+    uint8_t second[] = { 0, 0, 0, 8, 0xAA, 0xBB, 0xCC, 0xDD };
+    uint8_t truth[] = { 1, 0, 0, 12, 0, 0, 0, 8, 0xAA, 0xBB, 0xCC, 0xDD };
+
+    struct iovec iov[2] = {
+        { .iov_base = first,  .iov_len = sizeof(first)  },
+        { .iov_base = second, .iov_len = sizeof(second) },
+    };
+
+    RtaCapture *capture = rtaCapture_Open(data->path);
+    rtaCapture_WriteIoVec(capture, 3, RtaCaptureDirection_Down, 2, iov);
+    rtaCapture_Close(&capture);
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    _assertRecord(reader, 3, RtaCaptureDirection_Down, truth, sizeof(truth));
+    rtaCaptureReader_Close(&reader);
+}
+
+/**
+ * A record bigger than the batch buffer is written directly, after the records already buffered
+ */
+LONGBOW_TEST_CASE(Global, rtaCapture_LargeRecord)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t small[] = { 1, 2, 3 };
+
+    size_t largeLength = CAPTURE_BUFFER_BYTES + 100;
+    uint8_t *large = parcMemory_Allocate(largeLength);
+    for (size_t i = 0; i < largeLength; i++) {
+        large[i] = (uint8_t) i;
+    }
+
+    RtaCapture *capture = rtaCapture_Open(data->path);
+    struct iovec iov = { .iov_base = small, .iov_len = sizeof(small) };
+    rtaCapture_WriteIoVec(capture, 1, RtaCaptureDirection_Up, 1, &iov);
+    iov = (struct iovec) { .iov_base = large, .iov_len = largeLength };
+    rtaCapture_WriteIoVec(capture, 1, RtaCaptureDirection_Up, 1, &iov);
+    iov = (struct iovec) { .iov_base = small, .iov_len = sizeof(small) };
+    rtaCapture_WriteIoVec(capture, 2, RtaCaptureDirection_Down, 1, &iov);
+    rtaCapture_Close(&capture);
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    _assertRecord(reader, 1, RtaCaptureDirection_Up, small, sizeof(small));
+    _assertRecord(reader, 1, RtaCaptureDirection_Up, large, largeLength);
+    _assertRecord(reader, 2, RtaCaptureDirection_Down, small, sizeof(small));
+    rtaCaptureReader_Close(&reader);
+
+    parcMemory_Deallocate((void **) &large);
+}
+
+/**
+ * Opening an existing capture appends to it without a second file header
+ */
+LONGBOW_TEST_CASE(Global, rtaCapture_Open_Append)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t packet[] = { 1, 2, 3, 4 };
+    struct iovec iov = { .iov_base = packet, .iov_len = sizeof(packet) };
+
+    RtaCapture *first = rtaCapture_Open(data->path);
+    RtaCapture *second = rtaCapture_Open(data->path);
+    assertNotNull(second, "Could not open an existing capture");
+
+    rtaCapture_WriteIoVec(first, 1, RtaCaptureDirection_Down, 1, &iov);
+    rtaCapture_WriteIoVec(second, 2, RtaCaptureDirection_Down, 1, &iov);
+    rtaCapture_Close(&first);
+    rtaCapture_Close(&second);
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    _assertRecord(reader, 1, RtaCaptureDirection_Down, packet, sizeof(packet));
+    _assertRecord(reader, 2, RtaCaptureDirection_Down, packet, sizeof(packet));
+    rtaCaptureReader_Close(&reader);
+}
+
+LONGBOW_TEST_CASE(Global, rtaCapture_Open_NotACapture)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const char text[] = "not a capture file";
+    _writeFile(data->path, text, sizeof(text));
+
+    RtaCapture *capture = rtaCapture_Open(data->path);
+    assertNull(capture, "Opened a file that is not a capture");
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    assertNull(reader, "Read a file that is not a capture");
+}
+
+/**
+ * A record cut short ends the capture without returning the partial packet
+ */
+LONGBOW_TEST_CASE(Global, rtaCaptureReader_Next_Truncated)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    uint8_t bytes[FILE_HEADER_LENGTH + RECORD_HEADER_LENGTH + 2];
+    memcpy(bytes, _fileHeader, FILE_HEADER_LENGTH);
+    _encodeRecordHeader(bytes + FILE_HEADER_LENGTH, 1, 1, RtaCaptureDirection_Up, 10);
+    bytes[FILE_HEADER_LENGTH + RECORD_HEADER_LENGTH] = 0xAA;
+    bytes[FILE_HEADER_LENGTH + RECORD_HEADER_LENGTH + 1] = 0xBB;
+    _writeFile(data->path, bytes, sizeof(bytes));
+
+    RtaCaptureReader *reader = rtaCaptureReader_Open(data->path);
+    assertNotNull(reader, "Could not open reader %s", data->path);
+
+    RtaCaptureRecord record;
+    assertFalse(rtaCaptureReader_Next(reader, &record), "Returned a truncated record");
+    rtaCaptureReader_Close(&reader);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_Capture);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -42,7 +42,7 @@ typedef enum {
     FC_VEGAS = 2,
     FC_PIPELINE = 3,
     // vacant          = 4,
-    // vacant          = 5,
+    VERIFY_ENUMERATED = 5,
     // vacant          = 6,
     CODEC_NONE = 7,
     CODEC_UNSPEC = 8,
@@ -56,7 +56,9 @@ typedef enum {
     TESTING_UPPER = 16,
     TESTING_LOWER = 17,
     FWD_METIS = 19,
-    LAST_COMPONENT = 20,      // MUST ALWAYS BE LAST
+    CACHE = 20,
+    PIT = 21,
+    LAST_COMPONENT = 22,      // MUST ALWAYS BE LAST
     UNKNOWN_COMPONENT         // MUST BE VERY LAST
 } RtaComponents;
 
@@ -220,6 +220,7 @@
  * Close:        Per connection close
  * Release:      One time release of state when whole stack taken down
  * stateChagne:  Called when there is a state change related to the connection
+ * flush:        Per connection, just before close, send on whatever the component still holds
  *
  * Example:
  * @code
@@ -236,6 +237,7 @@ typedef struct {
     int (*close)(RtaConnection *conn);
     int (*release)(RtaProtocolStack *stack);
     void (*stateChange)(RtaConnection *conn);
+    void (*flush)(RtaConnection *conn);
 } RtaComponentOperations;
 
 extern PARCEventQueue *rtaComponent_GetOutputQueue(RtaConnection *conn,
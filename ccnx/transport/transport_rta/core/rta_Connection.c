@@ -42,6 +42,8 @@
 #include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
 #include <ccnx/transport/transport_rta/core/rta_Connection.h>
 #include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/core/rta_StatusCoalescer.h>
+#include <ccnx/transport/transport_rta/config/config_ApiConnector.h>
 
 #include <ccnx/api/notify/notify_Status.h>
 #include <ccnx/api/control/cpi_ControlFacade.h>
@@ -84,8 +86,17 @@ struct rta_connection {
     // is the connection blocked in the given direction?
     bool blocked_down;
     bool blocked_up;
+
+    // share of the stack's queues, see rta_QueueScheduler.h
+    unsigned weight;
+
+    // status notifications, see rtaConnection_SendStatus()
+    RtaStatusCoalescer *statusCoalescer;
+    bool binaryStatus;
 };
 
+static void _rtaConnection_DeliverStatus(const NotifyStatus *status, RtaComponents component, RtaDirection direction, void *connVoid);
+
 RtaComponentStats *
 rtaConnection_GetStats(RtaConnection *conn, RtaComponents component)
 {
@@ -109,6 +120,13 @@ rtaConnection_Create(RtaProtocolStack *stack, const RtaCommandOpenConnection *cm
 
     conn->params = parcJSON_Copy(rtaCommandOpenConnection_GetConfig(cmdOpen));
     conn->refcount = 1;
+    conn->weight = apiConnector_GetSchedulingWeightFromConfig(conn->params);
+    assertTrue(conn->weight >= 1, "Connection weight must be at least 1, a weight of 0 is never granted a message");
+
+    unsigned statusWindow = apiConnector_GetStatusWindowFromConfig(conn->params);
+    struct timeval window = { .tv_sec = statusWindow / 1000, .tv_usec = (statusWindow % 1000) * 1000 };
+    conn->statusCoalescer = rtaStatusCoalescer_Create(conn->framework, &window, _rtaConnection_DeliverStatus, conn);
+    conn->binaryStatus = apiConnector_GetBinaryStatusFromConfig(conn->params);
 
     conn->blocked_down = false;
     conn->blocked_up = false;
@@ -192,6 +210,8 @@ rtaConnection_Destroy(RtaConnection **connPtr)
         rtaComponentStats_Destroy(&conn->component_stats[i]);
     }
 
+    rtaStatusCoalescer_Destroy(&conn->statusCoalescer);
+
     rtaFramework_RemoveConnection(conn->framework, conn);
     parcJSON_Release(&conn->params);
     parcMemory_Deallocate((void **) &conn);
@@ -301,13 +321,26 @@ rtaConnection_GetConnectionId(const RtaConnection *conn)
     return conn->connid;
 }
 
-void
-rtaConnection_SendNotifyStatus(RtaConnection *conn, RtaComponents component, RtaDirection direction, const NotifyStatus *status)
+/**
+ * Puts the notification on the component's output queue, in binary if the connection asked
+ * for it and the status fits, otherwise in JSON
+ */
+static void
+_rtaConnection_DeliverStatus(const NotifyStatus *status, RtaComponents component, RtaDirection direction, void *connVoid)
 {
-    PARCJSON *json = notifyStatus_ToJSON(status);
-
-    CCNxTlvDictionary *notification = ccnxControlFacade_CreateNotification(json);
-    parcJSON_Release(&json);
+    RtaConnection *conn = (RtaConnection *) connVoid;
+
+    CCNxTlvDictionary *notification;
+    PARCBuffer *encoding = conn->binaryStatus ? notifyStatus_ToBinary(status) : NULL;
+    if (encoding != NULL) {
+        notification = ccnxControlFacade_CreateBinaryNotification(encoding);
+        parcBuffer_Release(&encoding);
+    } else {
+        // JSON also carries a name or message too long for the binary form
+        PARCJSON *json = notifyStatus_ToJSON(status);
+        notification = ccnxControlFacade_CreateNotification(json);
+        parcJSON_Release(&json);
+    }
 
     TransportMessage *tm = transportMessage_CreateFromDictionary(notification);
     ccnxTlvDictionary_Release(&notification);
@@ -318,6 +351,12 @@ rtaConnection_SendNotifyStatus(RtaConnection *conn, RtaComponents component, Rta
     rtaComponent_PutMessage(out, tm);
 }
 
+void
+rtaConnection_SendNotifyStatus(RtaConnection *conn, RtaComponents component, RtaDirection direction, const NotifyStatus *status)
+{
+    rtaStatusCoalescer_Post(conn->statusCoalescer, component, direction, status);
+}
+
 void
 rtaConnection_SendStatus(RtaConnection *conn,
                          RtaComponents component,
@@ -331,6 +370,13 @@ rtaConnection_SendStatus(RtaConnection *conn,
     notifyStatus_Release(&status);
 }
 
+uint64_t
+rtaConnection_GetStatusCount(const RtaConnection *connection, NotifyStatusCode code)
+{
+    assertNotNull(connection, "Parameter connection must be non-null");
+    return rtaStatusCoalescer_GetEventCount(connection->statusCoalescer, code);
+}
+
 RtaConnection *
 rtaConnection_GetFromTransport(TransportMessage *tm)
 {
@@ -351,6 +397,13 @@ rtaConnection_GetParameters(RtaConnection *conn)
     return conn->params;
 }
 
+unsigned
+rtaConnection_GetWeight(const RtaConnection *connection)
+{
+    assertNotNull(connection, "Parameter connection must be non-null");
+    return connection->weight;
+}
+
 bool
 rtaConnection_BlockedDown(const RtaConnection *connection)
 {
@@ -379,7 +379,8 @@ int  rtaConnection_GetTransportFd(RtaConnection *connection);
 /**
  * Creates a status message (see ccnx/api/notify) and sends it up or down the stack.
  *
- *   <#Discussion#>
+ *   The connection may hold the status and send it later, counted with others of the
+ *   same code, see rta_StatusCoalescer.h and `apiConnector_SetStatusWindow()`.
  *
  * @param <#param1#>
  * @return <#return#>
@@ -396,6 +397,26 @@ extern void rtaConnection_SendStatus(RtaConnection *connection,
                                      CCNxName *optionalName,
                                      const char *optionalMessage);
 
+/**
+ * The number of status events with the code on the connection
+ *
+ * Counts every `rtaConnection_SendStatus()`, including those coalesced into another
+ * notification (see `apiConnector_SetStatusWindow()`).
+ *
+ * @param [in] connection The connection
+ * @param [in] code The status code
+ *
+ * @return The number of events
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t timeouts = rtaConnection_GetStatusCount(conn, notifyStatusCode_INTEREST_TIMEOUT);
+ * }
+ * @endcode
+ */
+uint64_t rtaConnection_GetStatusCount(const RtaConnection *connection, NotifyStatusCode code);
+
 /**
  * Creates a status message (see ccnx/api/notify) and sends it up or down the stack.
  *
@@ -426,6 +447,23 @@ RtaConnection *rtaConnection_GetFromTransport(TransportMessage *tm);
  */
 PARCJSON *rtaConnection_GetParameters(RtaConnection *connection);
 
+/**
+ * The connection's scheduling weight
+ *
+ * When connections share a protocol stack, each gets messages through the stack's queues
+ * in proportion to its weight.  Set with `apiConnector_SetSchedulingWeight()`, default 1.
+ *
+ * @param [in] connection The connection
+ *
+ * @return positive The weight
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+unsigned rtaConnection_GetWeight(const RtaConnection *connection);
+
 /**
  * Is the connection blocked in the down direction?
  *
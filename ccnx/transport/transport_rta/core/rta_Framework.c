@@ -50,6 +50,12 @@
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <limits.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 #include <parc/algol/parc_EventSignal.h>
 
@@ -96,32 +102,71 @@ static void transmitStatisticsCallback(int fd, PARCEventType what, void *user_da
 // stop are done via the command channel
 // start cannot be done via the command channel, as its not running until after start.
 
-void
-rta_Framework_LockStatus(RtaFramework *framework)
+RtaFrameworkStatus
+rta_Framework_LoadStatus(const RtaFramework *framework)
 {
-    int res = pthread_mutex_lock(&framework->status_mutex);
-    assertTrue(res == 0, "error from pthread_mutex_lock: %d", res);
+    return (RtaFrameworkStatus) __atomic_load_n(&framework->status, __ATOMIC_ACQUIRE);
 }
 
-void
-rta_Framework_UnlockStatus(RtaFramework *framework)
+static void
+_rta_Framework_WakeStatusWaiters(RtaFramework *framework)
 {
-    int res = pthread_mutex_unlock(&framework->status_mutex);
-    assertTrue(res == 0, "error from pthread_mutex_unlock: %d", res);
+    // The waiter registers before it looks at the status, so either it sees the new
+    // status or we see it waiting.
+    if (__atomic_load_n(&framework->statusWaiters, __ATOMIC_SEQ_CST) == 0) {
+        return;
+    }
+
+#if defined(__linux__)
+    syscall(SYS_futex, &framework->status, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+    pthread_mutex_lock(&framework->status_mutex);
+    pthread_cond_broadcast(&framework->status_cv);
+    pthread_mutex_unlock(&framework->status_mutex);
+#endif
 }
 
-void
-rta_Framework_WaitStatus(RtaFramework *framework)
+bool
+rta_Framework_TransitionStatus(RtaFramework *framework, RtaFrameworkStatus expected, RtaFrameworkStatus next)
 {
-    int res = pthread_cond_wait(&framework->status_cv, &framework->status_mutex);
-    assertTrue(res == 0, "error from pthread_mutex_unlock: %d", res);
+    uint32_t current = (uint32_t) expected;
+    bool success = __atomic_compare_exchange_n(&framework->status, &current, (uint32_t) next, false,
+                                               __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    if (success) {
+        _rta_Framework_WakeStatusWaiters(framework);
+    }
+    return success;
 }
 
 void
-rta_Framework_BroadcastStatus(RtaFramework *framework)
+rta_Framework_StoreStatus(RtaFramework *framework, RtaFrameworkStatus next)
 {
-    int res = pthread_cond_broadcast(&framework->status_cv);
-    assertTrue(res == 0, "error from pthread_mutex_unlock: %d", res);
+    __atomic_store_n(&framework->status, (uint32_t) next, __ATOMIC_SEQ_CST);
+    _rta_Framework_WakeStatusWaiters(framework);
+}
+
+RtaFrameworkStatus
+rta_Framework_WaitStatus(RtaFramework *framework, RtaFrameworkStatus status)
+{
+    __atomic_add_fetch(&framework->statusWaiters, 1, __ATOMIC_SEQ_CST);
+
+    uint32_t current = __atomic_load_n(&framework->status, __ATOMIC_SEQ_CST);
+    while (current < (uint32_t) status) {
+#if defined(__linux__)
+        // returns at once if the status is no longer `current`
+        syscall(SYS_futex, &framework->status, FUTEX_WAIT_PRIVATE, current, NULL, NULL, 0);
+#else
+        pthread_mutex_lock(&framework->status_mutex);
+        if (__atomic_load_n(&framework->status, __ATOMIC_SEQ_CST) == current) {
+            pthread_cond_wait(&framework->status_cv, &framework->status_mutex);
+        }
+        pthread_mutex_unlock(&framework->status_mutex);
+#endif
+        current = __atomic_load_n(&framework->status, __ATOMIC_SEQ_CST);
+    }
+
+    __atomic_sub_fetch(&framework->statusWaiters, 1, __ATOMIC_SEQ_CST);
+    return (RtaFrameworkStatus) current;
 }
 
 
@@ -278,13 +323,15 @@ rtaFramework_Create(PARCRingBuffer1x1 *commandRingBuffer, PARCNotifier *commandN
 
     _setLogLevels(framework);
 
+    framework->threadConfig = rtaFrameworkConfig_CreateFromEnvironment(framework->logger);
+
     // setup the event scheduler
 
     // mutes, condition variable, and protected state for starting
     // and stopping the event thread from an outside thread.
     pthread_mutex_init(&framework->status_mutex, NULL);
     pthread_cond_init(&framework->status_cv, NULL);
-    framework->status = FRAMEWORK_INIT;
+    __atomic_store_n(&framework->status, FRAMEWORK_INIT, __ATOMIC_RELEASE);
 
     framework->commandRingBuffer = parcRingBuffer1x1_Acquire(commandRingBuffer);
     framework->commandNotifier = parcNotifier_Acquire(commandNotifier);
@@ -300,10 +347,10 @@ rtaFramework_Create(PARCRingBuffer1x1 *commandRingBuffer, PARCNotifier *commandN
 
     rtaFramework_SetupMillisecondTimer(framework);
 
-    framework->transmit_statistics_event = parcEventTimer_Create(framework->base,
-                                                     PARCEventType_Persist,
-                                                     transmitStatisticsCallback,
-                                                     (void *) framework);
+    framework->transmit_statistics_event = rtaTimer_Create(framework,
+                                                           PARCEventType_Persist,
+                                                           transmitStatisticsCallback,
+                                                           (void *) framework);
 
 
     rtaFramework_CreateCommandChannel(framework);
@@ -320,7 +367,10 @@ static void
 rtaFramework_DestroyEventScheduler(RtaFramework *framework)
 {
     parcEventTimer_Destroy(&(framework->tick_event));
-    parcEventTimer_Destroy(&(framework->transmit_statistics_event));
+    rtaTimer_Destroy(&(framework->transmit_statistics_event));
+    if (framework->virtualTimers != NULL) {
+        rtaTimerQueue_Destroy(&(framework->virtualTimers));
+    }
 
     if (framework->signal_int != NULL) {
         parcEventSignal_Destroy(&(framework->signal_int));
@@ -351,20 +401,27 @@ rtaFramework_Destroy(RtaFramework **frameworkPtr)
 
     // status can be STOPPED or INIT.  It's ok to destroy one that's never been started.
 
-    // %%%% LOCK
-    rta_Framework_LockStatus(framework);
-    assertTrue(framework->status == FRAMEWORK_SHUTDOWN ||
-               framework->status == FRAMEWORK_INIT ||
-               framework->status == FRAMEWORK_TEARDOWN,
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_SHUTDOWN ||
+               status == FRAMEWORK_INIT ||
+               status == FRAMEWORK_TEARDOWN,
                "Framework invalid state, got %d",
-               framework->status);
-    rta_Framework_UnlockStatus(framework);
-    // %%%% UNLOCK
+               status);
+
+    if (framework->threadStarted) {
+        // the thread has set FRAMEWORK_SHUTDOWN and is exiting
+        pthread_join(framework->thread, NULL);
+    }
+
+    pthread_mutex_destroy(&framework->status_mutex);
+    pthread_cond_destroy(&framework->status_cv);
 
     rtaConnectionTable_Destroy(&framework->connectionTable);
 
     rtaFramework_DestroyEventScheduler(framework);
 
+    rtaFrameworkConfig_Destroy(&framework->threadConfig);
+
     rtaLogger_Release(&framework->logger);
 
     parcMemory_Deallocate((void **) &framework);
@@ -372,6 +429,25 @@ rtaFramework_Destroy(RtaFramework **frameworkPtr)
     *frameworkPtr = NULL;
 }
 
+void
+rtaFramework_SetThreadConfig(RtaFramework *framework, const RtaFrameworkConfig *config)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    assertNotNull(config, "Parameter config must be non-null");
+
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_INIT, "Framework invalid state, expected FRAMEWORK_INIT got %d", status);
+    rtaFrameworkConfig_Destroy(&framework->threadConfig);
+    framework->threadConfig = rtaFrameworkConfig_Copy(config);
+}
+
+const RtaFrameworkConfig *
+rtaFramework_GetThreadConfig(const RtaFramework *framework)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    return framework->threadConfig;
+}
+
 RtaLogger *
 rtaFramework_GetLogger(RtaFramework *framework)
 {
@@ -379,7 +455,7 @@ rtaFramework_GetLogger(RtaFramework *framework)
 }
 
 /**
- * May block briefly, returns the current status of the framework.
+ * Returns the current status of the framework, without blocking.
  *
  * Example:
  * @code
@@ -389,13 +465,7 @@ rtaFramework_GetLogger(RtaFramework *framework)
 RtaFrameworkStatus
 rtaFramework_GetStatus(RtaFramework *framework)
 {
-    RtaFrameworkStatus status;
-    // %%%% LOCK
-    rta_Framework_LockStatus(framework);
-    status = framework->status;
-    rta_Framework_UnlockStatus(framework);
-    // %%%% UNLOCK
-    return status;
+    return rta_Framework_LoadStatus(framework);
 }
 
 /**
@@ -410,14 +480,7 @@ RtaFrameworkStatus
 rtaFramework_WaitForStatus(RtaFramework *framework,
                            RtaFrameworkStatus status)
 {
-    // %%%% LOCK
-    rta_Framework_LockStatus(framework);
-    while (framework->status < status) {
-        rta_Framework_WaitStatus(framework);
-    }
-    rta_Framework_UnlockStatus(framework);
-    // %%%% UNLOCK
-
+    rta_Framework_WaitStatus(framework, status);
     return status;
 }
 
@@ -453,18 +516,6 @@ _tick_cb(int fd, PARCEventType what, void *user_data)
     RtaFramework *framework = (RtaFramework *) user_data;
     assertTrue(what & PARCEventType_Timeout, "%s got unknown signal %d", __func__, what);
     framework->clock_ticks++;
-
-    if (framework->killme) {
-        int res;
-
-        if (rtaLogger_IsLoggable(framework->logger, RtaLoggerFacility_Framework, PARCLogLevel_Debug)) {
-            rtaLogger_Log(framework->logger, RtaLoggerFacility_Framework, PARCLogLevel_Debug, __func__,
-                          "framework %p exiting base loop", (void *) framework);
-        }
-
-        res = parcEventScheduler_Abort(framework->base);
-        assertTrue(res == 0, "error on parcEventScheduler_Abort: %d", res);
-    }
 }
 
 FILE *GlobalStatisticsFile = NULL;
@@ -67,6 +67,7 @@
 #include <parc/concurrent/parc_RingBuffer_1x1.h>
 #include <parc/concurrent/parc_Notifier.h>
 #include <ccnx/transport/transport_rta/core/rta_Logger.h>
+#include <ccnx/transport/transport_rta/core/rta_FrameworkConfig.h>
 
 // ===================================
 // External API, used by rtaTransport
@@ -149,6 +150,34 @@ RtaFramework *rtaFramework_Create(PARCRingBuffer1x1 *commandRingBuffer, PARCNoti
 
 void rtaFramework_Destroy(RtaFramework **frameworkPtr);
 
+/**
+ * Replaces the scheduling config of the framework thread
+ *
+ * The framework starts with the config from the RtaFramework_* environment variables
+ * (see rta_FrameworkConfig.h).  Must be called before `rtaFramework_Start()`.  In
+ * non-threaded mode the config is not used.
+ *
+ * @param [in] framework An allocated RtaFramework in FRAMEWORK_INIT
+ * @param [in] config The config to copy
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+ *     rtaFrameworkConfig_SetNumaNode(config, 0);
+ *     rtaFramework_SetThreadConfig(framework, config);
+ *     rtaFrameworkConfig_Destroy(&config);
+ *     rtaFramework_Start(framework);
+ * }
+ * @endcode
+ */
+void rtaFramework_SetThreadConfig(RtaFramework *framework, const RtaFrameworkConfig *config);
+
+/**
+ * Returns the scheduling config of the framework thread.  Do not free it.
+ */
+const RtaFrameworkConfig *rtaFramework_GetThreadConfig(const RtaFramework *framework);
+
 /**
  * Returns the Logging system used by the framework
  *
@@ -166,7 +195,7 @@ void rtaFramework_Destroy(RtaFramework **frameworkPtr);
 RtaLogger *rtaFramework_GetLogger(RtaFramework *framework);
 
 /**
- * May block briefly, returns the current status of the framework.
+ * Returns the current status of the framework, without blocking.
  *
  * Example:
  * @code
@@ -180,6 +209,9 @@ RtaFrameworkStatus rtaFramework_GetStatus(RtaFramework *framework);
  * Transient states: STARTING, STOPPING.  You don't want to block waiting for those
  * as you could easily miss them
  *
+ * The caller sleeps on the status word and is woken by the transition itself, so it
+ * returns as soon as the framework gets there.
+ *
  * Example:
  * @code
  * <#example#>
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// for cpu_set_t and sched_setaffinity
+#define _GNU_SOURCE
+#endif
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include "rta_FrameworkConfig.h"
+
+#define _CPU_WORDS (RTA_FRAMEWORK_CONFIG_MAX_CPUS / 64)
+
+struct rta_framework_config {
+    uint64_t cpus[_CPU_WORDS];
+    int numaNode;
+    int realtimePriority;
+};
+
+static const char *_envCpuAffinity = "RtaFramework_CpuAffinity";
+static const char *_envNumaNode = "RtaFramework_NumaNode";
+static const char *_envRealtimePriority = "RtaFramework_RealtimePriority";
+
+static const char *_nodeCpuListFormat = "/sys/devices/system/node/node%d/cpulist";
+
+RtaFrameworkConfig *
+rtaFrameworkConfig_Create(void)
+{
+    RtaFrameworkConfig *config = parcMemory_AllocateAndClear(sizeof(RtaFrameworkConfig));
+    assertNotNull(config, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaFrameworkConfig));
+    config->numaNode = -1;
+    return config;
+}
+
+/**
+ * Parses a non-negative decimal integer that is the whole string
+ */
+static bool
+_parseInt(const char *string, int *valuePtr)
+{
+    char *end;
+    errno = 0;
+    long value = strtol(string, &end, 10);
+    if (errno != 0 || end == string || *end != '\0' || value < 0 || value > INT32_MAX) {
+        return false;
+    }
+    *valuePtr = (int) value;
+    return true;
+}
+
+static void
+_warnIgnored(RtaLogger *logger, const char *variable, const char *value)
+{
+    rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                  "Ignoring %s, could not parse '%s'", variable, value);
+}
+
+RtaFrameworkConfig *
+rtaFrameworkConfig_CreateFromEnvironment(RtaLogger *logger)
+{
+    assertNotNull(logger, "Parameter logger must be non-null");
+
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+
+    const char *value = getenv(_envCpuAffinity);
+    if (value != NULL && !rtaFrameworkConfig_AddCpuList(config, value)) {
+        _warnIgnored(logger, _envCpuAffinity, value);
+    }
+
+    int number;
+    value = getenv(_envNumaNode);
+    if (value != NULL) {
+        if (_parseInt(value, &number)) {
+            rtaFrameworkConfig_SetNumaNode(config, number);
+        } else {
+            _warnIgnored(logger, _envNumaNode, value);
+        }
+    }
+
+    value = getenv(_envRealtimePriority);
+    if (value != NULL) {
+        if (_parseInt(value, &number)) {
+            rtaFrameworkConfig_SetRealtimePriority(config, number);
+        } else {
+            _warnIgnored(logger, _envRealtimePriority, value);
+        }
+    }
+
+    return config;
+}
+
+RtaFrameworkConfig *
+rtaFrameworkConfig_Copy(const RtaFrameworkConfig *config)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    RtaFrameworkConfig *copy = rtaFrameworkConfig_Create();
+    *copy = *config;
+    return copy;
+}
+
+void
+rtaFrameworkConfig_Destroy(RtaFrameworkConfig **configPtr)
+{
+    assertNotNull(configPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*configPtr, "Parameter must dereference to non-null pointer");
+    parcMemory_Deallocate((void **) configPtr);
+    *configPtr = NULL;
+}
+
+void
+rtaFrameworkConfig_AddCpu(RtaFrameworkConfig *config, unsigned cpu)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertTrue(cpu < RTA_FRAMEWORK_CONFIG_MAX_CPUS, "CPU %u out of range, must be less than %u", cpu, RTA_FRAMEWORK_CONFIG_MAX_CPUS);
+    config->cpus[cpu / 64] |= UINT64_C(1) << (cpu % 64);
+}
+
+static bool
+_parseCpu(const char **cursorPtr, unsigned *cpuPtr)
+{
+    const char *cursor = *cursorPtr;
+    if (!isdigit((unsigned char) *cursor)) {
+        return false;
+    }
+
+    unsigned long cpu = 0;
+    while (isdigit((unsigned char) *cursor)) {
+        cpu = cpu * 10 + (unsigned long) (*cursor - '0');
+        if (cpu >= RTA_FRAMEWORK_CONFIG_MAX_CPUS) {
+            return false;
+        }
+        cursor++;
+    }
+
+    *cpuPtr = (unsigned) cpu;
+    *cursorPtr = cursor;
+    return true;
+}
+
+bool
+rtaFrameworkConfig_AddCpuList(RtaFrameworkConfig *config, const char *cpuList)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertNotNull(cpuList, "Parameter cpuList must be non-null");
+
+    // parse into a scratch set so a bad list leaves the config unchanged
+    uint64_t cpus[_CPU_WORDS];
+    memset(cpus, 0, sizeof(cpus));
+
+    const char *cursor = cpuList;
+    while (isspace((unsigned char) *cursor)) {
+        cursor++;
+    }
+
+    bool first = true;
+    while (*cursor != '\0' && *cursor != '\n') {
+        if (!first) {
+            if (*cursor != ',') {
+                return false;
+            }
+            cursor++;
+        }
+        first = false;
+
+        unsigned low, high;
+        if (!_parseCpu(&cursor, &low)) {
+            return false;
+        }
+        high = low;
+        if (*cursor == '-') {
+            cursor++;
+            if (!_parseCpu(&cursor, &high) || high < low) {
+                return false;
+            }
+        }
+
+        for (unsigned cpu = low; cpu <= high; cpu++) {
+            cpus[cpu / 64] |= UINT64_C(1) << (cpu % 64);
+        }
+    }
+
+    if (first) {
+        // an empty list
+        return false;
+    }
+
+    for (int i = 0; i < _CPU_WORDS; i++) {
+        config->cpus[i] |= cpus[i];
+    }
+    return true;
+}
+
+bool
+rtaFrameworkConfig_HasCpu(const RtaFrameworkConfig *config, unsigned cpu)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    if (cpu >= RTA_FRAMEWORK_CONFIG_MAX_CPUS) {
+        return false;
+    }
+    return (config->cpus[cpu / 64] & (UINT64_C(1) << (cpu % 64))) != 0;
+}
+
+unsigned
+rtaFrameworkConfig_GetCpuCount(const RtaFrameworkConfig *config)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    unsigned count = 0;
+    for (int i = 0; i < _CPU_WORDS; i++) {
+        count += (unsigned) __builtin_popcountll(config->cpus[i]);
+    }
+    return count;
+}
+
+void
+rtaFrameworkConfig_SetNumaNode(RtaFrameworkConfig *config, int node)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertTrue(node >= -1, "Invalid NUMA node %d", node);
+    config->numaNode = node;
+}
+
+int
+rtaFrameworkConfig_GetNumaNode(const RtaFrameworkConfig *config)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    return config->numaNode;
+}
+
+void
+rtaFrameworkConfig_SetRealtimePriority(RtaFrameworkConfig *config, int priority)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertTrue(priority >= 0, "Invalid priority %d", priority);
+    config->realtimePriority = priority;
+}
+
+int
+rtaFrameworkConfig_GetRealtimePriority(const RtaFrameworkConfig *config)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    return config->realtimePriority;
+}
+
+// ======================================================================
+
+/**
+ * Fills `nodeCpus` with the CPUs of a NUMA node, as listed by sysfs
+ *
+ * @return true if the node exists and its list parsed
+ */
+static bool
+_loadNumaNodeCpus(int node, RtaFrameworkConfig *nodeCpus)
+{
+    char path[128];
+    snprintf(path, sizeof(path), _nodeCpuListFormat, node);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    char line[4096];
+    bool success = (fgets(line, sizeof(line), file) != NULL) && rtaFrameworkConfig_AddCpuList(nodeCpus, line);
+    fclose(file);
+    return success;
+}
+
+/**
+ * The CPUs the thread should run on: the affinity set, the node's CPUs, or both intersected.
+ *
+ * @return false if the node cannot be read or the intersection is empty
+ */
+static bool
+_effectiveCpus(const RtaFrameworkConfig *config, RtaFrameworkConfig *effective, RtaLogger *logger)
+{
+    memcpy(effective->cpus, config->cpus, sizeof(effective->cpus));
+
+    if (config->numaNode >= 0) {
+        RtaFrameworkConfig nodeCpus;
+        memset(&nodeCpus, 0, sizeof(nodeCpus));
+        if (!_loadNumaNodeCpus(config->numaNode, &nodeCpus)) {
+            rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                          "Could not read the CPUs of NUMA node %d", config->numaNode);
+            return false;
+        }
+
+        bool hasAffinity = rtaFrameworkConfig_GetCpuCount(config) > 0;
+        for (int i = 0; i < _CPU_WORDS; i++) {
+            effective->cpus[i] = hasAffinity ? (effective->cpus[i] & nodeCpus.cpus[i]) : nodeCpus.cpus[i];
+        }
+
+        if (rtaFrameworkConfig_GetCpuCount(effective) == 0) {
+            rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                          "The CPU affinity set has no CPU on NUMA node %d", config->numaNode);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+_applyAffinity(const RtaFrameworkConfig *effective, RtaLogger *logger)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu = 0; cpu < RTA_FRAMEWORK_CONFIG_MAX_CPUS && cpu < CPU_SETSIZE; cpu++) {
+        if (rtaFrameworkConfig_HasCpu(effective, cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    int failure = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (failure != 0) {
+        rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                      "Could not set the CPU affinity: %s", strerror(failure));
+        return false;
+    }
+    return true;
+#else
+    rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                  "CPU affinity is not supported on this platform");
+    return false;
+#endif
+}
+
+static bool
+_applyRealtimePriority(int priority, RtaLogger *logger)
+{
+    int min = sched_get_priority_min(SCHED_FIFO);
+    int max = sched_get_priority_max(SCHED_FIFO);
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = (priority < min) ? min : ((priority > max) ? max : priority);
+
+    int failure = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (failure != 0) {
+        rtaLogger_Log(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning, __func__,
+                      "Could not set SCHED_FIFO priority %d: %s", param.sched_priority, strerror(failure));
+        return false;
+    }
+    return true;
+}
+
+bool
+rtaFrameworkConfig_ApplyToCurrentThread(const RtaFrameworkConfig *config, RtaLogger *logger)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertNotNull(logger, "Parameter logger must be non-null");
+
+    bool success = true;
+
+    if (rtaFrameworkConfig_GetCpuCount(config) > 0 || config->numaNode >= 0) {
+        RtaFrameworkConfig effective;
+        memset(&effective, 0, sizeof(effective));
+        success = _effectiveCpus(config, &effective, logger) && _applyAffinity(&effective, logger);
+    }
+
+    if (config->realtimePriority > 0) {
+        success = _applyRealtimePriority(config->realtimePriority, logger) && success;
+    }
+
+    return success;
+}
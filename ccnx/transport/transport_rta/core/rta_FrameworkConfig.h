@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_FrameworkConfig.h
+ * @brief Scheduling properties of the RTA Framework thread
+ *
+ * By default the framework thread may run on any CPU and uses the normal time-sharing
+ * scheduler.  A framework config can pin it to a set of CPUs, to the CPUs of one NUMA node,
+ * and give it a real-time (SCHED_FIFO) priority.  The framework thread applies the config
+ * to itself when it starts, before it runs any command, so every protocol stack, connection
+ * and queue it allocates afterwards is first touched on the chosen CPUs and, with the
+ * kernel's default first-touch policy, lands in memory local to them.
+ *
+ * `rtaFramework_Create()` reads a config from the environment, in the same way it reads
+ * the log levels:
+ *
+ *    RtaFramework_CpuAffinity         a CPU list, e.g. "2" or "0-3,8"
+ *    RtaFramework_NumaNode            a NUMA node number, e.g. "1"
+ *    RtaFramework_RealtimePriority    a SCHED_FIFO priority, e.g. "10"
+ *
+ * A program can replace it with `rtaFramework_SetThreadConfig()` before
+ * `rtaFramework_Start()`, or by creating the transport with
+ * `rtaTransport_CreateWithFrameworkConfig()`.
+ *
+ * Affinity and NUMA placement are only supported on Linux.  Real-time priority usually
+ * needs CAP_SYS_NICE.  A setting that cannot be applied is logged as a warning on the
+ * Framework facility and the thread keeps running without it.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_rta_FrameworkConfig_h
+#define Libccnx_rta_FrameworkConfig_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ccnx/transport/transport_rta/core/rta_Logger.h>
+
+/**
+ * CPUs numbered at or above this are ignored
+ */
+#define RTA_FRAMEWORK_CONFIG_MAX_CPUS 1024
+
+struct rta_framework_config;
+typedef struct rta_framework_config RtaFrameworkConfig;
+
+/**
+ * Create an empty config: no affinity, no NUMA node, normal scheduling
+ *
+ * @return non-null An allocated config, destroy with `rtaFrameworkConfig_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+ *     rtaFrameworkConfig_AddCpu(config, 2);
+ *     rtaFrameworkConfig_SetRealtimePriority(config, 10);
+ *     RTATransport *transport = rtaTransport_CreateWithFrameworkConfig(config);
+ *     rtaFrameworkConfig_Destroy(&config);
+ * }
+ * @endcode
+ */
+RtaFrameworkConfig *rtaFrameworkConfig_Create(void);
+
+/**
+ * Create a config from the RtaFramework_* environment variables
+ *
+ * A variable that does not parse is ignored and logged as a warning on the Framework facility.
+ *
+ * @param [in] logger Where to report variables that did not parse
+ *
+ * @return non-null An allocated config, destroy with `rtaFrameworkConfig_Destroy()`
+ */
+RtaFrameworkConfig *rtaFrameworkConfig_CreateFromEnvironment(RtaLogger *logger);
+
+/**
+ * Create an independent copy of a config
+ */
+RtaFrameworkConfig *rtaFrameworkConfig_Copy(const RtaFrameworkConfig *config);
+
+void rtaFrameworkConfig_Destroy(RtaFrameworkConfig **configPtr);
+
+/**
+ * Adds a CPU to the affinity set
+ *
+ * @param [in] config The config
+ * @param [in] cpu The CPU number, less than RTA_FRAMEWORK_CONFIG_MAX_CPUS
+ */
+void rtaFrameworkConfig_AddCpu(RtaFrameworkConfig *config, unsigned cpu);
+
+/**
+ * Adds every CPU of a list to the affinity set
+ *
+ * The list has the format used by taskset(1) and /sys/devices/system/node: comma
+ * separated CPU numbers and inclusive ranges, e.g. "0-3,8,10-11".
+ *
+ * @param [in] config The config
+ * @param [in] cpuList The CPU list
+ *
+ * @return true The list parsed and was added
+ * @return false The list did not parse, the config is unchanged
+ */
+bool rtaFrameworkConfig_AddCpuList(RtaFrameworkConfig *config, const char *cpuList);
+
+/**
+ * true if the affinity set contains the CPU
+ */
+bool rtaFrameworkConfig_HasCpu(const RtaFrameworkConfig *config, unsigned cpu);
+
+/**
+ * The number of CPUs in the affinity set, 0 means the thread may run anywhere
+ */
+unsigned rtaFrameworkConfig_GetCpuCount(const RtaFrameworkConfig *config);
+
+/**
+ * Keep the framework thread on the CPUs of a NUMA node
+ *
+ * If an affinity set is also given, the thread runs on the CPUs that are in both.
+ *
+ * @param [in] config The config
+ * @param [in] node The NUMA node, -1 for none
+ */
+void rtaFrameworkConfig_SetNumaNode(RtaFrameworkConfig *config, int node);
+
+/**
+ * The NUMA node, or -1 if none
+ */
+int rtaFrameworkConfig_GetNumaNode(const RtaFrameworkConfig *config);
+
+/**
+ * Run the framework thread with the SCHED_FIFO policy
+ *
+ * The priority is clamped to the range the system allows for SCHED_FIFO.
+ *
+ * @param [in] config The config
+ * @param [in] priority The priority, 0 for normal scheduling
+ */
+void rtaFrameworkConfig_SetRealtimePriority(RtaFrameworkConfig *config, int priority);
+
+/**
+ * The SCHED_FIFO priority, or 0 for normal scheduling
+ */
+int rtaFrameworkConfig_GetRealtimePriority(const RtaFrameworkConfig *config);
+
+/**
+ * Apply the config to the calling thread
+ *
+ * Called by the framework thread when it starts.  Every setting is attempted; one that
+ * fails is logged as a warning on the Framework facility.
+ *
+ * @param [in] config The config
+ * @param [in] logger Where to report settings that could not be applied
+ *
+ * @return true Every setting was applied
+ * @return false At least one setting could not be applied
+ */
+bool rtaFrameworkConfig_ApplyToCurrentThread(const RtaFrameworkConfig *config, RtaLogger *logger);
+#endif // Libccnx_rta_FrameworkConfig_h
@@ -171,14 +171,7 @@ _rtaFramework_ExecuteCreateStack(RtaFramework *framework, const RtaCommandCreate
 {
     // if we're in INIT mode, we need to bump
     // wait for notificaiton from event thread
-    if (framework->status == FRAMEWORK_INIT) {
-        rta_Framework_LockStatus(framework);
-        if (framework->status == FRAMEWORK_INIT) {
-            framework->status = FRAMEWORK_SETUP;
-        }
-        rta_Framework_BroadcastStatus(framework);
-        rta_Framework_UnlockStatus(framework);
-    }
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_SETUP);
 
     FrameworkProtocolHolder *holder =
         rtaFramework_GetProtocolStackByStackId(framework, rtaCommandCreateProtocolStack_GetStackId(createStack));
@@ -264,6 +257,9 @@ rtaFramework_CloseConnection(RtaFramework *framework, RtaConnection *connection)
     assertFalse(rtaConnection_GetState(connection) == CONN_CLOSED,
                 "connection api_fd %d is already closed", rtaConnection_GetApiFd(connection));
 
+    // what the components still hold goes down before the connection stops taking messages
+    rtaProtocolStack_Flush(rtaConnection_GetStack(connection), connection);
+
     rtaConnection_SetState(connection, CONN_CLOSED);
     rtaProtocolStack_Close(rtaConnection_GetStack(connection), connection);
 
@@ -399,8 +395,9 @@ _rtaFramework_ExecuteDestroyStack(RtaFramework *framework, const RtaCommandDestr
 }
 
 /**
- * This will update the shared framework->status, so needs a lock around
- * the work it does.
+ * Destroys every stack and stops the event scheduler at once.  The status moves to
+ * FRAMEWORK_STOPPING here, and to FRAMEWORK_SHUTDOWN when the framework thread
+ * returns from the scheduler.
  *
  * Example:
  * @code
@@ -412,12 +409,8 @@ _rtaFramework_ExecuteShutdownFramework(RtaFramework *framework)
 {
     FrameworkProtocolHolder *holder;
 
-    // %%% LOCK
-    rta_Framework_LockStatus(framework);
-    if (framework->status != FRAMEWORK_RUNNING) {
-        RtaFrameworkStatus status = framework->status;
-        rta_Framework_UnlockStatus(framework);
-        // %%% UNLOCK
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    if (status != FRAMEWORK_RUNNING) {
         assertTrue(0, "Invalid state, expected FRAMEWORK_RUNNING or later, got %d", status);
         return -1;
     }
@@ -434,11 +427,12 @@ _rtaFramework_ExecuteShutdownFramework(RtaFramework *framework)
         holder = temp;
     }
 
-    parcEventScheduler_Stop(framework->base, &(struct timeval) { .tv_sec = 0, .tv_usec = 1000 });
-    framework->status = FRAMEWORK_STOPPING;
-    rta_Framework_BroadcastStatus(framework);
-    rta_Framework_UnlockStatus(framework);
-    // %%% UNLOCK
+    // Abort returns from the scheduler as soon as this callback is done, rather than
+    // waiting out a timeout
+    int res = parcEventScheduler_Abort(framework->base);
+    assertTrue(res == 0, "error on parcEventScheduler_Abort: %d", res);
+
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_RUNNING, FRAMEWORK_STOPPING);
 
     return 0;
 }
@@ -456,7 +450,7 @@ _rtaFramework_ExecuteTransmitStatistics(RtaFramework *framework, const RtaComman
 
     if (GlobalStatisticsFile != NULL) {
         struct timeval period = rtaCommandTransmitStatistics_GetPeriod(transmitStats);
-        parcEventTimer_Start(framework->transmit_statistics_event, &period);
+        rtaTimer_Start(framework->transmit_statistics_event, &period);
     } else {
         fprintf(stderr, "Will not report statistics: Failed to open %s for output.", rtaCommandTransmitStatistics_GetFilename(transmitStats));
     }
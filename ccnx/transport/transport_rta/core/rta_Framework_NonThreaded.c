@@ -56,15 +56,101 @@
 #include "rta_Framework.h"
 #include "rta_ConnectionTable.h"
 #include "rta_Framework_Commands.h"
+#include "rta_Timer.h"
 
 #ifndef DEBUG_OUTPUT
 #define DEBUG_OUTPUT 0
 #endif
 
+// On the virtual clock, the number of non-blocking event loop passes run at each virtual
+// instant.  Messages cross one component queue per pass, so this bounds how far a message
+// travels through the stack before virtual time moves on.
+#define VIRTUAL_CLOCK_IO_PASSES 16
+
 // This is implemented in rta_Framework_Commands
 void
 rtaFramework_DestroyProtocolHolder(RtaFramework *framework, FrameworkProtocolHolder *holder);
 
+// ==============================
+// Virtual clock
+
+static void
+_virtualClock_SetNow(RtaFramework *framework, uint64_t nowUsec)
+{
+    framework->virtualNowUsec = nowUsec;
+    framework->clock_ticks = nowUsec / FC_USEC_PER_TICK;
+}
+
+/**
+ * Runs whatever I/O is ready without blocking and without moving virtual time
+ */
+static int
+_virtualClock_RunIo(RtaFramework *framework)
+{
+    for (int i = 0; i < VIRTUAL_CLOCK_IO_PASSES; i++) {
+        if (parcEventScheduler_Start(framework->base, PARCEventSchedulerDispatchType_NonBlocking) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Fires the virtual timers in expiry order up to and including `untilUsec`, running the ready
+ * I/O after each, then leaves virtual time at `untilUsec`.
+ */
+static int
+_virtualClock_RunUntil(RtaFramework *framework, uint64_t untilUsec)
+{
+    if (_virtualClock_RunIo(framework) < 0) {
+        return -1;
+    }
+
+    uint64_t expiryUsec;
+    while (rtaTimerQueue_NextExpiry(framework->virtualTimers, &expiryUsec) && expiryUsec <= untilUsec) {
+        if (expiryUsec > framework->virtualNowUsec) {
+            _virtualClock_SetNow(framework, expiryUsec);
+        }
+        rtaTimerQueue_FireNext(framework->virtualTimers);
+
+        if (_virtualClock_RunIo(framework) < 0) {
+            return -1;
+        }
+    }
+
+    if (untilUsec > framework->virtualNowUsec) {
+        _virtualClock_SetNow(framework, untilUsec);
+    }
+    return 0;
+}
+
+void
+rtaFramework_NonThreadedUseVirtualClock(RtaFramework *framework, const struct timeval *startTime)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    assertNotNull(startTime, "Parameter startTime must be non-null");
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_INIT || status == FRAMEWORK_SETUP,
+               "The virtual clock is only for the non-threaded framework, got status %d", status);
+    assertTrue(TAILQ_EMPTY(&framework->protocols_head), "Switch to the virtual clock before creating protocol stacks");
+    assertFalse(framework->virtualClock, "The framework is already on the virtual clock");
+
+    parcEventTimer_Stop(framework->tick_event);
+
+    framework->virtualClock = true;
+    framework->virtualStartTime = *startTime;
+    framework->virtualTimers = rtaTimerQueue_Create();
+    _virtualClock_SetNow(framework, 0);
+}
+
+uint64_t
+rtaFramework_NonThreadedGetVirtualUsec(RtaFramework *framework)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    assertTrue(framework->virtualClock, "The framework is not on the virtual clock");
+    return framework->virtualNowUsec;
+}
+
 /**
  * If running in non-threaded mode (you don't call _Start), you must manually
  * turn the crank.  This turns it for a single cycle.
@@ -78,20 +164,23 @@ rtaFramework_DestroyProtocolHolder(RtaFramework *framework, FrameworkProtocolHol
 int
 rtaFramework_NonThreadedStep(RtaFramework *framework)
 {
-    if (framework->status == FRAMEWORK_INIT) {
-        framework->status = FRAMEWORK_SETUP;
-    }
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_SETUP);
 
-    assertTrue(framework->status == FRAMEWORK_SETUP,
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_SETUP,
                "Framework invalid state for non-threaded, expected %d got %d",
                FRAMEWORK_SETUP,
-               framework->status
+               status
                );
 
-    if (framework->status != FRAMEWORK_SETUP) {
+    if (status != FRAMEWORK_SETUP) {
         return -1;
     }
 
+    if (framework->virtualClock) {
+        return _virtualClock_RunUntil(framework, framework->virtualNowUsec);
+    }
+
     if (parcEventScheduler_Start(framework->base, PARCEventSchedulerDispatchType_LoopOnce) < 0) {
         return -1;
     }
@@ -112,22 +201,25 @@ rtaFramework_NonThreadedStep(RtaFramework *framework)
 int
 rtaFramework_NonThreadedStepCount(RtaFramework *framework, unsigned count)
 {
-    if (framework->status == FRAMEWORK_INIT) {
-        framework->status = FRAMEWORK_SETUP;
-    }
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_SETUP);
 
-    assertTrue(framework->status == FRAMEWORK_SETUP,
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_SETUP,
                "Framework invalid state for non-threaded, expected %d got %d",
                FRAMEWORK_SETUP,
-               framework->status
+               status
                );
 
-    if (framework->status != FRAMEWORK_SETUP) {
+    if (status != FRAMEWORK_SETUP) {
         return -1;
     }
 
     while (count-- > 0) {
-        if (parcEventScheduler_Start(framework->base, PARCEventSchedulerDispatchType_LoopOnce) < 0) {
+        if (framework->virtualClock) {
+            if (_virtualClock_RunUntil(framework, framework->virtualNowUsec) < 0) {
+                return -1;
+            }
+        } else if (parcEventScheduler_Start(framework->base, PARCEventSchedulerDispatchType_LoopOnce) < 0) {
             return -1;
         }
     }
@@ -147,20 +239,24 @@ rtaFramework_NonThreadedStepCount(RtaFramework *framework, unsigned count)
 int
 rtaFramework_NonThreadedStepTimed(RtaFramework *framework, struct timeval *duration)
 {
-    if (framework->status == FRAMEWORK_INIT) {
-        framework->status = FRAMEWORK_SETUP;
-    }
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_SETUP);
 
-    assertTrue(framework->status == FRAMEWORK_SETUP,
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    assertTrue(status == FRAMEWORK_SETUP,
                "Framework invalid state for non-threaded, expected %d got %d",
                FRAMEWORK_SETUP,
-               framework->status
+               status
                );
 
-    if (framework->status != FRAMEWORK_SETUP) {
+    if (status != FRAMEWORK_SETUP) {
         return -1;
     }
 
+    if (framework->virtualClock) {
+        uint64_t durationUsec = (uint64_t) duration->tv_sec * 1000000 + duration->tv_usec;
+        return _virtualClock_RunUntil(framework, framework->virtualNowUsec + durationUsec);
+    }
+
     parcEventScheduler_Stop(framework->base, duration);
 
     if (parcEventScheduler_Start(framework->base, 0) < 0) {
@@ -193,12 +289,8 @@ rtaFramework_Teardown(RtaFramework *framework)
                __func__, (void *) framework);
     }
 
-    // %%% LOCK
-    rta_Framework_LockStatus(framework);
-    if (framework->status != FRAMEWORK_SETUP) {
-        RtaFrameworkStatus status = framework->status;
-        rta_Framework_UnlockStatus(framework);
-        // %%% UNLOCK
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    if (status != FRAMEWORK_SETUP) {
         assertTrue(0, "Invalid state, expected FRAMEWORK_SETUP, got %d", status);
         return -1;
     }
@@ -210,10 +302,7 @@ rtaFramework_Teardown(RtaFramework *framework)
         holder = temp;
     }
 
-    framework->status = FRAMEWORK_TEARDOWN;
-    rta_Framework_BroadcastStatus(framework);
-    rta_Framework_UnlockStatus(framework);
-    // %%% UNLOCK
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_SETUP, FRAMEWORK_TEARDOWN);
 
     return 0;
 }
@@ -30,12 +30,28 @@
  *
  * Unless you call one of the _Step methods frequently, the tick clock will be off.
  *
+ * A non-threaded framework can instead run on a virtual clock, for simulations that must run
+ * faster than real time and give the same result every run.  The framework ticks and every
+ * `RtaTimer` then follow virtual time, which only moves when the step functions move it:
+ *
+ *   - `rtaFramework_NonThreadedStepTimed()` fires the virtual timers due within the duration,
+ *     in expiry order, and leaves virtual time at the end of the duration.  It returns at once,
+ *     however long the duration is.
+ *   - `rtaFramework_NonThreadedStep()` and `rtaFramework_NonThreadedStepCount()` run the ready
+ *     I/O and the timers already due without moving virtual time.
+ *
+ * Sockets, such as the application's API socket, still carry the messages; the step functions
+ * run them without blocking between timers.  For a reproducible run, keep everything that takes
+ * real time out of the stack: use zero signing and decoding workers (see config_Codec_Tlv.h), and
+ * a lower component in the same thread rather than a forwarder in another process or thread.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright 2013-2014, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
  */
 #ifndef Libccnx_rta_Framework_NonThreaded_h
 #define Libccnx_rta_Framework_NonThreaded_h
 
+#include <stdint.h>
 #include <sys/time.h>
 
 // ==============================
@@ -77,6 +93,40 @@ int rtaFramework_NonThreadedStepCount(RtaFramework *framework, unsigned count);
  */
 int rtaFramework_NonThreadedStepTimed(RtaFramework *framework, struct timeval *duration);
 
+/**
+ * Drives the framework from a virtual clock instead of real time
+ *
+ * Call after `rtaFramework_Create()` and before creating any protocol stacks.  The framework
+ * stays on the virtual clock until it is destroyed.  Virtual time starts at zero, and
+ * `rtaFramework_GetTimeOfDay()` returns `startTime` plus the virtual time elapsed.
+ *
+ * @param [in] framework A framework that has not been started in threaded mode
+ * @param [in] startTime The time of day at virtual time zero, fixed for a reproducible run
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaFramework *framework = rtaFramework_Create(commandRingBuffer, commandNotifier);
+ *     rtaFramework_NonThreadedUseVirtualClock(framework, &(struct timeval) { .tv_sec = 1420070400, .tv_usec = 0 });
+ *
+ *     // ... create the protocol stacks and open connections ...
+ *
+ *     // run 10 simulated seconds
+ *     rtaFramework_NonThreadedStepTimed(framework, &(struct timeval) { .tv_sec = 10, .tv_usec = 0 });
+ * }
+ * @endcode
+ */
+void rtaFramework_NonThreadedUseVirtualClock(RtaFramework *framework, const struct timeval *startTime);
+
+/**
+ * The virtual time elapsed since `rtaFramework_NonThreadedUseVirtualClock()`
+ *
+ * @param [in] framework A framework on the virtual clock
+ *
+ * @return The virtual time in microseconds
+ */
+uint64_t rtaFramework_NonThreadedGetVirtualUsec(RtaFramework *framework);
+
 
 /**
  * After a protocol stack is created, you need to Teardown.  If you
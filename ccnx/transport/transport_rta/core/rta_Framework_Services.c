@@ -57,3 +57,26 @@ rtaFramework_UsecToTicks(unsigned usec)
 {
     return MSEC_TO_TICKS(usec / 1000);
 }
+
+ticks
+rtaFramework_MsecToTicks(uint64_t msec)
+{
+    return MSEC_TO_TICKS(msec);
+}
+
+void
+rtaFramework_GetTimeOfDay(RtaFramework *framework, struct timeval *now)
+{
+    assertNotNull(framework, "Parameter framework cannot be null");
+    assertNotNull(now, "Parameter now cannot be null");
+
+    if (framework->virtualClock) {
+        struct timeval elapsed = {
+            .tv_sec  = framework->virtualNowUsec / 1000000,
+            .tv_usec = framework->virtualNowUsec % 1000000
+        };
+        timeradd(&framework->virtualStartTime, &elapsed, now);
+    } else {
+        gettimeofday(now, NULL);
+    }
+}
@@ -38,6 +38,8 @@
 
 #include "rta_Framework.h"
 
+#include <sys/time.h>
+
 #include <parc/algol/parc_EventScheduler.h>
 
 // ===================================
@@ -135,4 +137,38 @@ extern uint64_t rtaFramework_TicksToUsec(ticks tick);
  * @see <#references#>
  */
 extern ticks rtaFramework_UsecToTicks(unsigned usec);
+
+/**
+ * Convert milliseconds to ticks, without the 32-bit limit of `rtaFramework_UsecToTicks()`
+ *
+ * Use it for long intervals such as Interest lifetimes, where the microseconds of more than
+ * about 71 minutes do not fit in an unsigned.
+ *
+ * @param [in] msec A duration in milliseconds
+ *
+ * @return The duration in ticks, at least 1
+ */
+extern ticks rtaFramework_MsecToTicks(uint64_t msec);
+
+/**
+ * The framework's time of day
+ *
+ * Normally the same as `gettimeofday()`.  On a virtual clock it is the virtual start time
+ * plus the virtual time elapsed, so components that compare against absolute times (e.g.
+ * Content Object expiry) see simulated time.
+ *
+ * @param [in] framework An allocated framework
+ * @param [out] now The current time
+ *
+ * Example:
+ * @code
+ * {
+ *     struct timeval now;
+ *     rtaFramework_GetTimeOfDay(rtaConnection_GetFramework(conn), &now);
+ * }
+ * @endcode
+ *
+ * @see rtaFramework_NonThreadedUseVirtualClock
+ */
+void rtaFramework_GetTimeOfDay(RtaFramework *framework, struct timeval *now);
 #endif // Libccnx_rta_Framework_Services_h
@@ -30,9 +30,14 @@
  */
 #include <config.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <pthread.h>
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 #include <errno.h>
 
 #include <string.h>
@@ -71,22 +76,11 @@ rtaFramework_Start(RtaFramework *framework)
     pthread_attr_t attr;
 
     // ensure we're in the INIT state, then bump to STARTING
-    // %%% LOCK
-    rta_Framework_LockStatus(framework);
-    if (framework->status == FRAMEWORK_INIT) {
-        framework->status = FRAMEWORK_STARTING;
-        rta_Framework_BroadcastStatus(framework);
-        rta_Framework_UnlockStatus(framework);
-        // %%% UNLOCK
-    } else {
-        RtaFrameworkStatus status = framework->status;
-        rta_Framework_UnlockStatus(framework);
-        // %%% UNLOCK
-        assertTrue(0, "Invalid state, not FRAMEWORK_INIT, got %d", status);
+    if (!rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_STARTING)) {
+        assertTrue(0, "Invalid state, not FRAMEWORK_INIT, got %d", rta_Framework_LoadStatus(framework));
         return;
     }
 
-
     pthread_attr_init(&attr);
     pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 
@@ -99,12 +93,11 @@ rtaFramework_Start(RtaFramework *framework)
         printf("%s framework started %p\n", __func__, (void *) framework);
     }
 
-    // wait for notificaiton from event thread
-    rta_Framework_LockStatus(framework);
-    while (framework->status == FRAMEWORK_INIT) {
-        rta_Framework_WaitStatus(framework);
-    }
-    rta_Framework_UnlockStatus(framework);
+    pthread_attr_destroy(&attr);
+    framework->threadStarted = true;
+
+    // wait for the event thread to run, which includes applying its thread config
+    rta_Framework_WaitStatus(framework, FRAMEWORK_RUNNING);
 
     if (DEBUG_OUTPUT) {
         printf("%s framework running %p\n", __func__, (void *) framework);
@@ -116,26 +109,28 @@ _rtaFramework_Run(void *ctx)
 {
     RtaFramework *framework = (RtaFramework *) ctx;
 
-    // %%% LOCK
-    rta_Framework_LockStatus(framework);
-    if (framework->status != FRAMEWORK_STARTING) {
-        assertTrue(0, "Invalid state, expected before %d, got %d", FRAMEWORK_STARTING, framework->status);
-        rta_Framework_UnlockStatus(framework);
-        // %%% UNLOCK
+    RtaFrameworkStatus status = rta_Framework_LoadStatus(framework);
+    if (status != FRAMEWORK_STARTING) {
+        assertTrue(0, "Invalid state, expected before %d, got %d", FRAMEWORK_STARTING, status);
         pthread_exit(NULL);
     }
-    framework->status = FRAMEWORK_RUNNING;
+
+#if defined(__linux__)
+    framework->threadId = (int) syscall(SYS_gettid);
+#endif
+
+    // Pin and prioritize before running any command, so the stacks and connections we
+    // allocate are first touched on the chosen CPUs.
+    rtaFrameworkConfig_ApplyToCurrentThread(framework->threadConfig, framework->logger);
 
     // Set our thread name, only used to diagnose a crash or in debugging
 #if __APPLE__
     pthread_setname_np("RTA Framework");
 #else
-    pthread_setname_np(framework->thread, "RTA Framework");
+    pthread_setname_np(pthread_self(), "RTA Framework");
 #endif
 
-    rta_Framework_BroadcastStatus(framework);
-    rta_Framework_UnlockStatus(framework);
-    // %%% UNLOCK
+    rta_Framework_TransitionStatus(framework, FRAMEWORK_STARTING, FRAMEWORK_RUNNING);
 
     if (DEBUG_OUTPUT) {
         const int bufferLength = 1024;
@@ -151,12 +146,16 @@ _rtaFramework_Run(void *ctx)
         printf("%9" PRIu64 " %s existed parcEventScheduler_Start\n", framework->clock_ticks, __func__);
     }
 
-    // %%% LOCK
-    rta_Framework_LockStatus(framework);
-    framework->status = FRAMEWORK_SHUTDOWN;
-    rta_Framework_BroadcastStatus(framework);
-    rta_Framework_UnlockStatus(framework);
-    // %%% UNLOCK
+    RtaFrameworkThreadStats stats;
+    if (rtaLogger_IsLoggable(framework->logger, RtaLoggerFacility_Framework, PARCLogLevel_Info) &&
+        rtaFramework_GetThreadStats(framework, &stats)) {
+        rtaLogger_Log(framework->logger, RtaLoggerFacility_Framework, PARCLogLevel_Info, __func__,
+                      "framework %p context switches voluntary %" PRIu64 " involuntary %" PRIu64 " last cpu %d",
+                      (void *) framework, stats.voluntaryContextSwitches, stats.involuntaryContextSwitches, stats.cpu);
+    }
+
+    framework->threadId = 0;
+    rta_Framework_StoreStatus(framework, FRAMEWORK_SHUTDOWN);
 
     pthread_exit(NULL);
 }
@@ -183,3 +182,80 @@ rtaFramework_Shutdown(RtaFramework *framework)
     // now block on reading status
     rtaFramework_WaitForStatus(framework, FRAMEWORK_SHUTDOWN);
 }
+
+#if defined(__linux__)
+/**
+ * The processor field (39) of /proc/self/task/<tid>/stat, or -1
+ */
+static int
+_rtaFramework_ReadLastCpu(int tid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+
+    char line[1024];
+    char *fields = NULL;
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // field 2 is the command name in parentheses and may contain spaces
+        fields = strrchr(line, ')');
+    }
+    fclose(file);
+
+    int cpu = -1;
+    if (fields != NULL) {
+        // skip fields 3 through 38
+        char *save;
+        char *token = strtok_r(fields + 1, " ", &save);
+        for (int field = 3; token != NULL && field < 39; field++) {
+            token = strtok_r(NULL, " ", &save);
+        }
+        if (token != NULL) {
+            cpu = atoi(token);
+        }
+    }
+    return cpu;
+}
+#endif
+
+bool
+rtaFramework_GetThreadStats(RtaFramework *framework, RtaFrameworkThreadStats *stats)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+#if defined(__linux__)
+    if (framework->threadId == 0) {
+        return false;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/status", framework->threadId);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(RtaFrameworkThreadStats));
+    int found = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, "voluntary_ctxt_switches: %" SCNu64, &stats->voluntaryContextSwitches) == 1) {
+            found++;
+        } else if (sscanf(line, "nonvoluntary_ctxt_switches: %" SCNu64, &stats->involuntaryContextSwitches) == 1) {
+            found++;
+        }
+    }
+    fclose(file);
+
+    stats->cpu = _rtaFramework_ReadLastCpu(framework->threadId);
+    return found == 2;
+#else
+    return false;
+#endif
+}
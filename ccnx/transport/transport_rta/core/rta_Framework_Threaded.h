@@ -36,9 +36,21 @@
 #ifndef Libccnx_rta_Framework_Threaded_h
 #define Libccnx_rta_Framework_Threaded_h
 
+#include <stdbool.h>
+#include <stdint.h>
+
 // =============================
 // THREADED
 
+/**
+ * Scheduler counters of the framework thread, cumulative since it started
+ */
+typedef struct rta_framework_thread_stats {
+    uint64_t voluntaryContextSwitches;      // the thread blocked, e.g. waiting for an event
+    uint64_t involuntaryContextSwitches;    // the thread was preempted
+    int cpu;                                // the CPU it last ran on
+} RtaFrameworkThreadStats;
+
 /**
  * Starts the worker thread.  Blocks until started.
  *
@@ -66,4 +78,31 @@ void rtaFramework_Start(RtaFramework *framework);
  */
 void rtaFramework_Shutdown(RtaFramework *framework);
 
+/**
+ * Reads the scheduler counters of the framework thread
+ *
+ * May be called from any thread while the framework is running.  A high rate of
+ * involuntary context switches means the thread is competing for its CPU; see
+ * `rtaFramework_SetThreadConfig()` to pin it.
+ *
+ * Only supported on Linux, where the counters come from /proc.
+ *
+ * @param [in] framework A started RtaFramework
+ * @param [out] stats Filled in on success
+ *
+ * @return true The stats were read
+ * @return false The thread is not running or the platform does not expose the counters
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaFrameworkThreadStats stats;
+ *     if (rtaFramework_GetThreadStats(framework, &stats)) {
+ *         printf("involuntary %" PRIu64 " on cpu %d\n", stats.involuntaryContextSwitches, stats.cpu);
+ *     }
+ * }
+ * @endcode
+ */
+bool rtaFramework_GetThreadStats(RtaFramework *framework, RtaFrameworkThreadStats *stats);
+
 #endif
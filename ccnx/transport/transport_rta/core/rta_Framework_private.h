@@ -37,6 +37,8 @@
 #define Libccnx_rta_Framework_private_h
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <sys/queue.h>
 #include <pthread.h>
 
@@ -45,6 +47,8 @@
 #include "rta_Framework_Services.h"
 
 #include "rta_ConnectionTable.h"
+#include "rta_Timer.h"
+#include "rta_FrameworkConfig.h"
 
 #include <parc/algol/parc_EventScheduler.h>
 #include <parc/algol/parc_Event.h>
@@ -82,31 +86,44 @@ struct rta_framework {
     PARCEventSignal         *signal_usr1;
     PARCEventTimer          *tick_event;
     PARCEvent               *udp_event;
-    PARCEventTimer          *transmit_statistics_event;
+    RtaTimer                *transmit_statistics_event;
     PARCEventSignal         *signal_pipe;
 
     struct timeval starttime;
     ticks clock_ticks;                       // at WTHZ
 
+    // Set by rtaFramework_NonThreadedUseVirtualClock().  The tick_event is stopped and
+    // clock_ticks follows virtualNowUsec, which only the non-threaded step functions advance.
+    bool virtualClock;
+    struct timeval virtualStartTime;
+    uint64_t virtualNowUsec;                 // since virtualStartTime
+    RtaTimerQueue *virtualTimers;
+
     // used by seed48 and nrand48
     unsigned short seed[3];
 
     pthread_t thread;
 
+    // Applied by the framework thread to itself when it starts
+    RtaFrameworkConfig *threadConfig;
+
+    // The kernel thread id of the framework thread, 0 until it runs.  Only set on Linux.
+    int threadId;
+
     unsigned connid_next;
 
-    // operations that modify global state need
-    // to be locked.
+    // The lifecycle state machine.  Only read and written with the rta_Framework_*Status
+    // functions below, which use atomic operations.  Waiters sleep on the status word
+    // itself (a futex on Linux); statusWaiters lets a transition skip the wakeup call
+    // when nobody waits.  The mutex and condition variable are only used on platforms
+    // without futexes.
+    uint32_t status;                         // an RtaFrameworkStatus
+    uint32_t statusWaiters;
     pthread_mutex_t status_mutex;
     pthread_cond_t status_cv;
-    RtaFrameworkStatus status;
 
-    // signals from outside control thread to event scheduler
-    // that it should exit its event loop.  This does
-    // not need to be protected in mutex (its not
-    // a condition variable).  We check for this
-    // inside the HZ timer callback.
-    bool killme;
+    // true once rtaFramework_Start() created the thread, which _Destroy joins
+    bool threadStarted;
 
     // A list of all our in-use protocol stacks
     TAILQ_HEAD(, framework_protocol_holder)    protocols_head;
@@ -119,58 +136,54 @@ struct rta_framework {
 int rtaFramework_CloseConnection(RtaFramework *framework, RtaConnection *connection);
 
 /**
- * Lock the frameworks state machine status
- *
- * Will block until the state machine status is locked
+ * Returns the current status of the state machine, without blocking
  *
  * @param [in] framework An allocated framework
- *
- * Example:
- * @code
- * <#example#>
- * @endcode
  */
-void rta_Framework_LockStatus(RtaFramework *framework);
+RtaFrameworkStatus rta_Framework_LoadStatus(const RtaFramework *framework);
 
 /**
- * Unlock the state mahcines status
+ * Moves the state machine from `expected` to `next` and wakes any waiters
  *
- * Will assert if we do not currently hold the lock
+ * The transition is a single compare-and-swap, so of two threads racing for the same
+ * transition exactly one succeeds.
  *
  * @param [in] framework An allocated framework
+ * @param [in] expected The status the framework must be in
+ * @param [in] next The new status
+ *
+ * @return true The status was `expected` and is now `next`
+ * @return false The status was not `expected` and is unchanged
  *
  * Example:
  * @code
- * <#example#>
+ * {
+ *     if (!rta_Framework_TransitionStatus(framework, FRAMEWORK_INIT, FRAMEWORK_STARTING)) {
+ *         trapIllegalValue(status, "Framework already started");
+ *     }
+ * }
  * @endcode
  */
-void rta_Framework_UnlockStatus(RtaFramework *framework);
+bool rta_Framework_TransitionStatus(RtaFramework *framework, RtaFrameworkStatus expected, RtaFrameworkStatus next);
 
 /**
- * Wait on the state machine's condition variable to be signaled
+ * Unconditionally sets the status and wakes any waiters
  *
- * <#Paragraphs Of Explanation#>
+ * Only for the thread that owns the transition, e.g. the framework thread when its
+ * event scheduler exits.
  *
  * @param [in] framework An allocated framework
- *
- * Example:
- * @code
- * <#example#>
- * @endcode
+ * @param [in] next The new status
  */
-void rta_Framework_WaitStatus(RtaFramework *framework);
+void rta_Framework_StoreStatus(RtaFramework *framework, RtaFrameworkStatus next);
 
 /**
- * Broadcast on the state machine's condition variable (signal it)
- *
- * <#Paragraphs Of Explanation#>
+ * Sleeps until the status is at least `status`
  *
  * @param [in] framework An allocated framework
+ * @param [in] status The status to wait for
  *
- * Example:
- * @code
- * <#example#>
- * @endcode
+ * @return The status that ended the wait, equal to or later than `status`
  */
-void rta_Framework_BroadcastStatus(RtaFramework *framework);
+RtaFrameworkStatus rta_Framework_WaitStatus(RtaFramework *framework, RtaFrameworkStatus status);
 #endif
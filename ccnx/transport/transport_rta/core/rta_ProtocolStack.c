@@ -51,6 +51,7 @@
 #include <ccnx/transport/transport_rta/core/rta_Component.h>
 #include <ccnx/transport/transport_rta/core/rta_ConnectionTable.h>
 #include <ccnx/transport/transport_rta/core/rta_ComponentStats.h>
+#include <ccnx/transport/transport_rta/core/rta_QueueScheduler.h>
 #include <ccnx/transport/common/transport_Message.h>
 #include <ccnx/transport/common/transport_private.h>
 
@@ -59,6 +60,9 @@
 #include <ccnx/transport/transport_rta/components/component_Codec.h>
 #include <ccnx/transport/transport_rta/components/component_Flowcontrol.h>
 #include <ccnx/transport/transport_rta/components/component_Testing.h>
+#include <ccnx/transport/transport_rta/components/component_Cache.h>
+#include <ccnx/transport/transport_rta/components/component_Pit.h>
+#include <ccnx/transport/transport_rta/components/component_Verify.h>
 
 #include <ccnx/transport/transport_rta/config/config_ProtocolStack.h>
 
@@ -92,7 +96,9 @@ const char *RtaComponentNames[LAST_COMPONENT] =
     "TESTING_UPPER",
     "TESTING_LOWER",    // 17
     "CCND_REGISTRAR",
-    "FWD_METIS"
+    "FWD_METIS",
+    "CACHE",            // 20
+    "PIT"
 };
 
 struct protocol_stack {
@@ -112,11 +118,17 @@ struct protocol_stack {
     PARCEventQueuePair *queue_pairs[MAX_STACK_DEPTH];
     RtaComponents components[MAX_STACK_DEPTH];
 
-    // queues assigned to components
+    // queues assigned to components, and the schedulers in front of
+    // the component's read callback on each
     struct component_queues {
         PARCEventQueue *up;
         PARCEventQueue *down;
+        RtaQueueScheduler *upScheduler;
+        RtaQueueScheduler *downScheduler;
     } *component_queues[LAST_COMPONENT];
+
+    // the most messages a component reads from a queue in one turn
+    unsigned batch;
     RtaComponentOperations component_ops[LAST_COMPONENT];
     void *component_state[LAST_COMPONENT];
 
@@ -159,6 +171,7 @@ rtaProtocolStack_Create(RtaFramework *framework, PARCJSON *params, int stack_id)
 
     stack->framework = framework;
     stack->stack_id = stack_id;
+    stack->batch = protocolStack_GetBatchSizeFromConfig(stack->params);
 
     // create all the buffer pairs
     for (int i = 0; i < MAX_STACK_DEPTH; i++) {
@@ -317,6 +330,20 @@ rtaProtocolStack_Close(RtaProtocolStack *stack, RtaConnection *conn)
     return 0;
 }
 
+void
+rtaProtocolStack_Flush(RtaProtocolStack *stack, RtaConnection *conn)
+{
+    assertNotNull(stack, "called with null stack\n");
+    assertNotNull(conn, "called with null connection\n");
+
+    for (int i = 0; i < stack->component_count; i++) {
+        RtaComponents comp = stack->components[i];
+        if (stack->component_ops[comp].flush != NULL) {
+            stack->component_ops[comp].flush(conn);
+        }
+    }
+}
+
 /**
  * Calls the release() function of all components.
  * Drains all the component queues.
@@ -358,6 +385,18 @@ rtaProtocolStack_Destroy(RtaProtocolStack **stackPtr)
         }
     }
 
+    // Messages held back by a scheduler are drained along with the queues
+    for (int i = 0; i < LAST_COMPONENT; i++) {
+        if (stack->component_queues[i]) {
+            if (stack->component_queues[i]->upScheduler) {
+                rtaQueueScheduler_Destroy(&(stack->component_queues[i]->upScheduler));
+            }
+            if (stack->component_queues[i]->downScheduler) {
+                rtaQueueScheduler_Destroy(&(stack->component_queues[i]->downScheduler));
+            }
+        }
+    }
+
     for (int i = 0; i < MAX_STACK_DEPTH; i++) {
         TransportMessage *tm;
         while ((tm = rtaComponent_GetMessage(parcEventQueue_GetConnectedUpQueue(stack->queue_pairs[i]))) != NULL) {
@@ -524,6 +563,18 @@ rtaProtocolStack_ConfigureComponents(RtaProtocolStack *stack)
                 configure_FwdConnector(stack, comp_type, fwd_metis_ops);
                 break;
 
+            case CACHE:
+                configure_Component(stack, comp_type, cache_ops);
+                break;
+
+            case PIT:
+                configure_Component(stack, comp_type, pit_ops);
+                break;
+
+            case VERIFY_ENUMERATED:
+                configure_Component(stack, comp_type, verify_ops);
+                break;
+
             case TESTING_UPPER:
             // fallthrough
             case TESTING_LOWER:
@@ -632,6 +683,29 @@ rtaProtocolStack_GetParam(RtaProtocolStack *stack, const char *domain, const cha
     return parcJSONValue_GetJSON(value);
 }
 
+PARCJSON *
+rtaProtocolStack_GetParameters(RtaProtocolStack *stack)
+{
+    assertNotNull(stack, "%s called with null stack\n", __func__);
+    return stack->params;
+}
+
+void *
+rtaProtocolStack_GetPrivateData(RtaProtocolStack *stack, RtaComponents component)
+{
+    assertNotNull(stack, "%s called with null stack\n", __func__);
+    assertTrue(component < LAST_COMPONENT, "invalid component %d\n", component);
+    return stack->component_state[component];
+}
+
+void
+rtaProtocolStack_SetPrivateData(RtaProtocolStack *stack, RtaComponents component, void *private)
+{
+    assertNotNull(stack, "%s called with null stack\n", __func__);
+    assertTrue(component < LAST_COMPONENT, "invalid component %d\n", component);
+    stack->component_state[component] = private;
+}
+
 unsigned
 rtaProtocolStack_GetNextConnectionId(RtaProtocolStack *stack)
 {
@@ -686,6 +760,31 @@ rtaProtocolStack_GetStatistics(const RtaProtocolStack *stack, FILE *file)
 
 // =============================================
 
+/**
+ * Sets a component's callbacks on one of its queues
+ *
+ * The read callback is called through a queue scheduler, so connections sharing the
+ * stack take turns in the queue.
+ *
+ * @return non-null The queue scheduler
+ * @return null There is no read callback
+ */
+static RtaQueueScheduler *
+set_queue_callbacks(RtaProtocolStack *stack, PARCEventQueue *queue,
+                    RtaQueueSchedulerReadCallback *readCallback,
+                    RtaQueueSchedulerEventCallback *eventCallback)
+{
+    if (readCallback == NULL) {
+        parcEventQueue_SetCallbacks(queue, NULL, NULL, eventCallback, (void *) stack);
+        return NULL;
+    }
+
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(stack->framework), queue,
+                                                            readCallback, eventCallback, (void *) stack, stack->batch);
+    parcEventQueue_SetCallbacks(queue, rtaQueueScheduler_Read, NULL, rtaQueueScheduler_Event, (void *) scheduler);
+    return scheduler;
+}
+
 static void
 set_queue_pairs(RtaProtocolStack *stack, RtaComponents comp_type)
 {
@@ -702,17 +801,15 @@ set_queue_pairs(RtaProtocolStack *stack, RtaComponents comp_type)
         parcEventQueue_GetConnectedDownQueue(stack->queue_pairs[stack->component_count]);
 
     // Set callbacks on the INPUT queues read by a specific component
-    parcEventQueue_SetCallbacks(stack->component_queues[comp_type]->up,
-                                stack->component_ops[comp_type].downcallRead,
-                                NULL,
-                                stack->component_ops[comp_type].downcallEvent,
-                                (void *) stack);
-
-    parcEventQueue_SetCallbacks(stack->component_queues[comp_type]->down,
-                                stack->component_ops[comp_type].upcallRead,
-                                NULL,
-                                stack->component_ops[comp_type].upcallEvent,
-                                (void *) stack);
+    stack->component_queues[comp_type]->upScheduler =
+        set_queue_callbacks(stack, stack->component_queues[comp_type]->up,
+                            stack->component_ops[comp_type].downcallRead,
+                            stack->component_ops[comp_type].downcallEvent);
+
+    stack->component_queues[comp_type]->downScheduler =
+        set_queue_callbacks(stack, stack->component_queues[comp_type]->down,
+                            stack->component_ops[comp_type].upcallRead,
+                            stack->component_ops[comp_type].upcallEvent);
 }
 
 
@@ -735,11 +832,10 @@ configure_ApiConnector(RtaProtocolStack *stack, RtaComponents comp_type, RtaComp
     stack->component_queues[comp_type]->down =
         parcEventQueue_GetConnectedDownQueue(stack->queue_pairs[stack->component_count]);
 
-    parcEventQueue_SetCallbacks(stack->component_queues[comp_type]->down,
-                                stack->component_ops[comp_type].upcallRead,
-                                NULL,
-                                stack->component_ops[comp_type].upcallEvent,
-                                (void *) stack);
+    stack->component_queues[comp_type]->downScheduler =
+        set_queue_callbacks(stack, stack->component_queues[comp_type]->down,
+                            stack->component_ops[comp_type].upcallRead,
+                            stack->component_ops[comp_type].upcallEvent);
 
     stack->component_count++;
     return 0;
@@ -771,11 +867,10 @@ configure_FwdConnector(RtaProtocolStack *stack, RtaComponents comp_type, RtaComp
     stack->component_queues[comp_type]->up =
         parcEventQueue_GetConnectedUpQueue(stack->queue_pairs[stack->component_count - 1]);
 
-    parcEventQueue_SetCallbacks(stack->component_queues[comp_type]->up,
-                                stack->component_ops[comp_type].downcallRead,
-                                NULL,
-                                stack->component_ops[comp_type].downcallEvent,
-                                (void *) stack);
+    stack->component_queues[comp_type]->upScheduler =
+        set_queue_callbacks(stack, stack->component_queues[comp_type]->up,
+                            stack->component_ops[comp_type].downcallRead,
+                            stack->component_ops[comp_type].downcallEvent);
 
     stack->component_count++;
     return 0;
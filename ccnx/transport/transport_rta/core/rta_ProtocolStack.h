@@ -272,6 +272,18 @@ int rtaProtocolStack_Open(RtaProtocolStack *, struct rta_connection *connection)
  */
 int rtaProtocolStack_Close(RtaProtocolStack *, struct rta_connection *conn);
 
+/**
+ * Calls the flush() function of each component in the protocol stack, top to bottom
+ *
+ * Called while the connection is still open, just before it closes, so a component can
+ * send on the messages it holds (e.g. a partial signing batch) and the components below
+ * still take them.
+ *
+ * @param [in] stack The protocol stack
+ * @param [in] conn The connection about to close
+ */
+void rtaProtocolStack_Flush(RtaProtocolStack *stack, struct rta_connection *conn);
+
 /**
  * <#One Line Description#>
  *
@@ -328,6 +340,26 @@ PARCEventQueue *rtaProtocolStack_GetPutQueue(RtaProtocolStack *stack,
  */
 PARCJSON *rtaProtocolStack_GetParam(RtaProtocolStack *stack, const char *domain, const char *key);
 
+/**
+ * Returns the protocol stack configuration
+ *
+ * This is the JSON passed to `rtaProtocolStack_Create()`.  Components use it to
+ * read their stack-wide settings in their Init function.  Do not release it.
+ *
+ * @param [in] stack An allocated protocol stack
+ *
+ * @return non-null The stack configuration JSON
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *params = rtaProtocolStack_GetParameters(stack);
+ *     size_t maxObjects = contentStore_GetMaxObjectsFromConfig(params);
+ * }
+ * @endcode
+ */
+PARCJSON *rtaProtocolStack_GetParameters(RtaProtocolStack *stack);
+
 /**
  * <#One Line Description#>
  *
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_EventBuffer.h>
+#include <parc/algol/parc_EventTimer.h>
+
+#include <ccnx/transport/common/transport_Message.h>
+#include <ccnx/transport/transport_rta/core/rta_Connection.h>
+#include <ccnx/transport/transport_rta/core/rta_QueueScheduler.h>
+
+/**
+ * The messages of one connection held back by the scheduler
+ */
+typedef struct rta_scheduler_flow {
+    // Not a reference, every held message has one
+    RtaConnection *connection;
+
+    // TransportMessage pointers, oldest first
+    PARCEventBuffer *messages;
+    size_t count;
+
+    // messages the flow may still send in this round
+    unsigned deficit;
+    bool granted;
+
+    TAILQ_ENTRY(rta_scheduler_flow) list;
+} _RtaSchedulerFlow;
+
+struct rta_queue_scheduler {
+    PARCEventQueue *queue;
+    RtaQueueSchedulerReadCallback *readCallback;
+    RtaQueueSchedulerEventCallback *eventCallback;
+    void *stack;
+    unsigned batch;
+
+    // gives the next batch after we yield to the event scheduler
+    PARCEventTimer *resumeTimer;
+    bool resumePending;
+
+    // the read callback may cause more messages on our queue; do not reschedule under it
+    bool reading;
+
+    // flows with held messages, in round robin order
+    TAILQ_HEAD(rta_scheduler_flow_list, rta_scheduler_flow) active;
+    size_t backlog;
+
+    // held control messages of connections with no flow, oldest first.  They go ahead of the flows.
+    PARCEventBuffer *control;
+    size_t controlCount;
+
+    RtaQueueSchedulerStats stats;
+};
+
+static void _rtaQueueScheduler_Resume(int fd, PARCEventType type, void *schedulerVoid);
+
+RtaQueueScheduler *
+rtaQueueScheduler_Create(PARCEventScheduler *base, PARCEventQueue *queue,
+                         RtaQueueSchedulerReadCallback *readCallback,
+                         RtaQueueSchedulerEventCallback *eventCallback,
+                         void *stack, unsigned batch)
+{
+    assertNotNull(base, "Parameter base must be non-null");
+    assertNotNull(queue, "Parameter queue must be non-null");
+    assertNotNull(readCallback, "Parameter readCallback must be non-null");
+    assertTrue(batch > 0, "Parameter batch must be positive");
+
+    RtaQueueScheduler *scheduler = parcMemory_AllocateAndClear(sizeof(RtaQueueScheduler));
+    assertNotNull(scheduler, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaQueueScheduler));
+
+    scheduler->queue = queue;
+    scheduler->readCallback = readCallback;
+    scheduler->eventCallback = eventCallback;
+    scheduler->stack = stack;
+    scheduler->batch = batch;
+    TAILQ_INIT(&scheduler->active);
+    scheduler->control = parcEventBuffer_Create();
+
+    scheduler->resumeTimer = parcEventTimer_Create(base, 0, _rtaQueueScheduler_Resume, scheduler);
+    assertNotNull(scheduler->resumeTimer, "Got null result from parcEventTimer_Create");
+
+    return scheduler;
+}
+
+static TransportMessage *
+_rtaQueueScheduler_BufferRemove(PARCEventBuffer *buffer)
+{
+    TransportMessage *tm;
+    int len = parcEventBuffer_Read(buffer, (void *) &tm, sizeof(&tm));
+    assertTrue(len == sizeof(TransportMessage *), "parcEventBuffer_Read returned %d", len);
+    return tm;
+}
+
+static void
+_rtaQueueScheduler_BufferAppend(PARCEventBuffer *buffer, TransportMessage *tm)
+{
+    int res = parcEventBuffer_Append(buffer, (void *) &tm, sizeof(&tm));
+    assertTrue(res == 0, "parcEventBuffer_Append returned error");
+}
+
+static TransportMessage *
+_rtaQueueScheduler_FlowRemove(_RtaSchedulerFlow *flow)
+{
+    flow->count--;
+    return _rtaQueueScheduler_BufferRemove(flow->messages);
+}
+
+static void
+_rtaQueueScheduler_Release(TransportMessage *tm)
+{
+    (void) rtaConnection_DecrementMessagesInQueue(rtaConnection_GetFromTransport(tm));
+    transportMessage_Destroy(&tm);
+}
+
+static void
+_rtaQueueScheduler_FlowDestroy(RtaQueueScheduler *scheduler, _RtaSchedulerFlow **flowPtr)
+{
+    _RtaSchedulerFlow *flow = *flowPtr;
+    TAILQ_REMOVE(&scheduler->active, flow, list);
+    parcEventBuffer_Destroy(&flow->messages);
+    parcMemory_Deallocate((void **) flowPtr);
+}
+
+void
+rtaQueueScheduler_Destroy(RtaQueueScheduler **schedulerPtr)
+{
+    assertNotNull(schedulerPtr, "Parameter schedulerPtr must be non-null");
+    assertNotNull(*schedulerPtr, "Parameter schedulerPtr must dereference to non-null");
+    RtaQueueScheduler *scheduler = *schedulerPtr;
+
+    parcEventTimer_Stop(scheduler->resumeTimer);
+    parcEventTimer_Destroy(&scheduler->resumeTimer);
+
+    while (scheduler->controlCount > 0) {
+        _rtaQueueScheduler_Release(_rtaQueueScheduler_BufferRemove(scheduler->control));
+        scheduler->controlCount--;
+    }
+    parcEventBuffer_Destroy(&scheduler->control);
+
+    _RtaSchedulerFlow *flow;
+    while ((flow = TAILQ_FIRST(&scheduler->active)) != NULL) {
+        while (flow->count > 0) {
+            _rtaQueueScheduler_Release(_rtaQueueScheduler_FlowRemove(flow));
+        }
+        _rtaQueueScheduler_FlowDestroy(scheduler, &flow);
+    }
+
+    parcMemory_Deallocate((void **) schedulerPtr);
+}
+
+static _RtaSchedulerFlow *
+_rtaQueueScheduler_FindFlow(RtaQueueScheduler *scheduler, RtaConnection *conn)
+{
+    // A few connections per stack, a linear search is fine.  Look from the tail,
+    // where the most recent arrivals are.
+    _RtaSchedulerFlow *flow;
+    TAILQ_FOREACH_REVERSE(flow, &scheduler->active, rta_scheduler_flow_list, list)
+    {
+        if (flow->connection == conn) {
+            break;
+        }
+    }
+    return flow;
+}
+
+/**
+ * Moves everything in the input queue to the priority lane or the per-connection flows
+ *
+ * A control message only goes in the priority lane if its connection has no data held
+ * back.  Otherwise it waits in the connection's flow, so it does not overtake the data
+ * it follows, e.g. a CONNECTION_CLOSED or the end of a stream.
+ */
+static void
+_rtaQueueScheduler_Enqueue(RtaQueueScheduler *scheduler, PARCEventBuffer *in)
+{
+    while (parcEventBuffer_GetLength(in) >= sizeof(TransportMessage *)) {
+        TransportMessage *tm = _rtaQueueScheduler_BufferRemove(in);
+        scheduler->backlog++;
+
+        RtaConnection *conn = rtaConnection_GetFromTransport(tm);
+        assertNotNull(conn, "Got null connection from transport message");
+
+        _RtaSchedulerFlow *flow = _rtaQueueScheduler_FindFlow(scheduler, conn);
+
+        if (flow == NULL && transportMessage_IsControl(tm)) {
+            _rtaQueueScheduler_BufferAppend(scheduler->control, tm);
+            scheduler->controlCount++;
+            scheduler->stats.control++;
+            continue;
+        }
+
+        if (flow == NULL) {
+            flow = parcMemory_AllocateAndClear(sizeof(_RtaSchedulerFlow));
+            assertNotNull(flow, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_RtaSchedulerFlow));
+            flow->connection = conn;
+            flow->messages = parcEventBuffer_Create();
+            TAILQ_INSERT_TAIL(&scheduler->active, flow, list);
+        }
+
+        _rtaQueueScheduler_BufferAppend(flow->messages, tm);
+        flow->count++;
+    }
+}
+
+/**
+ * Puts up to one batch of held messages back in the (empty) input queue: the priority lane
+ * first, then the flows in deficit round robin order
+ */
+static void
+_rtaQueueScheduler_FillBatch(RtaQueueScheduler *scheduler, PARCEventBuffer *in)
+{
+    unsigned remaining = scheduler->batch;
+    _RtaSchedulerFlow *flow;
+
+    while (remaining > 0 && scheduler->controlCount > 0) {
+        _rtaQueueScheduler_BufferAppend(in, _rtaQueueScheduler_BufferRemove(scheduler->control));
+        scheduler->controlCount--;
+        scheduler->backlog--;
+        remaining--;
+    }
+
+    while (remaining > 0 && (flow = TAILQ_FIRST(&scheduler->active)) != NULL) {
+        // A flow interrupted by the end of a batch keeps what is left of its quantum
+        if (!flow->granted) {
+            flow->deficit += rtaConnection_GetWeight(flow->connection);
+            flow->granted = true;
+        }
+
+        while (remaining > 0 && flow->deficit > 0 && flow->count > 0) {
+            _rtaQueueScheduler_BufferAppend(in, _rtaQueueScheduler_FlowRemove(flow));
+            flow->deficit--;
+            scheduler->backlog--;
+            remaining--;
+        }
+
+        if (flow->count == 0) {
+            _rtaQueueScheduler_FlowDestroy(scheduler, &flow);
+        } else if (flow->deficit == 0) {
+            flow->granted = false;
+            TAILQ_REMOVE(&scheduler->active, flow, list);
+            TAILQ_INSERT_TAIL(&scheduler->active, flow, list);
+        }
+    }
+}
+
+void
+rtaQueueScheduler_Read(PARCEventQueue *queue, PARCEventType events, void *schedulerVoid)
+{
+    RtaQueueScheduler *scheduler = (RtaQueueScheduler *) schedulerVoid;
+    assertNotNull(scheduler, "Parameter schedulerVoid must be non-null");
+
+    if (scheduler->reading) {
+        // The read callback is draining the queue, it will see these messages
+        return;
+    }
+
+    PARCEventBuffer *in = parcEventBuffer_GetQueueBufferInput(queue);
+    size_t waiting = parcEventBuffer_GetLength(in) / sizeof(TransportMessage *);
+
+    if (scheduler->backlog > 0 || waiting > scheduler->batch) {
+        _rtaQueueScheduler_Enqueue(scheduler, in);
+        if (scheduler->backlog > scheduler->stats.maxBacklog) {
+            scheduler->stats.maxBacklog = scheduler->backlog;
+        }
+        _rtaQueueScheduler_FillBatch(scheduler, in);
+        scheduler->stats.batches++;
+    }
+
+    scheduler->reading = true;
+    scheduler->readCallback(queue, events, scheduler->stack);
+    scheduler->reading = false;
+    scheduler->stats.callbacks++;
+
+    // Give the other events a turn before the next batch
+    bool more = scheduler->backlog > 0 || parcEventBuffer_GetLength(in) >= sizeof(TransportMessage *);
+    if (more && !scheduler->resumePending) {
+        struct timeval immediateTimeout = { 0, 0 };
+        parcEventTimer_Start(scheduler->resumeTimer, &immediateTimeout);
+        scheduler->resumePending = true;
+        scheduler->stats.yields++;
+    }
+
+    parcEventBuffer_Destroy(&in);
+}
+
+void
+rtaQueueScheduler_Event(PARCEventQueue *queue, PARCEventQueueEventType events, void *schedulerVoid)
+{
+    RtaQueueScheduler *scheduler = (RtaQueueScheduler *) schedulerVoid;
+    assertNotNull(scheduler, "Parameter schedulerVoid must be non-null");
+
+    if (scheduler->eventCallback != NULL) {
+        scheduler->eventCallback(queue, events, scheduler->stack);
+    }
+}
+
+static void
+_rtaQueueScheduler_Resume(int fd, PARCEventType type, void *schedulerVoid)
+{
+    RtaQueueScheduler *scheduler = (RtaQueueScheduler *) schedulerVoid;
+    scheduler->resumePending = false;
+    rtaQueueScheduler_Read(scheduler->queue, PARCEventType_Read, scheduler);
+}
+
+size_t
+rtaQueueScheduler_GetBacklog(const RtaQueueScheduler *scheduler)
+{
+    assertNotNull(scheduler, "Parameter scheduler must be non-null");
+    return scheduler->backlog;
+}
+
+const RtaQueueSchedulerStats *
+rtaQueueScheduler_GetStats(const RtaQueueScheduler *scheduler)
+{
+    assertNotNull(scheduler, "Parameter scheduler must be non-null");
+    return &scheduler->stats;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_QueueScheduler.h
+ * @brief Deficit round robin between the connections sharing a component's input queue
+ *
+ * Every connection of a protocol stack shares the same queue between two components.  A
+ * component's read callback drains its input queue, so a connection that puts 10,000
+ * messages in the queue would hold the RTA thread until all of them are processed, and
+ * every other connection on the stack waits behind it.
+ *
+ * The protocol stack puts a queue scheduler between each input queue and the component's
+ * read callback.  When the queue has more than one batch of messages, the scheduler moves
+ * them to a sub-queue per connection and gives the component one batch, picked by deficit
+ * round robin over the connections.  A connection's quantum is its weight (see
+ * `apiConnector_SetSchedulingWeight()`) times one message.  After the component returns,
+ * the scheduler yields to the event scheduler and gives it the next batch from a timer.
+ *
+ * Control messages (`transportMessage_IsControl()`), such as CPI requests and the status
+ * notifications of `rtaConnection_SendStatus()`, do not wait for other connections' data.  They
+ * go in a priority lane that is emptied at the start of every batch, so the control plane
+ * waits for at most one batch of data however much data is queued.  A control message of a
+ * connection that has data held back stays behind that data, so each connection's messages
+ * keep their order and a CONNECTION_CLOSED never overtakes the data before it.
+ *
+ * When nothing is held back and the input fits in one batch, the component's read callback
+ * is called directly, so a lightly loaded stack behaves as before.
+ *
+ * The component does not change: it still calls `rtaComponent_GetMessage()` until it
+ * returns NULL.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_rta_QueueScheduler_h
+#define Libccnx_rta_QueueScheduler_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <parc/algol/parc_EventQueue.h>
+#include <parc/algol/parc_EventScheduler.h>
+
+struct rta_queue_scheduler;
+typedef struct rta_queue_scheduler RtaQueueScheduler;
+
+/**
+ * A component's read callback, as in `RtaComponentOperations`
+ */
+typedef void (RtaQueueSchedulerReadCallback)(PARCEventQueue *queue, PARCEventType events, void *stack);
+
+/**
+ * A component's event callback, as in `RtaComponentOperations`
+ */
+typedef void (RtaQueueSchedulerEventCallback)(PARCEventQueue *queue, PARCEventQueueEventType events, void *stack);
+
+/**
+ * Counters kept by the scheduler.  They are cumulative over the life of the scheduler.
+ */
+typedef struct rta_queue_scheduler_stats {
+    uint64_t callbacks;     // calls to the component's read callback
+    uint64_t batches;       // of those, the ones given a scheduled batch
+    uint64_t yields;        // times messages were held back for a later turn
+    uint64_t maxBacklog;    // the most messages ever held back
+    uint64_t control;       // control messages given the priority lane
+} RtaQueueSchedulerStats;
+
+/**
+ * Create a scheduler for one input queue
+ *
+ * The caller registers `rtaQueueScheduler_Read()` as the queue's read callback and
+ * `rtaQueueScheduler_Event()` as its event callback, with the scheduler as their argument.
+ *
+ * @param [in] base The event scheduler of the RTA thread
+ * @param [in] queue The component's input queue
+ * @param [in] readCallback The component's read callback
+ * @param [in] eventCallback The component's event callback, may be NULL
+ * @param [in] stack The argument of the callbacks (the protocol stack)
+ * @param [in] batch The most messages given to the read callback in one turn (positive)
+ *
+ * @return non-null An allocated scheduler, destroy with `rtaQueueScheduler_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(base, queue, ops.downcallRead, ops.downcallEvent, stack, 64);
+ *     parcEventQueue_SetCallbacks(queue, rtaQueueScheduler_Read, NULL, rtaQueueScheduler_Event, scheduler);
+ * }
+ * @endcode
+ */
+RtaQueueScheduler *rtaQueueScheduler_Create(PARCEventScheduler *base, PARCEventQueue *queue,
+                                            RtaQueueSchedulerReadCallback *readCallback,
+                                            RtaQueueSchedulerEventCallback *eventCallback,
+                                            void *stack, unsigned batch);
+
+/**
+ * Destroys the scheduler
+ *
+ * Messages still held back are destroyed as if `rtaComponent_GetMessage()` had drained them.
+ *
+ * @param [in,out] schedulerPtr Pointer to the scheduler, will be NULL'd
+ */
+void rtaQueueScheduler_Destroy(RtaQueueScheduler **schedulerPtr);
+
+/**
+ * The read callback to register on the input queue
+ *
+ * @param [in] queue The input queue
+ * @param [in] events The PARCEvent events
+ * @param [in] schedulerVoid The RtaQueueScheduler of the queue
+ */
+void rtaQueueScheduler_Read(PARCEventQueue *queue, PARCEventType events, void *schedulerVoid);
+
+/**
+ * The event callback to register on the input queue, passes the event to the component
+ *
+ * @param [in] queue The input queue
+ * @param [in] events The PARCEventQueue events
+ * @param [in] schedulerVoid The RtaQueueScheduler of the queue
+ */
+void rtaQueueScheduler_Event(PARCEventQueue *queue, PARCEventQueueEventType events, void *schedulerVoid);
+
+/**
+ * The number of messages held back for a later turn
+ */
+size_t rtaQueueScheduler_GetBacklog(const RtaQueueScheduler *scheduler);
+
+/**
+ * Returns the cumulative counters of the scheduler.  Do not free it.
+ */
+const RtaQueueSchedulerStats *rtaQueueScheduler_GetStats(const RtaQueueScheduler *scheduler);
+#endif // Libccnx_rta_QueueScheduler_h
@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * Each status code and name has a slot.  A slot is idle, or open with a window in progress.  The
+ * first event on an idle slot is delivered and opens it.  Events on an open slot are held:
+ * the slot counts them and keeps the last one.  When the timer fires, every open slot with
+ * held events delivers them as one notification and stays open, and every open slot
+ * without held events goes idle.  The timer runs while any slot is open.
+ *
+ * Statuses without a name use a fixed slot per code.  A named slot is created when its
+ * first event arrives and freed when it goes idle, so a connection only keeps the names
+ * that had an event in the last window.  Named slots are found through a hash table on
+ * (code, name), which grows with them, so a post costs the same however many names are open.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/transport/transport_rta/core/rta_StatusCoalescer.h>
+#include <ccnx/transport/transport_rta/core/rta_Timer.h>
+
+// larger than any NotifyStatusCode, a status with a code beyond it is delivered at once
+#define RTA_STATUS_CODES 32
+
+#define MIN_BUCKETS 16
+
+typedef struct rta_status_slot {
+    NotifyStatusCode code;
+    CCNxName *name;         // NULL for the slot of the code's statuses without a name
+    uint64_t hash;          // of code and name, for a named slot
+
+    bool open;              // a window is in progress
+    uint32_t held;          // events held since the window opened or last delivered
+
+    // the last held event
+    NotifyStatus *last;
+    RtaComponents component;
+    RtaDirection direction;
+
+    TAILQ_ENTRY(rta_status_slot) list;
+    LIST_ENTRY(rta_status_slot) bucketList;
+} _RtaStatusSlot;
+
+LIST_HEAD(rta_status_bucket, rta_status_slot);
+
+struct rta_status_coalescer {
+    struct timeval window;
+    bool coalesce;
+    RtaTimer *windowTimer;
+
+    RtaStatusCoalescerDeliver *deliver;
+    void *user_data;
+
+    uint64_t events[RTA_STATUS_CODES];      // posted with each code
+    uint64_t delivered[RTA_STATUS_CODES];   // notifications delivered for each code
+
+    unsigned openSlots;
+    _RtaStatusSlot slots[RTA_STATUS_CODES];
+
+    // the open slots of named statuses, and the same slots by hash, bucketCount is a power of 2
+    TAILQ_HEAD(, rta_status_slot) namedSlots;
+    size_t namedCount;
+    size_t bucketCount;
+    struct rta_status_bucket *buckets;
+};
+
+static void
+_rtaStatusCoalescer_Deliver(RtaStatusCoalescer *coalescer, NotifyStatusCode code, RtaComponents component,
+                            RtaDirection direction, const NotifyStatus *status)
+{
+    coalescer->delivered[code]++;
+    coalescer->deliver(status, component, direction, coalescer->user_data);
+}
+
+/**
+ * Delivers the slot's held events as one notification, whose count is the sum of their counts
+ */
+static void
+_rtaStatusCoalescer_DeliverHeld(RtaStatusCoalescer *coalescer, _RtaStatusSlot *slot)
+{
+    NotifyStatus *last = slot->last;
+    NotifyStatus *status = notifyStatus_CreateWithCount(notifyStatus_GetFiledes(last), notifyStatus_GetStatusCode(last),
+                                                        notifyStatus_GetName(last), notifyStatus_GetMessage(last), slot->held);
+    slot->held = 0;
+    slot->last = NULL;
+
+    _rtaStatusCoalescer_Deliver(coalescer, slot->code, slot->component, slot->direction, status);
+
+    notifyStatus_Release(&status);
+    notifyStatus_Release(&last);
+}
+
+static uint64_t
+_rtaStatusCoalescer_Hash(NotifyStatusCode code, const CCNxName *name)
+{
+    return ccnxName_HashCode(name) ^ ((uint64_t) code * UINT64_C(0x9E3779B97F4A7C15));
+}
+
+static struct rta_status_bucket *
+_rtaStatusCoalescer_GetBucket(RtaStatusCoalescer *coalescer, uint64_t hash)
+{
+    return &coalescer->buckets[hash & (coalescer->bucketCount - 1)];
+}
+
+static void
+_rtaStatusCoalescer_AllocateBuckets(RtaStatusCoalescer *coalescer, size_t bucketCount)
+{
+    coalescer->bucketCount = bucketCount;
+    coalescer->buckets = parcMemory_Allocate(bucketCount * sizeof(struct rta_status_bucket));
+    assertNotNull(coalescer->buckets, "parcMemory_Allocate(%zu) returned NULL", bucketCount * sizeof(struct rta_status_bucket));
+    for (size_t i = 0; i < bucketCount; i++) {
+        LIST_INIT(&coalescer->buckets[i]);
+    }
+}
+
+/**
+ * Double the buckets, so a chain stays about one slot long
+ */
+static void
+_rtaStatusCoalescer_Grow(RtaStatusCoalescer *coalescer)
+{
+    parcMemory_Deallocate((void **) &coalescer->buckets);
+    _rtaStatusCoalescer_AllocateBuckets(coalescer, coalescer->bucketCount * 2);
+
+    _RtaStatusSlot *slot;
+    TAILQ_FOREACH(slot, &coalescer->namedSlots, list)
+    {
+        LIST_INSERT_HEAD(_rtaStatusCoalescer_GetBucket(coalescer, slot->hash), slot, bucketList);
+    }
+}
+
+static void
+_rtaStatusCoalescer_DestroyNamedSlot(RtaStatusCoalescer *coalescer, _RtaStatusSlot *slot)
+{
+    TAILQ_REMOVE(&coalescer->namedSlots, slot, list);
+    LIST_REMOVE(slot, bucketList);
+    coalescer->namedCount--;
+    if (slot->last != NULL) {
+        notifyStatus_Release(&slot->last);
+    }
+    ccnxName_Release(&slot->name);
+    parcMemory_Deallocate((void **) &slot);
+}
+
+/**
+ * The slot for the status's code and name, a new idle one for a name without a slot
+ */
+static _RtaStatusSlot *
+_rtaStatusCoalescer_GetSlot(RtaStatusCoalescer *coalescer, NotifyStatusCode code, const CCNxName *name)
+{
+    if (name == NULL) {
+        return &coalescer->slots[code];
+    }
+
+    uint64_t hash = _rtaStatusCoalescer_Hash(code, name);
+    _RtaStatusSlot *slot;
+    LIST_FOREACH(slot, _rtaStatusCoalescer_GetBucket(coalescer, hash), bucketList)
+    {
+        if (slot->hash == hash && slot->code == code && ccnxName_Equals(slot->name, name)) {
+            return slot;
+        }
+    }
+
+    slot = parcMemory_AllocateAndClear(sizeof(_RtaStatusSlot));
+    assertNotNull(slot, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_RtaStatusSlot));
+    slot->code = code;
+    slot->name = ccnxName_Acquire(name);
+    slot->hash = hash;
+    TAILQ_INSERT_TAIL(&coalescer->namedSlots, slot, list);
+    LIST_INSERT_HEAD(_rtaStatusCoalescer_GetBucket(coalescer, hash), slot, bucketList);
+
+    coalescer->namedCount++;
+    if (coalescer->namedCount > coalescer->bucketCount) {
+        _rtaStatusCoalescer_Grow(coalescer);
+    }
+    return slot;
+}
+
+/**
+ * At the end of a window: deliver what the slot holds, or let it go idle
+ *
+ * @return true The slot went idle
+ */
+static bool
+_rtaStatusCoalescer_CloseWindow(RtaStatusCoalescer *coalescer, _RtaStatusSlot *slot)
+{
+    if (slot->held > 0) {
+        _rtaStatusCoalescer_DeliverHeld(coalescer, slot);
+        return false;
+    }
+
+    slot->open = false;
+    coalescer->openSlots--;
+    return true;
+}
+
+static void
+_rtaStatusCoalescer_WindowClosed(int fd, PARCEventType type, void *user_data)
+{
+    RtaStatusCoalescer *coalescer = (RtaStatusCoalescer *) user_data;
+
+    for (int code = 0; code < RTA_STATUS_CODES; code++) {
+        _RtaStatusSlot *slot = &coalescer->slots[code];
+        if (slot->open) {
+            _rtaStatusCoalescer_CloseWindow(coalescer, slot);
+        }
+    }
+
+    _RtaStatusSlot *slot = TAILQ_FIRST(&coalescer->namedSlots);
+    while (slot != NULL) {
+        _RtaStatusSlot *next = TAILQ_NEXT(slot, list);
+        if (_rtaStatusCoalescer_CloseWindow(coalescer, slot)) {
+            _rtaStatusCoalescer_DestroyNamedSlot(coalescer, slot);
+        }
+        slot = next;
+    }
+
+    if (coalescer->openSlots > 0) {
+        rtaTimer_Start(coalescer->windowTimer, &coalescer->window);
+    }
+}
+
+RtaStatusCoalescer *
+rtaStatusCoalescer_Create(RtaFramework *framework, const struct timeval *window,
+                          RtaStatusCoalescerDeliver *deliver, void *user_data)
+{
+    assertNotNull(window, "Parameter window must be non-null");
+    assertTrue(framework != NULL || !timerisset(window), "Parameter framework must be non-null with a window");
+    assertNotNull(deliver, "Parameter deliver must be non-null");
+
+    RtaStatusCoalescer *coalescer = parcMemory_AllocateAndClear(sizeof(RtaStatusCoalescer));
+    assertNotNull(coalescer, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaStatusCoalescer));
+
+    coalescer->window = *window;
+    coalescer->coalesce = timerisset(window);
+    coalescer->deliver = deliver;
+    coalescer->user_data = user_data;
+    TAILQ_INIT(&coalescer->namedSlots);
+    _rtaStatusCoalescer_AllocateBuckets(coalescer, MIN_BUCKETS);
+
+    for (int code = 0; code < RTA_STATUS_CODES; code++) {
+        coalescer->slots[code].code = code;
+    }
+
+    if (coalescer->coalesce) {
+        coalescer->windowTimer = rtaTimer_Create(framework, 0, _rtaStatusCoalescer_WindowClosed, coalescer);
+    }
+    return coalescer;
+}
+
+void
+rtaStatusCoalescer_Destroy(RtaStatusCoalescer **coalescerPtr)
+{
+    assertNotNull(coalescerPtr, "Parameter coalescerPtr must be non-null");
+    RtaStatusCoalescer *coalescer = *coalescerPtr;
+    assertNotNull(coalescer, "Parameter must dereference to non-null");
+
+    if (coalescer->windowTimer != NULL) {
+        rtaTimer_Destroy(&coalescer->windowTimer);
+    }
+
+    for (int code = 0; code < RTA_STATUS_CODES; code++) {
+        if (coalescer->slots[code].last != NULL) {
+            notifyStatus_Release(&coalescer->slots[code].last);
+        }
+    }
+
+    while (!TAILQ_EMPTY(&coalescer->namedSlots)) {
+        _rtaStatusCoalescer_DestroyNamedSlot(coalescer, TAILQ_FIRST(&coalescer->namedSlots));
+    }
+    parcMemory_Deallocate((void **) &coalescer->buckets);
+
+    parcMemory_Deallocate((void **) &coalescer);
+    *coalescerPtr = NULL;
+}
+
+bool
+rtaStatusCoalescer_Post(RtaStatusCoalescer *coalescer, RtaComponents component, RtaDirection direction, const NotifyStatus *status)
+{
+    assertNotNull(coalescer, "Parameter coalescer must be non-null");
+    assertNotNull(status, "Parameter status must be non-null");
+
+    NotifyStatusCode code = notifyStatus_GetStatusCode(status);
+    if (code < 0 || code >= RTA_STATUS_CODES) {
+        coalescer->deliver(status, component, direction, coalescer->user_data);
+        return true;
+    }
+
+    coalescer->events[code] += notifyStatus_GetCount(status);
+
+    if (!coalescer->coalesce) {
+        _rtaStatusCoalescer_Deliver(coalescer, code, component, direction, status);
+        return true;
+    }
+
+    if (code == notifyStatusCode_CONNECTION_CLOSED) {
+        // the API should see the held events before the close
+        rtaStatusCoalescer_Flush(coalescer);
+    }
+
+    _RtaStatusSlot *slot = _rtaStatusCoalescer_GetSlot(coalescer, code, notifyStatus_GetName(status));
+
+    if (!slot->open) {
+        slot->open = true;
+        coalescer->openSlots++;
+        if (!rtaTimer_IsPending(coalescer->windowTimer)) {
+            rtaTimer_Start(coalescer->windowTimer, &coalescer->window);
+        }
+        _rtaStatusCoalescer_Deliver(coalescer, code, component, direction, status);
+        return true;
+    }
+
+    if (slot->last != NULL) {
+        notifyStatus_Release(&slot->last);
+    }
+    slot->last = notifyStatus_Acquire(status);
+    slot->held += notifyStatus_GetCount(status);
+    slot->component = component;
+    slot->direction = direction;
+    return false;
+}
+
+void
+rtaStatusCoalescer_Flush(RtaStatusCoalescer *coalescer)
+{
+    assertNotNull(coalescer, "Parameter coalescer must be non-null");
+
+    for (int code = 0; code < RTA_STATUS_CODES; code++) {
+        _RtaStatusSlot *slot = &coalescer->slots[code];
+        if (slot->held > 0) {
+            _rtaStatusCoalescer_DeliverHeld(coalescer, slot);
+        }
+    }
+
+    _RtaStatusSlot *slot;
+    TAILQ_FOREACH(slot, &coalescer->namedSlots, list)
+    {
+        if (slot->held > 0) {
+            _rtaStatusCoalescer_DeliverHeld(coalescer, slot);
+        }
+    }
+}
+
+uint64_t
+rtaStatusCoalescer_GetEventCount(const RtaStatusCoalescer *coalescer, NotifyStatusCode code)
+{
+    assertNotNull(coalescer, "Parameter coalescer must be non-null");
+    if (code < 0 || code >= RTA_STATUS_CODES) {
+        return 0;
+    }
+    return coalescer->events[code];
+}
+
+uint64_t
+rtaStatusCoalescer_GetDeliveredCount(const RtaStatusCoalescer *coalescer, NotifyStatusCode code)
+{
+    assertNotNull(coalescer, "Parameter coalescer must be non-null");
+    if (code < 0 || code >= RTA_STATUS_CODES) {
+        return 0;
+    }
+    return coalescer->delivered[code];
+}
+
+uint64_t
+rtaStatusCoalescer_GetPendingCount(const RtaStatusCoalescer *coalescer)
+{
+    assertNotNull(coalescer, "Parameter coalescer must be non-null");
+
+    uint64_t pending = 0;
+    for (int code = 0; code < RTA_STATUS_CODES; code++) {
+        pending += coalescer->slots[code].held;
+    }
+
+    const _RtaStatusSlot *slot;
+    TAILQ_FOREACH(slot, &coalescer->namedSlots, list)
+    {
+        pending += slot->held;
+    }
+    return pending;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_StatusCoalescer.h
+ * @brief Coalesces a connection's status notifications (see `rtaConnection_SendStatus()`)
+ *
+ * Every status event used to become its own JSON notification, sent up through every
+ * component.  A connection with thousands of flow control sessions, or a failing forwarder
+ * socket, floods the API with identical notifications.
+ *
+ * With a window, the first event with a given status code and name is delivered at once and
+ * opens a window for that code and name.  Further events with the same code and name during
+ * the window are only counted.  When the window closes, the held events are delivered as one
+ * notification whose count (`notifyStatus_GetCount()`) is the number of events, carrying the
+ * message of the last one, and the window opens again.  A code and name with no events during
+ * a window go back to delivering the next event at once.  So each code and name is delivered at
+ * most once per window, and every event is accounted for in some notification's count.  Events
+ * with different names, e.g. the flow control sessions of different streams, are never merged.
+ *
+ * A CONNECTION_CLOSED event first delivers everything held, so the API sees those events
+ * before the close.
+ *
+ * With no window, every event is delivered at once, as before.  Either way the coalescer
+ * counts the events of each code (`rtaStatusCoalescer_GetEventCount()`).
+ *
+ * The windows of all codes on a connection open and close on one timer.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_rta_StatusCoalescer_h
+#define Libccnx_rta_StatusCoalescer_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <ccnx/api/notify/notify_Status.h>
+
+#include <ccnx/transport/transport_rta/core/components.h>
+#include <ccnx/transport/transport_rta/core/rta_ComponentQueue.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework.h>
+
+struct rta_status_coalescer;
+typedef struct rta_status_coalescer RtaStatusCoalescer;
+
+/**
+ * Sends a notification on its way, e.g. `rtaComponent_PutMessage()` on the output queue of the component
+ *
+ * @param [in] status The notification, the callee acquires it if it keeps it
+ * @param [in] component The component that raised the (last) event
+ * @param [in] direction The direction the component sent it
+ * @param [in] user_data As given to `rtaStatusCoalescer_Create()`
+ */
+typedef void (RtaStatusCoalescerDeliver)(const NotifyStatus *status, RtaComponents component, RtaDirection direction, void *user_data);
+
+/**
+ * Create a coalescer for one connection
+ *
+ * @param [in] framework The framework whose clock times the window, may be NULL without a window
+ * @param [in] window The window, zero to deliver every event at once
+ * @param [in] deliver Called for every notification delivered
+ * @param [in] user_data Passed to `deliver`
+ *
+ * @return non-null An allocated coalescer, destroy with `rtaStatusCoalescer_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     struct timeval window = { .tv_sec = 0, .tv_usec = 100000 };
+ *     RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(framework, &window, deliverCallback, conn);
+ * }
+ * @endcode
+ */
+RtaStatusCoalescer *rtaStatusCoalescer_Create(RtaFramework *framework, const struct timeval *window,
+                                              RtaStatusCoalescerDeliver *deliver, void *user_data);
+
+/**
+ * Destroys the coalescer.  Events held in an open window are dropped, they are still in the counts.
+ *
+ * @param [in,out] coalescerPtr Pointer to the coalescer, will be NULL'd
+ */
+void rtaStatusCoalescer_Destroy(RtaStatusCoalescer **coalescerPtr);
+
+/**
+ * Delivers the status now, or holds it until the window of its code and name closes
+ *
+ * @param [in] coalescer The coalescer
+ * @param [in] component The component raising the event
+ * @param [in] direction The direction of the notification
+ * @param [in] status The event, with a count of 1 or more
+ *
+ * @return true The status was delivered
+ * @return false The status is held in an open window
+ */
+bool rtaStatusCoalescer_Post(RtaStatusCoalescer *coalescer, RtaComponents component, RtaDirection direction, const NotifyStatus *status);
+
+/**
+ * Delivers every held event now, one notification per code and name
+ *
+ * @param [in] coalescer The coalescer
+ */
+void rtaStatusCoalescer_Flush(RtaStatusCoalescer *coalescer);
+
+/**
+ * The number of events posted with the code, delivered or not
+ */
+uint64_t rtaStatusCoalescer_GetEventCount(const RtaStatusCoalescer *coalescer, NotifyStatusCode code);
+
+/**
+ * The number of notifications delivered for the code
+ */
+uint64_t rtaStatusCoalescer_GetDeliveredCount(const RtaStatusCoalescer *coalescer, NotifyStatusCode code);
+
+/**
+ * The number of events held in open windows, over all codes
+ */
+uint64_t rtaStatusCoalescer_GetPendingCount(const RtaStatusCoalescer *coalescer);
+#endif // Libccnx_rta_StatusCoalescer_h
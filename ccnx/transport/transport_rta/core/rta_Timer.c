@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * The virtual timer queue is a binary min-heap ordered by (expiry, sequence).  The sequence
+ * number is taken each time a timer is started, so timers with equal expiries fire in the
+ * order they were started.  Each timer remembers its heap index so it can be stopped in
+ * O(log n).
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include "rta_Framework_private.h"
+#include "rta_Timer.h"
+
+#define INITIAL_QUEUE_CAPACITY 64
+
+struct rta_timer {
+    RtaFramework *framework;
+    RtaTimerCallback *callback;
+    void *user_data;
+    bool persist;
+
+    // the real clock
+    PARCEventTimer *eventTimer;
+    bool eventPending;
+
+    // the virtual clock, queue is non-null while the timer is in the queue
+    RtaTimerQueue *queue;
+    size_t queueIndex;
+    uint64_t expiryUsec;
+    uint64_t periodUsec;
+    uint64_t sequence;
+};
+
+struct rta_timer_queue {
+    RtaTimer **heap;
+    size_t length;
+    size_t capacity;
+    uint64_t nextSequence;
+};
+
+// ==================
+// Virtual timer queue
+
+static bool
+_rtaTimerQueue_Before(const RtaTimer *a, const RtaTimer *b)
+{
+    if (a->expiryUsec != b->expiryUsec) {
+        return a->expiryUsec < b->expiryUsec;
+    }
+    return a->sequence < b->sequence;
+}
+
+static void
+_rtaTimerQueue_Set(RtaTimerQueue *queue, size_t index, RtaTimer *timer)
+{
+    queue->heap[index] = timer;
+    timer->queueIndex = index;
+}
+
+static void
+_rtaTimerQueue_SiftUp(RtaTimerQueue *queue, size_t index)
+{
+    RtaTimer *timer = queue->heap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!_rtaTimerQueue_Before(timer, queue->heap[parent])) {
+            break;
+        }
+        _rtaTimerQueue_Set(queue, index, queue->heap[parent]);
+        index = parent;
+    }
+    _rtaTimerQueue_Set(queue, index, timer);
+}
+
+static void
+_rtaTimerQueue_SiftDown(RtaTimerQueue *queue, size_t index)
+{
+    RtaTimer *timer = queue->heap[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= queue->length) {
+            break;
+        }
+        if (child + 1 < queue->length && _rtaTimerQueue_Before(queue->heap[child + 1], queue->heap[child])) {
+            child++;
+        }
+        if (!_rtaTimerQueue_Before(queue->heap[child], timer)) {
+            break;
+        }
+        _rtaTimerQueue_Set(queue, index, queue->heap[child]);
+        index = child;
+    }
+    _rtaTimerQueue_Set(queue, index, timer);
+}
+
+static void
+_rtaTimerQueue_Insert(RtaTimerQueue *queue, RtaTimer *timer)
+{
+    if (queue->length == queue->capacity) {
+        size_t capacity = queue->capacity * 2;
+        RtaTimer **heap = parcMemory_Allocate(capacity * sizeof(RtaTimer *));
+        assertNotNull(heap, "parcMemory_Allocate(%zu) returned NULL", capacity * sizeof(RtaTimer *));
+        memcpy(heap, queue->heap, queue->length * sizeof(RtaTimer *));
+        parcMemory_Deallocate((void **) &queue->heap);
+        queue->heap = heap;
+        queue->capacity = capacity;
+    }
+
+    timer->sequence = queue->nextSequence++;
+    timer->queue = queue;
+    _rtaTimerQueue_Set(queue, queue->length, timer);
+    queue->length++;
+    _rtaTimerQueue_SiftUp(queue, timer->queueIndex);
+}
+
+static void
+_rtaTimerQueue_Remove(RtaTimerQueue *queue, RtaTimer *timer)
+{
+    size_t index = timer->queueIndex;
+    assertTrue(index < queue->length && queue->heap[index] == timer, "Timer %p is not at its queue index %zu", (void *) timer, index);
+
+    queue->length--;
+    if (index < queue->length) {
+        // the last timer fills the hole, then moves whichever way restores the heap
+        RtaTimer *moved = queue->heap[queue->length];
+        _rtaTimerQueue_Set(queue, index, moved);
+        _rtaTimerQueue_SiftDown(queue, index);
+        _rtaTimerQueue_SiftUp(queue, moved->queueIndex);
+    }
+
+    timer->queue = NULL;
+}
+
+RtaTimerQueue *
+rtaTimerQueue_Create(void)
+{
+    RtaTimerQueue *queue = parcMemory_AllocateAndClear(sizeof(RtaTimerQueue));
+    assertNotNull(queue, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaTimerQueue));
+
+    queue->capacity = INITIAL_QUEUE_CAPACITY;
+    queue->heap = parcMemory_Allocate(queue->capacity * sizeof(RtaTimer *));
+    assertNotNull(queue->heap, "parcMemory_Allocate(%zu) returned NULL", queue->capacity * sizeof(RtaTimer *));
+    return queue;
+}
+
+void
+rtaTimerQueue_Destroy(RtaTimerQueue **queuePtr)
+{
+    assertNotNull(queuePtr, "Parameter queuePtr must be non-null");
+    assertNotNull(*queuePtr, "Parameter queuePtr must dereference to non-null");
+
+    RtaTimerQueue *queue = *queuePtr;
+    assertTrue(queue->length == 0, "Destroying a timer queue with %zu pending timers", queue->length);
+
+    parcMemory_Deallocate((void **) &queue->heap);
+    parcMemory_Deallocate((void **) &queue);
+    *queuePtr = NULL;
+}
+
+size_t
+rtaTimerQueue_Size(const RtaTimerQueue *queue)
+{
+    return queue->length;
+}
+
+bool
+rtaTimerQueue_NextExpiry(const RtaTimerQueue *queue, uint64_t *expiryUsec)
+{
+    if (queue->length == 0) {
+        return false;
+    }
+    *expiryUsec = queue->heap[0]->expiryUsec;
+    return true;
+}
+
+bool
+rtaTimerQueue_FireNext(RtaTimerQueue *queue)
+{
+    if (queue->length == 0) {
+        return false;
+    }
+
+    RtaTimer *timer = queue->heap[0];
+    _rtaTimerQueue_Remove(queue, timer);
+
+    if (timer->persist) {
+        timer->expiryUsec += timer->periodUsec;
+        _rtaTimerQueue_Insert(queue, timer);
+    }
+
+    // The callback may stop, restart or destroy the timer, so do not touch it afterwards
+    timer->callback(-1, PARCEventType_Timeout, timer->user_data);
+    return true;
+}
+
+// ==================
+// Timers
+
+static void
+_rtaTimer_EventCallback(int fd, PARCEventType what, void *user_data)
+{
+    RtaTimer *timer = user_data;
+    if (!timer->persist) {
+        timer->eventPending = false;
+    }
+    timer->callback(fd, what, timer->user_data);
+}
+
+RtaTimer *
+rtaTimer_Create(RtaFramework *framework, PARCEventType flags, RtaTimerCallback *callback, void *user_data)
+{
+    assertNotNull(framework, "Parameter framework must be non-null");
+    assertNotNull(callback, "Parameter callback must be non-null");
+
+    RtaTimer *timer = parcMemory_AllocateAndClear(sizeof(RtaTimer));
+    assertNotNull(timer, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaTimer));
+
+    timer->framework = framework;
+    timer->callback = callback;
+    timer->user_data = user_data;
+    timer->persist = (flags & PARCEventType_Persist) != 0;
+    timer->eventTimer = parcEventTimer_Create(framework->base, flags, _rtaTimer_EventCallback, timer);
+    return timer;
+}
+
+void
+rtaTimer_Destroy(RtaTimer **timerPtr)
+{
+    assertNotNull(timerPtr, "Parameter timerPtr must be non-null");
+    assertNotNull(*timerPtr, "Parameter timerPtr must dereference to non-null");
+
+    RtaTimer *timer = *timerPtr;
+    rtaTimer_Stop(timer);
+    parcEventTimer_Destroy(&timer->eventTimer);
+    parcMemory_Deallocate((void **) &timer);
+    *timerPtr = NULL;
+}
+
+void
+rtaTimer_Start(RtaTimer *timer, const struct timeval *timeout)
+{
+    assertNotNull(timer, "Parameter timer must be non-null");
+    assertNotNull(timeout, "Parameter timeout must be non-null");
+
+    RtaFramework *framework = timer->framework;
+    if (framework->virtualClock) {
+        if (timer->queue != NULL) {
+            _rtaTimerQueue_Remove(timer->queue, timer);
+        }
+
+        timer->periodUsec = (uint64_t) timeout->tv_sec * 1000000 + timeout->tv_usec;
+        assertFalse(timer->persist && timer->periodUsec == 0, "A persistent virtual timer needs a non-zero period");
+
+        timer->expiryUsec = framework->virtualNowUsec + timer->periodUsec;
+        _rtaTimerQueue_Insert(framework->virtualTimers, timer);
+    } else {
+        struct timeval copy = *timeout;
+        parcEventTimer_Start(timer->eventTimer, &copy);
+        timer->eventPending = true;
+    }
+}
+
+void
+rtaTimer_Stop(RtaTimer *timer)
+{
+    assertNotNull(timer, "Parameter timer must be non-null");
+
+    if (timer->queue != NULL) {
+        _rtaTimerQueue_Remove(timer->queue, timer);
+    }
+
+    if (timer->eventPending) {
+        parcEventTimer_Stop(timer->eventTimer);
+        timer->eventPending = false;
+    }
+}
+
+bool
+rtaTimer_IsPending(const RtaTimer *timer)
+{
+    assertNotNull(timer, "Parameter timer must be non-null");
+    return timer->queue != NULL || timer->eventPending;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_Timer.h
+ * @brief Timers for components and connectors, on the real or the virtual clock
+ *
+ * A component that needs a timeout creates an `RtaTimer` instead of a `PARCEventTimer`.
+ * Normally the timer is a `PARCEventTimer` on the framework's event scheduler.  When the
+ * framework runs on a virtual clock (see `rtaFramework_NonThreadedUseVirtualClock()`), the
+ * timer goes in the framework's virtual timer queue instead, and it fires when the non-threaded
+ * step functions move virtual time past its expiry.
+ *
+ * Virtual timers fire in order of expiry.  Timers with the same expiry fire in the order they
+ * were started, so a simulation fires the same timers in the same order on every run.
+ *
+ * The callback has the same signature as a `PARCEventTimer` callback.  It is called with a
+ * file descriptor of -1 and `PARCEventType_Timeout`.
+ *
+ * @code
+ * {
+ *     RtaTimer *timer = rtaTimer_Create(rtaConnection_GetFramework(conn), 0, myTimeout, state);
+ *     struct timeval timeout = { .tv_sec = 0, .tv_usec = 5000 };
+ *     rtaTimer_Start(timer, &timeout);
+ *     ...
+ *     rtaTimer_Destroy(&timer);
+ * }
+ * @endcode
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_rta_Timer_h
+#define Libccnx_rta_Timer_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <parc/algol/parc_Event.h>
+
+#include <ccnx/transport/transport_rta/core/rta_Framework.h>
+
+struct rta_timer;
+typedef struct rta_timer RtaTimer;
+
+typedef void (RtaTimerCallback)(int fd, PARCEventType type, void *user_data);
+
+/**
+ * Creates a stopped timer
+ *
+ * @param [in] framework The framework whose clock drives the timer
+ * @param [in] flags 0 for a one-shot timer, PARCEventType_Persist to fire every timeout
+ * @param [in] callback Called when the timer fires
+ * @param [in] user_data Passed to the callback
+ *
+ * @return non-null An allocated timer
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaTimer *timer = rtaTimer_Create(framework, PARCEventType_Persist, tickCallback, state);
+ * }
+ * @endcode
+ */
+RtaTimer *rtaTimer_Create(RtaFramework *framework, PARCEventType flags, RtaTimerCallback *callback, void *user_data);
+
+/**
+ * Stops and destroys the timer
+ *
+ * @param [in,out] timerPtr The timer, NULL'd on return
+ */
+void rtaTimer_Destroy(RtaTimer **timerPtr);
+
+/**
+ * Starts the timer, or restarts it if it is already pending
+ *
+ * @param [in] timer The timer
+ * @param [in] timeout How long from now the timer fires, and its period if it is persistent.
+ *                     A persistent timer on the virtual clock must have a non-zero timeout.
+ */
+void rtaTimer_Start(RtaTimer *timer, const struct timeval *timeout);
+
+/**
+ * Stops the timer.  It is not an error to stop a stopped timer.
+ *
+ * @param [in] timer The timer
+ */
+void rtaTimer_Stop(RtaTimer *timer);
+
+/**
+ * Determines if the timer is started and has not fired yet
+ *
+ * A persistent timer stays pending until it is stopped.
+ *
+ * @param [in] timer The timer
+ *
+ * @return true The timer will fire
+ * @return false The timer is stopped
+ */
+bool rtaTimer_IsPending(const RtaTimer *timer);
+
+// ==================
+// The virtual timer queue, used by the framework
+
+struct rta_timer_queue;
+typedef struct rta_timer_queue RtaTimerQueue;
+
+/**
+ * Creates an empty virtual timer queue
+ */
+RtaTimerQueue *rtaTimerQueue_Create(void);
+
+/**
+ * Destroys the queue.  All its timers must be stopped.
+ */
+void rtaTimerQueue_Destroy(RtaTimerQueue **queuePtr);
+
+/**
+ * The number of pending timers
+ */
+size_t rtaTimerQueue_Size(const RtaTimerQueue *queue);
+
+/**
+ * The expiry of the first timer to fire
+ *
+ * @param [in] queue The queue
+ * @param [out] expiryUsec The virtual time the timer fires, in microseconds
+ *
+ * @return true There is a pending timer
+ * @return false The queue is empty, `expiryUsec` is not changed
+ */
+bool rtaTimerQueue_NextExpiry(const RtaTimerQueue *queue, uint64_t *expiryUsec);
+
+/**
+ * Fires the first timer in the queue
+ *
+ * Removes the timer (re-inserts it one period later if it is persistent) and calls its callback.
+ * The caller sets the virtual time to the timer's expiry first.
+ *
+ * @param [in] queue The queue
+ *
+ * @return true A timer fired
+ * @return false The queue is empty
+ */
+bool rtaTimerQueue_FireNext(RtaTimerQueue *queue);
+#endif // Libccnx_rta_Timer_h
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/queue.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_Event.h>
+#include <parc/concurrent/parc_Notifier.h>
+
+#include "rta_WorkerPool.h"
+
+#ifndef DEBUG_OUTPUT
+#define DEBUG_OUTPUT 0
+#endif
+
+typedef struct rta_worker_job {
+    RtaWorkerPoolWorkFunction *workFunction;
+    void *job;
+    TAILQ_ENTRY(rta_worker_job) list;
+} RtaWorkerJob;
+
+TAILQ_HEAD(rta_worker_job_list, rta_worker_job);
+
+struct rta_worker_pool {
+    RtaWorkerPoolDoneFunction *doneFunction;
+    void *doneContext;
+
+    unsigned workerCount;
+    pthread_t *workers;
+
+    // protects everything below, down to the notifier
+    pthread_mutex_t lock;
+    pthread_cond_t haveWork;
+    bool shutdown;
+    size_t pendingCount;
+
+    // waiting for a worker
+    struct rta_worker_job_list pending;
+
+    // finished, waiting for the RTA thread
+    struct rta_worker_job_list done;
+
+    // the workers wake up the RTA thread through the notifier
+    PARCNotifier *notifier;
+    PARCEvent *doneEvent;
+
+    // only used on the RTA thread
+    size_t outstandingCount;
+    RtaWorkerPoolStats stats;
+};
+
+// ==================
+
+static void
+_rtaWorkerPool_Lock(RtaWorkerPool *pool)
+{
+    int res = pthread_mutex_lock(&pool->lock);
+    assertTrue(res == 0, "error from pthread_mutex_lock: %d", res);
+}
+
+static void
+_rtaWorkerPool_Unlock(RtaWorkerPool *pool)
+{
+    int res = pthread_mutex_unlock(&pool->lock);
+    assertTrue(res == 0, "error from pthread_mutex_unlock: %d", res);
+}
+
+/**
+ * Put a finished job on the done list and wake up the RTA thread.
+ * The caller must hold the lock.  The notifier only writes to its socket if
+ * the RTA thread has not been woken up yet, so this is cheap.
+ */
+static void
+_rtaWorkerPool_Finished(RtaWorkerPool *pool, RtaWorkerJob *entry)
+{
+    TAILQ_INSERT_TAIL(&pool->done, entry, list);
+    parcNotifier_Notify(pool->notifier);
+}
+
+static void *
+_rtaWorkerPool_Worker(void *arg)
+{
+    RtaWorkerPool *pool = (RtaWorkerPool *) arg;
+
+    _rtaWorkerPool_Lock(pool);
+    while (true) {
+        while (!pool->shutdown && TAILQ_EMPTY(&pool->pending)) {
+            pthread_cond_wait(&pool->haveWork, &pool->lock);
+        }
+
+        if (pool->shutdown) {
+            break;
+        }
+
+        RtaWorkerJob *entry = TAILQ_FIRST(&pool->pending);
+        TAILQ_REMOVE(&pool->pending, entry, list);
+        pool->pendingCount--;
+        _rtaWorkerPool_Unlock(pool);
+
+        entry->workFunction(entry->job);
+
+        _rtaWorkerPool_Lock(pool);
+        _rtaWorkerPool_Finished(pool, entry);
+    }
+    _rtaWorkerPool_Unlock(pool);
+
+    return NULL;
+}
+
+/**
+ * Hand every finished job back to its owner.  Must run on the RTA thread.
+ */
+static void
+_rtaWorkerPool_DrainDone(RtaWorkerPool *pool)
+{
+    struct rta_worker_job_list finished;
+    TAILQ_INIT(&finished);
+
+    _rtaWorkerPool_Lock(pool);
+    TAILQ_CONCAT(&finished, &pool->done, list);
+    _rtaWorkerPool_Unlock(pool);
+
+    RtaWorkerJob *entry;
+    while ((entry = TAILQ_FIRST(&finished)) != NULL) {
+        TAILQ_REMOVE(&finished, entry, list);
+        pool->outstandingCount--;
+        pool->stats.completed++;
+
+        void *job = entry->job;
+        parcMemory_Deallocate((void **) &entry);
+        pool->doneFunction(job, pool->doneContext);
+    }
+}
+
+static void
+_rtaWorkerPool_DoneCallback(int fd, PARCEventType what, void *user_data)
+{
+    RtaWorkerPool *pool = (RtaWorkerPool *) user_data;
+    bool more;
+
+    do {
+        // flag the notifier that we are starting a batch of reads
+        parcNotifier_PauseEvents(pool->notifier);
+
+        _rtaWorkerPool_DrainDone(pool);
+
+        // resume notifications
+        parcNotifier_StartEvents(pool->notifier);
+
+        // A worker that finished between the drain and the resume could not notify
+        _rtaWorkerPool_Lock(pool);
+        more = !TAILQ_EMPTY(&pool->done);
+        _rtaWorkerPool_Unlock(pool);
+    } while (more);
+}
+
+// ==================
+
+RtaWorkerPool *
+rtaWorkerPool_Create(PARCEventScheduler *scheduler, unsigned workerCount,
+                     RtaWorkerPoolDoneFunction *doneFunction, void *doneContext)
+{
+    assertNotNull(scheduler, "Parameter scheduler must be non-null");
+    assertNotNull(doneFunction, "Parameter doneFunction must be non-null");
+
+    RtaWorkerPool *pool = parcMemory_AllocateAndClear(sizeof(RtaWorkerPool));
+    assertNotNull(pool, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaWorkerPool));
+
+    pool->doneFunction = doneFunction;
+    pool->doneContext = doneContext;
+    pool->workerCount = workerCount;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->haveWork, NULL);
+    TAILQ_INIT(&pool->pending);
+    TAILQ_INIT(&pool->done);
+
+    pool->notifier = parcNotifier_Create();
+    int fd = parcNotifier_Socket(pool->notifier);
+
+    int flags = fcntl(fd, F_GETFL, NULL);
+    assertFalse(flags == -1, "fcntl failed to obtain file descriptor flags (%d)", errno);
+    int res = fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    assertTrue(res == 0, "%s failed to set socket non-blocking: %s", __func__, strerror(errno));
+
+    pool->doneEvent = parcEvent_Create(scheduler, fd, PARCEventType_Read | PARCEventType_Persist, _rtaWorkerPool_DoneCallback, (void *) pool);
+    parcEvent_Start(pool->doneEvent);
+
+    if (workerCount > 0) {
+        pool->workers = parcMemory_AllocateAndClear(workerCount * sizeof(pthread_t));
+        assertNotNull(pool->workers, "parcMemory_AllocateAndClear(%zu) returned NULL", workerCount * sizeof(pthread_t));
+
+        for (unsigned i = 0; i < workerCount; i++) {
+            res = pthread_create(&pool->workers[i], NULL, _rtaWorkerPool_Worker, (void *) pool);
+            assertTrue(res == 0, "error from pthread_create: %d", res);
+        }
+    }
+
+    if (DEBUG_OUTPUT) {
+        printf("%s pool %p workers %u\n", __func__, (void *) pool, workerCount);
+    }
+
+    return pool;
+}
+
+void
+rtaWorkerPool_Destroy(RtaWorkerPool **poolPtr)
+{
+    assertNotNull(poolPtr, "Parameter poolPtr must be non-null");
+    RtaWorkerPool *pool = *poolPtr;
+    assertNotNull(pool, "Parameter poolPtr must dereference to non-null");
+
+    _rtaWorkerPool_Lock(pool);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->haveWork);
+    _rtaWorkerPool_Unlock(pool);
+
+    for (unsigned i = 0; i < pool->workerCount; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    // The workers are gone, so we can finish the rest without the lock
+    RtaWorkerJob *entry;
+    while ((entry = TAILQ_FIRST(&pool->pending)) != NULL) {
+        TAILQ_REMOVE(&pool->pending, entry, list);
+        entry->workFunction(entry->job);
+        TAILQ_INSERT_TAIL(&pool->done, entry, list);
+    }
+    pool->pendingCount = 0;
+
+    _rtaWorkerPool_DrainDone(pool);
+
+    parcEvent_Stop(pool->doneEvent);
+    parcEvent_Destroy(&pool->doneEvent);
+    parcNotifier_Release(&pool->notifier);
+
+    pthread_cond_destroy(&pool->haveWork);
+    pthread_mutex_destroy(&pool->lock);
+
+    if (pool->workers) {
+        parcMemory_Deallocate((void **) &pool->workers);
+    }
+    parcMemory_Deallocate((void **) &pool);
+    *poolPtr = NULL;
+}
+
+void
+rtaWorkerPool_Submit(RtaWorkerPool *pool, RtaWorkerPoolWorkFunction *workFunction, void *job)
+{
+    assertNotNull(pool, "Parameter pool must be non-null");
+    assertNotNull(workFunction, "Parameter workFunction must be non-null");
+
+    RtaWorkerJob *entry = parcMemory_AllocateAndClear(sizeof(RtaWorkerJob));
+    assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(RtaWorkerJob));
+    entry->workFunction = workFunction;
+    entry->job = job;
+
+    pool->outstandingCount++;
+    pool->stats.submitted++;
+
+    if (pool->workerCount == 0) {
+        workFunction(job);
+
+        _rtaWorkerPool_Lock(pool);
+        _rtaWorkerPool_Finished(pool, entry);
+        _rtaWorkerPool_Unlock(pool);
+        return;
+    }
+
+    _rtaWorkerPool_Lock(pool);
+    TAILQ_INSERT_TAIL(&pool->pending, entry, list);
+    pool->pendingCount++;
+    if (pool->pendingCount > pool->stats.maxDepth) {
+        pool->stats.maxDepth = pool->pendingCount;
+    }
+    pthread_cond_signal(&pool->haveWork);
+    _rtaWorkerPool_Unlock(pool);
+}
+
+size_t
+rtaWorkerPool_GetOutstandingCount(const RtaWorkerPool *pool)
+{
+    assertNotNull(pool, "Parameter pool must be non-null");
+    return pool->outstandingCount;
+}
+
+unsigned
+rtaWorkerPool_GetWorkerCount(const RtaWorkerPool *pool)
+{
+    assertNotNull(pool, "Parameter pool must be non-null");
+    return pool->workerCount;
+}
+
+const RtaWorkerPoolStats *
+rtaWorkerPool_GetStats(const RtaWorkerPool *pool)
+{
+    assertNotNull(pool, "Parameter pool must be non-null");
+    return &pool->stats;
+}
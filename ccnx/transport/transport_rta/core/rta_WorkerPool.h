@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @file rta_WorkerPool.h
+ * @brief A small pool of threads that runs expensive work off the RTA thread
+ *
+ * Components that need to do CPU-heavy work (signature verification, signing,
+ * decoding) submit jobs to a worker pool.  A job's work function runs on one of the
+ * worker threads.  When it finishes, the job is handed back to the RTA thread, where the
+ * pool calls its done function from the event scheduler.  The done function is the only
+ * place a component should touch its own state or the stack's queues.
+ *
+ * Jobs may complete out of submission order.  A component that must preserve ordering
+ * keeps its own queue and releases messages in order from the done function.
+ *
+ * A pool with zero workers runs the work function inline in `rtaWorkerPool_Submit()`, but
+ * still calls the done function later from the event scheduler, so a component sees the
+ * same sequence of calls either way.
+ *
+ * The work function must not use the event scheduler, the protocol stack, or any
+ * connection.  Only the job itself is shared with the worker thread.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+#ifndef Libccnx_rta_WorkerPool_h
+#define Libccnx_rta_WorkerPool_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <parc/algol/parc_EventScheduler.h>
+
+struct rta_worker_pool;
+typedef struct rta_worker_pool RtaWorkerPool;
+
+/**
+ * Runs on a worker thread
+ */
+typedef void (RtaWorkerPoolWorkFunction)(void *job);
+
+/**
+ * Runs on the RTA thread after the work function finished
+ */
+typedef void (RtaWorkerPoolDoneFunction)(void *job, void *doneContext);
+
+/**
+ * Counters kept by the pool.  They are cumulative over the life of the pool.
+ */
+typedef struct rta_worker_pool_stats {
+    uint64_t submitted;     // number of calls to rtaWorkerPool_Submit
+    uint64_t completed;     // number of calls to the done function
+    uint64_t maxDepth;      // the most jobs ever waiting for a worker
+} RtaWorkerPoolStats;
+
+/**
+ * Create a worker pool and start its threads
+ *
+ * @param [in] scheduler The event scheduler of the RTA thread, used to run the done function
+ * @param [in] workerCount The number of worker threads, 0 runs the work inline
+ * @param [in] doneFunction Called on the RTA thread for each finished job
+ * @param [in] doneContext Passed to every call of the done function
+ *
+ * @return non-null An allocated pool, destroy with `rtaWorkerPool_Destroy()`
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaWorkerPool *pool = rtaWorkerPool_Create(rtaFramework_GetEventScheduler(framework), 2, _myDone, state);
+ *     rtaWorkerPool_Submit(pool, _myWork, job);
+ *     ...
+ *     rtaWorkerPool_Destroy(&pool);
+ * }
+ * @endcode
+ */
+RtaWorkerPool *rtaWorkerPool_Create(PARCEventScheduler *scheduler, unsigned workerCount,
+                                    RtaWorkerPoolDoneFunction *doneFunction, void *doneContext);
+
+/**
+ * Stops the worker threads and destroys the pool
+ *
+ * Every outstanding job is finished before this returns: jobs still waiting for a worker
+ * are run on the calling thread, and the done function is called for every job that has
+ * not yet been handed back.
+ *
+ * @param [in,out] poolPtr Pointer to the pool, will be NULL'd
+ */
+void rtaWorkerPool_Destroy(RtaWorkerPool **poolPtr);
+
+/**
+ * Queue a job for a worker thread
+ *
+ * @param [in] pool The worker pool
+ * @param [in] workFunction Runs on a worker thread with `job` as its argument
+ * @param [in] job The caller's job, passed to the work and done functions
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void rtaWorkerPool_Submit(RtaWorkerPool *pool, RtaWorkerPoolWorkFunction *workFunction, void *job);
+
+/**
+ * The number of jobs submitted whose done function has not been called yet
+ */
+size_t rtaWorkerPool_GetOutstandingCount(const RtaWorkerPool *pool);
+
+/**
+ * The number of worker threads
+ */
+unsigned rtaWorkerPool_GetWorkerCount(const RtaWorkerPool *pool);
+
+/**
+ * Returns the cumulative counters of the pool.  Do not free it.
+ */
+const RtaWorkerPoolStats *rtaWorkerPool_GetStats(const RtaWorkerPool *pool);
+#endif // Libccnx_rta_WorkerPool_h
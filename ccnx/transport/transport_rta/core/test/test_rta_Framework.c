@@ -94,6 +94,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, rtaFramework_GetNextConnectionId);
     LONGBOW_RUN_TEST_CASE(Global, rtaFramework_GetStatus);
     LONGBOW_RUN_TEST_CASE(Global, rtaFramework_Start_Shutdown);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFramework_Start_Shutdown_Repeated);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFramework_SetThreadConfig);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFramework_GetThreadStats);
     LONGBOW_RUN_TEST_CASE(Global, tick_cb);
 }
 
@@ -153,6 +156,67 @@ LONGBOW_TEST_CASE(Global, rtaFramework_Start_Shutdown)
     rtaFramework_Shutdown(data->framework);
 }
 
+LONGBOW_TEST_CASE(Global, rtaFramework_Start_Shutdown_Repeated)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // the fixture's framework is unused here
+    for (int i = 0; i < 20; i++) {
+        RtaFramework *framework = rtaFramework_Create(data->commandRingBuffer, data->commandNotifier);
+
+        // Start returns once the thread is running, Shutdown once it has left its event loop
+        rtaFramework_Start(framework);
+        assertTrue(rtaFramework_GetStatus(framework) == FRAMEWORK_RUNNING, "Iteration %d: expected RUNNING got %d",
+                   i, rtaFramework_GetStatus(framework));
+
+        rtaFramework_Shutdown(framework);
+        assertTrue(rtaFramework_GetStatus(framework) == FRAMEWORK_SHUTDOWN, "Iteration %d: expected SHUTDOWN got %d",
+                   i, rtaFramework_GetStatus(framework));
+
+        rtaFramework_Destroy(&framework);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, rtaFramework_SetThreadConfig)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpu(config, 3);
+    rtaFrameworkConfig_SetRealtimePriority(config, 7);
+    rtaFramework_SetThreadConfig(data->framework, config);
+    rtaFrameworkConfig_Destroy(&config);
+
+    const RtaFrameworkConfig *test = rtaFramework_GetThreadConfig(data->framework);
+    assertTrue(rtaFrameworkConfig_HasCpu(test, 3), "Framework config lost cpu 3");
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(test) == 7, "Framework config lost the priority");
+}
+
+LONGBOW_TEST_CASE(Global, rtaFramework_GetThreadStats)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaFrameworkThreadStats stats;
+
+    assertFalse(rtaFramework_GetThreadStats(data->framework, &stats), "Stats should not be available before start");
+
+    rtaFramework_Start(data->framework);
+    rtaFramework_WaitForStatus(data->framework, FRAMEWORK_RUNNING);
+
+#if defined(__linux__)
+    // the framework thread wakes up on its millisecond tick, so it blocks voluntarily
+    usleep(20000);
+    bool success = rtaFramework_GetThreadStats(data->framework, &stats);
+    assertTrue(success, "Could not read the framework thread stats");
+    assertTrue(stats.voluntaryContextSwitches > 0, "Expected voluntary context switches");
+    assertTrue(stats.cpu >= 0, "Expected a cpu, got %d", stats.cpu);
+#else
+    assertFalse(rtaFramework_GetThreadStats(data->framework, &stats), "Stats are only supported on Linux");
+#endif
+
+    rtaFramework_Shutdown(data->framework);
+    assertFalse(rtaFramework_GetThreadStats(data->framework, &stats), "Stats should not be available after shutdown");
+}
+
 LONGBOW_TEST_CASE(Global, tick_cb)
 {
     ticks tic0, tic1;
@@ -186,6 +250,9 @@ LONGBOW_TEST_CASE(Global, tick_cb)
 
 LONGBOW_TEST_FIXTURE(Local)
 {
+    LONGBOW_RUN_TEST_CASE(Local, rta_Framework_TransitionStatus);
+    LONGBOW_RUN_TEST_CASE(Local, rta_Framework_WaitStatus_Reached);
+    LONGBOW_RUN_TEST_CASE(Local, rta_Framework_WaitStatus_Wakeup);
     LONGBOW_RUN_TEST_CASE(Local, _setLogLevels_All);
     LONGBOW_RUN_TEST_CASE(Local, _setLogLevels_All_Framework);
     LONGBOW_RUN_TEST_CASE(Local, _setLogLevels_Framework);
@@ -213,6 +280,54 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+LONGBOW_TEST_CASE(Local, rta_Framework_TransitionStatus)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    assertTrue(rta_Framework_TransitionStatus(data->framework, FRAMEWORK_INIT, FRAMEWORK_SETUP), "INIT to SETUP should succeed");
+    assertFalse(rta_Framework_TransitionStatus(data->framework, FRAMEWORK_INIT, FRAMEWORK_STARTING), "Transition from a stale status should fail");
+    assertTrue(rta_Framework_LoadStatus(data->framework) == FRAMEWORK_SETUP, "Failed transition changed the status");
+
+    assertTrue(rta_Framework_TransitionStatus(data->framework, FRAMEWORK_SETUP, FRAMEWORK_TEARDOWN), "SETUP to TEARDOWN should succeed");
+}
+
+LONGBOW_TEST_CASE(Local, rta_Framework_WaitStatus_Reached)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    rta_Framework_StoreStatus(data->framework, FRAMEWORK_TEARDOWN);
+
+    // already past SETUP, so this must not block
+    RtaFrameworkStatus status = rta_Framework_WaitStatus(data->framework, FRAMEWORK_SETUP);
+    assertTrue(status == FRAMEWORK_TEARDOWN, "Expected TEARDOWN got %d", status);
+    assertTrue(data->framework->statusWaiters == 0, "Waiter count not restored, got %u", data->framework->statusWaiters);
+}
+
+static void *
+_waitForTeardown(void *arg)
+{
+    RtaFramework *framework = (RtaFramework *) arg;
+    rta_Framework_WaitStatus(framework, FRAMEWORK_TEARDOWN);
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Local, rta_Framework_WaitStatus_Wakeup)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    pthread_t waiter;
+    pthread_create(&waiter, NULL, _waitForTeardown, data->framework);
+
+    // give the waiter a chance to sleep, then walk it through an intermediate status
+    usleep(10000);
+    rta_Framework_TransitionStatus(data->framework, FRAMEWORK_INIT, FRAMEWORK_SETUP);
+    usleep(10000);
+    rta_Framework_TransitionStatus(data->framework, FRAMEWORK_SETUP, FRAMEWORK_TEARDOWN);
+
+    pthread_join(waiter, NULL);
+    assertTrue(data->framework->statusWaiters == 0, "Waiter count not restored, got %u", data->framework->statusWaiters);
+}
+
 LONGBOW_TEST_CASE(Local, _setLogLevels_All)
 {
     TestData *data = longBowTestCase_GetClipBoardData(testCase);
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_FrameworkConfig.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+#include <unistd.h>
+
+LONGBOW_TEST_RUNNER(rta_FrameworkConfig)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_FrameworkConfig)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_FrameworkConfig)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ===================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_Create);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_AddCpu);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_AddCpuList);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_AddCpuList_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_Copy);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment_Invalid);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment_InvalidCpuList);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_ApplyToCurrentThread_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFrameworkConfig_ApplyToCurrentThread_Affinity);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static RtaLogger *
+_createLogger(void)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    RtaLogger *logger = rtaLogger_Create(reporter, parcClock_Monotonic());
+    parcLogReporter_Release(&reporter);
+    return logger;
+}
+
+static unsigned _warningCount;
+
+static PARCLogReporter *
+_countingReporter_Acquire(const PARCLogReporter *reporter)
+{
+    return parcObject_Acquire(reporter);
+}
+
+static void
+_countingReporter_Release(PARCLogReporter **reporterPtr)
+{
+    parcObject_Release((void **) reporterPtr);
+}
+
+static void
+_countingReporter_Report(PARCLogReporter *reporter, const PARCLogEntry *entry)
+{
+    if (parcLogEntry_GetLevel(entry) == PARCLogLevel_Warning) {
+        _warningCount++;
+    }
+}
+
+/**
+ * A logger that counts the warnings on the Framework facility in _warningCount
+ */
+static RtaLogger *
+_createCountingLogger(void)
+{
+    _warningCount = 0;
+    PARCLogReporter *reporter = parcLogReporter_Create(_countingReporter_Acquire, _countingReporter_Release,
+                                                       _countingReporter_Report, NULL);
+    RtaLogger *logger = rtaLogger_Create(reporter, parcClock_Monotonic());
+    parcLogReporter_Release(&reporter);
+    rtaLogger_SetLogLevel(logger, RtaLoggerFacility_Framework, PARCLogLevel_Warning);
+    return logger;
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_Create)
+{
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 0, "New config should have no affinity");
+    assertTrue(rtaFrameworkConfig_GetNumaNode(config) == -1, "New config should have no NUMA node");
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(config) == 0, "New config should use normal scheduling");
+    rtaFrameworkConfig_Destroy(&config);
+    assertNull(config, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_AddCpu)
+{
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpu(config, 0);
+    rtaFrameworkConfig_AddCpu(config, 65);
+    rtaFrameworkConfig_AddCpu(config, 65);
+
+    assertTrue(rtaFrameworkConfig_HasCpu(config, 0), "Missing cpu 0");
+    assertTrue(rtaFrameworkConfig_HasCpu(config, 65), "Missing cpu 65");
+    assertFalse(rtaFrameworkConfig_HasCpu(config, 1), "Unexpected cpu 1");
+    assertFalse(rtaFrameworkConfig_HasCpu(config, RTA_FRAMEWORK_CONFIG_MAX_CPUS), "Out of range cpu should not be set");
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 2, "Expected 2 cpus, got %u", rtaFrameworkConfig_GetCpuCount(config));
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_AddCpuList)
+{
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    bool success = rtaFrameworkConfig_AddCpuList(config, "0-3,8,10-11\n");
+    assertTrue(success, "Valid list did not parse");
+
+    unsigned expected[] = { 0, 1, 2, 3, 8, 10, 11 };
+    for (int i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        assertTrue(rtaFrameworkConfig_HasCpu(config, expected[i]), "Missing cpu %u", expected[i]);
+    }
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 7, "Expected 7 cpus, got %u", rtaFrameworkConfig_GetCpuCount(config));
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_AddCpuList_Invalid)
+{
+    const char *invalid[] = { "", "a", "1,", "3-1", "1-", "1;2", "-1", "99999" };
+
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpu(config, 5);
+    for (int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assertFalse(rtaFrameworkConfig_AddCpuList(config, invalid[i]), "List '%s' should not parse", invalid[i]);
+        assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 1, "List '%s' changed the config", invalid[i]);
+    }
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_Copy)
+{
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpu(config, 7);
+    rtaFrameworkConfig_SetNumaNode(config, 1);
+    rtaFrameworkConfig_SetRealtimePriority(config, 10);
+
+    RtaFrameworkConfig *copy = rtaFrameworkConfig_Copy(config);
+    rtaFrameworkConfig_Destroy(&config);
+
+    assertTrue(rtaFrameworkConfig_HasCpu(copy, 7), "Copy lost cpu 7");
+    assertTrue(rtaFrameworkConfig_GetNumaNode(copy) == 1, "Copy lost the NUMA node");
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(copy) == 10, "Copy lost the priority");
+    rtaFrameworkConfig_Destroy(&copy);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment)
+{
+    setenv(_envCpuAffinity, "2-3", 1);
+    setenv(_envNumaNode, "0", 1);
+    setenv(_envRealtimePriority, "5", 1);
+
+    RtaLogger *logger = _createCountingLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_CreateFromEnvironment(logger);
+    rtaLogger_Release(&logger);
+
+    unsetenv(_envCpuAffinity);
+    unsetenv(_envNumaNode);
+    unsetenv(_envRealtimePriority);
+
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 2, "Expected 2 cpus, got %u", rtaFrameworkConfig_GetCpuCount(config));
+    assertTrue(rtaFrameworkConfig_HasCpu(config, 2) && rtaFrameworkConfig_HasCpu(config, 3), "Wrong cpus");
+    assertTrue(rtaFrameworkConfig_GetNumaNode(config) == 0, "Wrong NUMA node %d", rtaFrameworkConfig_GetNumaNode(config));
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(config) == 5, "Wrong priority %d", rtaFrameworkConfig_GetRealtimePriority(config));
+    assertTrue(_warningCount == 0, "Good values should not warn, got %u warnings", _warningCount);
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment_Invalid)
+{
+    setenv(_envCpuAffinity, "two", 1);
+    setenv(_envNumaNode, "-3", 1);
+    setenv(_envRealtimePriority, "10x", 1);
+
+    RtaLogger *logger = _createCountingLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_CreateFromEnvironment(logger);
+    rtaLogger_Release(&logger);
+
+    unsetenv(_envCpuAffinity);
+    unsetenv(_envNumaNode);
+    unsetenv(_envRealtimePriority);
+
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 0, "Bad affinity should be ignored");
+    assertTrue(rtaFrameworkConfig_GetNumaNode(config) == -1, "Bad NUMA node should be ignored");
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(config) == 0, "Bad priority should be ignored");
+    assertTrue(_warningCount == 3, "Each bad value should be warned about, got %u warnings", _warningCount);
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_CreateFromEnvironment_InvalidCpuList)
+{
+    // a range past the last CPU, the other variables are good
+    setenv(_envCpuAffinity, "0-4096", 1);
+    setenv(_envRealtimePriority, "5", 1);
+
+    RtaLogger *logger = _createCountingLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_CreateFromEnvironment(logger);
+    rtaLogger_Release(&logger);
+
+    unsetenv(_envCpuAffinity);
+    unsetenv(_envRealtimePriority);
+
+    assertTrue(_warningCount == 1, "Expected one warning for the CPU list, got %u", _warningCount);
+    assertTrue(rtaFrameworkConfig_GetCpuCount(config) == 0, "A bad CPU list should leave no affinity");
+    assertTrue(rtaFrameworkConfig_GetRealtimePriority(config) == 5, "The good priority should still be read");
+    rtaFrameworkConfig_Destroy(&config);
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_ApplyToCurrentThread_Empty)
+{
+    RtaLogger *logger = _createLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+
+    assertTrue(rtaFrameworkConfig_ApplyToCurrentThread(config, logger), "An empty config should always apply");
+
+    rtaFrameworkConfig_Destroy(&config);
+    rtaLogger_Release(&logger);
+}
+
+static void *
+_applyAffinityThread(void *arg)
+{
+    RtaFrameworkConfig *config = (RtaFrameworkConfig *) arg;
+    RtaLogger *logger = _createLogger();
+    bool *success = parcMemory_Allocate(sizeof(bool));
+    *success = rtaFrameworkConfig_ApplyToCurrentThread(config, logger);
+    rtaLogger_Release(&logger);
+    return success;
+}
+
+LONGBOW_TEST_CASE(Global, rtaFrameworkConfig_ApplyToCurrentThread_Affinity)
+{
+#if defined(__linux__)
+    // pick a CPU we are allowed to run on, and pin a scratch thread to it
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    assertTrue(sched_getaffinity(0, sizeof(allowed), &allowed) == 0, "sched_getaffinity failed: %s", strerror(errno));
+    unsigned cpu = 0;
+    while (!CPU_ISSET(cpu, &allowed)) {
+        cpu++;
+    }
+
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpu(config, cpu);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, _applyAffinityThread, config);
+    bool *success;
+    pthread_join(thread, (void **) &success);
+
+    assertTrue(*success, "Could not pin a thread to allowed cpu %u", cpu);
+    parcMemory_Deallocate((void **) &success);
+    rtaFrameworkConfig_Destroy(&config);
+#else
+    testSkip("CPU affinity is only supported on Linux");
+#endif
+}
+
+// ===================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _effectiveCpus_NoNode);
+    LONGBOW_RUN_TEST_CASE(Local, _effectiveCpus_MissingNode);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _effectiveCpus_NoNode)
+{
+    RtaLogger *logger = _createLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_AddCpuList(config, "1,4");
+
+    RtaFrameworkConfig effective;
+    memset(&effective, 0, sizeof(effective));
+    assertTrue(_effectiveCpus(config, &effective, logger), "Without a node the affinity set should be used as is");
+    assertTrue(rtaFrameworkConfig_GetCpuCount(&effective) == 2, "Expected 2 cpus, got %u", rtaFrameworkConfig_GetCpuCount(&effective));
+    assertTrue(rtaFrameworkConfig_HasCpu(&effective, 1) && rtaFrameworkConfig_HasCpu(&effective, 4), "Wrong cpus");
+
+    rtaFrameworkConfig_Destroy(&config);
+    rtaLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Local, _effectiveCpus_MissingNode)
+{
+    RtaLogger *logger = _createLogger();
+    RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+    rtaFrameworkConfig_SetNumaNode(config, 100000);
+
+    RtaFrameworkConfig effective;
+    memset(&effective, 0, sizeof(effective));
+    assertFalse(_effectiveCpus(config, &effective, logger), "A node that does not exist should fail");
+
+    rtaFrameworkConfig_Destroy(&config);
+    rtaLogger_Release(&logger);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_FrameworkConfig);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -33,6 +33,7 @@
 
 #include "../rta_Framework_Services.c"
 #include <parc/algol/parc_SafeMemory.h>
+#include <inttypes.h>
 
 #include <LongBow/unit-test.h>
 
@@ -59,6 +60,8 @@ LONGBOW_TEST_RUNNER_TEARDOWN(rta_Framework_Services)
 
 LONGBOW_TEST_FIXTURE(Global)
 {
+    LONGBOW_RUN_TEST_CASE(Global, rtaFramework_MsecToTicks);
+    LONGBOW_RUN_TEST_CASE(Global, rtaFramework_MsecToTicks_Long);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -76,6 +79,23 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
     return LONGBOW_STATUS_SUCCEEDED;
 }
 
+LONGBOW_TEST_CASE(Global, rtaFramework_MsecToTicks)
+{
+    assertTrue(rtaFramework_MsecToTicks(0) == 1, "A short interval should be at least one tick");
+    assertTrue(rtaFramework_MsecToTicks(4000) == rtaFramework_UsecToTicks(4000000), "Should agree with rtaFramework_UsecToTicks");
+}
+
+/**
+ * 5 hours is more microseconds than an unsigned holds, it must not wrap to a short interval
+ */
+LONGBOW_TEST_CASE(Global, rtaFramework_MsecToTicks_Long)
+{
+    uint64_t msec = UINT64_C(5) * 3600 * 1000;
+    ticks expected = msec / FC_MSEC_PER_TICK;
+    ticks actual = rtaFramework_MsecToTicks(msec);
+    assertTrue(actual == expected, "Expected %" PRIu64 " ticks, got %" PRIu64, expected, actual);
+    assertTrue(rtaFramework_TicksToUsec(actual) / 1000 == msec, "Round trip lost time");
+}
 
 LONGBOW_TEST_FIXTURE(Local)
 {
@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_QueueScheduler.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/transport/transport_rta/core/rta_ProtocolStack.h>
+#include <ccnx/transport/transport_rta/core/rta_Component.h>
+#include <ccnx/transport/transport_rta/config/config_All.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework_Commands.c>
+#include <ccnx/transport/transport_rta/core/rta_Framework_NonThreaded.h>
+#include <ccnx/transport/test_tools/traffic_tools.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <limits.h>
+
+#define MAX_RECORD 64
+
+typedef struct test_data {
+    PARCRingBuffer1x1 *commandRingBuffer;
+    PARCNotifier *commandNotifier;
+    RtaFramework *framework;
+    RtaProtocolStack *stack;
+
+    RtaConnection *heavy;
+    RtaConnection *light;
+
+    PARCEventQueuePair *pair;
+    PARCEventQueue *queue;
+
+    // the connection of each message the component read, in order
+    RtaConnection *record[MAX_RECORD];
+    bool recordControl[MAX_RECORD];
+    unsigned recordCount;
+} TestData;
+
+static RtaConnection *
+_createConnection(TestData *data, int64_t weight)
+{
+    int fds[2];
+    int error = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    assertFalse(error, "Error creating socket pair: (%d) %s", errno, strerror(errno));
+
+    CCNxConnectionConfig *connConfig = apiConnector_ConnectionConfig(ccnxConnectionConfig_Create());
+    if (weight <= UINT_MAX) {
+        apiConnector_SetSchedulingWeight(connConfig, (unsigned) weight);
+    } else {
+        // beyond what the setter takes, as a hand written configuration could have it
+        PARCJSON *apiJson = parcJSONValue_GetJSON(parcJSON_GetValueByName(ccnxConnectionConfig_GetJson(connConfig),
+                                                                          apiConnector_GetName()));
+        parcJSON_AddInteger(apiJson, "WEIGHT", weight);
+    }
+
+    RtaCommandOpenConnection *openConnection = rtaCommandOpenConnection_Create(1, fds[0], fds[1], ccnxConnectionConfig_GetJson(connConfig));
+
+    // The connection closes the descriptors when destroyed
+    RtaConnection *conn = rtaConnection_Create(data->stack, openConnection);
+
+    rtaCommandOpenConnection_Release(&openConnection);
+    ccnxConnectionConfig_Destroy(&connConfig);
+    return conn;
+}
+
+static TestData *
+_commonSetup(int64_t lightWeight)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    data->commandRingBuffer = parcRingBuffer1x1_Create(128, NULL);
+    data->commandNotifier = parcNotifier_Create();
+    data->framework = rtaFramework_Create(data->commandRingBuffer, data->commandNotifier);
+
+    CCNxStackConfig *stackConfig = ccnxStackConfig_Create();
+    apiConnector_ProtocolStackConfig(stackConfig);
+    testingLower_ProtocolStackConfig(stackConfig);
+    protocolStack_ComponentsConfigArgs(stackConfig, apiConnector_GetName(), testingLower_GetName(), NULL);
+
+    int stackId = 1;
+    RtaCommandCreateProtocolStack *createStack = rtaCommandCreateProtocolStack_Create(stackId, stackConfig);
+    _rtaFramework_ExecuteCreateStack(data->framework, createStack);
+    rtaCommandCreateProtocolStack_Release(&createStack);
+    ccnxStackConfig_Release(&stackConfig);
+
+    data->stack = (rtaFramework_GetProtocolStackByStackId(data->framework, stackId))->stack;
+
+    data->heavy = _createConnection(data, 1);
+    data->light = _createConnection(data, lightWeight);
+
+    // A private pair, so the stack's own components never see our messages
+    data->pair = parcEventQueue_CreateConnectedPair(rtaFramework_GetEventScheduler(data->framework));
+    data->queue = parcEventQueue_GetConnectedDownQueue(data->pair);
+
+    return data;
+}
+
+static void
+_commonTeardown(TestData *data)
+{
+    parcEventQueue_DestroyConnectedPair(&data->pair);
+
+    rtaConnection_Destroy(&data->heavy);
+    rtaConnection_Destroy(&data->light);
+
+    rtaFramework_Teardown(data->framework);
+    parcRingBuffer1x1_Release(&data->commandRingBuffer);
+    parcNotifier_Release(&data->commandNotifier);
+    rtaFramework_Destroy(&data->framework);
+
+    parcMemory_Deallocate((void **) &data);
+}
+
+/**
+ * Puts a message for the connection directly in the input buffer of the queue, as
+ * if the component above had written it.
+ */
+static void
+_arriveMessages(TestData *data, RtaConnection *conn, unsigned count, bool control)
+{
+    PARCEventBuffer *in = parcEventBuffer_GetQueueBufferInput(data->queue);
+    for (unsigned i = 0; i < count; i++) {
+        TransportMessage *tm = control ?
+                               trafficTools_CreateTransportMessageWithDictionaryControl(conn, CCNxTlvDictionary_SchemaVersion_V1) :
+                               trafficTools_CreateTransportMessageWithDictionaryInterest(conn, CCNxTlvDictionary_SchemaVersion_V1);
+        int res = parcEventBuffer_Append(in, (void *) &tm, sizeof(&tm));
+        assertTrue(res == 0, "parcEventBuffer_Append returned error");
+        rtaConnection_IncrementMessagesInQueue(conn);
+    }
+    parcEventBuffer_Destroy(&in);
+}
+
+static void
+_arrive(TestData *data, RtaConnection *conn, unsigned count)
+{
+    _arriveMessages(data, conn, count, false);
+}
+
+/**
+ * The component read callback: records and destroys everything in the queue
+ */
+static void
+_recordRead(PARCEventQueue *queue, PARCEventType events, void *stack)
+{
+    TestData *data = (TestData *) stack;
+    TransportMessage *tm;
+    while ((tm = rtaComponent_GetMessage(queue)) != NULL) {
+        assertTrue(data->recordCount < MAX_RECORD, "Too many messages read");
+        data->recordControl[data->recordCount] = transportMessage_IsControl(tm);
+        data->record[data->recordCount++] = rtaConnection_GetFromTransport(tm);
+        transportMessage_Destroy(&tm);
+    }
+}
+
+static unsigned
+_countRecorded(TestData *data, RtaConnection *conn, unsigned from, unsigned to)
+{
+    unsigned count = 0;
+    for (unsigned i = from; i < to && i < data->recordCount; i++) {
+        if (data->record[i] == conn) {
+            count++;
+        }
+    }
+    return count;
+}
+
+LONGBOW_TEST_RUNNER(rta_QueueScheduler)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_QueueScheduler)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_QueueScheduler)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_FastPath);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_RoundRobin);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_Weighted);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_WeightAboveUint32);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_Resume);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_ControlFirst);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_ControlBehindBacklog);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Read_ControlKeepsConnectionOrder);
+    LONGBOW_RUN_TEST_CASE(Global, rtaQueueScheduler_Destroy_Backlog);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * No more than a batch waiting and nothing held back: the component reads the queue as is
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_FastPath)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 3);
+    _arrive(data, data->light, 1);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 4, "Expected 4 messages read, got %u", data->recordCount);
+    assertTrue(data->record[3] == data->light, "Fast path should keep arrival order");
+
+    const RtaQueueSchedulerStats *stats = rtaQueueScheduler_GetStats(scheduler);
+    assertTrue(stats->batches == 0, "Fast path should not form a batch, got %" PRIu64, (uint64_t) stats->batches);
+    assertTrue(stats->yields == 0, "Nothing left, should not yield, got %" PRIu64, (uint64_t) stats->yields);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * A light connection behind a burst from a heavy one is served in the first batch
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_RoundRobin)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 10);
+    _arrive(data, data->light, 2);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 4, "Expected one batch of 4, got %u", data->recordCount);
+    assertTrue(_countRecorded(data, data->light, 0, 4) == 2, "Expected both light messages in the first batch");
+    assertTrue(rtaQueueScheduler_GetBacklog(scheduler) == 8, "Expected backlog 8, got %zu", rtaQueueScheduler_GetBacklog(scheduler));
+    assertTrue(rtaConnection_MessagesInQueue(data->heavy) == 8, "Held messages should still count as queued");
+
+    const RtaQueueSchedulerStats *stats = rtaQueueScheduler_GetStats(scheduler);
+    assertTrue(stats->maxBacklog == 12, "Expected max backlog 12, got %" PRIu64, stats->maxBacklog);
+    assertTrue(stats->yields == 1, "Expected to yield once, got %" PRIu64, (uint64_t) stats->yields);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    assertTrue(rtaConnection_MessagesInQueue(data->heavy) == 0, "Destroy should release the held messages");
+    _commonTeardown(data);
+}
+
+/**
+ * With weight 3 the light connection gets three messages per round to the heavy one's one
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_Weighted)
+{
+    TestData *data = _commonSetup(3);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 8);
+
+    _arrive(data, data->heavy, 10);
+    _arrive(data, data->light, 10);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 8, "Expected one batch of 8, got %u", data->recordCount);
+    unsigned light = _countRecorded(data, data->light, 0, 8);
+    assertTrue(light == 6, "Expected 6 light messages in the batch, got %u", light);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * A configured weight of 2^32 is clamped, not wrapped to 0, so the light connection is still served
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_WeightAboveUint32)
+{
+    TestData *data = _commonSetup((int64_t) UINT32_MAX + 1);
+    assertTrue(rtaConnection_GetWeight(data->light) == UINT_MAX, "Expected the weight clamped, got %u",
+               rtaConnection_GetWeight(data->light));
+
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 8);
+
+    _arrive(data, data->heavy, 10);
+    _arrive(data, data->light, 10);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 8, "Expected one batch of 8, got %u", data->recordCount);
+    unsigned light = _countRecorded(data, data->light, 0, 8);
+    assertTrue(light == 7, "Expected the rest of the batch to be light messages, got %u", light);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * The resume timer delivers the rest of the backlog from the event loop
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_Resume)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 10);
+    _arrive(data, data->light, 2);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    for (int i = 0; i < 10 && rtaQueueScheduler_GetBacklog(scheduler) > 0; i++) {
+        rtaFramework_NonThreadedStep(data->framework);
+    }
+
+    assertTrue(data->recordCount == 12, "Expected all 12 messages read, got %u", data->recordCount);
+    assertTrue(rtaQueueScheduler_GetBacklog(scheduler) == 0, "Expected empty backlog");
+
+    const RtaQueueSchedulerStats *stats = rtaQueueScheduler_GetStats(scheduler);
+    assertTrue(stats->callbacks == 3, "Expected 3 callbacks, got %" PRIu64, (uint64_t) stats->callbacks);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * A control message behind a burst of another connection's data is the first message of the batch
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_ControlFirst)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 10);
+    _arriveMessages(data, data->light, 1, true);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 4, "Expected one batch of 4, got %u", data->recordCount);
+    assertTrue(data->recordControl[0], "The control message should lead the batch");
+
+    const RtaQueueSchedulerStats *stats = rtaQueueScheduler_GetStats(scheduler);
+    assertTrue(stats->control == 1, "Expected 1 control message, got %" PRIu64, stats->control);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * A control message that arrives while data is held back goes ahead of it
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_ControlBehindBacklog)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 20);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+    assertTrue(rtaQueueScheduler_GetBacklog(scheduler) == 16, "Expected backlog 16, got %zu", rtaQueueScheduler_GetBacklog(scheduler));
+
+    _arriveMessages(data, data->light, 1, true);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    assertTrue(data->recordCount == 8, "Expected two batches of 4, got %u", data->recordCount);
+    assertTrue(data->recordControl[4] && data->record[4] == data->light, "The control message should lead the second batch");
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+/**
+ * A control message behind its own connection's data, like a CONNECTION_CLOSED, is read
+ * after that data.  Another connection's control message still goes first.
+ */
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Read_ControlKeepsConnectionOrder)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 4);
+
+    _arrive(data, data->heavy, 10);
+    _arriveMessages(data, data->heavy, 1, true);
+    _arriveMessages(data, data->light, 1, true);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    for (int i = 0; i < 10 && rtaQueueScheduler_GetBacklog(scheduler) > 0; i++) {
+        rtaFramework_NonThreadedStep(data->framework);
+    }
+
+    assertTrue(data->recordCount == 12, "Expected all 12 messages read, got %u", data->recordCount);
+    assertTrue(data->recordControl[0] && data->record[0] == data->light, "The light control message should lead the first batch");
+
+    unsigned heavyData = 0;
+    for (unsigned i = 0; i < data->recordCount; i++) {
+        if (data->record[i] == data->heavy) {
+            if (data->recordControl[i]) {
+                assertTrue(heavyData == 10, "The heavy control message overtook its data, read after %u of 10", heavyData);
+            } else {
+                heavyData++;
+            }
+        }
+    }
+
+    const RtaQueueSchedulerStats *stats = rtaQueueScheduler_GetStats(scheduler);
+    assertTrue(stats->control == 1, "Expected 1 control message in the priority lane, got %" PRIu64, stats->control);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    _commonTeardown(data);
+}
+
+LONGBOW_TEST_CASE(Global, rtaQueueScheduler_Destroy_Backlog)
+{
+    TestData *data = _commonSetup(1);
+    RtaQueueScheduler *scheduler = rtaQueueScheduler_Create(rtaFramework_GetEventScheduler(data->framework),
+                                                            data->queue, _recordRead, NULL, data, 1);
+
+    _arrive(data, data->heavy, 5);
+    _arrive(data, data->light, 5);
+    _arriveMessages(data, data->light, 2, true);
+    rtaQueueScheduler_Read(data->queue, PARCEventType_Read, scheduler);
+
+    rtaQueueScheduler_Destroy(&scheduler);
+    assertNull(scheduler, "Destroy did not null the pointer");
+    assertTrue(rtaConnection_MessagesInQueue(data->heavy) == 0, "Heavy connection still has queued messages");
+    assertTrue(rtaConnection_MessagesInQueue(data->light) == 0, "Light connection still has queued messages");
+
+    _commonTeardown(data);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_QueueScheduler);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_StatusCoalescer.c"
+#include <ccnx/transport/transport_rta/core/rta_Framework_NonThreaded.h>
+#include <string.h>
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/concurrent/parc_RingBuffer_1x1.h>
+#include <parc/concurrent/parc_Notifier.h>
+
+#define MAX_DELIVERED 64
+
+typedef struct test_data {
+    PARCRingBuffer1x1 *commandRingBuffer;
+    PARCNotifier *commandNotifier;
+    RtaFramework *framework;
+
+    // what was delivered, in order
+    unsigned deliveredCount;
+    NotifyStatus *delivered[MAX_DELIVERED];
+    RtaComponents component[MAX_DELIVERED];
+} TestData;
+
+static void
+_testDeliver(const NotifyStatus *status, RtaComponents component, RtaDirection direction, void *user_data)
+{
+    TestData *data = (TestData *) user_data;
+    assertTrue(data->deliveredCount < MAX_DELIVERED, "Too many notifications delivered");
+    data->delivered[data->deliveredCount] = notifyStatus_Acquire(status);
+    data->component[data->deliveredCount] = component;
+    data->deliveredCount++;
+}
+
+static struct timeval
+_msec(unsigned msec)
+{
+    return (struct timeval) { .tv_sec = msec / 1000, .tv_usec = (msec % 1000) * 1000 };
+}
+
+static void
+_post(RtaStatusCoalescer *coalescer, RtaComponents component, NotifyStatusCode code, const char *message)
+{
+    NotifyStatus *status = notifyStatus_Create(7, code, NULL, message);
+    rtaStatusCoalescer_Post(coalescer, component, RTA_UP, status);
+    notifyStatus_Release(&status);
+}
+
+static void
+_postNamed(RtaStatusCoalescer *coalescer, NotifyStatusCode code, const char *uri)
+{
+    CCNxName *name = ccnxName_CreateFromURI(uri);
+    NotifyStatus *status = notifyStatus_Create(7, code, name, NULL);
+    rtaStatusCoalescer_Post(coalescer, FC_VEGAS, RTA_UP, status);
+    notifyStatus_Release(&status);
+    ccnxName_Release(&name);
+}
+
+static void
+_step(TestData *data, unsigned msec)
+{
+    struct timeval duration = _msec(msec);
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+}
+
+LONGBOW_TEST_RUNNER(rta_StatusCoalescer)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_StatusCoalescer)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_StatusCoalescer)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_NoWindow);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Window);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Window_Idle);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Window_PerCode);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Window_PerName);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Window_ManyNames);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Flush);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_ConnectionClosed);
+    LONGBOW_RUN_TEST_CASE(Global, rtaStatusCoalescer_Destroy_Held);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+    data->commandRingBuffer = parcRingBuffer1x1_Create(128, NULL);
+    data->commandNotifier = parcNotifier_Create();
+    data->framework = rtaFramework_Create(data->commandRingBuffer, data->commandNotifier);
+    rtaFramework_NonThreadedUseVirtualClock(data->framework, &(struct timeval) { .tv_sec = 1000, .tv_usec = 0 });
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    for (unsigned i = 0; i < data->deliveredCount; i++) {
+        notifyStatus_Release(&data->delivered[i]);
+    }
+    rtaFramework_Destroy(&data->framework);
+    parcRingBuffer1x1_Release(&data->commandRingBuffer);
+    parcNotifier_Release(&data->commandNotifier);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_NoWindow)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(0);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    for (int i = 0; i < 5; i++) {
+        _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, NULL);
+    }
+
+    assertTrue(data->deliveredCount == 5, "Without a window every status is delivered, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetCount(data->delivered[4]) == 1, "Each notification is one event");
+    assertTrue(rtaStatusCoalescer_GetEventCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == 5, "Wrong event count");
+    assertTrue(rtaStatusCoalescer_GetDeliveredCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == 5, "Wrong delivered count");
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Window)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, "first");
+    assertTrue(data->deliveredCount == 1, "The first status should be delivered at once, got %u", data->deliveredCount);
+
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, "second");
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, "third");
+    assertTrue(data->deliveredCount == 1, "Statuses in the window should be held, got %u", data->deliveredCount);
+    assertTrue(rtaStatusCoalescer_GetPendingCount(coalescer) == 2, "Expected 2 held");
+
+    _step(data, 100);
+    assertTrue(data->deliveredCount == 2, "The window should deliver the held statuses, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetCount(data->delivered[1]) == 2, "Expected a count of 2, got %u", notifyStatus_GetCount(data->delivered[1]));
+    assertTrue(strcmp(notifyStatus_GetMessage(data->delivered[1]), "third") == 0, "Expected the last message");
+
+    // the window is open again
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, "fourth");
+    assertTrue(data->deliveredCount == 2, "A status after a delivered window should be held, got %u", data->deliveredCount);
+
+    _step(data, 100);
+    assertTrue(data->deliveredCount == 3, "Expected the fourth to be delivered, got %u", data->deliveredCount);
+    assertTrue(rtaStatusCoalescer_GetEventCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == 4, "Wrong event count");
+    assertTrue(rtaStatusCoalescer_GetDeliveredCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == 3, "Wrong delivered count");
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Window_Idle)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    _post(coalescer, PIT, notifyStatusCode_INTEREST_TIMEOUT, NULL);
+    _step(data, 100);
+    assertFalse(rtaTimer_IsPending(coalescer->windowTimer), "A window with nothing held should close the slot");
+
+    _post(coalescer, PIT, notifyStatusCode_INTEREST_TIMEOUT, NULL);
+    assertTrue(data->deliveredCount == 2, "An idle code should deliver at once, got %u", data->deliveredCount);
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Window_PerCode)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_STARTED, NULL);
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, NULL);
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_STARTED, NULL);
+
+    assertTrue(data->deliveredCount == 2, "Each code should deliver its first status, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetStatusCode(data->delivered[0]) == notifyStatusCode_FLOW_CONTROL_STARTED, "Wrong first code");
+    assertTrue(notifyStatus_GetStatusCode(data->delivered[1]) == notifyStatusCode_FLOW_CONTROL_FINISHED, "Wrong second code");
+
+    _step(data, 100);
+    assertTrue(data->deliveredCount == 3, "Expected the held STARTED, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetStatusCode(data->delivered[2]) == notifyStatusCode_FLOW_CONTROL_STARTED, "Wrong held code");
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Window_PerName)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    CCNxName *nameA = ccnxName_CreateFromURI("lci:/stream/a");
+    CCNxName *nameB = ccnxName_CreateFromURI("lci:/stream/b");
+
+    _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, "lci:/stream/a");
+    _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, "lci:/stream/b");
+    _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, "lci:/stream/a");
+    _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, "lci:/stream/a");
+    _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, "lci:/stream/b");
+
+    assertTrue(data->deliveredCount == 2, "Each name should deliver its first status, got %u", data->deliveredCount);
+    assertTrue(ccnxName_Equals(notifyStatus_GetName(data->delivered[0]), nameA), "Expected name a first");
+    assertTrue(ccnxName_Equals(notifyStatus_GetName(data->delivered[1]), nameB), "Expected name b second");
+    assertTrue(rtaStatusCoalescer_GetPendingCount(coalescer) == 3, "Expected 3 held");
+
+    _step(data, 100);
+    assertTrue(data->deliveredCount == 4, "Each name should deliver its held statuses, got %u", data->deliveredCount);
+    assertTrue(ccnxName_Equals(notifyStatus_GetName(data->delivered[2]), nameA), "Expected the held name a");
+    assertTrue(notifyStatus_GetCount(data->delivered[2]) == 2, "Expected a count of 2, got %u", notifyStatus_GetCount(data->delivered[2]));
+    assertTrue(ccnxName_Equals(notifyStatus_GetName(data->delivered[3]), nameB), "Expected the held name b");
+    assertTrue(notifyStatus_GetCount(data->delivered[3]) == 1, "Expected a count of 1, got %u", notifyStatus_GetCount(data->delivered[3]));
+    assertTrue(rtaStatusCoalescer_GetDeliveredCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == 4, "Wrong delivered count");
+
+    // a window with nothing held frees the named slots
+    _step(data, 100);
+    assertTrue(TAILQ_EMPTY(&coalescer->namedSlots), "Idle named slots should be freed");
+    assertFalse(rtaTimer_IsPending(coalescer->windowTimer), "No slot should be open");
+
+    ccnxName_Release(&nameA);
+    ccnxName_Release(&nameB);
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+/**
+ * Many open names: the table grows and each name still finds its own slot
+ */
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Window_ManyNames)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    // more names than the initial buckets, fewer than the notifications the test keeps
+    const unsigned count = 24;
+    char uri[64];
+    for (int round = 0; round < 2; round++) {
+        for (unsigned i = 0; i < count; i++) {
+            sprintf(uri, "lci:/session/%u", i);
+            _postNamed(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED, uri);
+        }
+    }
+
+    // the first of each name was delivered, the second is held
+    assertTrue(rtaStatusCoalescer_GetDeliveredCount(coalescer, notifyStatusCode_FLOW_CONTROL_FINISHED) == count,
+               "Each name should deliver its first status");
+    assertTrue(rtaStatusCoalescer_GetPendingCount(coalescer) == count, "Each name should hold its second status");
+    assertTrue(coalescer->namedCount == count, "Expected %u named slots, got %zu", count, coalescer->namedCount);
+    assertTrue(coalescer->bucketCount > MIN_BUCKETS, "The table should have grown, got %zu buckets", coalescer->bucketCount);
+
+    _step(data, 100);
+    assertTrue(data->deliveredCount == 2 * count, "Each name should deliver its held status, got %u", data->deliveredCount);
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Flush)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    for (int i = 0; i < 10; i++) {
+        _post(coalescer, FWD_METIS, notifyStatusCode_SEND_ERROR, NULL);
+    }
+    rtaStatusCoalescer_Flush(coalescer);
+
+    assertTrue(data->deliveredCount == 2, "Expected the first and the flushed, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetCount(data->delivered[1]) == 9, "Expected a count of 9, got %u", notifyStatus_GetCount(data->delivered[1]));
+    assertTrue(data->component[1] == FWD_METIS, "Expected the component of the held status");
+    assertTrue(rtaStatusCoalescer_GetPendingCount(coalescer) == 0, "Nothing should be held after a flush");
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_ConnectionClosed)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, NULL);
+    _post(coalescer, FC_VEGAS, notifyStatusCode_FLOW_CONTROL_FINISHED, NULL);
+    _post(coalescer, FWD_METIS, notifyStatusCode_CONNECTION_CLOSED, NULL);
+
+    assertTrue(data->deliveredCount == 3, "Expected 3 notifications, got %u", data->deliveredCount);
+    assertTrue(notifyStatus_GetStatusCode(data->delivered[1]) == notifyStatusCode_FLOW_CONTROL_FINISHED,
+               "The held status should come before the close");
+    assertTrue(notifyStatus_GetStatusCode(data->delivered[2]) == notifyStatusCode_CONNECTION_CLOSED, "Expected the close last");
+
+    rtaStatusCoalescer_Destroy(&coalescer);
+}
+
+LONGBOW_TEST_CASE(Global, rtaStatusCoalescer_Destroy_Held)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    struct timeval window = _msec(100);
+    RtaStatusCoalescer *coalescer = rtaStatusCoalescer_Create(data->framework, &window, _testDeliver, data);
+
+    _post(coalescer, PIT, notifyStatusCode_INTEREST_TIMEOUT, "a");
+    _post(coalescer, PIT, notifyStatusCode_INTEREST_TIMEOUT, "b");
+
+    // the held status and the timer must be released
+    rtaStatusCoalescer_Destroy(&coalescer);
+    assertNull(coalescer, "Destroy should NULL the pointer");
+
+    _step(data, 200);
+    assertTrue(data->deliveredCount == 1, "Nothing should be delivered after destroy, got %u", data->deliveredCount);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_StatusCoalescer);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_Timer.c"
+#include <ccnx/transport/transport_rta/core/rta_Framework_NonThreaded.h>
+#include <ccnx/transport/transport_rta/core/rta_Framework_Services.h>
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/concurrent/parc_RingBuffer_1x1.h>
+#include <parc/concurrent/parc_Notifier.h>
+#include <inttypes.h>
+
+#define MAX_FIRES 64
+
+typedef struct test_data {
+    PARCRingBuffer1x1 *commandRingBuffer;
+    PARCNotifier *commandNotifier;
+    RtaFramework *framework;
+
+    // the order in which timers fired, by index, and the virtual time they fired at
+    unsigned fireCount;
+    unsigned fired[MAX_FIRES];
+    uint64_t firedUsec[MAX_FIRES];
+} TestData;
+
+typedef struct test_timer {
+    TestData *data;
+    unsigned index;
+} TestTimer;
+
+static void
+_testCallback(int fd, PARCEventType type, void *user_data)
+{
+    TestTimer *testTimer = (TestTimer *) user_data;
+    TestData *data = testTimer->data;
+
+    assertTrue(data->fireCount < MAX_FIRES, "Too many timers fired");
+    data->fired[data->fireCount] = testTimer->index;
+    data->firedUsec[data->fireCount] = data->framework->virtualNowUsec;
+    data->fireCount++;
+}
+
+static struct timeval
+_msec(unsigned msec)
+{
+    return (struct timeval) { .tv_sec = msec / 1000, .tv_usec = (msec % 1000) * 1000 };
+}
+
+LONGBOW_TEST_RUNNER(rta_Timer)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Virtual);
+    LONGBOW_RUN_TEST_FIXTURE(Real);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_Timer)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_Timer)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static TestData *
+_commonSetup(void)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+    data->commandRingBuffer = parcRingBuffer1x1_Create(128, NULL);
+    data->commandNotifier = parcNotifier_Create();
+    data->framework = rtaFramework_Create(data->commandRingBuffer, data->commandNotifier);
+    return data;
+}
+
+static int
+_commonTeardown(LongBowTestCase *testCase, TestData *data)
+{
+    rtaFramework_Destroy(&data->framework);
+    parcRingBuffer1x1_Release(&data->commandRingBuffer);
+    parcNotifier_Release(&data->commandNotifier);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Virtual)
+{
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimer_Virtual_Order);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimer_Virtual_Ties);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimer_Virtual_Persist);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimer_Virtual_Stop);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimer_Virtual_Restart);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaTimerQueue_Heap);
+    LONGBOW_RUN_TEST_CASE(Virtual, rtaFramework_GetTimeOfDay_Virtual);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Virtual)
+{
+    TestData *data = _commonSetup();
+    rtaFramework_NonThreadedUseVirtualClock(data->framework, &(struct timeval) { .tv_sec = 1000, .tv_usec = 0 });
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Virtual)
+{
+    return _commonTeardown(testCase, longBowTestCase_GetClipBoardData(testCase));
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimer_Virtual_Order)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    unsigned timeouts[] = { 30, 10, 20 };
+    TestTimer testTimers[3];
+    RtaTimer *timers[3];
+
+    for (int i = 0; i < 3; i++) {
+        testTimers[i] = (TestTimer) { .data = data, .index = i };
+        timers[i] = rtaTimer_Create(data->framework, 0, _testCallback, &testTimers[i]);
+        struct timeval timeout = _msec(timeouts[i]);
+        rtaTimer_Start(timers[i], &timeout);
+    }
+
+    struct timeval duration = _msec(25);
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+
+    assertTrue(data->fireCount == 2, "Expected 2 timers to fire, got %u", data->fireCount);
+    assertTrue(data->fired[0] == 1 && data->firedUsec[0] == 10000, "First fire wrong, timer %u at %" PRIu64, data->fired[0], data->firedUsec[0]);
+    assertTrue(data->fired[1] == 2 && data->firedUsec[1] == 20000, "Second fire wrong, timer %u at %" PRIu64, data->fired[1], data->firedUsec[1]);
+    assertTrue(rtaFramework_NonThreadedGetVirtualUsec(data->framework) == 25000,
+               "Virtual time should be at the end of the step, got %" PRIu64, rtaFramework_NonThreadedGetVirtualUsec(data->framework));
+    assertTrue(rtaTimer_IsPending(timers[0]), "The 30 msec timer should still be pending");
+    assertFalse(rtaTimer_IsPending(timers[1]), "The 10 msec timer should not be pending");
+
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+    assertTrue(data->fireCount == 3 && data->fired[2] == 0 && data->firedUsec[2] == 30000, "Third fire wrong");
+
+    for (int i = 0; i < 3; i++) {
+        rtaTimer_Destroy(&timers[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimer_Virtual_Ties)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimers[4];
+    RtaTimer *timers[4];
+
+    struct timeval timeout = _msec(5);
+    for (int i = 0; i < 4; i++) {
+        testTimers[i] = (TestTimer) { .data = data, .index = i };
+        timers[i] = rtaTimer_Create(data->framework, 0, _testCallback, &testTimers[i]);
+        rtaTimer_Start(timers[i], &timeout);
+    }
+
+    rtaFramework_NonThreadedStepTimed(data->framework, &timeout);
+
+    assertTrue(data->fireCount == 4, "Expected 4 timers to fire, got %u", data->fireCount);
+    for (int i = 0; i < 4; i++) {
+        assertTrue(data->fired[i] == i, "Timers with the same expiry should fire in start order, position %d got %u", i, data->fired[i]);
+        rtaTimer_Destroy(&timers[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimer_Virtual_Persist)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimer = { .data = data, .index = 0 };
+    RtaTimer *timer = rtaTimer_Create(data->framework, PARCEventType_Persist, _testCallback, &testTimer);
+
+    struct timeval period = _msec(10);
+    rtaTimer_Start(timer, &period);
+
+    struct timeval duration = _msec(35);
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+
+    assertTrue(data->fireCount == 3, "Expected 3 fires, got %u", data->fireCount);
+    for (int i = 0; i < 3; i++) {
+        assertTrue(data->firedUsec[i] == (i + 1) * 10000, "Fire %d at wrong time %" PRIu64, i, data->firedUsec[i]);
+    }
+    assertTrue(rtaTimer_IsPending(timer), "A persistent timer should stay pending");
+
+    rtaTimer_Destroy(&timer);
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimer_Virtual_Stop)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimers[2] = { { .data = data, .index = 0 }, { .data = data, .index = 1 } };
+    RtaTimer *a = rtaTimer_Create(data->framework, 0, _testCallback, &testTimers[0]);
+    RtaTimer *b = rtaTimer_Create(data->framework, 0, _testCallback, &testTimers[1]);
+
+    struct timeval timeout = _msec(10);
+    rtaTimer_Start(a, &timeout);
+    rtaTimer_Start(b, &timeout);
+    rtaTimer_Stop(a);
+
+    assertFalse(rtaTimer_IsPending(a), "A stopped timer should not be pending");
+    assertTrue(rtaTimerQueue_Size(data->framework->virtualTimers) == 1, "Expected 1 queued timer, got %zu",
+               rtaTimerQueue_Size(data->framework->virtualTimers));
+
+    rtaFramework_NonThreadedStepTimed(data->framework, &timeout);
+    assertTrue(data->fireCount == 1 && data->fired[0] == 1, "Only the running timer should fire");
+
+    rtaTimer_Destroy(&a);
+    rtaTimer_Destroy(&b);
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimer_Virtual_Restart)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimer = { .data = data, .index = 0 };
+    RtaTimer *timer = rtaTimer_Create(data->framework, 0, _testCallback, &testTimer);
+
+    struct timeval timeout = _msec(10);
+    rtaTimer_Start(timer, &timeout);
+
+    struct timeval step = _msec(5);
+    rtaFramework_NonThreadedStepTimed(data->framework, &step);
+
+    // restarting moves the expiry out from the current virtual time
+    rtaTimer_Start(timer, &timeout);
+    rtaFramework_NonThreadedStepTimed(data->framework, &timeout);
+
+    assertTrue(data->fireCount == 1 && data->firedUsec[0] == 15000, "Restarted timer should fire once at 15 msec, got %u fires",
+               data->fireCount);
+
+    rtaTimer_Destroy(&timer);
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaTimerQueue_Heap)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    const unsigned count = MAX_FIRES;
+    TestTimer testTimers[MAX_FIRES];
+    RtaTimer *timers[MAX_FIRES];
+
+    // more timers than the initial capacity would hold, so the heap grows, started in a scrambled order
+    for (unsigned i = 0; i < count; i++) {
+        testTimers[i] = (TestTimer) { .data = data, .index = i };
+        timers[i] = rtaTimer_Create(data->framework, 0, _testCallback, &testTimers[i]);
+        struct timeval timeout = _msec((i * 37) % count + 1);
+        rtaTimer_Start(timers[i], &timeout);
+    }
+
+    // stop every fifth timer, from the middle of the heap
+    for (unsigned i = 0; i < count; i += 5) {
+        rtaTimer_Stop(timers[i]);
+    }
+
+    while (rtaTimerQueue_FireNext(data->framework->virtualTimers)) {
+    }
+
+    unsigned expected = count - (count + 4) / 5;
+    assertTrue(data->fireCount == expected, "Expected %u fires, got %u", expected, data->fireCount);
+    for (unsigned i = 1; i < data->fireCount; i++) {
+        uint64_t previous = timers[data->fired[i - 1]]->expiryUsec;
+        uint64_t current = timers[data->fired[i]]->expiryUsec;
+        assertTrue(previous <= current, "Timers fired out of order at position %u", i);
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        rtaTimer_Destroy(&timers[i]);
+    }
+}
+
+LONGBOW_TEST_CASE(Virtual, rtaFramework_GetTimeOfDay_Virtual)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    struct timeval duration = { .tv_sec = 2, .tv_usec = 500000 };
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+
+    struct timeval now;
+    rtaFramework_GetTimeOfDay(data->framework, &now);
+    assertTrue(now.tv_sec == 1002 && now.tv_usec == 500000, "Wrong virtual time of day %ld.%06ld", (long) now.tv_sec, (long) now.tv_usec);
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Real)
+{
+    LONGBOW_RUN_TEST_CASE(Real, rtaTimer_Real_Pending);
+    LONGBOW_RUN_TEST_CASE(Real, rtaTimer_Real_Fires);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Real)
+{
+    longBowTestCase_SetClipBoardData(testCase, _commonSetup());
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Real)
+{
+    return _commonTeardown(testCase, longBowTestCase_GetClipBoardData(testCase));
+}
+
+LONGBOW_TEST_CASE(Real, rtaTimer_Real_Pending)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimer = { .data = data, .index = 0 };
+    RtaTimer *timer = rtaTimer_Create(data->framework, 0, _testCallback, &testTimer);
+
+    assertFalse(rtaTimer_IsPending(timer), "A new timer should not be pending");
+
+    struct timeval timeout = _msec(1000);
+    rtaTimer_Start(timer, &timeout);
+    assertTrue(rtaTimer_IsPending(timer), "A started timer should be pending");
+
+    rtaTimer_Stop(timer);
+    assertFalse(rtaTimer_IsPending(timer), "A stopped timer should not be pending");
+
+    rtaTimer_Destroy(&timer);
+}
+
+LONGBOW_TEST_CASE(Real, rtaTimer_Real_Fires)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    TestTimer testTimer = { .data = data, .index = 0 };
+    RtaTimer *timer = rtaTimer_Create(data->framework, 0, _testCallback, &testTimer);
+
+    struct timeval timeout = _msec(1);
+    rtaTimer_Start(timer, &timeout);
+
+    struct timeval duration = _msec(20);
+    rtaFramework_NonThreadedStepTimed(data->framework, &duration);
+
+    assertTrue(data->fireCount == 1, "Expected the timer to fire once, got %u", data->fireCount);
+    assertFalse(rtaTimer_IsPending(timer), "A fired one-shot timer should not be pending");
+
+    rtaTimer_Destroy(&timer);
+}
+
+// ==================================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_Timer);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Patent rights are not granted under this agreement. Patent rights are
+ *       available under FRAND terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX or PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright 2015, Xerox Corporation (Xerox)and Palo Alto Research Center (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../rta_WorkerPool.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <unistd.h>
+
+typedef struct test_job {
+    unsigned index;
+    bool worked;
+    pthread_t workThread;
+} TestJob;
+
+typedef struct test_data {
+    PARCEventScheduler *scheduler;
+    unsigned doneCount;
+} TestData;
+
+static void
+_testWork(void *arg)
+{
+    TestJob *job = (TestJob *) arg;
+    job->worked = true;
+    job->workThread = pthread_self();
+}
+
+static void
+_testDone(void *arg, void *doneContext)
+{
+    TestJob *job = (TestJob *) arg;
+    TestData *data = (TestData *) doneContext;
+
+    assertTrue(job->worked, "Done called before work for job %u", job->index);
+    data->doneCount++;
+    parcMemory_Deallocate((void **) &job);
+}
+
+static TestJob *
+_createJob(unsigned index)
+{
+    TestJob *job = parcMemory_AllocateAndClear(sizeof(TestJob));
+    assertNotNull(job, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestJob));
+    job->index = index;
+    return job;
+}
+
+/**
+ * Runs the event loop until the done count reaches `expected` or we give up
+ */
+static void
+_runUntilDone(TestData *data, unsigned expected)
+{
+    for (int i = 0; i < 1000 && data->doneCount < expected; i++) {
+        parcEventScheduler_Start(data->scheduler, PARCEventSchedulerDispatchType_NonBlocking);
+        usleep(1000);
+    }
+}
+
+LONGBOW_TEST_RUNNER(rta_WorkerPool)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(rta_WorkerPool)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(rta_WorkerPool)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ==================================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, rtaWorkerPool_Create);
+    LONGBOW_RUN_TEST_CASE(Global, rtaWorkerPool_Submit_Threaded);
+    LONGBOW_RUN_TEST_CASE(Global, rtaWorkerPool_Submit_Inline);
+    LONGBOW_RUN_TEST_CASE(Global, rtaWorkerPool_Destroy_Outstanding);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+    data->scheduler = parcEventScheduler_Create();
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    parcEventScheduler_Destroy(&data->scheduler);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, rtaWorkerPool_Create)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaWorkerPool *pool = rtaWorkerPool_Create(data->scheduler, 3, _testDone, data);
+    assertNotNull(pool, "Got null pool");
+    assertTrue(rtaWorkerPool_GetWorkerCount(pool) == 3, "Expected 3 workers, got %u", rtaWorkerPool_GetWorkerCount(pool));
+    assertTrue(rtaWorkerPool_GetOutstandingCount(pool) == 0, "New pool should have nothing outstanding");
+    rtaWorkerPool_Destroy(&pool);
+    assertNull(pool, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, rtaWorkerPool_Submit_Threaded)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaWorkerPool *pool = rtaWorkerPool_Create(data->scheduler, 2, _testDone, data);
+
+    const unsigned jobCount = 100;
+    for (unsigned i = 0; i < jobCount; i++) {
+        rtaWorkerPool_Submit(pool, _testWork, _createJob(i));
+    }
+
+    _runUntilDone(data, jobCount);
+    assertTrue(data->doneCount == jobCount, "Expected %u done, got %u", jobCount, data->doneCount);
+    assertTrue(rtaWorkerPool_GetOutstandingCount(pool) == 0, "Expected nothing outstanding, got %zu",
+               rtaWorkerPool_GetOutstandingCount(pool));
+
+    const RtaWorkerPoolStats *stats = rtaWorkerPool_GetStats(pool);
+    assertTrue(stats->submitted == jobCount, "Expected %u submitted, got %" PRIu64, jobCount, stats->submitted);
+    assertTrue(stats->completed == jobCount, "Expected %u completed, got %" PRIu64, jobCount, stats->completed);
+
+    rtaWorkerPool_Destroy(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, rtaWorkerPool_Submit_Inline)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaWorkerPool *pool = rtaWorkerPool_Create(data->scheduler, 0, _testDone, data);
+
+    TestJob *job = _createJob(0);
+    rtaWorkerPool_Submit(pool, _testWork, job);
+
+    assertTrue(job->worked, "Zero workers should run the work inline");
+    assertTrue(pthread_equal(job->workThread, pthread_self()), "Work should have run on the calling thread");
+    assertTrue(data->doneCount == 0, "Done should wait for the event scheduler");
+
+    _runUntilDone(data, 1);
+    assertTrue(data->doneCount == 1, "Expected 1 done, got %u", data->doneCount);
+
+    rtaWorkerPool_Destroy(&pool);
+}
+
+LONGBOW_TEST_CASE(Global, rtaWorkerPool_Destroy_Outstanding)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    RtaWorkerPool *pool = rtaWorkerPool_Create(data->scheduler, 1, _testDone, data);
+
+    const unsigned jobCount = 10;
+    for (unsigned i = 0; i < jobCount; i++) {
+        rtaWorkerPool_Submit(pool, _testWork, _createJob(i));
+    }
+
+    // Never run the event loop, Destroy must finish everything
+    rtaWorkerPool_Destroy(&pool);
+    assertTrue(data->doneCount == jobCount, "Expected %u done, got %u", jobCount, data->doneCount);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(rta_WorkerPool);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
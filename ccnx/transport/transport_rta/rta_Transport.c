@@ -70,6 +70,7 @@
 #include <ccnx/transport/transport_rta/commands/rta_Command.h>
 #include <ccnx/transport/transport_rta/core/components.h>
 #include <ccnx/transport/transport_rta/core/rta_ConnectionTable.h>
+#include <ccnx/transport/transport_rta/config/config_ApiConnector.h>
 
 // These are some internal diagnostic counters used in the debugger
 // for when things are going really bad.  They are incremented on each
@@ -172,6 +173,12 @@ _rtaTransport_SendCommandToFramework(RTATransport *transport, const RtaCommand *
 
 RTATransport *
 rtaTransport_Create(void)
+{
+    return rtaTransport_CreateWithFrameworkConfig(NULL);
+}
+
+RTATransport *
+rtaTransport_CreateWithFrameworkConfig(const RtaFrameworkConfig *frameworkConfig)
 {
     RTATransport *transport = parcMemory_AllocateAndClear(sizeof(RTATransport));
 
@@ -184,6 +191,10 @@ rtaTransport_Create(void)
         transport->framework = rtaFramework_Create(transport->commandRingBuffer, transport->commandNotifier);
         assertNotNull(transport->framework, "rtaFramework_Create returned null");
 
+        if (frameworkConfig != NULL) {
+            rtaFramework_SetThreadConfig(transport->framework, frameworkConfig);
+        }
+
         rtaFramework_Start(transport->framework);
         transport->list = parcDeque_Create();
     }
@@ -337,7 +348,11 @@ rtaTransport_Open(RTATransport *transport, CCNxTransportConfig *transportConfig)
 
     assertNotNull(transport, "Parameter transport must be a valid RTATransport");
 
-    _RTASocketPair pair = _rtaTransport_CreateSocketPair(transport, sizeof(void *) * 128);
+    // The socket only carries message pointers; the API connector accounts the payload
+    // bytes behind them, so size the socket to hold the connection's message budget
+    CCNxConnectionConfig *connConfig = ccnxTransportConfig_GetConnectionConfig(transportConfig);
+    size_t messages = apiConnector_GetQueueMessagesFromConfig(ccnxConnectionConfig_GetJson(connConfig));
+    _RTASocketPair pair = _rtaTransport_CreateSocketPair(transport, (int) (sizeof(void *) * messages));
 
     parcDeque_Lock(transport->list);
     {
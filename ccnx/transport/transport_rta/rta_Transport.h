@@ -73,6 +73,7 @@
 
 #include <ccnx/transport/common/transport.h>
 #include <ccnx/transport/transport_rta/commands/rta_Command.h>
+#include <ccnx/transport/transport_rta/core/rta_FrameworkConfig.h>
 
 /**
  * Transport Ready To Assemble context
@@ -94,6 +95,26 @@ extern const struct transport_operations rta_ops;
  */
 RTATransport *rtaTransport_Create(void);
 
+/**
+ * Create the transport with a scheduling config for its framework thread.
+ *
+ * Same as rtaTransport_Create(), but the framework thread uses `frameworkConfig`
+ * instead of the RtaFramework_* environment variables.  The config is copied.
+ *
+ * @param [in] frameworkConfig The thread config, or NULL for the environment
+ *
+ * Example:
+ * @code
+ * {
+ *     RtaFrameworkConfig *config = rtaFrameworkConfig_Create();
+ *     rtaFrameworkConfig_AddCpuList(config, "2-3");
+ *     RTATransport *transport = rtaTransport_CreateWithFrameworkConfig(config);
+ *     rtaFrameworkConfig_Destroy(&config);
+ * }
+ * @endcode
+ */
+RTATransport *rtaTransport_CreateWithFrameworkConfig(const RtaFrameworkConfig *frameworkConfig);
+
 int rtaTransport_Destroy(RTATransport **ctxPtr);
 
 int rtaTransport_Open(RTATransport *ctx, CCNxTransportConfig *transportConfig);